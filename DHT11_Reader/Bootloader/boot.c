@@ -0,0 +1,489 @@
+/**
+ ******************************************************************************
+ * @file           : boot.c
+ * @brief          : Resident bootloader in flash sector 0: starts the
+ *                   application at BOOT_APP_BASE, or takes a new image over
+ *                   USART2 (boot_layout.h, Docs/bootloader.md).
+ *
+ *                   Register-level and without the HAL, on the 16 MHz HSI
+ *                   the core resets to; flash runs with no wait states and
+ *                   the ART caches off, so nothing read back after an
+ *                   erase can come from a stale line.
+ *
+ *                   Receive: DMA1 Stream5 (channel 4, USART2_RX) runs in
+ *                   double-buffer mode over two BOOT_FRAME_LEN buffers, so
+ *                   the hardware swaps buffers at every frame and the next
+ *                   frame streams in while the CPU erases and programs
+ *                   flash from the last one. A frame left incomplete for
+ *                   BOOT_SYNC_MS restarts the stream at a frame boundary.
+ *
+ *                   Flash: sectors are erased on the first WRITE that
+ *                   touches them, words programmed 32 bits at a time and
+ *                   read back. A word that already holds its value is
+ *                   skipped, so a resent frame is harmless. The CRC unit
+ *                   checks every frame and, at END and at each boot, the
+ *                   whole image.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "stm32f4xx.h"
+#include "boot_layout.h"
+
+/** Core clock out of reset */
+#define BOOT_HSI_HZ      (16000000U)
+
+/** A frame stalled this long is dropped and the stream restarted */
+#define BOOT_SYNC_MS     (50U)
+
+/** Started on request with a valid image: back to it after this long idle */
+#define BOOT_IDLE_MS     (30000U)
+
+/** SRAM1 and SRAM2, where the application's initial stack must point */
+#define BOOT_SRAM_BASE   (0x20000000U)
+#define BOOT_SRAM_END    (0x20020000U)
+
+/** Frame words covered by the frame CRC, and the CRC word's index */
+#define BOOT_CRC_WORDS   ((BOOT_HDR_LEN + BOOT_CHUNK) / 4U)
+
+#define BOOT_IWDG_RELOAD (0xAAAAU)
+
+#define BOOT_FLASH_KEY1  (0x45670123U)
+#define BOOT_FLASH_KEY2  (0xCDEF89ABU)
+#define BOOT_FLASH_ERR   (FLASH_SR_WRPERR | FLASH_SR_PGAERR | FLASH_SR_PGPERR \
+		| FLASH_SR_PGSERR | FLASH_SR_RDERR)
+
+/** Receive stream, HISR/HIFCR flags of stream 5 */
+#define BOOT_DMA_STREAM  DMA1_Stream5
+#define BOOT_DMA_FLAGS   (DMA_HIFCR_CTCIF5 | DMA_HIFCR_CHTIF5 | DMA_HIFCR_CTEIF5 \
+		| DMA_HIFCR_CDMEIF5 | DMA_HIFCR_CFEIF5)
+
+/** Application sector bounds, as offsets from BOOT_APP_BASE */
+static const uint32_t boot_sector_end[BOOT_APP_SECTORS] = { 0x10000U,
+		0x30000U };
+
+/* Frame buffers, word-aligned for the CRC unit */
+static uint32_t boot_rx[2][BOOT_FRAME_LEN / 4U];
+
+static uint32_t boot_ms = 0U;
+static uint32_t boot_size = 0U;
+static uint32_t boot_crc = 0U;
+static uint8_t boot_begun = 0U;
+static uint8_t boot_sealed = 0U;
+static uint8_t boot_erased = 0U;   /* Bit per application sector */
+static uint8_t boot_seq = 0U;
+
+/**
+ * @brief CMSIS hook called by the startup code; the reset clock is kept.
+ */
+void SystemInit(void) {
+}
+
+/**
+ * @brief Counts SysTick wraps; flash stalls only make time pass slower.
+ */
+static uint32_t Boot_Tick(void) {
+	if ((SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk) != 0U) {
+		boot_ms++;
+	}
+	return boot_ms;
+}
+
+/**
+ * @brief Keeps an independent watchdog the application started alive; it
+ *        survives the reset into the bootloader.
+ */
+static void Boot_Kick(void) {
+	IWDG->KR = BOOT_IWDG_RELOAD;
+}
+
+/**
+ * @brief CRC-32/MPEG-2 of n words on the CRC unit.
+ */
+static uint32_t Boot_Crc(const uint32_t *words, uint32_t n) {
+	uint32_t i;
+
+	CRC->CR = CRC_CR_RESET;
+	for (i = 0U; i < n; i++) {
+		CRC->DR = words[i];
+	}
+	return CRC->DR;
+}
+
+/**
+ * @brief Reads and clears the update request left in RTC_BKP1R.
+ * @retval 1 if the application asked for an update.
+ */
+static uint8_t Boot_Requested(void) {
+	uint8_t requested = 0U;
+
+	RCC->APB1ENR |= RCC_APB1ENR_PWREN;
+	(void) RCC->APB1ENR;
+	if (RTC->BKP1R == BOOT_REQUEST_MAGIC) {
+		PWR->CR |= PWR_CR_DBP;
+		RTC->BKP1R = 0U;
+		PWR->CR &= ~PWR_CR_DBP;
+		requested = 1U;
+	}
+	RCC->APB1ENR &= ~RCC_APB1ENR_PWREN;
+	return requested;
+}
+
+/**
+ * @brief Samples the user button (PC13, low when pressed).
+ */
+static uint8_t Boot_ButtonHeld(void) {
+	uint8_t held;
+
+	RCC->AHB1ENR |= RCC_AHB1ENR_GPIOCEN;
+	(void) RCC->AHB1ENR;
+	held = ((GPIOC->IDR & GPIO_IDR_ID13) == 0U) ? 1U : 0U;
+	RCC->AHB1ENR &= ~RCC_AHB1ENR_GPIOCEN;
+	return held;
+}
+
+/**
+ * @brief Checks the descriptor, the vector table and the image CRC; the
+ *        CRC unit must be clocked.
+ * @retval 1 if the application can be started.
+ */
+static uint8_t Boot_ImageValid(void) {
+	const boot_desc_t *desc = (const boot_desc_t*) BOOT_DESC_BASE;
+	const uint32_t *vectors = (const uint32_t*) BOOT_APP_BASE;
+	uint8_t valid = 0U;
+
+	if ((desc->magic != BOOT_DESC_MAGIC)
+			|| (desc->check != ~(desc->magic ^ desc->size ^ desc->crc))
+			|| (desc->size < 8U) || (desc->size > BOOT_APP_SIZE)
+			|| ((desc->size & 3U) != 0U)) {
+		return 0U;
+	}
+	if ((vectors[0] <= BOOT_SRAM_BASE) || (vectors[0] > BOOT_SRAM_END)
+			|| ((vectors[1] & 1U) == 0U) || (vectors[1] < BOOT_APP_BASE)
+			|| (vectors[1] >= (BOOT_APP_BASE + desc->size))) {
+		return 0U;
+	}
+
+	if (Boot_Crc(vectors, desc->size / 4U) == desc->crc) {
+		valid = 1U;
+	}
+	return valid;
+}
+
+/**
+ * @brief Starts the application with the core as out of reset: its vector
+ *        table, its initial stack, its reset handler.
+ */
+static void Boot_Jump(void) __attribute__((noreturn));
+static void Boot_Jump(void) {
+	const uint32_t *vectors = (const uint32_t*) BOOT_APP_BASE;
+	void (*entry)(void) = (void (*)(void)) vectors[1];
+
+	RCC->AHB1RSTR |= RCC_AHB1RSTR_CRCRST;
+	RCC->AHB1RSTR &= ~RCC_AHB1RSTR_CRCRST;
+	RCC->AHB1ENR &= ~RCC_AHB1ENR_CRCEN;
+	SCB->VTOR = BOOT_APP_BASE;
+	__DSB();
+	__ISB();
+	__set_MSP(vectors[0]);
+	entry();
+	for (;;) {
+	}
+}
+
+/**
+ * @brief Waits for the flash controller and clears its flags.
+ * @retval Error flags of the operation, 0 if none.
+ */
+static uint32_t Boot_FlashWait(void) {
+	uint32_t err;
+
+	while ((FLASH->SR & FLASH_SR_BSY) != 0U) {
+	}
+	err = FLASH->SR & BOOT_FLASH_ERR;
+	FLASH->SR = err | FLASH_SR_EOP;
+	return err;
+}
+
+/**
+ * @brief Erases one sector; the CPU stalls on flash meanwhile, DMA does not.
+ */
+static uint32_t Boot_FlashErase(uint32_t sector) {
+	uint32_t err;
+
+	Boot_Kick();
+	(void) Boot_FlashWait();
+	FLASH->CR = FLASH_CR_PSIZE_1 | FLASH_CR_SER | (sector << FLASH_CR_SNB_Pos);
+	FLASH->CR |= FLASH_CR_STRT;
+	err = Boot_FlashWait();
+	FLASH->CR = 0U;
+	Boot_Kick();
+	return err;
+}
+
+/**
+ * @brief Programs and reads back n words; words already holding their
+ *        value are left alone.
+ * @retval 0 on success.
+ */
+static uint32_t Boot_FlashProgram(uint32_t addr, const uint32_t *words,
+		uint32_t n) {
+	volatile uint32_t *dst = (volatile uint32_t*) addr;
+	uint32_t err = 0U;
+	uint32_t i;
+
+	FLASH->CR = FLASH_CR_PSIZE_1 | FLASH_CR_PG;
+	for (i = 0U; (i < n) && (err == 0U); i++) {
+		if (dst[i] == words[i]) {
+			continue;
+		}
+		if (dst[i] != 0xFFFFFFFFU) {
+			err = FLASH_SR_PGSERR; /* Not erased: a different image's word */
+			break;
+		}
+		dst[i] = words[i];
+		err = Boot_FlashWait();
+		if ((err == 0U) && (dst[i] != words[i])) {
+			err = FLASH_SR_PGPERR;
+		}
+	}
+	FLASH->CR = 0U;
+	return err;
+}
+
+/**
+ * @brief Sends one reply, polled: frames come in by DMA meanwhile.
+ */
+static void Boot_Reply(uint8_t cmd, uint8_t status, uint32_t value) {
+	boot_reply_t reply;
+	const uint8_t *p = (const uint8_t*) &reply;
+	uint32_t i;
+
+	reply.sof = BOOT_SOF;
+	reply.cmd = cmd | BOOT_REPLY_FLAG;
+	reply.status = status;
+	reply.seq = boot_seq;
+	reply.value = value;
+	for (i = 0U; i < sizeof(reply); i++) {
+		while ((USART2->SR & USART_SR_TXE) == 0U) {
+		}
+		USART2->DR = p[i];
+	}
+}
+
+/**
+ * @brief Restarts reception at a frame boundary, into buffer 0.
+ */
+static void Boot_RxStart(void) {
+	BOOT_DMA_STREAM->CR &= ~DMA_SxCR_EN;
+	while ((BOOT_DMA_STREAM->CR & DMA_SxCR_EN) != 0U) {
+	}
+	DMA1->HIFCR = BOOT_DMA_FLAGS;
+	(void) USART2->SR; /* Clears an overrun */
+	(void) USART2->DR;
+	BOOT_DMA_STREAM->NDTR = BOOT_FRAME_LEN;
+	BOOT_DMA_STREAM->CR = (4U << DMA_SxCR_CHSEL_Pos) | DMA_SxCR_DBM
+			| DMA_SxCR_PL_1 | DMA_SxCR_MINC;
+	BOOT_DMA_STREAM->CR |= DMA_SxCR_EN;
+}
+
+/**
+ * @brief USART2 on PA2/PA3 at BOOT_BAUD (oversampling by 8), receive DMA.
+ */
+static void Boot_UartInit(void) {
+	uint32_t div = (BOOT_HSI_HZ + (BOOT_BAUD / 2U)) / BOOT_BAUD; /* 1/8ths */
+
+	RCC->AHB1ENR |= RCC_AHB1ENR_GPIOAEN | RCC_AHB1ENR_DMA1EN;
+	RCC->APB1ENR |= RCC_APB1ENR_USART2EN;
+	(void) RCC->APB1ENR;
+
+	GPIOA->AFR[0] = (GPIOA->AFR[0] & ~0x0000FF00U) | 0x00007700U; /* AF7 */
+	GPIOA->OSPEEDR |= (3U << (2U * 2U));
+	GPIOA->PUPDR = (GPIOA->PUPDR & ~(3U << (3U * 2U))) | (1U << (3U * 2U));
+	GPIOA->MODER = (GPIOA->MODER & ~(0xFU << (2U * 2U))) | (0xAU << (2U * 2U));
+
+	USART2->BRR = ((div >> 3) << 4) | (div & 7U);
+	USART2->CR3 = USART_CR3_DMAR;
+	USART2->CR1 = USART_CR1_OVER8 | USART_CR1_TE | USART_CR1_RE | USART_CR1_UE;
+
+	BOOT_DMA_STREAM->PAR = (uint32_t) &USART2->DR;
+	BOOT_DMA_STREAM->M0AR = (uint32_t) boot_rx[0];
+	BOOT_DMA_STREAM->M1AR = (uint32_t) boot_rx[1];
+	Boot_RxStart();
+}
+
+/**
+ * @brief Erases the application sectors [off, off + len) touches that this
+ *        session has not erased yet.
+ */
+static uint32_t Boot_EraseRange(uint32_t off, uint32_t len) {
+	uint32_t start = 0U;
+	uint32_t err = 0U;
+	uint32_t i;
+
+	for (i = 0U; (i < BOOT_APP_SECTORS) && (err == 0U); i++) {
+		if ((off < boot_sector_end[i]) && ((off + len) > start)
+				&& ((boot_erased & (1U << i)) == 0U)) {
+			err = Boot_FlashErase(BOOT_APP_SECTOR + i);
+			if (err == 0U) {
+				boot_erased |= (uint8_t) (1U << i);
+			}
+		}
+		start = boot_sector_end[i];
+	}
+	return err;
+}
+
+/**
+ * @brief Seals the image: descriptor words after the image checked out.
+ *        Repeating it rewrites the same words, so a resent END passes.
+ */
+static uint8_t Boot_End(uint32_t *crc) {
+	uint32_t desc[4];
+
+	*crc = Boot_Crc((const uint32_t*) BOOT_APP_BASE, boot_size / 4U);
+	if (*crc != boot_crc) {
+		return BOOT_ERR_IMAGE;
+	}
+	desc[0] = BOOT_DESC_MAGIC;
+	desc[1] = boot_size;
+	desc[2] = boot_crc;
+	desc[3] = ~(desc[0] ^ desc[1] ^ desc[2]);
+	if (Boot_FlashProgram(BOOT_DESC_BASE, desc, 4U) != 0U) {
+		return BOOT_ERR_FLASH;
+	}
+	boot_sealed = 1U;
+	return BOOT_OK;
+}
+
+/**
+ * @brief Handles one received frame and replies.
+ * @retval 1 after a valid frame.
+ */
+static uint8_t Boot_Handle(const uint32_t *frame) {
+	const boot_frame_hdr_t *hdr = (const boot_frame_hdr_t*) frame;
+	const uint32_t *payload = &frame[BOOT_HDR_LEN / 4U];
+	uint32_t value = hdr->arg;
+	uint8_t status = BOOT_OK;
+
+	if ((hdr->sof != BOOT_SOF)
+			|| (Boot_Crc(frame, BOOT_CRC_WORDS) != frame[BOOT_CRC_WORDS])) {
+		Boot_Reply(hdr->cmd, BOOT_ERR_CRC, value);
+		return 0U;
+	}
+	boot_seq++;
+
+	switch (hdr->cmd) {
+	case BOOT_CMD_INFO:
+		value = BOOT_VERSION | ((uint32_t) Boot_ImageValid() << 8);
+		break;
+	case BOOT_CMD_BEGIN:
+		if ((hdr->arg < 8U) || (hdr->arg > BOOT_APP_SIZE)
+				|| ((hdr->arg & 3U) != 0U)) {
+			status = BOOT_ERR_RANGE;
+		} else if (Boot_FlashErase(BOOT_DESC_SECTOR) != 0U) {
+			status = BOOT_ERR_FLASH;
+		} else {
+			boot_size = hdr->arg;
+			boot_crc = payload[0];
+			boot_erased = 0U;
+			boot_begun = 1U;
+			boot_sealed = 0U;
+		}
+		break;
+	case BOOT_CMD_WRITE:
+		if (boot_begun == 0U) {
+			status = BOOT_ERR_STATE;
+		} else if ((hdr->len == 0U) || (hdr->len > BOOT_CHUNK) || ((hdr->len & 3U) != 0U)
+				|| ((hdr->arg & 3U) != 0U) || (hdr->len > boot_size)
+				|| (hdr->arg > (boot_size - hdr->len))) {
+			status = BOOT_ERR_RANGE;
+		} else if ((Boot_EraseRange(hdr->arg, hdr->len) != 0U)
+				|| (Boot_FlashProgram(BOOT_APP_BASE + hdr->arg, payload,
+						hdr->len / 4U) != 0U)) {
+			status = BOOT_ERR_FLASH;
+		} else {
+			value = hdr->arg + hdr->len;
+		}
+		break;
+	case BOOT_CMD_END:
+		status = (boot_begun == 0U) ? BOOT_ERR_STATE : Boot_End(&value);
+		break;
+	case BOOT_CMD_RUN:
+		Boot_Reply(hdr->cmd, BOOT_OK, value);
+		while ((USART2->SR & USART_SR_TC) == 0U) {
+		}
+		NVIC_SystemReset();
+		break;
+	default:
+		status = BOOT_ERR_CMD;
+		break;
+	}
+	Boot_Reply(hdr->cmd, status, value);
+	return 1U;
+}
+
+/**
+ * @brief Update loop: one frame per buffer swap, a restart on a stalled
+ *        frame, a reset into a valid or just sealed image once the host
+ *        has gone quiet.
+ */
+static void Boot_Serve(uint8_t requested) __attribute__((noreturn));
+static void Boot_Serve(uint8_t requested) {
+	uint8_t may_leave = ((requested != 0U) && (Boot_ImageValid() != 0U)) ?
+			1U : 0U;
+	uint32_t last_ms = 0U;
+	uint32_t stall_ms = 0U;
+	uint32_t ndtr = BOOT_FRAME_LEN;
+	uint32_t now;
+	uint8_t next = 0U;
+
+	SysTick->LOAD = (BOOT_HSI_HZ / 1000U) - 1U;
+	SysTick->VAL = 0U;
+	SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+	FLASH->KEYR = BOOT_FLASH_KEY1;
+	FLASH->KEYR = BOOT_FLASH_KEY2;
+	Boot_UartInit();
+
+	for (;;) {
+		Boot_Kick();
+		now = Boot_Tick();
+		if ((DMA1->HISR & DMA_HISR_TCIF5) != 0U) {
+			DMA1->HIFCR = DMA_HIFCR_CTCIF5;
+			if (Boot_Handle(boot_rx[next]) != 0U) {
+				last_ms = now;
+			}
+			next ^= 1U;
+			continue;
+		}
+		if (BOOT_DMA_STREAM->NDTR != ndtr) {
+			ndtr = BOOT_DMA_STREAM->NDTR;
+			stall_ms = now;
+		} else if ((ndtr != BOOT_FRAME_LEN)
+				&& ((now - stall_ms) >= BOOT_SYNC_MS)) {
+			Boot_Reply(0U, BOOT_ERR_SYNC, BOOT_FRAME_LEN - ndtr);
+			Boot_RxStart();
+			ndtr = BOOT_FRAME_LEN;
+			next = 0U;
+		}
+		if ((((may_leave != 0U) && (boot_begun == 0U)) || (boot_sealed != 0U))
+				&& ((now - last_ms) >= BOOT_IDLE_MS)) {
+			NVIC_SystemReset(); /* The request is cleared: the image starts */
+		}
+	}
+}
+
+int main(void) {
+	uint8_t requested = Boot_Requested();
+
+	RCC->AHB1ENR |= RCC_AHB1ENR_CRCEN;
+	(void) RCC->AHB1ENR;
+	if ((requested == 0U) && (Boot_ButtonHeld() == 0U)
+			&& (Boot_ImageValid() != 0U)) {
+		Boot_Jump();
+	}
+	Boot_Serve(requested);
+}
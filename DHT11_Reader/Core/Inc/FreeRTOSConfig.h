@@ -0,0 +1,91 @@
+/**
+ ******************************************************************************
+ * @file           : FreeRTOSConfig.h
+ * @brief          : FreeRTOS kernel configuration for the APP_USE_RTOS build.
+ *
+ *                   Static allocation only (no heap_x.c needed), 1 kHz
+ *                   tick, preemptive without time slicing: tasks of
+ *                   app_rtos.h have distinct priorities. No interrupt
+ *                   handler calls the kernel, so the capture and timebase
+ *                   levels of irq_prio.h may sit above
+ *                   configMAX_SYSCALL_INTERRUPT_PRIORITY; tasks
+ *                   communicate through a lock-free ring and direct
+ *                   notifications.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+#if defined(__ICCARM__) || defined(__CC_ARM) || defined(__GNUC__)
+#include <stdint.h>
+extern uint32_t SystemCoreClock;
+#endif
+
+#define configUSE_PREEMPTION                     1
+#define configUSE_TIME_SLICING                   0
+#define configSUPPORT_STATIC_ALLOCATION          1
+#define configSUPPORT_DYNAMIC_ALLOCATION         0
+#define configUSE_IDLE_HOOK                      1
+#define configUSE_TICK_HOOK                      0
+#define configCPU_CLOCK_HZ                       (SystemCoreClock)
+#define configTICK_RATE_HZ                       ((TickType_t) 1000)
+#define configMAX_PRIORITIES                     (5)
+#define configMINIMAL_STACK_SIZE                 ((uint16_t) 128)
+#define configMAX_TASK_NAME_LEN                  (12)
+#define configUSE_16_BIT_TICKS                   0
+#define configUSE_MUTEXES                        1
+#define configUSE_RECURSIVE_MUTEXES              0
+#define configUSE_COUNTING_SEMAPHORES            0
+#define configUSE_TASK_NOTIFICATIONS             1
+#define configQUEUE_REGISTRY_SIZE                0
+#define configUSE_TIMERS                         0
+#define configUSE_CO_ROUTINES                    0
+#define configCHECK_FOR_STACK_OVERFLOW           2
+#define configUSE_MALLOC_FAILED_HOOK             0
+#define configUSE_TRACE_FACILITY                 0
+#define configUSE_TICKLESS_IDLE                  0
+
+/* API functions used by app_rtos.c and the CubeMX SysTick handler */
+#define INCLUDE_vTaskDelay                       1
+#define INCLUDE_vTaskDelayUntil                  1
+#define INCLUDE_xTaskGetSchedulerState           1
+#define INCLUDE_uxTaskPriorityGet                1
+#define INCLUDE_uxTaskGetStackHighWaterMark      1
+#define INCLUDE_xTaskAbortDelay                  1
+#define INCLUDE_vTaskPrioritySet                 0
+#define INCLUDE_vTaskDelete                      0
+#define INCLUDE_vTaskSuspend                     0
+
+/* Cortex-M specific definitions */
+#ifdef __NVIC_PRIO_BITS
+#define configPRIO_BITS                          __NVIC_PRIO_BITS
+#else
+#define configPRIO_BITS                          4
+#endif
+
+/* Lowest priority for the kernel interrupts (SysTick, PendSV) */
+#define configLIBRARY_LOWEST_INTERRUPT_PRIORITY      15
+
+/* Highest priority from which ISR-safe kernel calls would be allowed.
+ * None are made today; an ISR that starts using FromISR calls must be
+ * moved to this priority or lower (numerically >= 5). */
+#define configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY 5
+
+#define configKERNEL_INTERRUPT_PRIORITY \
+	(configLIBRARY_LOWEST_INTERRUPT_PRIORITY << (8 - configPRIO_BITS))
+#define configMAX_SYSCALL_INTERRUPT_PRIORITY \
+	(configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY << (8 - configPRIO_BITS))
+
+#define configASSERT(x) if ((x) == 0) { taskDISABLE_INTERRUPTS(); for (;;); }
+
+/* Map the port's handlers onto the CMSIS vector names; stm32f4xx_it.c
+ * leaves SVC_Handler and PendSV_Handler out of the RTOS build */
+#define vPortSVCHandler    SVC_Handler
+#define xPortPendSVHandler PendSV_Handler
+
+#endif /* FREERTOS_CONFIG_H */
@@ -0,0 +1,135 @@
+/**
+ ******************************************************************************
+ * @file           : adc_mon.h
+ * @brief          : ADC1 monitor: die temperature, supply voltage and
+ *                   optional analog inputs.
+ *
+ *                   TIM3 TRGO starts one ADC1 scan ADC_MON_SCAN_HZ times a
+ *                   second: VREFINT (IN17), the temperature sensor (IN18)
+ *                   and, with ADC_MON_USE_EXT, A2 (PA4, IN4) and A3 (PB0,
+ *                   IN8). DMA2 Stream4 stores the scans into a circular
+ *                   buffer of ADC_MON_SCANS, so the conversions cost the CPU
+ *                   nothing until a value is asked for. ADC1 has no
+ *                   hardware oversampling on the F446; Adc_Mon_Get()
+ *                   averages the buffer instead, 16 scans for two more bits,
+ *                   and converts with the factory calibration values:
+ *                     - VDDA from VREFINT_CAL (taken at 3.3 V);
+ *                     - die temperature between TS_CAL1 (30 C) and TS_CAL2
+ *                       (110 C), scaled to the measured VDDA;
+ *                     - the analog inputs in mV of the measured VDDA.
+ *
+ *                   The analog watchdog guards VREFINT alone: a supply
+ *                   below ADC_MON_BROWNOUT_MV raises VREFINT's reading past
+ *                   the high threshold and interrupts once (ADC, wakeup
+ *                   level). The handler then swaps the window so the next
+ *                   interrupt is the recovery, ADC_MON_BROWNOUT_HYST_MV up,
+ *                   so an unsteady supply does not storm.
+ *
+ *                   Adc_Mon_Check() runs on every emitted DHT11 reading:
+ *                   the die runs warmer than the air, but a sensor more
+ *                   than ADC_MON_TEMP_TOLERANCE away from it is counted as
+ *                   a disagreement, a cheap sanity check on the sensor.
+ *
+ *                   STOP halts TIM3 and the scans resume on wake.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef ADC_MON_H_
+#define ADC_MON_H_
+
+#include "main.h"
+#include "dht11.h"
+
+/* Set to 0 to leave ADC1, TIM3 and DMA2 Stream4 unused */
+#define ADC_MON_USE_ADC (1)
+
+/* Set to 1 to also scan A2 (PA4) and A3 (PB0) */
+#define ADC_MON_USE_EXT (0)
+
+/** Scans per second, on TIM3 update */
+#define ADC_MON_SCAN_HZ            (100U)
+
+/** Scans in the circular buffer, averaged by Adc_Mon_Get() */
+#define ADC_MON_SCANS              (16U)
+
+/** VDDA below which the supply counts as browned out */
+#define ADC_MON_BROWNOUT_MV        (2900U)
+
+/** Rise above ADC_MON_BROWNOUT_MV that ends a brownout */
+#define ADC_MON_BROWNOUT_HYST_MV   (100U)
+
+/** Largest DHT11 to die temperature difference that is plausible, 0.1 C */
+#define ADC_MON_TEMP_TOLERANCE     (150)
+
+/** Analog inputs scanned */
+#if ADC_MON_USE_EXT
+#define ADC_MON_EXT_INPUTS         (2U)
+#else
+#define ADC_MON_EXT_INPUTS         (0U)
+#endif /* ADC_MON_USE_EXT */
+
+#if ADC_MON_USE_ADC
+#define ADC_MON_CHECK(reading)     Adc_Mon_Check(reading)
+#else
+#define ADC_MON_CHECK(reading)     ((void) 0)
+#endif /* ADC_MON_USE_ADC */
+
+/**
+ * @brief Averaged values of the last ADC_MON_SCANS scans.
+ */
+typedef struct {
+	uint32_t vdda_mv;
+	int32_t die_tenths;   /*!< Die temperature, 0.1 C */
+	uint32_t ext_mv[2];   /*!< A2, A3; 0 without ADC_MON_USE_EXT */
+	uint8_t valid;        /*!< The buffer holds ADC_MON_SCANS scans */
+} adc_mon_values_t;
+
+/**
+ * @brief Monitor counters.
+ */
+typedef struct {
+	uint32_t brownouts;   /*!< Supply dips below ADC_MON_BROWNOUT_MV    */
+	uint32_t last_ms;     /*!< HAL tick of the last one                */
+	uint32_t overruns;    /*!< Scans lost and the DMA restarted        */
+	uint32_t checked;     /*!< Readings compared with the die          */
+	uint32_t disagree;    /*!< Of those, beyond ADC_MON_TEMP_TOLERANCE */
+	uint8_t low;          /*!< In a brownout now                       */
+} adc_mon_stats_t;
+
+/**
+ * @brief Configures ADC1, DMA2 Stream4 and TIM3 and starts the scans.
+ *        Call after Timebase_Init().
+ */
+void Adc_Mon_Init(void);
+
+/**
+ * @brief Averages the buffer into calibrated values. Thread context.
+ */
+void Adc_Mon_Get(adc_mon_values_t *values);
+
+/**
+ * @brief Compares an emitted DHT11 reading with the die temperature.
+ */
+void Adc_Mon_Check(const dht11_reading_t *reading);
+
+/**
+ * @brief Fills the monitor counters.
+ */
+void Adc_Mon_GetStats(adc_mon_stats_t *stats);
+
+/**
+ * @brief Recomputes the TIM3 prescaler after a clock profile change.
+ */
+void Adc_Mon_ClockChanged(void);
+
+/**
+ * @brief ADC interrupt: analog watchdog and overrun. Called from
+ *        ADC_IRQHandler().
+ */
+void Adc_Mon_IRQHandler(void);
+
+#endif /* ADC_MON_H_ */
@@ -0,0 +1,67 @@
+/**
+ ******************************************************************************
+ * @file           : app_bench.h
+ * @brief          : On-target micro-benchmarks of the driver APIs.
+ *
+ *                   The Bench configuration of the project (next to Debug
+ *                   and Release in .cproject) is the Release build with
+ *                   APP_USE_BENCH=1 defined. Its main() runs
+ *                   AppBench_Run() once, after init and before the
+ *                   watchdog starts, then carries on as the normal
+ *                   firmware.
+ *
+ *                   Each case is timed with the DWT cycle counter over
+ *                   APP_BENCH_RUNS calls, with interrupts from
+ *                   IRQ_PRIO_TIMEBASE down masked unless the case needs
+ *                   them (the TX drain, the frame read). The cost of an
+ *                   empty call through the same harness is subtracted.
+ *                   The whole table is repeated at every clock profile
+ *                   (clock_config.h) and the original profile restored.
+ *
+ *                   The rows are comma-separated, one per case and
+ *                   profile, with the build date and the backends built
+ *                   in the header, so runs on different commits and
+ *                   profiles can be diffed as text:
+ *                     bench,<profile>,<sysclk_hz>,<case>,<backend>,<runs>,
+ *                       <min_cyc>,<med_cyc>,<max_cyc>,<med_ns>,<fails>
+ *                   Backends that are chosen at compile time (the UART TX
+ *                   drain, the PA1 decoder) are timed as built and named
+ *                   in the backend column; the HAL, LL and register GPIO
+ *                   paths and both sensor decoders are timed side by side.
+ *
+ *                   The decoder cases run on synthetic frames built from
+ *                   the nominal bit widths; the classifier, drift and
+ *                   profile state they touch is reset afterwards, so the
+ *                   firmware starts as from boot.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef APP_BENCH_H_
+#define APP_BENCH_H_
+
+#include "main.h"
+
+/* Set to 1 (the Bench configuration passes -DAPP_USE_BENCH=1) to run the
+ * micro-benchmarks at boot */
+#ifndef APP_USE_BENCH
+#define APP_USE_BENCH (0)
+#endif /* APP_USE_BENCH */
+
+/** Timed calls per case; the frame read uses APP_BENCH_FRAME_RUNS */
+#define APP_BENCH_RUNS        (32U)
+
+/** Frame reads per profile, each one minimum spacing after the last */
+#define APP_BENCH_FRAME_RUNS  (3U)
+
+/**
+ * @brief Runs every case at every clock profile and prints the table.
+ *        Call after init, before Watchdog_Start(), with the scheduler
+ *        not yet running.
+ */
+void AppBench_Run(void);
+
+#endif /* APP_BENCH_H_ */
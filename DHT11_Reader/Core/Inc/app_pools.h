@@ -0,0 +1,87 @@
+/**
+ ******************************************************************************
+ * @file           : app_pools.h
+ * @brief          : Fixed-block pools (pool.h) of the application, and the
+ *                   heap-free build.
+ *
+ *                   Three compile-time sized pools replace dynamic memory:
+ *                     - readings: dht11_reading_t, for handing a reading
+ *                       to a later stage without copying it into a ring;
+ *                     - packets:  one telemetry frame buffer, large enough
+ *                       for the COBS-encoded history and flash log dump
+ *                       packets, which used to be on the caller's stack;
+ *                     - records:  history_record_t log records.
+ *                   Alloc and Free are O(1) and any context may call them;
+ *                   an empty pool returns NULL and the caller retries or
+ *                   drops. "stats" shows each pool's low-water mark and
+ *                   the failed allocations.
+ *
+ *                   printf no longer needs the heap either: UART_TX_Init()
+ *                   gives stdout a static line buffer instead of the one
+ *                   newlib would malloc() on first use.
+ *
+ *                   With APP_NO_HEAP set, nothing may link the C library
+ *                   allocator: sysmem.c's _sbrk() is replaced by one that
+ *                   references the undefined APP_NO_HEAP_malloc_is_linked,
+ *                   so any malloc(), calloc() or strdup() in the image,
+ *                   direct or inside newlib, fails the link with that
+ *                   name. -ffunction-sections and --gc-sections (the
+ *                   CubeIDE defaults) keep the unused _sbrk() out of it.
+ *                   Float printf (-u _printf_float) allocates and must
+ *                   stay off; some older newlib-nano releases also
+ *                   malloc() the stdio FILE objects, and need APP_NO_HEAP 0
+ *                   unless FMT_PRINTF_SHIM (fmt.h) takes stdio out.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef APP_POOLS_H_
+#define APP_POOLS_H_
+
+#include "main.h"
+#include "pool.h"
+#include "dht11.h"
+#include "history.h"
+
+/* Set to 1 to fail the link if anything uses the C library heap */
+#define APP_NO_HEAP (0)
+
+/** Blocks per pool */
+#define APP_POOL_READINGS     (4U)
+#define APP_POOL_PACKETS      (1U)  /*!< Drains run in one context */
+#define APP_POOL_RECORDS      (4U)
+
+/** Bytes in a packet buffer: a COBS-encoded dump frame fits */
+#define APP_POOL_PACKET_SIZE  (256U)
+
+/**
+ * @brief One packet buffer.
+ */
+typedef struct {
+	uint8_t data[APP_POOL_PACKET_SIZE];
+} app_packet_t;
+
+POOL_DEFINE(app_reading_pool_t, AppReadingPool, dht11_reading_t,
+		APP_POOL_READINGS)
+POOL_DEFINE(app_packet_pool_t, AppPacketPool, app_packet_t, APP_POOL_PACKETS)
+POOL_DEFINE(app_record_pool_t, AppRecordPool, history_record_t,
+		APP_POOL_RECORDS)
+
+extern app_reading_pool_t app_reading_pool;
+extern app_packet_pool_t app_packet_pool;
+extern app_record_pool_t app_record_pool;
+
+/**
+ * @brief Marks every block of every pool free. Call once, early.
+ */
+void AppPools_Init(void);
+
+/**
+ * @brief Prints "pool_<name>_min" lines and the total "pool_fails".
+ */
+void AppPools_Dump(void);
+
+#endif /* APP_POOLS_H_ */
@@ -0,0 +1,86 @@
+/**
+ ******************************************************************************
+ * @file           : app_rtos.h
+ * @brief          : Optional FreeRTOS build with a top-priority sensor task.
+ *
+ *                   With APP_USE_RTOS set, main() hands over to
+ *                   AppRtos_Start() instead of the cooperative scheduler
+ *                   (sched.h). Three tasks with fixed, distinct priorities:
+ *                     - sensor    (highest): one blocking DHT11_Read() (or
+ *                       DHT11_Multi_Read() of the channels due) as the
+ *                       sampling plan (dht11_sampler.h) asks, paced with
+ *                       vTaskDelayUntil(). Readings go into the lock-free
+ *                       dht11_queue.h ring; the task never formats,
+ *                       prints or touches flash;
+ *                     - telemetry (middle): drains the ring into the sink
+ *                       (UART, backup SRAM history, flash log);
+ *                     - service   (lowest): CLI, deferred debug log and
+ *                       flash log dumps.
+ *                   Only telemetry and service print, and a mutex keeps
+ *                   their output apart; the sensor task takes no lock.
+ *
+ *                   HAL_Delay() yields to the other tasks once the
+ *                   scheduler runs, so the 18 ms start pulse and retry
+ *                   spacing no longer hold the CPU. The edge-sensitive
+ *                   window, from releasing the line to arming the capture,
+ *                   is a short critical section in DHT11_Capture_Arm().
+ *
+ *                   The port takes SVC, PendSV and SysTick
+ *                   (FreeRTOSConfig.h); the HAL tick moves to TIM7
+ *                   (stm32f4xx_hal_timebase_tim.c). POWER_USE_STOP and
+ *                   DHT11_USE_ASYNC must be 0: the port runs without
+ *                   tickless idle, and the sensor task owns TIM5. A flash
+ *                   sector erase still stalls every task, sensor included,
+ *                   since code executes from flash.
+ *
+ *                   Requires the FreeRTOS kernel (CubeMX: Middlewares/
+ *                   Third_Party/FreeRTOS, GCC/ARM_CM4F port) in the build.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef APP_RTOS_H_
+#define APP_RTOS_H_
+
+#include "main.h"
+
+/* Set to 1 to run on FreeRTOS, 0 for the cooperative scheduler */
+#define APP_USE_RTOS (0)
+
+/** Task priorities; configMAX_PRIORITIES must be above the highest */
+#define APP_RTOS_PRIO_SERVICE    (1U)
+#define APP_RTOS_PRIO_TELEMETRY  (2U)
+#define APP_RTOS_PRIO_SENSOR     (3U)
+
+/** Task stacks in words */
+#define APP_RTOS_STACK_SENSOR    (256U)
+#define APP_RTOS_STACK_TELEMETRY (384U)
+#define APP_RTOS_STACK_SERVICE   (384U)
+
+/** Service poll period */
+#define APP_RTOS_SERVICE_MS      (10U)
+
+/**
+ * @brief Creates the tasks and starts the scheduler. Does not return.
+ */
+void AppRtos_Start(void);
+
+/**
+ * @brief Reprograms the kernel tick after a clock profile change.
+ */
+void AppRtos_ClockChanged(void);
+
+/**
+ * @brief Prints one line per task (stack headroom) and the queue drops.
+ */
+void AppRtos_Dump(void);
+
+/**
+ * @brief Readings dropped because the telemetry task fell behind.
+ */
+uint32_t AppRtos_GetDropped(void);
+
+#endif /* APP_RTOS_H_ */
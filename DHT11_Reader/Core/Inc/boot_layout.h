@@ -0,0 +1,135 @@
+/**
+ ******************************************************************************
+ * @file           : boot_layout.h
+ * @brief          : Flash layout and update protocol of the resident
+ *                   bootloader (Bootloader/), shared by the bootloader, the
+ *                   application and the host uploader (Tools/fwupdate).
+ *
+ *                   Only <stdint.h> is needed: the bootloader is built
+ *                   without the HAL.
+ *
+ *                   Flash:
+ *                     sector 0    0x08000000  16 KB   bootloader
+ *                     sector 1    0x08004000  16 KB   image descriptor
+ *                     sectors 2-3 0x08008000  32 KB   settings, A/B (config.h)
+ *                     sectors 4-5 0x08010000  192 KB  application
+ *                     sectors 6-7 0x08040000  256 KB  flash log (flashlog.h)
+ *                   The application links at BOOT_APP_BASE
+ *                   (STM32F446RETX_FLASH.ld) and points VTOR there
+ *                   (system_stm32f4xx.c). An update erases only the
+ *                   descriptor and application sectors, so the saved
+ *                   settings survive it.
+ *
+ *                   The bootloader starts the application when the
+ *                   descriptor is sealed and the image's CRC-32/MPEG-2
+ *                   matches, unless RTC_BKP1R holds BOOT_REQUEST_MAGIC
+ *                   (the CLI "update" command) or the user button is held
+ *                   through reset.
+ *
+ *                   Protocol: USART2 at BOOT_BAUD, 8N1. Each host frame is
+ *                   BOOT_FRAME_LEN bytes whatever it carries: the
+ *                   boot_frame_hdr_t header, BOOT_CHUNK payload bytes
+ *                   (unused ones 0xFF) and the CRC-32/MPEG-2 of header and
+ *                   payload as words, little-endian. The fixed length lets
+ *                   receive DMA take whole frames into alternate buffers
+ *                   with no per-byte work. Each frame is answered by a
+ *                   boot_reply_t; the host may have two frames in flight.
+ *                   Frame flow and commands: Docs/bootloader.md.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef BOOT_LAYOUT_H_
+#define BOOT_LAYOUT_H_
+
+#include <stdint.h>
+
+/** Flash layout */
+#define BOOT_BASE            (0x08000000U)
+#define BOOT_SIZE            (16U * 1024U)
+#define BOOT_DESC_BASE       (0x08004000U)  /*!< Sector 1               */
+#define BOOT_DESC_SECTOR     (1U)
+#define BOOT_CONFIG_BASE     (0x08008000U)  /*!< Sectors 2 and 3          */
+#define BOOT_CONFIG_SECTOR   (2U)           /*!< Copy A; copy B follows  */
+#define BOOT_CONFIG_SIZE     (16U * 1024U)  /*!< Per copy                */
+#define BOOT_APP_BASE        (0x08010000U)  /*!< Multiple of 0x200 (VTOR) */
+#define BOOT_APP_SIZE        (192U * 1024U)
+#define BOOT_APP_SECTOR      (4U)           /*!< First application sector */
+#define BOOT_APP_SECTORS     (2U)
+
+/** RTC_BKP1R value asking the bootloader to stay for an update */
+#define BOOT_REQUEST_MAGIC   (0xB0070001U)
+
+/** Descriptor magic, "APP1" */
+#define BOOT_DESC_MAGIC      (0x31505041U)
+
+/** Protocol */
+#define BOOT_BAUD            (1000000U)
+#define BOOT_VERSION         (1U)
+#define BOOT_SOF             (0xA5U)
+#define BOOT_CHUNK           (4096U)
+#define BOOT_HDR_LEN         (8U)
+#define BOOT_FRAME_LEN       (BOOT_HDR_LEN + BOOT_CHUNK + 4U)
+#define BOOT_REPLY_LEN       (8U)
+
+/** Commands; the reply's cmd byte has BOOT_REPLY_FLAG set */
+#define BOOT_CMD_INFO        (0x01U)  /*!< value: version, arg echoed     */
+#define BOOT_CMD_BEGIN       (0x02U)  /*!< arg: size, payload word 0: CRC */
+#define BOOT_CMD_WRITE       (0x03U)  /*!< arg: offset, len: bytes        */
+#define BOOT_CMD_END         (0x04U)  /*!< Check the image, seal it       */
+#define BOOT_CMD_RUN         (0x05U)  /*!< Reset into the application     */
+#define BOOT_REPLY_FLAG      (0x80U)
+
+/** Reply status */
+#define BOOT_OK              (0x00U)
+#define BOOT_ERR_CRC         (0x01U)  /*!< Frame CRC: resend              */
+#define BOOT_ERR_SYNC        (0x02U)  /*!< Frame cut by an idle line: resend */
+#define BOOT_ERR_CMD         (0x03U)
+#define BOOT_ERR_RANGE       (0x04U)  /*!< Size, offset or alignment      */
+#define BOOT_ERR_STATE       (0x05U)  /*!< WRITE or END before BEGIN      */
+#define BOOT_ERR_FLASH       (0x06U)  /*!< Erase, program or read-back    */
+#define BOOT_ERR_IMAGE       (0x07U)  /*!< Image CRC does not match BEGIN */
+
+/**
+ * @brief Image descriptor, first words of sector 1.
+ */
+typedef struct {
+	uint32_t magic;          /*!< BOOT_DESC_MAGIC                       */
+	uint32_t size;           /*!< Image bytes, a multiple of 4          */
+	uint32_t crc;            /*!< CRC-32/MPEG-2 of the image words      */
+	uint32_t check;          /*!< ~(magic ^ size ^ crc)                 */
+} boot_desc_t;
+
+/**
+ * @brief Host frame header.
+ */
+typedef struct __attribute__((packed)) {
+	uint8_t sof;             /*!< BOOT_SOF                              */
+	uint8_t cmd;
+	uint16_t len;            /*!< Payload bytes used, a multiple of 4   */
+	uint32_t arg;
+} boot_frame_hdr_t;
+
+/**
+ * @brief Reply to one frame.
+ */
+typedef struct __attribute__((packed)) {
+	uint8_t sof;             /*!< BOOT_SOF                              */
+	uint8_t cmd;             /*!< Frame cmd | BOOT_REPLY_FLAG           */
+	uint8_t status;
+	uint8_t seq;             /*!< Frames handled, low byte              */
+	uint32_t value;          /*!< Per command, or the frame's arg       */
+} boot_reply_t;
+
+#ifdef __cplusplus
+static_assert(sizeof(boot_frame_hdr_t) == BOOT_HDR_LEN, "boot header");
+static_assert(sizeof(boot_reply_t) == BOOT_REPLY_LEN, "boot reply");
+#else
+_Static_assert(sizeof(boot_frame_hdr_t) == BOOT_HDR_LEN, "boot header");
+_Static_assert(sizeof(boot_reply_t) == BOOT_REPLY_LEN, "boot reply");
+#endif
+
+#endif /* BOOT_LAYOUT_H_ */
@@ -0,0 +1,188 @@
+/**
+ ******************************************************************************
+ * @file           : can_bus.h
+ * @brief          : bxCAN (CAN1) transport for multi-node sensor networks.
+ *
+ *                   Every reading the emission policy lets through
+ *                   (dht11_emit.h) goes out as one 8-byte data frame with
+ *                   a 29-bit extended identifier, whatever the active
+ *                   sink, so any number of nodes share one bus and an
+ *                   aggregator only listens; arbitration is done by the
+ *                   hardware and nobody polls.
+ *
+ *                   Identifier, bits:
+ *                     28..24  kind    CAN_BUS_KIND_*, lowest wins the bus
+ *                     23..16  node    sender of a reading, target of a
+ *                                     command (CAN_BUS_NODE_ALL = all)
+ *                     15..8   sensor  dht11_reading_t.sensor_id
+ *                      7..0   0
+ *
+ *                   Reading payload:
+ *                     0     status       dht11_status_t
+ *                     1     confidence   0-100
+ *                     2..5  raw[0..3]    sensor bytes, as in telemetry
+ *                                        type 0x01 (the CAN CRC replaces
+ *                                        the checksum byte)
+ *                     6     retries
+ *                     7     seq          per node, to spot lost frames
+ *
+ *                   Command frames carry 1-8 bytes of CLI text, so a
+ *                   master drives a node with the same commands as on the
+ *                   UART, split over as many frames as needed and ended
+ *                   by CR. Two filter banks pass only command frames for
+ *                   this node and for CAN_BUS_NODE_ALL into FIFO 0; the
+ *                   CPU never sees other nodes' readings. Replies go to
+ *                   the console transport (uart_tx.h), not to the bus.
+ *
+ *                   Outgoing frames wait in a CAN_BUS_TX_QUEUE ring; the
+ *                   three TX mailboxes are refilled from the mailbox-empty
+ *                   interrupt and leave in queue order (TXFP). Frames that
+ *                   find the ring full are counted and dropped. Bus-off is
+ *                   left automatically after 128 x 11 recessive bits
+ *                   (ABOM).
+ *
+ *                   Bit timing is derived from PCLK1 for CAN_BUS_BITRATE
+ *                   (sample point near 87.5 %) and recomputed by
+ *                   Can_Bus_ClockChanged(). RX on PB8, TX on PB9 (AF9),
+ *                   through an external transceiver. STOP mode would stop
+ *                   the controller, so it is held off while CAN runs.
+ *
+ *                   The node ID defaults to CAN_BUS_NODE_DEFAULT and can
+ *                   be changed at runtime ("can node <id>"); it is not
+ *                   kept across resets.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef CAN_BUS_H_
+#define CAN_BUS_H_
+
+#include "main.h"
+#include "dht11.h"
+
+/* Set to 1 to build the CAN1 transport on PB8/PB9 */
+#define CAN_USE_BUS       (0)
+
+/** Nominal bit rate; 250 kbit/s reaches ~250 m of cable */
+#define CAN_BUS_BITRATE        (250000U)
+
+/** Node ID after reset, 0x00-0xFE */
+#define CAN_BUS_NODE_DEFAULT   (0x01U)
+
+/** Commands to every node */
+#define CAN_BUS_NODE_ALL       (0xFFU)
+
+/** Frame kinds, bits 28..24 of the identifier */
+#define CAN_BUS_KIND_COMMAND   (0x02U)
+#define CAN_BUS_KIND_READING   (0x08U)
+
+/** Outgoing frames waiting for a mailbox, a power of two */
+#define CAN_BUS_TX_QUEUE       (16U)
+
+/** Received command bytes, a power of two */
+#define CAN_BUS_RX_SIZE        (64U)
+
+/** Builds an identifier from its fields */
+#define CAN_BUS_ID(kind, node, sensor) \
+	((((uint32_t) (kind) & 0x1FU) << 24) | (((uint32_t) (node) & 0xFFU) << 16) \
+			| (((uint32_t) (sensor) & 0xFFU) << 8))
+
+/**
+ * @brief Counters and bus state.
+ */
+typedef struct {
+	uint32_t tx_frames;    /*!< Frames acknowledged on the bus          */
+	uint32_t tx_dropped;   /*!< Frames that found the queue full        */
+	uint32_t rx_frames;    /*!< Command frames accepted by the filters  */
+	uint32_t rx_overruns;  /*!< Frames lost to a full FIFO 0            */
+	uint32_t errors;       /*!< Error interrupts (LEC, passive, off)    */
+	uint8_t tec;           /*!< Transmit error counter                  */
+	uint8_t rec;           /*!< Receive error counter                   */
+	uint8_t passive;       /*!< Error passive                           */
+	uint8_t bus_off;
+} can_bus_stats_t;
+
+#if CAN_USE_BUS
+
+/**
+ * @brief Claims PB8/PB9, programs bit timing and filters and joins the
+ *        bus. Call after UART_TX_Init().
+ * @retval 1 if the controller synchronised with the bus, 0 otherwise
+ *         (no transceiver or bit rate unreachable from PCLK1).
+ */
+uint8_t Can_Bus_Init(void);
+
+/**
+ * @brief Reports whether the controller is in normal mode.
+ */
+uint8_t Can_Bus_IsStarted(void);
+
+/**
+ * @brief Queues one data frame with an extended identifier.
+ * @param id: 29-bit identifier, see CAN_BUS_ID().
+ * @param data: Payload.
+ * @param len: 0 to 8 bytes.
+ * @retval 1 if queued, 0 if the queue was full or CAN is off.
+ * @note  Thread context only, one producer.
+ */
+uint8_t Can_Bus_Send(uint32_t id, const uint8_t *data, uint32_t len);
+
+/**
+ * @brief Packs and queues a reading frame from this node.
+ */
+void Can_Bus_Reading(const dht11_reading_t *reading);
+
+/**
+ * @brief Copies out command bytes received since the last call.
+ * @param out: Destination buffer.
+ * @param max: Capacity of out.
+ * @retval Number of bytes copied.
+ */
+uint32_t Can_Bus_Read(uint8_t *out, uint32_t max);
+
+/**
+ * @brief Changes the node ID and reprograms the command filters.
+ * @retval 1 if changed, 0 for CAN_BUS_NODE_ALL.
+ */
+uint8_t Can_Bus_SetNode(uint8_t node);
+
+/**
+ * @brief Current node ID.
+ */
+uint8_t Can_Bus_GetNode(void);
+
+/**
+ * @brief Bit rate actually programmed, 0 if none.
+ */
+uint32_t Can_Bus_GetBitrate(void);
+
+/**
+ * @brief Copies the counters and samples the error state.
+ */
+void Can_Bus_GetStats(can_bus_stats_t *stats);
+
+/**
+ * @brief Reprograms the bit timing from the new PCLK1.
+ */
+void Can_Bus_ClockChanged(void);
+
+/**
+ * @brief Interrupt bodies; called from CAN1_TX_IRQHandler(),
+ *        CAN1_RX0_IRQHandler() and CAN1_SCE_IRQHandler().
+ */
+void Can_Bus_TxIRQHandler(void);
+void Can_Bus_Rx0IRQHandler(void);
+void Can_Bus_SceIRQHandler(void);
+
+/** Sends every emitted reading */
+#define CAN_BUS_READING(reading) Can_Bus_Reading(reading)
+
+#else
+#define Can_Bus_IsStarted()      (0U)
+#define CAN_BUS_READING(reading) ((void) 0)
+#endif /* CAN_USE_BUS */
+
+#endif /* CAN_BUS_H_ */
@@ -0,0 +1,94 @@
+/**
+ ******************************************************************************
+ * @file           : cli.h
+ * @brief          : Non-blocking line-oriented command interpreter on the
+ *                   USART2 receive ring and, when built, the USB CDC port.
+ *
+ *                   Commands (terminated by CR or LF):
+ *                     help                         list commands
+ *                     interval <ms>                DHT11 refresh period, 0 = stop
+ *                     format text|binary|delta|none|batch|schema
+ *                                                  output sink
+ *                     stats                        counters, clock state, stack
+ *                                                  and entry latency (watermark.h)
+ *                     clock low|balanced|high      switch clock profile
+ *                     prof [reset]                 DHT11 timing profile
+ *                     history [drain|clear]        backup SRAM readings
+ *                     flashlog [dump|range <from_s> <to_s>|last <s>]
+ *                                                  long-term flash log, all or
+ *                                                  a window in RTC seconds
+ *                     tasks                        task statistics, watchdog tokens
+ *                     crash                        last saved fault record
+ *                     calib [<ch> temp|hum <gain> <offset>]
+ *                                                  per-sensor calibration,
+ *                                                  gain in 1/1000, offset in 1/10
+ *                     calib path [low|balanced|high fixed|fpu]
+ *                                                  derived-metrics path per profile
+ *                     calib bench [apply]          time both paths, keep the faster
+ *                     filter [<ch> window|median|hampel|ema <v>]
+ *                                                  per-sensor filter stage,
+ *                                                  hampel k in 1/10, ema alpha in 1/1000
+ *                     emit [periodic <ms>|change <dT> <dH>|threshold <T> <H> <hyst>|heartbeat <ms>]
+ *                                                  emission policy, values in 1/10
+ *                     agg [<s> [<s>]|off|raw on|off]
+ *                                                  min/mean/max windows, raw readings
+ *                     sample [<ch> <period_ms> [<phase_ms>]]
+ *                                                  per-sensor sampling plan, 0 = off
+ *                     sensor [<ch> dht11|dht22]    per-sensor type
+ *                     perf [reset|send]            CPU load, ISR and task time
+ *                     baud [<rate>|ok]             USART2 rate, negotiated
+ *                     transport [uart|usb]         output on USART2 or USB CDC
+ *                     flow [on|off]                RTS/CTS, TX ring backpressure
+ *                     can [node <id>]              CAN bus counters, node ID
+ *                     time [<unix_s>[.<ms>]]       UTC wall clock, host sync
+ *                     latest                       last reading of every sensor
+ *                     emu [run <n>|frame <b0>..<b3> [<sum>]|timing <low> <zero> <one> [<resp> [<wait>]]|jitter <us>]
+ *                                                  loopback DHT11 emulator, bench
+ *                     glitch [<ch> <icf> <min_us>] TIM5 input filter, pulse guard
+ *                     supply [<ch> gate|always|cycle]
+ *                                                  sensor power gating, reset
+ *                     discover                     sensors present, absent ones rechecked
+ *                     drift [reset <ch>]           sensor timing drift, health events
+ *                     trace [off|failed|all|dump|clear]
+ *                                                  raw frame recorder, bulk dump
+ *                     sync [offset <ms>]           lock to the shared sync pulse
+ *                     led [ok|retrying|link_down|fault|auto]
+ *                                                  status LED pattern, forced or auto
+ *                     read                         on-demand reading, as B1 does
+ *                     adc                          VDDA, die temperature, brownouts
+ *                     gw [list|nodes <n>|period <ms>|timeout <ms>]
+ *                                                  RS-485 gateway polling, per node
+ *                     config [save|erase]          settings restored at boot, A/B in flash
+ *                     update                       reset into the bootloader
+ *
+ *                   Replies are printed as "OK ..." or "ERR ..." lines.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef CLI_H_
+#define CLI_H_
+
+#include "main.h"
+
+/** Longest accepted command line, excluding the terminator */
+#define CLI_LINE_MAX  (48U)
+
+/** Maximum tokens per line, command included */
+#define CLI_MAX_ARGS  (5U)
+
+/**
+ * @brief Resets the line buffer.
+ */
+void CLI_Init(void);
+
+/**
+ * @brief Consumes received bytes and executes complete lines. Returns
+ *        immediately when nothing has arrived; call from the main loop.
+ */
+void CLI_Poll(void);
+
+#endif /* CLI_H_ */
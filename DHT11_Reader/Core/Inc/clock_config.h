@@ -0,0 +1,94 @@
+/**
+ ******************************************************************************
+ * @file           : clock_config.h
+ * @brief          : Selectable system clock profiles for the STM32F446RE.
+ *
+ *                   Profile       SYSCLK  Source       VOS      Flash WS  APB1/APB2
+ *                   LOW_POWER     16 MHz  HSI          Scale 3  0         16/16 MHz
+ *                   BALANCED      50 MHz  HSE+PLL      Scale 3  1         25/50 MHz
+ *                   HIGH_PERF    180 MHz  HSE+PLL+OD   Scale 1  5         45/90 MHz
+ *
+ *                   BALANCED is the original CubeMX configuration. The ART
+ *                   accelerator (prefetch, instruction and data cache) is
+ *                   enabled in every profile.
+ *
+ *                   Peripheral init reads the bus clocks through HAL
+ *                   (HAL_RCC_GetPCLKxFreq) or Clock_GetApbxTimerHz(), so it
+ *                   follows whichever profile is active. After a runtime
+ *                   switch, Clock_ProfileChangedCallback() is invoked so the
+ *                   application can re-derive baud rates and prescalers.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef CLOCK_CONFIG_H_
+#define CLOCK_CONFIG_H_
+
+#include "main.h"
+
+/**
+ * @brief Available clock profiles.
+ */
+typedef enum {
+	CLOCK_PROFILE_LOW_POWER = 0,
+	CLOCK_PROFILE_BALANCED,
+	CLOCK_PROFILE_HIGH_PERF,
+	CLOCK_PROFILE_COUNT
+} clock_profile_t;
+
+/** Profile applied by SystemClock_Config() at boot */
+#define CLOCK_DEFAULT_PROFILE (CLOCK_PROFILE_HIGH_PERF)
+
+/**
+ * @brief Programs the regulator, oscillators, PLL, bus dividers and flash
+ *        wait states for a profile. Safe to call at boot or at runtime.
+ * @param profile: Profile to apply.
+ * @retval HAL status; on error the system is left running from HSI.
+ */
+HAL_StatusTypeDef Clock_ApplyProfile(clock_profile_t profile);
+
+/**
+ * @brief Turns the HSE on without waiting for it, so that its start-up
+ *        overlaps other init. Clock_ApplyProfile() then finds it ready.
+ *        Does nothing if the default profile runs from HSI.
+ */
+void Clock_StartHse(void);
+
+/**
+ * @brief Switches profile at runtime and notifies the application.
+ * @param profile: Profile to apply.
+ * @retval HAL status.
+ */
+HAL_StatusTypeDef Clock_SetProfile(clock_profile_t profile);
+
+/**
+ * @brief Returns the active profile.
+ */
+clock_profile_t Clock_GetProfile(void);
+
+/**
+ * @brief Returns a short printable name for a profile.
+ */
+const char* Clock_GetProfileName(clock_profile_t profile);
+
+/**
+ * @brief Clock feeding the APB1 timers (TIM2-7, TIM12-14).
+ * @note  Twice PCLK1 whenever the APB1 divider is not 1.
+ */
+uint32_t Clock_GetApb1TimerHz(void);
+
+/**
+ * @brief Clock feeding the APB2 timers (TIM1, TIM8-11).
+ */
+uint32_t Clock_GetApb2TimerHz(void);
+
+/**
+ * @brief Called after Clock_SetProfile() has changed the bus clocks.
+ *        Weak default does nothing; override to re-derive peripheral timing.
+ */
+void Clock_ProfileChangedCallback(clock_profile_t profile);
+
+#endif /* CLOCK_CONFIG_H_ */
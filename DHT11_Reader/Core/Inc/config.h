@@ -0,0 +1,167 @@
+/**
+ ******************************************************************************
+ * @file           : config.h
+ * @brief          : Saved settings: a versioned, CRC-checked record in its
+ *                   own flash sectors, restored at boot.
+ *
+ *                   What a host sets at runtime and expects back after a
+ *                   reset is kept in one config_record_t: the console
+ *                   rate, clock profile, output format, async refresh
+ *                   interval and, per sensor, the sampling plan, the
+ *                   sensor type and the calibration. "config save"
+ *                   captures the running values; nothing is written
+ *                   behind the host's back.
+ *
+ *                   Two copies, A in sector 2 and B in sector 3
+ *                   (boot_layout.h), each 16 KB and holding one record. A
+ *                   save erases and programs the copy that does not hold
+ *                   the newest record, with the next sequence number, and
+ *                   reads it back. Power lost at any point leaves the
+ *                   other copy whole, so the unit boots with the new
+ *                   settings or the previous ones, never with none.
+ *                   Firmware updates leave both sectors alone.
+ *
+ *                   Config_Load() runs first thing in main(), before
+ *                   SystemClock_Config() and on the reset HSI. It copies
+ *                   each copy into RAM and checks magic, version, length
+ *                   and the CRC-32 of the CRC unit (crc.h) over the
+ *                   words; the valid copy with the newer sequence wins.
+ *                   That is a few microseconds for ~230 bytes, so the
+ *                   clock comes up at the saved profile directly
+ *                   (Config_BootProfile()), the console at the saved rate
+ *                   before the first line is printed (Config_ApplyBaud())
+ *                   and the rest once its modules are set up
+ *                   (Config_Apply()). A record of another CONFIG_VERSION
+ *                   is ignored: the defaults run until the next save.
+ *
+ *                   An erase stalls the CPU for up to 0.5 s, interrupts
+ *                   included, as the flash log's does.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef CONFIG_H_
+#define CONFIG_H_
+
+#include "main.h"
+#include "clock_config.h"
+#include "dht11_sampler.h"
+
+/* Set to 0 to boot with the built-in defaults every time */
+#define CONFIG_USE_STORE (1)
+
+/** Record layout; bump when config_settings_t changes */
+#define CONFIG_VERSION   (1U)
+
+/** Record magic, "CFG1" */
+#define CONFIG_MAGIC     (0x31474643U)
+
+/** Sensors with saved settings; the sampler's, driver's and calibration's */
+#define CONFIG_SENSORS   (8U)
+
+/** Sensor types in the record */
+#define CONFIG_TYPE_DHT11 (0U)
+#define CONFIG_TYPE_DHT22 (1U)
+
+/**
+ * @brief Calibration of one sensor quantity (dht11_calib.h).
+ */
+typedef struct {
+	int32_t gain;            /*!< Q16.16                                */
+	int16_t offset;          /*!< Tenths                                */
+	uint16_t reserved;
+} config_calib_t;
+
+/**
+ * @brief The saved settings.
+ */
+typedef struct {
+	uint32_t baud;                         /*!< Console rate (uart_baud.h) */
+	uint32_t interval_ms;                  /*!< Async refresh, 0 = single shot */
+	uint8_t clock_profile;                 /*!< clock_profile_t            */
+	uint8_t format;                        /*!< dht11_format_t             */
+	uint8_t sensor_type[CONFIG_SENSORS];   /*!< CONFIG_TYPE_*              */
+	uint8_t reserved[2];
+	dht11_sampler_cfg_t sample[CONFIG_SENSORS];
+	config_calib_t calib[CONFIG_SENSORS][2]; /*!< Temperature, humidity    */
+} config_settings_t;
+
+/**
+ * @brief One copy in flash.
+ */
+typedef struct {
+	uint32_t magic;          /*!< CONFIG_MAGIC                          */
+	uint16_t version;        /*!< CONFIG_VERSION                        */
+	uint16_t length;         /*!< sizeof(config_record_t)               */
+	uint32_t sequence;       /*!< One more than the other copy's        */
+	config_settings_t settings;
+	uint32_t crc;            /*!< CRC-32/MPEG-2 of the words before it  */
+} config_record_t;
+
+_Static_assert((sizeof(config_record_t) % 4U) == 0U,
+		"config_record_t must be whole words");
+
+/**
+ * @brief Where the running settings came from.
+ */
+typedef struct {
+	uint8_t copy;            /*!< 0: defaults, 1: copy A, 2: copy B     */
+	uint32_t sequence;       /*!< Of that copy                          */
+	uint32_t saves;          /*!< Since boot                            */
+	uint32_t errors;         /*!< Erase, program or read-back failures  */
+	uint32_t rejected;       /*!< Copies found damaged or of another version at boot */
+} config_info_t;
+
+#if CONFIG_USE_STORE
+
+/**
+ * @brief Takes the newest valid copy into RAM. Call right after
+ *        HAL_Init() and Crc_Init(), before SystemClock_Config().
+ */
+void Config_Load(void);
+
+/**
+ * @brief Clock profile for SystemClock_Config(): the saved one, or
+ *        CLOCK_DEFAULT_PROFILE without a valid record.
+ */
+clock_profile_t Config_BootProfile(void);
+
+/**
+ * @brief Switches the console to the saved rate. Call after
+ *        UART_Baud_Init(), before anything is printed.
+ */
+void Config_ApplyBaud(void);
+
+/**
+ * @brief Applies the saved interval, format, sensor types, sampling plans
+ *        and calibration. Call after those modules are initialised.
+ */
+void Config_Apply(void);
+
+/**
+ * @brief Captures the running settings and writes them to the older copy.
+ * @retval HAL_OK once the copy has been read back,
+ *         HAL_BUSY while a baud change awaits its confirmation,
+ *         HAL_ERROR if the flash failed; the other copy is kept.
+ */
+HAL_StatusTypeDef Config_Save(void);
+
+/**
+ * @brief Erases both copies: the next boot runs with the defaults.
+ * @retval HAL_OK, or HAL_ERROR if an erase failed.
+ */
+HAL_StatusTypeDef Config_Erase(void);
+
+/**
+ * @brief Copies where the running settings came from and the counters.
+ */
+void Config_GetInfo(config_info_t *info);
+
+#else
+#define Config_BootProfile() (CLOCK_DEFAULT_PROFILE)
+#endif /* CONFIG_USE_STORE */
+
+#endif /* CONFIG_H_ */
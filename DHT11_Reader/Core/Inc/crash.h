@@ -0,0 +1,133 @@
+/**
+ ******************************************************************************
+ * @file           : crash.h
+ * @brief          : Fault capture, fast reset and crash report on next boot.
+ *
+ *                   The HardFault, MemManage, BusFault and UsageFault
+ *                   handlers are naked trampolines (CRASH_FAULT_ENTRY()):
+ *                   they pick the stack that was active from EXC_RETURN,
+ *                   switch to a small private stack, so a stack overflow
+ *                   cannot fault again, and call Crash_Fault(). That
+ *                   stores the stacked registers, CFSR/HFSR/MMFAR/BFAR and
+ *                   the first CRASH_STACK_WORDS above the exception frame
+ *                   in the .noinit RAM section, and resets at once.
+ *                   Error_Handler() records the caller's return address the
+ *                   same way.
+ *
+ *                   .noinit is not touched by the startup code, so the
+ *                   record survives the reset (not a power cycle; it is
+ *                   validated by magic and CRC). Crash_Init() prints it
+ *                   once at the next boot as "CRASH ..." lines, along with
+ *                   the reset cause; the CLI "crash" command shows it
+ *                   again.
+ *
+ *                   Crash_Init() also enables the MemManage, BusFault and
+ *                   UsageFault exceptions, which otherwise escalate to
+ *                   HardFault. With a debugger attached the handlers stop
+ *                   on a BKPT before resetting.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef CRASH_H_
+#define CRASH_H_
+
+#include "main.h"
+
+/** Stack words saved above the exception frame */
+#define CRASH_STACK_WORDS        (16U)
+
+/** Private stack of the fault path, in words */
+#define CRASH_FAULT_STACK_WORDS  (128U)
+
+/** Crash reasons; plain numbers, they are assembler immediates */
+#define CRASH_REASON_HARDFAULT   1
+#define CRASH_REASON_MEMMANAGE   2
+#define CRASH_REASON_BUSFAULT    3
+#define CRASH_REASON_USAGEFAULT  4
+#define CRASH_REASON_ERROR       5
+
+/**
+ * @brief Body of a naked fault handler: passes the exception frame,
+ *        EXC_RETURN and the reason to Crash_Fault() on the fault stack.
+ */
+#define CRASH_FAULT_ENTRY(reason)                     \
+	__asm volatile(                                   \
+			"tst lr, #4                          \n"  \
+			"ite eq                              \n"  \
+			"mrseq r0, msp                       \n"  \
+			"mrsne r0, psp                       \n"  \
+			"mov r1, lr                          \n"  \
+			"movs r2, %0                         \n"  \
+			"movw r3, #:lower16:crash_fault_stack \n" \
+			"movt r3, #:upper16:crash_fault_stack \n" \
+			"add r3, r3, %1                      \n"  \
+			"mov sp, r3                          \n"  \
+			"b Crash_Fault                       \n"  \
+			: : "i" (reason), "i" (CRASH_FAULT_STACK_WORDS * 4U))
+
+/**
+ * @brief One saved crash. Lives in .noinit.
+ */
+typedef struct {
+	uint32_t magic;
+	uint32_t count;          /*!< Crashes since the last power-on       */
+	uint32_t reason;         /*!< CRASH_REASON_*                        */
+	uint32_t tick_ms;        /*!< HAL tick at the fault                 */
+	uint32_t r[4];           /*!< Stacked r0-r3                         */
+	uint32_t r12;
+	uint32_t lr;
+	uint32_t pc;             /*!< Faulting instruction, or caller of
+	                              Error_Handler()                       */
+	uint32_t xpsr;
+	uint32_t exc_return;
+	uint32_t sp;             /*!< Stack pointer before the exception    */
+	uint32_t cfsr;
+	uint32_t hfsr;
+	uint32_t mmfar;
+	uint32_t bfar;
+	uint32_t stack[CRASH_STACK_WORDS];
+	uint32_t stack_words;    /*!< Valid entries of stack[]              */
+	uint32_t reported;       /*!< Printed at boot already               */
+	uint32_t crc;            /*!< Crc_Ccitt16() of everything above */
+} crash_record_t;
+
+/**
+ * @brief Reports a saved crash and the reset cause, once, then clears the
+ *        reset flags. Call once the UART is up.
+ */
+void Crash_Init(void);
+
+/**
+ * @brief Fault path; entered from CRASH_FAULT_ENTRY(), does not return.
+ * @param frame: Exception frame on the interrupted stack.
+ */
+void Crash_Fault(uint32_t *frame, uint32_t exc_return, uint32_t reason)
+		__attribute__((noreturn));
+
+/**
+ * @brief Records an Error_Handler() call and resets.
+ * @param caller: Return address of the Error_Handler() call.
+ */
+void Crash_Error(uint32_t caller) __attribute__((noreturn));
+
+/**
+ * @brief Prints the saved crash, if any.
+ * @retval 1 if a crash record exists.
+ */
+uint8_t Crash_Print(void);
+
+/**
+ * @brief Crashes since the last power-on.
+ */
+uint32_t Crash_GetCount(void);
+
+/**
+ * @brief Printable reset cause of this boot, from RCC->CSR.
+ */
+const char* Crash_GetResetCause(void);
+
+#endif /* CRASH_H_ */
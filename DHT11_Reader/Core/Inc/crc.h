@@ -0,0 +1,78 @@
+/**
+ ******************************************************************************
+ * @file           : crc.h
+ * @brief          : CRC service: the STM32 CRC unit for CRC-32 over words,
+ *                   table-driven software for the CRC-16 framings.
+ *
+ *                   The CRC unit computes CRC-32/MPEG-2 (poly 0x04C11DB7,
+ *                   init 0xFFFFFFFF, no reflection, no final XOR) one 32-bit
+ *                   word per AHB write, bit 31 of each word first. Over a
+ *                   little-endian word array that is the CRC-32/MPEG-2 of
+ *                   each word's bytes taken most significant first, which
+ *                   a host gets with struct.pack(">%dI", *words).
+ *
+ *                   Crc_Hw32() feeds the unit from the CPU, about 2 cycles
+ *                   a word. Crc_Hw32Start() hands a block of up to 65535
+ *                   words to DMA2 Stream0 as a memory-to-memory transfer
+ *                   into the data register, so a flash sector (32768
+ *                   words) is checked while the CPU runs; Crc_Hw32Poll()
+ *                   collects the result. A Crc_Hw32() call during a DMA
+ *                   block waits for it and keeps its result for the poll.
+ *
+ *                   The packet framings keep their CRC-16s: CRC-16/CCITT-
+ *                   FALSE (telemetry.h, crash and history records) from a
+ *                   16-entry nibble table, and the Modbus RTU CRC-16 from a
+ *                   256-entry byte table. The CRC unit has a fixed
+ *                   polynomial, so these stay in software.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef CRC_H_
+#define CRC_H_
+
+#include "main.h"
+
+/** Longest block of one DMA transfer (NDTR is 16 bits) */
+#define CRC_DMA_MAX_WORDS (65535U)
+
+/**
+ * @brief Clocks the CRC unit and DMA2.
+ */
+void Crc_Init(void);
+
+/**
+ * @brief CRC-32/MPEG-2 of a word array, fed by the CPU.
+ */
+uint32_t Crc_Hw32(const uint32_t *words, uint32_t n);
+
+/**
+ * @brief Starts a CRC-32/MPEG-2 of a word array, fed by DMA. The words
+ *        must stay unchanged until Crc_Hw32Poll() returns.
+ * @retval HAL_BUSY while another block is in progress or uncollected,
+ *         HAL_ERROR above CRC_DMA_MAX_WORDS words, HAL_OK otherwise.
+ */
+HAL_StatusTypeDef Crc_Hw32Start(const uint32_t *words, uint32_t n);
+
+/**
+ * @brief Collects the result of Crc_Hw32Start().
+ * @retval HAL_BUSY while the transfer runs, HAL_ERROR after a transfer
+ *         error or with no block started, HAL_OK with *crc set.
+ */
+HAL_StatusTypeDef Crc_Hw32Poll(uint32_t *crc);
+
+/**
+ * @brief CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF, no reflection).
+ */
+uint16_t Crc_Ccitt16(const uint8_t *data, uint32_t len);
+
+/**
+ * @brief Modbus RTU CRC-16 (poly 0xA001 reflected, init 0xFFFF); sent low
+ *        byte first.
+ */
+uint16_t Crc_Modbus16(const uint8_t *data, uint32_t len);
+
+#endif /* CRC_H_ */
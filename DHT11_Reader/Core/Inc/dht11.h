@@ -9,8 +9,8 @@
  *                   microsecond-level delays, pin direction switching, and
  *                   reading sensor data bit-by-bit.
  *
- *                   Make sure TIM6 (or any timer used for delay_us) is
- *                   initialized before calling delay_us.
+ *                   Make sure Timebase_Init() (timebase.h) has run before
+ *                   calling delay_us.
  *
  * @author         : Nitin R
  * @version        : 1.0
@@ -23,6 +23,48 @@
 
 #include "main.h"
 
+/**
+ * @brief Result of a DHT11 transaction.
+ */
+typedef enum {
+	DHT11_OK = 0,           /*!< Frame received and checksum valid        */
+	DHT11_ERR_BUSY,         /*!< A transaction is already in progress     */
+	DHT11_ERR_NO_RESPONSE,  /*!< Sensor did not answer the start signal   */
+	DHT11_ERR_TIMEOUT,      /*!< Frame started but did not complete       */
+	DHT11_ERR_FRAME,        /*!< A pulse width was outside the spec       */
+	DHT11_ERR_CHECKSUM,     /*!< All 40 bits received, checksum mismatch  */
+	DHT11_ERR_STUCK_LOW,    /*!< Response LOW phase did not end           */
+	DHT11_ERR_STUCK_HIGH,   /*!< Response HIGH phase did not end          */
+	DHT11_ERR_BIT_TIMEOUT   /*!< A data bit phase did not end in time     */
+} dht11_status_t;
+
+/**
+ * @brief One acquisition, independent of how it is presented.
+ */
+typedef struct {
+	uint8_t raw[5];          /*!< Hum int, hum dec, temp int, temp dec, checksum */
+	dht11_status_t status;   /*!< Outcome of the last attempt                   */
+	uint32_t timestamp_ms;   /*!< HAL tick at the start of the last attempt     */
+	uint8_t retries;         /*!< Attempts beyond the first                      */
+	uint8_t sensor_id;       /*!< Channel number, 0 for the single PA1 sensor    */
+	uint8_t confidence;      /*!< Bit decision margin 0-100 (dht11_classify.h)   */
+} dht11_reading_t;
+
+/** Default extra attempts after a transient failure; spacing and backoff
+ * of the retries come from the sensor's policy (dht11_health.h) */
+#define DHT11_READ_RETRIES       (2U)
+
+/** Bounded waits of the bit-banged path, in microseconds. Worst case per
+ * frame after the start pulse: 3 * 100 + 40 * (80 + 40 + 60) = 7.5 ms */
+#define DHT11_RESPONSE_WAIT_US   (100U) /*!< release -> LOW, and each 80 us phase */
+#define DHT11_BIT_LOW_WAIT_US    (80U)  /*!< 50 us bit preamble                   */
+#define DHT11_BIT_SAMPLE_US      (40U)  /*!< '0' ends before, '1' after this      */
+#define DHT11_BIT_HIGH_WAIT_US   (60U)  /*!< rest of a 70 us '1' after sampling   */
+
+/** Settling time after power-up before the first start pulse, counted
+ * from reset (HAL tick 0) */
+#define DHT11_POWERUP_MS         (1000U)
+
 /**
  * @brief Initializes the DWT cycle counter for microsecond delays.
  *        (Used only if using DWT for delay_us instead of TIM6).
@@ -32,7 +74,9 @@ void DWT_Init(void);
 /**
  * @brief Generates a delay in microseconds.
  * @param us: Duration of delay in microseconds.
- * @note Requires a properly initialized TIM6 or DWT.
+ * @note Requires Timebase_Init(); forwards to Timebase_DelayUs(), which
+ *       takes its measured call cost off the wait. Constant protocol
+ *       windows use the inline Timebase_DelayUsShort() instead.
  */
 void delay_us(uint32_t us);
 
@@ -56,16 +100,48 @@ void DHT11_Start(void);
 
 /**
  * @brief Checks the sensor's response after start signal.
- * @retval 1 if response is valid (LOW then HIGH), 0 otherwise.
+ * @retval DHT11_OK, DHT11_ERR_NO_RESPONSE, DHT11_ERR_STUCK_LOW or
+ *         DHT11_ERR_STUCK_HIGH.
  */
-uint8_t DHT11_CheckResponse(void);
+dht11_status_t DHT11_CheckResponse(void);
 
 /**
  * @brief Reads 1 byte of data from the sensor.
  *        Each bit is determined based on pulse width timing.
- * @retval 8-bit data (humidity/temperature or checksum)
+ * @param byte: Receives the 8-bit data (humidity/temperature or checksum).
+ * @retval DHT11_OK or DHT11_ERR_BIT_TIMEOUT.
  */
-uint8_t DHT11_ReadByte(void);
+dht11_status_t DHT11_ReadByte(uint8_t *byte);
+
+/**
+ * @brief Measures the HIGH time of all 40 data bits, right after
+ *        DHT11_CheckResponse(). Classification is left to the caller.
+ * @param widths: Receives the HIGH times in microseconds.
+ * @retval DHT11_OK or DHT11_ERR_BIT_TIMEOUT.
+ */
+dht11_status_t DHT11_ReadPulseWidths(uint16_t widths[40]);
+
+/**
+ * @brief Short printable name of a status code.
+ */
+const char* DHT11_StatusName(dht11_status_t status);
+
+/**
+ * @brief Acquires one reading through the configured path (capture or
+ *        bit-bang), validates the checksum and retries transient errors.
+ *        Does no formatting or output.
+ * @param reading: Filled with raw bytes, status, timestamp and retry count.
+ * @retval Final status, also stored in reading->status.
+ */
+dht11_status_t DHT11_Read(dht11_reading_t *reading);
+
+/**
+ * @brief One attempt through the configured path: no retry, and the
+ *        sensor's health is left alone. For benchmarks (dht11_emu.h).
+ * @param data: Receives the 5 frame bytes.
+ * @retval Attempt status, range-checked for the sensor type.
+ */
+dht11_status_t DHT11_ReadOnce(uint8_t data[5]);
 
 /**
  * @brief Reads temperature and humidity data from the DHT11 sensor and prints the values.
@@ -78,4 +154,17 @@ uint8_t DHT11_ReadByte(void);
  */
 void ReadAndDisplayDHT11(void);
 
+/**
+ * @brief Reads the sensor and hands the result to the active sink, without
+ *        waiting. Retries of a failed read still block for a few ms.
+ * @retval Milliseconds until the next reading is due.
+ */
+uint32_t DHT11_ReadAndEmit(void);
+
+/**
+ * @brief Time left until the sensor may be read after power-up.
+ * @retval Milliseconds until HAL tick DHT11_POWERUP_MS, 0 once past it.
+ */
+uint32_t DHT11_PowerUpRemainingMs(void);
+
 #endif /* DHT11_H_ */
@@ -0,0 +1,129 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_agg.h
+ * @brief          : Windowed min/max/mean aggregation per sensor.
+ *
+ *                   Up to DHT11_AGG_WINDOWS tumbling windows per sensor,
+ *                   each with its own length in seconds (say 60 and 900).
+ *                   DHT11_Sink_Emit() adds every filtered reading to the
+ *                   open window of its sensor: count, failures and the
+ *                   running min, max and sum of the calibrated temperature
+ *                   and humidity (dht11_calib.h), a few words of state and
+ *                   no sample buffer. When a window ends, one summary goes
+ *                   to the active sink's format (DHT11_Sink_Summary()): a
+ *                   text line, or a 0x09 telemetry packet for the binary
+ *                   formats.
+ *
+ *                   Windows are aligned to multiples of their length: of
+ *                   UTC once the wall clock is synced (wallclock.h), so a
+ *                   60 s window is a calendar minute, of the HAL tick
+ *                   before. A window closes on the first reading past its
+ *                   end, or DHT11_AGG_GRACE_MS after its end from
+ *                   DHT11_Agg_Poll(), so a sensor that went silent still
+ *                   reports it. Readings that all failed still produce a
+ *                   summary, with a count of 0.
+ *
+ *                   With raw readings off, only the summaries reach the
+ *                   sink and the CAN bus: at one reading per 2 s a 60 s
+ *                   window sends 30 times less, a 900 s window 450 times
+ *                   less. History, flash log, latest values and the
+ *                   register maps still see every reading.
+ *
+ *                   Default: no window, raw readings on, as before.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef DHT11_AGG_H_
+#define DHT11_AGG_H_
+
+#include "main.h"
+#include "dht11.h"
+
+/** Sensors tracked; matches the 8-channel reader */
+#define DHT11_AGG_SENSORS    (8U)
+
+/** Windows per sensor */
+#define DHT11_AGG_WINDOWS    (2U)
+
+/** Longest window: 12 h, so a count at one reading per second fits 16 bits */
+#define DHT11_AGG_WINDOW_MAX (43200U)
+
+/** Wait past a window's end for readings still on their way */
+#define DHT11_AGG_GRACE_MS   (500U)
+
+/**
+ * @brief Windows shared by all sensors.
+ */
+typedef struct {
+	uint32_t window_s[DHT11_AGG_WINDOWS];  /*!< Length, 0 = off       */
+	uint8_t raw;                           /*!< Also send raw readings */
+} dht11_agg_cfg_t;
+
+/**
+ * @brief One closed window. Values calibrated, in tenths; 0 when count
+ *        is 0.
+ */
+typedef struct {
+	uint8_t sensor_id;
+	uint8_t window;       /*!< Index into window_s              */
+	uint8_t utc;          /*!< Aligned to UTC, not the tick     */
+	uint32_t window_s;
+	uint32_t start_ms;    /*!< HAL tick at the window's start   */
+	uint16_t count;       /*!< Good readings                    */
+	uint16_t failures;    /*!< Failed readings                  */
+	int16_t temp_min;
+	int16_t temp_mean;
+	int16_t temp_max;
+	int16_t hum_min;
+	int16_t hum_mean;
+	int16_t hum_max;
+} dht11_agg_summary_t;
+
+/**
+ * @brief Turns all windows off and raw readings on.
+ */
+void DHT11_Agg_Init(void);
+
+/**
+ * @brief Replaces the windows; open windows are dropped, the next
+ *        reading of each sensor opens new ones.
+ */
+void DHT11_Agg_SetConfig(const dht11_agg_cfg_t *cfg);
+
+/**
+ * @brief Current windows.
+ */
+dht11_agg_cfg_t DHT11_Agg_GetConfig(void);
+
+/**
+ * @brief Adds a reading, closing the windows it is past first.
+ */
+void DHT11_Agg_Add(const dht11_reading_t *reading);
+
+/**
+ * @brief Closes windows whose end passed DHT11_AGG_GRACE_MS ago. Same
+ *        context as DHT11_Sink_Emit(); call from the CLI poll loop.
+ */
+void DHT11_Agg_Poll(void);
+
+/**
+ * @brief Reports whether raw readings go on to the sink.
+ * @retval 0 only when raw readings are off and a window is on.
+ */
+uint8_t DHT11_Agg_PassRaw(void);
+
+/**
+ * @brief Reports whether any window is on.
+ */
+uint8_t DHT11_Agg_IsOn(void);
+
+/**
+ * @brief Summaries sent since DHT11_Agg_Init().
+ */
+uint32_t DHT11_Agg_GetSummaries(void);
+
+#endif /* DHT11_AGG_H_ */
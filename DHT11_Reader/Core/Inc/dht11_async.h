@@ -0,0 +1,166 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_async.h
+ * @brief          : Non-blocking DHT11 driver built on the capture engine.
+ *
+ *                   A transaction is a small state machine driven by TIM5
+ *                   channel 1 output-compare interrupts (timing mode, no
+ *                   pin): the start pulse (dht11_driver.h), the frame
+ *                   timeout and the refresh interval are all compare
+ *                   deadlines on the 1 MHz TIM5 counter. The frame itself
+ *                   is captured by DMA, so the main loop only has to call
+ *                   DHT11_Poll().
+ *
+ *                   The refresh compare is the sample clock: readings
+ *                   start at whole multiples of the interval from the
+ *                   first one, to the microsecond and whatever the
+ *                   transaction, retry or main-loop latency. A slot that
+ *                   passes before the previous reading is done is skipped
+ *                   rather than caught up, and counted
+ *                   (DHT11_Async_GetClock()). A sync pulse (dht11_sync.h)
+ *                   or an on-demand reading (dht11_trigger.h) starts a new
+ *                   grid.
+ *
+ *                   Typical use:
+ *                     DHT11_Async_SetCallback(on_reading);
+ *                     DHT11_Async_SetInterval(2000U);
+ *                     DHT11_StartAsync();
+ *                     while (1) { DHT11_Poll(); ...other work... }
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef DHT11_ASYNC_H_
+#define DHT11_ASYNC_H_
+
+#include "main.h"
+#include "dht11.h"
+#include "dht11_capture.h"
+#include "dht11_exti.h"
+#include "dht11_oversample.h"
+
+/* Set to 1 to run the main loop on the asynchronous API, 0 for ReadAndDisplayDHT11() */
+#define DHT11_USE_ASYNC (1)
+
+#if DHT11_USE_ASYNC && !DHT11_USE_CAPTURE
+#error "DHT11_USE_ASYNC requires DHT11_USE_CAPTURE"
+#endif
+
+#if DHT11_USE_ASYNC && DHT11_USE_EXTI
+#error "DHT11_USE_ASYNC runs on TIM5 capture: set DHT11_USE_EXTI to 0"
+#endif
+
+#if DHT11_USE_ASYNC && DHT11_USE_OVERSAMPLE
+#error "DHT11_USE_ASYNC runs on TIM5 capture: set DHT11_USE_OVERSAMPLE to 0"
+#endif
+
+
+/** Default refresh interval; the DHT11 needs ≥1 s between reads */
+#define DHT11_ASYNC_INTERVAL_MS (2000U)
+
+/**
+ * @brief Sample clock counters.
+ */
+typedef struct {
+	uint32_t slots;        /*!< Readings started on a grid slot        */
+	uint32_t missed;       /*!< Slots skipped: passed before re-arming */
+	uint32_t max_late_us;  /*!< Worst slot to start pulse latency      */
+} dht11_async_clock_t;
+
+/**
+ * @brief Completion callback, invoked from DHT11_Poll() (thread context).
+ * @param reading: Completed reading; raw bytes only meaningful when
+ *                 reading->status is DHT11_OK.
+ */
+typedef void (*dht11_async_cb_t)(const dht11_reading_t *reading);
+
+/**
+ * @brief Resets the state machine. Call after DHT11_Capture_Init().
+ */
+void DHT11_Async_Init(void);
+
+/**
+ * @brief Registers the completion callback (NULL to disable).
+ */
+void DHT11_Async_SetCallback(dht11_async_cb_t cb);
+
+/**
+ * @brief Sets the automatic refresh interval.
+ * @param interval_ms: Start-to-start period, or 0 for single-shot reads.
+ */
+void DHT11_Async_SetInterval(uint32_t interval_ms);
+
+/**
+ * @brief Returns the refresh interval in milliseconds (0 = single shot).
+ */
+uint32_t DHT11_Async_GetInterval(void);
+
+/**
+ * @brief Fills the sample clock counters.
+ */
+void DHT11_Async_GetClock(dht11_async_clock_t *clock);
+
+/**
+ * @brief Reports whether a transaction is using the line or TIM5 right now
+ *        (start pulse, capture or an undecoded frame).
+ * @retval 1 while busy; 0 when idle or waiting for the next refresh.
+ */
+uint8_t DHT11_Async_IsBusy(void);
+
+/**
+ * @brief Time until the state machine next needs the CPU or TIM5.
+ * @retval Microseconds until the next refresh while waiting, 0 while busy
+ *         or with a result pending, 0xFFFFFFFF when idle (single shot).
+ */
+uint32_t DHT11_Async_GetIdleUs(void);
+
+/**
+ * @brief Re-arms the refresh deadline after a stop. Power_Stop() steps
+ *        TIM5 over the time it spent frozen (SysTime_Advance()), so the
+ *        next refresh keeps its wall-clock schedule; a deadline stepped
+ *        over fires at once. Only acts while idle or waiting.
+ * @param us: Time TIM5 was stopped, from Power_Sleep().
+ */
+void DHT11_Async_AdvanceTime(uint32_t us);
+
+/**
+ * @brief Begins a transaction and returns immediately.
+ * @retval DHT11_OK, or DHT11_ERR_BUSY if a transaction is in progress.
+ */
+dht11_status_t DHT11_StartAsync(void);
+
+/**
+ * @brief Brings the next refresh forward for an on-demand reading
+ *        (dht11_trigger.h): at once, or as soon as the minimum spacing
+ *        after the last start pulse allows. The cadence restarts from it.
+ *        Thread context.
+ * @retval DHT11_OK, or DHT11_ERR_BUSY while a transaction or its retries
+ *         are under way (their result serves the request) or before the
+ *         first one.
+ */
+dht11_status_t DHT11_Async_Trigger(void);
+
+/**
+ * @brief Completes a finished transaction: decodes the frame and fires
+ *        the callback. Cheap to call from the main loop.
+ * @retval 1 if a new result became available during this call, 0 otherwise.
+ */
+uint8_t DHT11_Poll(void);
+
+/**
+ * @brief Returns the most recent result.
+ * @param reading: Receives a copy of the most recent reading.
+ * @retval Status of the most recent transaction, DHT11_ERR_BUSY if none yet.
+ */
+dht11_status_t DHT11_GetResult(dht11_reading_t *reading);
+
+/**
+ * @brief TIM5 channel 1 compare handler; called from
+ *        HAL_TIM_OC_DelayElapsedCallback().
+ */
+void DHT11_Async_TimerCallback(void);
+
+#endif /* DHT11_ASYNC_H_ */
@@ -0,0 +1,180 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_calib.h
+ * @brief          : Per-sensor calibration and derived metrics in fixed
+ *                   point.
+ *
+ *                   DHT11_Calib_Process() turns a reading into calibrated
+ *                   temperature and humidity, then derives the dew point,
+ *                   the heat index and the absolute humidity:
+ *                     - calibration: value = value * gain + offset per
+ *                       sensor and quantity, gain in Q16.16 (65536 = 1.0),
+ *                       offset in tenths; identity by default;
+ *                     - saturation vapour pressure from a Magnus-formula
+ *                       table every 2 degrees from -40 to +80 C, linearly
+ *                       interpolated (within 0.3 %);
+ *                     - dew point: the same table inverted at the actual
+ *                       vapour pressure, so no log();
+ *                     - absolute humidity: e * Mw / (R * T);
+ *                     - heat index: the NWS algorithm (Steadman's simple
+ *                       formula, the Rothfusz regression above 80 F and its
+ *                       two adjustments), a polynomial in 64-bit integers.
+ *                   Readings are stored raw (history, flash log);
+ *                   calibration only applies to what is presented.
+ *
+ *                   With DHT11_CALIB_USE_FPU the same derivation is also
+ *                   built in single precision for the M4F's FPU: Magnus
+ *                   directly, dew point by its closed-form inverse, heat
+ *                   index as written. exp and log are local float
+ *                   polynomials, square root and absolute value the
+ *                   VSQRT/VABS built-ins, so nothing is promoted to double
+ *                   and libm is not linked. Calibration stays in integers
+ *                   on both paths.
+ *
+ *                   Which path runs is chosen per clock profile: flash wait
+ *                   states cost the table and 64-bit integer code more at
+ *                   180 MHz than at 16 MHz, while FPU instructions take the
+ *                   same cycles everywhere. DHT11_Calib_Bench() times both
+ *                   over a sweep of the whole range at the current profile
+ *                   (cycles per sample, with interrupts from
+ *                   IRQ_PRIO_TIMEBASE down held off for each sample) and
+ *                   the largest difference between their results; the CLI
+ *                   "calib bench apply" keeps the faster one for that
+ *                   profile.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef DHT11_CALIB_H_
+#define DHT11_CALIB_H_
+
+#include "main.h"
+#include "dht11.h"
+#include "clock_config.h"
+
+/* Set to 1 to build the single-precision derived-metrics path */
+#define DHT11_CALIB_USE_FPU (1)
+
+/** Sensors with their own calibration; matches the 8-channel reader */
+#define DHT11_CALIB_SENSORS (8U)
+
+/** Q16.16 gain of 1.0 */
+#define DHT11_CALIB_ONE     (65536)
+
+/** Largest gain accepted, 4.0 */
+#define DHT11_CALIB_GAIN_MAX (4 * DHT11_CALIB_ONE)
+
+/** Benchmark sweep: every 10.0 C from -40 to 80 by every 10 %RH */
+#define DHT11_CALIB_BENCH_SAMPLES (13U * 11U)
+
+/**
+ * @brief Calibrated quantity.
+ */
+typedef enum {
+	DHT11_CALIB_TEMP = 0,
+	DHT11_CALIB_HUM
+} dht11_calib_qty_t;
+
+/**
+ * @brief Implementation of the derived metrics.
+ */
+typedef enum {
+	DHT11_CALIB_PATH_FIXED = 0, /*!< Integer, vapour pressure table */
+	DHT11_CALIB_PATH_FPU,       /*!< Single precision               */
+	DHT11_CALIB_PATHS
+} dht11_calib_path_t;
+
+/** Path of every profile after DHT11_Calib_Init() */
+#define DHT11_CALIB_DEFAULT_PATH (DHT11_CALIB_PATH_FIXED)
+
+/**
+ * @brief Gain and offset of one quantity.
+ */
+typedef struct {
+	int32_t gain;        /*!< Q16.16                  */
+	int16_t offset;      /*!< Tenths, added after gain */
+} dht11_calib_t;
+
+/**
+ * @brief Calibrated and derived values of one reading.
+ */
+typedef struct {
+	int16_t temp;        /*!< Tenths of a degree C, -40.0 to 80.0 */
+	int16_t hum;         /*!< Tenths of %RH, 0 to 100.0           */
+	int16_t dew_point;   /*!< Tenths of a degree C                */
+	int16_t heat_index;  /*!< Tenths of a degree C                */
+	uint16_t abs_hum;    /*!< Hundredths of g/m3                  */
+} dht11_values_t;
+
+/**
+ * @brief Benchmark of both paths at one clock profile.
+ */
+typedef struct {
+	uint32_t samples;                      /*!< 0: not measured          */
+	uint32_t cycles[DHT11_CALIB_PATHS];    /*!< Mean per sample          */
+	uint32_t worst[DHT11_CALIB_PATHS];     /*!< Slowest sample           */
+	uint16_t diff_dew;                     /*!< Largest |fixed - fpu|,   */
+	uint16_t diff_heat;                    /*!< tenths of a degree C ... */
+	uint16_t diff_abs;                     /*!< ... and 0.01 g/m3        */
+} dht11_calib_bench_t;
+
+/**
+ * @brief Resets every sensor to the identity calibration and every
+ *        profile to DHT11_CALIB_DEFAULT_PATH.
+ */
+void DHT11_Calib_Init(void);
+
+/**
+ * @brief Sets the calibration of one sensor quantity.
+ * @param gain: Q16.16, 1 to DHT11_CALIB_GAIN_MAX.
+ * @retval 1 if applied, 0 for an invalid sensor or gain.
+ */
+uint8_t DHT11_Calib_Set(uint8_t sensor_id, dht11_calib_qty_t qty, int32_t gain,
+		int16_t offset);
+
+/**
+ * @brief Calibration of one sensor quantity, identity for unknown sensors.
+ */
+dht11_calib_t DHT11_Calib_Get(uint8_t sensor_id, dht11_calib_qty_t qty);
+
+/**
+ * @brief Calibrates a reading and derives the other values.
+ * @retval 1 on success, 0 (values untouched) if the reading failed.
+ */
+uint8_t DHT11_Calib_Process(const dht11_reading_t *reading,
+		dht11_values_t *values);
+
+/**
+ * @brief Selects the derived-metrics path of a clock profile.
+ * @retval 1 if applied, 0 for an unknown profile or a path not built.
+ */
+uint8_t DHT11_Calib_SetPath(clock_profile_t profile, dht11_calib_path_t path);
+
+/**
+ * @brief Derived-metrics path of a clock profile.
+ */
+dht11_calib_path_t DHT11_Calib_GetPath(clock_profile_t profile);
+
+/**
+ * @brief Times both paths over DHT11_CALIB_BENCH_SAMPLES readings at the
+ *        current clock profile and keeps the result for it. Takes a few
+ *        milliseconds at 16 MHz; thread context.
+ * @param result: Filled with the measurement.
+ * @retval The faster path.
+ */
+dht11_calib_path_t DHT11_Calib_Bench(dht11_calib_bench_t *result);
+
+/**
+ * @brief Last benchmark of a clock profile; samples is 0 if none ran.
+ */
+const dht11_calib_bench_t* DHT11_Calib_GetBench(clock_profile_t profile);
+
+/**
+ * @brief Short printable name of a path.
+ */
+const char* DHT11_Calib_PathName(dht11_calib_path_t path);
+
+#endif /* DHT11_CALIB_H_ */
@@ -0,0 +1,248 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_capture.h
+ * @brief          : Timer input-capture + DMA engine for the DHT11 bit stream.
+ *
+ *                   The DHT11 data line (PA1) is routed to TIM5_CH2 (AF2).
+ *                   TIM5 free-runs at 1 MHz and latches its counter on every
+ *                   falling edge of the line. DMA1 Stream4 (channel 6) moves
+ *                   each captured value into a RAM buffer, so the CPU is free
+ *                   for the whole frame and other interrupts cannot corrupt
+ *                   the bit timing. The pulse widths are classified after the
+ *                   frame is complete.
+ *
+ *                   TIM5 is used rather than TIM2 because TIM2_CH2 shares
+ *                   DMA1 Stream6 with USART2_TX.
+ *
+ *                   Glitch rejection, per sensor (DHT11_Capture_SetFilter()):
+ *                   - ic_filter is the IC2F digital filter of TIM5_CH2: an
+ *                     edge counts only after N equal samples at fDTS/div,
+ *                     so spikes shorter than N * div timer clocks (22 ns to
+ *                     2.8 us at 90 MHz, DHT11_Capture_FilterNs()) never
+ *                     reach the capture, at no CPU cost. Every edge is
+ *                     delayed by the same amount, so periods are unchanged.
+ *                     Only the capture pin (sensor 0) has one.
+ *                   - min_pulse_us is a software guard for what gets past
+ *                     it. With a guard, both edges are captured (up to
+ *                     DHT11_CAPTURE_SPARE_EDGES beyond the frame's) and any
+ *                     pulse shorter than the guard is removed with the
+ *                     edge that ends it before decoding
+ *                     (DHT11_Capture_Deglitch()); the frame ends once the
+ *                     line has been quiet for DHT11_CAPTURE_QUIET_US. The
+ *                     multi-sensor reader applies it to its samples too.
+ *                   A glitch then costs nothing instead of a re-read and the
+ *                   retry spacing. Both default to off. Both edges are
+ *                   also captured while the raw frame recorder is on
+ *                   (dht11_trace.h); the guard of 0 then drops nothing.
+ *
+ *                   With DHT11_CAPTURE_USE_HW_START the start pulse is timed
+ *                   in hardware too (DHT11_Capture_StartPulse()): TIM8 runs
+ *                   one pulse of the sensor type's start_us at 1 MHz and its
+ *                   channel 4 compare makes DMA2 Stream7 (channel 7) write
+ *                   GPIOA->MODER, switching PA1 from the output driving it
+ *                   LOW to TIM5_CH2, which releases the line with the
+ *                   capture already armed. From the first LOW to the DMA
+ *                   completion of the last edge no code runs, and the pulse
+ *                   is exact to the microsecond instead of HAL_Delay()'s
+ *                   1 ms tick. PA1 is not a TIM8 pin, so the timer hands
+ *                   over through the pin mode rather than an output; the
+ *                   MODER value is taken at the start, so nothing else may
+ *                   reconfigure a GPIOA pin during the pulse.
+ *
+ *                   Make sure MX_DMA_Init() and MX_TIM5_Init() have been
+ *                   called before DHT11_Capture_Init().
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef DHT11_CAPTURE_H_
+#define DHT11_CAPTURE_H_
+
+#include "main.h"
+#include "dht11.h"
+#include "dht11_classify.h"
+
+/* Set to 1 to read the sensor through the capture engine, 0 to bit-bang.
+ * The host simulator (Tools/host_sim) overrides it on the command line. */
+#ifndef DHT11_USE_CAPTURE
+#define DHT11_USE_CAPTURE (1)
+#endif /* DHT11_USE_CAPTURE */
+
+/* Set to 1 to time the start pulse with TIM8 one-pulse mode and DMA2 */
+#define DHT11_CAPTURE_USE_HW_START (0)
+
+/** Capture timer tick rate: one count per microsecond */
+#define DHT11_CAPTURE_TICK_HZ          (1000000U)
+
+/**
+ * Falling edges per frame: the sensor's response edge followed by the
+ * 41 edges that bound the 40 data bits.
+ */
+#define DHT11_CAPTURE_EDGES            (42U)
+
+/** Shortest and longest acceptable bit period */
+#define DHT11_CAPTURE_BIT_MIN_US       (60U)
+#define DHT11_CAPTURE_BIT_MAX_US       (160U)
+
+/** Acceptable response period (80 us LOW + 80 us HIGH) */
+#define DHT11_CAPTURE_RESP_MIN_US      (120U)
+#define DHT11_CAPTURE_RESP_MAX_US      (220U)
+
+/** Upper bound for a complete frame, start release to last edge */
+#define DHT11_CAPTURE_TIMEOUT_MS       (10U)
+
+/** Sensors with a glitch filter; matches the 8-channel reader */
+#define DHT11_CAPTURE_SENSORS          (8U)
+
+/** Edges beyond the frame's 84 kept with a guard: 8 glitch pulses */
+#define DHT11_CAPTURE_SPARE_EDGES      (16U)
+#define DHT11_CAPTURE_BOTH_EDGES       ((2U * DHT11_CAPTURE_EDGES) + DHT11_CAPTURE_SPARE_EDGES)
+
+/** An edge this soon after the release is the release itself */
+#define DHT11_CAPTURE_RELEASE_US       (10U)
+
+/** Line quiet for this long after the frame's edges ends a guarded frame */
+#define DHT11_CAPTURE_QUIET_US         (200U)
+
+/** Largest IC2F setting and guard; the guard stays under the 26 us '0' */
+#define DHT11_CAPTURE_IC_FILTER_MAX    (15U)
+#define DHT11_CAPTURE_GUARD_MAX_US     (20U)
+
+/**
+ * @brief Glitch rejection of one sensor.
+ */
+typedef struct {
+	uint8_t ic_filter;     /*!< TIM5 IC2F, 0 = off, sensor 0 only  */
+	uint8_t min_pulse_us;  /*!< Shorter pulses are dropped, 0 = off */
+} dht11_capture_filter_t;
+
+/**
+ * @brief Starts the capture timer and leaves the data pin released.
+ */
+void DHT11_Capture_Init(void);
+
+/**
+ * @brief Returns the TIM5 prescaler that gives DHT11_CAPTURE_TICK_HZ
+ *        from the current APB1 timer clock.
+ */
+uint32_t DHT11_Capture_TimerPrescaler(void);
+
+/**
+ * @brief Drives the data line LOW to begin the start pulse.
+ */
+void DHT11_Capture_DriveLow(void);
+
+/**
+ * @brief Arms DMA capture and releases the data line to the sensor.
+ *        Call this at the end of the ≥18 ms LOW start pulse.
+ * @retval DHT11_OK, or DHT11_ERR_BUSY if a capture is still running.
+ */
+dht11_status_t DHT11_Capture_Arm(void);
+
+#if DHT11_CAPTURE_USE_HW_START
+/**
+ * @brief Drives the line LOW now and releases it to the armed capture
+ *        low_us later, both in hardware.
+ * @param low_us: Start pulse, 1 to 65535 us.
+ * @retval DHT11_OK, or DHT11_ERR_BUSY if a capture is still running.
+ */
+dht11_status_t DHT11_Capture_StartPulse(uint32_t low_us);
+#endif /* DHT11_CAPTURE_USE_HW_START */
+
+/**
+ * @brief Stops a running capture and disables the DMA request.
+ */
+void DHT11_Capture_Abort(void);
+
+#if APP_USE_FASTPATH
+/**
+ * @brief Edge stream interrupt: transfer complete ends the frame, an error
+ *        drops it. Called from DMA1_Stream4_IRQHandler().
+ */
+void DHT11_Capture_DmaIRQHandler(void);
+#endif /* APP_USE_FASTPATH */
+
+/**
+ * @brief Reports whether all DHT11_CAPTURE_EDGES edges have been stored,
+ *        or with a guard, whether the line went quiet after the frame's
+ *        edges (the capture is stopped then).
+ * @retval 1 if the frame is complete, 0 otherwise.
+ */
+uint8_t DHT11_Capture_IsComplete(void);
+
+/**
+ * @brief Number of edges captured so far in the current frame.
+ */
+uint32_t DHT11_Capture_EdgeCount(void);
+
+/**
+ * @brief Classifies the captured pulse widths into 5 data bytes.
+ * @param data: Output buffer for humidity int/dec, temperature int/dec, checksum.
+ * @retval DHT11_OK, DHT11_ERR_FRAME or DHT11_ERR_CHECKSUM.
+ */
+dht11_status_t DHT11_Capture_Decode(uint8_t data[5]);
+
+/**
+ * @brief Hands the edges of the last frame, complete or cut short, to the
+ *        raw frame recorder (dht11_trace.h). DHT11_Capture_Decode() does
+ *        it for complete frames; call it after a timeout.
+ * @param status: Outcome of the frame.
+ */
+void DHT11_Capture_Trace(dht11_status_t status);
+
+/**
+ * @brief Classifies any DHT11_CAPTURE_EDGES falling-edge timestamps (in
+ *        microseconds) into 5 data bytes. Shared with the multi-sensor path.
+ * @param edges: DHT11_CAPTURE_EDGES timestamps, oldest first.
+ * @param sensor: Sensor index; its classifier learns from frames that
+ *                pass, its drift statistics (dht11_drift.h) take both.
+ * @param data: Output buffer for the 5 frame bytes.
+ * @retval DHT11_OK, DHT11_ERR_FRAME or DHT11_ERR_CHECKSUM.
+ */
+dht11_status_t DHT11_Capture_DecodeEdges(const uint32_t *edges,
+		uint8_t sensor, uint8_t data[5]);
+
+/**
+ * @brief Removes every pulse shorter than the sensor's guard from a list
+ *        of both-edge timestamps, then keeps the falling edges.
+ * @param edges: count timestamps in microseconds, alternating from a
+ *               falling edge; overwritten with the falling edges left.
+ * @retval Number of falling edges left.
+ */
+uint32_t DHT11_Capture_Deglitch(uint8_t sensor, uint32_t *edges,
+		uint32_t count);
+
+/**
+ * @brief Sets a sensor's glitch filter; the next frame uses it.
+ * @retval 0 if out of range (ic_filter is for sensor 0 only).
+ */
+uint8_t DHT11_Capture_SetFilter(uint8_t sensor,
+		const dht11_capture_filter_t *filter);
+
+/**
+ * @brief A sensor's glitch filter, all zero past the last sensor.
+ */
+dht11_capture_filter_t DHT11_Capture_GetFilter(uint8_t sensor);
+
+/**
+ * @brief Shortest spike an IC2F setting passes at the current TIM5 clock.
+ */
+uint32_t DHT11_Capture_FilterNs(uint8_t ic_filter);
+
+/**
+ * @brief Pulses a sensor's guard has removed since boot.
+ */
+uint32_t DHT11_Capture_GetGlitches(uint8_t sensor);
+
+/**
+ * @brief Performs a full transaction through the capture engine.
+ *        Sends the start pulse, waits for DMA completion and decodes.
+ * @param data: Output buffer for the 5 frame bytes.
+ * @retval Transaction status.
+ */
+dht11_status_t DHT11_Capture_Read(uint8_t data[5]);
+
+#endif /* DHT11_CAPTURE_H_ */
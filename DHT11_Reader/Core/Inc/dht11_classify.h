@@ -0,0 +1,105 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_classify.h
+ * @brief          : Adaptive '0'/'1' classification of the 40 DHT11 bit
+ *                   widths.
+ *
+ *                   Each sensor keeps running means of its '0' and '1'
+ *                   widths, updated only from frames that pass the
+ *                   checksum. A frame is decoded in two steps:
+ *                     1. Split at the running midpoint and take the mean
+ *                        of each half.
+ *                     2. If the halves separate cleanly (a gap of at least
+ *                        DHT11_CLASSIFY_MIN_GAP_US), re-split at the
+ *                        frame's own midpoint. Otherwise keep the running
+ *                        threshold.
+ *
+ *                   Confidence (0-100) is the distance of the closest bit
+ *                   to the threshold, relative to half the distance
+ *                   between the means: 100 is a textbook frame, and values
+ *                   near 0 mean one bit was a coin toss.
+ *
+ *                   Widths are whatever the acquisition path measures:
+ *                   HIGH time when bit-banged, falling-to-falling period
+ *                   on the capture and multi paths.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef DHT11_CLASSIFY_H_
+#define DHT11_CLASSIFY_H_
+
+#include "main.h"
+
+/* Set to 1 to learn the threshold per sensor, 0 for the fixed nominal one */
+#define DHT11_USE_ADAPTIVE (1)
+
+/** Independent classifiers: PA1 sensor is 0, multi channels 0..7 */
+#define DHT11_CLASSIFY_SENSORS     (8U)
+
+/** Nominal widths on the bit-banged path (HIGH time) */
+#define DHT11_CLASSIFY_HIGH_ZERO_US   (27U)
+#define DHT11_CLASSIFY_HIGH_ONE_US    (70U)
+
+/** Nominal widths on the capture paths (50 us LOW + HIGH) */
+#define DHT11_CLASSIFY_PERIOD_ZERO_US (78U)
+#define DHT11_CLASSIFY_PERIOD_ONE_US  (120U)
+
+/** Clean separation: no width within this gap between the two clusters */
+#define DHT11_CLASSIFY_MIN_GAP_US  (10U)
+
+/** Means closer than this are not learnt (degenerate frame) */
+#define DHT11_CLASSIFY_MIN_SEP_US  (20U)
+
+/** Running mean weight: new = old + (frame - old) / 2^shift */
+#define DHT11_CLASSIFY_EMA_SHIFT   (3U)
+
+/**
+ * @brief Per-sensor classifier state. Means are in 1/16 us.
+ */
+typedef struct {
+	uint32_t zero_q4;       /*!< Running '0' mean                     */
+	uint32_t one_q4;        /*!< Running '1' mean                     */
+	uint32_t frame_zero_q4; /*!< '0' mean of the last frame           */
+	uint32_t frame_one_q4;  /*!< '1' mean of the last frame           */
+	uint32_t learnt;        /*!< Frames folded into the running means */
+	uint8_t confidence;     /*!< Confidence of the last frame, 0-100  */
+	uint8_t clean;          /*!< Last frame separated cleanly         */
+} dht11_classifier_t;
+
+/**
+ * @brief Seeds every classifier with the nominal widths of its path.
+ *        PA1 (sensor 0) follows DHT11_USE_CAPTURE; the multi channels
+ *        always measure periods.
+ */
+void DHT11_Classify_Init(void);
+
+/**
+ * @brief Returns the classifier of a sensor.
+ */
+dht11_classifier_t* DHT11_Classify_Get(uint32_t sensor);
+
+/**
+ * @brief Decodes 40 widths into 5 bytes (checksum not checked).
+ * @param cls: Sensor classifier; confidence and frame means are updated.
+ * @param widths: Bit widths in microseconds, first bit first.
+ * @param data: Output buffer for the 5 frame bytes.
+ */
+void DHT11_Classify(dht11_classifier_t *cls, const uint16_t widths[40],
+		uint8_t data[5]);
+
+/**
+ * @brief Folds the last frame into the running means. Call only once the
+ *        checksum has confirmed the classification.
+ */
+void DHT11_Classify_Learn(dht11_classifier_t *cls);
+
+/**
+ * @brief Current running threshold in microseconds.
+ */
+uint32_t DHT11_Classify_Threshold(const dht11_classifier_t *cls);
+
+#endif /* DHT11_CLASSIFY_H_ */
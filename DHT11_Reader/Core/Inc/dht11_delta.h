@@ -0,0 +1,119 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_delta.h
+ * @brief          : Delta and run-length encoding stage for readings.
+ *
+ *                   Sits between acquisition and an output that pays per
+ *                   byte. Per sensor, each reading becomes one of:
+ *                     KEY   absolute values, on the first reading, on a
+ *                           step too large for the output's delta fields,
+ *                           when the caller asks, and every key_every
+ *                           readings so a receiver that lost a record
+ *                           resynchronises;
+ *                     STEP  humidity/temperature change since the last
+ *                           reading;
+ *                     RUN   unchanged: nothing to send, the reading is
+ *                           counted into a run that the next KEY or STEP
+ *                           (or DHT11_Delta_TakeRun()) carries.
+ *
+ *                   Values are in tenths (DHT11_Delta_HumTenths() and
+ *                   DHT11_Delta_TempTenths()). Timing is left to the
+ *                   output: each has its own time fields, and passes
+ *                   DHT11_DELTA_NO_RUN or DHT11_DELTA_FORCE_KEY when a
+ *                   reading's time cannot be implied or encoded.
+ *
+ *                   Users: Telemetry_DeltaSink() (packet types 0x04/0x05)
+ *                   and the flash log (flashlog.h).
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef DHT11_DELTA_H_
+#define DHT11_DELTA_H_
+
+#include "main.h"
+#include "dht11.h"
+
+/** DHT11_Delta_Encode() flags */
+#define DHT11_DELTA_NO_RUN     (0x01U)  /*!< Send even if unchanged   */
+#define DHT11_DELTA_FORCE_KEY  (0x02U)  /*!< Send absolute values     */
+
+/**
+ * @brief What the output's record format can carry.
+ */
+typedef struct {
+	int16_t step_min;    /*!< Smallest humidity/temperature step, tenths */
+	int16_t step_max;    /*!< Largest step, tenths                       */
+	uint32_t run_max;    /*!< Longest run a record can carry             */
+	uint32_t key_every;  /*!< Readings between keyframes, 0: on need only */
+} dht11_delta_limits_t;
+
+/**
+ * @brief Encoder state of one sensor.
+ */
+typedef struct {
+	int16_t hum;         /*!< Last reading, tenths of %RH    */
+	int16_t temp;        /*!< Last reading, tenths of a degree */
+	uint32_t run;        /*!< Unchanged readings not yet sent */
+	uint32_t since_key;  /*!< Readings since the last keyframe */
+	uint8_t valid;       /*!< 0 until the first keyframe      */
+} dht11_delta_enc_t;
+
+/**
+ * @brief Kind of record a reading turned into.
+ */
+typedef enum {
+	DHT11_DELTA_RUN = 0,
+	DHT11_DELTA_STEP,
+	DHT11_DELTA_KEY
+} dht11_delta_kind_t;
+
+/**
+ * @brief Record to send for a KEY or STEP reading.
+ */
+typedef struct {
+	dht11_delta_kind_t kind;
+	uint32_t run;        /*!< Unchanged readings before this one     */
+	int16_t hum;         /*!< Absolute values, tenths                */
+	int16_t temp;
+	int16_t dh;          /*!< Steps from the previous reading (STEP) */
+	int16_t dtemp;
+} dht11_delta_t;
+
+/**
+ * @brief Forgets the sensor's state; the next reading is a keyframe.
+ */
+void DHT11_Delta_Reset(dht11_delta_enc_t *enc);
+
+/**
+ * @brief Encodes one successful reading.
+ * @param flags: DHT11_DELTA_NO_RUN and/or DHT11_DELTA_FORCE_KEY.
+ * @param out: Filled for KEY and STEP, untouched for RUN.
+ * @retval Kind of the reading.
+ */
+dht11_delta_kind_t DHT11_Delta_Encode(dht11_delta_enc_t *enc,
+		const dht11_delta_limits_t *limits, int16_t hum, int16_t temp,
+		uint32_t flags, dht11_delta_t *out);
+
+/**
+ * @brief Ends the current run, e.g. before a record the stage does not
+ *        see or a flush.
+ * @retval Unchanged readings in it.
+ */
+uint32_t DHT11_Delta_TakeRun(dht11_delta_enc_t *enc);
+
+/**
+ * @brief Relative humidity of a reading in tenths of %RH.
+ */
+int16_t DHT11_Delta_HumTenths(const dht11_reading_t *reading);
+
+/**
+ * @brief Temperature of a reading in tenths of a degree. Bit 7 of the
+ *        decimal byte is the sign on sensors that report below zero.
+ */
+int16_t DHT11_Delta_TempTenths(const dht11_reading_t *reading);
+
+#endif /* DHT11_DELTA_H_ */
@@ -0,0 +1,119 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_discover.h
+ * @brief          : Sensor discovery and hot-plug detection on the candidate
+ *                   data lines.
+ *
+ *                   Sensor headers are optional: a line with nothing on it
+ *                   answers a start pulse with no response at all, never
+ *                   with a bad frame. Every final status reaches
+ *                   DHT11_Discover_Report() through DHT11_Health_Report(),
+ *                   and each sensor is:
+ *                     - unknown until its first reading;
+ *                     - present from any reading that got a response,
+ *                       good or not;
+ *                     - absent after its first reading without one, or a
+ *                       present sensor after DHT11_DISCOVER_LOST_AFTER of
+ *                       them in a row (unplugged).
+ *
+ *                   The discovery pass is the sampling plan's first frame
+ *                   (dht11_sampler.h): every sensor starts with phase 0,
+ *                   so the multi build (dht11_multi.h) pulses all its
+ *                   candidate lines in parallel and knows after one frame
+ *                   which ones are populated. The single-line builds do
+ *                   the same for PA1.
+ *
+ *                   An absent sensor stays in the plan but is only
+ *                   rechecked every DHT11_DISCOVER_RECHECK_MS
+ *                   (DHT11_Health_NextIntervalMs()) and never retried
+ *                   (DHT11_Health_RetryDelayMs()), so an empty header costs
+ *                   one start pulse per recheck. Absent sensors fall due
+ *                   together and share one parallel frame. A sensor that
+ *                   answers a recheck is found: its next reading is
+ *                   brought forward (DHT11_Sampler_Request()) and it is
+ *                   read on its own period again.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef DHT11_DISCOVER_H_
+#define DHT11_DISCOVER_H_
+
+#include "main.h"
+#include "dht11.h"
+
+/* Set to 0 to read every sensor on its plan whether it answers or not */
+#define DHT11_USE_DISCOVERY (1)
+
+/** Sensors tracked; matches dht11_health.h */
+#define DHT11_DISCOVER_SENSORS     (8U)
+
+/** Readings without a response in a row that mark a present sensor absent */
+#define DHT11_DISCOVER_LOST_AFTER  (3U)
+
+/** Start to start of an absent sensor's rechecks; within the sampler's
+ *  DHT11_SAMPLER_MAX_PERIOD_MS, so the loop stays inside its watchdog */
+#define DHT11_DISCOVER_RECHECK_MS  (30000U)
+
+/**
+ * @brief Presence of one sensor.
+ */
+typedef enum {
+	DHT11_PRESENCE_UNKNOWN = 0,  /*!< Not read yet                  */
+	DHT11_PRESENCE_PRESENT,      /*!< Answers start pulses          */
+	DHT11_PRESENCE_ABSENT        /*!< Silent: rechecked slowly      */
+} dht11_presence_t;
+
+/**
+ * @brief Discovery counters.
+ */
+typedef struct {
+	uint32_t present;    /*!< Sensor bit mask now           */
+	uint32_t absent;     /*!< Sensor bit mask now           */
+	uint32_t found;      /*!< Absent or unknown to present  */
+	uint32_t lost;       /*!< Present to absent             */
+	uint32_t rechecks;   /*!< Readings of absent sensors    */
+} dht11_discover_stats_t;
+
+#if DHT11_USE_DISCOVERY
+
+#define DHT11_DISCOVER_REPORT(sensor, status) \
+	DHT11_Discover_Report((sensor), (status))
+#define DHT11_DISCOVER_IS_ABSENT(sensor) \
+	(DHT11_Discover_Get(sensor) == DHT11_PRESENCE_ABSENT)
+
+/**
+ * @brief Marks every sensor unknown.
+ */
+void DHT11_Discover_Init(void);
+
+/**
+ * @brief Updates the presence of a sensor from the final status of a
+ *        reading; called from DHT11_Health_Report().
+ */
+void DHT11_Discover_Report(uint32_t sensor, dht11_status_t status);
+
+/**
+ * @brief Presence of a sensor; unknown for an invalid one.
+ */
+dht11_presence_t DHT11_Discover_Get(uint32_t sensor);
+
+/**
+ * @brief Copies the discovery counters.
+ */
+void DHT11_Discover_GetStats(dht11_discover_stats_t *stats);
+
+/**
+ * @brief Short printable name of a presence state.
+ */
+const char* DHT11_Discover_Name(dht11_presence_t presence);
+
+#else
+#define DHT11_DISCOVER_REPORT(sensor, status) ((void) 0)
+#define DHT11_DISCOVER_IS_ABSENT(sensor)      (0U)
+#endif /* DHT11_USE_DISCOVERY */
+
+#endif /* DHT11_DISCOVER_H_ */
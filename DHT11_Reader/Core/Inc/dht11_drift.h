@@ -0,0 +1,154 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_drift.h
+ * @brief          : Per-sensor long-term timing drift: response length, '0'
+ *                   and '1' pulse-width clusters and checksum failure rate,
+ *                   with health events when the decoding margin shrinks.
+ *
+ *                   Every frame whose timing was complete is folded in,
+ *                   checksum good or bad:
+ *                     - response: LOW + HIGH of the sensor's answer, about
+ *                       160 us, as running mean and frame-to-frame variance;
+ *                     - bits: the frame's '0' and '1' widths as decoded, per
+ *                       cluster running mean and variance (spread within
+ *                       the frame plus wander between frames); only frames
+ *                       that pass the checksum, like the classifier;
+ *                     - checksum: running failure rate in permille.
+ *                   All are exponential: new = old + (frame - old) / 2^
+ *                   DHT11_DRIFT_SHIFT, so a few bytes per statistic cover
+ *                   the last hundred or so frames.
+ *
+ *                   Margin: the clearance between the clusters' 3-sigma
+ *                   edges, (mean1 - 3 sd1) - (mean0 + 3 sd0). It is what a
+ *                   split between the clusters (dht11_classify.h) has to
+ *                   work with; ageing sensors close it before frames start
+ *                   failing.
+ *
+ *                   After DHT11_DRIFT_LEARN_FRAMES good frames the margin
+ *                   and the response mean are kept as the sensor's
+ *                   baseline. Events, each with hysteresis:
+ *                     margin    below DHT11_DRIFT_MARGIN_MIN_US, or below
+ *                               (100 - DHT11_DRIFT_MARGIN_LOSS_PCT)% of
+ *                               the baseline;
+ *                     response  mean off its baseline by more than
+ *                               DHT11_DRIFT_RESPONSE_US;
+ *                     checksum  failure rate above
+ *                               DHT11_DRIFT_FAIL_PERMILLE.
+ *                   A raised event is logged (DEBUG_WARN) and shown by the
+ *                   CLI "drift" command. Reset a sensor's statistics after
+ *                   replacing it.
+ *
+ *                   Widths are those of the acquisition path: HIGH time
+ *                   when bit-banged, falling-to-falling periods on the
+ *                   capture paths (dht11_prof.h). The baseline makes the
+ *                   events path-independent.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef DHT11_DRIFT_H_
+#define DHT11_DRIFT_H_
+
+#include "main.h"
+
+/* Set to 1 to track per-sensor timing drift */
+#define DHT11_USE_DRIFT (1)
+
+/** Independent sensor contexts: PA1 sensor is 0, multi channels 0..7 */
+#define DHT11_DRIFT_SENSORS         (8U)
+
+/** Running statistics weight, 1/2^shift per frame */
+#define DHT11_DRIFT_SHIFT           (6U)
+
+/** Good frames before the baseline is taken and events are checked */
+#define DHT11_DRIFT_LEARN_FRAMES    (64U)
+
+/** Event thresholds */
+#define DHT11_DRIFT_MARGIN_MIN_US   (8U)
+#define DHT11_DRIFT_MARGIN_LOSS_PCT (50U)
+#define DHT11_DRIFT_RESPONSE_US     (20U)
+#define DHT11_DRIFT_FAIL_PERMILLE   (50U)
+
+/** An event clears this far inside its threshold; the checksum one at half
+ * its rate */
+#define DHT11_DRIFT_HYST_US         (2U)
+
+/** Event flags */
+#define DHT11_DRIFT_EV_MARGIN       (1U << 0)
+#define DHT11_DRIFT_EV_RESPONSE     (1U << 1)
+#define DHT11_DRIFT_EV_CHECKSUM     (1U << 2)
+#define DHT11_DRIFT_EVENTS          (3U)
+
+/**
+ * @brief Running mean and variance of one duration.
+ */
+typedef struct {
+	uint32_t mean_q8;       /*!< 1/256 us          */
+	uint32_t var_q8;        /*!< 1/256 us^2        */
+} dht11_drift_stat_t;
+
+/**
+ * @brief Drift state of one sensor.
+ */
+typedef struct {
+	dht11_drift_stat_t response;
+	dht11_drift_stat_t bit[2];     /*!< '0' and '1' widths              */
+	uint32_t frames;               /*!< Timed frames                    */
+	uint32_t good;                 /*!< Of which passed the checksum    */
+	uint32_t raised;               /*!< Events raised                   */
+	int32_t margin_q4;             /*!< Current margin, 1/16 us         */
+	int32_t base_margin_q4;
+	uint32_t base_response_q8;
+	uint32_t fail_q16;             /*!< Running checksum failure rate   */
+	uint16_t fail_permille;        /*!< The same rate, permille         */
+	uint8_t baseline;              /*!< Baseline taken                  */
+	uint8_t events;                /*!< DHT11_DRIFT_EV_* active         */
+} dht11_drift_t;
+
+#if DHT11_USE_DRIFT
+#define DHT11_DRIFT_FRAME(s, r, w, d, ok) DHT11_Drift_Frame((s), (r), (w), (d), (ok))
+#else
+#define DHT11_DRIFT_FRAME(s, r, w, d, ok) ((void) 0)
+#endif /* DHT11_USE_DRIFT */
+
+/**
+ * @brief Clears every sensor's statistics.
+ */
+void DHT11_Drift_Init(void);
+
+/**
+ * @brief Clears one sensor's statistics and baseline, e.g. after
+ *        replacing it.
+ */
+void DHT11_Drift_Reset(uint32_t sensor);
+
+/**
+ * @brief Folds one fully timed frame in. Safe from the decode ISRs.
+ * @param sensor: Sensor index.
+ * @param response_us: Response LOW + HIGH.
+ * @param widths: The 40 bit widths.
+ * @param data: The decoded bytes; bit values split the widths.
+ * @param checksum_ok: Non-zero if the frame passed its checksum.
+ */
+void DHT11_Drift_Frame(uint32_t sensor, uint32_t response_us,
+		const uint16_t widths[40], const uint8_t data[5], uint8_t checksum_ok);
+
+/**
+ * @brief Read-only view of a sensor's statistics.
+ */
+const dht11_drift_t* DHT11_Drift_Get(uint32_t sensor);
+
+/**
+ * @brief Standard deviation of a statistic, 1/16 us.
+ */
+uint32_t DHT11_Drift_SdQ4(const dht11_drift_stat_t *stat);
+
+/**
+ * @brief Short printable name of event flag i (0..DHT11_DRIFT_EVENTS-1).
+ */
+const char* DHT11_Drift_EventName(uint32_t i);
+
+#endif /* DHT11_DRIFT_H_ */
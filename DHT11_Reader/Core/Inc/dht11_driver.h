@@ -0,0 +1,96 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_driver.h
+ * @brief          : Sensor-type descriptors, so DHT11 and DHT22/AM2302
+ *                   sensors run on the same engines.
+ *
+ *                   The acquisition engines (bit-banged, TIM5 capture,
+ *                   EXTI, asynchronous and multi-channel) share the bit
+ *                   timing of the DHT family: an 80/80 us response, then
+ *                   40 bits of 50 us LOW and 26-28 or 70 us HIGH, and a
+ *                   byte-sum checksum. What differs is described by a
+ *                   dht11_driver_t, chosen per sensor:
+ *                     - start_us: the LOW start pulse (DHT11 18 ms,
+ *                       DHT22 1.1 ms). The DHT22 accepts up to 20 ms, so
+ *                       a multi-channel frame uses the longest pulse of
+ *                       the sensors it starts;
+ *                     - min_interval_ms: start-to-start minimum (DHT11
+ *                       1 s, DHT22 2 s), honoured by the sampling plan,
+ *                       retries and the asynchronous cadence;
+ *                     - decode: turns a checksum-valid frame into the
+ *                       reading layout of dht11.h (integer and tenth
+ *                       bytes, sign in bit 7 of the temperature tenths)
+ *                       and rejects values out of the sensor's range.
+ *                   Every reading leaves the driver in that one layout,
+ *                   so the filter, calibration, history, flash log and
+ *                   telemetry are shared by a mixed fleet unchanged. The
+ *                   layout holds DHT22 values exactly: one decimal, -40.0
+ *                   to 80.0 C and 0 to 100.0 %RH.
+ *
+ *                   Default: every sensor is a DHT11.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef DHT11_DRIVER_H_
+#define DHT11_DRIVER_H_
+
+#include "main.h"
+#include "dht11.h"
+
+/** Sensors with their own type; matches the 8-channel reader */
+#define DHT11_DRIVER_SENSORS (8U)
+
+/**
+ * @brief Descriptor of one sensor type.
+ */
+typedef struct {
+	const char *name;
+	uint32_t start_us;           /*!< LOW start pulse                  */
+	uint32_t min_interval_ms;    /*!< Start-to-start minimum           */
+	/** Checksum-valid frame to the reading layout, in place.
+	 *  Returns DHT11_OK, or DHT11_ERR_FRAME for values out of range. */
+	dht11_status_t (*decode)(uint8_t raw[5]);
+} dht11_driver_t;
+
+/** Built-in sensor types */
+extern const dht11_driver_t dht11_driver_dht11;
+extern const dht11_driver_t dht11_driver_dht22;
+
+/**
+ * @brief Makes every sensor a DHT11.
+ */
+void DHT11_Driver_Init(void);
+
+/**
+ * @brief Sets the type of one sensor.
+ * @retval 1 if applied, 0 for an invalid sensor or a NULL driver.
+ */
+uint8_t DHT11_Driver_Set(uint8_t sensor_id, const dht11_driver_t *driver);
+
+/**
+ * @brief Type of one sensor; the DHT11 for unknown sensors.
+ */
+const dht11_driver_t* DHT11_Driver_Get(uint8_t sensor_id);
+
+/**
+ * @brief Built-in type by name, NULL if there is none.
+ */
+const dht11_driver_t* DHT11_Driver_Find(const char *name);
+
+/**
+ * @brief Decodes a checksum-valid frame of one sensor in place.
+ * @retval DHT11_OK, or DHT11_ERR_FRAME for values out of range.
+ */
+dht11_status_t DHT11_Driver_Decode(uint8_t sensor_id, uint8_t raw[5]);
+
+/**
+ * @brief Start pulse of one sensor in whole milliseconds, rounded up, for
+ *        the HAL_Delay() based paths.
+ */
+uint32_t DHT11_Driver_StartMs(uint8_t sensor_id);
+
+#endif /* DHT11_DRIVER_H_ */
@@ -0,0 +1,96 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_emit.h
+ * @brief          : Emission policy between acquisition and the output sink.
+ *
+ *                   DHT11_Sink_Emit() still stores every reading in the
+ *                   history and the flash log, but asks DHT11_Emit_Decide()
+ *                   before handing it to the active sink:
+ *                     - periodic:  every reading, or at most one per
+ *                                  period_ms;
+ *                     - change:    when temperature or humidity moved by
+ *                                  at least its deadband since the last
+ *                                  reading sent;
+ *                     - threshold: when temperature or humidity crosses its
+ *                                  level, going up at the level and coming
+ *                                  back down below level - hysteresis.
+ *                   In every mode a reading is also sent when its status
+ *                   differs from the last one sent, and when the sensor has
+ *                   been silent for heartbeat_ms (0: no heartbeat), so the
+ *                   host can tell a quiet room from a dead node. Decisions
+ *                   use the calibrated values (dht11_calib.h), per sensor.
+ *
+ *                   Default: periodic, every reading, as before.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef DHT11_EMIT_H_
+#define DHT11_EMIT_H_
+
+#include "main.h"
+#include "dht11.h"
+
+/** Sensors tracked; matches the 8-channel reader */
+#define DHT11_EMIT_SENSORS (8U)
+
+/**
+ * @brief Emission mode.
+ */
+typedef enum {
+	DHT11_EMIT_PERIODIC = 0,
+	DHT11_EMIT_CHANGE,
+	DHT11_EMIT_THRESHOLD
+} dht11_emit_mode_t;
+
+/**
+ * @brief Policy shared by all sensors. Values in tenths.
+ */
+typedef struct {
+	dht11_emit_mode_t mode;
+	uint32_t period_ms;      /*!< periodic: minimum spacing, 0 = all  */
+	int16_t deadband_temp;   /*!< change                              */
+	int16_t deadband_hum;
+	int16_t level_temp;      /*!< threshold                           */
+	int16_t level_hum;
+	int16_t hysteresis;      /*!< threshold, both quantities          */
+	uint32_t heartbeat_ms;   /*!< Longest silence, 0 = none           */
+} dht11_emit_cfg_t;
+
+/**
+ * @brief Restores the default policy and forgets what was sent.
+ */
+void DHT11_Emit_Init(void);
+
+/**
+ * @brief Replaces the policy and forgets what was sent, so the next
+ *        reading of each sensor goes out.
+ */
+void DHT11_Emit_SetConfig(const dht11_emit_cfg_t *cfg);
+
+/**
+ * @brief Current policy.
+ */
+dht11_emit_cfg_t DHT11_Emit_GetConfig(void);
+
+/**
+ * @brief Decides whether a reading goes to the sink, and if so records it
+ *        as the last one sent.
+ * @retval 1 to send, 0 to suppress.
+ */
+uint8_t DHT11_Emit_Decide(const dht11_reading_t *reading);
+
+/**
+ * @brief Readings suppressed since DHT11_Emit_Init().
+ */
+uint32_t DHT11_Emit_GetSuppressed(void);
+
+/**
+ * @brief Printable mode name.
+ */
+const char* DHT11_Emit_ModeName(dht11_emit_mode_t mode);
+
+#endif /* DHT11_EMIT_H_ */
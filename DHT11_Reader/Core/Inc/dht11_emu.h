@@ -0,0 +1,147 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_emu.h
+ * @brief          : DHT11 emulator on PB10 for loopback decoder benchmarks.
+ *
+ *                   With DHT11_EMU_USE_LOOPBACK the board answers its own
+ *                   start pulses: jumper PB10 (Arduino D6) to PA1 and the
+ *                   reader sees a sensor whose frame, pulse widths and
+ *                   jitter are set from the CLI.
+ *
+ *                   PB10 is TIM2_CH3 (AF1) in open-drain, released while
+ *                   idle. EXTI10 times the host's LOW on TIM2, free-running
+ *                   at 1 MHz; a release after at least
+ *                   DHT11_EMU_START_MIN_US of LOW restarts the counter and
+ *                   plays the frame: channel 3 toggles the line on each
+ *                   compare and DMA1 Stream1 (channel 3) loads the next
+ *                   edge time into CCR3, so all DHT11_EMU_EDGES edges come
+ *                   from the timer with no CPU work and no interrupt while
+ *                   the reader measures them. Every segment is lengthened
+ *                   or shortened by a uniform random amount of up to
+ *                   jitter_us; the edge table for the next frame is drawn
+ *                   in the CLI poll loop while the current one plays.
+ *
+ *                   "emu run <n>" reads n frames back to back through
+ *                   DHT11_ReadOnce() (the configured PA1 path: capture,
+ *                   EXTI, oversampled or bit-banged) from the CLI poll loop, one per
+ *                   pass, with the async refresh paused: no retries, no
+ *                   1 s spacing, about 2500 frames a minute. Each result is
+ *                   compared with the bytes sent; the profile (dht11_prof.h)
+ *                   is reset first, so "prof" then shows the bench's phase
+ *                   cycles and width histograms. Not under the RTOS or the
+ *                   multi-sensor reader, which own the PA1 reads.
+ *
+ *                   STOP mode is held off (TIM2 must run).
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef DHT11_EMU_H_
+#define DHT11_EMU_H_
+
+#include "main.h"
+#include "dht11.h"
+#include "dht11_prof.h"
+
+/* Set to 1 to emulate a DHT11 on PB10 (jumpered to PA1) */
+#define DHT11_EMU_USE_LOOPBACK (0)
+
+/** Shortest LOW taken as a start pulse (DHT11 18 ms, DHT22 1 ms) */
+#define DHT11_EMU_START_MIN_US (800U)
+
+/** Edges per frame: response LOW and HIGH, LOW and HIGH per bit, release */
+#define DHT11_EMU_EDGES        (84U)
+
+/** Largest jitter, and the shortest segment it may leave */
+#define DHT11_EMU_JITTER_MAX   (20U)
+#define DHT11_EMU_SEGMENT_MIN  (5U)
+
+/**
+ * @brief What the emulated sensor sends. Times in microseconds.
+ */
+typedef struct {
+	uint8_t frame[5];     /*!< Humidity, temperature, checksum      */
+	uint16_t wait_us;     /*!< Release -> response LOW (30)         */
+	uint16_t resp_us;     /*!< Each response phase (80)             */
+	uint16_t low_us;      /*!< Bit preamble LOW (50)                */
+	uint16_t zero_us;     /*!< '0' HIGH (26)                        */
+	uint16_t one_us;      /*!< '1' HIGH (70)                        */
+	uint16_t jitter_us;   /*!< Per-segment uniform +/-, 0 = exact   */
+} dht11_emu_cfg_t;
+
+/**
+ * @brief Emulator and bench counters.
+ */
+typedef struct {
+	uint32_t frames_sent;  /*!< Start pulses answered                 */
+	uint32_t stale;        /*!< Of which replayed the previous jitter */
+	uint32_t run_left;     /*!< Bench frames still to read            */
+	uint32_t reads;        /*!< Bench frames read                     */
+	uint32_t ok;           /*!< Read back as sent                     */
+	uint32_t wrong;        /*!< Checksum passed on other bytes        */
+	uint32_t status[DHT11_PROF_STATUSES]; /*!< Bench results by status */
+	uint32_t elapsed_ms;   /*!< Bench time so far                     */
+} dht11_emu_stats_t;
+
+#if DHT11_EMU_USE_LOOPBACK
+
+/**
+ * @brief Claims PB10, TIM2, DMA1 Stream1 and EXTI10 and starts answering
+ *        with a nominal frame (40.0 %RH, 23.5 degC).
+ */
+void DHT11_Emu_Init(void);
+
+/**
+ * @brief Replaces the frame and timing; the next start pulse uses them.
+ *        Jitter is capped at DHT11_EMU_JITTER_MAX.
+ */
+void DHT11_Emu_SetConfig(const dht11_emu_cfg_t *cfg);
+
+/**
+ * @brief Current frame and timing.
+ */
+dht11_emu_cfg_t DHT11_Emu_GetConfig(void);
+
+/**
+ * @brief Starts a bench of frames reads and clears its counters.
+ * @retval 0 if this build cannot run it (RTOS or multi-sensor reader).
+ */
+uint8_t DHT11_Emu_Run(uint32_t frames);
+
+/**
+ * @brief Draws the next edge table and reads one bench frame. Call from
+ *        the CLI poll loop.
+ */
+void DHT11_Emu_Poll(void);
+
+/**
+ * @brief Copies the counters.
+ */
+void DHT11_Emu_GetStats(dht11_emu_stats_t *stats);
+
+/**
+ * @brief Recomputes the TIM2 prescaler after a clock profile change.
+ */
+void DHT11_Emu_ClockChanged(void);
+
+/**
+ * @brief Host LOW start and release; called from EXTI15_10_IRQHandler().
+ */
+void DHT11_Emu_ExtiIRQHandler(void);
+
+/**
+ * @brief Last edge time loaded; called from DMA1_Stream1_IRQHandler().
+ */
+void DHT11_Emu_DmaIRQHandler(void);
+
+/** The emulator holds TIM2 and PB10 from DHT11_Emu_Init() on */
+#define DHT11_Emu_IsEnabled()  (1U)
+
+#else
+#define DHT11_Emu_IsEnabled()  (0U)
+#endif /* DHT11_EMU_USE_LOOPBACK */
+
+#endif /* DHT11_EMU_H_ */
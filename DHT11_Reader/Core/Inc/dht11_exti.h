@@ -0,0 +1,123 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_exti.h
+ * @brief          : EXTI edge-interrupt decoder for the DHT11 bit stream,
+ *                   for boards that cannot route the data line to a timer
+ *                   channel.
+ *
+ *                   EXTI line 1 fires on both edges of PA1. The handler
+ *                   reads DWT CYCCNT first, then the line level: a falling
+ *                   edge stores its cycle stamp, and two edges of the same
+ *                   direction in a row mean one was lost to interrupt
+ *                   latency, which fails the frame. After the response
+ *                   edge and the 41 edges around the data bits
+ *                   (DHT11_CAPTURE_EDGES), the line is masked and the
+ *                   completion hook runs. The stamps are converted to
+ *                   microseconds and decoded by DHT11_Capture_DecodeEdges(),
+ *                   so the classifier and the checks are the capture
+ *                   path's.
+ *
+ *                   The CPU is free during the frame as with capture, at
+ *                   the cost of 83 short interrupts and a stamp that moves
+ *                   with interrupt latency (a few cycles, more while a
+ *                   level-0 handler runs) instead of the timer's latch.
+ *
+ *                   The pin stays in open-drain output mode: EXTI watches
+ *                   the input stage, so the released line is read back
+ *                   without a mode switch. Any GPIO works; only the line
+ *                   number (DHT11_PIN_NUM) and the IRQ below change.
+ *
+ *                   Call DHT11_Exti_Init() after Timebase_Init() (DWT).
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef DHT11_EXTI_H_
+#define DHT11_EXTI_H_
+
+#include "main.h"
+#include "dht11.h"
+#include "dht11_capture.h"
+#include "dht11_pin.h"
+
+/* Set to 1 to read PA1 through EXTI edge interrupts instead of TIM5 capture */
+#define DHT11_USE_EXTI (0)
+
+#if DHT11_USE_EXTI && !DHT11_USE_CAPTURE
+#error "DHT11_USE_EXTI decodes edge periods: set DHT11_USE_CAPTURE to 1"
+#endif
+
+/** EXTI line and interrupt of the data pin */
+#define DHT11_EXTI_LINE  (1UL << DHT11_PIN_NUM)
+#define DHT11_EXTI_IRQn  EXTI1_IRQn
+
+#if DHT11_PIN_NUM != 1U
+#error "DHT11_EXTI_IRQn must match DHT11_PIN_NUM"
+#endif
+
+/**
+ * @brief Completion hook, called from the EXTI handler once every edge
+ *        has been stamped or a lost edge was detected.
+ */
+typedef void (*dht11_exti_cb_t)(void);
+
+/**
+ * @brief Routes PA1 to EXTI line 1 on both edges, masked, and enables the
+ *        interrupt.
+ */
+void DHT11_Exti_Init(void);
+
+/**
+ * @brief Installs the completion hook, NULL for none.
+ */
+void DHT11_Exti_SetCallback(dht11_exti_cb_t cb);
+
+/**
+ * @brief Drives the data line LOW to begin the start pulse.
+ */
+void DHT11_Exti_DriveLow(void);
+
+/**
+ * @brief Releases the data line and unmasks the EXTI line.
+ *        Call this at the end of the ≥18 ms LOW start pulse.
+ * @retval DHT11_OK, or DHT11_ERR_BUSY if a frame is still running.
+ */
+dht11_status_t DHT11_Exti_Arm(void);
+
+/**
+ * @brief Masks the EXTI line and drops the frame.
+ */
+void DHT11_Exti_Abort(void);
+
+/**
+ * @brief Reports whether the frame has ended (complete or lost edge).
+ */
+uint8_t DHT11_Exti_IsComplete(void);
+
+/**
+ * @brief Falling edges stamped so far in the current frame.
+ */
+uint32_t DHT11_Exti_EdgeCount(void);
+
+/**
+ * @brief Decodes the stamped falling edges into 5 data bytes.
+ * @retval DHT11_OK, DHT11_ERR_FRAME or DHT11_ERR_CHECKSUM.
+ */
+dht11_status_t DHT11_Exti_Decode(uint8_t data[5]);
+
+/**
+ * @brief Blocking transaction through the EXTI decoder.
+ * @param data: Output buffer for the 5 frame bytes.
+ * @retval Transaction status.
+ */
+dht11_status_t DHT11_Exti_Read(uint8_t data[5]);
+
+/**
+ * @brief Edge handler; called from EXTI1_IRQHandler().
+ */
+void DHT11_Exti_IRQHandler(void);
+
+#endif /* DHT11_EXTI_H_ */
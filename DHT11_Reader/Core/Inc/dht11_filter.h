@@ -0,0 +1,102 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_filter.h
+ * @brief          : Streaming median, Hampel and EMA filter stage for
+ *                   readings.
+ *
+ *                   DHT11_Sink_Emit() passes every good reading through
+ *                   DHT11_Filter_Apply() before it is stored or sent, so
+ *                   the history, the flash log and every sink see the
+ *                   filtered values. Per sensor, temperature and humidity
+ *                   each keep a ring of the last window raw values and
+ *                   the same values sorted:
+ *                     - Hampel: a value further from the window median
+ *                       than hampel_k * 1.4826 * MAD (median absolute
+ *                       deviation), and at least the quantity's minimum
+ *                       deviation, is an outlier and replaced by the
+ *                       median. The raw value still enters the window, so
+ *                       a real step is accepted after (window + 1) / 2
+ *                       readings;
+ *                     - median: optionally output the window median
+ *                       instead of the (Hampel-checked) value;
+ *                     - EMA: y += alpha * (x - y) on the result, alpha in
+ *                       Q16.16, DHT11_FILTER_ONE to pass through.
+ *                   An update costs a binary search and at most window - 1
+ *                   moves per sorted insert or removal, and one merge pass
+ *                   from the median outwards for the MAD; window is at most
+ *                   DHT11_FILTER_WINDOW_MAX, so it is bounded and small.
+ *                   The filtered values are written back into the raw
+ *                   bytes with a fresh checksum.
+ *
+ *                   Default: window 5, Hampel at 3.0, no median, no EMA,
+ *                   so only outliers change.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef DHT11_FILTER_H_
+#define DHT11_FILTER_H_
+
+#include "main.h"
+#include "dht11.h"
+
+/** Sensors with their own filter; matches the 8-channel reader */
+#define DHT11_FILTER_SENSORS     (8U)
+
+/** Longest window, odd */
+#define DHT11_FILTER_WINDOW_MAX  (15U)
+
+/** Q16.16 EMA weight of 1.0: no smoothing */
+#define DHT11_FILTER_ONE         (65536)
+
+/** Smallest deviation treated as an outlier, tenths; keeps a flat window
+ * (MAD 0) from rejecting every change */
+#define DHT11_FILTER_MIN_DEV_TEMP (20)
+#define DHT11_FILTER_MIN_DEV_HUM  (50)
+
+/** Configuration applied by DHT11_Filter_Init() */
+#define DHT11_FILTER_DEFAULT_WINDOW   (5U)
+#define DHT11_FILTER_DEFAULT_HAMPEL_K (30U)
+
+/**
+ * @brief Filter configuration of one sensor, both quantities.
+ */
+typedef struct {
+	uint8_t window;      /*!< Samples, odd, 1 to DHT11_FILTER_WINDOW_MAX */
+	uint8_t median;      /*!< Nonzero: output the window median          */
+	uint8_t hampel_k;    /*!< Threshold in tenths of a scaled MAD, 0 off */
+	int32_t ema_alpha;   /*!< Q16.16, DHT11_FILTER_ONE: off              */
+} dht11_filter_cfg_t;
+
+/**
+ * @brief Applies the default configuration to every sensor and empties
+ *        the windows.
+ */
+void DHT11_Filter_Init(void);
+
+/**
+ * @brief Sets one sensor's configuration and empties its windows.
+ * @retval 1 if applied, 0 for an invalid sensor or setting.
+ */
+uint8_t DHT11_Filter_SetConfig(uint8_t sensor_id, const dht11_filter_cfg_t *cfg);
+
+/**
+ * @brief Configuration of one sensor; the default for unknown sensors.
+ */
+dht11_filter_cfg_t DHT11_Filter_GetConfig(uint8_t sensor_id);
+
+/**
+ * @brief Filters a good reading in place; others are left alone.
+ * @retval 1 if temperature or humidity was an outlier.
+ */
+uint8_t DHT11_Filter_Apply(dht11_reading_t *reading);
+
+/**
+ * @brief Outliers replaced for one sensor since DHT11_Filter_Init().
+ */
+uint32_t DHT11_Filter_GetRejected(uint8_t sensor_id);
+
+#endif /* DHT11_FILTER_H_ */
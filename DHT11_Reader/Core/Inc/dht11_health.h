@@ -0,0 +1,133 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_health.h
+ * @brief          : Per-sensor retry policy and health state machine.
+ *
+ *                   Retries: a failed attempt is repeated up to max_retries
+ *                   times. Retry n starts at least
+ *                   min(backoff_base_ms << (n - 1), backoff_max_ms) after the
+ *                   previous start pulse, and never less than
+ *                   min_spacing_ms, or the minimum interval of the sensor
+ *                   type (dht11_driver.h) if that is longer.
+ *
+ *                   Health, updated once per reading (after its retries):
+ *
+ *                              fail                fail x fail_threshold
+ *                     OK ---------------> DEGRADED ----------------------> FAILED
+ *                      ^                   |    ^                            |
+ *                      +-------------------+    +----------------------------+
+ *                     recover_count x ok              first ok
+ *
+ *                   While FAILED, the sensor is only probed: the read
+ *                   interval doubles with every further failure, up to
+ *                   backoff_max_ms. With a switched supply
+ *                   (dht11_supply.h), runs of failures also power-cycle
+ *                   the sensor. A sensor that does not answer at all is
+ *                   absent (dht11_discover.h): never retried and read
+ *                   only every DHT11_DISCOVER_RECHECK_MS.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef DHT11_HEALTH_H_
+#define DHT11_HEALTH_H_
+
+#include "main.h"
+#include "dht11.h"
+
+/** Independent sensor contexts: PA1 sensor is 0, multi channels 0..7 */
+#define DHT11_HEALTH_SENSORS          (8U)
+
+/** Default policy */
+#define DHT11_HEALTH_MIN_SPACING_MS   (1000U)  /*!< DHT11: ≥1 s between start pulses */
+#define DHT11_HEALTH_BACKOFF_BASE_MS  (1000U)
+#define DHT11_HEALTH_BACKOFF_MAX_MS   (30000U)
+#define DHT11_HEALTH_FAIL_THRESHOLD   (5U)     /*!< Failed readings in a row -> FAILED */
+#define DHT11_HEALTH_RECOVER_COUNT    (3U)     /*!< Good readings in a row -> OK       */
+
+/**
+ * @brief Sensor health.
+ */
+typedef enum {
+	DHT11_HEALTH_OK = 0,    /*!< Last readings all succeeded           */
+	DHT11_HEALTH_DEGRADED,  /*!< Recent failures, still read normally  */
+	DHT11_HEALTH_FAILED     /*!< Persistent failure, probed slowly     */
+} dht11_health_t;
+
+/**
+ * @brief Retry policy of one sensor.
+ */
+typedef struct {
+	uint8_t max_retries;        /*!< Extra attempts per reading             */
+	uint8_t retry_no_response;  /*!< Also retry DHT11_ERR_NO_RESPONSE       */
+	uint8_t fail_threshold;     /*!< See DHT11_HEALTH_FAIL_THRESHOLD        */
+	uint8_t recover_count;      /*!< See DHT11_HEALTH_RECOVER_COUNT         */
+	uint32_t min_spacing_ms;    /*!< Start-to-start minimum                 */
+	uint32_t backoff_base_ms;   /*!< First retry delay                      */
+	uint32_t backoff_max_ms;    /*!< Delay cap, also the slowest probe rate */
+} dht11_policy_t;
+
+/**
+ * @brief Applies the default policy to every sensor and marks them OK.
+ */
+void DHT11_Health_Init(void);
+
+/**
+ * @brief Replaces the retry policy of a sensor.
+ */
+void DHT11_Health_SetPolicy(uint32_t sensor, const dht11_policy_t *policy);
+
+/**
+ * @brief Returns the retry policy of a sensor.
+ */
+const dht11_policy_t* DHT11_Health_GetPolicy(uint32_t sensor);
+
+/**
+ * @brief Shortest start-to-start spacing of a sensor: the larger of the
+ *        policy's min_spacing_ms and its type's min_interval_ms
+ *        (dht11_driver.h).
+ */
+uint32_t DHT11_Health_MinSpacingMs(uint32_t sensor);
+
+/**
+ * @brief Decides whether a failed attempt is retried.
+ * @param sensor: Sensor index.
+ * @param status: Outcome of the attempt.
+ * @param retries: Retries already made for this reading.
+ * @retval Delay from the failed attempt's start to the retry's start in
+ *         ms, or 0 for no retry.
+ */
+uint32_t DHT11_Health_RetryDelayMs(uint32_t sensor, dht11_status_t status,
+		uint8_t retries);
+
+/**
+ * @brief Feeds the final status of a reading into the state machine.
+ */
+void DHT11_Health_Report(uint32_t sensor, dht11_status_t status);
+
+/**
+ * @brief Start-to-start period until the next reading.
+ * @param nominal_ms: Interval used while OK or DEGRADED.
+ * @retval nominal_ms, or the probe interval while FAILED.
+ */
+uint32_t DHT11_Health_NextIntervalMs(uint32_t sensor, uint32_t nominal_ms);
+
+/**
+ * @brief Current health of a sensor.
+ */
+dht11_health_t DHT11_Health_Get(uint32_t sensor);
+
+/**
+ * @brief Failed readings in a row.
+ */
+uint32_t DHT11_Health_GetFailures(uint32_t sensor);
+
+/**
+ * @brief Short printable name of a health state.
+ */
+const char* DHT11_Health_Name(dht11_health_t health);
+
+#endif /* DHT11_HEALTH_H_ */
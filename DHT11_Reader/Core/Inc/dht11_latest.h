@@ -0,0 +1,68 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_latest.h
+ * @brief          : Latest state of every sensor, published through
+ *                   seqlock.h.
+ *
+ *                   Each sensor has its own seqlock, written by whatever
+ *                   context completes its readings (today the sink in
+ *                   thread context; an acquisition interrupt works the
+ *                   same, one writer per sensor). Any number of readers,
+ *                   interrupt handlers included, take consistent copies
+ *                   without masking interrupts or waiting: the Modbus
+ *                   slave answers from them in its t3.5 interrupt, and the
+ *                   "latest" command prints them.
+ *
+ *                   An entry holds the last reading, good or failed, the
+ *                   sensor's health after it and the calibrated values of
+ *                   the last good one, so a failed reading does not blank
+ *                   the numbers.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef DHT11_LATEST_H_
+#define DHT11_LATEST_H_
+
+#include "main.h"
+#include "dht11.h"
+#include "dht11_calib.h"
+#include "dht11_health.h"
+
+/** Sensors tracked, by sensor_id */
+#define DHT11_LATEST_SENSORS (8U)
+
+/**
+ * @brief One sensor's published state.
+ */
+typedef struct {
+	dht11_reading_t reading;  /*!< Last reading, filtered, good or failed */
+	dht11_values_t values;    /*!< Calibrated, from the last good reading */
+	uint32_t good_ms;         /*!< HAL tick of the last good reading      */
+	uint32_t failures;        /*!< Consecutive failures after reading     */
+	dht11_health_t health;    /*!< Health state after reading             */
+	uint8_t has_values;       /*!< values and good_ms are set             */
+} dht11_latest_t;
+
+/**
+ * @brief Forgets every sensor. Call before the first reading.
+ */
+void DHT11_Latest_Init(void);
+
+/**
+ * @brief Publishes a reading of its sensor. One writing context per
+ *        sensor; never blocks.
+ */
+void DHT11_Latest_Publish(const dht11_reading_t *reading);
+
+/**
+ * @brief Copies a sensor's latest state; safe from any context.
+ * @retval Readings published for the sensor so far, 0 if none (entry
+ *         zeroed) or the sensor is out of range (entry untouched).
+ */
+uint32_t DHT11_Latest_Get(uint8_t sensor_id, dht11_latest_t *entry);
+
+#endif /* DHT11_LATEST_H_ */
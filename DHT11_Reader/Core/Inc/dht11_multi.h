@@ -0,0 +1,189 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_multi.h
+ * @brief          : Parallel acquisition of up to 8 DHT11 sensors on up to
+ *                   four GPIO ports.
+ *
+ *                   All data lines are pulled low together, one BSRR write
+ *                   per port, and released together. TIM1 then paces one
+ *                   DMA2 stream per port (channel 6), each copying its
+ *                   port's whole IDR into that port's sample buffer every
+ *                   DHT11_MULTI_SAMPLE_US:
+ *                     slot 0  update event  Stream5
+ *                     slot 1  CC1 match     Stream3
+ *                     slot 2  CC2 match     Stream2
+ *                     slot 3  CC3 match     Stream6
+ *                   The compares sit at ARR, so the ports' samples are
+ *                   1 us ahead of slot 0's and the streams share one
+ *                   counter: the same sample index is the same instant,
+ *                   within that microsecond, on every port. Slot 0 is the
+ *                   last to fill and its transfer-complete ends the
+ *                   window for all. After the window, each channel's bit
+ *                   stream is demultiplexed from its port's buffer into
+ *                   falling-edge timestamps and decoded with the same
+ *                   rules as the TIM5 capture path.
+ *
+ *                   Sensors may then be wired wherever the board has free
+ *                   pins; a frame takes as long with four ports as with
+ *                   one. Each port costs DHT11_MULTI_BUFFERS x
+ *                   DHT11_MULTI_SAMPLES halfwords of SRAM2 (4.8 KB).
+ *
+ *                   N sensors are read in the time of one frame (~5 ms
+ *                   after the 18 ms start pulse) instead of N back to back.
+ *
+ *                   Frames are pipelined over DHT11_MULTI_BUFFERS sample
+ *                   buffers: DHT11_Multi_Begin() starts the next frame's
+ *                   pulse into the other buffer, so the channels due next
+ *                   are pulsed and sampled while the previous frame is
+ *                   demultiplexed, decoded and published by
+ *                   DHT11_Multi_Collect(). The buffers swap on each
+ *                   transfer-complete; a frame's buffer is kept until it
+ *                   has been collected. DHT11_Multi_Read() is the same
+ *                   steps back to back.
+ *
+ *                   DMA2 is used because only its peripheral port reaches
+ *                   the AHB1 GPIO registers.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef DHT11_MULTI_H_
+#define DHT11_MULTI_H_
+
+#include "main.h"
+#include "dht11.h"
+#include "dht11_pin.h"
+
+/* Set to 1 to build the multi-sensor driver and use it in main() */
+#define DHT11_USE_MULTI          (0)
+
+/** Ports carrying data lines, 1 to 4; slot n is DHT11_MULTI_PORT_<n> */
+#define DHT11_MULTI_PORTS        (1U)
+#define DHT11_MULTI_PORT_0       GPIOC
+#define DHT11_MULTI_PORT_1       GPIOB
+#define DHT11_MULTI_PORT_2       GPIOA
+#define DHT11_MULTI_PORT_3       GPIOD
+
+/** Number of sensor channels */
+#define DHT11_MULTI_CHANNELS     (8U)
+
+/**
+ * Port slot and pin number of each channel, as X(channel, slot, pin); the
+ * slot is a bare digit. The pin tables and the per-channel accessors
+ * DHT11_Ch<n>_Low() etc. (dht11_pin.h) are generated from this list. A
+ * board with sensors on three ports, say, sets DHT11_MULTI_PORTS to 3 and
+ * lists X(0, 0, 0U) X(1, 0, 1U) X(2, 1, 12U) X(3, 2, 8U) ...
+ */
+#define DHT11_MULTI_PINS(X) \
+	X(0, 0, 0U) X(1, 0, 1U) X(2, 0, 2U) X(3, 0, 3U) \
+	X(4, 0, 4U) X(5, 0, 5U) X(6, 0, 8U) X(7, 0, 9U)
+
+#if (DHT11_MULTI_PORTS < 1U) || (DHT11_MULTI_PORTS > 4U)
+#error "DHT11_MULTI_PORTS must be 1 to 4"
+#endif
+
+/** IDR sampling period; 5 us resolves the 26 us '0' pulse comfortably */
+#define DHT11_MULTI_SAMPLE_US    (5U)
+
+/** Sampling window after release: response + 40 bits of '1' fits in 5.1 ms */
+#define DHT11_MULTI_WINDOW_US    (6000U)
+
+#define DHT11_MULTI_SAMPLES      (DHT11_MULTI_WINDOW_US / DHT11_MULTI_SAMPLE_US)
+#define DHT11_MULTI_WINDOW_MS    ((DHT11_MULTI_WINDOW_US + 999U) / 1000U)
+
+/** Sample buffers: one being filled while the other is decoded */
+#define DHT11_MULTI_BUFFERS      (2U)
+
+/** Channel mask of every channel */
+#define DHT11_MULTI_ALL          ((1UL << DHT11_MULTI_CHANNELS) - 1UL)
+
+#define DHT11_MULTI_PIN_BIND(ch, slot, num) \
+	DHT11_PIN_DEFINE(DHT11_Ch##ch, DHT11_MULTI_PORT_##slot, num)
+
+DHT11_MULTI_PINS(DHT11_MULTI_PIN_BIND)
+
+/**
+ * @brief Configures every channel pin as released open-drain with pull-up
+ *        and the sampling streams of slots 1 and up. Call after
+ *        MX_TIM1_Init().
+ */
+void DHT11_Multi_Init(void);
+
+/**
+ * @brief TIM1 prescaler for a 1 MHz count from the APB2 timer clock.
+ */
+uint32_t DHT11_Multi_TimerPrescaler(void);
+
+/**
+ * @brief Pulls the lines of the given channels low together (start of the
+ *        ≥18 ms pulse).
+ * @param channels: Channel bit mask.
+ */
+void DHT11_Multi_DriveLow(uint32_t channels);
+
+/**
+ * @brief Holds the lines of the given channels LOW across frames, for
+ *        sensors that are unpowered (dht11_supply.h), and releases the
+ *        channels no longer held.
+ * @param channels: Channel bit mask of every held channel.
+ */
+void DHT11_Multi_Hold(uint32_t channels);
+
+/**
+ * @brief Begins a frame: takes the next sample buffer and pulls the
+ *        channels low. Call DHT11_Multi_Arm() once pulse_ms has passed;
+ *        the pulse may run longer, the sensors only need the minimum.
+ * @param channels: Channel bit mask.
+ * @param pulse_ms: Out: the longest start pulse the channels' types need.
+ * @retval DHT11_OK, or DHT11_ERR_BUSY if a frame is still in its pulse or
+ *         window, or the next buffer has not been collected.
+ */
+dht11_status_t DHT11_Multi_Begin(uint32_t channels, uint32_t *pulse_ms);
+
+/**
+ * @brief Starts IDR sampling of every port into the frame's buffers and
+ *        releases all lines in the same instant.
+ * @retval DHT11_OK, or DHT11_ERR_BUSY if no frame is in its start pulse.
+ */
+dht11_status_t DHT11_Multi_Arm(void);
+
+/**
+ * @brief Reports whether the frame begun last has left its pulse and
+ *        window: filled, timed out, or none begun.
+ */
+uint8_t DHT11_Multi_IsComplete(void);
+
+/**
+ * @brief Decodes and reports (profile, health) every channel of the
+ *        oldest filled frame and frees its buffer. A window not filled
+ *        within DHT11_CAPTURE_TIMEOUT_MS of the pulse is ended here and
+ *        its channels report DHT11_ERR_TIMEOUT.
+ * @param readings: DHT11_MULTI_CHANNELS entries; only the frame's
+ *        channels are written, sensor_id is the channel.
+ * @retval Channel mask of the frame collected, 0 if none was filled.
+ */
+uint32_t DHT11_Multi_Collect(dht11_reading_t readings[DHT11_MULTI_CHANNELS]);
+
+/**
+ * @brief Demultiplexes and decodes one channel from its port's last filled
+ *        buffer.
+ * @param channel: 0 .. DHT11_MULTI_CHANNELS-1.
+ * @param data: Output buffer for the 5 frame bytes.
+ * @retval Transaction status for that channel.
+ */
+dht11_status_t DHT11_Multi_Decode(uint32_t channel, uint8_t data[5]);
+
+/**
+ * @brief Blocking read of the given channels in one frame; the others are
+ *        not started and their entries are left untouched.
+ * @param channels: Channel bit mask, DHT11_MULTI_ALL for every channel.
+ * @param readings: DHT11_MULTI_CHANNELS entries; sensor_id is the channel.
+ * @retval Number of channels that returned DHT11_OK.
+ */
+uint32_t DHT11_Multi_Read(uint32_t channels,
+		dht11_reading_t readings[DHT11_MULTI_CHANNELS]);
+
+#endif /* DHT11_MULTI_H_ */
@@ -0,0 +1,131 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_oversample.h
+ * @brief          : Oversampled DHT11 decoder: the whole frame is sampled
+ *                   from GPIO IDR by timer-triggered DMA and decoded
+ *                   afterwards, with short glitches voted away.
+ *
+ *                   At the release of the start pulse, TIM8 update events
+ *                   start triggering DMA2 Stream1 (channel 7) to copy the
+ *                   IDR byte holding the data pin into a RAM buffer every
+ *                   DHT11_OVERSAMPLE_US, for DHT11_OVERSAMPLE_WINDOW_US:
+ *                   the response and 40 bits of '1' with margin. No CPU
+ *                   work and no interrupt happens while the sensor talks,
+ *                   so interrupt latency cannot move an edge.
+ *
+ *                   The buffer is then run-length encoded four samples per
+ *                   word read: a word whose four samples all match the
+ *                   current level (the common case, about 19 in 20) costs
+ *                   one AND and one compare. A run shorter than
+ *                   DHT11_OVERSAMPLE_GLITCH_US is outvoted by the samples
+ *                   around it and merged into its neighbours, so a spike
+ *                   or dropout of a few microseconds no longer splits or
+ *                   joins a bit. The falling edges of the filtered runs go
+ *                   to DHT11_Capture_DecodeEdges(), so the classifier and
+ *                   the checks are the capture path's.
+ *
+ *                   Costs 6 KB of SRAM2 at 1 us, TIM8 and DMA2 Stream1; the
+ *                   decode takes about 2000 word steps after the frame.
+ *                   DMA2 is used because only its peripheral port reaches
+ *                   the AHB1 GPIO registers.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef DHT11_OVERSAMPLE_H_
+#define DHT11_OVERSAMPLE_H_
+
+#include "main.h"
+#include "dht11.h"
+#include "dht11_capture.h"
+#include "dht11_pin.h"
+
+/* Set to 1 to read PA1 by DMA-sampling IDR instead of TIM5 capture */
+#define DHT11_USE_OVERSAMPLE (0)
+
+#if DHT11_USE_OVERSAMPLE && !DHT11_USE_CAPTURE
+#error "DHT11_USE_OVERSAMPLE decodes edge periods: set DHT11_USE_CAPTURE to 1"
+#endif
+
+/** Sampling period; 1 us gives the capture path's resolution */
+#define DHT11_OVERSAMPLE_US        (1U)
+
+/** Sampling window after release: response + 40 bits of '1' fits in 5.1 ms */
+#define DHT11_OVERSAMPLE_WINDOW_US (6000U)
+
+#define DHT11_OVERSAMPLE_SAMPLES   (DHT11_OVERSAMPLE_WINDOW_US / DHT11_OVERSAMPLE_US)
+
+/** Shortest run kept; the shortest real segment is the 26 us '0' HIGH */
+#define DHT11_OVERSAMPLE_GLITCH_US (4U)
+
+/** Runs kept after filtering: the frame has 84, the rest is noise */
+#define DHT11_OVERSAMPLE_RUNS      (96U)
+
+#if DHT11_USE_OVERSAMPLE && DHT11_CAPTURE_USE_HW_START
+#error "DHT11_USE_OVERSAMPLE samples on TIM8: set DHT11_CAPTURE_USE_HW_START to 0"
+#endif
+
+#if (DHT11_OVERSAMPLE_SAMPLES % 4U) != 0U
+#error "DHT11_OVERSAMPLE_SAMPLES must be a multiple of 4 (decoded by words)"
+#endif
+
+#if DHT11_USE_OVERSAMPLE
+
+/**
+ * @brief Clocks TIM8 and DMA2 and sets the sampling rate. Call after
+ *        DHT11_Pin_Init().
+ */
+void DHT11_Oversample_Init(void);
+
+/**
+ * @brief Recomputes the TIM8 period after a clock profile change.
+ */
+void DHT11_Oversample_ClockChanged(void);
+
+/**
+ * @brief Drives the data line LOW to begin the start pulse.
+ */
+void DHT11_Oversample_DriveLow(void);
+
+/**
+ * @brief Starts sampling and releases the data line in the same instant.
+ *        Call this at the end of the ≥18 ms LOW start pulse.
+ * @retval DHT11_OK, or DHT11_ERR_BUSY if a window is still being sampled.
+ */
+dht11_status_t DHT11_Oversample_Arm(void);
+
+/**
+ * @brief Reports whether the sampling window has been filled.
+ */
+uint8_t DHT11_Oversample_IsComplete(void);
+
+/**
+ * @brief Stops sampling and drops the window.
+ */
+void DHT11_Oversample_Abort(void);
+
+/**
+ * @brief Filters the sampled window and decodes it into 5 data bytes.
+ * @retval DHT11_OK, DHT11_ERR_NO_RESPONSE, DHT11_ERR_TIMEOUT,
+ *         DHT11_ERR_FRAME or DHT11_ERR_CHECKSUM.
+ */
+dht11_status_t DHT11_Oversample_Decode(uint8_t data[5]);
+
+/**
+ * @brief Blocking transaction through the oversampled decoder.
+ * @param data: Output buffer for the 5 frame bytes.
+ * @retval Transaction status.
+ */
+dht11_status_t DHT11_Oversample_Read(uint8_t data[5]);
+
+/**
+ * @brief Runs outvoted by their neighbours since boot.
+ */
+uint32_t DHT11_Oversample_GetGlitches(void);
+
+#endif /* DHT11_USE_OVERSAMPLE */
+
+#endif /* DHT11_OVERSAMPLE_H_ */
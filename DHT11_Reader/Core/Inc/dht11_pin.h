@@ -0,0 +1,102 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_pin.h
+ * @brief          : Single-register access to the DHT11 data line (PA1).
+ *
+ *                   DHT11_Pin_Init() configures the pin once: open-drain,
+ *                   pull-up, AF2 (TIM5_CH2) preselected in AFR. After that
+ *                   the line is never reconfigured through HAL_GPIO_Init():
+ *                     - drive low / release: one BSRR write
+ *                     - read:                one IDR read
+ *                     - GPIO <-> TIM5 hand-over: one MODER field update
+ *
+ *                   In open-drain mode the released line can be read back
+ *                   through IDR, so no output/input direction switch is
+ *                   needed around the start pulse.
+ *
+ *                   The accessors are generated by DHT11_PIN_DEFINE() from
+ *                   a port and a pin number known at compile time, so the
+ *                   port base, the BSRR/IDR addresses and the pin masks are
+ *                   literals in the code and every accessor stays one load
+ *                   or store, without a pin descriptor to dereference. The
+ *                   same macro binds any other data line, e.g.:
+ *                     DHT11_PIN_DEFINE(Aux_Pin, GPIOB, 7U)
+ *                     Aux_Pin_Low(); ... if (Aux_Pin_Read() != 0U) {...}
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef DHT11_PIN_H_
+#define DHT11_PIN_H_
+
+#include "main.h"
+#include "ramfunc.h"
+
+/** Bit number of DHT_PIN_Pin, used for the 2-bit MODER field */
+#define DHT11_PIN_NUM          (1U)
+
+/** BSRR/IDR mask and MODER fields of pin number num */
+#define DHT11_PIN_MASK(num)        ((uint32_t) 1U << (num))
+#define DHT11_PIN_MODER_MASK(num)  (GPIO_MODER_MODER0 << (2U * (num)))
+#define DHT11_PIN_MODER_OUTPUT(num) (GPIO_MODER_MODER0_0 << (2U * (num)))
+#define DHT11_PIN_MODER_AF(num)    (GPIO_MODER_MODER0_1 << (2U * (num)))
+
+/**
+ * @brief Defines the accessors prefix_Low, _Release, _Read, _ModeGpio and
+ *        _ModeAf of one open-drain data line.
+ * @param port: GPIO port, a constant such as GPIOA.
+ * @param num: Pin number, 0 to 15.
+ */
+#define DHT11_PIN_DEFINE(prefix, port, num)                                  \
+	_Static_assert((num) < 16U, #prefix " pin number must be 0 to 15");   \
+	                                                                       \
+	/** Pulls the data line low. */                                        \
+	RAMFUNC_INLINE void prefix##_Low(void) {                               \
+		(port)->BSRR = DHT11_PIN_MASK(num) << 16U;                         \
+	}                                                                      \
+	                                                                       \
+	/** Releases the data line to the pull-up. */                          \
+	RAMFUNC_INLINE void prefix##_Release(void) {                           \
+		(port)->BSRR = DHT11_PIN_MASK(num);                                \
+	}                                                                      \
+	                                                                       \
+	/** Samples the data line; non-zero when it is high. */                \
+	RAMFUNC_INLINE uint32_t prefix##_Read(void) {                          \
+		return (port)->IDR & DHT11_PIN_MASK(num);                          \
+	}                                                                      \
+	                                                                       \
+	/** Connects the pad to the GPIO output driver (ODR controls it). */   \
+	RAMFUNC_INLINE void prefix##_ModeGpio(void) {                          \
+		(port)->MODER = ((port)->MODER & ~DHT11_PIN_MODER_MASK(num))       \
+				| DHT11_PIN_MODER_OUTPUT(num);                             \
+	}                                                                      \
+	                                                                       \
+	/** Connects the pad to its alternate function selected in AFR. */     \
+	RAMFUNC_INLINE void prefix##_ModeAf(void) {                            \
+		(port)->MODER = ((port)->MODER & ~DHT11_PIN_MODER_MASK(num))       \
+				| DHT11_PIN_MODER_AF(num);                                 \
+	}
+
+_Static_assert(DHT11_PIN_MASK(DHT11_PIN_NUM) == DHT_PIN_Pin,
+		"DHT11_PIN_NUM must match DHT_PIN_Pin");
+
+/**
+ * @brief One-time configuration of the data line. Leaves it released.
+ */
+void DHT11_Pin_Init(void);
+
+/* DHT11_Pin_Low(), _Release(), _Read(), _ModeGpio() and _ModeAf() */
+DHT11_PIN_DEFINE(DHT11_Pin, DHT_PIN_GPIO_Port, DHT11_PIN_NUM)
+
+/**
+ * @brief Connects the pad to TIM5_CH2. The capture input does not drive
+ *        the pad, so the line is released to the pull-up.
+ */
+static inline void DHT11_Pin_ModeCapture(void) {
+	DHT11_Pin_ModeAf();
+}
+
+#endif /* DHT11_PIN_H_ */
@@ -0,0 +1,130 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_prof.h
+ * @brief          : Optional DWT cycle-counter profiling of DHT11
+ *                   transactions.
+ *
+ *                   For each transaction it records:
+ *                     - the duration of every phase (start pulse, response,
+ *                       data bits, checksum);
+ *                     - min/max/mean and a histogram of the bit pulse widths,
+ *                       separately for '0' and '1' bits;
+ *                     - the widths of all 40 bits of the last frame;
+ *                     - one counter per dht11_status_t.
+ *
+ *                   What a width means depends on the path:
+ *                     - Bit-banged (DHT11_USE_CAPTURE = 0): HIGH time.
+ *                     - Capture, EXTI and multi paths: falling-to-falling period
+ *                       (50 us LOW + HIGH). The response is captured by
+ *                       DMA with the bits, so the data phase includes it.
+ *                   Either way the threshold is the classifier's
+ *                   (dht11_classify.h).
+ *
+ *                   The gap between the widest '0' and the narrowest '1' is
+ *                   the decoding margin.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef DHT11_PROF_H_
+#define DHT11_PROF_H_
+
+#include "main.h"
+#include "dht11.h"
+
+/* Set to 1 to collect transaction timing statistics */
+#define DHT11_USE_PROFILE (1)
+
+/** Histogram bin width and count: 0 .. 160 us */
+#define DHT11_PROF_BIN_US   (4U)
+#define DHT11_PROF_BINS     (40U)
+
+/** Number of dht11_status_t values */
+#define DHT11_PROF_STATUSES ((uint32_t) DHT11_ERR_BIT_TIMEOUT + 1U)
+
+/**
+ * @brief Transaction phases, in order.
+ */
+typedef enum {
+	DHT11_PROF_START = 0,   /*!< Start pulse, line LOW until release   */
+	DHT11_PROF_RESPONSE,    /*!< Sensor 80 us LOW + 80 us HIGH         */
+	DHT11_PROF_DATA,        /*!< 40 data bits                          */
+	DHT11_PROF_CHECKSUM,    /*!< Decode and checksum validation        */
+	DHT11_PROF_PHASES
+} dht11_prof_phase_t;
+
+/**
+ * @brief Running min/max/mean of a duration, in microseconds.
+ */
+typedef struct {
+	uint32_t count;
+	uint32_t min_us;
+	uint32_t max_us;
+	uint64_t sum_us;
+} dht11_prof_stat_t;
+
+/**
+ * @brief Everything collected so far.
+ */
+typedef struct {
+	dht11_prof_stat_t phase[DHT11_PROF_PHASES]; /*!< Phase durations          */
+	dht11_prof_stat_t bit[2];                   /*!< '0' and '1' widths       */
+	uint32_t hist[2][DHT11_PROF_BINS];          /*!< Last bin takes overflow  */
+	uint16_t last_width_us[40];                 /*!< Widths of the last frame */
+	uint32_t status[DHT11_PROF_STATUSES];       /*!< Results by status code   */
+} dht11_prof_t;
+
+#if DHT11_USE_PROFILE
+#define DHT11_PROF_BEGIN()          DHT11_Prof_Begin()
+#define DHT11_PROF_MARK(phase)      DHT11_Prof_Mark(phase)
+#define DHT11_PROF_BIT(i, v, w)     DHT11_Prof_Bit((i), (v), (w))
+#define DHT11_PROF_RESULT(status)   DHT11_Prof_Result(status)
+#else
+#define DHT11_PROF_BEGIN()          ((void) 0)
+#define DHT11_PROF_MARK(phase)      ((void) 0)
+#define DHT11_PROF_BIT(i, v, w)     ((void) 0)
+#define DHT11_PROF_RESULT(status)   ((void) 0)
+#endif /* DHT11_USE_PROFILE */
+
+/**
+ * @brief Clears all statistics.
+ */
+void DHT11_Prof_Reset(void);
+
+/**
+ * @brief Latches CYCCNT at the start of a transaction.
+ */
+void DHT11_Prof_Begin(void);
+
+/**
+ * @brief Ends a phase: records the time since the previous mark.
+ */
+void DHT11_Prof_Mark(dht11_prof_phase_t phase);
+
+/**
+ * @brief Records one decoded bit.
+ * @param index: Bit position in the frame, 0..39.
+ * @param value: Decoded value, 0 or 1.
+ * @param width_us: Measured width (see file header).
+ */
+void DHT11_Prof_Bit(uint32_t index, uint32_t value, uint32_t width_us);
+
+/**
+ * @brief Counts the outcome of one attempt.
+ */
+void DHT11_Prof_Result(dht11_status_t status);
+
+/**
+ * @brief Read-only view of the statistics.
+ */
+const dht11_prof_t* DHT11_Prof_Get(void);
+
+/**
+ * @brief Prints the statistics through printf.
+ */
+void DHT11_Prof_Dump(void);
+
+#endif /* DHT11_PROF_H_ */
@@ -0,0 +1,31 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_queue.h
+ * @brief          : Lock-free reading queue (spsc.h) for dht11_reading_t.
+ *
+ *                   Hands completed readings from the context that acquires
+ *                   them (capture/timer interrupt, sensor task) to the one
+ *                   that formats and stores them, without masking
+ *                   interrupts. Functions: DHT11_Queue_Init, _Push, _Pop,
+ *                   _Count and _Free.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef DHT11_QUEUE_H_
+#define DHT11_QUEUE_H_
+
+#include "main.h"
+#include "dht11.h"
+#include "spsc.h"
+
+/** Readings held; power of two. 16 covers 32 s at the 2 s interval, or
+ * two frames of the 8-channel reader */
+#define DHT11_QUEUE_LEN (16U)
+
+SPSC_DEFINE(dht11_queue_t, DHT11_Queue, dht11_reading_t, DHT11_QUEUE_LEN)
+
+#endif /* DHT11_QUEUE_H_ */
@@ -0,0 +1,130 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_sampler.h
+ * @brief          : Per-sensor sampling plan: period, phase and the DHT11
+ *                   minimum re-trigger spacing.
+ *
+ *                   Each sensor has its own period (start pulse to start
+ *                   pulse) and a phase offset from the moment its plan was
+ *                   set. DHT11_Sampler_Next() tells the acquisition loop
+ *                   how long to wait and, once a frame is due, which
+ *                   sensors to start in it:
+ *                     - a sensor is never started sooner than the larger
+ *                       of DHT11_SAMPLER_MIN_PERIOD_MS and its minimum
+ *                       spacing (DHT11_Health_MinSpacingMs(), which
+ *                       includes the sensor type) after its previous start;
+ *                     - frames start at least DHT11_SAMPLER_SLOT_MS apart,
+ *                       the length of the start pulse and the response, so
+ *                       the sampling windows of two frames never overlap;
+ *                     - sensors due within the same slot share one frame
+ *                       (dht11_multi.h samples every line at once), so
+ *                       equal phases give the old parallel read and
+ *                       phases a slot or more apart stagger the sensors.
+ *                   With a shared sync pulse (dht11_sync.h), the starts
+ *                   follow its slots instead of the plan's own anchor.
+ *                   A sensor on a switched supply (dht11_supply.h) is not
+ *                   due before it has warmed up.
+ *                   An on-demand request (dht11_trigger.h) moves a
+ *                   sensor's planned start to now, within the same rules.
+ *                   A sensor that has FAILED (dht11_health.h) follows the
+ *                   slower probe interval, one found absent
+ *                   (dht11_discover.h) the recheck interval; a frame
+ *                   that ran late skips the missed slots instead of
+ *                   bursting to catch up.
+ *
+ *                   Default: every sensor every DHT11_SAMPLER_DEFAULT_PERIOD_MS,
+ *                   phase 0, all in one frame.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef DHT11_SAMPLER_H_
+#define DHT11_SAMPLER_H_
+
+#include "main.h"
+
+/** Sensors planned; matches the 8-channel reader */
+#define DHT11_SAMPLER_SENSORS           (8U)
+
+/** The DHT11 is specified for at most one reading per second */
+#define DHT11_SAMPLER_MIN_PERIOD_MS     (1000U)
+
+/** Longest period accepted; keeps the loop inside WATCHDOG_AGE_SENSOR_MS */
+#define DHT11_SAMPLER_MAX_PERIOD_MS     (30000U)
+
+/** Period applied by DHT11_Sampler_Init() */
+#define DHT11_SAMPLER_DEFAULT_PERIOD_MS (2000U)
+
+/** One frame: 18 ms start pulse, ~5 ms response, margin */
+#define DHT11_SAMPLER_SLOT_MS           (25U)
+
+/**
+ * @brief Plan of one sensor.
+ */
+typedef struct {
+	uint32_t period_ms;  /*!< Start to start, 0: not sampled     */
+	uint32_t phase_ms;   /*!< First start after the plan was set */
+} dht11_sampler_cfg_t;
+
+/**
+ * @brief Applies the default plan to every sensor, anchored now.
+ */
+void DHT11_Sampler_Init(void);
+
+/**
+ * @brief Sets the plan of one sensor, anchored now.
+ * @param period_ms: 0, or from the sensor's minimum spacing to
+ *        DHT11_SAMPLER_MAX_PERIOD_MS.
+ * @param phase_ms: Below period_ms.
+ * @retval 1 if applied, 0 for an invalid sensor or plan.
+ */
+uint8_t DHT11_Sampler_Set(uint8_t sensor_id, uint32_t period_ms,
+		uint32_t phase_ms);
+
+/**
+ * @brief Plan of one sensor; period 0 for unknown sensors.
+ */
+dht11_sampler_cfg_t DHT11_Sampler_Get(uint8_t sensor_id);
+
+/**
+ * @brief Time until the next frame.
+ * @param due: Set to the bit mask of the sensors to start now when the
+ *        return value is 0, to 0 otherwise.
+ * @retval Milliseconds to wait before asking again.
+ */
+uint32_t DHT11_Sampler_Next(uint32_t now_ms, uint32_t *due);
+
+/**
+ * @brief Records a frame started at start_ms for the sensors in due, after
+ *        their health has been reported.
+ */
+void DHT11_Sampler_Done(uint32_t due, uint32_t start_ms);
+
+/**
+ * @brief Brings the planned start of the sensors in mask forward to now
+ *        for an on-demand reading (dht11_trigger.h). Each still waits out
+ *        its minimum spacing after the last start and a supply warm-up;
+ *        its period restarts from the frame this gives. Single-sensor
+ *        loops record their starts with DHT11_Sampler_Done() for it.
+ * @retval Milliseconds until the first of them may start: 0 for now,
+ *         DHT11_SAMPLER_MIN_PERIOD_MS if none of them is sampled.
+ */
+uint32_t DHT11_Sampler_Request(uint32_t mask, uint32_t now_ms);
+
+/**
+ * @brief Next start of a single-sensor loop after a frame begun at
+ *        start_ms: one interval on, or the sensor's sync slot when locked.
+ *        Only meaningful while DHT11_Sampler_IntervalMs() is nonzero.
+ */
+uint32_t DHT11_Sampler_NextStartMs(uint8_t sensor_id, uint32_t start_ms);
+
+/**
+ * @brief Nominal interval of a single-sensor loop: the plan of a sensor, or
+ *        its probe interval while FAILED; 0 if it is not sampled.
+ */
+uint32_t DHT11_Sampler_IntervalMs(uint8_t sensor_id);
+
+#endif /* DHT11_SAMPLER_H_ */
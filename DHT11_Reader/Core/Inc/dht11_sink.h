@@ -0,0 +1,104 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_sink.h
+ * @brief          : Presentation of dht11_reading_t results.
+ *
+ *                   Acquisition (DHT11_Read(), the async and multi-sensor
+ *                   drivers) only fills dht11_reading_t. Where a reading
+ *                   goes is decided here: DHT11_Sink_Emit() updates the
+ *                   status LED (status_led.h) and forwards the reading to
+ *                   the active sink. Consumers that only need the numbers
+ *                   can select a NULL sink and skip formatting entirely.
+ *
+ *                   The TX ring's backpressure (uart_tx.h) steers the
+ *                   sink: while the link backs up only window summaries
+ *                   are sent (when dht11_agg.h windows are on), while it
+ *                   is stalled nothing; history, flash log, latest values,
+ *                   register maps and CAN still get every reading.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef DHT11_SINK_H_
+#define DHT11_SINK_H_
+
+#include "main.h"
+#include "dht11.h"
+#include "dht11_agg.h"
+
+/**
+ * @brief Consumer of completed readings (thread context).
+ */
+typedef void (*dht11_sink_t)(const dht11_reading_t *reading);
+
+/**
+ * @brief Wire formats selectable at runtime.
+ */
+typedef enum {
+	DHT11_FORMAT_TEXT = 0,  /*!< ASCII line via printf            */
+	DHT11_FORMAT_BINARY,    /*!< COBS telemetry frame (telemetry.h) */
+	DHT11_FORMAT_DELTA,     /*!< Keyframes, steps and runs (telemetry.h) */
+	DHT11_FORMAT_NONE,      /*!< Discard, numbers only via the API  */
+	DHT11_FORMAT_BATCH,     /*!< Several readings per frame (telemetry.h);
+	                             after NONE, which keeps its number      */
+	DHT11_FORMAT_SCHEMA     /*!< Schema once, values only (telemetry.h) */
+} dht11_format_t;
+
+/** Sink active after reset: DHT11_Sink_Text, Telemetry_Sink,
+ * Telemetry_DeltaSink, Telemetry_BatchSink, Telemetry_SchemaSink or NULL */
+#define DHT11_SINK_DEFAULT (DHT11_Sink_Text)
+
+/**
+ * @brief Selects the active sink; NULL discards readings. Leaving the
+ *        batch sink sends its pending batch first.
+ */
+void DHT11_Sink_Set(dht11_sink_t sink);
+
+/**
+ * @brief Returns the active sink.
+ */
+dht11_sink_t DHT11_Sink_Get(void);
+
+/**
+ * @brief Selects one of the built-in sinks by wire format.
+ */
+void DHT11_Sink_SetFormat(dht11_format_t format);
+
+/**
+ * @brief Returns the format of the active sink, DHT11_FORMAT_NONE for
+ *        custom or NULL sinks.
+ */
+dht11_format_t DHT11_Sink_GetFormat(void);
+
+/**
+ * @brief Updates the status LED (status_led.h), filters a copy of the reading
+ *        (dht11_filter.h), publishes it (dht11_latest.h), appends it to
+ *        the history (history.h), adds it to the aggregation windows
+ *        (dht11_agg.h) and passes it to the active sink when raw
+ *        readings are on, the emission policy (dht11_emit.h) does not
+ *        suppress it and the TX ring's backpressure allows.
+ *        Matches dht11_async_cb_t, so it can be registered directly.
+ */
+void DHT11_Sink_Emit(const dht11_reading_t *reading);
+
+/**
+ * @brief Human-readable line over printf. Silent on DHT11_ERR_NO_RESPONSE.
+ */
+void DHT11_Sink_Text(const dht11_reading_t *reading);
+
+/**
+ * @brief Sends a window summary in the active sink's format: a text line,
+ *        a 0x09 packet for the binary formats, nothing
+ *        for NULL or custom sinks.
+ */
+void DHT11_Sink_Summary(const dht11_agg_summary_t *summary);
+
+/**
+ * @brief Readings and summaries held back by backpressure since boot.
+ */
+uint32_t DHT11_Sink_GetShed(void);
+
+#endif /* DHT11_SINK_H_ */
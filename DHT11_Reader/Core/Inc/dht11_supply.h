@@ -0,0 +1,147 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_supply.h
+ * @brief          : GPIO-switched sensor supply: power gating between
+ *                   readings and power-cycle recovery of hung sensors.
+ *
+ *                   Each sensor listed in DHT11_SUPPLY_PINS has its VDD on
+ *                   a push-pull output, directly (a DHT11 draws at most
+ *                   2.5 mA) or through a high-side switch. Two uses:
+ *                     - gating: after a reading, a sensor whose next start
+ *                       is more than DHT11_SUPPLY_WARMUP_MS +
+ *                       DHT11_SUPPLY_GATE_MIN_MS away is switched off,
+ *                       and back on DHT11_SUPPLY_WARMUP_MS (plus one poll
+ *                       and one slot) before that start;
+ *                     - recovery: after DHT11_SUPPLY_RESET_FAILURES failed
+ *                       readings in a row (dht11_health.h), and again after
+ *                       each further run of that many, the sensor is held
+ *                       off for DHT11_SUPPLY_OFF_MS and powered up again.
+ *                       A sensor latched up after a brownout answers no
+ *                       retry, only this.
+ *                   While a sensor is off its data line is held LOW, so the
+ *                   pull-up cannot feed it through the pin and the reset is
+ *                   a real one.
+ *
+ *                   A sensor is not read before its warm-up has passed:
+ *                   the sampling plan (dht11_sampler.h) and the single-line
+ *                   loops wait for DHT11_Supply_ReadyInMs().
+ *                   DHT11_Supply_Poll() does the switching on: call it from
+ *                   a scheduler task (bare metal) or the service task
+ *                   (RTOS). DHT11_Health_Report() hands it every final
+ *                   status.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef DHT11_SUPPLY_H_
+#define DHT11_SUPPLY_H_
+
+#include "main.h"
+#include "dht11.h"
+
+/* Set to 1 to switch the sensors' supply from GPIO outputs */
+#define DHT11_USE_SUPPLY (0)
+
+/**
+ * Supply output of each switched sensor, as X(sensor, port, pin). Sensor 0
+ * is the PA1 sensor or multi channel 0; add e.g. X(1, GPIOB, 5U) for the
+ * other multi channels.
+ */
+#define DHT11_SUPPLY_PINS(X) \
+	X(0, GPIOB, 4U)
+
+/* Set to 1 if a low output powers the sensor (P-channel switch) */
+#define DHT11_SUPPLY_ACTIVE_LOW (0)
+
+/** Power-up to first start pulse; the datasheet asks for 1 s */
+#define DHT11_SUPPLY_WARMUP_MS      (DHT11_POWERUP_MS)
+
+/** Shortest off period worth a gate; shorter gaps stay powered */
+#define DHT11_SUPPLY_GATE_MIN_MS    (200U)
+
+/** Off time of a power cycle, long enough to drain the supply capacitor */
+#define DHT11_SUPPLY_OFF_MS         (500U)
+
+/** Failed readings in a row before a power cycle */
+#define DHT11_SUPPLY_RESET_FAILURES (3U)
+
+/** Longest sleep of DHT11_Supply_Poll()'s caller, covered by the lead */
+#define DHT11_SUPPLY_POLL_MS        (50U)
+
+/**
+ * @brief Supply state of one sensor.
+ */
+typedef enum {
+	DHT11_SUPPLY_UNSWITCHED = 0, /*!< Not in DHT11_SUPPLY_PINS: always on */
+	DHT11_SUPPLY_ON,             /*!< Powered, warm once ready            */
+	DHT11_SUPPLY_GATED,          /*!< Off until its next reading nears    */
+	DHT11_SUPPLY_CYCLING         /*!< Off for a power-cycle reset         */
+} dht11_supply_state_t;
+
+/**
+ * @brief Supply view of one sensor.
+ */
+typedef struct {
+	dht11_supply_state_t state;
+	uint8_t gating;          /*!< Switched off between readings        */
+	uint32_t ready_in_ms;    /*!< Until it may be read, 0 when warm    */
+	uint32_t cycles;         /*!< Power cycles since boot              */
+	uint32_t off_ms;         /*!< Time spent unpowered since boot      */
+} dht11_supply_info_t;
+
+#if DHT11_USE_SUPPLY
+
+/**
+ * @brief Configures the supply outputs and powers every sensor, gating
+ *        on. The boot warm-up is DHT11_POWERUP_MS, as without switching.
+ */
+void DHT11_Supply_Init(void);
+
+/**
+ * @brief Switches sensors on whose reading or reset is due.
+ * @retval Milliseconds until the next switch, at most DHT11_SUPPLY_POLL_MS.
+ */
+uint32_t DHT11_Supply_Poll(void);
+
+/**
+ * @brief Gating or power cycle after a reading; called from
+ *        DHT11_Health_Report() with the final status.
+ */
+void DHT11_Supply_Report(uint32_t sensor, dht11_status_t status);
+
+/**
+ * @brief Time until a sensor has power and has warmed up; 0 for an
+ *        unswitched sensor.
+ */
+uint32_t DHT11_Supply_ReadyInMs(uint32_t sensor);
+
+/**
+ * @brief Enables or disables gating of one sensor; disabling powers it.
+ * @retval 0 for a sensor without a supply output.
+ */
+uint8_t DHT11_Supply_SetGating(uint32_t sensor, uint8_t gating);
+
+/**
+ * @brief Starts a power cycle of one sensor now.
+ * @retval 0 for a sensor without a supply output.
+ */
+uint8_t DHT11_Supply_Cycle(uint32_t sensor);
+
+/**
+ * @brief Supply state and counters of one sensor.
+ */
+dht11_supply_info_t DHT11_Supply_GetInfo(uint32_t sensor);
+
+/**
+ * @brief Short printable name of a supply state.
+ */
+const char* DHT11_Supply_Name(dht11_supply_state_t state);
+
+#else
+#define DHT11_Supply_ReadyInMs(sensor) (0U)
+#endif /* DHT11_USE_SUPPLY */
+
+#endif /* DHT11_SUPPLY_H_ */
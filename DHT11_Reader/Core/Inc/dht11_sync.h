@@ -0,0 +1,164 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_sync.h
+ * @brief          : Cross-board sampling lock to a shared sync pulse.
+ *
+ *                   Boards in one room each sample on their own clock, so
+ *                   their readings drift apart by the crystal tolerance and
+ *                   by when each one booted. With a common pulse wired to
+ *                   every board's PA0 (rising edge, any 3.3 V source: one
+ *                   board's GPIO, a function generator, a host's DTR), each
+ *                   board starts its readings at
+ *
+ *                     pulse + node offset + sensor phase + k * period
+ *
+ *                   and readings of the same instant line up without host
+ *                   interpolation. The node offset staggers boards sharing
+ *                   a telemetry bus (CAN, RS-485); the sensor phase is the
+ *                   sampling plan's (dht11_sampler.h).
+ *
+ *                   The EXTI0 handler stamps each pulse on the TIM5
+ *                   microsecond count (systime.h) and on the HAL tick. The
+ *                   schedulers ask for the slot when they plan a reading:
+ *                     - the async driver (dht11_async.h) re-arms its TIM5
+ *                       deadline on the slot, to the microsecond;
+ *                     - the sampling plan (multi-sensor and single-sensor
+ *                       loops, bare-metal or RTOS) plans its next start on
+ *                       it, to the millisecond.
+ *                   Every pulse re-anchors the slots, so the boards track
+ *                   the pulse rather than each other's drift; the reading
+ *                   after the first pulse is already locked. A slot is
+ *                   never sooner than the sensor's minimum spacing after
+ *                   its last start, so a pulse landing next to a reading
+ *                   does not repeat it.
+ *
+ *                   The pulse interval must be a multiple of the sampling
+ *                   periods (equal to them, typically: 0.5 Hz for the 2 s
+ *                   default). A pulse sooner than DHT11_SYNC_MIN_PULSE_MS
+ *                   after the last one is rejected as a glitch; after
+ *                   DHT11_SYNC_HOLDOVER_MS without one the lock drops and
+ *                   sampling free-runs on its own period again. Until then
+ *                   missed pulses cost nothing but crystal drift.
+ *
+ *                   A pulse that wakes the MCU from STOP would be stamped
+ *                   on the frozen counts; Power_Stop() has it stamped once
+ *                   they have been stepped on, late by the STOP wake-up
+ *                   and clock restore time.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef DHT11_SYNC_H_
+#define DHT11_SYNC_H_
+
+#include "main.h"
+
+/* Set to 1 to lock sampling to the sync pulse on PA0 */
+#define DHT11_USE_SYNC (0)
+
+/** Sync input: PA0 on EXTI line 0, rising edge, pulled down */
+#define DHT11_SYNC_GPIO_Port          (GPIOA)
+#define DHT11_SYNC_PIN_NUM            (0U)
+
+/** Pulses closer than this to the previous one are glitches */
+#define DHT11_SYNC_MIN_PULSE_MS       (500U)
+
+/** Lock kept this long after the last pulse */
+#define DHT11_SYNC_HOLDOVER_MS        (60000U)
+
+/** Node offset after DHT11_Sync_Init() */
+#define DHT11_SYNC_DEFAULT_OFFSET_MS  (0U)
+
+/** Longest node offset; slots repeat every period anyway */
+#define DHT11_SYNC_MAX_OFFSET_MS      (30000U)
+
+/**
+ * @brief Lock state for the CLI.
+ */
+typedef struct {
+	uint32_t pulses;        /*!< Accepted since boot                 */
+	uint32_t rejected;      /*!< Glitches                            */
+	uint32_t interval_us;   /*!< Between the last two pulses         */
+	uint32_t jitter_us;     /*!< Largest interval change seen        */
+	uint32_t age_ms;        /*!< Since the last pulse                */
+	uint8_t locked;
+} dht11_sync_stats_t;
+
+#if DHT11_USE_SYNC
+#define DHT11_SYNC_SLOT_MS(after, period, phase, slot) \
+	DHT11_Sync_SlotMs((after), (period), (phase), (slot))
+#define DHT11_SYNC_SLOT_US(after, period, slot) \
+	DHT11_Sync_SlotUs((after), (period), (slot))
+#else
+#define DHT11_SYNC_SLOT_MS(after, period, phase, slot) (0U)
+#define DHT11_SYNC_SLOT_US(after, period, slot)        (0U)
+#endif /* DHT11_USE_SYNC */
+
+/**
+ * @brief Configures PA0 and EXTI0 and clears the lock. Call after
+ *        SysTime_Init().
+ */
+void DHT11_Sync_Init(void);
+
+/**
+ * @brief Sets the node offset from the pulse.
+ * @retval 1 if applied, 0 above DHT11_SYNC_MAX_OFFSET_MS.
+ */
+uint8_t DHT11_Sync_SetOffset(uint32_t offset_ms);
+
+/**
+ * @brief Node offset from the pulse in milliseconds.
+ */
+uint32_t DHT11_Sync_GetOffset(void);
+
+/**
+ * @brief Reports whether a pulse arrived within DHT11_SYNC_HOLDOVER_MS.
+ */
+uint8_t DHT11_Sync_IsLocked(void);
+
+/**
+ * @brief First locked slot at or after a HAL tick.
+ * @param after_ms: Earliest acceptable start.
+ * @param period_ms: Sampling period, nonzero.
+ * @param phase_ms: Sensor phase added to the node offset.
+ * @param slot_ms: Set to the slot when locked, untouched otherwise.
+ * @retval 1 if locked.
+ */
+uint8_t DHT11_Sync_SlotMs(uint32_t after_ms, uint32_t period_ms,
+		uint32_t phase_ms, uint32_t *slot_ms);
+
+/**
+ * @brief First locked slot at or after a TIM5 count (SysTime_Now()).
+ * @param after_us: Earliest acceptable start.
+ * @param period_us: Sampling period, nonzero.
+ * @param slot_us: Set to the slot when locked, untouched otherwise.
+ * @retval 1 if locked.
+ */
+uint8_t DHT11_Sync_SlotUs(uint32_t after_us, uint32_t period_us,
+		uint32_t *slot_us);
+
+/**
+ * @brief Fills the lock state.
+ */
+void DHT11_Sync_GetStats(dht11_sync_stats_t *stats);
+
+/**
+ * @brief Holds pulse stamps back; Power_Stop() calls it before STOP.
+ */
+void DHT11_Sync_StopBegin(void);
+
+/**
+ * @brief Stamps a pulse that arrived during STOP; Power_Stop() calls it
+ *        once TIM5 and the HAL tick have been stepped over the stop.
+ */
+void DHT11_Sync_StopEnd(void);
+
+/**
+ * @brief EXTI line 0 handler; called from EXTI0_IRQHandler().
+ */
+void DHT11_Sync_IRQHandler(void);
+
+#endif /* DHT11_SYNC_H_ */
@@ -0,0 +1,182 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_trace.h
+ * @brief          : Raw frame recorder: the edge times of every frame, or
+ *                   of the failed ones only, kept in a RAM ring and
+ *                   streamed out in bulk on request.
+ *
+ *                   A status code says a frame failed, not why. The
+ *                   recorder keeps what each acquisition path measured
+ *                   before it was decoded:
+ *                     - capture: the TIM5 edge timestamps; while recording,
+ *                       both edges are captured (as with a glitch guard),
+ *                       so LOW and HIGH times are both known. Frames that
+ *                       time out are kept with the edges they got;
+ *                     - multi: every level change of the channel in the
+ *                       sampled IDR words, before its guard, which is the
+ *                       whole content of the buffer for that channel at
+ *                       DHT11_MULTI_SAMPLE_US resolution;
+ *                     - oversample: the run boundaries after the majority
+ *                       vote;
+ *                     - EXTI: the falling edges (CYCCNT, from the first).
+ *                   Times are microseconds from the start-pulse release
+ *                   (TELEMETRY_TRACE_RELEASE) or from the first edge, 16
+ *                   bits each; a frame has at most DHT11_TRACE_EDGES of
+ *                   them. When the ring is full the oldest record goes.
+ *
+ *                   "trace dump" sends the records as 0x0A telemetry
+ *                   packets (Docs/telemetry.md), oldest first, through the
+ *                   TX ring; when the USB CDC port is open it takes over
+ *                   for the dump, ~100x the USART2 rate at 115200 baud.
+ *                   tlm_cat -t writes each one as a host simulator trace
+ *                   file (Docs/host_sim.md), so a field failure can be
+ *                   replayed against the decoder on the bench.
+ *
+ *                   Recording runs in the decoders' thread context, one
+ *                   frame at a time, like the classifier updates.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef DHT11_TRACE_H_
+#define DHT11_TRACE_H_
+
+#include "main.h"
+#include "dht11.h"
+#include "telemetry_frames.h"
+
+/* Set to 1 to build the raw frame recorder */
+#define DHT11_USE_TRACE (1)
+
+/** Records in the ring (212 bytes each), must be a power of two */
+#define DHT11_TRACE_RECORDS  (16U)
+
+/** Edges per record: a guarded capture frame */
+#define DHT11_TRACE_EDGES    (TELEMETRY_TRACE_MAX)
+
+#if (DHT11_TRACE_RECORDS & (DHT11_TRACE_RECORDS - 1U)) != 0U
+#error "DHT11_TRACE_RECORDS must be a power of two"
+#endif
+
+/** Record flags, as sent */
+#define DHT11_TRACE_BOTH     (TELEMETRY_TRACE_BOTH)
+#define DHT11_TRACE_RELEASE  (TELEMETRY_TRACE_RELEASE)
+#define DHT11_TRACE_CUT      (TELEMETRY_TRACE_CUT)
+
+/**
+ * @brief Which frames are recorded.
+ */
+typedef enum {
+	DHT11_TRACE_OFF = 0,
+	DHT11_TRACE_FAILED,     /*!< Any status but DHT11_OK */
+	DHT11_TRACE_ALL,
+	DHT11_TRACE_MODES
+} dht11_trace_mode_t;
+
+/** Mode after DHT11_Trace_Init() */
+#define DHT11_TRACE_DEFAULT_MODE (DHT11_TRACE_OFF)
+
+/**
+ * @brief One recorded frame.
+ */
+typedef struct {
+	uint32_t timestamp_ms;
+	uint16_t seq;
+	uint8_t sensor_id;
+	uint8_t status;                    /*!< dht11_status_t     */
+	uint8_t flags;                     /*!< DHT11_TRACE_*      */
+	uint8_t n;                         /*!< Edges kept         */
+	uint16_t t_us[DHT11_TRACE_EDGES];
+} dht11_trace_rec_t;
+
+#if DHT11_USE_TRACE
+#define DHT11_TRACE_BEGIN(s, f)  DHT11_Trace_Begin((s), (f))
+#define DHT11_TRACE_EDGE(t)      DHT11_Trace_Edge(t)
+#define DHT11_TRACE_END(status)  DHT11_Trace_End(status)
+#define DHT11_TRACE_BOTH_EDGES() DHT11_Trace_IsOn()
+#else
+#define DHT11_TRACE_BEGIN(s, f)  (0U)
+#define DHT11_TRACE_EDGE(t)      ((void) 0)
+#define DHT11_TRACE_END(status)  ((void) 0)
+#define DHT11_TRACE_BOTH_EDGES() (0U)
+#endif /* DHT11_USE_TRACE */
+
+/**
+ * @brief Empties the ring and applies DHT11_TRACE_DEFAULT_MODE.
+ */
+void DHT11_Trace_Init(void);
+
+/**
+ * @brief Selects which frames are recorded; the next frame uses it.
+ */
+void DHT11_Trace_SetMode(dht11_trace_mode_t mode);
+
+/**
+ * @brief Active mode.
+ */
+dht11_trace_mode_t DHT11_Trace_GetMode(void);
+
+/**
+ * @brief Reports whether frames are being recorded.
+ */
+uint8_t DHT11_Trace_IsOn(void);
+
+/**
+ * @brief Opens the scratch record for one frame.
+ * @param sensor: Sensor index.
+ * @param flags: DHT11_TRACE_BOTH and DHT11_TRACE_RELEASE as they apply.
+ * @retval 1 if recording; 0 if off, and DHT11_Trace_Edge() ignores edges.
+ */
+uint8_t DHT11_Trace_Begin(uint8_t sensor, uint8_t flags);
+
+/**
+ * @brief Adds one edge time to the open record; past DHT11_TRACE_EDGES
+ *        the record is marked DHT11_TRACE_CUT.
+ * @param t_us: Microseconds from the origin the flags name; saturates at
+ *        65535.
+ */
+void DHT11_Trace_Edge(uint32_t t_us);
+
+/**
+ * @brief Closes the open record: copies it into the ring if the mode takes
+ *        this status, otherwise drops it.
+ */
+void DHT11_Trace_End(dht11_status_t status);
+
+/**
+ * @brief Records waiting in the ring.
+ */
+uint32_t DHT11_Trace_Count(void);
+
+/**
+ * @brief Frames recorded since boot.
+ */
+uint32_t DHT11_Trace_GetRecorded(void);
+
+/**
+ * @brief Records lost because the ring was full.
+ */
+uint32_t DHT11_Trace_GetOverwritten(void);
+
+/**
+ * @brief Sends up to max_records of the oldest records as 0x0A packets
+ *        through the TX ring, removing each once queued.
+ * @retval Records sent; fewer when the ring had no room, flush and call
+ *         again.
+ */
+uint32_t DHT11_Trace_Drain(uint32_t max_records);
+
+/**
+ * @brief Drops every waiting record.
+ */
+void DHT11_Trace_Clear(void);
+
+/**
+ * @brief Short printable name of a mode.
+ */
+const char* DHT11_Trace_ModeName(dht11_trace_mode_t mode);
+
+#endif /* DHT11_TRACE_H_ */
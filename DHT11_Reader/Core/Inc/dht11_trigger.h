@@ -0,0 +1,95 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_trigger.h
+ * @brief          : On-demand readings from the user button B1 or a command.
+ *
+ *                   A press of B1 (PC13, EXTI13, falling edge) or the CLI
+ *                   "read" command asks for a reading now instead of at the
+ *                   next period. The request only raises a flag; the
+ *                   acquisition loop takes it in thread context and brings
+ *                   the next start forward to the earliest the sensor's
+ *                   minimum spacing (dht11_health.h) allows after its last
+ *                   start, ahead of the periodic one:
+ *                     - the async driver (dht11_async.h) re-arms its TIM5
+ *                       refresh deadline (DHT11_Async_Trigger());
+ *                     - the multi-sensor and blocking loops, bare-metal or
+ *                       RTOS, have the sampling plan start every planned
+ *                       sensor at once (DHT11_Sampler_Request()) and wake
+ *                       the acquisition task.
+ *                   The reading goes through the normal sinks and the
+ *                   periodic cadence restarts from it. A request made
+ *                   while a transaction is under way is served by that
+ *                   transaction; requests made while the sensor powers up
+ *                   (DHT11_PowerUpRemainingMs()) wait for it.
+ *
+ *                   B1 has an external pull-up and an RC filter; a host can
+ *                   trigger the same way with an open-drain output on
+ *                   CN7 pin 23. Edges closer than DHT11_TRIGGER_DEBOUNCE_MS
+ *                   to the last accepted press are counted as bounce. The
+ *                   edge also wakes the MCU from STOP (power.h).
+ *
+ *                   EXTI15_10 is shared with the DHT11 emulator's start
+ *                   detector (dht11_emu.h); with the emulator built, the
+ *                   handler runs at its IRQ_PRIO_CAPTURE level.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef DHT11_TRIGGER_H_
+#define DHT11_TRIGGER_H_
+
+#include "main.h"
+
+/* Set to 0 to leave B1 unused and build no on-demand readings */
+#define DHT11_USE_TRIGGER (1)
+
+/** Trigger input: B1 on PC13, EXTI line 13, active low */
+#define DHT11_TRIGGER_GPIO_Port    (B1_GPIO_Port)
+#define DHT11_TRIGGER_PIN_NUM      (13U)
+
+/** Presses closer than this to the last one are contact bounce */
+#define DHT11_TRIGGER_DEBOUNCE_MS  (50U)
+
+/**
+ * @brief Trigger counters for the CLI.
+ */
+typedef struct {
+	uint32_t presses;   /*!< B1 presses accepted     */
+	uint32_t bounces;   /*!< Edges rejected as bounce */
+	uint32_t commands;  /*!< DHT11_Trigger_Request()  */
+	uint32_t served;    /*!< Requests taken by the loop */
+} dht11_trigger_stats_t;
+
+/**
+ * @brief Configures PC13 and EXTI13. Call after MX_GPIO_Init() and, when
+ *        built, DHT11_Emu_Init().
+ */
+void DHT11_Trigger_Init(void);
+
+/**
+ * @brief Asks for an on-demand reading, as a B1 press does. Thread
+ *        context.
+ */
+void DHT11_Trigger_Request(void);
+
+/**
+ * @brief Takes the pending requests, however many arrived since the last
+ *        call. Thread context.
+ * @retval 1 if a reading was requested.
+ */
+uint8_t DHT11_Trigger_Take(void);
+
+/**
+ * @brief Fills the trigger counters.
+ */
+void DHT11_Trigger_GetStats(dht11_trigger_stats_t *stats);
+
+/**
+ * @brief EXTI line 13 handler; called from EXTI15_10_IRQHandler().
+ */
+void DHT11_Trigger_IRQHandler(void);
+
+#endif /* DHT11_TRIGGER_H_ */
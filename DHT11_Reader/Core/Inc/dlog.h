@@ -0,0 +1,96 @@
+/**
+ ******************************************************************************
+ * @file           : dlog.h
+ * @brief          : Deferred binary logging backend for the DEBUG_* macros.
+ *
+ *                   A call site only stores the address of its format
+ *                   string, a microsecond timestamp (SysTime_Now(), the
+ *                   clock capture edges are stamped on) and up to
+ *                   DLOG_MAX_ARGS raw 32-bit arguments into a RAM ring.
+ *                   Formatting is deferred to DLog_Process(), called from
+ *                   the idle loop, or done on the host from
+ *                   DLog_DumpBinary() output using the format strings in
+ *                   the ELF ".rodata.dlog" section.
+ *
+ *                   Recording is lock-free (LDREX/STREX slot reservation)
+ *                   and safe from interrupt context.
+ *
+ *                   Restrictions of deferred formatting:
+ *                     - arguments must be 32-bit (int, unsigned, pointer);
+ *                       float and 64-bit values are not supported
+ *                     - %s arguments must point to static storage
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef DLOG_H_
+#define DLOG_H_
+
+#include "main.h"
+
+/** Number of records in the ring, must be a power of two */
+#define DLOG_RING_ENTRIES (32U)
+
+/** Maximum number of arguments per call site */
+#define DLOG_MAX_ARGS     (6U)
+
+#if (DLOG_RING_ENTRIES & (DLOG_RING_ENTRIES - 1U)) != 0U
+#error "DLOG_RING_ENTRIES must be a power of two"
+#endif
+
+/**
+ * @brief Log levels, matching the DEBUG_* macros in my_debug.h
+ */
+typedef enum {
+	DLOG_LEVEL_INFO = 0,
+	DLOG_LEVEL_WARN,
+	DLOG_LEVEL_ERROR,
+	DLOG_LEVEL_DEBUG
+} dlog_level_t;
+
+/* Argument counter: DLOG_NARGS(a, b, c) -> 3, DLOG_NARGS() -> 0 */
+#define DLOG_NARGS(...) DLOG_NARGS_(0, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define DLOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, N, ...) N
+
+/**
+ * @brief Records one deferred log entry. The format string is placed in
+ *        ".rodata.dlog" so its address doubles as a stable message ID.
+ */
+#define DLOG_RECORD(level, fmt, ...)                                        \
+	do {                                                                    \
+		static const char dlog_fmt_[] __attribute__((section(".rodata.dlog"))) = fmt; \
+		DLog_Write((level), dlog_fmt_, DLOG_NARGS(__VA_ARGS__), ##__VA_ARGS__); \
+	} while (0)
+
+/**
+ * @brief Stores one record. Use DLOG_RECORD() rather than calling directly.
+ * @param level: Log level.
+ * @param fmt: printf-style format string with static storage.
+ * @param nargs: Number of variadic 32-bit arguments that follow.
+ */
+void DLog_Write(dlog_level_t level, const char *fmt, uint32_t nargs, ...);
+
+/**
+ * @brief Formats up to max_records pending records through printf.
+ *        Call from idle time only.
+ * @retval Number of records processed.
+ */
+uint32_t DLog_Process(uint32_t max_records);
+
+/**
+ * @brief Sends pending records unformatted over the TX ring for host-side
+ *        decoding. Each record is: fmt address, timestamp, level, nargs,
+ *        then nargs 32-bit arguments, all little-endian.
+ * @retval Number of records sent.
+ */
+uint32_t DLog_DumpBinary(uint32_t max_records);
+
+/**
+ * @brief Number of records lost because the ring was full.
+ */
+uint32_t DLog_GetDropped(void);
+
+#endif /* DLOG_H_ */
@@ -0,0 +1,96 @@
+/**
+ ******************************************************************************
+ * @file           : dvfs.h
+ * @brief          : Clock scaling around the scheduler's bursts of work.
+ *
+ *                   With DVFS_USE_SCALING, Sched_Idle() drops the core to
+ *                   DVFS_IDLE_PROFILE (16 MHz HSI, scale 3, no PLL) before
+ *                   an idle period of at least DVFS_IDLE_MIN_US, and wakes
+ *                   DVFS_RAMP_US early so that the due timer tasks (reads,
+ *                   decode, telemetry) run at the burst profile again,
+ *                   CLOCK_DEFAULT_PROFILE unless "clock" picks another.
+ *                   Poll tasks woken by an interrupt (command line, RX
+ *                   rings) run at whichever profile is active.
+ *
+ *                   Each transition goes through Clock_SetProfile(), so
+ *                   Clock_ProfileChangedCallback() re-derives the USART2
+ *                   divisor, the timer prescalers and the cycles-per-us of
+ *                   Timebase_DelayUs(). A transition is skipped, and the
+ *                   work runs at the current profile, while one of them
+ *                   would be cut: output still draining or a baud change
+ *                   pending, a DHT11 transaction or multi-sensor frame in
+ *                   flight, CAN, I2C or Modbus started, the emulator built
+ *                   in. The idle profile has no 48 MHz, so the clock is not
+ *                   lowered while USB is started.
+ *
+ *                   STOP periods (power.h) restore whichever profile was
+ *                   active when they began.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef DVFS_H_
+#define DVFS_H_
+
+#include "main.h"
+#include "clock_config.h"
+
+/* Set to 1 to idle at DVFS_IDLE_PROFILE and run timer tasks at full speed */
+#define DVFS_USE_SCALING (0)
+
+/** Profile held while the scheduler sleeps */
+#define DVFS_IDLE_PROFILE (CLOCK_PROFILE_LOW_POWER)
+
+/** Ramp back this early: HSE start, PLL lock and over-drive */
+#define DVFS_RAMP_US      (1500U)
+
+/** Shortest idle period worth a drop and a ramp */
+#define DVFS_IDLE_MIN_US  (4000U)
+
+/**
+ * @brief Transition counters.
+ */
+typedef struct {
+	uint32_t drops;        /*!< Switches to the idle profile        */
+	uint32_t ramps;        /*!< Switches back to the burst profile  */
+	uint32_t skipped;      /*!< Transitions held off by a veto      */
+	uint32_t idle_ms;      /*!< Time spent at the idle profile      */
+} dvfs_stats_t;
+
+#if DVFS_USE_SCALING
+
+/**
+ * @brief Takes the active profile as the burst profile.
+ */
+void Dvfs_Init(void);
+
+/**
+ * @brief Lowers the clock for an idle period. Call before sleeping.
+ * @param budget_us: Time until the next deadline.
+ * @retval The budget to sleep: shortened by DVFS_RAMP_US at the idle
+ *         profile, 0 after ramping up because the deadline is near.
+ */
+uint32_t Dvfs_Idle(uint32_t budget_us);
+
+/**
+ * @brief Returns to the burst profile. Call before running due work.
+ */
+void Dvfs_Burst(void);
+
+/**
+ * @brief Sets the profile used for bursts and switches to it now.
+ * @retval HAL status of the switch.
+ */
+HAL_StatusTypeDef Dvfs_SetBurstProfile(clock_profile_t profile);
+
+/**
+ * @brief Copies the counters.
+ */
+void Dvfs_GetStats(dvfs_stats_t *stats);
+
+#endif /* DVFS_USE_SCALING */
+
+#endif /* DVFS_H_ */
@@ -0,0 +1,199 @@
+/**
+ ******************************************************************************
+ * @file           : flashlog.h
+ * @brief          : Wear-levelled reading log in the upper flash sectors.
+ *
+ *                   Sectors 6 and 7 (2 x 128 KB at 0x08040000) are kept
+ *                   out of the FLASH region in the linker scripts and used
+ *                   as an append-only log of 32-bit words. One sector is
+ *                   active; when it fills, the other is erased and becomes
+ *                   active with a higher generation, so the log always
+ *                   holds the last one to two sectors and both wear evenly.
+ *
+ *                   With FLASHLOG_USE_BLOCKS, each sensor's readings are
+ *                   gathered in RAM, FLASHLOG_BLOCK_SAMPLES at a time,
+ *                   and written as one bit-packed block: a three-word
+ *                   header with the first reading, its time and the
+ *                   interval, then every later reading as the change of
+ *                   the interval, the humidity step and the temperature
+ *                   step, each zigzag-coded in the narrowest width that
+ *                   holds the block's largest one. Steps of whole units,
+ *                   as a DHT11 reports, are stored in units. A reading
+ *                   costs about 1.2 bytes while the values move, against
+ *                   2 in the word format below (5 days at a 2 s interval
+ *                   instead of 3); steady stretches cost about the same
+ *                   in both.
+ *
+ *                   Without it, readings go through the dht11_delta.h
+ *                   stage. Changed readings are delta-encoded against the
+ *                   previous one, two to a word write, so a reading costs
+ *                   2 bytes of flash in steady state: at least 3 days at a
+ *                   2 s interval, weeks at slower ones. Up to
+ *                   FLASHLOG_RUN_HOLD unchanged readings at the same
+ *                   interval collapse into one run word. A keyframe
+ *                   restarts a sensor after each boot, sector change or
+ *                   out-of-range step, and every 1024 readings.
+ *
+ *                   Both formats can share a log; the decoder reads both.
+ *                   Times come from the RTC calendar in whole seconds, UTC
+ *                   once the host synced it (wallclock.h).
+ *
+ *                   When a sector fills, a seal marker closes it: the low 24
+ *                   bits of the CRC-32 (crc.h, CPU-fed) of every word
+ *                   before it. FlashLog_Init() checks the older sector
+ *                   against its seal while the boot goes on, DMA-fed,
+ *                   and FlashLog_GetSeal() reports the result; a sector
+ *                   without a seal (written by older firmware) is not
+ *                   checked.
+ *
+ *                   Data words always have bit 31 clear, so the head is the
+ *                   first erased (0xFFFFFFFF) word, found by binary search
+ *                   at boot. The open block of each sensor, or its odd
+ *                   pending reading and current run, are held in RAM; a
+ *                   reset loses them.
+ *
+ *                   FlashLog_StartDump() streams the log, oldest word first,
+ *                   as COBS frames (telemetry packet type 0x03) from
+ *                   FlashLog_Poll(). Word format and decoder: Docs/flashlog.md.
+ *
+ *                   FlashLog_StartRange() streams only the part of the log
+ *                   that can hold readings of a time window. A RAM index
+ *                   keeps, for every FLASHLOG_INDEX_SPAN words of each
+ *                   sector, the first record starting there and the time
+ *                   range of the records that do. It is built at boot by
+ *                   decoding both sectors (a few ms) and kept up to date
+ *                   as words are written. The span to start from is found
+ *                   by binary search on the latest reading time up to each
+ *                   span, which never decreases; the dump stops after the
+ *                   last span with a reading in the window. Output starts
+ *                   on a block, so the host decoder needs no change. The
+ *                   word format's pair codes depend on the records before
+ *                   them; without blocks the stream starts at the header
+ *                   of the sector holding the first span.
+ *
+ *                   Erasing a 128 KB sector stalls the CPU, interrupts
+ *                   included, for 1-2 s. That happens once per sector fill,
+ *                   from the sink, between acquisitions.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef FLASHLOG_H_
+#define FLASHLOG_H_
+
+#include "main.h"
+#include "dht11.h"
+
+/** Log sectors; must match the FLASHLOG region of the linker scripts */
+#define FLASHLOG_BASE          (0x08040000U)
+#define FLASHLOG_FIRST_SECTOR  (6U)       /*!< FLASH_SECTOR_6             */
+#define FLASHLOG_SECTORS       (2U)
+#define FLASHLOG_SECTOR_SIZE   (0x20000U) /*!< 128 KB                     */
+
+/** Sensors the word format can address (3-bit id) */
+#define FLASHLOG_SENSORS       (8U)
+
+/** Words per dump frame */
+#define FLASHLOG_CHUNK_WORDS   (32U)
+
+/** Unchanged readings held in RAM before a run word is written */
+#define FLASHLOG_RUN_HOLD      (64U)
+
+/** Words per index span; 12 bytes of RAM per span, 3 KB for 256 words */
+#define FLASHLOG_INDEX_SPAN    (256U)
+
+/* Set to 1 to log readings in bit-packed blocks */
+#define FLASHLOG_USE_BLOCKS    (1)
+
+/** Readings per block, 2..64; 6 bytes of RAM each per sensor */
+#define FLASHLOG_BLOCK_SAMPLES (64U)
+
+#if (FLASHLOG_BLOCK_SAMPLES < 2U) || (FLASHLOG_BLOCK_SAMPLES > 64U)
+#error "FLASHLOG_BLOCK_SAMPLES must be 2..64"
+#endif
+
+/**
+ * @brief Check of the older sector against its seal.
+ */
+typedef enum {
+	FLASHLOG_SEAL_NONE = 0,  /*!< No older sector, or it has no seal */
+	FLASHLOG_SEAL_CHECKING,  /*!< CRC still running                  */
+	FLASHLOG_SEAL_OK,
+	FLASHLOG_SEAL_BAD        /*!< Words changed since sealing        */
+} flashlog_seal_t;
+
+/**
+ * @brief Finds the active sector and its head, formatting the log if no
+ *        sector is valid, then writes a boot marker.
+ */
+void FlashLog_Init(void);
+
+/**
+ * @brief Logs a reading. DHT11_ERR_NO_RESPONSE readings are not logged.
+ *        May erase the next sector when the active one is full.
+ */
+void FlashLog_Append(const dht11_reading_t *reading);
+
+/**
+ * @brief Writes out what each sensor holds in RAM: its open block, or its
+ *        pending odd reading and run.
+ */
+void FlashLog_Flush(void);
+
+/**
+ * @brief Flushes and starts streaming the log from the oldest word.
+ * @retval Words to be sent.
+ */
+uint32_t FlashLog_StartDump(void);
+
+/**
+ * @brief Flushes and starts streaming the spans of the log that can hold
+ *        readings from from_s to to_s, oldest first. The stream may start
+ *        and end a span wider than the window.
+ * @param from_s: Earliest reading wanted, in RTC seconds.
+ * @param to_s: Latest reading wanted, in RTC seconds.
+ * @retval Words to be sent.
+ */
+uint32_t FlashLog_StartRange(uint32_t from_s, uint32_t to_s);
+
+/**
+ * @brief Queues dump frames while the TX ring has room. Call from the main
+ *        loop.
+ * @retval 1 while a dump is in progress, 0 otherwise.
+ */
+uint8_t FlashLog_Poll(void);
+
+/**
+ * @brief Words written to the log, both sectors.
+ */
+uint32_t FlashLog_GetUsedWords(void);
+
+/**
+ * @brief Words the log holds when both sectors are full.
+ */
+uint32_t FlashLog_GetCapacityWords(void);
+
+/**
+ * @brief Generation of the active sector; counts sector changes.
+ */
+uint32_t FlashLog_GetGeneration(void);
+
+/**
+ * @brief Failed flash program or erase operations since boot.
+ */
+uint32_t FlashLog_GetErrors(void);
+
+/**
+ * @brief Result of checking the older sector against its seal.
+ */
+flashlog_seal_t FlashLog_GetSeal(void);
+
+/**
+ * @brief Short printable name of a seal state.
+ */
+const char* FlashLog_SealName(flashlog_seal_t seal);
+
+#endif /* FLASHLOG_H_ */
@@ -0,0 +1,109 @@
+/**
+ ******************************************************************************
+ * @file           : fmt.h
+ * @brief          : Small integer formatter writing into the TX ring.
+ *
+ *                   A line is built in a fmt_t on the caller's stack with
+ *                   Fmt_Str(), Fmt_Uint(), Fmt_Int(), Fmt_Hex() and
+ *                   Fmt_Fixed(), and Fmt_End() copies it into the
+ *                   uart_tx.h ring in one UART_TX_Write(), so lines from
+ *                   different contexts do not interleave. Output longer
+ *                   than FMT_LINE_MAX goes out in pieces as the buffer
+ *                   fills. No stdio, no locale, no heap, no floating point;
+ *                   divisions are 32-bit.
+ *
+ *                   Fmt_Print() takes a printf-style format with the
+ *                   subset this firmware uses: flags '-', '0', a decimal
+ *                   width, the 'l' modifier, and d i u x X c s p %.
+ *                   Anything else is copied through as text.
+ *
+ *                   With FMT_PRINTF_SHIM set, fmt.c also defines printf(),
+ *                   vprintf(), puts() and putchar() on top of Fmt_Print(),
+ *                   so newlib's vfprintf and the stdio FILE machinery are
+ *                   no longer linked. All existing output keeps working;
+ *                   float conversions are not supported.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef FMT_H_
+#define FMT_H_
+
+#include "main.h"
+#include <stdarg.h>
+
+/* Set to 1 to replace newlib's printf() with Fmt_Print() */
+#define FMT_PRINTF_SHIM (0)
+
+/** Line buffer; a longer line is written out as it fills */
+#define FMT_LINE_MAX    (160U)
+
+/**
+ * @brief Line under construction.
+ */
+typedef struct {
+	char buf[FMT_LINE_MAX];
+	uint32_t len;            /*!< Bytes in buf                */
+	uint32_t total;          /*!< Bytes since Fmt_Begin()     */
+} fmt_t;
+
+/**
+ * @brief Starts an empty line.
+ */
+void Fmt_Begin(fmt_t *f);
+
+/**
+ * @brief Appends one character.
+ */
+void Fmt_Char(fmt_t *f, char c);
+
+/**
+ * @brief Appends a NUL-terminated string; NULL appends "(null)".
+ */
+void Fmt_Str(fmt_t *f, const char *s);
+
+/**
+ * @brief Appends an unsigned decimal.
+ * @param width: Minimum field width, padded on the left with pad.
+ */
+void Fmt_Uint(fmt_t *f, uint32_t value, uint32_t width, char pad);
+
+/**
+ * @brief Appends a signed decimal; a zero pad goes after the sign.
+ */
+void Fmt_Int(fmt_t *f, int32_t value, uint32_t width, char pad);
+
+/**
+ * @brief Appends hexadecimal digits, zero-padded to at least digits.
+ * @param upper: Nonzero for A-F.
+ */
+void Fmt_Hex(fmt_t *f, uint32_t value, uint32_t digits, uint8_t upper);
+
+/**
+ * @brief Appends a fixed-point value: Fmt_Fixed(f, -235, 1) gives "-23.5".
+ * @param decimals: Digits after the point, 0 to 9.
+ */
+void Fmt_Fixed(fmt_t *f, int32_t value, uint32_t decimals);
+
+/**
+ * @brief Writes the rest of the line to the TX ring.
+ * @retval Bytes formatted since Fmt_Begin().
+ */
+uint32_t Fmt_End(fmt_t *f);
+
+/**
+ * @brief Appends a printf-style format (subset above) to a line.
+ */
+void Fmt_VFormat(fmt_t *f, const char *format, va_list ap);
+
+/**
+ * @brief Formats one printf-style line straight into the TX ring.
+ * @retval Bytes formatted.
+ */
+uint32_t Fmt_Print(const char *format, ...)
+		__attribute__((format(printf, 1, 2)));
+
+#endif /* FMT_H_ */
@@ -0,0 +1,105 @@
+/**
+ ******************************************************************************
+ * @file           : history.h
+ * @brief          : Reading history in the 4 KB battery-backed SRAM.
+ *
+ *                   A fixed-size ring of 12-byte records lives in the
+ *                   .bkpsram section (BKPSRAM, 0x40024000), which the
+ *                   startup code never clears. It survives resets and,
+ *                   while VBAT is supplied, loss of VDD. The header holds
+ *                   its own CRC and is rewritten after each record, so a
+ *                   reset mid-append loses at most that record. A header
+ *                   that does not check out formats the ring.
+ *
+ *                   Records carry the HAL tick and a boot number, since
+ *                   the tick restarts at every reset. When full, the
+ *                   oldest record is overwritten.
+ *
+ *                   History_Drain() sends the oldest records as COBS
+ *                   frames (telemetry packet type 0x02, Docs/telemetry.md)
+ *                   and removes only what the TX ring accepted.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef HISTORY_H_
+#define HISTORY_H_
+
+#include "main.h"
+#include "dht11.h"
+
+/** Size of the BKPSRAM region in the linker scripts */
+#define HISTORY_BKPSRAM_SIZE   (4096U)
+
+/** Records per drained packet */
+#define HISTORY_DRAIN_BATCH    (16U)
+
+/** Bumped whenever the record or header layout changes */
+#define HISTORY_VERSION        (1U)
+
+/**
+ * @brief One stored reading. Little-endian, packed to 12 bytes.
+ */
+typedef struct __attribute__((packed)) {
+	uint32_t timestamp_ms;  /*!< HAL tick at the start of the acquisition */
+	uint16_t boot;          /*!< Boot number the tick belongs to          */
+	uint8_t sensor_id;
+	uint8_t status;         /*!< dht11_status_t                           */
+	uint8_t raw[4];         /*!< Hum int, hum dec, temp int, temp dec     */
+} history_record_t;
+
+/**
+ * @brief Enables BKPSRAM and the backup regulator, then validates or
+ *        formats the ring and counts the boot.
+ */
+void History_Init(void);
+
+/**
+ * @brief Stores a reading, overwriting the oldest one when full.
+ *        DHT11_ERR_NO_RESPONSE readings are not stored.
+ */
+void History_Append(const dht11_reading_t *reading);
+
+/**
+ * @brief Copies a stored record.
+ * @param index: 0 for the oldest.
+ * @retval 1 if the record exists, 0 otherwise.
+ */
+uint8_t History_Get(uint32_t index, history_record_t *record);
+
+/**
+ * @brief Sends the oldest records in batches and removes them.
+ * @param max_records: Upper bound for this call.
+ * @retval Records sent; stops early when the TX ring is full.
+ */
+uint32_t History_Drain(uint32_t max_records);
+
+/**
+ * @brief Discards every stored record.
+ */
+void History_Clear(void);
+
+/**
+ * @brief Number of stored records.
+ */
+uint32_t History_Count(void);
+
+/**
+ * @brief Records the ring can hold.
+ */
+uint32_t History_Capacity(void);
+
+/**
+ * @brief Current boot number.
+ */
+uint32_t History_GetBoot(void);
+
+/**
+ * @brief Records lost to overwriting since the ring was formatted.
+ */
+uint32_t History_GetOverwritten(void);
+
+#endif /* HISTORY_H_ */
@@ -0,0 +1,176 @@
+/**
+ ******************************************************************************
+ * @file           : i2c_regmap.h
+ * @brief          : I2C slave register map for a host processor.
+ *
+ *                   A host on the carrier board reads the latest values as
+ *                   plain little-endian registers, with no text to format
+ *                   or parse on either side: write the start register,
+ *                   then read (repeated start or a separate transfer) as
+ *                   many bytes as wanted. The auto-incrementing read is
+ *                   fed by DMA straight from a snapshot of the whole map,
+ *                   so every byte of one read comes from the same instant
+ *                   and the CPU only sees the address and the NACK.
+ *
+ *                   Two snapshots alternate. Each reading updates a staging
+ *                   copy, which is published into the snapshot not being
+ *                   read, and the next read starts from it; a snapshot is
+ *                   never written while the DMA serves it (the publication
+ *                   waits for the read to end). Reads past the end return
+ *                   0xFF.
+ *
+ *                   Map (i2c_regmap_t), 160 bytes:
+ *                     0x00  u8   magic 0xD1
+ *                     0x01  u8   layout version
+ *                     0x02  u8   sensors
+ *                     0x03  u8   format (dht11_format_t)          rw
+ *                     0x04  u32  snapshot sequence
+ *                     0x08  u32  uptime ms at the snapshot
+ *                     0x0C  u32  DHT11 interval ms, 0 = stopped   rw
+ *                     0x10  u32  UART TX bytes dropped
+ *                     0x14  u32  UART RX errors
+ *                     0x18  u32  crashes since power-on
+ *                     0x1C  u32  register reads served
+ *                     0x20  8 x i2c_regmap_sensor_t, 16 bytes each:
+ *                       +0  u8   dht11_status_t of the last reading
+ *                       +1  u8   confidence, 0-100
+ *                       +2  u8   retries
+ *                       +3  u8   dht11_health_t
+ *                       +4  i16  temperature, 1/10 degC, calibrated
+ *                       +6  i16  humidity, 1/10 %RH, calibrated
+ *                       +8  u32  HAL tick of the reading
+ *                       +12 u16  readings, to spot new ones
+ *                       +14 u16  consecutive failures, saturated
+ *                   Temperature and humidity keep the last good values
+ *                   while the status reports a failure.
+ *
+ *                   Writes to the rw registers take effect from the
+ *                   thread within a poll (I2C_Regmap_Poll()); the interval
+ *                   only when all four bytes are written in one transfer
+ *                   and only with DHT11_USE_ASYNC.
+ *
+ *                   I2C1 on PB6 (SCL) / PB7 (SDA), AF4, open drain, up to
+ *                   400 kHz, 7-bit address I2C_REGMAP_ADDRESS. The host
+ *                   needs pull-ups. STOP mode would miss the address, so
+ *                   it is held off while the slave is enabled.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef I2C_REGMAP_H_
+#define I2C_REGMAP_H_
+
+#include "main.h"
+#include "dht11.h"
+
+/* Set to 1 to serve the register map on I2C1 (PB6/PB7) */
+#define I2C_USE_REGMAP        (0)
+
+/** 7-bit slave address */
+#define I2C_REGMAP_ADDRESS    (0x42U)
+
+#define I2C_REGMAP_MAGIC      (0xD1U)
+#define I2C_REGMAP_VERSION    (1U)
+#define I2C_REGMAP_SENSORS    (8U)
+
+/** Longest write after the register byte */
+#define I2C_REGMAP_WRITE_MAX  (8U)
+
+/** Republishes the header counters at least this often */
+#define I2C_REGMAP_REFRESH_MS (1000U)
+
+/** Register offsets */
+#define I2C_REGMAP_REG_FORMAT   (0x03U)
+#define I2C_REGMAP_REG_INTERVAL (0x0CU)
+#define I2C_REGMAP_REG_SENSORS  (0x20U)
+
+/**
+ * @brief One sensor's entry. Little-endian, packed to 16 bytes.
+ */
+typedef struct __attribute__((packed)) {
+	uint8_t status;
+	uint8_t confidence;
+	uint8_t retries;
+	uint8_t health;
+	int16_t temp;
+	int16_t hum;
+	uint32_t timestamp_ms;
+	uint16_t readings;
+	uint16_t failures;
+} i2c_regmap_sensor_t;
+
+/**
+ * @brief The whole map as the host sees it.
+ */
+typedef struct __attribute__((packed)) {
+	uint8_t magic;
+	uint8_t version;
+	uint8_t sensors;
+	uint8_t format;
+	uint32_t snapshot;
+	uint32_t uptime_ms;
+	uint32_t interval_ms;
+	uint32_t tx_dropped;
+	uint32_t rx_errors;
+	uint32_t crashes;
+	uint32_t reads;
+	i2c_regmap_sensor_t sensor[I2C_REGMAP_SENSORS];
+} i2c_regmap_t;
+
+_Static_assert(sizeof(i2c_regmap_t) == 160U, "register map layout changed");
+
+#if I2C_USE_REGMAP
+
+/**
+ * @brief Claims PB6/PB7 and starts listening for the host. Call after
+ *        UART_TX_Init().
+ */
+void I2C_Regmap_Init(void);
+
+/**
+ * @brief Reports whether the slave is listening.
+ */
+uint8_t I2C_Regmap_IsEnabled(void);
+
+/**
+ * @brief Records a reading, good or failed, and publishes the map.
+ */
+void I2C_Regmap_Reading(const dht11_reading_t *reading);
+
+/**
+ * @brief Applies host writes, publishes a deferred update and refreshes
+ *        the counters. Call from the CLI poll loop.
+ */
+void I2C_Regmap_Poll(void);
+
+/**
+ * @brief Read transactions served and bus errors seen.
+ */
+uint32_t I2C_Regmap_GetReads(void);
+uint32_t I2C_Regmap_GetErrors(void);
+
+/**
+ * @brief Reprograms CR2.FREQ from the new PCLK1.
+ */
+void I2C_Regmap_ClockChanged(void);
+
+/**
+ * @brief Interrupt bodies; called from I2C1_EV_IRQHandler(),
+ *        I2C1_ER_IRQHandler() and DMA1_Stream7_IRQHandler().
+ */
+void I2C_Regmap_EvIRQHandler(void);
+void I2C_Regmap_ErIRQHandler(void);
+void I2C_Regmap_DmaIRQHandler(void);
+
+/** Records every reading */
+#define I2C_REGMAP_READING(reading) I2C_Regmap_Reading(reading)
+
+#else
+#define I2C_Regmap_IsEnabled()      (0U)
+#define I2C_REGMAP_READING(reading) ((void) 0)
+#endif /* I2C_USE_REGMAP */
+
+#endif /* I2C_REGMAP_H_ */
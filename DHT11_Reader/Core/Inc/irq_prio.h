@@ -0,0 +1,100 @@
+/**
+ ******************************************************************************
+ * @file           : irq_prio.h
+ * @brief          : Interrupt priority plan and BASEPRI masking helpers.
+ *
+ *                   NVIC_PRIORITYGROUP_4: all four priority bits preempt,
+ *                   no sub-priorities; lower numbers preempt higher ones.
+ *
+ *                     0  IRQ_PRIO_CAPTURE   TIM5 (capture, async deadlines,
+ *                                           SysTime_Now64 wraps),
+ *                                           DMA1 S4 (capture), DMA2 S5
+ *                                           (multi-channel sampling),
+ *                                           EXTI1 (EXTI decoder),
+ *                                           EXTI15_10 (dht11_emu.h start)
+ *                     2  IRQ_PRIO_TIMEBASE  TIM6 (Timebase_Micros64 wraps),
+ *                                           EXTI0 (dht11_sync.h pulse),
+ *                                           TIM11 (watermark.h probe)
+ *                     6  IRQ_PRIO_UART      USART2, DMA1 S5/S6, OTG FS
+ *                                           (usb_cdc.h, feeds the same ring),
+ *                                           CAN1 TX/RX0/SCE (can_bus.h),
+ *                                           I2C1 EV/ER, DMA1 S7 (i2c_regmap.h),
+ *                                           TIM4 (modbus.h t3.5),
+ *                                           DMA1 S1 (dht11_emu.h),
+ *                                           EXTI9_5 (uart_flow.h CTS),
+ *                                           USART3, TIM12 (rs485_gw.h)
+ *                    10  IRQ_PRIO_WAKEUP    RTC wakeup, EXTI3 (RX wake),
+ *                                           EXTI15_10 (dht11_trigger.h B1,
+ *                                           without the emulator),
+ *                                           ADC (adc_mon.h brownout)
+ *                    15  IRQ_PRIO_TICK      SysTick, or TIM7 under FreeRTOS,
+ *                                           TIM2 (status_led.h patterns)
+ *
+ *                   Irq_MaskFrom(level) raises BASEPRI so that every
+ *                   interrupt of priority level or lower (numerically >=)
+ *                   waits, while the more urgent ones keep running. A
+ *                   section that only races the UART handlers masks from
+ *                   IRQ_PRIO_UART and never delays capture; a timing
+ *                   window masks from IRQ_PRIO_TIMEBASE. BASEPRI cannot
+ *                   mask level 0, so the few sections shared with the
+ *                   capture handlers (Timebase_Cycles64(), SysTime_Now64(),
+ *                   profiling) keep
+ *                   __disable_irq() and stay a handful of instructions.
+ *
+ *                   FreeRTOS (app_rtos.h) masks from level 5 in its own
+ *                   critical sections; no handler here calls the kernel.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef IRQ_PRIO_H_
+#define IRQ_PRIO_H_
+
+#include "main.h"
+
+/** Preemption priorities, 0 (most urgent) to 15 */
+#define IRQ_PRIO_CAPTURE   (0U)
+#define IRQ_PRIO_TIMEBASE  (2U)
+#define IRQ_PRIO_UART      (6U)
+#define IRQ_PRIO_WAKEUP    (10U)
+#define IRQ_PRIO_TICK      (15U)
+
+#if TICK_INT_PRIORITY != IRQ_PRIO_TICK
+#error "TICK_INT_PRIORITY in stm32f4xx_hal_conf.h must equal IRQ_PRIO_TICK"
+#endif
+
+/**
+ * @brief Holds off interrupts of priority level and below; more urgent
+ *        ones still preempt. Never lowers an existing mask.
+ * @param level: 1-15; the caller's own level or above.
+ * @retval Previous BASEPRI, for Irq_Unmask().
+ */
+static inline uint32_t Irq_MaskFrom(uint32_t level) {
+	uint32_t basepri = __get_BASEPRI();
+
+	__set_BASEPRI_MAX(level << (8U - __NVIC_PRIO_BITS));
+	__ISB();
+	return basepri;
+}
+
+/**
+ * @brief Restores the mask returned by Irq_MaskFrom().
+ */
+static inline void Irq_Unmask(uint32_t basepri) {
+	__set_BASEPRI(basepri);
+}
+
+/**
+ * @brief Reports whether BASEPRI currently holds off the given level.
+ */
+static inline uint8_t Irq_IsMasked(uint32_t level) {
+	uint32_t basepri = __get_BASEPRI();
+
+	return ((basepri != 0U)
+			&& ((level << (8U - __NVIC_PRIO_BITS)) >= basepri)) ? 1U : 0U;
+}
+
+#endif /* IRQ_PRIO_H_ */
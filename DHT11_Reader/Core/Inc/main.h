@@ -41,6 +41,19 @@ extern "C" {
 
 /* Exported constants --------------------------------------------------------*/
 /* USER CODE BEGIN EC */
+/* Set to 1 for the fast boot path: the HSE starts up while the GPIOs are
+ * configured, a warm reset keeps the RTC and its LSI calibration, and the
+ * DHT11 power-up time passes asleep in the scheduler rather than in a
+ * blocking delay after init */
+#define APP_FAST_BOOT (1)
+
+/* Set to 1 for register-level hot paths: the capture DMA is armed, read
+ * and stopped on DMA1 Stream4 directly, console chunks start on DMA1
+ * Stream6 without HAL_UART_Transmit_DMA(), and the TIM5, TIM6 and both
+ * DMA streams' interrupts dispatch on their flags instead of going
+ * through the HAL handlers. CubeMX init and every other peripheral stay
+ * on the HAL. Set to 0 for the all-HAL build */
+#define APP_USE_FASTPATH (1)
 
 /* USER CODE END EC */
 
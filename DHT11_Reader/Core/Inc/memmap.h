@@ -0,0 +1,38 @@
+/**
+ ******************************************************************************
+ * @file           : memmap.h
+ * @brief          : Placement of data in the SRAM banks.
+ *
+ *                   SRAM1 (112 KB at 0x20000000) holds .data, .bss,
+ *                   .noinit, the heap and the main stack; SRAM2 (16 KB at
+ *                   0x2001C000) holds the DMA buffers. The CPU and the DMA
+ *                   streams then mostly go to different slaves of the AHB
+ *                   bus matrix and rarely wait for each other.
+ *
+ *                   DMA_BUFFER  .dma_buffers in SRAM2, word aligned, neither
+ *                               loaded nor cleared at boot: the owner
+ *                               resets its indices and the DMA fills the
+ *                               data before it is read.
+ *                   NOINIT      .noinit in SRAM1, kept across resets (not
+ *                               power cycles); validate before use.
+ *
+ *                   The linker reports the use of each bank
+ *                   (--print-memory-usage) and fails the link when one
+ *                   overflows.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef MEMMAP_H_
+#define MEMMAP_H_
+
+/** Buffer read or written by a DMA stream */
+#define DMA_BUFFER __attribute__((section(".dma_buffers"), aligned(4)))
+
+/** Variable that survives a reset */
+#define NOINIT     __attribute__((section(".noinit")))
+
+#endif /* MEMMAP_H_ */
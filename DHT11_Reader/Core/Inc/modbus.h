@@ -0,0 +1,144 @@
+/**
+ ******************************************************************************
+ * @file           : modbus.h
+ * @brief          : Modbus RTU slave on USART2 for PLC polling.
+ *
+ *                   With MODBUS_USE_RTU the node answers a Modbus master on
+ *                   USART2 instead of printing text there: function codes
+ *                   03 (read holding), 04 (read input), 06 (write single)
+ *                   and 16 (write multiple). Console output moves to USB
+ *                   CDC when that device runs (usb_cdc.h) and is discarded
+ *                   otherwise (UART_TX_TRANSPORT_NONE); the CLI stays
+ *                   reachable on USB and CAN.
+ *
+ *                   Reception reuses the circular DMA ring of uart_rx.h.
+ *                   Every reception event (IDLE line, half/full ring)
+ *                   restarts a one-pulse TIM4 for the rest of the t3.5
+ *                   silence (3.5 characters, 1.75 ms above 19200 baud);
+ *                   when it expires with no byte received since, the frame
+ *                   is complete and handled in that interrupt: CRC check,
+ *                   address match, reply built and started on USART2 TX
+ *                   DMA. The thread is not involved, so the reply follows
+ *                   the request within a few microseconds of t3.5 whatever
+ *                   the main loop does. The CRC uses a 256-entry table.
+ *
+ *                   Input registers (04), per sensor n at 8 * n:
+ *                     +0 dht11_status_t   +4 confidence, 0-100
+ *                     +1 temp, 1/10 degC  +5 dht11_health_t
+ *                     +2 hum, 1/10 %RH    +6 readings, wraps
+ *                     +3 dew point, 1/10  +7 consecutive failures
+ *                   then at 100: uptime s (hi, lo), frames served,
+ *                   CRC errors. Temperatures are signed; failed readings
+ *                   keep the last good values. Sensor registers come from
+ *                   the dht11_latest.h snapshots, one per sensor and
+ *                   request, read lock-free in the interrupt.
+ *
+ *                   Holding registers (03/06/16):
+ *                     0-1  DHT11 interval ms (hi, lo), 0 = stopped; needs
+ *                          DHT11_USE_ASYNC, else reads 0 and ignores writes
+ *                     2    format (dht11_format_t)
+ *                     3    slave address, 1-247, until reset
+ *                   Writes are answered at once and applied from the CLI
+ *                   poll loop.
+ *
+ *                   Line settings come from uart_baud.h (8N1, default
+ *                   115200); set the master to match. An RS-485
+ *                   transceiver's driver enable goes on PA8, high while
+ *                   the reply is sent. STOP mode is held off.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef MODBUS_H_
+#define MODBUS_H_
+
+#include "main.h"
+#include "dht11.h"
+
+/* Set to 1 to hand USART2 to a Modbus RTU master */
+#define MODBUS_USE_RTU          (0)
+
+/** Slave address after reset */
+#define MODBUS_ADDRESS          (1U)
+
+/** Largest RTU frame */
+#define MODBUS_ADU_MAX          (256U)
+
+#define MODBUS_SENSORS          (8U)
+#define MODBUS_REGS_PER_SENSOR  (8U)
+#define MODBUS_INPUT_STATS      (100U)
+#define MODBUS_HOLDING_COUNT    (4U)
+
+/** Holding registers */
+#define MODBUS_HOLD_INTERVAL_HI (0U)
+#define MODBUS_HOLD_INTERVAL_LO (1U)
+#define MODBUS_HOLD_FORMAT      (2U)
+#define MODBUS_HOLD_ADDRESS     (3U)
+
+/**
+ * @brief Frame counters.
+ */
+typedef struct {
+	uint32_t frames;      /*!< Requests answered or, broadcast, executed */
+	uint32_t crc_errors;
+	uint32_t exceptions;  /*!< Exception replies sent                    */
+	uint32_t foreign;     /*!< Valid frames for other slaves             */
+} modbus_stats_t;
+
+#if MODBUS_USE_RTU
+
+/**
+ * @brief Takes over USART2: moves console output away, claims PA8 and
+ *        TIM4. Call after UART_RX_Init() and Usb_Cdc_Start().
+ */
+void Modbus_Init(void);
+
+/**
+ * @brief Reports whether USART2 belongs to Modbus.
+ */
+uint8_t Modbus_IsActive(void);
+
+/**
+ * @brief Applies holding register writes. Call from the CLI poll loop.
+ */
+void Modbus_Poll(void);
+
+/**
+ * @brief Copies the frame counters.
+ */
+void Modbus_GetStats(modbus_stats_t *stats);
+
+/**
+ * @brief Recomputes the TIM4 prescaler after a clock profile change.
+ */
+void Modbus_ClockChanged(void);
+
+/**
+ * @brief Reception event; called from HAL_UARTEx_RxEventCallback().
+ */
+void Modbus_RxEventCallback(void);
+
+/**
+ * @brief Reply sent, line released; called from HAL_UART_TxCpltCallback().
+ */
+void Modbus_TxCompleteCallback(void);
+
+/**
+ * @brief UART error; called from HAL_UART_ErrorCallback(). Releases the
+ *        line if HAL aborted the reply.
+ */
+void Modbus_ErrorCallback(void);
+
+/**
+ * @brief t3.5 expiry; called from TIM4_IRQHandler().
+ */
+void Modbus_TimerIRQHandler(void);
+
+#else
+#define Modbus_IsActive()       (0U)
+#endif /* MODBUS_USE_RTU */
+
+#endif /* MODBUS_H_ */
@@ -25,7 +25,29 @@
 /* Set to 1 to enable debug prints, 0 to disable */
 #define MY_DEBUG (0)
 
-#if MY_DEBUG != 0
+/* Set to 1 to record debug calls into the deferred log ring (dlog.h)
+ * instead of calling printf at the call site. Records are formatted later
+ * by DLog_Process() from the idle loop, so timing-critical code is not
+ * disturbed. Arguments must be 32-bit values (no float/64-bit). */
+#define MY_DEBUG_DEFERRED (1)
+
+#if (MY_DEBUG != 0) && (MY_DEBUG_DEFERRED != 0)
+
+    #include "dlog.h"
+
+    #define DEBUG_INFO(fmt, ...) \
+        DLOG_RECORD(DLOG_LEVEL_INFO, fmt, ##__VA_ARGS__)
+
+    #define DEBUG_WARN(fmt, ...) \
+        DLOG_RECORD(DLOG_LEVEL_WARN, fmt, ##__VA_ARGS__)
+
+    #define DEBUG_ERROR(fmt, ...) \
+        DLOG_RECORD(DLOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
+
+    #define DEBUG_PRINT(fmt, ...) \
+        DLOG_RECORD(DLOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+
+#elif MY_DEBUG != 0
 
     /* Helper macros for log levels */
     #define DEBUG_INFO(fmt, ...) \
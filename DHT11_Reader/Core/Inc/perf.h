@@ -0,0 +1,205 @@
+/**
+ ******************************************************************************
+ * @file           : perf.h
+ * @brief          : CPU time accounting from the DWT counters: idle and
+ *                   busy time, time per interrupt handler and, through
+ *                   sched.h, per scheduler task.
+ *
+ *                   Everything is counted in DWT CYCCNT cycles while the
+ *                   core is awake:
+ *                     - sleep: every WFI goes through Perf_IdleBegin() and
+ *                       Perf_IdleEnd() (Power_Sleep(), the RTOS idle hook),
+ *                       less the handlers that ran inside the window;
+ *                     - ISR: PERF_ISR_ENTER() and PERF_ISR_EXIT() bracket
+ *                       each handler in stm32f4xx_it.c. A nested handler's
+ *                       time is taken out of the one it preempted, so each
+ *                       cycle is counted once;
+ *                     - exception overhead: DWT EXCCNT, the stacking and
+ *                       unstacking cycles, added up at every handler exit;
+ *                     - tasks: Sched_Exec() charges a task its run time
+ *                       less the handlers that preempted it.
+ *                   busy = awake - sleep, so spin waits (the bit-banged
+ *                   read, Timebase_DelayUs()) count as load, which is the
+ *                   point. STOP mode halts CYCCNT; that time is reported
+ *                   separately in milliseconds (power.h).
+ *
+ *                   EXCCNT, SLEEPCNT, LSUCNT and FOLDCNT are 8-bit and
+ *                   wrap every 256 events. Only EXCCNT is read often
+ *                   enough (once per handler, whose overhead is ~12-30
+ *                   cycles) to be accumulated; sleep is taken from CYCCNT
+ *                   around the WFI, and the LSU and fold counters are
+ *                   enabled for PERF_REGION_BEGIN()/END() on short code
+ *                   sections only.
+ *
+ *                   Shares are in permille of the awake cycles since
+ *                   Perf_Reset(), shown by the "perf" command and sent as
+ *                   a telemetry packet (TELEMETRY_TYPE_PERF).
+ *
+ *                   Call Perf_Init() after Timebase_Init().
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef PERF_H_
+#define PERF_H_
+
+#include "main.h"
+
+/* Set to 1 to time every interrupt handler */
+#define PERF_USE_ISR (1)
+
+/**
+ * @brief Timed interrupt handlers.
+ */
+typedef enum {
+	PERF_ISR_SYSTICK = 0,
+	PERF_ISR_RTC_WKUP,
+	PERF_ISR_EXTI1,       /*!< DHT11 EXTI decoder          */
+	PERF_ISR_EXTI3,       /*!< USART2 RX wake-up from STOP */
+	PERF_ISR_DMA1_S4,     /*!< TIM5 capture DMA            */
+	PERF_ISR_DMA1_S5,     /*!< USART2 RX DMA               */
+	PERF_ISR_DMA1_S6,     /*!< USART2 TX DMA               */
+	PERF_ISR_USART2,
+	PERF_ISR_TIM5,
+	PERF_ISR_TIM6,        /*!< Timebase                    */
+	PERF_ISR_TIM7,        /*!< HAL tick under the RTOS     */
+	PERF_ISR_DMA2_S5,     /*!< Multi-channel IDR sampling  */
+	PERF_ISR_OTG_FS,      /*!< USB CDC device              */
+	PERF_ISR_CAN1_TX,     /*!< CAN mailbox refill          */
+	PERF_ISR_CAN1_RX0,    /*!< CAN command frames          */
+	PERF_ISR_CAN1_SCE,    /*!< CAN errors                  */
+	PERF_ISR_I2C1_EV,     /*!< Register map slave          */
+	PERF_ISR_I2C1_ER,
+	PERF_ISR_DMA1_S7,     /*!< Register map reads          */
+	PERF_ISR_TIM4,        /*!< Modbus t3.5                 */
+	PERF_ISR_EXTI15_10,   /*!< Emulator start pulse, B1    */
+	PERF_ISR_DMA1_S1,     /*!< Emulator last edge          */
+	PERF_ISR_EXTI0,       /*!< Cross-board sync pulse      */
+	PERF_ISR_EXTI9_5,     /*!< USART2 CTS (uart_flow.h)    */
+	PERF_ISR_TIM2,        /*!< Status LED patterns         */
+	PERF_ISR_ADC,         /*!< ADC1 brownout watchdog      */
+	PERF_ISR_USART3,      /*!< RS-485 gateway line         */
+	PERF_ISR_TIM12,       /*!< RS-485 gateway timeouts     */
+	PERF_ISR_TIM11,       /*!< Latency probe (watermark.h) */
+	PERF_ISR_COUNT
+} perf_isr_t;
+
+/**
+ * @brief State saved by PERF_ISR_ENTER() on the handler's stack.
+ */
+typedef struct {
+	uint32_t start;       /*!< CYCCNT at entry                      */
+	uint32_t outer;       /*!< Nested time of the preempted handler */
+} perf_frame_t;
+
+/**
+ * @brief Accounting of one handler.
+ */
+typedef struct {
+	uint32_t count;
+	uint32_t max_cycles;  /*!< Longest run, nested handlers excluded */
+	uint64_t cycles;
+} perf_isr_stat_t;
+
+/**
+ * @brief CPU shares since Perf_Reset(), permille of the awake cycles.
+ */
+typedef struct {
+	uint32_t window_ms;   /*!< HAL time, STOP included   */
+	uint32_t stop_ms;     /*!< Spent in STOP             */
+	uint16_t busy_pm;     /*!< Handlers and thread code  */
+	uint16_t isr_pm;      /*!< Handler bodies            */
+	uint16_t exc_pm;      /*!< Exception entry and exit  */
+	uint16_t isr_each_pm[PERF_ISR_COUNT];
+} perf_load_t;
+
+#if PERF_USE_ISR
+#define PERF_ISR_ENTER()   perf_frame_t perf_frame; Perf_IsrEnter(&perf_frame)
+#define PERF_ISR_EXIT(isr) Perf_IsrExit(&perf_frame, (isr))
+#else
+#define PERF_ISR_ENTER()   ((void) 0)
+#define PERF_ISR_EXIT(isr) ((void) 0)
+#endif /* PERF_USE_ISR */
+
+/** Extra cycles of a short section (< 256 each): LSU stalls and folds */
+#define PERF_REGION_BEGIN(lsu, fold) \
+	do { (lsu) = DWT->LSUCNT; (fold) = DWT->FOLDCNT; } while (0)
+#define PERF_REGION_END(lsu, fold) \
+	do { (lsu) = (DWT->LSUCNT - (lsu)) & 0xFFU; \
+		(fold) = (DWT->FOLDCNT - (fold)) & 0xFFU; } while (0)
+
+/**
+ * @brief Enables the DWT event counters and starts a window.
+ */
+void Perf_Init(void);
+
+/**
+ * @brief Starts a new window; also clears the task times (sched.h) and
+ *        the handler entry latencies (watermark.h).
+ */
+void Perf_Reset(void);
+
+/**
+ * @brief Marks a handler entry. Use PERF_ISR_ENTER().
+ */
+void Perf_IsrEnter(perf_frame_t *frame);
+
+/**
+ * @brief Charges a handler its run time. Use PERF_ISR_EXIT().
+ */
+void Perf_IsrExit(perf_frame_t *frame, perf_isr_t isr);
+
+/**
+ * @brief Cycles spent in handler bodies since boot.
+ */
+uint64_t Perf_IsrCycles(void);
+
+/**
+ * @brief Call right before a WFI, in thread context.
+ */
+void Perf_IdleBegin(void);
+
+/**
+ * @brief Call right after the WFI returns.
+ */
+void Perf_IdleEnd(void);
+
+/**
+ * @brief Awake cycles in the current window.
+ */
+uint64_t Perf_WindowCycles(void);
+
+/**
+ * @brief Computes the shares of the current window.
+ */
+void Perf_GetLoad(perf_load_t *load);
+
+/**
+ * @brief Accounting of one handler in the current window.
+ */
+const perf_isr_stat_t* Perf_GetIsr(perf_isr_t isr);
+
+/**
+ * @brief Short handler name for printing.
+ */
+const char* Perf_IsrName(perf_isr_t isr);
+
+/**
+ * @brief Share of the window, permille, saturated at 1000.
+ */
+uint32_t Perf_Permille(uint64_t cycles, uint64_t window);
+
+/**
+ * @brief Prints the window shares and one line per handler that ran.
+ */
+void Perf_Dump(void);
+
+/**
+ * @brief Queues the window shares as one TELEMETRY_TYPE_PERF packet.
+ */
+void Perf_Send(void);
+
+#endif /* PERF_H_ */
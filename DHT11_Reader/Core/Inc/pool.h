@@ -0,0 +1,128 @@
+/**
+ ******************************************************************************
+ * @file           : pool.h
+ * @brief          : Header-only fixed-block pool allocator.
+ *
+ *                   POOL_DEFINE() generates a pool type of len blocks of
+ *                   one element type and its static inline functions.
+ *                   Free blocks are kept on a stack of indices, so
+ *                   allocation and release are O(1) with no search, no
+ *                   fragmentation and no dependency on the C library heap.
+ *                   Running out is an ordinary NULL result that the caller
+ *                   handles; the pool counts it, and keeps the lowest free
+ *                   level seen, so the sizes can be tuned from "stats".
+ *
+ *                   Alloc and Free run with interrupts masked for a few
+ *                   instructions (PRIMASK saved and restored), so any
+ *                   context may use the same pool. Free rejects pointers
+ *                   that are not one of the pool's blocks or that are
+ *                   already free.
+ *
+ *                   Example:
+ *                     POOL_DEFINE(pkt_pool_t, PktPool, pkt_t, 4U)
+ *                     static pkt_pool_t pool;
+ *                     init: PktPool_Init(&pool);
+ *                     use:  pkt_t *p = PktPool_Alloc(&pool);
+ *                           if (p != NULL) { ...; PktPool_Free(&pool, p); }
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef POOL_H_
+#define POOL_H_
+
+#include "main.h"
+#include <stddef.h>
+
+/**
+ * @brief Defines pool type type_name and functions prefix_Init, _Alloc,
+ *        _Free, _Available, _MinAvailable and _Fails for blocks of
+ *        elem_type.
+ * @param len: Blocks in the pool, 1 to 255.
+ */
+#define POOL_DEFINE(type_name, prefix, elem_type, len)                      \
+	_Static_assert(((len) != 0U) && ((len) <= 255U),                      \
+			#type_name " must hold 1 to 255 blocks");                     \
+	typedef struct {                                                       \
+		elem_type blocks[len];                                             \
+		uint8_t free_idx[len];  /*!< Stack of free block indices   */      \
+		uint8_t in_use[len];    /*!< Against double and stray frees */     \
+		uint32_t free_count;                                               \
+		uint32_t min_free;      /*!< Low-water mark of free_count  */      \
+		uint32_t fails;         /*!< Allocations that found none   */      \
+	} type_name;                                                           \
+	                                                                       \
+	/** Marks every block free; only while no block is held. */           \
+	static inline void prefix##_Init(type_name *p) {                      \
+		uint32_t i;                                                        \
+		                                                                   \
+		for (i = 0U; i < (len); i++) {                                     \
+			p->free_idx[i] = (uint8_t) ((len) - 1U - i);                   \
+			p->in_use[i] = 0U;                                             \
+		}                                                                  \
+		p->free_count = (len);                                             \
+		p->min_free = (len);                                               \
+		p->fails = 0U;                                                     \
+	}                                                                      \
+	                                                                       \
+	/** Takes a block, contents undefined. Returns NULL if none is free. */\
+	static inline elem_type* prefix##_Alloc(type_name *p) {               \
+		uint32_t primask = __get_PRIMASK();                                \
+		elem_type *block = NULL;                                           \
+		uint32_t idx;                                                      \
+		                                                                   \
+		__disable_irq();                                                   \
+		if (p->free_count == 0U) {                                         \
+			p->fails++;                                                    \
+		} else {                                                           \
+			idx = p->free_idx[--p->free_count];                            \
+			p->in_use[idx] = 1U;                                           \
+			block = &p->blocks[idx];                                       \
+			if (p->free_count < p->min_free) {                             \
+				p->min_free = p->free_count;                               \
+			}                                                              \
+		}                                                                  \
+		__set_PRIMASK(primask);                                            \
+		return block;                                                      \
+	}                                                                      \
+	                                                                       \
+	/** Returns a block. Returns 0 for NULL, foreign or free pointers. */  \
+	static inline uint8_t prefix##_Free(type_name *p, elem_type *block) { \
+		uint32_t primask;                                                  \
+		uint32_t idx;                                                      \
+		uint8_t ok = 0U;                                                   \
+		                                                                   \
+		if ((block < &p->blocks[0]) || (block > &p->blocks[(len) - 1U])) { \
+			return 0U;                                                     \
+		}                                                                  \
+		idx = (uint32_t) (block - &p->blocks[0]);                          \
+		primask = __get_PRIMASK();                                         \
+		__disable_irq();                                                   \
+		if (p->in_use[idx] != 0U) {                                        \
+			p->in_use[idx] = 0U;                                           \
+			p->free_idx[p->free_count++] = (uint8_t) idx;                  \
+			ok = 1U;                                                       \
+		}                                                                  \
+		__set_PRIMASK(primask);                                            \
+		return ok;                                                         \
+	}                                                                      \
+	                                                                       \
+	/** Free blocks (a snapshot). */                                      \
+	static inline uint32_t prefix##_Available(const type_name *p) {       \
+		return p->free_count;                                              \
+	}                                                                      \
+	                                                                       \
+	/** Fewest free blocks since Init. */                                 \
+	static inline uint32_t prefix##_MinAvailable(const type_name *p) {    \
+		return p->min_free;                                                \
+	}                                                                      \
+	                                                                       \
+	/** Allocations that returned NULL since Init. */                     \
+	static inline uint32_t prefix##_Fails(const type_name *p) {           \
+		return p->fails;                                                   \
+	}
+
+#endif /* POOL_H_ */
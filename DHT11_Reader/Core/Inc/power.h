@@ -0,0 +1,143 @@
+/**
+ ******************************************************************************
+ * @file           : power.h
+ * @brief          : Low-power idle between DHT11 acquisitions.
+ *
+ *                   Long idle periods are spent in STOP mode (all clocks
+ *                   off, low-power regulator, flash powered down) and end on
+ *                   the RTC wakeup timer. The RTC runs on the 32.768 kHz
+ *                   LSE when POWER_USE_LSE is set and the crystal starts;
+ *                   otherwise it runs on the LSI, calibrated against TIM5
+ *                   at init (with APP_FAST_BOOT, only after a power-up:
+ *                   warm resets reuse the RTC prescalers derived from it).
+ *                   The LSI keeps clocking the watchdog. On wake the active
+ *                   clock profile is restored and the time spent stopped is
+ *                   measured on the RTC sub-second counter, then added back
+ *                   to the HAL tick.
+ *
+ *                   STOP freezes TIM5, TIM6 and DWT. TIM5 carries the
+ *                   system timestamp (systime.h), so the stop time is
+ *                   added back to it (SysTime_Advance()); callers with a
+ *                   compare pending on TIM5 re-arm it (see
+ *                   DHT11_Async_AdvanceTime()). Timebase_Micros() excludes
+ *                   time spent stopped.
+ *
+ *                   USART2 cannot receive in STOP. A falling edge on PA3
+ *                   (RX) wakes the node, but those characters are lost.
+ *                   After that, STOP is held off for
+ *                   POWER_ACTIVITY_HOLDOFF_MS so the command line works.
+ *                   STOP also stops PLLSAI, which clocks the USB device
+ *                   (usb_cdc.h), and the CAN controller (can_bus.h): it is
+ *                   not entered while either is started, nor while the
+ *                   I2C register map (i2c_regmap.h) or the Modbus slave
+ *                   (modbus.h) waits for its host, nor with the DHT11
+ *                   emulator (dht11_emu.h) built in, nor while the status
+ *                   LED (status_led.h) shows a problem.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef POWER_H_
+#define POWER_H_
+
+#include "main.h"
+
+/* Set to 1 to idle in STOP mode, 0 to only use WFI sleep */
+#define POWER_USE_STOP (1)
+
+/** Idle periods shorter than this are spent in WFI sleep */
+#define POWER_STOP_MIN_US         (5000U)
+
+/** Wake this early to cover the regulator, HSE, PLL and over-drive restart */
+#define POWER_STOP_LATENCY_US     (1500U)
+
+/** Longest single STOP period; RTC wakeup timer at LSI/16 tops out near 32 s */
+#define POWER_STOP_MAX_US         (30000000U)
+
+/** STOP is not entered for this long after UART activity */
+#define POWER_ACTIVITY_HOLDOFF_MS (15000U)
+
+/** LSI frequency assumed if calibration fails */
+#define POWER_LSI_NOMINAL_HZ      (32000U)
+
+/* Set to 1 to clock the RTC from the LSE crystal when one is fitted */
+#define POWER_USE_LSE (1)
+
+#define POWER_LSE_HZ              (32768U)
+
+/** LSE start-up allowance; an absent crystal costs this once per power-up */
+#define POWER_LSE_TIMEOUT_MS      (2000U)
+
+/**
+ * @brief Starts the LSI, calibrates it on TIM5 and configures the RTC
+ *        wakeup timer. Call after DHT11_Capture_Init() (TIM5 running).
+ */
+void Power_Init(void);
+
+/**
+ * @brief Idles for at most budget_us.
+ *        Uses STOP when the budget allows it, the TX path is drained and no
+ *        UART activity was seen recently. Otherwise it runs one WFI.
+ * @param budget_us: Time until the next scheduled event.
+ * @retval Microseconds spent in STOP (timers frozen), 0 after a WFI.
+ */
+uint32_t Power_Sleep(uint32_t budget_us);
+
+/**
+ * @brief Low-power replacement for HAL_Delay().
+ */
+void Power_DelayMs(uint32_t ms);
+
+/**
+ * @brief Holds off STOP for POWER_ACTIVITY_HOLDOFF_MS.
+ */
+void Power_NotifyActivity(void);
+
+/**
+ * @brief Calibrated LSI frequency in Hz.
+ */
+uint32_t Power_GetLsiHz(void);
+
+/**
+ * @brief RTC clock in Hz: POWER_LSE_HZ or the calibrated LSI.
+ */
+uint32_t Power_GetRtcHz(void);
+
+/**
+ * @brief Seconds since 2000-01-01 00:00 on the RTC calendar, which keeps
+ *        running across warm resets. Falls back to the HAL tick when the
+ *        RTC could not be started.
+ */
+uint32_t Power_GetRtcSeconds(void);
+
+/**
+ * @brief Power_GetRtcSeconds() with the time into the second, at the
+ *        resolution of the sub-second counter (RTCCLK/2).
+ * @param us: Receives microseconds into the second; may be NULL.
+ */
+uint32_t Power_GetRtcTime(uint32_t *us);
+
+/**
+ * @brief Number of STOP periods entered.
+ */
+uint32_t Power_GetStopCount(void);
+
+/**
+ * @brief Total time spent in STOP, in milliseconds.
+ */
+uint32_t Power_GetStopTimeMs(void);
+
+/**
+ * @brief RTC wakeup handler; called from RTC_WKUP_IRQHandler().
+ */
+void Power_WakeupIRQHandler(void);
+
+/**
+ * @brief RX line wake handler; called from HAL_GPIO_EXTI_Callback().
+ */
+void Power_RxWakeCallback(void);
+
+#endif /* POWER_H_ */
@@ -0,0 +1,57 @@
+/**
+ ******************************************************************************
+ * @file           : ramfunc.h
+ * @brief          : Placement of the timing-critical code in SRAM.
+ *
+ *                   At 180 MHz the flash needs 5 wait states. The ART
+ *                   accelerator hides them on a hit, but a miss in a
+ *                   cycle-counted loop stretches it by several cycles, and
+ *                   whether it misses depends on what ran before. The
+ *                   bit-banged DHT11 path therefore runs from SRAM:
+ *                   delay_us(), the DWT delay and scale, the level waits
+ *                   and the bit/width decoders are marked RAMFUNC. The pin
+ *                   accessors are forced inline into them (RAMFUNC_INLINE),
+ *                   so none of the loop executes from flash even at -O0.
+ *
+ *                   RAMFUNC places a function in the .RamFunc input
+ *                   section, which the linker scripts collect into .data
+ *                   between _sramfunc and _eramfunc. The startup code's
+ *                   .data copy loads it, so nothing else is needed at boot.
+ *                   Calls across the flash/SRAM gap go through veneers the
+ *                   linker inserts. Functions are kept out of line so a
+ *                   caller in flash still runs the SRAM copy.
+ *
+ *                   With RAMFUNC_REPORT set, Ramfunc_Report() prints at
+ *                   boot where each marked function ended up.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef RAMFUNC_H_
+#define RAMFUNC_H_
+
+/* Set to 0 to leave the hot paths in flash, e.g. to compare the jitter */
+#define RAMFUNC_ENABLE (1)
+
+/* Set to 1 to print the placement of the RAMFUNC functions at boot */
+#define RAMFUNC_REPORT (0)
+
+#if RAMFUNC_ENABLE && defined(__arm__)
+#define RAMFUNC        __attribute__((section(".RamFunc"), noinline))
+#else
+#define RAMFUNC
+#endif /* RAMFUNC_ENABLE && __arm__ */
+
+/** Small accessor that must be inlined into its (SRAM) caller */
+#define RAMFUNC_INLINE static inline __attribute__((always_inline))
+
+/**
+ * @brief Prints one line per RAMFUNC function with its address and
+ *        region, and the size of the SRAM code. Only with RAMFUNC_REPORT.
+ */
+void Ramfunc_Report(void);
+
+#endif /* RAMFUNC_H_ */
@@ -0,0 +1,197 @@
+/**
+ ******************************************************************************
+ * @file           : rs485_gw.h
+ * @brief          : RS-485 gateway: polls downstream boards as a Modbus RTU
+ *                   master on USART3 and forwards their readings upstream.
+ *
+ *                   With RS485_USE_GATEWAY this board is the head of a
+ *                   daisy chain. Each downstream board runs the normal
+ *                   firmware with MODBUS_USE_RTU (modbus.h) at its own
+ *                   slave address, RS485_GW_FIRST_ADDRESS and up. Every
+ *                   RS485_GW_PERIOD_MS the gateway runs one round: a
+ *                   read input registers request (04) to each node for
+ *                   the RS485_GW_SENSORS sensor blocks of its map.
+ *
+ *                   A round runs in interrupts once started, so the main
+ *                   loop only kicks it off and drains it:
+ *                     - the request goes out on USART3 TX DMA (DMA1
+ *                       Stream3) with the transceiver's driver enable on
+ *                       PC12 high;
+ *                     - the USART transmission complete interrupt drops
+ *                       DE after the last stop bit, no earlier, and arms
+ *                       RX DMA (DMA1 Stream1) for the whole reply;
+ *                     - an IDLE line with the reply (or an exception)
+ *                       complete ends the poll; TIM12, one-pulse, ends it
+ *                       as a timeout after the node's RS485_GW_TIMEOUT_MS;
+ *                     - TIM12 then waits out the t3.5 silence and starts
+ *                       the next node.
+ *                   A node that missed RS485_GW_DOWN_AFTER polls in a row
+ *                   is down and polled only every RS485_GW_DOWN_RETRY
+ *                   rounds, so dead nodes do not stretch every round.
+ *
+ *                   At the end of a round Rs485_Gw_Poll() sends what it
+ *                   learned on the console transport (uart_tx.h: USART2
+ *                   or USB CDC): one record per sensor whose reading
+ *                   counter moved since the last round, one per node that
+ *                   did not answer properly. The text format prints a
+ *                   line per record; the binary formats send them as
+ *                   gateway packets (0x0D, telemetry_frames.h), up to
+ *                   TELEMETRY_GATEWAY_MAX records per frame and DMA
+ *                   transfer; NONE drops them.
+ *
+ *                   USART3 on PC10 (TX), PC11 (RX), AF7, at RS485_GW_BAUD
+ *                   8N1: match the nodes (uart_baud.h). STOP mode is held
+ *                   off while the gateway runs.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef RS485_GW_H_
+#define RS485_GW_H_
+
+#include "main.h"
+#include "dht11_emu.h"
+
+/* Set to 1 to poll downstream Modbus boards on USART3 */
+#define RS485_USE_GATEWAY (0)
+
+/** Line rate; the nodes' uart_baud.h default */
+#define RS485_GW_BAUD            (115200U)
+
+/** Slave address of the first node; the others follow */
+#define RS485_GW_FIRST_ADDRESS   (1U)
+
+/** Nodes polled after reset, and the most the table holds */
+#define RS485_GW_NODES           (8U)
+#define RS485_GW_NODES_MAX       (32U)
+
+/** Sensor blocks read from each node (modbus.h, 8 registers each) */
+#define RS485_GW_SENSORS         (1U)
+
+/** Round start to round start */
+#define RS485_GW_PERIOD_MS       (2000U)
+
+/** Request sent to reply complete, per node; 1-1000 */
+#define RS485_GW_TIMEOUT_MS      (20U)
+
+/** Missed polls in a row that mark a node down, and its retry rounds */
+#define RS485_GW_DOWN_AFTER      (3U)
+#define RS485_GW_DOWN_RETRY      (10U)
+
+#if RS485_USE_GATEWAY && DHT11_EMU_USE_LOOPBACK
+#error "The DHT11 emulator owns DMA1 Stream1: set RS485_USE_GATEWAY to 0"
+#endif
+
+#if RS485_USE_GATEWAY
+#define RS485_GW_IS_ACTIVE()     (1U)
+#else
+#define RS485_GW_IS_ACTIVE()     (0U)
+#endif /* RS485_USE_GATEWAY */
+
+/**
+ * @brief Outcome of a node's last poll.
+ */
+typedef enum {
+	RS485_GW_LINK_OK = 0,
+	RS485_GW_LINK_TIMEOUT,    /*!< No complete reply in time     */
+	RS485_GW_LINK_CRC,        /*!< Reply damaged or malformed    */
+	RS485_GW_LINK_EXCEPTION,  /*!< The node refused the request  */
+	RS485_GW_LINK_NONE        /*!< Not polled yet                */
+} rs485_gw_link_t;
+
+/**
+ * @brief Per-node counters.
+ */
+typedef struct {
+	uint8_t address;
+	uint8_t link;            /*!< rs485_gw_link_t of the last poll */
+	uint8_t down;            /*!< Polled every RS485_GW_DOWN_RETRY rounds */
+	uint32_t polls;
+	uint32_t timeouts;
+	uint32_t errors;         /*!< CRC and exception replies        */
+} rs485_gw_node_t;
+
+/**
+ * @brief Gateway counters.
+ */
+typedef struct {
+	uint32_t rounds;
+	uint32_t polls;
+	uint32_t timeouts;
+	uint32_t crc_errors;
+	uint32_t exceptions;
+	uint32_t records;        /*!< Sent upstream                    */
+	uint32_t overruns;       /*!< Periods lost to a long round */
+} rs485_gw_stats_t;
+
+#if RS485_USE_GATEWAY
+
+/**
+ * @brief Claims USART3, PC10-PC12, DMA1 Streams 1 and 3 and TIM12. Call
+ *        after UART_TX_Init().
+ */
+void Rs485_Gw_Init(void);
+
+/**
+ * @brief Forwards a finished round and starts the next one when due.
+ *        Call from the CLI poll loop.
+ */
+void Rs485_Gw_Poll(void);
+
+/**
+ * @brief Sets the nodes polled, 1 to RS485_GW_NODES_MAX.
+ * @retval 1 if accepted.
+ */
+uint8_t Rs485_Gw_SetNodes(uint32_t nodes);
+
+/**
+ * @brief Sets the round period and the per-node timeout, in ms.
+ * @retval 1 if accepted.
+ */
+uint8_t Rs485_Gw_SetPeriod(uint32_t period_ms);
+uint8_t Rs485_Gw_SetTimeout(uint32_t timeout_ms);
+
+/**
+ * @brief Settings now.
+ */
+uint32_t Rs485_Gw_GetNodes(void);
+uint32_t Rs485_Gw_GetPeriod(void);
+uint32_t Rs485_Gw_GetTimeout(void);
+
+/**
+ * @brief Copies the counters of one node, 0 to Rs485_Gw_GetNodes() - 1.
+ */
+void Rs485_Gw_GetNode(uint32_t index, rs485_gw_node_t *node);
+
+/**
+ * @brief Short printable name of a link state.
+ */
+const char* Rs485_Gw_LinkName(rs485_gw_link_t link);
+
+/**
+ * @brief Copies the gateway counters.
+ */
+void Rs485_Gw_GetStats(rs485_gw_stats_t *stats);
+
+/**
+ * @brief Recomputes the USART3 rate and the TIM12 prescaler after a clock
+ *        profile change.
+ */
+void Rs485_Gw_ClockChanged(void);
+
+/**
+ * @brief USART3 interrupt: transmission complete, IDLE line.
+ */
+void Rs485_Gw_UartIRQHandler(void);
+
+/**
+ * @brief TIM12 expiry: reply timeout or end of the turnaround gap.
+ */
+void Rs485_Gw_TimerIRQHandler(void);
+
+#endif /* RS485_USE_GATEWAY */
+
+#endif /* RS485_GW_H_ */
@@ -0,0 +1,114 @@
+/**
+ ******************************************************************************
+ * @file           : sched.h
+ * @brief          : Cooperative run-to-completion scheduler.
+ *
+ *                   Two kinds of task, both run from Sched_Run() in thread
+ *                   context and never preempt each other:
+ *                     - timer tasks are kept in a binary min-heap ordered
+ *                       by deadline (HAL tick, wrap-safe). A due task runs
+ *                       once and returns the delay until its next run, or
+ *                       SCHED_STOP to park until Sched_Wake();
+ *                     - poll tasks run on every pass of the loop, i.e.
+ *                       after each wake-up. They drain rings that
+ *                       interrupts fill (UART RX, async DHT11 results) and
+ *                       return nonzero when they want another pass before
+ *                       the CPU sleeps.
+ *
+ *                   When nothing is due, the loop sleeps through
+ *                   Power_Sleep() until the earliest deadline, or less if
+ *                   the idle hook (Sched_SetIdle()) asks for it. Any
+ *                   interrupt ends the sleep; the SysTick hook
+ *                   Sched_TickHandler() accounts the idle time for
+ *                   Sched_GetIdlePercent(), or, without the tick
+ *                   (tickless.h), TIM5 times each sleep.
+ *
+ *                   A task that blocks delays every other task; keep
+ *                   work per run short and split long jobs. Per-task run
+ *                   time, lateness and CPU share (perf.h) are recorded for
+ *                   Sched_Dump().
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef SCHED_H_
+#define SCHED_H_
+
+#include "main.h"
+
+/** Task slots, timer and poll tasks together */
+#define SCHED_MAX_TASKS  (10U)
+
+/** Timer task return value: park the task */
+#define SCHED_STOP       (0xFFFFFFFFU)
+
+/** Returned by Sched_Add*() when all slots are used */
+#define SCHED_NO_TASK    (0xFFU)
+
+/**
+ * @brief Timer task body.
+ * @retval Milliseconds from now until the next run, or SCHED_STOP.
+ */
+typedef uint32_t (*sched_timer_fn_t)(void);
+
+/**
+ * @brief Poll task body.
+ * @retval Nonzero if work remains and the loop should not sleep yet.
+ */
+typedef uint32_t (*sched_poll_fn_t)(void);
+
+/**
+ * @brief Adds a timer task.
+ * @param delay_ms: Time until its first run.
+ * @retval Task id, or SCHED_NO_TASK.
+ */
+uint8_t Sched_AddTimer(const char *name, sched_timer_fn_t fn, uint32_t delay_ms);
+
+/**
+ * @brief Adds a poll task.
+ * @retval Task id, or SCHED_NO_TASK.
+ */
+uint8_t Sched_AddPoll(const char *name, sched_poll_fn_t fn);
+
+/**
+ * @brief (Re)schedules a timer task, parked or not. Thread context only.
+ */
+void Sched_Wake(uint8_t id, uint32_t delay_ms);
+
+/**
+ * @brief Installs the idle hook of a driver with its own timebase.
+ * @param budget_us: Longest sleep the driver allows, 0 for none.
+ * @param advance: Receives the time spent in STOP (timers frozen).
+ */
+void Sched_SetIdle(uint32_t (*budget_us)(void), void (*advance)(uint32_t us));
+
+/**
+ * @brief Runs the tasks forever.
+ */
+void Sched_Run(void);
+
+/**
+ * @brief Idle accounting; called from SysTick_Handler().
+ */
+void Sched_TickHandler(void);
+
+/**
+ * @brief Share of time spent sleeping since boot, 0-100.
+ */
+uint32_t Sched_GetIdlePercent(void);
+
+/**
+ * @brief Prints one line per task: runs, longest run, worst lateness and
+ *        share of the perf.h window.
+ */
+void Sched_Dump(void);
+
+/**
+ * @brief Clears the per-task run time; called by Perf_Reset().
+ */
+void Sched_ResetLoad(void);
+
+#endif /* SCHED_H_ */
@@ -0,0 +1,93 @@
+/**
+ ******************************************************************************
+ * @file           : seqlock.h
+ * @brief          : Header-only latest-value publication: a sequence count
+ *                   over two copies (seqlock in its latch form).
+ *
+ *                   SEQLOCK_DEFINE() generates a type holding one value of
+ *                   elem_type and its static inline functions. One writer
+ *                   publishes, any number of readers take consistent
+ *                   copies; nobody masks interrupts or blocks.
+ *
+ *                   The count is odd while copy 0 is being written and even
+ *                   while copy 1 is, and readers copy the other one, then
+ *                   check that the count did not move. A reader interrupted
+ *                   by the writer retries; a reader that interrupts the
+ *                   writer (a higher-priority handler) finds its copy
+ *                   complete and the count still, so succeeds at once with
+ *                   the previous value instead of spinning on a writer that
+ *                   cannot run. A retry therefore only happens when a
+ *                   publication completed during the read.
+ *
+ *                   On the single-core Cortex-M4 an aligned 32-bit store is
+ *                   atomic; DMBs order the count against the copies. The
+ *                   writer may be an interrupt handler, a task or the main
+ *                   loop, as long as there is exactly one per instance.
+ *
+ *                   Example:
+ *                     SEQLOCK_DEFINE(latest_t, Latest, dht11_reading_t)
+ *                     static latest_t latest;   (zeroed = never written)
+ *                     ISR:  Latest_Write(&latest, &reading);
+ *                     loop: if (Latest_Read(&latest, &copy) != 0U) {...}
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef SEQLOCK_H_
+#define SEQLOCK_H_
+
+#include "main.h"
+
+/**
+ * @brief Defines type type_name and functions prefix_Init, _Write, _Read and
+ *        _Version for one value of elem_type.
+ */
+#define SEQLOCK_DEFINE(type_name, prefix, elem_type)                        \
+	typedef struct {                                                       \
+		volatile uint32_t seq;  /*!< Two per publication, writer only   */ \
+		elem_type buf[2];                                                  \
+	} type_name;                                                           \
+	                                                                       \
+	/** Forgets the value; only while nobody reads or writes. */          \
+	static inline void prefix##_Init(type_name *s) {                      \
+		s->seq = 0U;                                                       \
+	}                                                                      \
+	                                                                       \
+	/** Writer: publishes item; readers see the old value until then. */  \
+	static inline void prefix##_Write(type_name *s,                       \
+			const elem_type *item) {                                       \
+		uint32_t seq = s->seq;                                             \
+		                                                                   \
+		s->seq = seq + 1U;  /* Odd: readers move to copy 1 */              \
+		__DMB();                                                           \
+		s->buf[0] = *item;                                                 \
+		__DMB();                                                           \
+		s->seq = seq + 2U;  /* Even: readers move to copy 0 */             \
+		__DMB();                                                           \
+		s->buf[1] = *item;                                                 \
+	}                                                                      \
+	                                                                       \
+	/** Reader: copies the latest complete value out.                     \
+	 * Returns its publication number, 0 if nothing was published. */    \
+	static inline uint32_t prefix##_Read(const type_name *s,              \
+			elem_type *item) {                                             \
+		uint32_t seq;                                                      \
+		                                                                   \
+		do {                                                               \
+			seq = s->seq;                                                  \
+			__DMB(); /* Copy read after the count that selects it */       \
+			*item = s->buf[seq & 1U];                                      \
+			__DMB(); /* Copy complete before the count is checked */       \
+		} while (seq != s->seq);                                           \
+		return seq >> 1;                                                   \
+	}                                                                      \
+	                                                                       \
+	/** Either side: publication number of the latest complete value. */ \
+	static inline uint32_t prefix##_Version(const type_name *s) {         \
+		return s->seq >> 1;                                                \
+	}
+
+#endif /* SEQLOCK_H_ */
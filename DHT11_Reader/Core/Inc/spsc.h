@@ -0,0 +1,96 @@
+/**
+ ******************************************************************************
+ * @file           : spsc.h
+ * @brief          : Header-only lock-free single-producer/single-consumer
+ *                   ring.
+ *
+ *                   SPSC_DEFINE() generates a fixed-capacity ring type and
+ *                   its static inline functions for one element type. The
+ *                   head index is written only by the producer, the tail
+ *                   only by the consumer; both run free and are masked
+ *                   with the power-of-two capacity, so the fill level is
+ *                   head - tail even across wraps and every slot is usable.
+ *
+ *                   No interrupt masking and no LDREX/STREX are needed: on
+ *                   the single-core Cortex-M4 an aligned 32-bit store is
+ *                   atomic, and a DMB between the element copy and the
+ *                   index update orders them for the other side. Either
+ *                   side may be an interrupt handler, a task or the main
+ *                   loop, as long as there is exactly one of each.
+ *
+ *                   Example:
+ *                     SPSC_DEFINE(rx_ring_t, RxRing, uint8_t, 64U)
+ *                     static rx_ring_t ring;   (zeroed = empty)
+ *                     ISR:  (void) RxRing_Push(&ring, &byte);
+ *                     loop: while (RxRing_Pop(&ring, &byte) != 0U) {...}
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef SPSC_H_
+#define SPSC_H_
+
+#include "main.h"
+
+/**
+ * @brief Defines ring type type_name and functions prefix_Init, _Push,
+ *        _Pop, _Count and _Free for elements of elem_type.
+ * @param len: Capacity, a power of two.
+ */
+#define SPSC_DEFINE(type_name, prefix, elem_type, len)                      \
+	_Static_assert(((len) != 0U) && (((len) & ((len) - 1U)) == 0U),       \
+			#type_name " capacity must be a power of two");               \
+	typedef struct {                                                       \
+		volatile uint32_t head; /*!< Next slot to write, producer only */ \
+		volatile uint32_t tail; /*!< Next slot to read, consumer only  */ \
+		elem_type buf[len];                                                \
+	} type_name;                                                           \
+	                                                                       \
+	/** Empties the ring; only while neither side is active. */           \
+	static inline void prefix##_Init(type_name *q) {                      \
+		q->head = 0U;                                                      \
+		q->tail = 0U;                                                      \
+	}                                                                      \
+	                                                                       \
+	/** Producer: copies item in. Returns 0 if the ring is full. */       \
+	static inline uint8_t prefix##_Push(type_name *q,                     \
+			const elem_type *item) {                                       \
+		uint32_t head = q->head;                                           \
+		                                                                   \
+		if ((head - q->tail) >= (len)) {                                   \
+			return 0U;                                                     \
+		}                                                                  \
+		q->buf[head & ((len) - 1U)] = *item;                               \
+		__DMB(); /* Element stored before it is published */               \
+		q->head = head + 1U;                                               \
+		return 1U;                                                         \
+	}                                                                      \
+	                                                                       \
+	/** Consumer: copies the oldest item out. Returns 0 if empty. */      \
+	static inline uint8_t prefix##_Pop(type_name *q, elem_type *item) {   \
+		uint32_t tail = q->tail;                                           \
+		                                                                   \
+		if (tail == q->head) {                                             \
+			return 0U;                                                     \
+		}                                                                  \
+		__DMB(); /* Element read after the head that published it */       \
+		*item = q->buf[tail & ((len) - 1U)];                               \
+		__DMB(); /* Element copied before its slot is released */          \
+		q->tail = tail + 1U;                                               \
+		return 1U;                                                         \
+	}                                                                      \
+	                                                                       \
+	/** Either side: elements queued (a snapshot). */                     \
+	static inline uint32_t prefix##_Count(const type_name *q) {           \
+		return q->head - q->tail;                                          \
+	}                                                                      \
+	                                                                       \
+	/** Either side: free slots (a snapshot). */                          \
+	static inline uint32_t prefix##_Free(const type_name *q) {            \
+		return (len) - (q->head - q->tail);                                \
+	}
+
+#endif /* SPSC_H_ */
@@ -0,0 +1,144 @@
+/**
+ ******************************************************************************
+ * @file           : status_led.h
+ * @brief          : LD2 status patterns on TIM2 PWM, off the reading path.
+ *
+ *                   LD2 (PA5) is TIM2_CH1 (AF1). Each state has a pattern
+ *                   of segments, each one or more PWM periods at a level
+ *                   that holds or ramps:
+ *                     OK         slow breathing, 3 s;
+ *                     RETRYING   double blink every 1.5 s (a sensor is
+ *                                DHT11_HEALTH_DEGRADED);
+ *                     LINK_DOWN  one short flash every 2 s (the TX ring is
+ *                                stalled, uart_tx.h);
+ *                     FAULT      5 Hz blink (a sensor is
+ *                                DHT11_HEALTH_FAILED).
+ *                   The worst of the sensors' states and the link's shows;
+ *                   a sensor fault outranks the link.
+ *                   Status_Led_Update() runs once per emitted reading and
+ *                   reprograms the timer only when that state changes;
+ *                   the pattern then runs on its own. The TIM2 update
+ *                   interrupt (lowest priority) steps to the next segment:
+ *                   a few times per second for the blinks, every 10 ms
+ *                   while breathing.
+ *
+ *                   STOP halts TIM2: LD2 goes dark for the stop and the
+ *                   pattern restarts on wake. With STATUS_LED_HOLD_STOP a
+ *                   state other than OK keeps the node out of STOP
+ *                   (power.h), so a fault shows in the field at the cost
+ *                   of WFI sleep instead.
+ *
+ *                   The DHT11 emulator (dht11_emu.h) owns TIM2; builds
+ *                   with it, or with STATUS_LED_USE_PWM at 0, toggle LD2
+ *                   on every good reading as before.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef STATUS_LED_H_
+#define STATUS_LED_H_
+
+#include "main.h"
+#include "dht11.h"
+#include "dht11_emu.h"
+
+/* Set to 0 to toggle LD2 on good readings instead of running patterns */
+#define STATUS_LED_USE_PWM (1)
+
+/* Set to 0 to let STOP dim a fault pattern like the OK one */
+#define STATUS_LED_HOLD_STOP (1)
+
+/** TIM2 count rate: 0.1 ms ticks */
+#define STATUS_LED_TIM_HZ   (10000U)
+
+/** Sensors tracked; matches the 8-channel reader */
+#define STATUS_LED_SENSORS  (8U)
+
+#if STATUS_LED_USE_PWM && DHT11_EMU_USE_LOOPBACK
+#error "The DHT11 emulator owns TIM2: set STATUS_LED_USE_PWM to 0"
+#endif
+
+/**
+ * @brief What LD2 shows, mildest first.
+ */
+typedef enum {
+	STATUS_LED_OK = 0,
+	STATUS_LED_RETRYING,
+	STATUS_LED_LINK_DOWN,
+	STATUS_LED_FAULT,
+	STATUS_LED_STATES
+} status_led_state_t;
+
+#if STATUS_LED_USE_PWM
+#define STATUS_LED_STOP_BEGIN()  Status_Led_StopBegin()
+#define STATUS_LED_STOP_END()    Status_Led_StopEnd()
+#define STATUS_LED_HOLDS_STOP()  Status_Led_HoldsStop()
+#else
+#define STATUS_LED_STOP_BEGIN()  ((void) 0)
+#define STATUS_LED_STOP_END()    ((void) 0)
+#define STATUS_LED_HOLDS_STOP()  (0U)
+#endif /* STATUS_LED_USE_PWM */
+
+/**
+ * @brief Claims PA5 and TIM2 and starts the OK pattern. Call after
+ *        MX_GPIO_Init().
+ */
+void Status_Led_Init(void);
+
+/**
+ * @brief Takes one emitted reading's sensor health and the link state;
+ *        changes the pattern only when the shown state changes. Without
+ *        STATUS_LED_USE_PWM, toggles LD2 on a good reading.
+ */
+void Status_Led_Update(const dht11_reading_t *reading);
+
+/**
+ * @brief Shows one state whatever the readings say, to check the
+ *        patterns; STATUS_LED_STATES returns to the readings.
+ */
+void Status_Led_Force(status_led_state_t state);
+
+/**
+ * @brief State shown now.
+ */
+status_led_state_t Status_Led_Get(void);
+
+/**
+ * @brief Reports whether a state is being forced.
+ */
+uint8_t Status_Led_IsForced(void);
+
+/**
+ * @brief Short printable name of a state.
+ */
+const char* Status_Led_Name(status_led_state_t state);
+
+/**
+ * @brief Darkens LD2 before STOP; Power_Stop() calls it.
+ */
+void Status_Led_StopBegin(void);
+
+/**
+ * @brief Restarts the pattern after STOP.
+ */
+void Status_Led_StopEnd(void);
+
+/**
+ * @brief Reports whether the shown state keeps the node out of STOP.
+ */
+uint8_t Status_Led_HoldsStop(void);
+
+/**
+ * @brief Recomputes the TIM2 prescaler after a clock profile change.
+ */
+void Status_Led_ClockChanged(void);
+
+/**
+ * @brief TIM2 update: loads the next period. Called from TIM2_IRQHandler().
+ */
+void Status_Led_IRQHandler(void);
+
+#endif /* STATUS_LED_H_ */
@@ -55,7 +55,34 @@ void SVC_Handler(void);
 void DebugMon_Handler(void);
 void PendSV_Handler(void);
 void SysTick_Handler(void);
+void RTC_WKUP_IRQHandler(void);
+void EXTI1_IRQHandler(void);
+void EXTI3_IRQHandler(void);
+void DMA1_Stream4_IRQHandler(void);
+void DMA1_Stream5_IRQHandler(void);
+void DMA1_Stream6_IRQHandler(void);
+void USART2_IRQHandler(void);
+void TIM5_IRQHandler(void);
+void TIM6_DAC_IRQHandler(void);
+void DMA2_Stream5_IRQHandler(void);
 /* USER CODE BEGIN EFP */
+void OTG_FS_IRQHandler(void);
+void CAN1_TX_IRQHandler(void);
+void CAN1_RX0_IRQHandler(void);
+void CAN1_SCE_IRQHandler(void);
+void I2C1_EV_IRQHandler(void);
+void I2C1_ER_IRQHandler(void);
+void DMA1_Stream7_IRQHandler(void);
+void TIM4_IRQHandler(void);
+void EXTI15_10_IRQHandler(void);
+void DMA1_Stream1_IRQHandler(void);
+void EXTI0_IRQHandler(void);
+void EXTI9_5_IRQHandler(void);
+void TIM2_IRQHandler(void);
+void ADC_IRQHandler(void);
+void USART3_IRQHandler(void);
+void TIM8_BRK_TIM12_IRQHandler(void);
+void TIM1_TRG_COM_TIM11_IRQHandler(void);
 
 /* USER CODE END EFP */
 
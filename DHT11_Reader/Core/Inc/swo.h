@@ -0,0 +1,120 @@
+/**
+ ******************************************************************************
+ * @file           : swo.h
+ * @brief          : ITM trace output over the SWO pin (PB3), for telemetry
+ *                   and timing events that must not disturb the DHT11.
+ *
+ *                   A stimulus port write is one store into the ITM FIFO;
+ *                   the TPIU shifts it out on SWO in NRZ (UART) format at
+ *                   SWO_BAUD, independently of the CPU. Writing a 32-bit
+ *                   event costs a few cycles, against ~90 us per byte on
+ *                   USART2 at 115200 baud, so it can run inside the bit
+ *                   loop without moving the measured widths. Ports:
+ *                     - SWO_PORT_LOG:     printf text (SWO_USE_PRINTF);
+ *                     - SWO_PORT_READING: every reading before filtering,
+ *                       as the COBS frame of Telemetry_EncodeReading()
+ *                       (Docs/telemetry.md), whatever the active sink;
+ *                     - SWO_PORT_EVENT:   one 32-bit word per event, the
+ *                       id in bits 31..24 and the value in bits 23..0;
+ *                       the profiler (dht11_prof.h) sends every phase,
+ *                       bit and result.
+ *                   Local timestamp packets are enabled, so the host sees
+ *                   when each event happened without a timestamp in the
+ *                   payload.
+ *
+ *                   Optional hardware trace on the same pin:
+ *                     - SWO_USE_PC_SAMPLING: a DWT PC sample every
+ *                       SWO_PC_SAMPLE_CYCLES, a statistical profile;
+ *                     - SWO_USE_EXC_TRACE: exception entry, exit and
+ *                       return packets, to see interrupt latency.
+ *
+ *                   The baud divider follows HCLK and is recomputed by
+ *                   Swo_ClockChanged() on a profile switch (HCLK must stay
+ *                   a multiple of SWO_BAUD). A port write waits while the
+ *                   FIFO is full, at most one character time, and is
+ *                   skipped while the port is disabled in ITM TER, which
+ *                   the debugger may rewrite to pick the traced ports.
+ *
+ *                   Call Swo_Init() after Timebase_Init() (DWT).
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef SWO_H_
+#define SWO_H_
+
+#include "main.h"
+#include "dht11.h"
+
+/* Set to 1 to build the ITM trace output on SWO (PB3) */
+#define SWO_USE_ITM          (0)
+
+/* Set to 1 to send printf text to SWO_PORT_LOG instead of USART2 */
+#define SWO_USE_PRINTF       (0)
+
+/* Set to 1 to enable periodic DWT PC sampling */
+#define SWO_USE_PC_SAMPLING  (0)
+
+/* Set to 1 to enable exception entry/exit tracing */
+#define SWO_USE_EXC_TRACE    (0)
+
+/** SWO bit rate; a divisor of 16, 50 and 180 MHz HCLK */
+#define SWO_BAUD             (2000000U)
+
+/** Stimulus ports */
+#define SWO_PORT_LOG         (0U)
+#define SWO_PORT_READING     (1U)
+#define SWO_PORT_EVENT       (2U)
+
+/** Event ids, bits 31..24 of a SWO_PORT_EVENT word */
+#define SWO_EVENT_PHASE      (0x01U)  /*!< phase<<16 | duration_us         */
+#define SWO_EVENT_BIT        (0x02U)  /*!< index<<16 | value<<15 | width_us */
+#define SWO_EVENT_RESULT     (0x03U)  /*!< dht11_status_t                  */
+
+/** PC sample period: 16 x 1024 cycles, ~11 kHz at 180 MHz */
+#define SWO_PC_SAMPLE_CYCLES (16U * 1024U)
+
+#if SWO_USE_ITM
+#define SWO_EVENT(id, value)  Swo_Event((id), (value))
+#define SWO_READING(reading)  Swo_Reading(reading)
+#else
+#define SWO_EVENT(id, value)  ((void) 0)
+#define SWO_READING(reading)  ((void) 0)
+#endif /* SWO_USE_ITM */
+
+/**
+ * @brief Routes TRACESWO to PB3, sets the TPIU to NRZ at SWO_BAUD and
+ *        enables the ITM ports, PC sampling and exception tracing.
+ */
+void Swo_Init(void);
+
+/**
+ * @brief Recomputes the SWO baud divider from the current HCLK.
+ */
+void Swo_ClockChanged(void);
+
+/**
+ * @brief Writes bytes to a stimulus port, 32 bits at a time.
+ */
+void Swo_Write(uint32_t port, const uint8_t *data, uint32_t len);
+
+/**
+ * @brief Writes one character to SWO_PORT_LOG.
+ */
+void Swo_PutChar(uint8_t ch);
+
+/**
+ * @brief Writes one event word to SWO_PORT_EVENT.
+ * @param value: Low 24 bits are sent.
+ */
+void Swo_Event(uint32_t id, uint32_t value);
+
+/**
+ * @brief Writes a reading as a telemetry frame to SWO_PORT_READING.
+ */
+void Swo_Reading(const dht11_reading_t *reading);
+
+#endif /* SWO_H_ */
@@ -0,0 +1,89 @@
+/**
+ ******************************************************************************
+ * @file           : systime.h
+ * @brief          : System timestamp service on the 32-bit TIM5 counter.
+ *
+ *                   TIM5 already free-runs at 1 MHz for the capture path
+ *                   (dht11_capture.h) and is kept there across clock
+ *                   profile switches. This module makes that count the
+ *                   one timestamp of the firmware:
+ *                     - SysTime_Now() is a single register read, usable
+ *                       from any interrupt or DMA completion handler, and
+ *                       is the same clock the capture DMA stamps edges on;
+ *                     - SysTime_Now64() extends it with the overflow count
+ *                       kept by the TIM5 update interrupt (every 71.6 min),
+ *                       monotonic for the life of the node.
+ *
+ *                   Unlike DWT CYCCNT it does not depend on the debug
+ *                   block, does not wrap every 24 s at 180 MHz and does
+ *                   not change rate with HCLK. Unlike HAL_GetTick() it
+ *                   resolves microseconds.
+ *
+ *                   STOP freezes TIM5; Power_Stop() hands the measured
+ *                   stop time back through SysTime_Advance(), so the count
+ *                   keeps up with real time. The update request source is
+ *                   set to overflow only, so the UG of a clock switch does
+ *                   not count as a wrap.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef SYSTIME_H_
+#define SYSTIME_H_
+
+#include "main.h"
+#include "ramfunc.h"
+
+/** Counter behind the service, shared with the capture path */
+#define SYSTIME_TIM      (TIM5)
+
+/** Count rate; equals DHT11_CAPTURE_TICK_HZ */
+#define SYSTIME_HZ       (1000000U)
+
+/**
+ * @brief Enables the TIM5 overflow interrupt. Call after
+ *        DHT11_Capture_Init() has started the counter.
+ */
+void SysTime_Init(void);
+
+/**
+ * @brief Microseconds, low 32 bits; wraps every 71.6 min, so differences
+ *        of unsigned values are exact up to that.
+ */
+RAMFUNC_INLINE uint32_t SysTime_Now(void) {
+	return SYSTIME_TIM->CNT;
+}
+
+/**
+ * @brief Microseconds elapsed since a SysTime_Now() value.
+ */
+RAMFUNC_INLINE uint32_t SysTime_Since(uint32_t since) {
+	return SYSTIME_TIM->CNT - since;
+}
+
+/**
+ * @brief Monotonic microseconds since TIM5 started. Safe from any context.
+ */
+uint64_t SysTime_Now64(void);
+
+/**
+ * @brief Moves the count forward by time TIM5 spent frozen, carrying a
+ *        wrap into the high word.
+ * @param us: Microseconds to add.
+ */
+void SysTime_Advance(uint32_t us);
+
+/**
+ * @brief Overflows counted so far, the high word of SysTime_Now64().
+ */
+uint32_t SysTime_GetWraps(void);
+
+/**
+ * @brief TIM5 update handler; called from HAL_TIM_PeriodElapsedCallback().
+ */
+void SysTime_OverflowCallback(void);
+
+#endif /* SYSTIME_H_ */
@@ -0,0 +1,160 @@
+/**
+ ******************************************************************************
+ * @file           : telemetry.h
+ * @brief          : Compact binary telemetry frames over USART2.
+ *
+ *                   Each reading is sent as one COBS-encoded packet followed
+ *                   by a 0x00 delimiter (19 bytes on the wire, ~1.6 ms at
+ *                   115200 baud, against ~50 bytes for the ASCII line).
+ *
+ *                   Packet body before COBS, little-endian:
+ *                     off len field
+ *                       0   1 type (TELEMETRY_TYPE_READING)
+ *                       1   1 sensor_id
+ *                       2   2 sequence number
+ *                       4   4 timestamp_ms
+ *                       8   1 status (dht11_status_t)
+ *                       9   1 retries
+ *                      10   5 raw DHT11 bytes
+ *                      15   2 CRC-16/CCITT-FALSE over bytes 0..14
+ *
+ *                   Telemetry_DeltaSink() sends the same readings through
+ *                   the dht11_delta.h stage instead: a keyframe packet
+ *                   (0x04, 17 bytes on the wire) when needed and every
+ *                   TELEMETRY_DELTA_KEY_EVERY readings, a step packet
+ *                   (0x05, 12 bytes) when a value changed, and nothing for
+ *                   an unchanged reading. Each packet counts the unchanged
+ *                   readings before it. Failed readings still go out as
+ *                   0x01.
+ *
+ *                   Telemetry_BatchSink() collects readings, failed ones
+ *                   included, into one packet (0x08): a shared header with
+ *                   the first reading's timestamp, then 10 bytes per
+ *                   reading with its offset from it in ms. The batch goes
+ *                   out as one frame, one TX DMA transfer, when it holds
+ *                   TELEMETRY_BATCH_MAX readings or its first reading is
+ *                   TELEMETRY_BATCH_MS old, whichever comes first; 16
+ *                   readings take 172 bytes on the wire instead of 304.
+ *
+ *                   Telemetry_SchemaSink() describes the packets once
+ *                   instead of in each one: a schema packet (0x0B, 41
+ *                   bytes on the wire) lists the fields of the compact
+ *                   packets with their encoding, scale and unit, and the
+ *                   kind of every sensor. A compact packet (0x0C, 14 bytes)
+ *                   then carries the schema ID, the sensor, a sequence
+ *                   number and the values alone. The schema is sent
+ *                   before the first reading, when a sensor's type
+ *                   changes (under a new ID), on a transport switch or
+ *                   the USB CDC port opening, and every
+ *                   TELEMETRY_SCHEMA_EVERY readings. Failed readings
+ *                   still go out as 0x01.
+ *
+ *                   Window summaries (dht11_agg.h) go out as one packet
+ *                   each (0x09, 32 bytes on the wire) in any of these
+ *                   formats.
+ *
+ *                   Once the wall clock is synced (wallclock.h), both sinks
+ *                   put a time mark (0x07, 16 bytes on the wire) before the
+ *                   first reading after each sync and every
+ *                   TELEMETRY_TIME_EVERY readings: a HAL tick and the UTC
+ *                   time it stood for, which dates every timestamp_ms.
+ *
+ *                   Packet layouts are in telemetry_frames.h, shared with
+ *                   the host decoder; see Docs/telemetry.md for the spec.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include "main.h"
+#include "dht11.h"
+#include "dht11_agg.h"
+#include "telemetry_frames.h"
+
+/** Readings between time marks */
+#define TELEMETRY_TIME_EVERY     (30U)
+
+/** Batch: held at most this long (TELEMETRY_BATCH_MAX readings) */
+#define TELEMETRY_BATCH_MS       (5000U)
+
+/** Schema stream: readings between schema packets (1 min at 2 s) */
+#define TELEMETRY_SCHEMA_EVERY    (30U)
+
+/** Delta stream: readings between keyframes (1 min at 2 s), sensors */
+#define TELEMETRY_DELTA_KEY_EVERY (30U)
+#define TELEMETRY_DELTA_SENSORS   (8U)
+
+/**
+ * @brief COBS-encodes a buffer and appends the 0x00 delimiter.
+ * @param in: Payload.
+ * @param len: Payload length.
+ * @param out: At least TELEMETRY_COBS_MAX(len) bytes.
+ * @retval Number of bytes written to out.
+ */
+uint32_t Telemetry_CobsEncode(const uint8_t *in, uint32_t len, uint8_t *out);
+
+/**
+ * @brief Builds a complete framed packet for one reading.
+ * @param out: At least TELEMETRY_COBS_MAX(TELEMETRY_READING_LEN) bytes.
+ * @retval Frame length.
+ */
+uint32_t Telemetry_EncodeReading(const dht11_reading_t *reading, uint8_t *out);
+
+/**
+ * @brief dht11_sink_t that sends the reading as a binary frame.
+ */
+void Telemetry_Sink(const dht11_reading_t *reading);
+
+/**
+ * @brief dht11_sink_t that sends keyframes, steps and runs (0x04/0x05).
+ *        Unchanged readings are held back until the next packet of their
+ *        sensor.
+ */
+void Telemetry_DeltaSink(const dht11_reading_t *reading);
+
+/**
+ * @brief Restarts the delta stream; every sensor's next reading is sent
+ *        as a keyframe.
+ */
+void Telemetry_DeltaReset(void);
+
+/**
+ * @brief dht11_sink_t that adds the reading to the pending batch (0x08),
+ *        sending the batch when full.
+ */
+void Telemetry_BatchSink(const dht11_reading_t *reading);
+
+/**
+ * @brief Sends the pending batch now, if any.
+ */
+void Telemetry_BatchFlush(void);
+
+/**
+ * @brief Sends the pending batch once TELEMETRY_BATCH_MS old. Same context
+ *        as the sink.
+ * @retval Milliseconds until it is due, TELEMETRY_BATCH_MS when empty.
+ */
+uint32_t Telemetry_BatchPoll(void);
+
+/**
+ * @brief dht11_sink_t that sends compact packets (0x0C), preceded by the
+ *        schema (0x0B) whenever the host may not hold it.
+ */
+void Telemetry_SchemaSink(const dht11_reading_t *reading);
+
+/**
+ * @brief Sends the schema before the next compact packet.
+ */
+void Telemetry_SchemaReset(void);
+
+/**
+ * @brief Sends a window summary (0x09).
+ */
+void Telemetry_SendSummary(const dht11_agg_summary_t *summary);
+
+#endif /* TELEMETRY_H_ */
@@ -0,0 +1,399 @@
+/**
+ ******************************************************************************
+ * @file           : telemetry_frames.h
+ * @brief          : Wire layout of the binary telemetry packets, shared by
+ *                   the firmware and the host decoder (Tools/telemetry_decode).
+ *
+ *                   Only <stdint.h> is needed, so host code includes this
+ *                   header unchanged. Every packet has a packed struct with
+ *                   the fields at their wire offsets, little-endian; the
+ *                   size checks below tie each struct to the length the
+ *                   firmware frames. A host on a little-endian CPU reads
+ *                   the fields straight from the decoded bytes.
+ *
+ *                   Field meanings and the framing: Docs/telemetry.md.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef TELEMETRY_FRAMES_H_
+#define TELEMETRY_FRAMES_H_
+
+#include <stdint.h>
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__)
+#error "telemetry_frames.h maps little-endian fields onto the CPU's"
+#endif
+
+#define TELEMETRY_PACKED __attribute__((packed))
+
+#ifdef __cplusplus
+#define TELEMETRY_ASSERT static_assert
+#else
+#define TELEMETRY_ASSERT _Static_assert
+#endif
+
+/** Packet types */
+#define TELEMETRY_TYPE_READING   (0x01U)
+#define TELEMETRY_TYPE_HISTORY   (0x02U)  /*!< Batch of history.h records */
+#define TELEMETRY_TYPE_FLASHLOG  (0x03U)  /*!< Chunk of flashlog.h words  */
+#define TELEMETRY_TYPE_DELTA_KEY (0x04U)  /*!< Absolute reading + run     */
+#define TELEMETRY_TYPE_DELTA     (0x05U)  /*!< Step from the last reading */
+#define TELEMETRY_TYPE_PERF      (0x06U)  /*!< CPU load shares, perf.h    */
+#define TELEMETRY_TYPE_TIME      (0x07U)  /*!< HAL tick to UTC mark       */
+#define TELEMETRY_TYPE_BATCH     (0x08U)  /*!< Several readings           */
+#define TELEMETRY_TYPE_SUMMARY   (0x09U)  /*!< Window min/mean/max        */
+#define TELEMETRY_TYPE_TRACE     (0x0AU)  /*!< Raw edges of one frame     */
+#define TELEMETRY_TYPE_SCHEMA    (0x0BU)  /*!< Layout of the 0x0C packets */
+#define TELEMETRY_TYPE_COMPACT   (0x0CU)  /*!< Values laid out by a schema */
+#define TELEMETRY_TYPE_GATEWAY   (0x0DU)  /*!< Readings of RS-485 nodes   */
+
+/** Raw packet length including CRC */
+#define TELEMETRY_READING_LEN    (17U)
+#define TELEMETRY_DELTA_KEY_LEN  (15U)
+#define TELEMETRY_DELTA_LEN      (10U)
+#define TELEMETRY_TIME_LEN       (14U)
+#define TELEMETRY_SUMMARY_LEN    (30U)
+
+/** Batch packet: header, readings, CRC; at most TELEMETRY_BATCH_MAX */
+#define TELEMETRY_BATCH_MAX      (16U)
+#define TELEMETRY_BATCH_HEADER   (8U)
+#define TELEMETRY_BATCH_SAMPLE   (10U)
+#define TELEMETRY_BATCH_LEN(n)   (TELEMETRY_BATCH_HEADER \
+		+ ((n) * TELEMETRY_BATCH_SAMPLE) + 2U)
+
+/** Gateway packet (0x0D): header, records, CRC; at most
+ * TELEMETRY_GATEWAY_MAX */
+#define TELEMETRY_GATEWAY_MAX    (24U)
+#define TELEMETRY_GATEWAY_HEADER (8U)
+#define TELEMETRY_GATEWAY_RECORD (10U)
+#define TELEMETRY_GATEWAY_LEN(n) (TELEMETRY_GATEWAY_HEADER \
+		+ ((n) * TELEMETRY_GATEWAY_RECORD) + 2U)
+/** sensor_id of a node record: status is the link code (rs485_gw.h) */
+#define TELEMETRY_GATEWAY_LINK   (0xFFU)
+
+/** Header and record of the history (0x02), flash log chunk (0x03) and
+ * CPU load (0x06) packets; each ends with the CRC */
+#define TELEMETRY_HISTORY_HEADER  (6U)
+#define TELEMETRY_HISTORY_RECORD  (12U)
+#define TELEMETRY_FLASHLOG_HEADER (9U)
+#define TELEMETRY_PERF_HEADER     (20U)
+
+/** Trace packet (0x0A): header, n edge times, CRC; at most
+ * TELEMETRY_TRACE_MAX edges */
+#define TELEMETRY_TRACE_MAX      (100U)
+#define TELEMETRY_TRACE_HEADER   (11U)
+#define TELEMETRY_TRACE_LEN(n)   (TELEMETRY_TRACE_HEADER + ((n) * 2U) + 2U)
+
+/** Trace flags */
+#define TELEMETRY_TRACE_BOTH     (0x01U)  /*!< Both edges, falling first  */
+#define TELEMETRY_TRACE_RELEASE  (0x02U)  /*!< Times from the release,
+                                               else from the first edge   */
+#define TELEMETRY_TRACE_CUT      (0x04U)  /*!< More edges than were kept  */
+
+/** Schema packet (0x0B): header, field descriptors, sensor entries, CRC */
+#define TELEMETRY_SCHEMA_HEADER   (9U)
+#define TELEMETRY_SCHEMA_FIELD    (4U)
+#define TELEMETRY_SCHEMA_SENSOR   (2U)
+#define TELEMETRY_SCHEMA_LEN(f, s) (TELEMETRY_SCHEMA_HEADER \
+		+ ((f) * TELEMETRY_SCHEMA_FIELD) + ((s) * TELEMETRY_SCHEMA_SENSOR) + 2U)
+
+/** Compact packet (0x0C): header, the schema's values, CRC */
+#define TELEMETRY_COMPACT_HEADER  (4U)
+
+/** Schema field IDs */
+#define TELEMETRY_FIELD_DT       (0x01U)  /*!< Since the last 0x0B/0x0C    */
+#define TELEMETRY_FIELD_TEMP     (0x02U)
+#define TELEMETRY_FIELD_HUM      (0x03U)
+
+/** Field encodings: size in bytes in bits 0..3, bit 7 set if signed */
+#define TELEMETRY_ENC_SIGNED     (0x80U)
+#define TELEMETRY_ENC_SIZE(enc)  ((enc) & 0x0FU)
+#define TELEMETRY_ENC_U8         (0x01U)
+#define TELEMETRY_ENC_I8         (0x81U)
+#define TELEMETRY_ENC_U16        (0x02U)
+#define TELEMETRY_ENC_I16        (0x82U)
+#define TELEMETRY_ENC_U32        (0x04U)
+#define TELEMETRY_ENC_I32        (0x84U)
+
+/** Field units; the value is the wire integer * 10^scale of the unit */
+#define TELEMETRY_UNIT_NONE      (0x00U)
+#define TELEMETRY_UNIT_SECOND    (0x01U)
+#define TELEMETRY_UNIT_CELSIUS   (0x02U)
+#define TELEMETRY_UNIT_RH        (0x03U)  /*!< Percent relative humidity  */
+
+/** Sensor kinds in the schema's sensor entries */
+#define TELEMETRY_SENSOR_DHT11   (0x11U)
+#define TELEMETRY_SENSOR_DHT22   (0x22U)
+
+/** Worst-case COBS output for n payload bytes (+1 overhead, +1 delimiter) */
+#define TELEMETRY_COBS_MAX(n)    ((n) + ((n) / 254U) + 2U)
+
+/** Longest packet body before COBS; sizes a host receive buffer */
+#define TELEMETRY_PKT_MAX        (256U)
+
+/**
+ * @brief 0x01: one reading.
+ */
+typedef struct TELEMETRY_PACKED {
+	uint8_t type;
+	uint8_t sensor_id;
+	uint16_t seq;
+	uint32_t timestamp_ms;
+	uint8_t status;          /*!< dht11_status_t                  */
+	uint8_t retries;
+	uint8_t raw[5];          /*!< Sensor frame, checksum included */
+	uint16_t crc;
+} telemetry_reading_pkt_t;
+
+/**
+ * @brief 0x02 header; n telemetry_history_rec_t and the CRC follow.
+ */
+typedef struct TELEMETRY_PACKED {
+	uint8_t type;
+	uint8_t n;
+	uint32_t first_seq;
+} telemetry_history_hdr_t;
+
+/**
+ * @brief One history.h record, as stored in backup SRAM.
+ */
+typedef struct TELEMETRY_PACKED {
+	uint32_t timestamp_ms;
+	uint16_t boot;
+	uint8_t sensor_id;
+	uint8_t status;
+	uint8_t raw[4];
+} telemetry_history_rec_t;
+
+/**
+ * @brief 0x03 header; n flash log words and the CRC follow.
+ */
+typedef struct TELEMETRY_PACKED {
+	uint8_t type;
+	uint8_t n;
+	uint8_t sector;
+	uint32_t generation;
+	uint16_t offset;         /*!< Word offset in the sector */
+} telemetry_flashlog_hdr_t;
+
+/**
+ * @brief 0x04: delta keyframe.
+ */
+typedef struct TELEMETRY_PACKED {
+	uint8_t type;
+	uint8_t sensor_id;
+	uint16_t seq;
+	uint32_t timestamp_ms;
+	uint8_t run;
+	uint16_t hum;            /*!< Tenths of %RH */
+	int16_t temp;            /*!< Tenths of °C  */
+	uint16_t crc;
+} telemetry_delta_key_pkt_t;
+
+/**
+ * @brief 0x05: delta step.
+ */
+typedef struct TELEMETRY_PACKED {
+	uint8_t type;
+	uint8_t sensor_id;
+	uint8_t seq;             /*!< Low byte of the delta sequence   */
+	uint8_t run;
+	uint16_t dt;             /*!< Since the sensor's last packet, 10 ms units */
+	int8_t dh;
+	int8_t dtemp;
+	uint16_t crc;
+} telemetry_delta_pkt_t;
+
+/**
+ * @brief 0x06 header; n handler shares and the CRC follow.
+ */
+typedef struct TELEMETRY_PACKED {
+	uint8_t type;
+	uint8_t n;
+	uint32_t timestamp_ms;
+	uint32_t window_ms;
+	uint32_t stop_ms;
+	uint16_t busy;           /*!< Permille of the awake cycles */
+	uint16_t isr;
+	uint16_t exc;
+} telemetry_perf_hdr_t;
+
+/**
+ * @brief 0x07: time mark.
+ */
+typedef struct TELEMETRY_PACKED {
+	uint8_t type;
+	uint8_t flags;           /*!< Bit 0: an offset is being slewed */
+	uint32_t tick;
+	uint32_t unix_s;
+	uint16_t ms;
+	uint16_t crc;
+} telemetry_time_pkt_t;
+
+/**
+ * @brief 0x08 header; n telemetry_batch_sample_t and the CRC follow.
+ */
+typedef struct TELEMETRY_PACKED {
+	uint8_t type;
+	uint8_t n;
+	uint16_t seq;
+	uint32_t timestamp_ms;   /*!< Of the first reading */
+} telemetry_batch_hdr_t;
+
+/**
+ * @brief One reading of a batch.
+ */
+typedef struct TELEMETRY_PACKED {
+	uint8_t sensor_id;
+	uint8_t status;
+	uint8_t retries;
+	uint16_t dt_ms;          /*!< Added to the header's timestamp */
+	uint8_t raw[5];
+} telemetry_batch_sample_t;
+
+/**
+ * @brief 0x09: window summary.
+ */
+typedef struct TELEMETRY_PACKED {
+	uint8_t type;
+	uint8_t sensor_id;
+	uint8_t window;
+	uint8_t utc;
+	uint32_t start_ms;
+	uint32_t window_s;
+	uint16_t count;
+	uint16_t failures;
+	int16_t temp_min;
+	int16_t temp_mean;
+	int16_t temp_max;
+	int16_t hum_min;
+	int16_t hum_mean;
+	int16_t hum_max;
+	uint16_t crc;
+} telemetry_summary_pkt_t;
+
+TELEMETRY_ASSERT(sizeof(telemetry_reading_pkt_t) == TELEMETRY_READING_LEN,
+		"0x01 layout");
+TELEMETRY_ASSERT(sizeof(telemetry_history_hdr_t) == TELEMETRY_HISTORY_HEADER,
+		"0x02 header layout");
+TELEMETRY_ASSERT(sizeof(telemetry_history_rec_t) == TELEMETRY_HISTORY_RECORD,
+		"0x02 record layout");
+TELEMETRY_ASSERT(sizeof(telemetry_flashlog_hdr_t) == TELEMETRY_FLASHLOG_HEADER,
+		"0x03 header layout");
+TELEMETRY_ASSERT(sizeof(telemetry_delta_key_pkt_t) == TELEMETRY_DELTA_KEY_LEN,
+		"0x04 layout");
+TELEMETRY_ASSERT(sizeof(telemetry_delta_pkt_t) == TELEMETRY_DELTA_LEN,
+		"0x05 layout");
+TELEMETRY_ASSERT(sizeof(telemetry_perf_hdr_t) == TELEMETRY_PERF_HEADER,
+		"0x06 header layout");
+TELEMETRY_ASSERT(sizeof(telemetry_time_pkt_t) == TELEMETRY_TIME_LEN,
+		"0x07 layout");
+/**
+ * @brief 0x0A header; n 16-bit edge times in microseconds and the CRC
+ *        follow.
+ */
+typedef struct TELEMETRY_PACKED {
+	uint8_t type;
+	uint8_t n;
+	uint8_t sensor_id;
+	uint8_t status;          /*!< dht11_status_t of the frame     */
+	uint8_t flags;           /*!< TELEMETRY_TRACE_*               */
+	uint16_t seq;            /*!< Increments per recorded frame   */
+	uint32_t timestamp_ms;   /*!< HAL tick when it was recorded   */
+} telemetry_trace_hdr_t;
+
+/**
+ * @brief 0x0B header; nfields telemetry_schema_field_t, nsensors
+ *        telemetry_schema_sensor_t and the CRC follow.
+ */
+typedef struct TELEMETRY_PACKED {
+	uint8_t type;
+	uint8_t schema_id;       /*!< Carried by the 0x0C packets it lays out */
+	uint8_t seq;             /*!< Shared with the 0x0C packets           */
+	uint8_t nfields;
+	uint8_t nsensors;
+	uint32_t timestamp_ms;   /*!< HAL tick the first DT counts from      */
+} telemetry_schema_hdr_t;
+
+/**
+ * @brief One value of the 0x0C packets, in packet order.
+ */
+typedef struct TELEMETRY_PACKED {
+	uint8_t id;              /*!< TELEMETRY_FIELD_*                      */
+	uint8_t enc;             /*!< TELEMETRY_ENC_*                        */
+	int8_t scale;            /*!< Power of ten of the unit               */
+	uint8_t unit;            /*!< TELEMETRY_UNIT_*                       */
+} telemetry_schema_field_t;
+
+/**
+ * @brief One sensor the 0x0C packets may carry.
+ */
+typedef struct TELEMETRY_PACKED {
+	uint8_t sensor_id;
+	uint8_t kind;            /*!< TELEMETRY_SENSOR_*                     */
+} telemetry_schema_sensor_t;
+
+/**
+ * @brief 0x0C header; the values of the schema's fields and the CRC
+ *        follow.
+ */
+typedef struct TELEMETRY_PACKED {
+	uint8_t type;
+	uint8_t schema_id;
+	uint8_t sensor_id;
+	uint8_t seq;             /*!< Per 0x0B/0x0C packet                   */
+} telemetry_compact_hdr_t;
+
+/**
+ * @brief 0x0D header; n telemetry_gateway_rec_t and the CRC follow.
+ */
+typedef struct TELEMETRY_PACKED {
+	uint8_t type;
+	uint8_t n;
+	uint16_t seq;
+	uint32_t timestamp_ms;   /*!< HAL tick the round started */
+} telemetry_gateway_hdr_t;
+
+/**
+ * @brief One sensor of a node, as its Modbus input registers gave it.
+ */
+typedef struct TELEMETRY_PACKED {
+	uint8_t node;            /*!< Slave address                     */
+	uint8_t sensor_id;       /*!< Or TELEMETRY_GATEWAY_LINK         */
+	uint8_t status;          /*!< dht11_status_t, or the link code  */
+	uint8_t health;          /*!< dht11_health_t                    */
+	uint16_t count;          /*!< Readings on the node, wraps       */
+	int16_t temp;            /*!< 1/10 degC, last good              */
+	int16_t hum;             /*!< 1/10 %RH, last good               */
+} telemetry_gateway_rec_t;
+
+TELEMETRY_ASSERT(sizeof(telemetry_batch_hdr_t) == TELEMETRY_BATCH_HEADER,
+		"0x08 header layout");
+TELEMETRY_ASSERT(sizeof(telemetry_batch_sample_t) == TELEMETRY_BATCH_SAMPLE,
+		"0x08 sample layout");
+TELEMETRY_ASSERT(sizeof(telemetry_summary_pkt_t) == TELEMETRY_SUMMARY_LEN,
+		"0x09 layout");
+TELEMETRY_ASSERT(sizeof(telemetry_trace_hdr_t) == TELEMETRY_TRACE_HEADER,
+		"0x0A header layout");
+TELEMETRY_ASSERT(TELEMETRY_TRACE_LEN(TELEMETRY_TRACE_MAX) <= TELEMETRY_PKT_MAX,
+		"0x0A longer than TELEMETRY_PKT_MAX");
+TELEMETRY_ASSERT(sizeof(telemetry_schema_hdr_t) == TELEMETRY_SCHEMA_HEADER,
+		"0x0B header layout");
+TELEMETRY_ASSERT(sizeof(telemetry_schema_field_t) == TELEMETRY_SCHEMA_FIELD,
+		"0x0B field layout");
+TELEMETRY_ASSERT(sizeof(telemetry_schema_sensor_t) == TELEMETRY_SCHEMA_SENSOR,
+		"0x0B sensor layout");
+TELEMETRY_ASSERT(sizeof(telemetry_compact_hdr_t) == TELEMETRY_COMPACT_HEADER,
+		"0x0C header layout");
+TELEMETRY_ASSERT(sizeof(telemetry_gateway_hdr_t) == TELEMETRY_GATEWAY_HEADER,
+		"0x0D header layout");
+TELEMETRY_ASSERT(sizeof(telemetry_gateway_rec_t) == TELEMETRY_GATEWAY_RECORD,
+		"0x0D record layout");
+TELEMETRY_ASSERT(TELEMETRY_GATEWAY_LEN(TELEMETRY_GATEWAY_MAX)
+		<= TELEMETRY_PKT_MAX, "0x0D longer than TELEMETRY_PKT_MAX");
+
+#endif /* TELEMETRY_FRAMES_H_ */
@@ -0,0 +1,85 @@
+/**
+ ******************************************************************************
+ * @file           : tickless.h
+ * @brief          : Tickless HAL timebase: no 1 kHz SysTick interrupt.
+ *
+ *                   The HAL tick only counts milliseconds for HAL_GetTick(),
+ *                   yet its interrupt wakes the core from every WFI 1000
+ *                   times a second while the firmware has work about once
+ *                   every two seconds. With TICKLESS_USE_IDLE:
+ *                     - Tickless_Start(), once TIM5 carries the system
+ *                       timestamp (systime.h), stops SysTick and
+ *                       HAL_GetTick() from then on is SysTime_Now64() in
+ *                       milliseconds, continuing the count SysTick had
+ *                       reached. HAL_InitTick() leaves SysTick off on
+ *                       every later clock change;
+ *                     - a WFI sleep (Power_Sleep(), Timebase_SleepUs())
+ *                       arms a TIM5 channel 3 compare for its budget, the
+ *                       earliest scheduler deadline, and wakes on it or on
+ *                       any other interrupt;
+ *                     - STOP already wakes on the RTC wakeup timer and
+ *                       hands the stop time to SysTime_Advance(), which
+ *                       moves HAL_GetTick() over it as well.
+ *                   The F446 has no LPTIM: TIM5 is the one free-running
+ *                   timer that runs in sleep and is kept at 1 MHz across
+ *                   clock profiles, and resolves the deadline to the
+ *                   microsecond. Idle time is measured around each sleep
+ *                   (Sched_GetIdlePercent()) instead of sampled by the
+ *                   tick.
+ *
+ *                   What still wakes the core on its own: TIM6 wraps
+ *                   (every 65.5 ms), TIM5 wraps, the status LED's period
+ *                   updates and the peripherals in use.
+ *
+ *                   The FreeRTOS build (app_rtos.h) keeps the kernel tick
+ *                   on SysTick and the HAL tick on TIM7.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef TICKLESS_H_
+#define TICKLESS_H_
+
+#include "main.h"
+#include "app_rtos.h"
+
+/* Set to 0 to keep the 1 kHz SysTick interrupt */
+#define TICKLESS_USE_IDLE (1)
+
+/** Longest WFI without a wakeup armed; also bounds an empty schedule */
+#define TICKLESS_MAX_SLEEP_US (1000000U)
+
+#define TICKLESS_IS_ACTIVE (TICKLESS_USE_IDLE && !APP_USE_RTOS)
+
+#if TICKLESS_IS_ACTIVE
+
+#define TICKLESS_ARM_WAKEUP(us)  Tickless_ArmWakeup(us)
+#define TICKLESS_DISARM_WAKEUP() Tickless_DisarmWakeup()
+
+/**
+ * @brief Stops SysTick and moves HAL_GetTick() onto TIM5 without a step.
+ *        Call after SysTime_Init().
+ */
+void Tickless_Start(void);
+
+/**
+ * @brief Arms the TIM5 channel 3 wakeup us from now, at most
+ *        TICKLESS_MAX_SLEEP_US. Before Tickless_Start() SysTick still
+ *        bounds every WFI and nothing is armed. Thread context.
+ */
+void Tickless_ArmWakeup(uint32_t us);
+
+/**
+ * @brief Disarms the wakeup, fired or not.
+ */
+void Tickless_DisarmWakeup(void);
+
+#else
+#define TICKLESS_ARM_WAKEUP(us)  ((void) 0)
+#define TICKLESS_DISARM_WAKEUP() ((void) 0)
+#endif /* TICKLESS_IS_ACTIVE */
+
+#endif /* TICKLESS_H_ */
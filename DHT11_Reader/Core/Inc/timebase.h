@@ -0,0 +1,207 @@
+/**
+ ******************************************************************************
+ * @file           : timebase.h
+ * @brief          : Clock-aware microsecond timebase.
+ *
+ *                   All rates are derived from the live RCC configuration:
+ *                     - TIM6 is prescaled to a 1 MHz free-running counter
+ *                       whose update interrupt (every 65.536 ms) services
+ *                       the DWT CYCCNT wrap extension.
+ *                     - DWT CYCCNT (HCLK) provides cycle resolution; the
+ *                       cycles-per-us factor is cached at init instead of
+ *                       dividing SystemCoreClock on every call.
+ *
+ *                   Timebase_Micros64() is monotonic across CYCCNT wraps
+ *                   (23.8 s at 180 MHz) and across clock profile switches,
+ *                   provided Timebase_Recalibrate() is called after each.
+ *
+ *                   Short protocol windows use the inline delays
+ *                   (Timebase_DelayCycles(), _DelayNs(), _DelayUsShort()):
+ *                   a constant argument folds into one multiply by the
+ *                   factor cached for the running profile, and the entry
+ *                   and exit cost measured by Timebase_CalibrateDelay() at
+ *                   init and after every clock change is taken off the
+ *                   spin, so they are accurate to a few cycles rather than
+ *                   padded by the call. Timebase_DelayUs() and delay_us()
+ *                   take off their own, larger, measured cost the same
+ *                   way.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef TIMEBASE_H_
+#define TIMEBASE_H_
+
+#include "main.h"
+#include "ramfunc.h"
+
+/** TIM6 counter rate */
+#define TIMEBASE_TIM6_HZ          (1000000U)
+
+/** Below this many microseconds Timebase_SleepUs() spins instead of sleeping */
+#define TIMEBASE_SLEEP_SPIN_US    (1000U)
+
+/** Longest Timebase_DelayNs(): keeps ns * cycles-per-ns in 32 bits */
+#define TIMEBASE_DELAY_NS_MAX     (200000U)
+
+/** Longest Timebase_DelayUsShort(): 1 s still fits at 180 cycles/us */
+#define TIMEBASE_DELAY_US_SHORT_MAX (1000000U)
+
+/**
+ * @brief Enables the DWT cycle counter. Idempotent.
+ */
+void Timebase_EnableCycleCounter(void);
+
+/**
+ * @brief Caches the clock factors, enables DWT and starts TIM6 with its
+ *        update interrupt. Call after MX_TIM6_Init().
+ */
+void Timebase_Init(void);
+
+/**
+ * @brief Re-reads HCLK after a clock change while keeping
+ *        Timebase_Micros64() continuous.
+ */
+void Timebase_Recalibrate(void);
+
+/**
+ * @brief TIM6 prescaler that yields TIMEBASE_TIM6_HZ from the current
+ *        APB1 timer clock.
+ */
+uint32_t Timebase_TIM6Prescaler(void);
+
+/**
+ * @brief Cached HCLK cycles per microsecond.
+ */
+uint32_t Timebase_CyclesPerUs(void);
+
+/**
+ * @brief 64-bit extension of DWT CYCCNT.
+ * @note  Must be called at least once per CYCCNT wrap; the TIM6 update
+ *        interrupt guarantees this.
+ */
+uint64_t Timebase_Cycles64(void);
+
+/**
+ * @brief Monotonic microseconds since Timebase_Init().
+ */
+uint64_t Timebase_Micros64(void);
+
+/**
+ * @brief Low 32 bits of Timebase_Micros64(), for short interval maths.
+ */
+uint32_t Timebase_Micros(void);
+
+/**
+ * @brief Busy-waits on DWT CYCCNT. Long delays are split into chunks so
+ *        the cycle count never overflows; the measured cost of the call
+ *        comes off the first one.
+ * @param us: Delay in microseconds.
+ */
+void Timebase_DelayUs(uint32_t us);
+
+/**
+ * @brief Timer-event delay: sleeps with WFI between SysTick/TIM6
+ *        interrupts and spins only for the final TIMEBASE_SLEEP_SPIN_US.
+ * @param us: Delay in microseconds.
+ * @note  Thread context only.
+ */
+void Timebase_SleepUs(uint32_t us);
+
+/**
+ * @brief Measures the cost of the delays around their spin, with
+ *        interrupts masked, and keeps it for the running clock profile.
+ *        Timebase_Init() and Timebase_Recalibrate() call it.
+ * @retval Overhead of the inline delays, in cycles.
+ */
+uint32_t Timebase_CalibrateDelay(void);
+
+/**
+ * @brief Overhead of the inline delays in cycles, from the last
+ *        Timebase_CalibrateDelay().
+ */
+uint32_t Timebase_DelayOverhead(void);
+
+/**
+ * @brief Cached HCLK cycles per nanosecond, Q16.
+ */
+uint32_t Timebase_CyclesPerNsQ16(void);
+
+/**
+ * @brief Busy-waits a number of HCLK cycles, less the calibrated overhead.
+ *        CYCCNT is read before the count is worked out, so the arithmetic
+ *        is part of the wait.
+ * @param cycles: Cycles from the call to the return; any count under the
+ *        overhead returns at once.
+ */
+RAMFUNC_INLINE void Timebase_DelayCycles(uint32_t cycles) {
+	uint32_t start = DWT->CYCCNT;
+	uint32_t overhead = Timebase_DelayOverhead();
+	uint32_t ticks = (cycles > overhead) ? (cycles - overhead) : 0U;
+
+	while ((DWT->CYCCNT - start) < ticks) {
+		/* spin */
+	}
+}
+
+/**
+ * @brief Busy-waits for a sub-microsecond or short window.
+ * @param ns: Nanoseconds, at most TIMEBASE_DELAY_NS_MAX; resolution is one
+ *        HCLK cycle (5.6 ns at 180 MHz, 62.5 ns at 16 MHz).
+ */
+RAMFUNC_INLINE void Timebase_DelayNs(uint32_t ns) {
+	Timebase_DelayCycles((ns * Timebase_CyclesPerNsQ16()) >> 16);
+}
+
+/**
+ * @brief Busy-waits whole microseconds without the call and chunking of
+ *        Timebase_DelayUs().
+ * @param us: Microseconds, at most TIMEBASE_DELAY_US_SHORT_MAX.
+ */
+RAMFUNC_INLINE void Timebase_DelayUsShort(uint32_t us) {
+	Timebase_DelayCycles(us * Timebase_CyclesPerUs());
+}
+
+/**
+ * @brief Cycle-accurate deadline on DWT CYCCNT; wrap-safe because only the
+ *        elapsed count (now - start) is compared.
+ */
+typedef struct {
+	uint32_t start;
+	uint32_t ticks;
+} timebase_deadline_t;
+
+/**
+ * @brief Arms a deadline us microseconds from now.
+ */
+RAMFUNC_INLINE void Timebase_DeadlineStart(timebase_deadline_t *deadline,
+		uint32_t us) {
+	deadline->start = DWT->CYCCNT;
+	deadline->ticks = us * Timebase_CyclesPerUs();
+}
+
+/**
+ * @brief Reports whether the deadline has passed.
+ */
+RAMFUNC_INLINE uint8_t Timebase_DeadlineExpired(
+		const timebase_deadline_t *deadline) {
+	return ((DWT->CYCCNT - deadline->start) >= deadline->ticks) ? 1U : 0U;
+}
+
+/**
+ * @brief Microseconds elapsed since the deadline was armed.
+ */
+RAMFUNC_INLINE uint32_t Timebase_DeadlineElapsedUs(
+		const timebase_deadline_t *deadline) {
+	return (DWT->CYCCNT - deadline->start) / Timebase_CyclesPerUs();
+}
+
+/**
+ * @brief TIM6 update handler; called from HAL_TIM_PeriodElapsedCallback().
+ */
+void Timebase_TIM6UpdateCallback(void);
+
+#endif /* TIMEBASE_H_ */
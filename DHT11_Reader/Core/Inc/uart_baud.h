@@ -0,0 +1,128 @@
+/**
+ ******************************************************************************
+ * @file           : uart_baud.h
+ * @brief          : USART2 baud profiles and runtime rate negotiation.
+ *
+ *                   BRR is computed from the actual PCLK1 (thus from the
+ *                   clock profile) for every rate in UART_BAUD_PROFILES.
+ *                   Both oversampling modes divide PCLK1 by a whole
+ *                   n = PCLK1 / baud; 16x oversampling is kept while n is
+ *                   at least 16, as it tolerates more clock mismatch and
+ *                   noise, and 8x oversampling (OVER8) takes over down to
+ *                   n = 8, doubling the top rate. A rate whose rounding
+ *                   error exceeds UART_BAUD_MAX_ERROR_PPM is refused. With PCLK1 at 16, 25 or 45 MHz, 1 Mbaud is
+ *                   exact in every clock profile, 2 Mbaud needs 16 MHz
+ *                   (OVER8) and 3 Mbaud 45 MHz (OVER8).
+ *
+ *                   Negotiation, so a host can never lose the link:
+ *                     1. host: "baud 1000000" at the current rate;
+ *                     2. device: "OK baud 1000000 confirm <ms>", drains TX,
+ *                        then switches;
+ *                     3. host switches and sends "baud ok" at the new rate
+ *                        within UART_BAUD_CONFIRM_MS;
+ *                     4. device: "OK baud 1000000", the rate is kept.
+ *                   Without the confirmation, or after UART_BAUD_MAX_ERRORS
+ *                   receive errors (framing, noise, overrun) at the new
+ *                   rate, the device returns to the previous rate and
+ *                   prints "ERR baud fallback <rate>" there. STOP mode is
+ *                   held off meanwhile.
+ *
+ *                   At 3 Mbaud the 256-byte RX ring fills in ~0.9 ms: keep
+ *                   command lines short, as the CLI does.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef UART_BAUD_H_
+#define UART_BAUD_H_
+
+#include "main.h"
+
+/** Selectable rates, lowest first */
+#define UART_BAUD_PROFILES      { 115200U, 230400U, 460800U, 921600U, \
+		1000000U, 1500000U, 2000000U, 2250000U, 3000000U }
+
+/** Rate after reset and after a failed clock-change recomputation */
+#define UART_BAUD_DEFAULT       (115200U)
+
+/** Largest accepted rate error, parts per million */
+#define UART_BAUD_MAX_ERROR_PPM (15000U)
+
+/** Time the host has to confirm a new rate */
+#define UART_BAUD_CONFIRM_MS    (2000U)
+
+/** Receive errors at a new rate that abort the negotiation */
+#define UART_BAUD_MAX_ERRORS    (3U)
+
+/**
+ * @brief Applies UART_BAUD_DEFAULT with the best oversampling. Call after
+ *        MX_USART2_UART_Init() and UART_TX_Init().
+ */
+void UART_Baud_Init(void);
+
+/**
+ * @brief Current rate.
+ */
+uint32_t UART_Baud_Get(void);
+
+/**
+ * @brief Reports whether the current rate uses 8x oversampling.
+ */
+uint8_t UART_Baud_IsOver8(void);
+
+/**
+ * @brief Number of entries in UART_BAUD_PROFILES.
+ */
+uint32_t UART_Baud_ProfileCount(void);
+
+/**
+ * @brief Rate of one profile, 0 past the end.
+ */
+uint32_t UART_Baud_Profile(uint32_t index);
+
+/**
+ * @brief Reports whether a rate is a profile reachable from PCLK1.
+ */
+uint8_t UART_Baud_IsSupported(uint32_t baud);
+
+/**
+ * @brief Drains TX, then switches to a new rate pending confirmation.
+ * @retval 1 if switched, 0 for an unsupported rate.
+ */
+uint8_t UART_Baud_Propose(uint32_t baud);
+
+/**
+ * @brief Keeps a proposed rate.
+ * @retval 1 if a proposal was pending.
+ */
+uint8_t UART_Baud_Confirm(void);
+
+/**
+ * @brief Switches to a saved rate (config.h) with no confirmation. Call
+ *        at boot, before anything is printed.
+ * @retval 1 if switched, 0 for a rate not reachable now: the current one
+ *         is kept.
+ */
+uint8_t UART_Baud_Restore(uint32_t baud);
+
+/**
+ * @brief Reports whether a proposed rate awaits confirmation.
+ */
+uint8_t UART_Baud_IsPending(void);
+
+/**
+ * @brief Falls back to the previous rate when the confirmation is late or
+ *        the new rate sees receive errors. Call from the CLI poll loop.
+ */
+void UART_Baud_Poll(void);
+
+/**
+ * @brief Recomputes BRR and oversampling after a PCLK1 change; returns to
+ *        UART_BAUD_DEFAULT if the current rate is no longer reachable.
+ */
+void UART_Baud_ClockChanged(void);
+
+#endif /* UART_BAUD_H_ */
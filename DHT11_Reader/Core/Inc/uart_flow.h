@@ -0,0 +1,125 @@
+/**
+ ******************************************************************************
+ * @file           : uart_flow.h
+ * @brief          : RTS/CTS flow control for the USART2 console.
+ *
+ *                   At the higher baud profiles (uart_baud.h) a host that
+ *                   stops reading for a moment loses bytes in its own
+ *                   driver, and a host that talks while the CLI is busy
+ *                   (a flash sector erase, a dump) overruns the 256-byte
+ *                   RX ring. USART2's CTS and RTS functions are on PA0 and
+ *                   PA1 on this package, the sync input and the DHT11 data
+ *                   line, so both are driven from GPIOs instead:
+ *                     - CTS in on PB5 (Arduino D4), low = host ready. The
+ *                       TX drain (uart_tx.h) starts a chunk only while it
+ *                       is low, and sends chunks of UART_FLOW_CHUNK bytes,
+ *                       so at most that many follow the host raising it.
+ *                       The falling edge (EXTI5, UART level) restarts the
+ *                       drain;
+ *                     - RTS out on PA9 (Arduino D8), low = send. It goes
+ *                       high when the RX DMA reports half the ring or more
+ *                       unread, and low again once the CLI has read it.
+ *                   Wire them to a USB-serial adapter's RTS and CTS on
+ *                   PA2/PA3: the ST-LINK bridge has no flow control lines.
+ *                   CTS is pulled down, so a board built with flow control
+ *                   but not wired for it still transmits.
+ *
+ *                   However the link is paced, a slow or stalled host
+ *                   backs the TX ring up; UART_TX_GetPressure() reports it
+ *                   and the sink (dht11_sink.h) sheds output to match.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef UART_FLOW_H_
+#define UART_FLOW_H_
+
+#include "main.h"
+
+/* Set to 1 to build RTS/CTS flow control on PB5/PA9 */
+#define UART_FLOW_USE_RTSCTS (0)
+
+/** CTS input: PB5 on EXTI line 5, pulled down */
+#define UART_FLOW_CTS_GPIO_Port  (GPIOB)
+#define UART_FLOW_CTS_PIN_NUM    (5U)
+
+/** RTS output: PA9, push-pull */
+#define UART_FLOW_RTS_GPIO_Port  (GPIOA)
+#define UART_FLOW_RTS_PIN_NUM    (9U)
+
+/** Largest TX chunk while flow control is on: bytes sent after CTS rises */
+#define UART_FLOW_CHUNK          (16U)
+
+/** Flow control on after UART_Flow_Init() */
+#define UART_FLOW_DEFAULT_ON     (1U)
+
+/**
+ * @brief Flow control state for the CLI.
+ */
+typedef struct {
+	uint32_t cts_waits;  /*!< Chunks held back by CTS          */
+	uint32_t rts_holds;  /*!< Times RTS asked the host to stop */
+	uint8_t on;
+	uint8_t cts_clear;   /*!< Host ready now                   */
+	uint8_t rts_ready;   /*!< Device ready now                 */
+} uart_flow_stats_t;
+
+#if UART_FLOW_USE_RTSCTS
+#define UART_FLOW_IS_CLEAR()     UART_Flow_IsClear()
+#define UART_FLOW_CHUNK_MAX()    UART_Flow_ChunkMax()
+#define UART_FLOW_RX_FILL(n)     UART_Flow_RxFill(n)
+#else
+#define UART_FLOW_IS_CLEAR()     (1U)
+#define UART_FLOW_CHUNK_MAX()    (0U)
+#define UART_FLOW_RX_FILL(n)     ((void) 0)
+#endif /* UART_FLOW_USE_RTSCTS */
+
+/**
+ * @brief Configures PB5, PA9 and EXTI5 and applies UART_FLOW_DEFAULT_ON.
+ *        Call after UART_RX_Init().
+ */
+void UART_Flow_Init(void);
+
+/**
+ * @brief Turns flow control on or off; off, CTS is ignored and RTS held
+ *        low.
+ */
+void UART_Flow_SetOn(uint8_t on);
+
+/**
+ * @brief Reports whether flow control is on.
+ */
+uint8_t UART_Flow_IsOn(void);
+
+/**
+ * @brief Reports whether a chunk may start: flow control off, or CTS low.
+ *        Counts a refusal. UART level or masked.
+ */
+uint8_t UART_Flow_IsClear(void);
+
+/**
+ * @brief Largest chunk the TX drain may start, 0 for no limit.
+ */
+uint32_t UART_Flow_ChunkMax(void);
+
+/**
+ * @brief Drives RTS from the bytes still unread in the RX ring; called by
+ *        the RX event handler and by UART_RX_Read().
+ */
+void UART_Flow_RxFill(uint32_t unread);
+
+/**
+ * @brief Fills the flow control state.
+ */
+void UART_Flow_GetStats(uart_flow_stats_t *stats);
+
+/**
+ * @brief EXTI lines 9..5 handler: CTS fell, restarts the TX drain. Called
+ *        from EXTI9_5_IRQHandler().
+ */
+void UART_Flow_IRQHandler(void);
+
+#endif /* UART_FLOW_H_ */
@@ -0,0 +1,74 @@
+/**
+ ******************************************************************************
+ * @file           : uart_rx.h
+ * @brief          : Circular-DMA USART2 receive path with IDLE-line events.
+ *
+ *                   DMA1 Stream5 (channel 4) writes every received byte into
+ *                   a RAM ring in circular mode, so no byte needs CPU time.
+ *                   The USART IDLE-line interrupt (plus the DMA half/full
+ *                   transfer events) only raises a flag; the consumer reads
+ *                   the DMA write position from NDTR and copies out what
+ *                   arrived since its last call.
+ *
+ *                   The ring must be drained faster than it fills: at
+ *                   115200 baud 256 bytes last ~22 ms, at 1 Mbaud ~2.6 ms
+ *                   (uart_baud.h). With flow control (uart_flow.h) RTS
+ *                   holds the host off while half the ring is unread.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef UART_RX_H_
+#define UART_RX_H_
+
+#include "main.h"
+
+/** Ring size in bytes */
+#define UART_RX_BUFFER_SIZE (256U)
+
+/**
+ * @brief Starts circular reception. Call after MX_USART2_UART_Init().
+ */
+void UART_RX_Init(void);
+
+/**
+ * @brief Reports whether an IDLE/half/full event arrived since the last
+ *        UART_RX_Read(). Cheap enough to gate polling on.
+ */
+uint8_t UART_RX_HasEvent(void);
+
+/**
+ * @brief Copies out bytes received since the previous call.
+ * @param out: Destination buffer.
+ * @param max: Capacity of out.
+ * @retval Number of bytes copied.
+ */
+uint32_t UART_RX_Read(uint8_t *out, uint32_t max);
+
+/**
+ * @brief DMA write position in the ring, 0 to UART_RX_BUFFER_SIZE - 1.
+ *        Unchanged between two calls means nothing arrived (or exactly a
+ *        whole ring).
+ */
+uint32_t UART_RX_GetPosition(void);
+
+/**
+ * @brief Number of receive errors (overrun, framing, noise) so far.
+ */
+uint32_t UART_RX_GetErrors(void);
+
+/**
+ * @brief Reception event handler; called from HAL_UARTEx_RxEventCallback().
+ */
+void UART_RX_EventCallback(uint16_t pos);
+
+/**
+ * @brief Error handler; called from HAL_UART_ErrorCallback(). Restarts
+ *        reception if HAL stopped it.
+ */
+void UART_RX_ErrorCallback(void);
+
+#endif /* UART_RX_H_ */
@@ -0,0 +1,232 @@
+/**
+ ******************************************************************************
+ * @file           : uart_tx.h
+ * @brief          : Ring-buffered, DMA-drained USART2 transmit path.
+ *
+ *                   printf() output is copied into a RAM ring in one go by
+ *                   _write() and drained in the background by USART2 TX DMA
+ *                   (DMA1 Stream6, channel 4). Each transfer-complete
+ *                   interrupt chains the next contiguous chunk, so logging
+ *                   costs a memcpy instead of ~87 us per byte at 115200 baud.
+ *
+ *                   stdout is line buffered in a static buffer of
+ *                   UART_TX_STDIO_SIZE bytes, set by UART_TX_Init(), so
+ *                   newlib does not malloc() one on the first printf().
+ *                   fmt.h lines skip stdio and go straight into the ring.
+ *
+ *                   Writers are expected to run in thread context; the
+ *                   drain runs from the USART2/DMA interrupts.
+ *
+ *                   Builds that cannot spare DMA1 Stream6 set
+ *                   UART_TX_USE_DMA to 0: the same chunks then leave one
+ *                   byte per USART2 TXE interrupt (UART_TX_IRQHandler(), a
+ *                   load, a store and a count), and the chunk retires as
+ *                   the DMA one would. At 115200 baud that costs one short
+ *                   interrupt per 87 us instead of a blocking write per
+ *                   character. Only Modbus (modbus.h) still transmits on
+ *                   the stream; a variant that hands it to another
+ *                   peripheral drops the USART2_TX DMA request from
+ *                   DHT11_Reader.ioc along with Modbus.
+ *
+ *                   UART_TX_SetTransport() moves the drain to USB CDC bulk
+ *                   IN (usb_cdc.h) and back; everything written to the ring
+ *                   follows, whatever sink or logger produced it. With
+ *                   UART_TX_TRANSPORT_NONE the ring is emptied as it fills,
+ *                   so writers never notice that USART2 serves Modbus.
+ *
+ *                   UART_TX_GetPressure() tells producers how the drain
+ *                   keeps up: HIGH once the ring is three quarters full,
+ *                   until it is back to a quarter; STALLED while queued
+ *                   bytes have not moved for UART_TX_STALL_MS (a host
+ *                   holding CTS, uart_flow.h, or a USART2 nobody reads at
+ *                   the rate it is written). The sink (dht11_sink.h) sends
+ *                   window summaries only under HIGH and nothing under
+ *                   STALLED, instead of leaving the policy to cut frames.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef UART_TX_H_
+#define UART_TX_H_
+
+#include "main.h"
+
+/* Set to 0 to drain to USART2 from the TXE interrupt instead of DMA */
+#define UART_TX_USE_DMA (1)
+
+/** Ring size in bytes, must be a power of two */
+#define UART_TX_BUFFER_SIZE   (1024U)
+
+/** stdout line buffer; a longer line is written out as it fills */
+#define UART_TX_STDIO_SIZE    (128U)
+
+#if (UART_TX_BUFFER_SIZE & (UART_TX_BUFFER_SIZE - 1U)) != 0U
+#error "UART_TX_BUFFER_SIZE must be a power of two"
+#endif
+
+/**
+ * @brief What UART_TX_Write() does when the ring cannot hold the data.
+ */
+typedef enum {
+	UART_TX_POLICY_DROP = 0,  /*!< Keep queued data, discard what does not fit  */
+	UART_TX_POLICY_BLOCK,     /*!< Wait for the DMA to free space               */
+	UART_TX_POLICY_OVERWRITE  /*!< Discard queued, unsent data to keep the newest */
+} uart_tx_policy_t;
+
+/** Policy applied after UART_TX_Init() */
+#define UART_TX_DEFAULT_POLICY (UART_TX_POLICY_DROP)
+
+/**
+ * @brief Where the ring drains to.
+ */
+typedef enum {
+	UART_TX_TRANSPORT_USART2 = 0,  /*!< USART2 TX DMA, the ST-LINK bridge */
+	UART_TX_TRANSPORT_USB,         /*!< USB CDC bulk IN (usb_cdc.h)       */
+	UART_TX_TRANSPORT_NONE,        /*!< Discarded and counted; USART2 lent
+	                                    to Modbus (modbus.h)              */
+	UART_TX_TRANSPORT_COUNT
+} uart_tx_transport_t;
+
+/**
+ * @brief How far the drain is behind the writers.
+ */
+typedef enum {
+	UART_TX_PRESSURE_NONE = 0,  /*!< Keeping up                           */
+	UART_TX_PRESSURE_HIGH,      /*!< Ring filling: send less              */
+	UART_TX_PRESSURE_STALLED,   /*!< Nothing left for UART_TX_STALL_MS    */
+	UART_TX_PRESSURE_LEVELS
+} uart_tx_pressure_t;
+
+/** Fill that raises UART_TX_PRESSURE_HIGH, and the one that clears it */
+#define UART_TX_PRESSURE_HIGH_FILL ((UART_TX_BUFFER_SIZE * 3U) / 4U)
+#define UART_TX_PRESSURE_LOW_FILL  (UART_TX_BUFFER_SIZE / 4U)
+
+/** Queued bytes that have not moved for this long: the link stalled */
+#define UART_TX_STALL_MS       (1000U)
+
+/** Time allowed for the chunk in flight to leave before a switch */
+#define UART_TX_SWITCH_MS      (200U)
+
+/**
+ * @brief Resets the ring and sets the stdout buffer. Call after
+ *        MX_USART2_UART_Init() and before the first printf().
+ */
+void UART_TX_Init(void);
+
+/**
+ * @brief Selects the overflow policy.
+ */
+void UART_TX_SetPolicy(uart_tx_policy_t policy);
+
+/**
+ * @brief Queues bytes for transmission and starts the DMA if idle.
+ * @param data: Bytes to send.
+ * @param len: Number of bytes.
+ * @retval Number of bytes accepted into the ring.
+ * @note  UART_TX_POLICY_BLOCK falls back to dropping when called with
+ *        interrupts masked or from an ISR, since the drain could never run.
+ */
+uint32_t UART_TX_Write(const uint8_t *data, uint32_t len);
+
+/**
+ * @brief Waits until every queued byte has left the ring.
+ * @param timeout_ms: Maximum time to wait.
+ * @retval 1 if the ring drained, 0 on timeout.
+ */
+uint8_t UART_TX_Flush(uint32_t timeout_ms);
+
+/**
+ * @brief Free space in the ring, in bytes.
+ */
+uint32_t UART_TX_Free(void);
+
+/**
+ * @brief Total bytes discarded by the DROP/OVERWRITE policies.
+ */
+uint32_t UART_TX_GetDropped(void);
+
+/**
+ * @brief Watchdog probe of the drain.
+ * @retval 1 if the ring is empty or bytes were sent since the last call.
+ */
+uint8_t UART_TX_IsDraining(void);
+
+/**
+ * @brief Selects the transport. The chunk in flight finishes on the old
+ *        one first; a USB transfer the host does not take within
+ *        UART_TX_SWITCH_MS is dropped.
+ * @retval 1 if switched, 0 if the transport is not built in or the USART2
+ *         chunk did not finish.
+ */
+uint8_t UART_TX_SetTransport(uart_tx_transport_t transport);
+
+/**
+ * @brief Returns the active transport.
+ */
+uart_tx_transport_t UART_TX_GetTransport(void);
+
+/**
+ * @brief Backpressure of the ring, for producers deciding what to send.
+ *        Thread context.
+ */
+uart_tx_pressure_t UART_TX_GetPressure(void);
+
+/**
+ * @brief Times the ring entered UART_TX_PRESSURE_STALLED since
+ *        UART_TX_Init(), as seen by UART_TX_GetPressure().
+ */
+uint32_t UART_TX_GetStalls(void);
+
+/**
+ * @brief Short printable name of a backpressure level.
+ */
+const char* UART_TX_PressureName(uart_tx_pressure_t pressure);
+
+/**
+ * @brief Starts the next chunk if flow control (uart_flow.h) held the
+ *        drain back; thread context or the UART level.
+ */
+void UART_TX_Resume(void);
+
+/**
+ * @brief Transfer-complete handler; called from HAL_UART_TxCpltCallback()
+ *        (UART_TX_DmaIRQHandler() with APP_USE_FASTPATH, the last TXE
+ *        without UART_TX_USE_DMA) and from the USB IN transfer-complete
+ *        interrupt.
+ */
+void UART_TX_CompleteCallback(void);
+
+/**
+ * @brief Drops the chunk in flight and resumes; called when the transport
+ *        cancelled it.
+ */
+void UART_TX_AbortCallback(void);
+
+/**
+ * @brief Error handler; called from HAL_UART_ErrorCallback().
+ */
+void UART_TX_ErrorCallback(void);
+
+#if !UART_TX_USE_DMA
+/**
+ * @brief USART2 TXE interrupt: sends the next byte of the chunk, retires
+ *        it after the last. Called from USART2_IRQHandler() ahead of
+ *        HAL_UART_IRQHandler(); returns at once if TXEIE is off.
+ */
+void UART_TX_IRQHandler(void);
+#endif /* !UART_TX_USE_DMA */
+
+#if APP_USE_FASTPATH && UART_TX_USE_DMA
+/**
+ * @brief DMA1 Stream6 interrupt while the console drives it: completes or
+ *        drops the chunk and starts the next one.
+ * @retval 0 if the HAL transmits on the stream (Modbus) and its handler
+ *         must run instead.
+ */
+uint8_t UART_TX_DmaIRQHandler(void);
+#endif /* APP_USE_FASTPATH && UART_TX_USE_DMA */
+
+#endif /* UART_TX_H_ */
@@ -0,0 +1,132 @@
+/**
+ ******************************************************************************
+ * @file           : usb_cdc.h
+ * @brief          : USB CDC-ACM (virtual COM port) device on OTG FS, as an
+ *                   alternative drain for the uart_tx.h output ring.
+ *
+ *                   A register-level device stack for the one class this
+ *                   firmware needs: enumeration on EP0, a bulk IN/OUT pair
+ *                   on EP1 and the ACM notification endpoint (EP2, never
+ *                   used). Any host CDC-ACM driver binds to it: ttyACMx on
+ *                   Linux, usbser.sys on Windows 10+, cu.usbmodem on macOS.
+ *
+ *                   With UART_TX_SetTransport(UART_TX_TRANSPORT_USB) the
+ *                   output ring drains into EP1 IN instead of the USART2
+ *                   DMA, so text, telemetry frames and dumps all switch at
+ *                   once. A contiguous chunk of up to USB_CDC_TX_CHUNK
+ *                   bytes is copied into the EP1 TX FIFO in one go; the
+ *                   core sends it as back-to-back 64-byte packets while the
+ *                   ring fills the next chunk, and the transfer-complete
+ *                   interrupt chains it. Full-speed bulk moves up to ~1
+ *                   MB/s, against ~11 kB/s at 115200 baud, and needs no
+ *                   rate negotiation. Until the host has configured the
+ *                   device and raised DTR (opened the port), queued output
+ *                   is dropped and counted like on a UART nobody listens
+ *                   to. Bytes from the host feed the CLI alongside USART2;
+ *                   EP1 OUT is NAKed while the receive ring is full.
+ *
+ *                   Requirements and limits:
+ *                     - D-/D+ on PA11/PA12 (CN10 pins 14/12 on the Nucleo,
+ *                       which has no user USB connector); VBUS sensing is
+ *                       off, the B-session is forced valid;
+ *                     - 48 MHz comes from PLLSAI (HSE / 4 * 96 / 4), so
+ *                       the device only runs in the HSE profiles
+ *                       (clock_config.h); Usb_Cdc_ClockChanged() stops it
+ *                       in LOW_POWER and the output returns to USART2;
+ *                     - STOP mode stops PLLSAI and is held off while the
+ *                       device is started (power.h).
+ *
+ *                   VID/PID are ST's virtual COM port pair (0483:5740);
+ *                   the serial number is the 96-bit unique device ID.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef USB_CDC_H_
+#define USB_CDC_H_
+
+#include "main.h"
+
+/* Set to 1 to build the USB CDC-ACM device on OTG FS (PA11/PA12) */
+#define USB_USE_CDC       (0)
+
+/** Bulk and control packet size, full speed */
+#define USB_CDC_PACKET    (64U)
+
+/** Largest IN transfer, the whole EP1 TX FIFO */
+#define USB_CDC_TX_CHUNK  (512U)
+
+/** Host-to-device ring in bytes, must be a power of two */
+#define USB_CDC_RX_SIZE   (256U)
+
+#if USB_USE_CDC
+
+/**
+ * @brief Starts PLLSAI, claims PA11/PA12, initialises the core in device
+ *        mode and connects. Call after UART_TX_Init().
+ * @retval 1 if started, 0 if the active clock profile cannot feed 48 MHz.
+ */
+uint8_t Usb_Cdc_Start(void);
+
+/**
+ * @brief Disconnects from the host and powers the core and PLLSAI down.
+ *        Drops an IN transfer in progress.
+ */
+void Usb_Cdc_Stop(void);
+
+/**
+ * @brief Reports whether the device is started (connected or waiting for
+ *        a host).
+ */
+uint8_t Usb_Cdc_IsStarted(void);
+
+/**
+ * @brief Reports whether the host configured the device and opened the
+ *        port (DTR set), so that data sent is received.
+ */
+uint8_t Usb_Cdc_IsOpen(void);
+
+/**
+ * @brief Starts one bulk IN transfer; UART_TX_CompleteCallback() is
+ *        called when the host has taken all of it.
+ * @param data: Bytes to send; only read during the call.
+ * @param len: 1 to USB_CDC_TX_CHUNK bytes.
+ * @retval 1 if started, 0 if the endpoint is busy or the port closed.
+ * @note  Call with IRQ_PRIO_UART masked or from the UART-level handlers.
+ */
+uint8_t Usb_Cdc_Transmit(const uint8_t *data, uint32_t len);
+
+/**
+ * @brief Cancels the IN transfer in progress, if any, and reports it
+ *        through UART_TX_AbortCallback().
+ */
+void Usb_Cdc_AbortTx(void);
+
+/**
+ * @brief Copies out bytes received from the host since the last call.
+ * @param out: Destination buffer.
+ * @param max: Capacity of out.
+ * @retval Number of bytes copied.
+ */
+uint32_t Usb_Cdc_Read(uint8_t *out, uint32_t max);
+
+/**
+ * @brief Stops the device when the new clock profile has no HSE, starts
+ *        it again when it has.
+ */
+void Usb_Cdc_ClockChanged(void);
+
+/**
+ * @brief OTG FS interrupt body; called from OTG_FS_IRQHandler().
+ */
+void Usb_Cdc_IRQHandler(void);
+
+#else
+#define Usb_Cdc_IsStarted() (0U)
+#define Usb_Cdc_IsOpen()    (0U)
+#endif /* USB_USE_CDC */
+
+#endif /* USB_CDC_H_ */
@@ -0,0 +1,146 @@
+/**
+ ******************************************************************************
+ * @file           : wallclock.h
+ * @brief          : UTC wall-clock time on the RTC, set by the host.
+ *
+ *                   The RTC calendar (power.h: LSE when fitted, else the
+ *                   calibrated LSI) keeps running across resets, with a
+ *                   sub-second counter at RTCCLK/2 (~61 us). The host sets
+ *                   it with "time <unix_s>[.<ms>]" and repeats that now and
+ *                   then; the firmware works out the offset itself:
+ *
+ *                   - first sync, or an offset beyond WALLCLOCK_STEP_MS:
+ *                     the calendar is stepped, the sub-second phase set
+ *                     with RTC_SHIFTR;
+ *                   - otherwise the offset is slewed away with the RTC
+ *                     smooth calibration (RTC_CALR), WALLCLOCK_SLEW_PULSES
+ *                     faster or slower until it is gone, so time never
+ *                     jumps or runs backwards;
+ *                   - syncs at least WALLCLOCK_FREQ_MIN_MS apart also
+ *                     measure the oscillator's frequency error, which stays
+ *                     in RTC_CALR between syncs and is kept in backup
+ *                     register 0 with the synced state, across resets.
+ *
+ *                   Readings and log records then carry absolute time: the
+ *                   text sink starts each line with an ISO-8601 UTC stamp,
+ *                   the binary streams interleave time marks (telemetry
+ *                   packet 0x07) that map the HAL tick in every packet to
+ *                   UTC, and the flash log's RTC seconds become UTC seconds
+ *                   since 2000. Nothing changes until the first sync.
+ *
+ *                   The command's reply carries the firmware's time after
+ *                   the sync, so the host can measure the round trip and
+ *                   send its time plus half of it next time.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef WALLCLOCK_H_
+#define WALLCLOCK_H_
+
+#include "main.h"
+#include "fmt.h"
+
+/* Set to 1 to keep host-synced UTC on the RTC calendar */
+#define WALLCLOCK_USE_SYNC    (1)
+
+/** 2000-01-01 00:00 UTC, the RTC calendar's epoch, in Unix seconds */
+#define WALLCLOCK_UNIX_2000   (946684800U)
+
+/** Last second the calendar can hold (2099-12-31 23:59:59) */
+#define WALLCLOCK_UNIX_MAX    (4102444799U)
+
+/** Offsets beyond this are stepped instead of slewed */
+#define WALLCLOCK_STEP_MS     (1000U)
+
+/** Slew rate in RTC_CALR pulses per 2^20 RTC cycles (~0.954 ppm each):
+ * 256 is ~244 ppm, so 100 ms takes about 7 minutes */
+#define WALLCLOCK_SLEW_PULSES (256)
+
+/** Shortest sync spacing that updates the frequency correction */
+#define WALLCLOCK_FREQ_MIN_MS (900000U)
+
+/**
+ * @brief Outcome of Wallclock_Sync().
+ */
+typedef enum {
+	WALLCLOCK_STEPPED = 0,  /*!< Calendar set                       */
+	WALLCLOCK_SLEWING,      /*!< Offset being slewed away           */
+	WALLCLOCK_REJECTED      /*!< Outside 2000-2099 or no RTC clock  */
+} wallclock_sync_t;
+
+/**
+ * @brief Discipline state.
+ */
+typedef struct {
+	uint32_t syncs;      /*!< Accepted syncs                            */
+	uint32_t steps;      /*!< Of which stepped the calendar             */
+	int32_t offset_ms;   /*!< Host minus local time at the last sync    */
+	int32_t freq;        /*!< Frequency correction, RTC_CALR pulses     */
+	uint32_t slew_ms;    /*!< Slew time left, 0 when none is running    */
+} wallclock_stats_t;
+
+#if WALLCLOCK_USE_SYNC
+
+/**
+ * @brief Restores the synced state and frequency correction from the
+ *        backup domain. Call after Power_Init().
+ */
+void Wallclock_Init(void);
+
+/**
+ * @brief Reports whether the calendar holds host time.
+ */
+uint8_t Wallclock_IsSynced(void);
+
+/**
+ * @brief Current time.
+ * @param ms: Receives milliseconds into the second; may be NULL.
+ * @retval Unix seconds.
+ */
+uint32_t Wallclock_Now(uint32_t *ms);
+
+/**
+ * @brief Time at which the HAL tick read tick_ms (up to 49 days back).
+ * @param ms: Receives milliseconds into the second; may be NULL.
+ * @retval Unix seconds.
+ */
+uint32_t Wallclock_FromTick(uint32_t tick_ms, uint32_t *ms);
+
+/**
+ * @brief Takes the host's time and steps or slews towards it.
+ * @param offset_ms: Receives host minus local time before the correction.
+ */
+wallclock_sync_t Wallclock_Sync(uint32_t unix_s, uint32_t ms,
+		int32_t *offset_ms);
+
+/**
+ * @brief Ends a finished slew. Call from the CLI poll loop.
+ */
+void Wallclock_Poll(void);
+
+/**
+ * @brief Copies the discipline state.
+ */
+void Wallclock_GetStats(wallclock_stats_t *stats);
+
+/**
+ * @brief Appends "YYYY-MM-DDTHH:MM:SS.mmmZ".
+ */
+void Wallclock_Format(fmt_t *f, uint32_t unix_s, uint32_t ms);
+
+/**
+ * @brief Appends the ISO-8601 time of a HAL tick and a space once synced,
+ *        nothing before.
+ */
+void Wallclock_Stamp(fmt_t *f, uint32_t tick_ms);
+
+#else
+#define Wallclock_IsSynced()        (0U)
+#define Wallclock_Stamp(f, tick_ms) ((void) 0)
+#endif /* WALLCLOCK_USE_SYNC */
+
+#endif /* WALLCLOCK_H_ */
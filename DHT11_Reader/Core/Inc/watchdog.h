@@ -0,0 +1,116 @@
+/**
+ ******************************************************************************
+ * @file           : watchdog.h
+ * @brief          : IWDG supervisor refreshed only while every subsystem
+ *                   checks in.
+ *
+ *                   Each supervised subsystem registers a liveness token
+ *                   with the longest silence it may keep, and checks in
+ *                   with Watchdog_Checkin() whenever it makes progress;
+ *                   for one that is idle most of the time (the UART TX
+ *                   drain) a probe function decides at each service
+ *                   instead. Watchdog_Service() refreshes the IWDG only
+ *                   while all tokens are fresh. The first stale token
+ *                   latches: the supervisor stops refreshing, records the
+ *                   token in .noinit RAM and the IWDG resets the chip
+ *                   within the timeout. A hang anywhere in the service
+ *                   path stops the refresh the same way, so recovery is
+ *                   bounded by the token age plus the timeout.
+ *
+ *                   Cooperative build: a scheduler timer task services the
+ *                   supervisor every WATCHDOG_SERVICE_MS, which also caps
+ *                   STOP (the IWDG keeps counting in STOP). FreeRTOS build:
+ *                   the idle hook services it, so starving the idle task
+ *                   trips it too.
+ *
+ *                   The IWDG runs from the LSI, using the frequency
+ *                   calibrated by Power_Init(), and is frozen while the
+ *                   core is halted by a debugger.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef WATCHDOG_H_
+#define WATCHDOG_H_
+
+#include "main.h"
+
+/** IWDG timeout; 1 ms to ~32 s at the nominal LSI */
+#define WATCHDOG_TIMEOUT_MS     (8000U)
+
+/** Service period; well inside the timeout to absorb a flash sector erase */
+#define WATCHDOG_SERVICE_MS     (2000U)
+
+/** Token slots */
+#define WATCHDOG_MAX_TOKENS     (4U)
+
+/** Returned by Watchdog_Register() when all slots are used */
+#define WATCHDOG_NO_TOKEN       (0xFFU)
+
+/** Longest silence per token. The sensor may back off to
+ * DHT11_HEALTH_BACKOFF_MAX_MS between reads of a failed sensor. */
+#define WATCHDOG_AGE_SENSOR_MS  (35000U)
+#define WATCHDOG_AGE_UART_MS    (5000U)
+#define WATCHDOG_AGE_SERVICE_MS (5000U)
+
+#if WATCHDOG_SERVICE_MS >= WATCHDOG_TIMEOUT_MS
+#error "WATCHDOG_SERVICE_MS must be shorter than WATCHDOG_TIMEOUT_MS"
+#endif
+
+/**
+ * @brief Probe of a token: nonzero when the subsystem is healthy now.
+ */
+typedef uint8_t (*watchdog_probe_fn_t)(void);
+
+/**
+ * @brief Reports the token that tripped the supervisor before the last
+ *        reset, if any. Call once the UART is up.
+ */
+void Watchdog_Init(void);
+
+/**
+ * @brief Adds a liveness token, fresh from now.
+ * @param max_age_ms: Longest time allowed between check-ins.
+ * @param probe: Optional, run at each service; a nonzero result checks in.
+ * @retval Token id, or WATCHDOG_NO_TOKEN.
+ */
+uint8_t Watchdog_Register(const char *name, uint32_t max_age_ms,
+		watchdog_probe_fn_t probe);
+
+/**
+ * @brief Marks a token fresh. Any context; ignores WATCHDOG_NO_TOKEN.
+ */
+void Watchdog_Checkin(uint8_t id);
+
+/**
+ * @brief Starts the IWDG; it cannot be stopped afterwards. Calling again
+ *        changes the timeout.
+ * @param timeout_ms: Requested timeout, rounded down to the IWDG steps.
+ */
+void Watchdog_Start(uint32_t timeout_ms);
+
+/**
+ * @brief Checks the tokens and refreshes the IWDG if all are fresh. Calls
+ *        closer than WATCHDOG_SERVICE_MS / 2 apart return at once.
+ */
+void Watchdog_Service(void);
+
+/**
+ * @brief Timeout actually programmed, 0 before Watchdog_Start().
+ */
+uint32_t Watchdog_GetTimeoutMs(void);
+
+/**
+ * @brief Name of the stale token, "none" while all are fresh.
+ */
+const char* Watchdog_GetStale(void);
+
+/**
+ * @brief Prints one line per token with its age.
+ */
+void Watchdog_Dump(void);
+
+#endif /* WATCHDOG_H_ */
@@ -0,0 +1,170 @@
+/**
+ ******************************************************************************
+ * @file           : watermark.h
+ * @brief          : Stack high-water mark and interrupt entry latency.
+ *
+ *                   Stack: the reset handler (startup_stm32f446retx.s)
+ *                   fills the RAM from _spaint up to the initial stack
+ *                   pointer with WATERMARK_STACK_PAINT before anything
+ *                   runs on it. _spaint is _Paint_Stack_Size below
+ *                   _estack in the linker script, twice the
+ *                   _Min_Stack_Size reserve, so a stack that outgrows its
+ *                   reserve is still measured. Watermark_GetStack() scans
+ *                   up from the paint floor (or the heap top, if the heap
+ *                   has grown past it) to the first overwritten word: the
+ *                   deepest the main stack has been since reset, handlers
+ *                   and their nesting included. Under FreeRTOS that is the
+ *                   handler stack; the task stacks have their own marks
+ *                   ("tasks").
+ *
+ *                   Latency: from a hardware event to the first
+ *                   instruction of its handler, in CPU cycles, for the
+ *                   handlers whose event a timer timestamps:
+ *                     - SysTick: counts down from LOAD at the core clock,
+ *                       so LOAD - VAL at entry is the time since the tick;
+ *                     - TIM6 (timebase.h): CNT at the update entry is the
+ *                       time since the wrap, in 1 us ticks;
+ *                     - the probe: TIM11 compare events at
+ *                       WATERMARK_PROBE_PRIO, about every
+ *                       WATERMARK_PROBE_US with a pseudo-random step so
+ *                       they do not lock to the 1 ms tick. CCR1 is the
+ *                       event time, CNT at entry the arrival. What
+ *                       delays the probe is what that priority level
+ *                       waits for: more urgent handlers, PRIMASK and
+ *                       BASEPRI sections, the wake-up from WFI.
+ *                   A probe late by more than a TIM11 wrap (~1 ms at 180
+ *                   MHz, flash erases) is measured on CYCCNT from the
+ *                   previous entry instead. Each figure includes the 12
+ *                   cycle exception entry and the handler prologue.
+ *
+ *                   The probe wakes the core as often as the 1 kHz tick
+ *                   it is sized against, so the tickless build
+ *                   (tickless.h) leaves it out unless WATERMARK_USE_PROBE
+ *                   is forced on; SysTick is stopped there too, leaving
+ *                   the TIM6 figures.
+ *
+ *                   "stats" prints both; "perf reset" clears the latency
+ *                   maxima.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef WATERMARK_H_
+#define WATERMARK_H_
+
+#include "main.h"
+#include "irq_prio.h"
+#include "tickless.h"
+
+/* Set to 0 to leave TIM11 unused and the handlers unhooked */
+#define WATERMARK_USE_LATENCY (1)
+
+/* The TIM11 probe: 1000 wakeups a second, so only with the 1 kHz tick */
+#define WATERMARK_USE_PROBE (WATERMARK_USE_LATENCY && !TICKLESS_IS_ACTIVE)
+
+/** Fill of the unused stack; the startup code writes the same word */
+#define WATERMARK_STACK_PAINT  (0xA5A5A5A5U)
+
+/** Mean probe spacing; 1000 probes a second */
+#define WATERMARK_PROBE_US     (1000U)
+
+/** Probe level: what the timebase and timing windows wait for */
+#define WATERMARK_PROBE_PRIO   (IRQ_PRIO_TIMEBASE)
+
+/**
+ * @brief Handlers with a measured entry latency.
+ */
+typedef enum {
+	WATERMARK_IRQ_SYSTICK = 0,
+	WATERMARK_IRQ_TIM6,
+	WATERMARK_IRQ_PROBE,
+	WATERMARK_IRQ_COUNT
+} watermark_irq_t;
+
+/**
+ * @brief Entry latency of one handler, in CPU cycles.
+ */
+typedef struct {
+	uint32_t count;
+	uint32_t last;
+	uint32_t max;
+	uint64_t sum;
+} watermark_lat_t;
+
+/**
+ * @brief Main stack use since reset, in bytes.
+ */
+typedef struct {
+	uint32_t used;       /*!< _estack down to the deepest word written */
+	uint32_t reserved;   /*!< _Min_Stack_Size                          */
+	uint32_t painted;    /*!< What the scan can see                    */
+	uint8_t exhausted;   /*!< No paint left: used is at least this     */
+} watermark_stack_t;
+
+#if WATERMARK_USE_LATENCY
+/* First thing in the handler: the latency ends at this read */
+#define WATERMARK_SYSTICK_ENTRY() \
+	Watermark_Record(WATERMARK_IRQ_SYSTICK, SysTick->LOAD - SysTick->VAL)
+#define WATERMARK_TIM6_ENTRY() \
+	Watermark_Record(WATERMARK_IRQ_TIM6, TIM6->CNT)
+#else
+#define WATERMARK_SYSTICK_ENTRY() ((void) 0)
+#define WATERMARK_TIM6_ENTRY()    ((void) 0)
+#endif /* WATERMARK_USE_LATENCY */
+
+/**
+ * @brief Measures the main stack use from the paint left.
+ */
+void Watermark_GetStack(watermark_stack_t *stack);
+
+#if WATERMARK_USE_LATENCY
+
+/**
+ * @brief Sets the tick scales; claims TIM11 and starts the probe with
+ *        WATERMARK_USE_PROBE. Call after Perf_Init().
+ */
+void Watermark_Init(void);
+
+/**
+ * @brief Records a handler entry; ticks since its event, in the unit of
+ *        the timer that timestamps it. Use WATERMARK_*_ENTRY().
+ */
+void Watermark_Record(watermark_irq_t irq, uint32_t ticks);
+
+/**
+ * @brief Copies the latency of one handler.
+ */
+void Watermark_GetLatency(watermark_irq_t irq, watermark_lat_t *lat);
+
+/**
+ * @brief Clears the latencies; from Perf_Reset().
+ */
+void Watermark_ResetLatency(void);
+
+/**
+ * @brief Short printable name of a measured handler.
+ */
+const char* Watermark_IrqName(watermark_irq_t irq);
+
+/**
+ * @brief Recomputes the tick scales and the TIM11 prescaler after a clock
+ *        profile change.
+ */
+void Watermark_ClockChanged(void);
+
+#endif /* WATERMARK_USE_LATENCY */
+
+#if WATERMARK_USE_PROBE
+
+/**
+ * @brief TIM11 compare: records the probe and schedules the next one.
+ * @param cnt: TIM11->CNT, read first thing in the handler.
+ */
+void Watermark_ProbeIRQHandler(uint32_t cnt);
+
+#endif /* WATERMARK_USE_PROBE */
+
+#endif /* WATERMARK_H_ */
@@ -0,0 +1,262 @@
+/**
+ ******************************************************************************
+ * @file           : adc_mon.c
+ * @brief          : ADC1 monitor: die temperature, supply voltage and
+ *                   optional analog inputs.
+ *
+ *                   The buffer holds the scans rank by rank, so word i is
+ *                   channel i % ADC_MON_CHANNELS wherever the DMA stands.
+ *                   An overrun restarts the stream at word 0 and the
+ *                   sequence at rank 1 together, which keeps that true.
+ *                   Sums stay in 32 bits: 16 scans of 12 bits times 3.6 V.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "adc_mon.h"
+
+#if ADC_MON_USE_ADC
+#include "dht11_delta.h"
+#include "clock_config.h"
+#include "irq_prio.h"
+
+/** Factory calibration, system memory (RM0390 / DS10693) */
+#define ADC_MON_VREFINT_CAL  (*((const uint16_t *) 0x1FFF7A2AUL))
+#define ADC_MON_TS_CAL1      (*((const uint16_t *) 0x1FFF7A2CUL))
+#define ADC_MON_TS_CAL2      (*((const uint16_t *) 0x1FFF7A2EUL))
+#define ADC_MON_CAL_MV       (3300U)  /*!< VDDA the values were taken at */
+#define ADC_MON_CAL1_TENTHS  (300)
+#define ADC_MON_CAL2_TENTHS  (1100)
+
+/** Ranks: VREFINT, temperature sensor, then the analog inputs */
+#define ADC_MON_CHANNELS     (2U + ADC_MON_EXT_INPUTS)
+#define ADC_MON_WORDS        (ADC_MON_CHANNELS * ADC_MON_SCANS)
+
+#define ADC_MON_CH_VREFINT   (17U)
+#define ADC_MON_CH_TEMP      (18U)
+#define ADC_MON_CH_A2        (4U)   /* PA4 */
+#define ADC_MON_CH_A3        (8U)   /* PB0 */
+
+/** 480 ADC clocks: over the 10 us the temperature sensor needs */
+#define ADC_MON_SMP          (7UL)
+
+/** TIM3 count rate */
+#define ADC_MON_TIM_HZ       (10000U)
+
+/** ADCCLK = PCLK2 / 4: 22.5 MHz at 180 MHz, under the 36 MHz limit */
+#define ADC_MON_ADCPRE       (ADC_CCR_ADCPRE_0)
+
+/** TIM3 TRGO as the regular trigger, rising edge */
+#define ADC_MON_EXTSEL_TIM3  (8UL)
+
+static volatile uint16_t adc_buf[ADC_MON_WORDS];
+static uint32_t adc_brown_raw = 0xFFFU;   /* VREFINT at ADC_MON_BROWNOUT_MV */
+static uint32_t adc_recover_raw = 0U;     /* ... plus the hysteresis      */
+static uint32_t adc_start_ms = 0U;
+
+/* Written by the handler */
+static volatile uint32_t adc_brownouts = 0U;
+static volatile uint32_t adc_last_ms = 0U;
+static volatile uint32_t adc_overruns = 0U;
+static volatile uint8_t adc_low = 0U;
+
+static uint32_t adc_checked = 0U;
+static uint32_t adc_disagree = 0U;
+
+/**
+ * @brief Sets TIM3 to ADC_MON_TIM_HZ from the APB1 timer clock.
+ */
+static void Adc_Mon_Prescaler(void) {
+	TIM3->PSC = (Clock_GetApb1TimerHz() / ADC_MON_TIM_HZ) - 1U;
+}
+
+/**
+ * @brief (Re)starts the circular stream at word 0.
+ */
+static void Adc_Mon_StartDma(void) {
+	ADC1->CR2 &= ~ADC_CR2_DMA;
+	DMA2_Stream4->CR &= ~DMA_SxCR_EN;
+	while ((DMA2_Stream4->CR & DMA_SxCR_EN) != 0U) {
+		/* The stream finishes its current transfer */
+	}
+	DMA2->HIFCR = DMA_HIFCR_CTCIF4 | DMA_HIFCR_CHTIF4 | DMA_HIFCR_CTEIF4
+			| DMA_HIFCR_CDMEIF4 | DMA_HIFCR_CFEIF4;
+	DMA2_Stream4->NDTR = ADC_MON_WORDS;
+	DMA2_Stream4->CR |= DMA_SxCR_EN;
+	ADC1->CR2 |= ADC_CR2_DMA;
+	adc_start_ms = HAL_GetTick();
+}
+
+/**
+ * @brief Configures ADC1, DMA2 Stream4 and TIM3 and starts the scans.
+ */
+void Adc_Mon_Init(void) {
+	__HAL_RCC_ADC1_CLK_ENABLE();
+	__HAL_RCC_DMA2_CLK_ENABLE();
+	__HAL_RCC_TIM3_CLK_ENABLE();
+#if ADC_MON_USE_EXT
+	__HAL_RCC_GPIOA_CLK_ENABLE();
+	__HAL_RCC_GPIOB_CLK_ENABLE();
+	GPIOA->MODER |= GPIO_MODER_MODER4;    /* Analog */
+	GPIOB->MODER |= GPIO_MODER_MODER0;
+#endif /* ADC_MON_USE_EXT */
+
+	/* VREFINT and the temperature sensor on; VBAT off, it shares IN18 */
+	ADC->CCR = (ADC->CCR & ~(ADC_CCR_ADCPRE | ADC_CCR_VBATE)) | ADC_MON_ADCPRE
+			| ADC_CCR_TSVREFE;
+
+	adc_brown_raw = (ADC_MON_VREFINT_CAL * ADC_MON_CAL_MV) / ADC_MON_BROWNOUT_MV;
+	adc_recover_raw = (ADC_MON_VREFINT_CAL * ADC_MON_CAL_MV)
+			/ (ADC_MON_BROWNOUT_MV + ADC_MON_BROWNOUT_HYST_MV);
+
+	ADC1->CR2 = 0U;
+	ADC1->CR1 = ADC_CR1_SCAN | ADC_CR1_AWDEN | ADC_CR1_AWDSGL | ADC_CR1_AWDIE
+			| ADC_CR1_OVRIE | (ADC_MON_CH_VREFINT << ADC_CR1_AWDCH_Pos);
+	ADC1->SMPR1 = (ADC_MON_SMP << ADC_SMPR1_SMP17_Pos)
+			| (ADC_MON_SMP << ADC_SMPR1_SMP18_Pos);
+	ADC1->SMPR2 = (ADC_MON_SMP << ADC_SMPR2_SMP4_Pos)
+			| (ADC_MON_SMP << ADC_SMPR2_SMP8_Pos);
+	ADC1->SQR1 = (ADC_MON_CHANNELS - 1U) << ADC_SQR1_L_Pos;
+	ADC1->SQR3 = ADC_MON_CH_VREFINT | (ADC_MON_CH_TEMP << 5U)
+			| ((ADC_MON_USE_EXT != 0) ?
+					((ADC_MON_CH_A2 << 10U) | (ADC_MON_CH_A3 << 15U)) : 0U);
+	ADC1->LTR = 0U;
+	ADC1->HTR = adc_brown_raw;
+	ADC1->SR = 0U;
+
+	DMA2_Stream4->CR = 0U;
+	while ((DMA2_Stream4->CR & DMA_SxCR_EN) != 0U) {
+	}
+	DMA2_Stream4->PAR = (uint32_t) &ADC1->DR;
+	DMA2_Stream4->M0AR = (uint32_t) adc_buf;
+	DMA2_Stream4->FCR = 0U; /* Direct mode */
+	/* Channel 0 (ADC1), peripheral to memory, halfwords, circular */
+	DMA2_Stream4->CR = DMA_SxCR_MSIZE_0 | DMA_SxCR_PSIZE_0 | DMA_SxCR_MINC
+			| DMA_SxCR_CIRC | DMA_SxCR_PL_0;
+
+	ADC1->CR2 = ADC_CR2_DDS | (ADC_MON_EXTSEL_TIM3 << ADC_CR2_EXTSEL_Pos)
+			| ADC_CR2_EXTEN_0 | ADC_CR2_ADON;
+	Adc_Mon_StartDma();
+
+	HAL_NVIC_SetPriority(ADC_IRQn, IRQ_PRIO_WAKEUP, 0U);
+	HAL_NVIC_EnableIRQ(ADC_IRQn);
+
+	/* TIM3 update as TRGO, once per scan */
+	TIM3->CR1 = 0U;
+	TIM3->CR2 = TIM_CR2_MMS_1;
+	Adc_Mon_Prescaler();
+	TIM3->ARR = (ADC_MON_TIM_HZ / ADC_MON_SCAN_HZ) - 1U;
+	TIM3->EGR = TIM_EGR_UG;
+	TIM3->CR1 = TIM_CR1_CEN;
+}
+
+/**
+ * @brief Averages the buffer into calibrated values.
+ */
+void Adc_Mon_Get(adc_mon_values_t *values) {
+	uint32_t sum[ADC_MON_CHANNELS] = { 0U };
+	uint32_t ts;
+	uint32_t i;
+
+	for (i = 0U; i < ADC_MON_WORDS; i++) {
+		sum[i % ADC_MON_CHANNELS] += adc_buf[i];
+	}
+	values->valid = ((sum[0] != 0U) && ((HAL_GetTick() - adc_start_ms)
+			> ((ADC_MON_SCANS * 1000U) / ADC_MON_SCAN_HZ))) ? 1U : 0U;
+	values->ext_mv[0] = 0U;
+	values->ext_mv[1] = 0U;
+	if (sum[0] == 0U) {
+		values->vdda_mv = 0U;
+		values->die_tenths = 0;
+		return;
+	}
+
+	values->vdda_mv = (ADC_MON_CAL_MV * ADC_MON_VREFINT_CAL * ADC_MON_SCANS)
+			/ sum[0];
+	/* The calibration points were taken at 3.3 V: scale the reading there */
+	ts = (sum[1] * values->vdda_mv) / ADC_MON_CAL_MV;
+	values->die_tenths = ADC_MON_CAL1_TENTHS
+			+ (((ADC_MON_CAL2_TENTHS - ADC_MON_CAL1_TENTHS)
+					* ((int32_t) ts - (int32_t) (ADC_MON_TS_CAL1 * ADC_MON_SCANS)))
+					/ ((int32_t) (ADC_MON_TS_CAL2 - ADC_MON_TS_CAL1)
+							* (int32_t) ADC_MON_SCANS));
+#if ADC_MON_USE_EXT
+	for (i = 0U; i < ADC_MON_EXT_INPUTS; i++) {
+		values->ext_mv[i] = (sum[2U + i] * values->vdda_mv)
+				/ (4095U * ADC_MON_SCANS);
+	}
+#endif /* ADC_MON_USE_EXT */
+}
+
+/**
+ * @brief Compares an emitted DHT11 reading with the die temperature.
+ */
+void Adc_Mon_Check(const dht11_reading_t *reading) {
+	adc_mon_values_t values;
+	int32_t diff;
+
+	if (reading->status != DHT11_OK) {
+		return;
+	}
+	Adc_Mon_Get(&values);
+	if (values.valid == 0U) {
+		return;
+	}
+	diff = (int32_t) DHT11_Delta_TempTenths(reading) - values.die_tenths;
+	adc_checked++;
+	if ((diff > ADC_MON_TEMP_TOLERANCE) || (diff < -ADC_MON_TEMP_TOLERANCE)) {
+		adc_disagree++;
+	}
+}
+
+/**
+ * @brief Fills the monitor counters.
+ */
+void Adc_Mon_GetStats(adc_mon_stats_t *stats) {
+	stats->brownouts = adc_brownouts;
+	stats->last_ms = adc_last_ms;
+	stats->overruns = adc_overruns;
+	stats->checked = adc_checked;
+	stats->disagree = adc_disagree;
+	stats->low = adc_low;
+}
+
+/**
+ * @brief Recomputes the TIM3 prescaler; it applies from the next update.
+ */
+void Adc_Mon_ClockChanged(void) {
+	Adc_Mon_Prescaler();
+}
+
+/**
+ * @brief Analog watchdog: swaps the VREFINT window between the brownout
+ *        and the recovery threshold. Overrun: restarts the stream.
+ */
+void Adc_Mon_IRQHandler(void) {
+	uint32_t sr = ADC1->SR;
+
+	if ((sr & ADC_SR_OVR) != 0U) {
+		ADC1->SR = ~ADC_SR_OVR;
+		adc_overruns++;
+		Adc_Mon_StartDma();
+	}
+	if ((sr & ADC_SR_AWD) != 0U) {
+		ADC1->SR = ~ADC_SR_AWD;
+		if (adc_low == 0U) {
+			/* VREFINT reads high: VDDA fell */
+			adc_low = 1U;
+			adc_brownouts++;
+			adc_last_ms = HAL_GetTick();
+			ADC1->HTR = 0xFFFU;
+			ADC1->LTR = adc_recover_raw;
+		} else {
+			adc_low = 0U;
+			ADC1->LTR = 0U;
+			ADC1->HTR = adc_brown_raw;
+		}
+	}
+}
+#endif /* ADC_MON_USE_ADC */
@@ -0,0 +1,402 @@
+/**
+ ******************************************************************************
+ * @file           : app_bench.c
+ * @brief          : On-target micro-benchmarks of the driver APIs.
+ *
+ *                   A case is a function returning non-zero on failure,
+ *                   with an optional untimed step between calls (a
+ *                   drain, the sensor's spacing). A pass at one profile
+ *                   first times the empty case, whose minimum is the
+ *                   harness overhead taken off every other case.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "app_bench.h"
+
+#if APP_USE_BENCH
+#include "dht11.h"
+#include "dht11_pin.h"
+#include "dht11_capture.h"
+#include "dht11_classify.h"
+#include "dht11_driver.h"
+#include "dht11_drift.h"
+#include "dht11_exti.h"
+#include "dht11_health.h"
+#include "dht11_oversample.h"
+#include "dht11_prof.h"
+#include "uart_tx.h"
+#include "clock_config.h"
+#include "dvfs.h"
+#include "timebase.h"
+#include "irq_prio.h"
+#include "stm32f4xx_ll_gpio.h"
+#include <stdio.h>
+#include <stddef.h>
+
+extern UART_HandleTypeDef huart2;
+
+/** The case needs interrupts: the TX drain or the frame read */
+#define BENCH_IRQ    (1U << 0)
+/** Console output is discarded while it runs (UART_TX_TRANSPORT_NONE) */
+#define BENCH_QUIET  (1U << 1)
+
+/** Bytes per UART write case */
+#define BENCH_TX_LEN (16U)
+
+/** Sensor whose classifier the edge decoder uses: a period-measuring one */
+#define BENCH_EDGE_SENSOR (DHT11_CLASSIFY_SENSORS - 1U)
+
+#if UART_TX_USE_DMA
+#define BENCH_TX_BACKEND "dma"
+#else
+#define BENCH_TX_BACKEND "txe"
+#endif /* UART_TX_USE_DMA */
+
+#if DHT11_USE_EXTI
+#define BENCH_DECODER "exti"
+#elif DHT11_USE_OVERSAMPLE
+#define BENCH_DECODER "oversample"
+#elif DHT11_USE_CAPTURE
+#define BENCH_DECODER "capture"
+#else
+#define BENCH_DECODER "bitbang"
+#endif /* DHT11_USE_EXTI / DHT11_USE_OVERSAMPLE / DHT11_USE_CAPTURE */
+
+typedef struct {
+	const char *name;
+	const char *backend;
+	uint32_t (*run)(void);
+	void (*between)(void); /*!< Untimed, after every call, or NULL */
+	uint32_t runs;
+	uint32_t flags;
+} bench_case_t;
+
+/* 0x37 0x00 0x17 0x05 -> checksum 0x53: 55 %RH, 23.5 C */
+static const uint8_t bench_frame[5] = { 0x37U, 0x00U, 0x17U, 0x05U, 0x53U };
+static uint8_t bench_tx[BENCH_TX_LEN];
+static uint16_t bench_widths[40];
+static uint32_t bench_edges[DHT11_CAPTURE_EDGES];
+static dht11_classifier_t bench_cls;
+static uint8_t bench_data[5];
+static volatile uint32_t bench_sink;
+
+static uint32_t Bench_Empty(void) {
+	return 0U;
+}
+
+static uint32_t Bench_DelayUs1(void) {
+	delay_us(1U);
+	return 0U;
+}
+
+static uint32_t Bench_DelayUs10(void) {
+	delay_us(10U);
+	return 0U;
+}
+
+static uint32_t Bench_TimebaseDelayUs10(void) {
+	Timebase_DelayUs(10U);
+	return 0U;
+}
+
+static uint32_t Bench_DelayCycles100(void) {
+	Timebase_DelayCycles(100U);
+	return 0U;
+}
+
+static uint32_t Bench_DelayNs500(void) {
+	Timebase_DelayNs(500U);
+	return 0U;
+}
+
+static uint32_t Bench_DelayUsShort1(void) {
+	Timebase_DelayUsShort(1U);
+	return 0U;
+}
+
+static uint32_t Bench_ReadHal(void) {
+	bench_sink = (uint32_t) HAL_GPIO_ReadPin(DHT_PIN_GPIO_Port, DHT_PIN_Pin);
+	return 0U;
+}
+
+static uint32_t Bench_ReadLl(void) {
+	bench_sink = LL_GPIO_IsInputPinSet(DHT_PIN_GPIO_Port, DHT_PIN_Pin);
+	return 0U;
+}
+
+static uint32_t Bench_ReadReg(void) {
+	bench_sink = DHT11_Pin_Read();
+	return 0U;
+}
+
+/* The writes only release the line: the sensor never sees a start */
+static uint32_t Bench_ReleaseHal(void) {
+	HAL_GPIO_WritePin(DHT_PIN_GPIO_Port, DHT_PIN_Pin, GPIO_PIN_SET);
+	return 0U;
+}
+
+static uint32_t Bench_ReleaseLl(void) {
+	LL_GPIO_SetOutputPin(DHT_PIN_GPIO_Port, DHT_PIN_Pin);
+	return 0U;
+}
+
+static uint32_t Bench_ReleaseReg(void) {
+	DHT11_Pin_Release();
+	return 0U;
+}
+
+static uint32_t Bench_SetPinInput(void) {
+	DHT11_SetPinInput();
+	return 0U;
+}
+
+static uint32_t Bench_SetPinOutput(void) {
+	DHT11_SetPinOutput();
+	return 0U;
+}
+
+static uint32_t Bench_Printf(void) {
+	return (printf("T=23.5C H=55.0%%\r\n") > 0) ? 0U : 1U;
+}
+
+static uint32_t Bench_HalTransmit(void) {
+	return (HAL_UART_Transmit(&huart2, bench_tx, BENCH_TX_LEN, 10U) == HAL_OK) ?
+			0U : 1U;
+}
+
+static uint32_t Bench_TxWrite(void) {
+	return (UART_TX_Write(bench_tx, BENCH_TX_LEN) == BENCH_TX_LEN) ? 0U : 1U;
+}
+
+static uint32_t Bench_TxWriteFlush(void) {
+	if (UART_TX_Write(bench_tx, BENCH_TX_LEN) != BENCH_TX_LEN) {
+		return 1U;
+	}
+	return (UART_TX_Flush(10U) != 0U) ? 0U : 1U;
+}
+
+static uint32_t Bench_DecodeEdges(void) {
+	return (DHT11_Capture_DecodeEdges(bench_edges, (uint8_t) BENCH_EDGE_SENSOR,
+			bench_data) == DHT11_OK) ? 0U : 1U;
+}
+
+static uint32_t Bench_Classify(void) {
+	DHT11_Classify(&bench_cls, bench_widths, bench_data);
+	return (bench_data[4] == bench_frame[4]) ? 0U : 1U;
+}
+
+static uint32_t Bench_DecodeDht11(void) {
+	uint8_t raw[5] = { bench_frame[0], bench_frame[1], bench_frame[2],
+			bench_frame[3], bench_frame[4] };
+
+	return (dht11_driver_dht11.decode(raw) == DHT11_OK) ? 0U : 1U;
+}
+
+static uint32_t Bench_DecodeDht22(void) {
+	/* 55.0 %RH, 23.5 C in DHT22 tenths */
+	uint8_t raw[5] = { 0x02U, 0x26U, 0x00U, 0xEBU, 0x13U };
+
+	return (dht11_driver_dht22.decode(raw) == DHT11_OK) ? 0U : 1U;
+}
+
+static uint32_t Bench_ReadOnce(void) {
+	return (DHT11_ReadOnce(bench_data) == DHT11_OK) ? 0U : 1U;
+}
+
+static void Bench_Drain(void) {
+	(void) UART_TX_Flush(100U);
+}
+
+static void Bench_Spacing(void) {
+	HAL_Delay(DHT11_Health_MinSpacingMs(0U));
+}
+
+static const bench_case_t bench_cases[] = {
+	{ "empty", "-", Bench_Empty, NULL, APP_BENCH_RUNS, 0U },
+	{ "delay_us_1", "dwt", Bench_DelayUs1, NULL, APP_BENCH_RUNS, 0U },
+	{ "delay_us_10", "dwt", Bench_DelayUs10, NULL, APP_BENCH_RUNS, 0U },
+	{ "timebase_delay_10", "dwt", Bench_TimebaseDelayUs10, NULL,
+			APP_BENCH_RUNS, 0U },
+	{ "delay_cycles_100", "inline", Bench_DelayCycles100, NULL,
+			APP_BENCH_RUNS, 0U },
+	{ "delay_ns_500", "inline", Bench_DelayNs500, NULL, APP_BENCH_RUNS, 0U },
+	{ "delay_us_short_1", "inline", Bench_DelayUsShort1, NULL,
+			APP_BENCH_RUNS, 0U },
+	{ "gpio_read", "hal", Bench_ReadHal, NULL, APP_BENCH_RUNS, 0U },
+	{ "gpio_read", "ll", Bench_ReadLl, NULL, APP_BENCH_RUNS, 0U },
+	{ "gpio_read", "reg", Bench_ReadReg, NULL, APP_BENCH_RUNS, 0U },
+	{ "gpio_release", "hal", Bench_ReleaseHal, NULL, APP_BENCH_RUNS, 0U },
+	{ "gpio_release", "ll", Bench_ReleaseLl, NULL, APP_BENCH_RUNS, 0U },
+	{ "gpio_release", "reg", Bench_ReleaseReg, NULL, APP_BENCH_RUNS, 0U },
+	{ "set_pin_input", "reg", Bench_SetPinInput, NULL, APP_BENCH_RUNS, 0U },
+	{ "set_pin_output", "reg", Bench_SetPinOutput, NULL, APP_BENCH_RUNS, 0U },
+	{ "printf_line", "ring", Bench_Printf, NULL, APP_BENCH_RUNS, BENCH_QUIET },
+	{ "uart_tx_16", "hal_blocking", Bench_HalTransmit, NULL, APP_BENCH_RUNS,
+			0U },
+	{ "uart_tx_16", BENCH_TX_BACKEND, Bench_TxWrite, Bench_Drain,
+			APP_BENCH_RUNS, 0U },
+	{ "uart_tx_16_flush", BENCH_TX_BACKEND, Bench_TxWriteFlush, NULL,
+			APP_BENCH_RUNS, BENCH_IRQ },
+	{ "decode_edges", "capture", Bench_DecodeEdges, NULL, APP_BENCH_RUNS, 0U },
+	{ "classify", "sensor0", Bench_Classify, NULL, APP_BENCH_RUNS, 0U },
+	{ "driver_decode", "dht11", Bench_DecodeDht11, NULL, APP_BENCH_RUNS, 0U },
+	{ "driver_decode", "dht22", Bench_DecodeDht22, NULL, APP_BENCH_RUNS, 0U },
+	{ "read_frame", BENCH_DECODER, Bench_ReadOnce, Bench_Spacing,
+			APP_BENCH_FRAME_RUNS, BENCH_IRQ | BENCH_QUIET }
+};
+
+#define BENCH_CASES (sizeof(bench_cases) / sizeof(bench_cases[0]))
+
+/**
+ * @brief Builds the synthetic frame from the nominal bit widths: widths
+ *        as sensor 0's classifier measures them, edges as the capture
+ *        path's falling-to-falling periods.
+ */
+static void Bench_Synthesize(void) {
+	const dht11_classifier_t *edge_cls = DHT11_Classify_Get(BENCH_EDGE_SENSOR);
+	uint32_t bit;
+	uint32_t one;
+
+	bench_cls = *DHT11_Classify_Get(0U);
+	bench_edges[0] = 0U;
+	bench_edges[1] = 160U; /* 80 us LOW + 80 us HIGH */
+	for (bit = 0U; bit < 40U; bit++) {
+		one = (bench_frame[bit / 8U] >> (7U - (bit % 8U))) & 1U;
+		bench_widths[bit] = (uint16_t) (((one != 0U) ? bench_cls.one_q4 :
+				bench_cls.zero_q4) >> 4);
+		bench_edges[bit + 2U] = bench_edges[bit + 1U]
+				+ (((one != 0U) ? edge_cls->one_q4 : edge_cls->zero_q4) >> 4);
+	}
+	for (bit = 0U; bit < BENCH_TX_LEN; bit++) {
+		bench_tx[bit] = (uint8_t) ((bit < (BENCH_TX_LEN - 2U)) ? ('0' + (bit % 10U)) :
+				((bit == (BENCH_TX_LEN - 2U)) ? '\r' : '\n'));
+	}
+}
+
+/**
+ * @brief Sorts the samples in place; there are at most APP_BENCH_RUNS.
+ */
+static void Bench_Sort(uint32_t *cycles, uint32_t n) {
+	uint32_t i;
+	uint32_t j;
+	uint32_t v;
+
+	for (i = 1U; i < n; i++) {
+		v = cycles[i];
+		for (j = i; (j > 0U) && (cycles[j - 1U] > v); j--) {
+			cycles[j] = cycles[j - 1U];
+		}
+		cycles[j] = v;
+	}
+}
+
+/**
+ * @brief Times one case and prints its row.
+ * @param overhead: Harness cycles to take off each call.
+ * @retval Minimum cycles of the case before the overhead is taken off.
+ */
+static uint32_t Bench_Case(const bench_case_t *bc, uint32_t overhead) {
+	uint32_t cycles[APP_BENCH_RUNS];
+	uint32_t fails = 0U;
+	uint32_t basepri = 0U;
+	uint32_t start;
+	uint32_t n;
+	uint32_t i;
+
+	n = (bc->runs < APP_BENCH_RUNS) ? bc->runs : APP_BENCH_RUNS;
+	Bench_Drain();
+	if ((bc->flags & BENCH_QUIET) != 0U) {
+		(void) UART_TX_SetTransport(UART_TX_TRANSPORT_NONE);
+	}
+	/* One untimed call fills the ART caches as a live call finds them */
+	(void) bc->run();
+	if (bc->between != NULL) {
+		bc->between();
+	}
+	for (i = 0U; i < n; i++) {
+		if ((bc->flags & BENCH_IRQ) == 0U) {
+			basepri = Irq_MaskFrom(IRQ_PRIO_TIMEBASE);
+		}
+		start = DWT->CYCCNT;
+		fails += bc->run();
+		cycles[i] = DWT->CYCCNT - start;
+		if ((bc->flags & BENCH_IRQ) == 0U) {
+			Irq_Unmask(basepri);
+		}
+		cycles[i] = (cycles[i] > overhead) ? (cycles[i] - overhead) : 0U;
+		if (bc->between != NULL) {
+			bc->between();
+		}
+	}
+	if ((bc->flags & BENCH_QUIET) != 0U) {
+		(void) UART_TX_SetTransport(UART_TX_TRANSPORT_USART2);
+	}
+
+	Bench_Sort(cycles, n);
+	printf("bench,%s,%lu,%s,%s,%lu,%lu,%lu,%lu,%lu,%lu\r\n",
+			Clock_GetProfileName(Clock_GetProfile()), HAL_RCC_GetSysClockFreq(),
+			bc->name, bc->backend, n, cycles[0], cycles[n / 2U],
+			cycles[n - 1U],
+			(uint32_t) (((uint64_t) cycles[n / 2U] * 1000U)
+					/ Timebase_CyclesPerUs()), fails);
+	Bench_Drain();
+	return cycles[0] + overhead;
+}
+
+/**
+ * @brief Switches profile the way the clock command does.
+ */
+static HAL_StatusTypeDef Bench_SetProfile(clock_profile_t profile) {
+	Bench_Drain(); /* The baud rate divisor changes with PCLK1 */
+#if DVFS_USE_SCALING
+	return Dvfs_SetBurstProfile(profile);
+#else
+	return Clock_SetProfile(profile);
+#endif /* DVFS_USE_SCALING */
+}
+
+/**
+ * @brief Runs every case at every clock profile and prints the table.
+ */
+void AppBench_Run(void) {
+	clock_profile_t original = Clock_GetProfile();
+	uint32_t overhead;
+	uint32_t profile;
+	uint32_t i;
+
+	Bench_Synthesize();
+	printf("bench,build,%s %s,tx=%s,decoder=%s,fastpath=%d,runs=%lu\r\n",
+			__DATE__, __TIME__, BENCH_TX_BACKEND, BENCH_DECODER,
+			APP_USE_FASTPATH, (uint32_t) APP_BENCH_RUNS);
+	printf("bench,profile,sysclk_hz,case,backend,runs,min_cyc,med_cyc,max_cyc,"
+			"med_ns,fails\r\n");
+	for (profile = 0U; profile < (uint32_t) CLOCK_PROFILE_COUNT; profile++) {
+		if (Bench_SetProfile((clock_profile_t) profile) != HAL_OK) {
+			printf("bench,%s,switch failed\r\n",
+					Clock_GetProfileName((clock_profile_t) profile));
+			continue;
+		}
+		overhead = Bench_Case(&bench_cases[0], 0U);
+		for (i = 1U; i < BENCH_CASES; i++) {
+			(void) Bench_Case(&bench_cases[i], overhead);
+		}
+	}
+	if ((Clock_GetProfile() != original)
+			&& (Bench_SetProfile(original) != HAL_OK)) {
+		printf("bench,restore failed\r\n");
+	}
+
+	/* The synthetic frames were learnt and profiled like real ones */
+	DHT11_Classify_Init();
+	DHT11_Drift_Init();
+#if DHT11_USE_PROFILE
+	DHT11_Prof_Reset();
+#endif /* DHT11_USE_PROFILE */
+	DHT11_Pin_Init();
+	printf("bench,done\r\n");
+}
+#endif /* APP_USE_BENCH */
@@ -0,0 +1,41 @@
+/**
+ ******************************************************************************
+ * @file           : app_pools.c
+ * @brief          : Fixed-block pools (pool.h) of the application.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "app_pools.h"
+#include <stdio.h>
+
+app_reading_pool_t app_reading_pool;
+app_packet_pool_t app_packet_pool;
+app_record_pool_t app_record_pool;
+
+/**
+ * @brief Marks every block of every pool free.
+ */
+void AppPools_Init(void) {
+	AppReadingPool_Init(&app_reading_pool);
+	AppPacketPool_Init(&app_packet_pool);
+	AppRecordPool_Init(&app_record_pool);
+}
+
+/**
+ * @brief Prints the low-water mark of each pool and the failed allocations.
+ */
+void AppPools_Dump(void) {
+	printf("pool_readings_min %lu\r\n",
+			AppReadingPool_MinAvailable(&app_reading_pool));
+	printf("pool_packets_min %lu\r\n",
+			AppPacketPool_MinAvailable(&app_packet_pool));
+	printf("pool_records_min %lu\r\n",
+			AppRecordPool_MinAvailable(&app_record_pool));
+	printf("pool_fails %lu\r\n", AppReadingPool_Fails(&app_reading_pool)
+			+ AppPacketPool_Fails(&app_packet_pool)
+			+ AppRecordPool_Fails(&app_record_pool));
+}
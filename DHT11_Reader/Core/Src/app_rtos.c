@@ -0,0 +1,350 @@
+/**
+ ******************************************************************************
+ * @file           : app_rtos.c
+ * @brief          : Optional FreeRTOS build with a top-priority sensor task.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "app_rtos.h"
+
+#if APP_USE_RTOS
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "dht11.h"
+#include "dht11_async.h"
+#include "dht11_multi.h"
+#include "dht11_sink.h"
+#include "dht11_health.h"
+#include "dht11_sampler.h"
+#include "dht11_supply.h"
+#include "dht11_sync.h"
+#include "dht11_trigger.h"
+#include "dht11_queue.h"
+#include "power.h"
+#include "cli.h"
+#include "dlog.h"
+#include "flashlog.h"
+#include "watchdog.h"
+#include "fmt.h"
+#include "perf.h"
+#include "telemetry.h"
+#include <stdio.h>
+
+#if DHT11_USE_ASYNC
+#error "APP_USE_RTOS runs the blocking driver: set DHT11_USE_ASYNC to 0"
+#endif
+
+#if POWER_USE_STOP
+#error "APP_USE_RTOS has no tickless idle: set POWER_USE_STOP to 0"
+#endif
+
+/* Sensor -> telemetry readings */
+static dht11_queue_t rtos_queue;
+static volatile uint32_t rtos_dropped = 0U;
+
+static StaticTask_t rtos_sensor_tcb;
+static StaticTask_t rtos_telemetry_tcb;
+static StaticTask_t rtos_service_tcb;
+static StaticTask_t rtos_idle_tcb;
+static StackType_t rtos_sensor_stack[APP_RTOS_STACK_SENSOR];
+static StackType_t rtos_telemetry_stack[APP_RTOS_STACK_TELEMETRY];
+static StackType_t rtos_service_stack[APP_RTOS_STACK_SERVICE];
+static StackType_t rtos_idle_stack[configMINIMAL_STACK_SIZE];
+
+static TaskHandle_t rtos_sensor = NULL;
+static TaskHandle_t rtos_telemetry = NULL;
+static TaskHandle_t rtos_service = NULL;
+
+/* Serialises printf between the telemetry and service tasks */
+static StaticSemaphore_t rtos_print_buf;
+static SemaphoreHandle_t rtos_print = NULL;
+
+/* The sensor task is in its cadence delay, not in a read's own waits */
+static volatile uint8_t rtos_waiting = 0U;
+#if DHT11_USE_TRIGGER
+/* An on-demand request waits for the sensor's spacing (service task) */
+static uint8_t rtos_trigger = 0U;
+/* The sensor task's delay was cut short for it: restart the cadence */
+static volatile uint8_t rtos_triggered = 0U;
+#endif /* DHT11_USE_TRIGGER */
+
+/* Liveness tokens of the sensor and service tasks */
+static uint8_t rtos_wdg_sensor = WATCHDOG_NO_TOKEN;
+static uint8_t rtos_wdg_service = WATCHDOG_NO_TOKEN;
+
+/**
+ * @brief Queues a reading for the telemetry task; drops it when full.
+ */
+static void AppRtos_Push(const dht11_reading_t *reading) {
+	if (DHT11_Queue_Push(&rtos_queue, reading) == 0U) {
+		rtos_dropped++;
+	}
+}
+
+#if DHT11_USE_TRIGGER
+/**
+ * @brief Takes a B1 press or "read" command (dht11_trigger.h) and, once
+ *        the planned sensors may start, cuts the sensor task's delay.
+ */
+static void AppRtos_Trigger(void) {
+#if DHT11_USE_MULTI
+	uint32_t mask = (1UL << DHT11_MULTI_CHANNELS) - 1U;
+#else
+	uint32_t mask = 1UL << 0U;
+#endif /* DHT11_USE_MULTI */
+
+	if (DHT11_Trigger_Take() != 0U) {
+		rtos_trigger = 1U;
+	}
+	if ((rtos_trigger == 0U) || (DHT11_PowerUpRemainingMs() != 0U)
+			|| (DHT11_Sampler_Request(mask, HAL_GetTick()) != 0U)) {
+		return;
+	}
+	rtos_trigger = 0U;
+	/* Held so the sensor task cannot leave its delay and block in a read
+	 * between the test and the abort; if it is already up, it reads now */
+	vTaskSuspendAll();
+	if ((rtos_waiting != 0U) && (xTaskAbortDelay(rtos_sensor) == pdPASS)) {
+		rtos_triggered = 1U;
+	}
+	(void) xTaskResumeAll();
+}
+#endif /* DHT11_USE_TRIGGER */
+
+/**
+ * @brief Acquires readings on a fixed cadence.
+ */
+static void AppRtos_SensorTask(void *arg) {
+#if DHT11_USE_MULTI
+	dht11_reading_t readings[DHT11_MULTI_CHANNELS];
+	uint32_t start_ms;
+	uint32_t delay_ms;
+	uint32_t due;
+	uint32_t ch;
+#else
+	dht11_reading_t reading;
+	uint32_t interval_ms;
+#if DHT11_USE_SYNC
+	uint32_t wait_ms;
+#endif /* DHT11_USE_SYNC */
+	TickType_t wake;
+#endif /* DHT11_USE_MULTI */
+
+	(void) arg;
+	vTaskDelay(pdMS_TO_TICKS(DHT11_PowerUpRemainingMs())); /* Settling */
+#if !DHT11_USE_MULTI
+	wake = xTaskGetTickCount();
+#endif /* !DHT11_USE_MULTI */
+	for (;;) {
+#if DHT11_USE_MULTI
+		start_ms = HAL_GetTick();
+		delay_ms = DHT11_Sampler_Next(start_ms, &due);
+		if (due != 0U) {
+			(void) DHT11_Multi_Read(due, readings);
+			DHT11_Sampler_Done(due, start_ms);
+			for (ch = 0U; ch < DHT11_MULTI_CHANNELS; ch++) {
+				if (((due & (1UL << ch)) != 0U)
+						&& (readings[ch].status != DHT11_ERR_NO_RESPONSE)) {
+					AppRtos_Push(&readings[ch]);
+				}
+			}
+			xTaskNotifyGive(rtos_telemetry);
+			delay_ms = DHT11_Sampler_Next(HAL_GetTick(), &due);
+		}
+		Watchdog_Checkin(rtos_wdg_sensor);
+		rtos_waiting = 1U;
+		vTaskDelay(pdMS_TO_TICKS(delay_ms)); /* The plan keeps the cadence */
+		rtos_waiting = 0U;
+#else
+		interval_ms = DHT11_Sampler_IntervalMs(0U);
+#if DHT11_USE_SUPPLY
+		/* Powered up late: wait out the warm-up, then keep the cadence */
+		vTaskDelay(pdMS_TO_TICKS(DHT11_Supply_ReadyInMs(0U)));
+#endif /* DHT11_USE_SUPPLY */
+		if ((interval_ms != 0U) && (DHT11_Read(&reading) != DHT11_ERR_NO_RESPONSE)) {
+			AppRtos_Push(&reading);
+			xTaskNotifyGive(rtos_telemetry);
+		}
+		Watchdog_Checkin(rtos_wdg_sensor);
+#if DHT11_USE_TRIGGER
+		if (rtos_triggered != 0U) {
+			/* On demand: the period restarts from this reading */
+			rtos_triggered = 0U;
+			wake = xTaskGetTickCount();
+		}
+#endif /* DHT11_USE_TRIGGER */
+		if (interval_ms == 0U) {
+			/* Not sampled: look again later */
+			interval_ms = DHT11_SAMPLER_MIN_PERIOD_MS;
+			wake = xTaskGetTickCount();
+		}
+#if DHT11_USE_SYNC
+		else if (DHT11_Sync_IsLocked() != 0U) {
+			/* Locked: the slot is absolute, not a period from the last wake */
+			wait_ms = DHT11_Sampler_NextStartMs(0U, reading.timestamp_ms)
+					- HAL_GetTick();
+			interval_ms = ((int32_t) wait_ms > 0) ? wait_ms : 0U;
+			wake = xTaskGetTickCount();
+		}
+#endif /* DHT11_USE_SYNC */
+		rtos_waiting = 1U;
+		vTaskDelayUntil(&wake, pdMS_TO_TICKS(interval_ms));
+		rtos_waiting = 0U;
+#endif /* DHT11_USE_MULTI */
+	}
+}
+
+/**
+ * @brief Hands queued readings to the active sink.
+ */
+static void AppRtos_TelemetryTask(void *arg) {
+	dht11_reading_t reading;
+
+	(void) arg;
+	for (;;) {
+		(void) ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+		while (DHT11_Queue_Pop(&rtos_queue, &reading) != 0U) {
+			(void) xSemaphoreTake(rtos_print, portMAX_DELAY);
+#if DHT11_USE_MULTI
+			(void) Fmt_Print("ch%u: ", reading.sensor_id);
+#endif /* DHT11_USE_MULTI */
+			DHT11_Sink_Emit(&reading);
+			(void) xSemaphoreGive(rtos_print);
+		}
+	}
+}
+
+/**
+ * @brief Command line, deferred debug log, flash log dumps, the batch
+ *        deadline (telemetry.h), the sensor supply (dht11_supply.h) and
+ *        on-demand requests (dht11_trigger.h).
+ */
+static void AppRtos_ServiceTask(void *arg) {
+	TickType_t wake = xTaskGetTickCount();
+
+	(void) arg;
+	for (;;) {
+		(void) xSemaphoreTake(rtos_print, portMAX_DELAY);
+		CLI_Poll();
+		(void) DLog_Process(4U);
+		(void) FlashLog_Poll();
+		(void) Telemetry_BatchPoll();
+#if DHT11_USE_SUPPLY
+		(void) DHT11_Supply_Poll(); /* Every APP_RTOS_SERVICE_MS */
+#endif /* DHT11_USE_SUPPLY */
+#if DHT11_USE_TRIGGER
+		AppRtos_Trigger();
+#endif /* DHT11_USE_TRIGGER */
+		(void) xSemaphoreGive(rtos_print);
+		Watchdog_Checkin(rtos_wdg_service);
+		vTaskDelayUntil(&wake, pdMS_TO_TICKS(APP_RTOS_SERVICE_MS));
+	}
+}
+
+/**
+ * @brief Creates the tasks and starts the scheduler.
+ */
+void AppRtos_Start(void) {
+	DHT11_Queue_Init(&rtos_queue);
+	rtos_wdg_sensor = Watchdog_Register("sensor", WATCHDOG_AGE_SENSOR_MS, NULL);
+	rtos_wdg_service = Watchdog_Register("service", WATCHDOG_AGE_SERVICE_MS,
+			NULL);
+	rtos_print = xSemaphoreCreateMutexStatic(&rtos_print_buf);
+	rtos_sensor = xTaskCreateStatic(AppRtos_SensorTask, "sensor",
+			APP_RTOS_STACK_SENSOR, NULL, APP_RTOS_PRIO_SENSOR,
+			rtos_sensor_stack, &rtos_sensor_tcb);
+	rtos_telemetry = xTaskCreateStatic(AppRtos_TelemetryTask, "telemetry",
+			APP_RTOS_STACK_TELEMETRY, NULL, APP_RTOS_PRIO_TELEMETRY,
+			rtos_telemetry_stack, &rtos_telemetry_tcb);
+	rtos_service = xTaskCreateStatic(AppRtos_ServiceTask, "service",
+			APP_RTOS_STACK_SERVICE, NULL, APP_RTOS_PRIO_SERVICE,
+			rtos_service_stack, &rtos_service_tcb);
+
+	vTaskStartScheduler();
+	Error_Handler(); /* Only reached if the idle task could not be created */
+}
+
+/**
+ * @brief Reprograms the kernel tick after a clock profile change.
+ */
+void AppRtos_ClockChanged(void) {
+	SysTick->LOAD = (HAL_RCC_GetHCLKFreq() / configTICK_RATE_HZ) - 1U;
+	SysTick->VAL = 0U;
+}
+
+/**
+ * @brief Prints one line per task and the queue drops.
+ */
+void AppRtos_Dump(void) {
+	TaskHandle_t tasks[] = { rtos_sensor, rtos_telemetry, rtos_service };
+	uint32_t i;
+
+	for (i = 0U; i < (sizeof(tasks) / sizeof(tasks[0])); i++) {
+		printf("task %s prio %lu stack_free %lu\r\n", pcTaskGetName(tasks[i]),
+				(uint32_t) uxTaskPriorityGet(tasks[i]),
+				(uint32_t) uxTaskGetStackHighWaterMark(tasks[i]));
+	}
+	printf("queue_dropped %lu\r\n", rtos_dropped);
+}
+
+/**
+ * @brief Readings dropped because the telemetry task fell behind.
+ */
+uint32_t AppRtos_GetDropped(void) {
+	return rtos_dropped;
+}
+
+/**
+ * @brief Yields to other tasks once the scheduler runs. Overrides the
+ *        busy-waiting weak HAL_Delay().
+ */
+void HAL_Delay(uint32_t Delay) {
+	uint32_t tickstart = HAL_GetTick();
+
+	if (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+		/* The extra tick guarantees at least Delay, as HAL_Delay() does */
+		vTaskDelay(pdMS_TO_TICKS(Delay) + 1U);
+		return;
+	}
+	while ((HAL_GetTick() - tickstart) < Delay) {
+		/* Before the scheduler starts: TIM7 keeps the HAL tick */
+	}
+}
+
+/**
+ * @brief Idle task memory for configSUPPORT_STATIC_ALLOCATION.
+ */
+void vApplicationGetIdleTaskMemory(StaticTask_t **tcb, StackType_t **stack,
+		uint32_t *stack_words) {
+	*tcb = &rtos_idle_tcb;
+	*stack = rtos_idle_stack;
+	*stack_words = configMINIMAL_STACK_SIZE;
+}
+
+/**
+ * @brief Services the watchdog, then sleeps until the next interrupt when
+ *        no task is ready. Starving the idle task stops the refresh.
+ */
+void vApplicationIdleHook(void) {
+	Watchdog_Service();
+	Perf_IdleBegin();
+	__WFI();
+	Perf_IdleEnd();
+}
+
+/**
+ * @brief Stack overflow trap (configCHECK_FOR_STACK_OVERFLOW).
+ */
+void vApplicationStackOverflowHook(TaskHandle_t task, char *name) {
+	(void) task;
+	(void) name;
+	Error_Handler();
+}
+
+#endif /* APP_USE_RTOS */
@@ -0,0 +1,398 @@
+/**
+ ******************************************************************************
+ * @file           : can_bus.c
+ * @brief          : bxCAN (CAN1) telemetry and command transport.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "can_bus.h"
+#include "irq_prio.h"
+#include "spsc.h"
+#include <string.h>
+
+#if CAN_USE_BUS
+
+/** RX, TX */
+#define CAN_BUS_Pins      (GPIO_PIN_8 | GPIO_PIN_9)
+#define CAN_BUS_GPIO_Port GPIOB
+
+/** Bound on the INAK handshakes; leaving init needs 11 recessive bits */
+#define CAN_BUS_MODE_MS   (10U)
+
+/** Bit timing search: quanta per bit, target sample point in permille */
+#define CAN_BUS_TQ_MAX    (25U)
+#define CAN_BUS_TQ_MIN    (8U)
+#define CAN_BUS_SP        (875U)
+#define CAN_BUS_SP_TOL    (25U)
+
+/** 32-bit filter layout matches RIR: EXID from bit 3, then IDE and RTR */
+#define CAN_BUS_FILTER(id) (((id) << CAN_RI0R_EXID_Pos) | CAN_RI0R_IDE)
+#define CAN_BUS_FILTER_MASK ((0x1FFF0000U << CAN_RI0R_EXID_Pos) \
+		| CAN_RI0R_IDE | CAN_RI0R_RTR)
+
+/** Command banks; banks 14-27 stay with CAN2 */
+#define CAN_BUS_BANK_NODE (0U)
+#define CAN_BUS_BANK_ALL  (1U)
+
+#define CAN_BUS_TME       (CAN_TSR_TME0 | CAN_TSR_TME1 | CAN_TSR_TME2)
+
+typedef struct {
+	uint32_t id;
+	uint32_t len;
+	uint8_t data[8];
+} can_bus_frame_t;
+
+SPSC_DEFINE(can_tx_queue_t, CanTxQueue, can_bus_frame_t, CAN_BUS_TX_QUEUE)
+SPSC_DEFINE(can_rx_ring_t, CanRxRing, uint8_t, CAN_BUS_RX_SIZE)
+
+static can_tx_queue_t can_tx;
+static can_rx_ring_t can_rx;
+static can_bus_stats_t can_stats;
+static volatile uint8_t can_started = 0U;
+static uint8_t can_node = CAN_BUS_NODE_DEFAULT;
+static uint8_t can_seq = 0U;
+static uint32_t can_bitrate = 0U;
+
+/**
+ * @brief Finds BRP and segments for CAN_BUS_BITRATE at the current PCLK1,
+ *        preferring more quanta per bit.
+ * @retval 1 with BTR timing fields in *btr, 0 if no exact divider exists.
+ */
+static uint8_t Can_Bus_Timing(uint32_t *btr) {
+	uint32_t pclk = HAL_RCC_GetPCLK1Freq();
+	uint32_t tq;
+	uint32_t brp;
+	uint32_t ts1;
+	uint32_t ts2;
+	uint32_t sp;
+
+	for (tq = CAN_BUS_TQ_MAX; tq >= CAN_BUS_TQ_MIN; tq--) {
+		if ((pclk % (tq * CAN_BUS_BITRATE)) != 0U) {
+			continue;
+		}
+		brp = pclk / (tq * CAN_BUS_BITRATE);
+		ts1 = (((tq * CAN_BUS_SP) + 500U) / 1000U) - 1U;
+		if (ts1 > 16U) {
+			ts1 = 16U;
+		}
+		ts2 = tq - 1U - ts1;
+		sp = ((1U + ts1) * 1000U) / tq;
+		if ((brp == 0U) || (brp > 1024U) || (ts2 == 0U) || (ts2 > 8U)
+				|| (sp + CAN_BUS_SP_TOL < CAN_BUS_SP)
+				|| (sp > CAN_BUS_SP + CAN_BUS_SP_TOL)) {
+			continue;
+		}
+		/* SJW of one quantum */
+		*btr = ((ts2 - 1U) << CAN_BTR_TS2_Pos) | ((ts1 - 1U) << CAN_BTR_TS1_Pos)
+				| (brp - 1U);
+		return 1U;
+	}
+	return 0U;
+}
+
+/**
+ * @brief Requests or leaves initialisation mode and waits for INAK.
+ */
+static uint8_t Can_Bus_SetInit(uint8_t init) {
+	uint32_t start = HAL_GetTick();
+	uint32_t want = (init != 0U) ? CAN_MSR_INAK : 0U;
+
+	if (init != 0U) {
+		CAN1->MCR |= CAN_MCR_INRQ;
+	} else {
+		CAN1->MCR &= ~CAN_MCR_INRQ;
+	}
+	while ((CAN1->MSR & CAN_MSR_INAK) != want) {
+		if ((HAL_GetTick() - start) >= CAN_BUS_MODE_MS) {
+			return 0U;
+		}
+	}
+	return 1U;
+}
+
+/**
+ * @brief Passes command frames for this node and for every node to FIFO 0.
+ */
+static void Can_Bus_Filters(void) {
+	uint32_t banks = (1UL << CAN_BUS_BANK_NODE) | (1UL << CAN_BUS_BANK_ALL);
+
+	CAN1->FMR |= CAN_FMR_FINIT;
+	CAN1->FA1R &= ~banks;
+	CAN1->FM1R &= ~banks;       /* Mask mode   */
+	CAN1->FS1R |= banks;        /* 32-bit      */
+	CAN1->FFA1R &= ~banks;      /* FIFO 0      */
+	CAN1->sFilterRegister[CAN_BUS_BANK_NODE].FR1 = CAN_BUS_FILTER(
+			CAN_BUS_ID(CAN_BUS_KIND_COMMAND, can_node, 0U));
+	CAN1->sFilterRegister[CAN_BUS_BANK_NODE].FR2 = CAN_BUS_FILTER_MASK;
+	CAN1->sFilterRegister[CAN_BUS_BANK_ALL].FR1 = CAN_BUS_FILTER(
+			CAN_BUS_ID(CAN_BUS_KIND_COMMAND, CAN_BUS_NODE_ALL, 0U));
+	CAN1->sFilterRegister[CAN_BUS_BANK_ALL].FR2 = CAN_BUS_FILTER_MASK;
+	CAN1->FA1R |= banks;
+	CAN1->FMR &= ~CAN_FMR_FINIT;
+}
+
+/**
+ * @brief Claims the pins, programs the controller and joins the bus.
+ */
+uint8_t Can_Bus_Init(void) {
+	GPIO_InitTypeDef GPIO_InitStruct = { 0 };
+	uint32_t btr;
+
+	__HAL_RCC_GPIOB_CLK_ENABLE();
+	GPIO_InitStruct.Pin = CAN_BUS_Pins;
+	GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+	GPIO_InitStruct.Pull = GPIO_PULLUP;    /* RX recessive without a transceiver */
+	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+	GPIO_InitStruct.Alternate = GPIO_AF9_CAN1;
+	HAL_GPIO_Init(CAN_BUS_GPIO_Port, &GPIO_InitStruct);
+	__HAL_RCC_CAN1_CLK_ENABLE();
+
+	CanTxQueue_Init(&can_tx);
+	CanRxRing_Init(&can_rx);
+	(void) memset(&can_stats, 0, sizeof(can_stats));
+	can_started = 0U;
+	can_bitrate = 0U;
+
+	CAN1->MCR &= ~CAN_MCR_SLEEP;
+	if (Can_Bus_SetInit(1U) == 0U) {
+		return 0U;
+	}
+	/* Automatic bus-off recovery and wake-up, retransmit until acked,
+	 * mailboxes leave in request order */
+	CAN1->MCR = (CAN1->MCR & ~(CAN_MCR_TTCM | CAN_MCR_NART | CAN_MCR_RFLM))
+			| CAN_MCR_ABOM | CAN_MCR_AWUM | CAN_MCR_TXFP;
+	if (Can_Bus_Timing(&btr) == 0U) {
+		return 0U;
+	}
+	CAN1->BTR = btr;
+	can_bitrate = CAN_BUS_BITRATE;
+	Can_Bus_Filters();
+
+	CAN1->IER = CAN_IER_TMEIE | CAN_IER_FMPIE0 | CAN_IER_FOVIE0 | CAN_IER_ERRIE
+			| CAN_IER_EPVIE | CAN_IER_BOFIE;
+	HAL_NVIC_SetPriority(CAN1_TX_IRQn, IRQ_PRIO_UART, 0U);
+	HAL_NVIC_SetPriority(CAN1_RX0_IRQn, IRQ_PRIO_UART, 0U);
+	HAL_NVIC_SetPriority(CAN1_SCE_IRQn, IRQ_PRIO_UART, 0U);
+	HAL_NVIC_EnableIRQ(CAN1_TX_IRQn);
+	HAL_NVIC_EnableIRQ(CAN1_RX0_IRQn);
+	HAL_NVIC_EnableIRQ(CAN1_SCE_IRQn);
+
+	if (Can_Bus_SetInit(0U) == 0U) {
+		return 0U;
+	}
+	can_started = 1U;
+	return 1U;
+}
+
+/**
+ * @brief Reports whether the controller is in normal mode.
+ */
+uint8_t Can_Bus_IsStarted(void) {
+	return can_started;
+}
+
+/**
+ * @brief Queues one extended data frame for the TX interrupt.
+ */
+uint8_t Can_Bus_Send(uint32_t id, const uint8_t *data, uint32_t len) {
+	can_bus_frame_t frame = { 0 };
+
+	if ((can_started == 0U) || (len > 8U)) {
+		return 0U;
+	}
+	frame.id = id & 0x1FFFFFFFU;
+	frame.len = len;
+	if (len != 0U) {
+		(void) memcpy(frame.data, data, len);
+	}
+	if (CanTxQueue_Push(&can_tx, &frame) == 0U) {
+		can_stats.tx_dropped++;
+		return 0U;
+	}
+	/* The TX handler is the only consumer; it fills free mailboxes */
+	NVIC_SetPendingIRQ(CAN1_TX_IRQn);
+	return 1U;
+}
+
+/**
+ * @brief Packs and queues a reading frame from this node.
+ */
+void Can_Bus_Reading(const dht11_reading_t *reading) {
+	uint8_t data[8];
+
+	data[0] = (uint8_t) reading->status;
+	data[1] = reading->confidence;
+	(void) memcpy(&data[2], reading->raw, 4U);
+	data[6] = reading->retries;
+	data[7] = can_seq;
+	if (Can_Bus_Send(CAN_BUS_ID(CAN_BUS_KIND_READING, can_node,
+			reading->sensor_id), data, sizeof(data)) != 0U) {
+		can_seq++;
+	}
+}
+
+/**
+ * @brief Copies out received command bytes.
+ */
+uint32_t Can_Bus_Read(uint8_t *out, uint32_t max) {
+	uint32_t count = 0U;
+
+	while ((count < max) && (CanRxRing_Pop(&can_rx, &out[count]) != 0U)) {
+		count++;
+	}
+	return count;
+}
+
+/**
+ * @brief Changes the node ID and reprograms the command filters.
+ */
+uint8_t Can_Bus_SetNode(uint8_t node) {
+	if (node == CAN_BUS_NODE_ALL) {
+		return 0U;
+	}
+	can_node = node;
+	if (can_started != 0U) {
+		Can_Bus_Filters();
+	}
+	return 1U;
+}
+
+/**
+ * @brief Current node ID.
+ */
+uint8_t Can_Bus_GetNode(void) {
+	return can_node;
+}
+
+/**
+ * @brief Bit rate actually programmed, 0 if none.
+ */
+uint32_t Can_Bus_GetBitrate(void) {
+	return (can_started != 0U) ? can_bitrate : 0U;
+}
+
+/**
+ * @brief Copies the counters and samples the error state.
+ */
+void Can_Bus_GetStats(can_bus_stats_t *stats) {
+	uint32_t esr = CAN1->ESR;
+	uint32_t basepri = Irq_MaskFrom(IRQ_PRIO_UART);
+
+	*stats = can_stats;
+	Irq_Unmask(basepri);
+	stats->tec = (uint8_t) ((esr & CAN_ESR_TEC) >> CAN_ESR_TEC_Pos);
+	stats->rec = (uint8_t) ((esr & CAN_ESR_REC) >> CAN_ESR_REC_Pos);
+	stats->passive = ((esr & CAN_ESR_EPVF) != 0U) ? 1U : 0U;
+	stats->bus_off = ((esr & CAN_ESR_BOFF) != 0U) ? 1U : 0U;
+}
+
+/**
+ * @brief Reprograms the bit timing; the controller stays in init mode,
+ *        off the bus, if the new PCLK1 cannot make CAN_BUS_BITRATE.
+ */
+void Can_Bus_ClockChanged(void) {
+	uint32_t btr;
+
+	if (can_bitrate == 0U) {
+		return;
+	}
+	can_started = 0U;
+	if (Can_Bus_SetInit(1U) == 0U) {
+		return;
+	}
+	if (Can_Bus_Timing(&btr) == 0U) {
+		return;
+	}
+	CAN1->BTR = (CAN1->BTR & ~(CAN_BTR_SJW | CAN_BTR_TS2 | CAN_BTR_TS1
+			| CAN_BTR_BRP)) | btr;
+	if (Can_Bus_SetInit(0U) != 0U) {
+		can_started = 1U;
+	}
+}
+
+/**
+ * @brief Acknowledges finished mailboxes and refills the free ones from
+ *        the queue.
+ */
+void Can_Bus_TxIRQHandler(void) {
+	uint32_t tsr = CAN1->TSR;
+	can_bus_frame_t frame;
+	uint32_t box;
+
+	can_stats.tx_frames += (((tsr & CAN_TSR_TXOK0) != 0U) ? 1U : 0U)
+			+ (((tsr & CAN_TSR_TXOK1) != 0U) ? 1U : 0U)
+			+ (((tsr & CAN_TSR_TXOK2) != 0U) ? 1U : 0U);
+	CAN1->TSR = tsr & (CAN_TSR_RQCP0 | CAN_TSR_RQCP1 | CAN_TSR_RQCP2);
+
+	while (((CAN1->TSR & CAN_BUS_TME) != 0U)
+			&& (CanTxQueue_Pop(&can_tx, &frame) != 0U)) {
+		box = (CAN1->TSR & CAN_TSR_CODE) >> CAN_TSR_CODE_Pos;
+		CAN1->sTxMailBox[box].TIR = (frame.id << CAN_TI0R_EXID_Pos)
+				| CAN_TI0R_IDE;
+		CAN1->sTxMailBox[box].TDTR = frame.len;
+		CAN1->sTxMailBox[box].TDLR = (uint32_t) frame.data[0]
+				| ((uint32_t) frame.data[1] << 8)
+				| ((uint32_t) frame.data[2] << 16)
+				| ((uint32_t) frame.data[3] << 24);
+		CAN1->sTxMailBox[box].TDHR = (uint32_t) frame.data[4]
+				| ((uint32_t) frame.data[5] << 8)
+				| ((uint32_t) frame.data[6] << 16)
+				| ((uint32_t) frame.data[7] << 24);
+		CAN1->sTxMailBox[box].TIR |= CAN_TI0R_TXRQ;
+	}
+}
+
+/**
+ * @brief Drains FIFO 0 into the command byte ring.
+ */
+void Can_Bus_Rx0IRQHandler(void) {
+	uint32_t rir;
+	uint32_t len;
+	uint32_t lo;
+	uint32_t hi;
+	uint8_t byte;
+	uint32_t i;
+
+	if ((CAN1->RF0R & CAN_RF0R_FOVR0) != 0U) {
+		CAN1->RF0R = CAN_RF0R_FOVR0;
+		can_stats.rx_overruns++;
+	}
+	while ((CAN1->RF0R & CAN_RF0R_FMP0) != 0U) {
+		rir = CAN1->sFIFOMailBox[0].RIR;
+		len = (CAN1->sFIFOMailBox[0].RDTR & CAN_RDT0R_DLC) >> CAN_RDT0R_DLC_Pos;
+		lo = CAN1->sFIFOMailBox[0].RDLR;
+		hi = CAN1->sFIFOMailBox[0].RDHR;
+		CAN1->RF0R = CAN_RF0R_RFOM0;
+
+		if (((rir & CAN_RI0R_IDE) == 0U) || ((rir & CAN_RI0R_RTR) != 0U)) {
+			continue;
+		}
+		can_stats.rx_frames++;
+		if (len > 8U) {
+			len = 8U;
+		}
+		for (i = 0U; i < len; i++) {
+			byte = (uint8_t) (((i < 4U) ? lo : hi) >> ((i & 3U) * 8U));
+			(void) CanRxRing_Push(&can_rx, &byte);
+		}
+	}
+}
+
+/**
+ * @brief Counts error-passive, bus-off and error interrupts.
+ */
+void Can_Bus_SceIRQHandler(void) {
+	if ((CAN1->MSR & CAN_MSR_ERRI) != 0U) {
+		CAN1->MSR = CAN_MSR_ERRI;
+		can_stats.errors++;
+	}
+	if ((CAN1->MSR & CAN_MSR_WKUI) != 0U) {
+		CAN1->MSR = CAN_MSR_WKUI;
+	}
+}
+
+#endif /* CAN_USE_BUS */
@@ -0,0 +1,1799 @@
+/**
+ ******************************************************************************
+ * @file           : cli.c
+ * @brief          : Non-blocking line-oriented command interpreter.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "cli.h"
+#include "uart_rx.h"
+#include "uart_tx.h"
+#include "dlog.h"
+#include "dht11_async.h"
+#include "dht11_sink.h"
+#include "clock_config.h"
+#include "power.h"
+#include "dht11_prof.h"
+#include "dht11_health.h"
+#include "history.h"
+#include "flashlog.h"
+#include "sched.h"
+#include "app_rtos.h"
+#include "crash.h"
+#include "watchdog.h"
+#include "app_pools.h"
+#include "dht11_calib.h"
+#include "dht11_latest.h"
+#include "dht11_filter.h"
+#include "dht11_emit.h"
+#include "dht11_agg.h"
+#include "dht11_sampler.h"
+#include "dht11_driver.h"
+#include "dht11_capture.h"
+#include "perf.h"
+#include "uart_baud.h"
+#include "config.h"
+#include "uart_flow.h"
+#include "status_led.h"
+#include "usb_cdc.h"
+#include "can_bus.h"
+#include "i2c_regmap.h"
+#include "modbus.h"
+#include "dht11_emu.h"
+#include "dht11_oversample.h"
+#include "wallclock.h"
+#include "dvfs.h"
+#include "dht11_supply.h"
+#include "dht11_discover.h"
+#include "dht11_drift.h"
+#include "dht11_trace.h"
+#include "dht11_sync.h"
+#include "dht11_trigger.h"
+#include "fmt.h"
+#include "boot_layout.h"
+#include "adc_mon.h"
+#include "rs485_gw.h"
+#include "watermark.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+/**
+ * @brief One command: name, handler and a one-line usage string.
+ */
+typedef struct {
+	const char *name;
+	void (*handler)(uint32_t argc, char *argv[]);
+	const char *usage;
+} cli_command_t;
+
+static void CLI_CmdHelp(uint32_t argc, char *argv[]);
+static void CLI_CmdInterval(uint32_t argc, char *argv[]);
+static void CLI_CmdFormat(uint32_t argc, char *argv[]);
+static void CLI_CmdStats(uint32_t argc, char *argv[]);
+static void CLI_CmdClock(uint32_t argc, char *argv[]);
+static void CLI_CmdProf(uint32_t argc, char *argv[]);
+static void CLI_CmdHistory(uint32_t argc, char *argv[]);
+static void CLI_CmdFlashLog(uint32_t argc, char *argv[]);
+static void CLI_CmdTasks(uint32_t argc, char *argv[]);
+static void CLI_CmdCrash(uint32_t argc, char *argv[]);
+static void CLI_CmdCalib(uint32_t argc, char *argv[]);
+static void CLI_CmdFilter(uint32_t argc, char *argv[]);
+static void CLI_CmdEmit(uint32_t argc, char *argv[]);
+static void CLI_CmdAgg(uint32_t argc, char *argv[]);
+static void CLI_CmdSample(uint32_t argc, char *argv[]);
+static void CLI_CmdSensor(uint32_t argc, char *argv[]);
+static void CLI_CmdPerf(uint32_t argc, char *argv[]);
+static void CLI_CmdBaud(uint32_t argc, char *argv[]);
+static void CLI_CmdTransport(uint32_t argc, char *argv[]);
+static void CLI_CmdFlow(uint32_t argc, char *argv[]);
+static void CLI_CmdCan(uint32_t argc, char *argv[]);
+static void CLI_CmdTime(uint32_t argc, char *argv[]);
+static void CLI_CmdLatest(uint32_t argc, char *argv[]);
+static void CLI_CmdEmu(uint32_t argc, char *argv[]);
+static void CLI_CmdGlitch(uint32_t argc, char *argv[]);
+static void CLI_CmdSupply(uint32_t argc, char *argv[]);
+static void CLI_CmdDiscover(uint32_t argc, char *argv[]);
+static void CLI_CmdDrift(uint32_t argc, char *argv[]);
+static void CLI_CmdTrace(uint32_t argc, char *argv[]);
+static void CLI_CmdSync(uint32_t argc, char *argv[]);
+static void CLI_CmdLed(uint32_t argc, char *argv[]);
+static void CLI_CmdRead(uint32_t argc, char *argv[]);
+static void CLI_CmdAdc(uint32_t argc, char *argv[]);
+static void CLI_CmdGw(uint32_t argc, char *argv[]);
+static void CLI_CmdConfig(uint32_t argc, char *argv[]);
+static void CLI_CmdUpdate(uint32_t argc, char *argv[]);
+
+static const cli_command_t cli_commands[] = {
+	{ "help", CLI_CmdHelp, "help" },
+	{ "interval", CLI_CmdInterval, "interval <ms>" },
+	{ "format", CLI_CmdFormat, "format text|binary|delta|none|batch|schema" },
+	{ "stats", CLI_CmdStats, "stats" },
+	{ "clock", CLI_CmdClock, "clock low|balanced|high" },
+	{ "prof", CLI_CmdProf, "prof [reset]" },
+	{ "history", CLI_CmdHistory, "history [drain|clear]" },
+	{ "flashlog", CLI_CmdFlashLog, "flashlog [dump|range <from_s> <to_s>|last <s>]" },
+	{ "tasks", CLI_CmdTasks, "tasks" },
+	{ "crash", CLI_CmdCrash, "crash" },
+	{ "calib", CLI_CmdCalib, "calib [<ch> temp|hum <gain_milli> <offset_tenths>|path [<profile> fixed|fpu]|bench [apply]]" },
+	{ "filter", CLI_CmdFilter, "filter [<ch> window|median|hampel|ema <value>]" },
+	{ "emit", CLI_CmdEmit,
+			"emit [periodic <ms>|change <dT> <dH>|threshold <T> <H> <hyst>|heartbeat <ms>]" },
+	{ "agg", CLI_CmdAgg, "agg [<s> [<s>]|off|raw on|off]" },
+	{ "sample", CLI_CmdSample, "sample [<ch> <period_ms> [<phase_ms>]]" },
+	{ "sensor", CLI_CmdSensor, "sensor [<ch> dht11|dht22]" },
+	{ "perf", CLI_CmdPerf, "perf [reset|send]" },
+	{ "baud", CLI_CmdBaud, "baud [<rate>|ok]" },
+	{ "transport", CLI_CmdTransport, "transport [uart|usb]" },
+	{ "flow", CLI_CmdFlow, "flow [on|off]" },
+	{ "can", CLI_CmdCan, "can [node <id>]" },
+	{ "time", CLI_CmdTime, "time [<unix_s>[.<ms>]]" },
+	{ "latest", CLI_CmdLatest, "latest" },
+	{ "emu", CLI_CmdEmu,
+			"emu [run <n>|frame <b0> <b1> <b2> <b3> [<sum>]|timing <low> <zero> <one> [<resp> [<wait>]]|jitter <us>]" },
+	{ "glitch", CLI_CmdGlitch, "glitch [<ch> <icf> <min_us>]" },
+	{ "supply", CLI_CmdSupply, "supply [<ch> gate|always|cycle]" },
+	{ "discover", CLI_CmdDiscover, "discover" },
+	{ "drift", CLI_CmdDrift, "drift [reset <ch>]" },
+	{ "trace", CLI_CmdTrace, "trace [off|failed|all|dump|clear]" },
+	{ "sync", CLI_CmdSync, "sync [offset <ms>]" },
+	{ "led", CLI_CmdLed, "led [ok|retrying|link_down|fault|auto]" },
+	{ "read", CLI_CmdRead, "read" },
+	{ "adc", CLI_CmdAdc, "adc" },
+	{ "gw", CLI_CmdGw, "gw [list|nodes <n>|period <ms>|timeout <ms>]" },
+	{ "config", CLI_CmdConfig, "config [save|erase]" },
+	{ "update", CLI_CmdUpdate, "update" }
+};
+
+#define CLI_COMMAND_COUNT (sizeof(cli_commands) / sizeof(cli_commands[0]))
+
+static char cli_line[CLI_LINE_MAX + 1U];
+static uint32_t cli_len = 0U;
+static uint8_t cli_overflow = 0U;
+
+/**
+ * @brief Lists the commands.
+ */
+static void CLI_CmdHelp(uint32_t argc, char *argv[]) {
+	uint32_t i;
+
+	(void) argc;
+	(void) argv;
+	for (i = 0U; i < CLI_COMMAND_COUNT; i++) {
+		printf("  %s\r\n", cli_commands[i].usage);
+	}
+	printf("OK\r\n");
+}
+
+/**
+ * @brief Sets the DHT11 refresh interval.
+ */
+static void CLI_CmdInterval(uint32_t argc, char *argv[]) {
+#if DHT11_USE_ASYNC
+	uint32_t ms;
+
+	if (argc < 2U) {
+		printf("OK interval %lu\r\n", DHT11_Async_GetInterval());
+		return;
+	}
+	ms = (uint32_t) strtoul(argv[1], NULL, 10);
+	if ((ms != 0U) && (ms < 1000U)) {
+		printf("ERR DHT11 needs >= 1000 ms\r\n");
+		return;
+	}
+	DHT11_Async_SetInterval(ms);
+	if ((ms != 0U) && (DHT11_Async_IsBusy() == 0U)) {
+		/* Apply the new cadence from now rather than after the old period */
+		(void) DHT11_StartAsync();
+	}
+	printf("OK interval %lu\r\n", ms);
+#else
+	(void) argc;
+	(void) argv;
+	printf("ERR needs DHT11_USE_ASYNC\r\n");
+#endif /* DHT11_USE_ASYNC */
+}
+
+/**
+ * @brief Selects the output sink.
+ */
+static void CLI_CmdFormat(uint32_t argc, char *argv[]) {
+	static const char *const names[] = { "text", "binary", "delta", "none",
+			"batch", "schema" };
+	uint32_t i;
+
+	if (argc < 2U) {
+		printf("OK format %s\r\n", names[DHT11_Sink_GetFormat()]);
+		return;
+	}
+	for (i = 0U; i < (sizeof(names) / sizeof(names[0])); i++) {
+		if (strcmp(argv[1], names[i]) == 0) {
+			printf("OK format %s\r\n", names[i]);
+			DHT11_Sink_SetFormat((dht11_format_t) i);
+			return;
+		}
+	}
+	printf("ERR unknown format\r\n");
+}
+
+/**
+ * @brief Dumps counters and clock state.
+ */
+static void CLI_CmdStats(uint32_t argc, char *argv[]) {
+	watermark_stack_t stack;
+#if WATERMARK_USE_LATENCY
+	watermark_lat_t lat;
+	uint32_t i;
+#endif /* WATERMARK_USE_LATENCY */
+#if DVFS_USE_SCALING
+	dvfs_stats_t dvfs;
+#endif /* DVFS_USE_SCALING */
+#if MODBUS_USE_RTU
+	modbus_stats_t mb_stats;
+
+#endif /* MODBUS_USE_RTU */
+	(void) argc;
+	(void) argv;
+
+	printf("uptime_ms %lu\r\n", HAL_GetTick());
+	printf("clock %s %lu Hz\r\n", Clock_GetProfileName(Clock_GetProfile()),
+			HAL_RCC_GetSysClockFreq());
+	printf("tx_dropped %lu\r\n", UART_TX_GetDropped());
+	printf("rx_errors %lu\r\n", UART_RX_GetErrors());
+	printf("log_dropped %lu\r\n", DLog_GetDropped());
+	printf("stop_entries %lu\r\n", Power_GetStopCount());
+	printf("stop_ms %lu\r\n", Power_GetStopTimeMs());
+	printf("idle_pct %lu\r\n", Sched_GetIdlePercent());
+#if DVFS_USE_SCALING
+	Dvfs_GetStats(&dvfs);
+	printf("dvfs drops=%lu ramps=%lu skipped=%lu idle_ms=%lu\r\n", dvfs.drops,
+			dvfs.ramps, dvfs.skipped, dvfs.idle_ms);
+#endif /* DVFS_USE_SCALING */
+	printf("reset %s\r\n", Crash_GetResetCause());
+	printf("crashes %lu\r\n", Crash_GetCount());
+	printf("wdg_timeout_ms %lu\r\n", Watchdog_GetTimeoutMs());
+	printf("wdg_stale %s\r\n", Watchdog_GetStale());
+#if I2C_USE_REGMAP
+	printf("i2c_reads %lu\r\n", I2C_Regmap_GetReads());
+	printf("i2c_errors %lu\r\n", I2C_Regmap_GetErrors());
+#endif /* I2C_USE_REGMAP */
+#if MODBUS_USE_RTU
+	Modbus_GetStats(&mb_stats);
+	printf("modbus_frames %lu\r\n", mb_stats.frames);
+	printf("modbus_crc_errors %lu\r\n", mb_stats.crc_errors);
+	printf("modbus_exceptions %lu\r\n", mb_stats.exceptions);
+	printf("modbus_foreign %lu\r\n", mb_stats.foreign);
+#endif /* MODBUS_USE_RTU */
+	Watermark_GetStack(&stack);
+	printf("stack_used %lu of %lu painted %lu%s\r\n", stack.used,
+			stack.reserved, stack.painted,
+			(stack.exhausted != 0U) ? " exhausted" : "");
+#if WATERMARK_USE_LATENCY
+	for (i = 0U; i < (uint32_t) WATERMARK_IRQ_COUNT; i++) {
+		Watermark_GetLatency((watermark_irq_t) i, &lat);
+		printf("irq_lat %s count %lu max %lu mean %lu last %lu cycles\r\n",
+				Watermark_IrqName((watermark_irq_t) i), lat.count, lat.max,
+				(lat.count != 0U) ? (uint32_t) (lat.sum / lat.count) : 0U,
+				lat.last);
+	}
+#endif /* WATERMARK_USE_LATENCY */
+	AppPools_Dump();
+	printf("filter_rejected %lu\r\n", DHT11_Filter_GetRejected(0U));
+	printf("emit_mode %s\r\n",
+			DHT11_Emit_ModeName(DHT11_Emit_GetConfig().mode));
+	printf("emit_suppressed %lu\r\n", DHT11_Emit_GetSuppressed());
+	printf("agg_summaries %lu\r\n", DHT11_Agg_GetSummaries());
+	printf("lsi_hz %lu\r\n", Power_GetLsiHz());
+	printf("health %s\r\n", DHT11_Health_Name(DHT11_Health_Get(0U)));
+	printf("failures %lu\r\n", DHT11_Health_GetFailures(0U));
+#if DHT11_USE_OVERSAMPLE
+	printf("ovs_glitches %lu\r\n", DHT11_Oversample_GetGlitches());
+#endif /* DHT11_USE_OVERSAMPLE */
+#if DHT11_USE_ASYNC
+	{
+		dht11_reading_t reading;
+		dht11_status_t status = DHT11_GetResult(&reading);
+		dht11_async_clock_t clock;
+
+		DHT11_Async_GetClock(&clock);
+		printf("interval_ms %lu\r\n", DHT11_Async_GetInterval());
+		printf("clock_slots %lu missed %lu max_late_us %lu\r\n", clock.slots,
+				clock.missed, clock.max_late_us);
+		printf("last %s at %lu ms\r\n", DHT11_StatusName(status),
+				reading.timestamp_ms);
+	}
+#endif /* DHT11_USE_ASYNC */
+	printf("OK\r\n");
+}
+
+/**
+ * @brief Switches the clock profile while the sensor is idle.
+ */
+static void CLI_CmdClock(uint32_t argc, char *argv[]) {
+	static const char *const names[CLOCK_PROFILE_COUNT] = { "low", "balanced",
+			"high" };
+	uint32_t i;
+
+	if (argc < 2U) {
+		printf("OK clock %s\r\n", Clock_GetProfileName(Clock_GetProfile()));
+		return;
+	}
+	for (i = 0U; i < CLOCK_PROFILE_COUNT; i++) {
+		if (strcmp(argv[1], names[i]) == 0) {
+			break;
+		}
+	}
+	if (i == CLOCK_PROFILE_COUNT) {
+		printf("ERR unknown profile\r\n");
+		return;
+	}
+#if DHT11_USE_ASYNC
+	if (DHT11_Async_IsBusy() != 0U) {
+		printf("ERR sensor busy, retry\r\n");
+		return;
+	}
+#endif /* DHT11_USE_ASYNC */
+
+	/* The baud rate divisor changes with PCLK1: drain pending output first */
+	(void) UART_TX_Flush(100U);
+#if DVFS_USE_SCALING
+	/* The profile bursts run at; idle still drops to DVFS_IDLE_PROFILE */
+	if (Dvfs_SetBurstProfile((clock_profile_t) i) != HAL_OK) {
+#else
+	if (Clock_SetProfile((clock_profile_t) i) != HAL_OK) {
+#endif /* DVFS_USE_SCALING */
+		printf("ERR clock switch failed\r\n");
+		return;
+	}
+	printf("OK clock %s %lu Hz\r\n", Clock_GetProfileName(Clock_GetProfile()),
+			HAL_RCC_GetSysClockFreq());
+}
+
+/**
+ * @brief Dumps or clears the transaction timing profile.
+ */
+static void CLI_CmdProf(uint32_t argc, char *argv[]) {
+#if DHT11_USE_PROFILE
+	if ((argc >= 2U) && (strcmp(argv[1], "reset") == 0)) {
+		DHT11_Prof_Reset();
+	} else {
+		DHT11_Prof_Dump();
+	}
+	printf("OK\r\n");
+#else
+	(void) argc;
+	(void) argv;
+	printf("ERR needs DHT11_USE_PROFILE\r\n");
+#endif /* DHT11_USE_PROFILE */
+}
+
+/**
+ * @brief Shows, drains (binary frames) or clears the stored readings.
+ */
+static void CLI_CmdHistory(uint32_t argc, char *argv[]) {
+	uint32_t sent = 0U;
+	uint32_t n;
+
+	if ((argc >= 2U) && (strcmp(argv[1], "clear") == 0)) {
+		History_Clear();
+	} else if ((argc >= 2U) && (strcmp(argv[1], "drain") == 0)) {
+		while (History_Count() != 0U) {
+			n = History_Drain(History_Count());
+			sent += n;
+			if ((n == 0U) && (UART_TX_Flush(100U) == 0U)) {
+				break;
+			}
+		}
+		(void) UART_TX_Flush(100U);
+		printf("OK history drained %lu\r\n", sent);
+		return;
+	}
+	printf("history %lu/%lu boot %lu overwritten %lu\r\n", History_Count(),
+			History_Capacity(), History_GetBoot(), History_GetOverwritten());
+	printf("OK\r\n");
+}
+
+/**
+ * @brief Shows the flash log or starts streaming it, whole or a time
+ *        window of it (binary frames). The RTC time printed first lets the
+ *        host date the records.
+ */
+static void CLI_CmdFlashLog(uint32_t argc, char *argv[]) {
+	uint32_t words;
+	uint32_t from_s;
+	uint32_t to_s;
+	uint32_t now_s;
+
+	if ((argc >= 2U) && (strcmp(argv[1], "dump") == 0)) {
+		words = FlashLog_StartDump();
+		printf("OK flashlog dump %lu words rtc %lu\r\n", words,
+				Power_GetRtcSeconds());
+		return;
+	}
+	if ((argc >= 4U) && (strcmp(argv[1], "range") == 0)) {
+		from_s = (uint32_t) strtoul(argv[2], NULL, 10);
+		to_s = (uint32_t) strtoul(argv[3], NULL, 10);
+	} else if ((argc >= 3U) && (strcmp(argv[1], "last") == 0)) {
+		now_s = Power_GetRtcSeconds();
+		from_s = (uint32_t) strtoul(argv[2], NULL, 10);
+		from_s = (from_s < now_s) ? (now_s - from_s) : 0U;
+		to_s = UINT32_MAX;
+	} else {
+		printf("flashlog %lu/%lu words generation %lu errors %lu seal %s\r\n",
+				FlashLog_GetUsedWords(), FlashLog_GetCapacityWords(),
+				FlashLog_GetGeneration(), FlashLog_GetErrors(),
+				FlashLog_SealName(FlashLog_GetSeal()));
+		printf("OK\r\n");
+		return;
+	}
+	if (from_s > to_s) {
+		printf("ERR usage: flashlog range <from_s> <to_s>, from_s <= to_s\r\n");
+		return;
+	}
+	/* Replies like a dump, so the host dates the records the same way */
+	words = FlashLog_StartRange(from_s, to_s);
+	printf("OK flashlog range %lu words rtc %lu\r\n", words,
+			Power_GetRtcSeconds());
+}
+
+/**
+ * @brief Lists the scheduler tasks with their run time and lateness, and
+ *        the watchdog tokens.
+ */
+static void CLI_CmdTasks(uint32_t argc, char *argv[]) {
+	(void) argc;
+	(void) argv;
+
+#if APP_USE_RTOS
+	AppRtos_Dump();
+#else
+	Sched_Dump();
+#endif /* APP_USE_RTOS */
+	Watchdog_Dump();
+	printf("OK\r\n");
+}
+
+/**
+ * @brief Shows the crash saved before the last reset.
+ */
+static void CLI_CmdCrash(uint32_t argc, char *argv[]) {
+	(void) argc;
+	(void) argv;
+
+	if (Crash_Print() == 0U) {
+		printf("OK no crash\r\n");
+		return;
+	}
+	printf("OK\r\n");
+}
+
+/**
+ * @brief Gain in thousandths, rounded, from Q16.16.
+ */
+static int32_t CLI_GainMilli(int32_t gain) {
+	return (int32_t) ((((int64_t) gain * 1000) + (DHT11_CALIB_ONE / 2)) >> 16);
+}
+
+/**
+ * @brief Shows or sets the derived-metrics path of each clock profile.
+ */
+static void CLI_CalibPath(uint32_t argc, char *argv[]) {
+	static const char *const names[CLOCK_PROFILE_COUNT] = { "low", "balanced",
+			"high" };
+	const dht11_calib_bench_t *bench;
+	uint32_t i;
+	uint32_t path;
+
+	if (argc < 4U) {
+		for (i = 0U; i < CLOCK_PROFILE_COUNT; i++) {
+			bench = DHT11_Calib_GetBench((clock_profile_t) i);
+			printf("calib path %s %s", names[i],
+					DHT11_Calib_PathName(DHT11_Calib_GetPath((clock_profile_t) i)));
+			if (bench->samples != 0U) {
+				printf(" fixed %lu fpu %lu cycles",
+						bench->cycles[DHT11_CALIB_PATH_FIXED],
+						bench->cycles[DHT11_CALIB_PATH_FPU]);
+			}
+			printf("\r\n");
+		}
+		printf("OK\r\n");
+		return;
+	}
+	for (i = 0U; i < CLOCK_PROFILE_COUNT; i++) {
+		if (strcmp(argv[2], names[i]) == 0) {
+			break;
+		}
+	}
+	for (path = 0U; path < DHT11_CALIB_PATHS; path++) {
+		if (strcmp(argv[3], DHT11_Calib_PathName((dht11_calib_path_t) path)) == 0) {
+			break;
+		}
+	}
+	if ((i == CLOCK_PROFILE_COUNT) || (path == DHT11_CALIB_PATHS)
+			|| (DHT11_Calib_SetPath((clock_profile_t) i,
+					(dht11_calib_path_t) path) == 0U)) {
+		printf("ERR usage: calib path low|balanced|high fixed|fpu\r\n");
+		return;
+	}
+	printf("OK calib path %s %s\r\n", names[i], argv[3]);
+}
+
+/**
+ * @brief Times both derived-metrics paths at the current clock profile,
+ *        optionally keeping the faster one for it.
+ */
+static void CLI_CalibBench(uint32_t argc, char *argv[]) {
+	dht11_calib_bench_t bench;
+	dht11_calib_path_t faster;
+
+	faster = DHT11_Calib_Bench(&bench);
+	if ((argc >= 3U) && (strcmp(argv[2], "apply") == 0)) {
+		(void) DHT11_Calib_SetPath(Clock_GetProfile(), faster);
+	}
+	printf("OK calib bench %s %lu samples fixed %lu (%lu) fpu %lu (%lu) cycles"
+			" diff dew %u heat %u abs %u path %s\r\n",
+			Clock_GetProfileName(Clock_GetProfile()), bench.samples,
+			bench.cycles[DHT11_CALIB_PATH_FIXED],
+			bench.worst[DHT11_CALIB_PATH_FIXED],
+			bench.cycles[DHT11_CALIB_PATH_FPU],
+			bench.worst[DHT11_CALIB_PATH_FPU], bench.diff_dew, bench.diff_heat,
+			bench.diff_abs,
+			DHT11_Calib_PathName(DHT11_Calib_GetPath(Clock_GetProfile())));
+}
+
+/**
+ * @brief Shows or sets the per-sensor calibration and the derived-metrics
+ *        path.
+ */
+static void CLI_CmdCalib(uint32_t argc, char *argv[]) {
+	dht11_calib_t temp;
+	dht11_calib_t hum;
+	dht11_calib_qty_t qty;
+	uint32_t ch;
+	int32_t gain;
+	int32_t offset;
+
+	if ((argc >= 2U) && (strcmp(argv[1], "path") == 0)) {
+		CLI_CalibPath(argc, argv);
+		return;
+	}
+	if ((argc >= 2U) && (strcmp(argv[1], "bench") == 0)) {
+		CLI_CalibBench(argc, argv);
+		return;
+	}
+	if (argc < 2U) {
+		for (ch = 0U; ch < DHT11_CALIB_SENSORS; ch++) {
+			temp = DHT11_Calib_Get((uint8_t) ch, DHT11_CALIB_TEMP);
+			hum = DHT11_Calib_Get((uint8_t) ch, DHT11_CALIB_HUM);
+			printf("calib %lu temp %ld %d hum %ld %d\r\n", ch,
+					CLI_GainMilli(temp.gain), temp.offset,
+					CLI_GainMilli(hum.gain), hum.offset);
+		}
+		printf("OK\r\n");
+		return;
+	}
+	if (argc < 5U) {
+		printf("ERR usage: calib <ch> temp|hum <gain_milli> <offset_tenths>\r\n");
+		return;
+	}
+	ch = (uint32_t) strtoul(argv[1], NULL, 10);
+	if (strcmp(argv[2], "temp") == 0) {
+		qty = DHT11_CALIB_TEMP;
+	} else if (strcmp(argv[2], "hum") == 0) {
+		qty = DHT11_CALIB_HUM;
+	} else {
+		printf("ERR unknown quantity %s\r\n", argv[2]);
+		return;
+	}
+	gain = (int32_t) strtol(argv[3], NULL, 10);
+	offset = (int32_t) strtol(argv[4], NULL, 10);
+	if ((gain <= 0) || (gain > 4000) || (offset < -1000) || (offset > 1000)
+			|| (ch > 0xFFU) || (DHT11_Calib_Set((uint8_t) ch, qty,
+					(int32_t) ((((int64_t) gain << 16) + 500) / 1000),
+					(int16_t) offset) == 0U)) {
+		printf("ERR calib out of range\r\n");
+		return;
+	}
+	printf("OK calib %lu %s %ld %ld\r\n", ch, argv[2], gain, offset);
+}
+
+/**
+ * @brief Shows or changes one setting of a sensor's filter.
+ */
+static void CLI_CmdFilter(uint32_t argc, char *argv[]) {
+	dht11_filter_cfg_t cfg;
+	uint32_t ch;
+	int32_t value;
+
+	if (argc < 2U) {
+		for (ch = 0U; ch < DHT11_FILTER_SENSORS; ch++) {
+			cfg = DHT11_Filter_GetConfig((uint8_t) ch);
+			printf("filter %lu window %u median %u hampel %u ema %ld rejected %lu\r\n",
+					ch, cfg.window, cfg.median, cfg.hampel_k,
+					CLI_GainMilli(cfg.ema_alpha),
+					DHT11_Filter_GetRejected((uint8_t) ch));
+		}
+		printf("OK\r\n");
+		return;
+	}
+	if (argc < 4U) {
+		printf("ERR usage: filter <ch> window|median|hampel|ema <value>\r\n");
+		return;
+	}
+	ch = (uint32_t) strtoul(argv[1], NULL, 10);
+	value = (int32_t) strtol(argv[3], NULL, 10);
+	cfg = DHT11_Filter_GetConfig((uint8_t) ch);
+	if (strcmp(argv[2], "window") == 0) {
+		cfg.window = (value <= (int32_t) DHT11_FILTER_WINDOW_MAX) ? (uint8_t) value : 0U;
+	} else if (strcmp(argv[2], "median") == 0) {
+		cfg.median = (value != 0) ? 1U : 0U;
+	} else if (strcmp(argv[2], "hampel") == 0) {
+		cfg.hampel_k = (uint8_t) ((value > 255) ? 255 : value); /* Tenths, 0 = off */
+	} else if (strcmp(argv[2], "ema") == 0) {
+		cfg.ema_alpha = (int32_t) ((((int64_t) value << 16) + 500) / 1000);
+	} else {
+		printf("ERR unknown filter setting %s\r\n", argv[2]);
+		return;
+	}
+	if ((ch > 0xFFU) || (value < 0) || (value > 1000)
+			|| (DHT11_Filter_SetConfig((uint8_t) ch, &cfg) == 0U)) {
+		printf("ERR filter out of range\r\n");
+		return;
+	}
+	printf("OK filter %lu %s %ld\r\n", ch, argv[2], value);
+}
+
+/**
+ * @brief Shows or changes the emission policy.
+ */
+static void CLI_CmdEmit(uint32_t argc, char *argv[]) {
+	dht11_emit_cfg_t cfg = DHT11_Emit_GetConfig();
+	int32_t a = (argc > 2U) ? (int32_t) strtol(argv[2], NULL, 10) : 0;
+	int32_t b = (argc > 3U) ? (int32_t) strtol(argv[3], NULL, 10) : 0;
+	int32_t c = (argc > 4U) ? (int32_t) strtol(argv[4], NULL, 10) : 0;
+
+	if (argc < 2U) {
+		printf("emit %s period %lu deadband %d %d level %d %d hyst %d"
+				" heartbeat %lu suppressed %lu\r\n",
+				DHT11_Emit_ModeName(cfg.mode), cfg.period_ms, cfg.deadband_temp,
+				cfg.deadband_hum, cfg.level_temp, cfg.level_hum, cfg.hysteresis,
+				cfg.heartbeat_ms, DHT11_Emit_GetSuppressed());
+		printf("OK\r\n");
+		return;
+	}
+	if ((strcmp(argv[1], "periodic") == 0) && (argc >= 3U) && (a >= 0)) {
+		cfg.mode = DHT11_EMIT_PERIODIC;
+		cfg.period_ms = (uint32_t) a;
+	} else if ((strcmp(argv[1], "change") == 0) && (argc >= 4U) && (a >= 0)
+			&& (a <= 1000) && (b >= 0) && (b <= 1000)) {
+		cfg.mode = DHT11_EMIT_CHANGE;
+		cfg.deadband_temp = (int16_t) a;
+		cfg.deadband_hum = (int16_t) b;
+	} else if ((strcmp(argv[1], "threshold") == 0) && (argc >= 5U)
+			&& (a >= -400) && (a <= 800) && (b >= 0) && (b <= 1000) && (c >= 0)
+			&& (c <= 1000)) {
+		cfg.mode = DHT11_EMIT_THRESHOLD;
+		cfg.level_temp = (int16_t) a;
+		cfg.level_hum = (int16_t) b;
+		cfg.hysteresis = (int16_t) c;
+	} else if ((strcmp(argv[1], "heartbeat") == 0) && (argc >= 3U) && (a >= 0)) {
+		cfg.heartbeat_ms = (uint32_t) a;
+	} else {
+		printf("ERR usage: emit periodic <ms>|change <dT> <dH>|threshold <T> <H> <hyst>|heartbeat <ms>\r\n");
+		return;
+	}
+	DHT11_Emit_SetConfig(&cfg);
+	printf("OK emit %s\r\n", DHT11_Emit_ModeName(cfg.mode));
+}
+
+/**
+ * @brief Shows or changes the aggregation windows and whether raw
+ *        readings still go out.
+ */
+static void CLI_CmdAgg(uint32_t argc, char *argv[]) {
+	dht11_agg_cfg_t cfg = DHT11_Agg_GetConfig();
+	uint32_t i;
+	uint32_t s;
+
+	if (argc < 2U) {
+		printf("agg windows %lu %lu raw %s summaries %lu\r\n", cfg.window_s[0],
+				cfg.window_s[1], (cfg.raw != 0U) ? "on" : "off",
+				DHT11_Agg_GetSummaries());
+		printf("OK\r\n");
+		return;
+	}
+	if ((strcmp(argv[1], "raw") == 0) && (argc >= 3U)
+			&& ((strcmp(argv[2], "on") == 0) || (strcmp(argv[2], "off") == 0))) {
+		cfg.raw = (strcmp(argv[2], "on") == 0) ? 1U : 0U;
+	} else if (strcmp(argv[1], "off") == 0) {
+		for (i = 0U; i < DHT11_AGG_WINDOWS; i++) {
+			cfg.window_s[i] = 0U;
+		}
+	} else {
+		for (i = 0U; i < DHT11_AGG_WINDOWS; i++) {
+			s = (i < (argc - 1U)) ? (uint32_t) strtoul(argv[i + 1U], NULL, 10) : 0U;
+			if (s > DHT11_AGG_WINDOW_MAX) {
+				printf("ERR window 0-%lu s\r\n", (uint32_t) DHT11_AGG_WINDOW_MAX);
+				return;
+			}
+			cfg.window_s[i] = s;
+		}
+	}
+	DHT11_Agg_SetConfig(&cfg);
+	printf("OK agg %lu %lu raw %s\r\n", cfg.window_s[0], cfg.window_s[1],
+			(cfg.raw != 0U) ? "on" : "off");
+}
+
+/**
+ * @brief Shows or changes a sensor's sampling plan.
+ */
+static void CLI_CmdSample(uint32_t argc, char *argv[]) {
+	dht11_sampler_cfg_t cfg;
+	uint32_t ch;
+	uint32_t period_ms;
+	uint32_t phase_ms;
+
+	if (argc < 2U) {
+		for (ch = 0U; ch < DHT11_SAMPLER_SENSORS; ch++) {
+			cfg = DHT11_Sampler_Get((uint8_t) ch);
+			printf("sample %lu period %lu phase %lu\r\n", ch, cfg.period_ms,
+					cfg.phase_ms);
+		}
+		printf("OK\r\n");
+		return;
+	}
+	if (argc < 3U) {
+		printf("ERR usage: sample <ch> <period_ms> [<phase_ms>]\r\n");
+		return;
+	}
+	ch = (uint32_t) strtoul(argv[1], NULL, 10);
+	period_ms = (uint32_t) strtoul(argv[2], NULL, 10);
+	phase_ms = (argc > 3U) ? (uint32_t) strtoul(argv[3], NULL, 10) : 0U;
+	if ((ch > 0xFFU)
+			|| (DHT11_Sampler_Set((uint8_t) ch, period_ms, phase_ms) == 0U)) {
+		printf("ERR period 0 or %lu-%lu ms, phase below period\r\n",
+				(uint32_t) DHT11_SAMPLER_MIN_PERIOD_MS,
+				(uint32_t) DHT11_SAMPLER_MAX_PERIOD_MS);
+		return;
+	}
+	printf("OK sample %lu %lu %lu\r\n", ch, period_ms, phase_ms);
+}
+
+/**
+ * @brief Shows or changes a sensor's type.
+ */
+static void CLI_CmdSensor(uint32_t argc, char *argv[]) {
+	const dht11_driver_t *driver;
+	uint32_t ch;
+
+	if (argc < 2U) {
+		for (ch = 0U; ch < DHT11_DRIVER_SENSORS; ch++) {
+			driver = DHT11_Driver_Get((uint8_t) ch);
+			printf("sensor %lu %s start_us %lu min_ms %lu\r\n", ch, driver->name,
+					driver->start_us, driver->min_interval_ms);
+		}
+		printf("OK\r\n");
+		return;
+	}
+	if (argc < 3U) {
+		printf("ERR usage: sensor <ch> dht11|dht22\r\n");
+		return;
+	}
+	ch = (uint32_t) strtoul(argv[1], NULL, 10);
+	driver = DHT11_Driver_Find(argv[2]);
+	if (driver == NULL) {
+		printf("ERR unknown sensor type %s\r\n", argv[2]);
+		return;
+	}
+	if ((ch > 0xFFU) || (DHT11_Driver_Set((uint8_t) ch, driver) == 0U)) {
+		printf("ERR sensor out of range\r\n");
+		return;
+	}
+	printf("OK sensor %lu %s\r\n", ch, driver->name);
+}
+
+/**
+ * @brief Shows, restarts or sends (binary frame) the CPU load window.
+ */
+static void CLI_CmdPerf(uint32_t argc, char *argv[]) {
+	if ((argc >= 2U) && (strcmp(argv[1], "reset") == 0)) {
+		Perf_Reset();
+	} else if ((argc >= 2U) && (strcmp(argv[1], "send") == 0)) {
+		Perf_Send();
+	} else {
+		Perf_Dump();
+#if !APP_USE_RTOS
+		Sched_Dump();
+#endif /* !APP_USE_RTOS */
+	}
+	printf("OK\r\n");
+}
+
+/**
+ * @brief Lists the rates, proposes one or confirms a proposed one
+ *        (uart_baud.h).
+ */
+static void CLI_CmdBaud(uint32_t argc, char *argv[]) {
+	uint32_t baud;
+	uint32_t i;
+
+	if (argc < 2U) {
+		printf("OK baud %lu %s", UART_Baud_Get(),
+				(UART_Baud_IsOver8() != 0U) ? "over8" : "over16");
+		for (i = 0U; i < UART_Baud_ProfileCount(); i++) {
+			baud = UART_Baud_Profile(i);
+			if (UART_Baud_IsSupported(baud) != 0U) {
+				printf(" %lu", baud);
+			}
+		}
+		printf("\r\n");
+		return;
+	}
+	if (strcmp(argv[1], "ok") == 0) {
+		(void) UART_Baud_Confirm();
+		printf("OK baud %lu\r\n", UART_Baud_Get());
+		return;
+	}
+	baud = (uint32_t) strtoul(argv[1], NULL, 10);
+	if (UART_Baud_IsSupported(baud) == 0U) {
+		printf("ERR baud %s not reachable\r\n", argv[1]);
+		return;
+	}
+	printf("OK baud %lu confirm %lu\r\n", baud, (uint32_t) UART_BAUD_CONFIRM_MS);
+	(void) UART_Baud_Propose(baud);
+}
+
+/**
+ * @brief Shows or selects where output goes (uart_tx.h, usb_cdc.h). The
+ *        reply already takes the new path.
+ */
+static void CLI_CmdTransport(uint32_t argc, char *argv[]) {
+	uart_tx_transport_t transport;
+
+	if (argc < 2U) {
+		printf("OK transport %s usb %s\r\n",
+				(UART_TX_GetTransport() == UART_TX_TRANSPORT_USB) ? "usb" :
+				((UART_TX_GetTransport() == UART_TX_TRANSPORT_NONE) ? "none" : "uart"),
+				(Usb_Cdc_IsOpen() != 0U) ? "open" :
+				((Usb_Cdc_IsStarted() != 0U) ? "closed" : "off"));
+		return;
+	}
+	if (strcmp(argv[1], "uart") == 0) {
+		transport = UART_TX_TRANSPORT_USART2;
+		if (Modbus_IsActive() != 0U) {
+			printf("ERR uart is modbus\r\n");
+			return;
+		}
+	} else if (strcmp(argv[1], "usb") == 0) {
+		transport = UART_TX_TRANSPORT_USB;
+		if (Usb_Cdc_IsStarted() == 0U) {
+			printf("ERR usb off\r\n");
+			return;
+		}
+	} else {
+		printf("ERR transport uart|usb\r\n");
+		return;
+	}
+	if (UART_TX_SetTransport(transport) == 0U) {
+		printf("ERR transport busy\r\n");
+		return;
+	}
+	printf("OK transport %s\r\n", argv[1]);
+}
+
+/**
+ * @brief Shows the TX ring's backpressure and the RTS/CTS state
+ *        (uart_flow.h), or turns flow control on or off.
+ */
+static void CLI_CmdFlow(uint32_t argc, char *argv[]) {
+	uart_tx_pressure_t pressure;
+#if UART_FLOW_USE_RTSCTS
+	uart_flow_stats_t stats;
+
+	if (argc >= 2U) {
+		if ((strcmp(argv[1], "on") != 0) && (strcmp(argv[1], "off") != 0)) {
+			printf("ERR flow [on|off]\r\n");
+			return;
+		}
+		UART_Flow_SetOn((strcmp(argv[1], "on") == 0) ? 1U : 0U);
+		printf("OK flow %s\r\n", argv[1]);
+		return;
+	}
+	UART_Flow_GetStats(&stats);
+	printf("OK flow %s cts %s rts %s cts_waits %lu rts_holds %lu",
+			(stats.on != 0U) ? "on" : "off",
+			(stats.cts_clear != 0U) ? "clear" : "held",
+			(stats.rts_ready != 0U) ? "ready" : "held", stats.cts_waits,
+			stats.rts_holds);
+#else
+	(void) argv;
+	if (argc >= 2U) {
+		printf("ERR needs UART_FLOW_USE_RTSCTS\r\n");
+		return;
+	}
+	printf("OK flow none");
+#endif /* UART_FLOW_USE_RTSCTS */
+	pressure = UART_TX_GetPressure();
+	printf(" pressure %s stalls %lu shed %lu dropped %lu\r\n",
+			UART_TX_PressureName(pressure), UART_TX_GetStalls(),
+			DHT11_Sink_GetShed(), UART_TX_GetDropped());
+}
+
+/**
+ * @brief Shows the CAN bus counters and error state (can_bus.h), or
+ *        changes this node's ID.
+ */
+static void CLI_CmdCan(uint32_t argc, char *argv[]) {
+#if CAN_USE_BUS
+	can_bus_stats_t stats;
+	uint32_t node;
+
+	if ((argc >= 3U) && (strcmp(argv[1], "node") == 0)) {
+		node = (uint32_t) strtoul(argv[2], NULL, 0);
+		if ((node >= CAN_BUS_NODE_ALL)
+				|| (Can_Bus_SetNode((uint8_t) node) == 0U)) {
+			printf("ERR can node 0-254\r\n");
+			return;
+		}
+		printf("OK can node %lu\r\n", node);
+		return;
+	}
+	if (argc >= 2U) {
+		printf("ERR can [node <id>]\r\n");
+		return;
+	}
+	if (Can_Bus_IsStarted() == 0U) {
+		printf("ERR can off\r\n");
+		return;
+	}
+	Can_Bus_GetStats(&stats);
+	printf("OK can node %u %lu tx %lu drop %lu rx %lu ovr %lu err %lu"
+			" tec %u rec %u %s\r\n", Can_Bus_GetNode(), Can_Bus_GetBitrate(),
+			stats.tx_frames, stats.tx_dropped, stats.rx_frames,
+			stats.rx_overruns, stats.errors, stats.tec, stats.rec,
+			(stats.bus_off != 0U) ? "bus-off" :
+			((stats.passive != 0U) ? "passive" : "active"));
+#else
+	(void) argc;
+	(void) argv;
+	printf("ERR needs CAN_USE_BUS\r\n");
+#endif /* CAN_USE_BUS */
+}
+
+/**
+ * @brief Shows the wall clock and its discipline (wallclock.h), or syncs it
+ *        to the host's Unix time. Both replies carry the time afterwards,
+ *        so the host can time the round trip.
+ */
+static void CLI_CmdTime(uint32_t argc, char *argv[]) {
+#if WALLCLOCK_USE_SYNC
+	static const char *const actions[] = { "step", "slew" };
+	wallclock_stats_t stats;
+	wallclock_sync_t result = WALLCLOCK_REJECTED;
+	fmt_t line;
+	char *end;
+	uint32_t secs;
+	uint32_t ms = 0U;
+	uint32_t scale = 100U;
+	int32_t offset = 0;
+
+	if (argc >= 2U) {
+		secs = (uint32_t) strtoul(argv[1], &end, 10);
+		if (*end == '.') {
+			/* Digits past milliseconds are dropped */
+			for (end++; (*end >= '0') && (*end <= '9'); end++) {
+				ms += (uint32_t) (*end - '0') * scale;
+				scale /= 10U;
+			}
+		}
+		if ((end != argv[1]) && (*end == '\0')) {
+			result = Wallclock_Sync(secs, ms, &offset);
+		}
+		if (result == WALLCLOCK_REJECTED) {
+			printf("ERR time <unix_s>[.<ms>], 2000-2099\r\n");
+			return;
+		}
+	}
+
+	Wallclock_GetStats(&stats);
+	secs = Wallclock_Now(&ms);
+	Fmt_Begin(&line);
+	if (argc >= 2U) {
+		Fmt_Str(&line, "OK time ");
+		Fmt_Str(&line, actions[result]);
+		Fmt_Char(&line, ' ');
+		Fmt_Int(&line, offset, 0U, ' ');
+		Fmt_Str(&line, " ms ");
+	} else {
+		Fmt_Str(&line, "time ");
+	}
+	Wallclock_Format(&line, secs, ms);
+	Fmt_Char(&line, ' ');
+	Fmt_Uint(&line, secs, 0U, ' ');
+	Fmt_Char(&line, '.');
+	Fmt_Uint(&line, ms, 3U, '0');
+	if (argc < 2U) {
+		Fmt_Str(&line, " synced ");
+		Fmt_Uint(&line, Wallclock_IsSynced(), 0U, ' ');
+		Fmt_Str(&line, " rtc_hz ");
+		Fmt_Uint(&line, Power_GetRtcHz(), 0U, ' ');
+		Fmt_Str(&line, " offset ");
+		Fmt_Int(&line, stats.offset_ms, 0U, ' ');
+		Fmt_Str(&line, " freq ");
+		Fmt_Int(&line, stats.freq, 0U, ' ');
+		Fmt_Str(&line, " slew_ms ");
+		Fmt_Uint(&line, stats.slew_ms, 0U, ' ');
+		Fmt_Str(&line, " syncs ");
+		Fmt_Uint(&line, stats.syncs, 0U, ' ');
+		Fmt_Str(&line, " steps ");
+		Fmt_Uint(&line, stats.steps, 0U, ' ');
+		Fmt_Str(&line, "\r\nOK");
+	}
+	Fmt_Str(&line, "\r\n");
+	(void) Fmt_End(&line);
+#else
+	(void) argc;
+	(void) argv;
+	printf("ERR needs WALLCLOCK_USE_SYNC\r\n");
+#endif /* WALLCLOCK_USE_SYNC */
+}
+
+/**
+ * @brief Prints each sensor's latest published state (dht11_latest.h):
+ *        readings so far, last status, health, last good values and how
+ *        long ago they were taken.
+ */
+static void CLI_CmdLatest(uint32_t argc, char *argv[]) {
+	dht11_latest_t entry;
+	fmt_t line;
+	uint32_t count;
+	uint32_t now = HAL_GetTick();
+	uint8_t i;
+
+	(void) argc;
+	(void) argv;
+	for (i = 0U; i < DHT11_LATEST_SENSORS; i++) {
+		count = DHT11_Latest_Get(i, &entry);
+		if (count == 0U) {
+			continue;
+		}
+		Fmt_Begin(&line);
+		Fmt_Str(&line, "ch ");
+		Fmt_Uint(&line, i, 0U, ' ');
+		Fmt_Str(&line, " n ");
+		Fmt_Uint(&line, count, 0U, ' ');
+		Fmt_Char(&line, ' ');
+		Fmt_Str(&line, DHT11_StatusName(entry.reading.status));
+		Fmt_Char(&line, ' ');
+		Fmt_Str(&line, DHT11_Health_Name(entry.health));
+		if (entry.has_values != 0U) {
+			Fmt_Str(&line, " temp ");
+			Fmt_Fixed(&line, entry.values.temp, 1U);
+			Fmt_Str(&line, " hum ");
+			Fmt_Fixed(&line, entry.values.hum, 1U);
+			Fmt_Str(&line, " age_ms ");
+			Fmt_Uint(&line, now - entry.good_ms, 0U, ' ');
+		}
+		Fmt_Str(&line, "\r\n");
+		(void) Fmt_End(&line);
+	}
+	printf("OK\r\n");
+}
+
+/**
+ * @brief Shows or changes the emulated sensor (dht11_emu.h), or starts a
+ *        loopback bench of n reads.
+ */
+static void CLI_CmdEmu(uint32_t argc, char *argv[]) {
+#if DHT11_EMU_USE_LOOPBACK
+	dht11_emu_cfg_t cfg = DHT11_Emu_GetConfig();
+	dht11_emu_stats_t stats;
+	uint32_t value;
+	uint32_t i;
+
+	if (argc < 2U) {
+		DHT11_Emu_GetStats(&stats);
+		printf("emu frame %u %u %u %u %u wait %u resp %u low %u zero %u one %u"
+				" jitter %u\r\n", cfg.frame[0], cfg.frame[1], cfg.frame[2],
+				cfg.frame[3], cfg.frame[4], cfg.wait_us, cfg.resp_us, cfg.low_us,
+				cfg.zero_us, cfg.one_us, cfg.jitter_us);
+		printf("emu sent %lu stale %lu reads %lu ok %lu wrong %lu left %lu"
+				" ms %lu per_min %lu\r\n", stats.frames_sent, stats.stale,
+				stats.reads, stats.ok, stats.wrong, stats.run_left,
+				stats.elapsed_ms, (stats.elapsed_ms != 0U) ?
+						(uint32_t) (((uint64_t) stats.reads * 60000U)
+								/ stats.elapsed_ms) : 0U);
+		for (i = 0U; i < DHT11_PROF_STATUSES; i++) {
+			if (stats.status[i] != 0U) {
+				printf("emu %s %lu\r\n", DHT11_StatusName((dht11_status_t) i),
+						stats.status[i]);
+			}
+		}
+		printf("OK\r\n");
+		return;
+	}
+	if ((strcmp(argv[1], "run") == 0) && (argc >= 3U)) {
+		value = (uint32_t) strtoul(argv[2], NULL, 10);
+		if (DHT11_Emu_Run(value) == 0U) {
+			printf("ERR not under the RTOS or multi reader\r\n");
+			return;
+		}
+		printf("OK emu run %lu\r\n", value);
+		return;
+	}
+	if ((strcmp(argv[1], "frame") == 0) && (argc >= 6U)) {
+		for (i = 0U; i < 5U; i++) {
+			value = (i < (argc - 2U)) ? (uint32_t) strtoul(argv[i + 2U], NULL, 0)
+					: 0U;
+			if (value > 0xFFU) {
+				printf("ERR bytes 0-255\r\n");
+				return;
+			}
+			cfg.frame[i] = (uint8_t) value;
+		}
+		if (argc < 7U) {
+			cfg.frame[4] = (uint8_t) (cfg.frame[0] + cfg.frame[1] + cfg.frame[2]
+					+ cfg.frame[3]);
+		}
+	} else if ((strcmp(argv[1], "timing") == 0) && (argc >= 5U)) {
+		cfg.low_us = (uint16_t) strtoul(argv[2], NULL, 10);
+		cfg.zero_us = (uint16_t) strtoul(argv[3], NULL, 10);
+		cfg.one_us = (uint16_t) strtoul(argv[4], NULL, 10);
+		if (argc >= 6U) {
+			cfg.resp_us = (uint16_t) strtoul(argv[5], NULL, 10);
+		}
+		if (argc >= 7U) {
+			cfg.wait_us = (uint16_t) strtoul(argv[6], NULL, 10);
+		}
+	} else if ((strcmp(argv[1], "jitter") == 0) && (argc >= 3U)) {
+		cfg.jitter_us = (uint16_t) strtoul(argv[2], NULL, 10);
+	} else {
+		printf("ERR usage: emu [run <n>|frame ...|timing ...|jitter <us>]\r\n");
+		return;
+	}
+	DHT11_Emu_SetConfig(&cfg);
+	cfg = DHT11_Emu_GetConfig();
+	printf("OK emu frame %u %u %u %u %u timing %u %u %u %u %u jitter %u\r\n",
+			cfg.frame[0], cfg.frame[1], cfg.frame[2], cfg.frame[3], cfg.frame[4],
+			cfg.low_us, cfg.zero_us, cfg.one_us, cfg.resp_us, cfg.wait_us,
+			cfg.jitter_us);
+#else
+	(void) argc;
+	(void) argv;
+	printf("ERR needs DHT11_EMU_USE_LOOPBACK\r\n");
+#endif /* DHT11_EMU_USE_LOOPBACK */
+}
+
+/**
+ * @brief Shows or changes a sensor's glitch rejection: the TIM5 input
+ *        filter and the minimum pulse width (dht11_capture.h).
+ */
+static void CLI_CmdGlitch(uint32_t argc, char *argv[]) {
+	dht11_capture_filter_t filter;
+	uint32_t ch;
+	uint32_t icf;
+	uint32_t min_us;
+
+	if (argc < 2U) {
+		for (ch = 0U; ch < DHT11_CAPTURE_SENSORS; ch++) {
+			filter = DHT11_Capture_GetFilter((uint8_t) ch);
+			printf("glitch %lu icf %u ns %lu min_us %u dropped %lu\r\n", ch,
+					filter.ic_filter, DHT11_Capture_FilterNs(filter.ic_filter),
+					filter.min_pulse_us, DHT11_Capture_GetGlitches((uint8_t) ch));
+		}
+		printf("OK\r\n");
+		return;
+	}
+	if (argc < 4U) {
+		printf("ERR usage: glitch <ch> <icf> <min_us>\r\n");
+		return;
+	}
+	ch = (uint32_t) strtoul(argv[1], NULL, 10);
+	icf = (uint32_t) strtoul(argv[2], NULL, 10);
+	min_us = (uint32_t) strtoul(argv[3], NULL, 10);
+	filter.ic_filter = (uint8_t) icf;
+	filter.min_pulse_us = (uint8_t) min_us;
+	if ((ch > 0xFFU) || (icf > DHT11_CAPTURE_IC_FILTER_MAX)
+			|| (min_us > DHT11_CAPTURE_GUARD_MAX_US)
+			|| (DHT11_Capture_SetFilter((uint8_t) ch, &filter) == 0U)) {
+		printf("ERR ch 0-%lu, icf 0-%lu on ch 0 only, min_us 0-%lu\r\n",
+				(uint32_t) DHT11_CAPTURE_SENSORS - 1U,
+				(uint32_t) DHT11_CAPTURE_IC_FILTER_MAX,
+				(uint32_t) DHT11_CAPTURE_GUARD_MAX_US);
+		return;
+	}
+	printf("OK glitch %lu icf %lu ns %lu min_us %lu\r\n", ch, icf,
+			DHT11_Capture_FilterNs((uint8_t) icf), min_us);
+}
+
+/**
+ * @brief Shows the sensor supplies, sets gating or power-cycles a sensor.
+ */
+static void CLI_CmdSupply(uint32_t argc, char *argv[]) {
+#if DHT11_USE_SUPPLY
+	dht11_supply_info_t info;
+	uint32_t ch;
+	uint8_t ok;
+
+	if (argc < 2U) {
+		for (ch = 0U; ch < DHT11_HEALTH_SENSORS; ch++) {
+			info = DHT11_Supply_GetInfo(ch);
+			if (info.state == DHT11_SUPPLY_UNSWITCHED) {
+				continue;
+			}
+			printf("supply %lu %s gate %u ready_in_ms %lu cycles %lu off_ms %lu\r\n",
+					ch, DHT11_Supply_Name(info.state), info.gating,
+					info.ready_in_ms, info.cycles, info.off_ms);
+		}
+		printf("OK\r\n");
+		return;
+	}
+	if (argc < 3U) {
+		printf("ERR usage: supply <ch> gate|always|cycle\r\n");
+		return;
+	}
+	ch = (uint32_t) strtoul(argv[1], NULL, 10);
+	if (strcmp(argv[2], "gate") == 0) {
+		ok = DHT11_Supply_SetGating(ch, 1U);
+	} else if (strcmp(argv[2], "always") == 0) {
+		ok = DHT11_Supply_SetGating(ch, 0U);
+	} else if (strcmp(argv[2], "cycle") == 0) {
+#if DHT11_USE_ASYNC
+		if ((ch == 0U) && (DHT11_Async_IsBusy() != 0U)) {
+			printf("ERR sensor busy, retry\r\n");
+			return;
+		}
+#endif /* DHT11_USE_ASYNC */
+		ok = DHT11_Supply_Cycle(ch);
+	} else {
+		printf("ERR usage: supply <ch> gate|always|cycle\r\n");
+		return;
+	}
+	if (ok == 0U) {
+		printf("ERR ch %lu has no supply output\r\n", ch);
+		return;
+	}
+	info = DHT11_Supply_GetInfo(ch);
+	printf("OK supply %lu %s gate %u\r\n", ch, DHT11_Supply_Name(info.state),
+			info.gating);
+#else
+	(void) argc;
+	(void) argv;
+	printf("ERR needs DHT11_USE_SUPPLY\r\n");
+#endif /* DHT11_USE_SUPPLY */
+}
+
+/**
+ * @brief Shows which sensors answer and which are rechecked slowly.
+ */
+static void CLI_CmdDiscover(uint32_t argc, char *argv[]) {
+#if DHT11_USE_DISCOVERY
+	dht11_discover_stats_t stats;
+	dht11_presence_t presence;
+	uint32_t ch;
+
+	(void) argc;
+	(void) argv;
+	for (ch = 0U; ch < DHT11_DISCOVER_SENSORS; ch++) {
+		presence = DHT11_Discover_Get(ch);
+		if (presence != DHT11_PRESENCE_UNKNOWN) {
+			printf("discover %lu %s\r\n", ch, DHT11_Discover_Name(presence));
+		}
+	}
+	DHT11_Discover_GetStats(&stats);
+	printf("OK discover present 0x%02lx absent 0x%02lx found %lu lost %lu rechecks %lu recheck_ms %lu\r\n",
+			stats.present, stats.absent, stats.found, stats.lost,
+			stats.rechecks, (uint32_t) DHT11_DISCOVER_RECHECK_MS);
+#else
+	(void) argc;
+	(void) argv;
+	printf("ERR needs DHT11_USE_DISCOVERY\r\n");
+#endif /* DHT11_USE_DISCOVERY */
+}
+
+/**
+ * @brief Prints each watched sensor's timing drift (dht11_drift.h), or
+ *        clears one sensor's statistics. Durations are in microseconds with
+ *        one decimal, the failure rate in permille.
+ */
+static void CLI_CmdDrift(uint32_t argc, char *argv[]) {
+#if DHT11_USE_DRIFT
+	const dht11_drift_t *d;
+	fmt_t line;
+	uint32_t ch;
+	uint32_t i;
+
+	if (argc >= 2U) {
+		if ((strcmp(argv[1], "reset") != 0) || (argc < 3U)
+				|| ((ch = (uint32_t) strtoul(argv[2], NULL, 10))
+						>= DHT11_DRIFT_SENSORS)) {
+			printf("ERR usage: drift [reset <ch>], ch 0-%lu\r\n",
+					(uint32_t) DHT11_DRIFT_SENSORS - 1U);
+			return;
+		}
+		DHT11_Drift_Reset(ch);
+		printf("OK drift %lu reset\r\n", ch);
+		return;
+	}
+	for (ch = 0U; ch < DHT11_DRIFT_SENSORS; ch++) {
+		d = DHT11_Drift_Get(ch);
+		if (d->frames == 0U) {
+			continue;
+		}
+		Fmt_Begin(&line);
+		Fmt_Str(&line, "ch ");
+		Fmt_Uint(&line, ch, 0U, ' ');
+		Fmt_Str(&line, " frames ");
+		Fmt_Uint(&line, d->frames, 0U, ' ');
+		Fmt_Str(&line, " resp ");
+		Fmt_Fixed(&line, (int32_t) ((d->response.mean_q8 * 10U) >> 8), 1U);
+		Fmt_Str(&line, " zero ");
+		Fmt_Fixed(&line, (int32_t) ((d->bit[0].mean_q8 * 10U) >> 8), 1U);
+		Fmt_Char(&line, '/');
+		Fmt_Fixed(&line, (int32_t) ((DHT11_Drift_SdQ4(&d->bit[0]) * 10U) >> 4),
+				1U);
+		Fmt_Str(&line, " one ");
+		Fmt_Fixed(&line, (int32_t) ((d->bit[1].mean_q8 * 10U) >> 8), 1U);
+		Fmt_Char(&line, '/');
+		Fmt_Fixed(&line, (int32_t) ((DHT11_Drift_SdQ4(&d->bit[1]) * 10U) >> 4),
+				1U);
+		Fmt_Str(&line, " margin ");
+		Fmt_Fixed(&line, (d->margin_q4 * 10) / 16, 1U);
+		if (d->baseline != 0U) {
+			Fmt_Str(&line, " base ");
+			Fmt_Fixed(&line, (d->base_margin_q4 * 10) / 16, 1U);
+		}
+		Fmt_Str(&line, " csum_pm ");
+		Fmt_Uint(&line, d->fail_permille, 0U, ' ');
+		Fmt_Str(&line, " events");
+		for (i = 0U; i < DHT11_DRIFT_EVENTS; i++) {
+			if ((d->events & (1U << i)) != 0U) {
+				Fmt_Char(&line, ' ');
+				Fmt_Str(&line, DHT11_Drift_EventName(i));
+			}
+		}
+		if (d->events == 0U) {
+			Fmt_Str(&line, " none");
+		}
+		Fmt_Str(&line, " raised ");
+		Fmt_Uint(&line, d->raised, 0U, ' ');
+		Fmt_Str(&line, "\r\n");
+		(void) Fmt_End(&line);
+	}
+	printf("OK\r\n");
+#else
+	(void) argc;
+	(void) argv;
+	printf("ERR needs DHT11_USE_DRIFT\r\n");
+#endif /* DHT11_USE_DRIFT */
+}
+
+/**
+ * @brief Shows or sets what the raw frame recorder keeps (dht11_trace.h),
+ *        clears it, or dumps it as 0x0A packets, over USB CDC when the
+ *        host has that port open. The reply follows the dump on the
+ *        console's transport.
+ */
+static void CLI_CmdTrace(uint32_t argc, char *argv[]) {
+#if DHT11_USE_TRACE
+	uart_tx_transport_t console = UART_TX_GetTransport();
+	uint8_t moved = 0U;
+	uint32_t sent = 0U;
+	uint32_t n;
+	uint32_t i;
+
+	if (argc < 2U) {
+		printf("trace %s waiting %lu/%lu recorded %lu overwritten %lu\r\n",
+				DHT11_Trace_ModeName(DHT11_Trace_GetMode()), DHT11_Trace_Count(),
+				(uint32_t) DHT11_TRACE_RECORDS, DHT11_Trace_GetRecorded(),
+				DHT11_Trace_GetOverwritten());
+		printf("OK\r\n");
+		return;
+	}
+	if (strcmp(argv[1], "clear") == 0) {
+		DHT11_Trace_Clear();
+		printf("OK trace cleared\r\n");
+		return;
+	}
+	if (strcmp(argv[1], "dump") == 0) {
+		if ((console != UART_TX_TRANSPORT_USB) && (Usb_Cdc_IsOpen() != 0U)) {
+			(void) UART_TX_Flush(100U);
+			moved = UART_TX_SetTransport(UART_TX_TRANSPORT_USB);
+		}
+		while (DHT11_Trace_Count() != 0U) {
+			n = DHT11_Trace_Drain(DHT11_Trace_Count());
+			sent += n;
+			if ((n == 0U) && (UART_TX_Flush(100U) == 0U)) {
+				break;
+			}
+		}
+		(void) UART_TX_Flush(100U);
+		if (moved != 0U) {
+			(void) UART_TX_SetTransport(console);
+		}
+		printf("OK trace dumped %lu %s\r\n", sent,
+				((moved != 0U) || (console == UART_TX_TRANSPORT_USB)) ?
+						"usb" : "uart");
+		return;
+	}
+	for (i = 0U; i < (uint32_t) DHT11_TRACE_MODES; i++) {
+		if (strcmp(argv[1], DHT11_Trace_ModeName((dht11_trace_mode_t) i)) == 0) {
+			DHT11_Trace_SetMode((dht11_trace_mode_t) i);
+			printf("OK trace %s\r\n", argv[1]);
+			return;
+		}
+	}
+	printf("ERR trace off|failed|all|dump|clear\r\n");
+#else
+	(void) argc;
+	(void) argv;
+	printf("ERR needs DHT11_USE_TRACE\r\n");
+#endif /* DHT11_USE_TRACE */
+}
+
+/**
+ * @brief Shows the lock to the shared sync pulse (dht11_sync.h), or sets
+ *        this node's offset from it. The offset applies from each
+ *        sensor's next slot.
+ */
+static void CLI_CmdSync(uint32_t argc, char *argv[]) {
+#if DHT11_USE_SYNC
+	dht11_sync_stats_t stats;
+	uint32_t ms;
+
+	if ((argc >= 3U) && (strcmp(argv[1], "offset") == 0)) {
+		ms = (uint32_t) strtoul(argv[2], NULL, 10);
+		if (DHT11_Sync_SetOffset(ms) == 0U) {
+			printf("ERR sync offset 0-%lu ms\r\n",
+					(uint32_t) DHT11_SYNC_MAX_OFFSET_MS);
+			return;
+		}
+		printf("OK sync offset %lu\r\n", ms);
+		return;
+	}
+	if (argc >= 2U) {
+		printf("ERR sync [offset <ms>]\r\n");
+		return;
+	}
+	DHT11_Sync_GetStats(&stats);
+	printf("OK sync %s offset %lu pulses %lu rejected %lu interval_us %lu"
+			" jitter_us %lu age_ms %lu\r\n",
+			(stats.locked != 0U) ? "locked" : "free", DHT11_Sync_GetOffset(),
+			stats.pulses, stats.rejected, stats.interval_us, stats.jitter_us,
+			stats.age_ms);
+#else
+	(void) argc;
+	(void) argv;
+	printf("ERR needs DHT11_USE_SYNC\r\n");
+#endif /* DHT11_USE_SYNC */
+}
+
+/**
+ * @brief Shows the status LED state (status_led.h), or forces one to check
+ *        its pattern until "led auto".
+ */
+static void CLI_CmdLed(uint32_t argc, char *argv[]) {
+	uint32_t state;
+
+	if (argc >= 2U) {
+		if (strcmp(argv[1], "auto") == 0) {
+			Status_Led_Force(STATUS_LED_STATES);
+			printf("OK led auto\r\n");
+			return;
+		}
+		for (state = 0U; state < (uint32_t) STATUS_LED_STATES; state++) {
+			if (strcmp(argv[1], Status_Led_Name((status_led_state_t) state)) == 0) {
+				break;
+			}
+		}
+		if (state >= (uint32_t) STATUS_LED_STATES) {
+			printf("ERR led [ok|retrying|link_down|fault|auto]\r\n");
+			return;
+		}
+		Status_Led_Force((status_led_state_t) state);
+		printf("OK led %s forced\r\n", argv[1]);
+		return;
+	}
+	printf("OK led %s %s\r\n", Status_Led_Name(Status_Led_Get()),
+			(Status_Led_IsForced() != 0U) ? "forced" :
+					((STATUS_LED_USE_PWM != 0) ? "auto" : "toggle"));
+}
+
+/**
+ * @brief Asks for an on-demand reading (dht11_trigger.h), as B1 does; the
+ *        reading follows on the normal output.
+ */
+static void CLI_CmdRead(uint32_t argc, char *argv[]) {
+#if DHT11_USE_TRIGGER
+	dht11_trigger_stats_t stats;
+#endif /* DHT11_USE_TRIGGER */
+
+	(void) argc;
+	(void) argv;
+#if DHT11_USE_TRIGGER
+	DHT11_Trigger_Request();
+	DHT11_Trigger_GetStats(&stats);
+	printf("OK read presses %lu bounces %lu commands %lu served %lu\r\n",
+			stats.presses, stats.bounces, stats.commands, stats.served);
+#else
+	printf("ERR needs DHT11_USE_TRIGGER\r\n");
+#endif /* DHT11_USE_TRIGGER */
+}
+
+/**
+ * @brief Prints the ADC monitor values (adc_mon.h) and its counters.
+ */
+static void CLI_CmdAdc(uint32_t argc, char *argv[]) {
+#if ADC_MON_USE_ADC
+	adc_mon_values_t values;
+	adc_mon_stats_t stats;
+#endif /* ADC_MON_USE_ADC */
+
+	(void) argc;
+	(void) argv;
+#if ADC_MON_USE_ADC
+	Adc_Mon_Get(&values);
+	Adc_Mon_GetStats(&stats);
+	if (values.valid == 0U) {
+		printf("ERR adc not ready\r\n");
+		return;
+	}
+	printf("OK adc vdda_mv %lu die_tenths %ld a2_mv %lu a3_mv %lu brownouts %lu "
+			"low %u overruns %lu checked %lu disagree %lu\r\n",
+			values.vdda_mv, values.die_tenths, values.ext_mv[0],
+			values.ext_mv[1], stats.brownouts, stats.low, stats.overruns,
+			stats.checked, stats.disagree);
+#else
+	printf("ERR needs ADC_MON_USE_ADC\r\n");
+#endif /* ADC_MON_USE_ADC */
+}
+
+/**
+ * @brief Shows the RS-485 gateway (rs485_gw.h) counters or its nodes, or
+ *        changes what it polls.
+ */
+static void CLI_CmdGw(uint32_t argc, char *argv[]) {
+#if RS485_USE_GATEWAY
+	rs485_gw_stats_t stats;
+	rs485_gw_node_t node;
+	uint32_t value;
+	uint32_t down = 0U;
+	uint32_t i;
+	uint8_t ok;
+
+	if ((argc == 2U) && (strcmp(argv[1], "list") == 0)) {
+		for (i = 0U; i < Rs485_Gw_GetNodes(); i++) {
+			Rs485_Gw_GetNode(i, &node);
+			printf("node %u link %s%s polls %lu timeouts %lu errors %lu\r\n",
+					node.address,
+					Rs485_Gw_LinkName((rs485_gw_link_t) node.link),
+					(node.down != 0U) ? " down" : "", node.polls,
+					node.timeouts, node.errors);
+		}
+		printf("OK\r\n");
+		return;
+	}
+	if (argc == 3U) {
+		value = (uint32_t) strtoul(argv[2], NULL, 10);
+		if (strcmp(argv[1], "nodes") == 0) {
+			ok = Rs485_Gw_SetNodes(value);
+		} else if (strcmp(argv[1], "period") == 0) {
+			ok = Rs485_Gw_SetPeriod(value);
+		} else if (strcmp(argv[1], "timeout") == 0) {
+			ok = Rs485_Gw_SetTimeout(value);
+		} else {
+			ok = 0U;
+		}
+		if (ok == 0U) {
+			printf("ERR gw nodes 1-%lu|period 100-3600000|timeout 1-1000\r\n",
+					(uint32_t) RS485_GW_NODES_MAX);
+			return;
+		}
+		printf("OK gw %s %lu\r\n", argv[1], value);
+		return;
+	}
+	if (argc >= 2U) {
+		printf("ERR gw [list|nodes <n>|period <ms>|timeout <ms>]\r\n");
+		return;
+	}
+	for (i = 0U; i < Rs485_Gw_GetNodes(); i++) {
+		Rs485_Gw_GetNode(i, &node);
+		down += node.down;
+	}
+	Rs485_Gw_GetStats(&stats);
+	printf("OK gw nodes %lu down %lu period_ms %lu timeout_ms %lu rounds %lu"
+			" polls %lu timeouts %lu crc %lu exceptions %lu records %lu"
+			" overruns %lu\r\n", Rs485_Gw_GetNodes(), down,
+			Rs485_Gw_GetPeriod(), Rs485_Gw_GetTimeout(), stats.rounds,
+			stats.polls, stats.timeouts, stats.crc_errors, stats.exceptions,
+			stats.records, stats.overruns);
+#else
+	(void) argc;
+	(void) argv;
+	printf("ERR needs RS485_USE_GATEWAY\r\n");
+#endif /* RS485_USE_GATEWAY */
+}
+
+/**
+ * @brief Shows where the running settings came from, saves them to flash
+ *        for the next boot or erases the saved copies.
+ */
+static void CLI_CmdConfig(uint32_t argc, char *argv[]) {
+#if CONFIG_USE_STORE
+	static const char *const copies[] = { "defaults", "A", "B" };
+	config_info_t info;
+	HAL_StatusTypeDef status = HAL_OK;
+
+	if (argc >= 2U) {
+		if ((strcmp(argv[1], "save") != 0) && (strcmp(argv[1], "erase") != 0)) {
+			printf("ERR usage: config [save|erase]\r\n");
+			return;
+		}
+#if DHT11_USE_ASYNC
+		/* The erase stalls the CPU, and a transaction would miss edges */
+		if (DHT11_Async_IsBusy() != 0U) {
+			printf("ERR sensor busy, retry\r\n");
+			return;
+		}
+#endif /* DHT11_USE_ASYNC */
+		(void) UART_TX_Flush(100U);
+		status = (argv[1][0] == 's') ? Config_Save() : Config_Erase();
+	}
+	if (status == HAL_BUSY) {
+		printf("ERR baud not confirmed\r\n");
+		return;
+	}
+	if (status != HAL_OK) {
+		printf("ERR config flash failed\r\n");
+		return;
+	}
+	Config_GetInfo(&info);
+	printf("OK config %s seq %lu saves %lu errors %lu rejected %lu\r\n",
+			copies[info.copy], info.sequence, info.saves, info.errors,
+			info.rejected);
+#else
+	(void) argc;
+	(void) argv;
+	printf("ERR needs CONFIG_USE_STORE\r\n");
+#endif /* CONFIG_USE_STORE */
+}
+
+/**
+ * @brief Resets into the bootloader, which stays for a firmware update
+ *        (boot_layout.h); the reply names the rate it listens at.
+ */
+static void CLI_CmdUpdate(uint32_t argc, char *argv[]) {
+	(void) argc;
+	(void) argv;
+
+	printf("OK update baud %lu\r\n", (uint32_t) BOOT_BAUD);
+	(void) UART_TX_Flush(100U);
+	__HAL_RCC_PWR_CLK_ENABLE();
+	HAL_PWR_EnableBkUpAccess();
+	RTC->BKP1R = BOOT_REQUEST_MAGIC;
+	NVIC_SystemReset();
+}
+
+/**
+ * @brief Splits the line in place and runs the matching command.
+ */
+static void CLI_Execute(char *line) {
+	char *argv[CLI_MAX_ARGS];
+	uint32_t argc = 0U;
+	char *p = line;
+	uint32_t i;
+
+	while ((*p != '\0') && (argc < CLI_MAX_ARGS)) {
+		while (*p == ' ') {
+			*p++ = '\0';
+		}
+		if (*p == '\0') {
+			break;
+		}
+		argv[argc++] = p;
+		while ((*p != ' ') && (*p != '\0')) {
+			p++;
+		}
+	}
+	if (argc == 0U) {
+		return;
+	}
+
+	for (i = 0U; i < CLI_COMMAND_COUNT; i++) {
+		if (strcmp(argv[0], cli_commands[i].name) == 0) {
+			cli_commands[i].handler(argc, argv);
+			return;
+		}
+	}
+	printf("ERR unknown command, try help\r\n");
+}
+
+/**
+ * @brief Resets the line buffer.
+ */
+void CLI_Init(void) {
+	cli_len = 0U;
+	cli_overflow = 0U;
+}
+
+/**
+ * @brief Adds received bytes to the line, executing it at CR or LF.
+ */
+static void CLI_Feed(const uint8_t *chunk, uint32_t n) {
+	uint32_t i;
+	char c;
+
+	/* Stay out of STOP while someone is typing */
+	Power_NotifyActivity();
+	for (i = 0U; i < n; i++) {
+		c = (char) chunk[i];
+		if ((c == '\r') || (c == '\n')) {
+			if (cli_overflow != 0U) {
+				printf("ERR line too long\r\n");
+			} else if (cli_len != 0U) {
+				cli_line[cli_len] = '\0';
+				CLI_Execute(cli_line);
+			}
+			cli_len = 0U;
+			cli_overflow = 0U;
+		} else if ((c == '\b') || (c == 0x7F)) {
+			if (cli_len != 0U) {
+				cli_len--;
+			}
+		} else if (cli_len < CLI_LINE_MAX) {
+			cli_line[cli_len++] = c;
+		} else {
+			cli_overflow = 1U;
+		}
+	}
+}
+
+/**
+ * @brief Consumes received bytes and executes complete lines.
+ */
+void CLI_Poll(void) {
+	uint8_t chunk[16];
+	uint32_t n;
+
+	UART_Baud_Poll();
+	DHT11_Agg_Poll();
+#if WALLCLOCK_USE_SYNC
+	Wallclock_Poll();
+#endif /* WALLCLOCK_USE_SYNC */
+#if I2C_USE_REGMAP
+	I2C_Regmap_Poll();
+#endif /* I2C_USE_REGMAP */
+#if MODBUS_USE_RTU
+	Modbus_Poll();
+#endif /* MODBUS_USE_RTU */
+#if RS485_USE_GATEWAY
+	Rs485_Gw_Poll();
+#endif /* RS485_USE_GATEWAY */
+#if DHT11_EMU_USE_LOOPBACK
+	DHT11_Emu_Poll();
+#endif /* DHT11_EMU_USE_LOOPBACK */
+#if USB_USE_CDC
+	/* Both ports share one line buffer; type on one at a time */
+	while ((n = Usb_Cdc_Read(chunk, sizeof(chunk))) != 0U) {
+		CLI_Feed(chunk, n);
+	}
+#endif /* USB_USE_CDC */
+#if CAN_USE_BUS
+	/* Command frames from a bus master, same line buffer */
+	while ((n = Can_Bus_Read(chunk, sizeof(chunk))) != 0U) {
+		CLI_Feed(chunk, n);
+	}
+#endif /* CAN_USE_BUS */
+	/* USART2 input belongs to the Modbus master */
+	if ((Modbus_IsActive() != 0U) || (UART_RX_HasEvent() == 0U)) {
+		return;
+	}
+
+	while ((n = UART_RX_Read(chunk, sizeof(chunk))) != 0U) {
+		CLI_Feed(chunk, n);
+	}
+}
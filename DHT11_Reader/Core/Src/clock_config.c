@@ -0,0 +1,246 @@
+/**
+ ******************************************************************************
+ * @file           : clock_config.c
+ * @brief          : Selectable system clock profiles for the STM32F446RE.
+ *
+ *                   Switching sequence (RM0390 §5.1.4, §6.3.3):
+ *                     1. Run SYSCLK from HSI so the PLL can be stopped.
+ *                     2. Drop over-drive, stop the PLL.
+ *                     3. Program VOS (only writable while the PLL is off).
+ *                     4. Restart oscillators/PLL for the new profile.
+ *                     5. Enable over-drive if required (PLL must be on).
+ *                     6. Switch SYSCLK; HAL orders the flash latency change.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "clock_config.h"
+
+/**
+ * @brief Static description of one profile.
+ */
+typedef struct {
+	const char *name;
+	uint32_t voltageScale;
+	uint8_t overDrive;
+	uint8_t usePll;
+	uint32_t pllm;
+	uint32_t plln;
+	uint32_t pllp;
+	uint32_t ahbDiv;
+	uint32_t apb1Div;
+	uint32_t apb2Div;
+	uint32_t flashLatency;
+} clock_profile_desc_t;
+
+/* 8 MHz HSE / PLLM = 2 MHz VCO input */
+static const clock_profile_desc_t clock_profiles[CLOCK_PROFILE_COUNT] = {
+	/* LOW_POWER: 16 MHz straight from HSI */
+	{ "low-power", PWR_REGULATOR_VOLTAGE_SCALE3, 0U, 0U, 0U, 0U, 0U,
+	  RCC_SYSCLK_DIV1, RCC_HCLK_DIV1, RCC_HCLK_DIV1, FLASH_LATENCY_0 },
+	/* BALANCED: 2 MHz * 50 / 2 = 50 MHz */
+	{ "balanced", PWR_REGULATOR_VOLTAGE_SCALE3, 0U, 1U, 4U, 50U, RCC_PLLP_DIV2,
+	  RCC_SYSCLK_DIV1, RCC_HCLK_DIV2, RCC_HCLK_DIV1, FLASH_LATENCY_1 },
+	/* HIGH_PERF: 2 MHz * 180 / 2 = 180 MHz, 5 WS at 2.7-3.6 V */
+	{ "high-perf", PWR_REGULATOR_VOLTAGE_SCALE1, 1U, 1U, 4U, 180U, RCC_PLLP_DIV2,
+	  RCC_SYSCLK_DIV1, RCC_HCLK_DIV4, RCC_HCLK_DIV2, FLASH_LATENCY_5 }
+};
+
+static clock_profile_t clock_active = CLOCK_PROFILE_BALANCED;
+
+/**
+ * @brief Runs the core from HSI with the PLL stopped.
+ */
+static HAL_StatusTypeDef Clock_EnterSafeHsi(void) {
+	RCC_OscInitTypeDef RCC_OscInitStruct = { 0 };
+	RCC_ClkInitTypeDef RCC_ClkInitStruct = { 0 };
+
+	RCC_OscInitStruct.OscillatorType = RCC_OSCILLATORTYPE_HSI;
+	RCC_OscInitStruct.HSIState = RCC_HSI_ON;
+	RCC_OscInitStruct.HSICalibrationValue = RCC_HSICALIBRATION_DEFAULT;
+	RCC_OscInitStruct.PLL.PLLState = RCC_PLL_NONE;
+	if (HAL_RCC_OscConfig(&RCC_OscInitStruct) != HAL_OK) {
+		return HAL_ERROR;
+	}
+
+	/* Keep the current (higher or equal) latency while slowing down */
+	RCC_ClkInitStruct.ClockType = RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_SYSCLK
+			| RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
+	RCC_ClkInitStruct.SYSCLKSource = RCC_SYSCLKSOURCE_HSI;
+	RCC_ClkInitStruct.AHBCLKDivider = RCC_SYSCLK_DIV1;
+	RCC_ClkInitStruct.APB1CLKDivider = RCC_HCLK_DIV1;
+	RCC_ClkInitStruct.APB2CLKDivider = RCC_HCLK_DIV1;
+	if (HAL_RCC_ClockConfig(&RCC_ClkInitStruct, __HAL_FLASH_GET_LATENCY())
+			!= HAL_OK) {
+		return HAL_ERROR;
+	}
+
+	if ((PWR->CSR & PWR_CSR_ODRDY) != 0U) {
+		if (HAL_PWREx_DisableOverDrive() != HAL_OK) {
+			return HAL_ERROR;
+		}
+	}
+
+	__HAL_RCC_PLL_DISABLE();
+	while (__HAL_RCC_GET_FLAG(RCC_FLAG_PLLRDY) != 0U) {
+		/* PLL stops within a few cycles */
+	}
+	return HAL_OK;
+}
+
+/**
+ * @brief Enables prefetch and both ART caches, resetting the caches first.
+ */
+static void Clock_EnableArt(void) {
+	__HAL_FLASH_INSTRUCTION_CACHE_DISABLE();
+	__HAL_FLASH_DATA_CACHE_DISABLE();
+	__HAL_FLASH_INSTRUCTION_CACHE_RESET();
+	__HAL_FLASH_DATA_CACHE_RESET();
+	__HAL_FLASH_INSTRUCTION_CACHE_ENABLE();
+	__HAL_FLASH_DATA_CACHE_ENABLE();
+	__HAL_FLASH_PREFETCH_BUFFER_ENABLE();
+}
+
+/**
+ * @brief Programs a clock profile.
+ */
+HAL_StatusTypeDef Clock_ApplyProfile(clock_profile_t profile) {
+	const clock_profile_desc_t *desc;
+	RCC_OscInitTypeDef RCC_OscInitStruct = { 0 };
+	RCC_ClkInitTypeDef RCC_ClkInitStruct = { 0 };
+
+	if (profile >= CLOCK_PROFILE_COUNT) {
+		return HAL_ERROR;
+	}
+	desc = &clock_profiles[profile];
+
+	__HAL_RCC_PWR_CLK_ENABLE();
+	if (Clock_EnterSafeHsi() != HAL_OK) {
+		return HAL_ERROR;
+	}
+
+	/** Configure the main internal regulator output voltage
+	 */
+	__HAL_PWR_VOLTAGESCALING_CONFIG(desc->voltageScale);
+
+	/** Initializes the RCC Oscillators according to the specified parameters
+	 * in the RCC_OscInitTypeDef structure.
+	 */
+	if (desc->usePll != 0U) {
+		RCC_OscInitStruct.OscillatorType = RCC_OSCILLATORTYPE_HSE;
+		RCC_OscInitStruct.HSEState = RCC_HSE_ON;
+		RCC_OscInitStruct.PLL.PLLState = RCC_PLL_ON;
+		RCC_OscInitStruct.PLL.PLLSource = RCC_PLLSOURCE_HSE;
+		RCC_OscInitStruct.PLL.PLLM = desc->pllm;
+		RCC_OscInitStruct.PLL.PLLN = desc->plln;
+		RCC_OscInitStruct.PLL.PLLP = desc->pllp;
+		RCC_OscInitStruct.PLL.PLLQ = 2;
+		RCC_OscInitStruct.PLL.PLLR = 2;
+	} else {
+		RCC_OscInitStruct.OscillatorType = RCC_OSCILLATORTYPE_HSE;
+		RCC_OscInitStruct.HSEState = RCC_HSE_OFF;
+		RCC_OscInitStruct.PLL.PLLState = RCC_PLL_OFF;
+	}
+	if (HAL_RCC_OscConfig(&RCC_OscInitStruct) != HAL_OK) {
+		return HAL_ERROR;
+	}
+
+	/** Activate the Over-Drive mode (required above 168 MHz)
+	 */
+	if (desc->overDrive != 0U) {
+		if (HAL_PWREx_EnableOverDrive() != HAL_OK) {
+			return HAL_ERROR;
+		}
+	}
+
+	/** Initializes the CPU, AHB and APB buses clocks
+	 */
+	RCC_ClkInitStruct.ClockType = RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_SYSCLK
+			| RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
+	RCC_ClkInitStruct.SYSCLKSource =
+			(desc->usePll != 0U) ? RCC_SYSCLKSOURCE_PLLCLK : RCC_SYSCLKSOURCE_HSI;
+	RCC_ClkInitStruct.AHBCLKDivider = desc->ahbDiv;
+	RCC_ClkInitStruct.APB1CLKDivider = desc->apb1Div;
+	RCC_ClkInitStruct.APB2CLKDivider = desc->apb2Div;
+	if (HAL_RCC_ClockConfig(&RCC_ClkInitStruct, desc->flashLatency) != HAL_OK) {
+		return HAL_ERROR;
+	}
+
+	Clock_EnableArt();
+	clock_active = profile;
+	return HAL_OK;
+}
+
+/**
+ * @brief Turns the HSE on without waiting for it.
+ */
+void Clock_StartHse(void) {
+	if (clock_profiles[CLOCK_DEFAULT_PROFILE].usePll != 0U) {
+		__HAL_RCC_HSE_CONFIG(RCC_HSE_ON);
+	}
+}
+
+/**
+ * @brief Switches profile at runtime and notifies the application.
+ */
+HAL_StatusTypeDef Clock_SetProfile(clock_profile_t profile) {
+	HAL_StatusTypeDef status;
+
+	if (profile == clock_active) {
+		return HAL_OK;
+	}
+	status = Clock_ApplyProfile(profile);
+	Clock_ProfileChangedCallback(clock_active);
+	return status;
+}
+
+/**
+ * @brief Returns the active profile.
+ */
+clock_profile_t Clock_GetProfile(void) {
+	return clock_active;
+}
+
+/**
+ * @brief Returns a short printable name for a profile.
+ */
+const char* Clock_GetProfileName(clock_profile_t profile) {
+	if (profile >= CLOCK_PROFILE_COUNT) {
+		return "?";
+	}
+	return clock_profiles[profile].name;
+}
+
+/**
+ * @brief Clock feeding the APB1 timers.
+ */
+uint32_t Clock_GetApb1TimerHz(void) {
+	uint32_t pclk = HAL_RCC_GetPCLK1Freq();
+
+	if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1) {
+		pclk *= 2U;
+	}
+	return pclk;
+}
+
+/**
+ * @brief Clock feeding the APB2 timers.
+ */
+uint32_t Clock_GetApb2TimerHz(void) {
+	uint32_t pclk = HAL_RCC_GetPCLK2Freq();
+
+	if ((RCC->CFGR & RCC_CFGR_PPRE2) != RCC_CFGR_PPRE2_DIV1) {
+		pclk *= 2U;
+	}
+	return pclk;
+}
+
+/**
+ * @brief Weak default profile-change hook.
+ */
+__weak void Clock_ProfileChangedCallback(clock_profile_t profile) {
+	(void) profile;
+}
@@ -0,0 +1,275 @@
+/**
+ ******************************************************************************
+ * @file           : config.c
+ * @brief          : Saved settings: a versioned, CRC-checked record in its
+ *                   own flash sectors, restored at boot.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "config.h"
+#include "boot_layout.h"
+#include "crc.h"
+#include "uart_baud.h"
+#include "dht11_async.h"
+#include "dht11_sink.h"
+#include "dht11_driver.h"
+#include "dht11_calib.h"
+#include <string.h>
+
+#if CONFIG_USE_STORE
+
+_Static_assert(sizeof(config_record_t) <= BOOT_CONFIG_SIZE,
+		"config_record_t must fit a copy");
+_Static_assert((CONFIG_SENSORS == DHT11_SAMPLER_SENSORS)
+		&& (CONFIG_SENSORS == DHT11_DRIVER_SENSORS)
+		&& (CONFIG_SENSORS == DHT11_CALIB_SENSORS),
+		"CONFIG_SENSORS must match the sensor modules");
+
+#define CONFIG_COPIES      (2U)
+#define CONFIG_WORDS       (sizeof(config_record_t) / 4U)
+#define CONFIG_CRC_WORDS   (CONFIG_WORDS - 1U)
+#define CONFIG_COPY(copy)  ((const config_record_t*) (BOOT_CONFIG_BASE \
+		+ ((copy) * BOOT_CONFIG_SIZE)))
+
+static config_record_t config_record;  /* The valid record, if any   */
+static uint8_t config_copy = 0U;       /* 0: none, 1 + copy index    */
+static uint32_t config_saves = 0U;
+static uint32_t config_errors = 0U;
+static uint32_t config_rejected = 0U;
+
+/**
+ * @brief Checks a record copied to RAM.
+ */
+static uint8_t Config_IsValid(const config_record_t *record) {
+	return ((record->magic == CONFIG_MAGIC)
+			&& (record->version == CONFIG_VERSION)
+			&& (record->length == sizeof(config_record_t))
+			&& (record->crc == Crc_Hw32((const uint32_t*) record,
+					CONFIG_CRC_WORDS))) ? 1U : 0U;
+}
+
+/**
+ * @brief Unlocks the flash and clears stale error flags.
+ */
+static void Config_BeginWrite(void) {
+	(void) HAL_FLASH_Unlock();
+	__HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FLASH_FLAG_OPERR
+			| FLASH_FLAG_WRPERR | FLASH_FLAG_PGAERR | FLASH_FLAG_PGPERR
+			| FLASH_FLAG_PGSERR);
+}
+
+/**
+ * @brief Locks the flash and drops data cache lines read before the write.
+ */
+static void Config_EndWrite(void) {
+	(void) HAL_FLASH_Lock();
+	if ((FLASH->ACR & FLASH_ACR_DCEN) != 0U) {
+		__HAL_FLASH_DATA_CACHE_DISABLE();
+		__HAL_FLASH_DATA_CACHE_RESET();
+		__HAL_FLASH_DATA_CACHE_ENABLE();
+	}
+}
+
+/**
+ * @brief Erases one copy. Flash must be unlocked.
+ */
+static HAL_StatusTypeDef Config_EraseCopy(uint32_t copy) {
+	FLASH_EraseInitTypeDef erase;
+	uint32_t sector_error;
+
+	erase.TypeErase = FLASH_TYPEERASE_SECTORS;
+	erase.Banks = FLASH_BANK_1;
+	erase.Sector = BOOT_CONFIG_SECTOR + copy;
+	erase.NbSectors = 1U;
+	erase.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+	return HAL_FLASHEx_Erase(&erase, &sector_error);
+}
+
+/**
+ * @brief Fills a record with the running settings.
+ */
+static void Config_Capture(config_settings_t *s) {
+	dht11_calib_t calib;
+	uint32_t i;
+	uint32_t q;
+
+	memset(s, 0, sizeof(*s));
+	s->baud = UART_Baud_Get();
+#if DHT11_USE_ASYNC
+	s->interval_ms = DHT11_Async_GetInterval();
+#else
+	s->interval_ms = DHT11_ASYNC_INTERVAL_MS;
+#endif /* DHT11_USE_ASYNC */
+	s->clock_profile = (uint8_t) Clock_GetProfile();
+	s->format = (uint8_t) DHT11_Sink_GetFormat();
+	for (i = 0U; i < CONFIG_SENSORS; i++) {
+		s->sensor_type[i] = (DHT11_Driver_Get((uint8_t) i) == &dht11_driver_dht22) ?
+				CONFIG_TYPE_DHT22 : CONFIG_TYPE_DHT11;
+		s->sample[i] = DHT11_Sampler_Get((uint8_t) i);
+		for (q = 0U; q < 2U; q++) {
+			calib = DHT11_Calib_Get((uint8_t) i, (dht11_calib_qty_t) q);
+			s->calib[i][q].gain = calib.gain;
+			s->calib[i][q].offset = calib.offset;
+		}
+	}
+}
+
+/**
+ * @brief Takes the newest valid copy into RAM.
+ */
+void Config_Load(void) {
+	config_record_t candidate;
+	uint32_t copy;
+
+	config_copy = 0U;
+	for (copy = 0U; copy < CONFIG_COPIES; copy++) {
+		memcpy(&candidate, CONFIG_COPY(copy), sizeof(candidate));
+		if (candidate.magic == 0xFFFFFFFFU) {
+			continue; /* Erased: never written */
+		}
+		if (Config_IsValid(&candidate) == 0U) {
+			config_rejected++;
+			continue;
+		}
+		/* Wrap-safe: the newer copy is one sequence ahead */
+		if ((config_copy == 0U) || ((int32_t) (candidate.sequence
+				- config_record.sequence) > 0)) {
+			config_record = candidate;
+			config_copy = (uint8_t) (copy + 1U);
+		}
+	}
+}
+
+/**
+ * @brief Clock profile for SystemClock_Config().
+ */
+clock_profile_t Config_BootProfile(void) {
+	if ((config_copy == 0U)
+			|| (config_record.settings.clock_profile >= CLOCK_PROFILE_COUNT)) {
+		return CLOCK_DEFAULT_PROFILE;
+	}
+	return (clock_profile_t) config_record.settings.clock_profile;
+}
+
+/**
+ * @brief Switches the console to the saved rate.
+ */
+void Config_ApplyBaud(void) {
+	if (config_copy != 0U) {
+		(void) UART_Baud_Restore(config_record.settings.baud);
+	}
+}
+
+/**
+ * @brief Applies the saved settings of the sensor modules.
+ */
+void Config_Apply(void) {
+	const config_settings_t *s = &config_record.settings;
+	uint32_t i;
+	uint32_t q;
+
+	if (config_copy == 0U) {
+		return;
+	}
+#if DHT11_USE_ASYNC
+	DHT11_Async_SetInterval(s->interval_ms);
+#endif /* DHT11_USE_ASYNC */
+	if (s->format <= (uint8_t) DHT11_FORMAT_SCHEMA) {
+		DHT11_Sink_SetFormat((dht11_format_t) s->format);
+	}
+	for (i = 0U; i < CONFIG_SENSORS; i++) {
+		/* The type first: it sets the shortest period the plan may use */
+		(void) DHT11_Driver_Set((uint8_t) i,
+				(s->sensor_type[i] == CONFIG_TYPE_DHT22) ?
+						&dht11_driver_dht22 : &dht11_driver_dht11);
+		(void) DHT11_Sampler_Set((uint8_t) i, s->sample[i].period_ms,
+				s->sample[i].phase_ms);
+		for (q = 0U; q < 2U; q++) {
+			(void) DHT11_Calib_Set((uint8_t) i, (dht11_calib_qty_t) q,
+					s->calib[i][q].gain, s->calib[i][q].offset);
+		}
+	}
+}
+
+/**
+ * @brief Captures the running settings and writes them to the older copy.
+ */
+HAL_StatusTypeDef Config_Save(void) {
+	config_record_t record;
+	const uint32_t *words = (const uint32_t*) &record;
+	uint32_t copy;
+	uint32_t addr;
+	HAL_StatusTypeDef status;
+	uint32_t i;
+
+	if (UART_Baud_IsPending() != 0U) {
+		return HAL_BUSY; /* Only a confirmed rate is worth booting at */
+	}
+	memset(&record, 0, sizeof(record));
+	record.magic = CONFIG_MAGIC;
+	record.version = CONFIG_VERSION;
+	record.length = (uint16_t) sizeof(config_record_t);
+	record.sequence = (config_copy != 0U) ? (config_record.sequence + 1U) : 1U;
+	Config_Capture(&record.settings);
+	record.crc = Crc_Hw32(words, CONFIG_CRC_WORDS);
+
+	/* Never the copy holding the newest record */
+	copy = (config_copy == 1U) ? 1U : 0U;
+	addr = (uint32_t) CONFIG_COPY(copy);
+	Config_BeginWrite();
+	status = Config_EraseCopy(copy);
+	for (i = 0U; (i < CONFIG_WORDS) && (status == HAL_OK); i++) {
+		status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, addr + (i * 4U),
+				words[i]);
+	}
+	Config_EndWrite();
+	if ((status != HAL_OK)
+			|| (memcmp(CONFIG_COPY(copy), &record, sizeof(record)) != 0)) {
+		config_errors++;
+		return HAL_ERROR;
+	}
+
+	config_record = record;
+	config_copy = (uint8_t) (copy + 1U);
+	config_saves++;
+	return HAL_OK;
+}
+
+/**
+ * @brief Erases both copies.
+ */
+HAL_StatusTypeDef Config_Erase(void) {
+	HAL_StatusTypeDef status = HAL_OK;
+	uint32_t copy;
+
+	Config_BeginWrite();
+	for (copy = 0U; copy < CONFIG_COPIES; copy++) {
+		if (Config_EraseCopy(copy) != HAL_OK) {
+			status = HAL_ERROR;
+		}
+	}
+	Config_EndWrite();
+	if (status != HAL_OK) {
+		config_errors++;
+	}
+	/* The running settings stay; the sequence restarts with the next save */
+	config_copy = 0U;
+	return status;
+}
+
+/**
+ * @brief Copies where the running settings came from and the counters.
+ */
+void Config_GetInfo(config_info_t *info) {
+	info->copy = config_copy;
+	info->sequence = (config_copy != 0U) ? config_record.sequence : 0U;
+	info->saves = config_saves;
+	info->errors = config_errors;
+	info->rejected = config_rejected;
+}
+
+#endif /* CONFIG_USE_STORE */
@@ -0,0 +1,224 @@
+/**
+ ******************************************************************************
+ * @file           : crash.c
+ * @brief          : Fault capture, fast reset and crash report on next boot.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "crash.h"
+#include "crc.h"
+#include "uart_tx.h"
+#include "memmap.h"
+#include <stdio.h>
+#include <stddef.h>
+
+#define CRASH_MAGIC      (0x43525348U) /* "CRSH" */
+
+/** Lowest plausible stack pointer: start of SRAM1 (memmap.h) */
+#define CRASH_RAM_START  (0x20000000U)
+
+/** EXC_RETURN bit 4 clear: the frame includes the FPU state */
+#define CRASH_EXC_NO_FPU (0x10U)
+
+extern uint32_t _estack;
+
+/* Fault-path stack, referenced by CRASH_FAULT_ENTRY() */
+uint32_t crash_fault_stack[CRASH_FAULT_STACK_WORDS] __attribute__((aligned(8)));
+
+static crash_record_t crash NOINIT;
+
+static const char *crash_reset_cause = "unknown";
+
+/**
+ * @brief CRC of the record, crc field excluded.
+ */
+static uint32_t Crash_Crc(const crash_record_t *rec) {
+	return Crc_Ccitt16((const uint8_t*) rec, offsetof(crash_record_t, crc));
+}
+
+/**
+ * @brief Checks that .noinit holds a record from this build's layout.
+ */
+static uint8_t Crash_IsValid(void) {
+	return ((crash.magic == CRASH_MAGIC)
+			&& (crash.stack_words <= CRASH_STACK_WORDS)
+			&& (crash.crc == Crash_Crc(&crash))) ? 1U : 0U;
+}
+
+/**
+ * @brief Starts a record, keeping the crash count of a valid one.
+ */
+static void Crash_Begin(uint32_t reason) {
+	uint32_t count = (Crash_IsValid() != 0U) ? crash.count : 0U;
+	uint8_t *p = (uint8_t*) &crash;
+	uint32_t i;
+
+	/* No memset: the C library may be what faulted */
+	for (i = 0U; i < sizeof(crash); i++) {
+		p[i] = 0U;
+	}
+	crash.magic = CRASH_MAGIC;
+	crash.count = count + 1U;
+	crash.reason = reason;
+	crash.tick_ms = HAL_GetTick();
+	crash.cfsr = SCB->CFSR;
+	crash.hfsr = SCB->HFSR;
+	crash.mmfar = SCB->MMFAR;
+	crash.bfar = SCB->BFAR;
+}
+
+/**
+ * @brief Seals the record and resets; stops first under a debugger.
+ */
+static void Crash_Reset(void) __attribute__((noreturn));
+static void Crash_Reset(void) {
+	crash.crc = Crash_Crc(&crash);
+	__DSB();
+	if ((CoreDebug->DHCSR & CoreDebug_DHCSR_C_DEBUGEN_Msk) != 0U) {
+		__BKPT(0);
+	}
+	NVIC_SystemReset();
+}
+
+/**
+ * @brief Saves the exception frame and the stack above it, then resets.
+ */
+void Crash_Fault(uint32_t *frame, uint32_t exc_return, uint32_t reason) {
+	uint32_t top = (uint32_t) &_estack;
+	uint32_t addr = (uint32_t) frame;
+	uint32_t frame_words;
+	uint32_t i;
+
+	__disable_irq();
+	Crash_Begin(reason);
+	crash.exc_return = exc_return;
+
+	/* A stack overflow leaves a frame outside RAM: keep the fault status
+	 * registers only */
+	if (((addr & 3U) == 0U) && (addr >= CRASH_RAM_START)
+			&& (addr <= (top - (8U * 4U)))) {
+		for (i = 0U; i < 4U; i++) {
+			crash.r[i] = frame[i];
+		}
+		crash.r12 = frame[4];
+		crash.lr = frame[5];
+		crash.pc = frame[6];
+		crash.xpsr = frame[7];
+
+		frame_words = ((exc_return & CRASH_EXC_NO_FPU) == 0U) ? 26U : 8U;
+		if ((crash.xpsr & (1UL << 9)) != 0U) {
+			frame_words++; /* Stack was realigned to 8 bytes */
+		}
+		crash.sp = addr + (frame_words * 4U);
+		for (i = 0U; (i < CRASH_STACK_WORDS)
+				&& ((crash.sp + (i * 4U)) < top); i++) {
+			crash.stack[i] = ((const uint32_t*) crash.sp)[i];
+		}
+		crash.stack_words = i;
+	}
+	Crash_Reset();
+}
+
+/**
+ * @brief Records an Error_Handler() call and resets.
+ */
+void Crash_Error(uint32_t caller) {
+	__disable_irq();
+	Crash_Begin(CRASH_REASON_ERROR);
+	crash.pc = caller;
+	crash.sp = __get_MSP();
+	Crash_Reset();
+}
+
+/**
+ * @brief Short name of a crash reason.
+ */
+static const char* Crash_ReasonName(uint32_t reason) {
+	static const char *const names[] = { "?", "hardfault", "memmanage",
+			"busfault", "usagefault", "error" };
+
+	if (reason >= (sizeof(names) / sizeof(names[0]))) {
+		return "?";
+	}
+	return names[reason];
+}
+
+/**
+ * @brief Prints the saved crash, if any.
+ */
+uint8_t Crash_Print(void) {
+	uint32_t i;
+
+	if (Crash_IsValid() == 0U) {
+		return 0U;
+	}
+	printf("CRASH %s count %lu tick %lu ms\r\n", Crash_ReasonName(crash.reason),
+			crash.count, crash.tick_ms);
+	printf("CRASH pc %08lx lr %08lx sp %08lx xpsr %08lx exc %08lx\r\n",
+			crash.pc, crash.lr, crash.sp, crash.xpsr, crash.exc_return);
+	printf("CRASH r0 %08lx r1 %08lx r2 %08lx r3 %08lx r12 %08lx\r\n",
+			crash.r[0], crash.r[1], crash.r[2], crash.r[3], crash.r12);
+	printf("CRASH cfsr %08lx hfsr %08lx mmfar %08lx bfar %08lx\r\n",
+			crash.cfsr, crash.hfsr, crash.mmfar, crash.bfar);
+	for (i = 0U; i < crash.stack_words; i += 4U) {
+		printf("CRASH stack+%02lx %08lx %08lx %08lx %08lx\r\n", i * 4U,
+				crash.stack[i], crash.stack[i + 1U], crash.stack[i + 2U],
+				crash.stack[i + 3U]);
+	}
+	return 1U;
+}
+
+/**
+ * @brief Reports a saved crash and the reset cause, once.
+ */
+void Crash_Init(void) {
+	uint32_t csr = RCC->CSR;
+
+	if ((csr & RCC_CSR_BORRSTF) != 0U) {
+		/* POR sets BORRSTF too, and .noinit holds garbage after either */
+		crash_reset_cause = ((csr & RCC_CSR_PORRSTF) != 0U) ? "power-on"
+				: "brown-out";
+		crash.magic = 0U;
+	} else if ((csr & RCC_CSR_IWDGRSTF) != 0U) {
+		crash_reset_cause = "watchdog";
+	} else if ((csr & RCC_CSR_WWDGRSTF) != 0U) {
+		crash_reset_cause = "window watchdog";
+	} else if ((csr & RCC_CSR_LPWRRSTF) != 0U) {
+		crash_reset_cause = "low-power";
+	} else if ((csr & RCC_CSR_SFTRSTF) != 0U) {
+		crash_reset_cause = "software";
+	} else if ((csr & RCC_CSR_PINRSTF) != 0U) {
+		crash_reset_cause = "pin";
+	}
+	RCC->CSR |= RCC_CSR_RMVF;
+
+	/* Report MemManage, BusFault and UsageFault as such, not as HardFault */
+	SCB->SHCSR |= SCB_SHCSR_MEMFAULTENA_Msk | SCB_SHCSR_BUSFAULTENA_Msk
+			| SCB_SHCSR_USGFAULTENA_Msk;
+
+	printf("Reset: %s\r\n", crash_reset_cause);
+	if ((Crash_IsValid() != 0U) && (crash.reported == 0U)) {
+		(void) Crash_Print();
+		crash.reported = 1U;
+		crash.crc = Crash_Crc(&crash);
+		(void) UART_TX_Flush(100U); /* Out before anything else can fail */
+	}
+}
+
+/**
+ * @brief Crashes since the last power-on.
+ */
+uint32_t Crash_GetCount(void) {
+	return (Crash_IsValid() != 0U) ? crash.count : 0U;
+}
+
+/**
+ * @brief Printable reset cause of this boot.
+ */
+const char* Crash_GetResetCause(void) {
+	return crash_reset_cause;
+}
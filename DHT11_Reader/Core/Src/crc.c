@@ -0,0 +1,188 @@
+/**
+ ******************************************************************************
+ * @file           : crc.c
+ * @brief          : CRC service: the STM32 CRC unit for CRC-32 over words,
+ *                   table-driven software for the CRC-16 framings.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "crc.h"
+
+#define CRC_DMA             (DMA2_Stream0)
+#define CRC_DMA_FLAGS       (DMA_LIFCR_CTCIF0 | DMA_LIFCR_CHTIF0 \
+		| DMA_LIFCR_CTEIF0 | DMA_LIFCR_CDMEIF0 | DMA_LIFCR_CFEIF0)
+
+/**
+ * @brief Progress of the DMA-fed block.
+ */
+typedef enum {
+	CRC_DMA_IDLE = 0,
+	CRC_DMA_RUNNING,
+	CRC_DMA_DONE,       /*!< Result latched, not collected yet */
+	CRC_DMA_FAILED
+} crc_dma_state_t;
+
+/* Nibble table for CRC-16/CCITT-FALSE: 32 bytes instead of 512 */
+static const uint16_t crc16_nibble[16] = { 0x0000U, 0x1021U, 0x2042U, 0x3063U,
+		0x4084U, 0x50A5U, 0x60C6U, 0x70E7U, 0x8108U, 0x9129U, 0xA14AU, 0xB16BU,
+		0xC18CU, 0xD1ADU, 0xE1CEU, 0xF1EFU };
+
+static const uint16_t crc_modbus_table[256] = {
+	0x0000U, 0xC0C1U, 0xC181U, 0x0140U, 0xC301U, 0x03C0U, 0x0280U, 0xC241U,
+	0xC601U, 0x06C0U, 0x0780U, 0xC741U, 0x0500U, 0xC5C1U, 0xC481U, 0x0440U,
+	0xCC01U, 0x0CC0U, 0x0D80U, 0xCD41U, 0x0F00U, 0xCFC1U, 0xCE81U, 0x0E40U,
+	0x0A00U, 0xCAC1U, 0xCB81U, 0x0B40U, 0xC901U, 0x09C0U, 0x0880U, 0xC841U,
+	0xD801U, 0x18C0U, 0x1980U, 0xD941U, 0x1B00U, 0xDBC1U, 0xDA81U, 0x1A40U,
+	0x1E00U, 0xDEC1U, 0xDF81U, 0x1F40U, 0xDD01U, 0x1DC0U, 0x1C80U, 0xDC41U,
+	0x1400U, 0xD4C1U, 0xD581U, 0x1540U, 0xD701U, 0x17C0U, 0x1680U, 0xD641U,
+	0xD201U, 0x12C0U, 0x1380U, 0xD341U, 0x1100U, 0xD1C1U, 0xD081U, 0x1040U,
+	0xF001U, 0x30C0U, 0x3180U, 0xF141U, 0x3300U, 0xF3C1U, 0xF281U, 0x3240U,
+	0x3600U, 0xF6C1U, 0xF781U, 0x3740U, 0xF501U, 0x35C0U, 0x3480U, 0xF441U,
+	0x3C00U, 0xFCC1U, 0xFD81U, 0x3D40U, 0xFF01U, 0x3FC0U, 0x3E80U, 0xFE41U,
+	0xFA01U, 0x3AC0U, 0x3B80U, 0xFB41U, 0x3900U, 0xF9C1U, 0xF881U, 0x3840U,
+	0x2800U, 0xE8C1U, 0xE981U, 0x2940U, 0xEB01U, 0x2BC0U, 0x2A80U, 0xEA41U,
+	0xEE01U, 0x2EC0U, 0x2F80U, 0xEF41U, 0x2D00U, 0xEDC1U, 0xEC81U, 0x2C40U,
+	0xE401U, 0x24C0U, 0x2580U, 0xE541U, 0x2700U, 0xE7C1U, 0xE681U, 0x2640U,
+	0x2200U, 0xE2C1U, 0xE381U, 0x2340U, 0xE101U, 0x21C0U, 0x2080U, 0xE041U,
+	0xA001U, 0x60C0U, 0x6180U, 0xA141U, 0x6300U, 0xA3C1U, 0xA281U, 0x6240U,
+	0x6600U, 0xA6C1U, 0xA781U, 0x6740U, 0xA501U, 0x65C0U, 0x6480U, 0xA441U,
+	0x6C00U, 0xACC1U, 0xAD81U, 0x6D40U, 0xAF01U, 0x6FC0U, 0x6E80U, 0xAE41U,
+	0xAA01U, 0x6AC0U, 0x6B80U, 0xAB41U, 0x6900U, 0xA9C1U, 0xA881U, 0x6840U,
+	0x7800U, 0xB8C1U, 0xB981U, 0x7940U, 0xBB01U, 0x7BC0U, 0x7A80U, 0xBA41U,
+	0xBE01U, 0x7EC0U, 0x7F80U, 0xBF41U, 0x7D00U, 0xBDC1U, 0xBC81U, 0x7C40U,
+	0xB401U, 0x74C0U, 0x7580U, 0xB541U, 0x7700U, 0xB7C1U, 0xB681U, 0x7640U,
+	0x7200U, 0xB2C1U, 0xB381U, 0x7340U, 0xB101U, 0x71C0U, 0x7080U, 0xB041U,
+	0x5000U, 0x90C1U, 0x9181U, 0x5140U, 0x9301U, 0x53C0U, 0x5280U, 0x9241U,
+	0x9601U, 0x56C0U, 0x5780U, 0x9741U, 0x5500U, 0x95C1U, 0x9481U, 0x5440U,
+	0x9C01U, 0x5CC0U, 0x5D80U, 0x9D41U, 0x5F00U, 0x9FC1U, 0x9E81U, 0x5E40U,
+	0x5A00U, 0x9AC1U, 0x9B81U, 0x5B40U, 0x9901U, 0x59C0U, 0x5880U, 0x9841U,
+	0x8801U, 0x48C0U, 0x4980U, 0x8941U, 0x4B00U, 0x8BC1U, 0x8A81U, 0x4A40U,
+	0x4E00U, 0x8EC1U, 0x8F81U, 0x4F40U, 0x8D01U, 0x4DC0U, 0x4C80U, 0x8C41U,
+	0x4400U, 0x84C1U, 0x8581U, 0x4540U, 0x8701U, 0x47C0U, 0x4680U, 0x8641U,
+	0x8201U, 0x42C0U, 0x4380U, 0x8341U, 0x4100U, 0x81C1U, 0x8081U, 0x4040U
+};
+
+static crc_dma_state_t crc_dma_state = CRC_DMA_IDLE;
+static uint32_t crc_dma_result = 0U;
+
+/**
+ * @brief Latches the DMA block's result once the transfer has ended.
+ */
+static void Crc_DmaCheck(void) {
+	if (crc_dma_state != CRC_DMA_RUNNING) {
+		return;
+	}
+	if ((DMA2->LISR & DMA_LISR_TEIF0) != 0U) {
+		CRC_DMA->CR &= ~DMA_SxCR_EN;
+		crc_dma_state = CRC_DMA_FAILED;
+	} else if ((DMA2->LISR & DMA_LISR_TCIF0) != 0U) {
+		crc_dma_result = CRC->DR;
+		crc_dma_state = CRC_DMA_DONE;
+	}
+}
+
+/**
+ * @brief Clocks the CRC unit and DMA2.
+ */
+void Crc_Init(void) {
+	__HAL_RCC_CRC_CLK_ENABLE();
+	__HAL_RCC_DMA2_CLK_ENABLE();
+}
+
+/**
+ * @brief CRC-32/MPEG-2 of a word array, fed by the CPU.
+ */
+uint32_t Crc_Hw32(const uint32_t *words, uint32_t n) {
+	uint32_t i;
+
+	/* The unit has one accumulator: let a DMA block finish first */
+	while (crc_dma_state == CRC_DMA_RUNNING) {
+		Crc_DmaCheck();
+	}
+	CRC->CR = CRC_CR_RESET;
+	for (i = 0U; i < n; i++) {
+		CRC->DR = words[i];
+	}
+	return CRC->DR;
+}
+
+/**
+ * @brief Starts a CRC-32/MPEG-2 of a word array, fed by DMA.
+ */
+HAL_StatusTypeDef Crc_Hw32Start(const uint32_t *words, uint32_t n) {
+	if (n > CRC_DMA_MAX_WORDS) {
+		return HAL_ERROR;
+	}
+	if (crc_dma_state != CRC_DMA_IDLE) {
+		return HAL_BUSY;
+	}
+	CRC->CR = CRC_CR_RESET;
+	if (n == 0U) {
+		crc_dma_result = CRC->DR;
+		crc_dma_state = CRC_DMA_DONE;
+		return HAL_OK;
+	}
+
+	/* Memory-to-memory: the peripheral port reads the words, the memory
+	 * port writes the data register. Needs the FIFO (no direct mode). */
+	DMA2->LIFCR = CRC_DMA_FLAGS;
+	CRC_DMA->PAR = (uint32_t) words;
+	CRC_DMA->M0AR = (uint32_t) &CRC->DR;
+	CRC_DMA->NDTR = n;
+	CRC_DMA->FCR = DMA_SxFCR_DMDIS | DMA_SxFCR_FTH;
+	CRC_DMA->CR = DMA_SxCR_DIR_1 | DMA_SxCR_PINC | DMA_SxCR_PSIZE_1
+			| DMA_SxCR_MSIZE_1;
+	crc_dma_state = CRC_DMA_RUNNING;
+	CRC_DMA->CR |= DMA_SxCR_EN;
+	return HAL_OK;
+}
+
+/**
+ * @brief Collects the result of Crc_Hw32Start().
+ */
+HAL_StatusTypeDef Crc_Hw32Poll(uint32_t *crc) {
+	Crc_DmaCheck();
+	switch (crc_dma_state) {
+	case CRC_DMA_RUNNING:
+		return HAL_BUSY;
+	case CRC_DMA_DONE:
+		*crc = crc_dma_result;
+		crc_dma_state = CRC_DMA_IDLE;
+		return HAL_OK;
+	default:
+		crc_dma_state = CRC_DMA_IDLE;
+		return HAL_ERROR;
+	}
+}
+
+/**
+ * @brief CRC-16/CCITT-FALSE.
+ */
+uint16_t Crc_Ccitt16(const uint8_t *data, uint32_t len) {
+	uint16_t crc = 0xFFFFU;
+	uint32_t i;
+
+	for (i = 0U; i < len; i++) {
+		crc = (uint16_t) ((crc << 4) ^ crc16_nibble[(crc >> 12) ^ (data[i] >> 4)]);
+		crc = (uint16_t) ((crc << 4)
+				^ crc16_nibble[(crc >> 12) ^ (data[i] & 0x0FU)]);
+	}
+	return crc;
+}
+
+/**
+ * @brief Table-driven Modbus CRC-16, one lookup per byte.
+ */
+uint16_t Crc_Modbus16(const uint8_t *data, uint32_t len) {
+	uint16_t crc = 0xFFFFU;
+	uint32_t i;
+
+	for (i = 0U; i < len; i++) {
+		crc = (uint16_t) ((crc >> 8) ^ crc_modbus_table[(crc ^ data[i]) & 0xFFU]);
+	}
+	return crc;
+}
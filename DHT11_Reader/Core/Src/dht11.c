@@ -18,19 +18,31 @@
 #include "dht11.h"
 #include <stdio.h>  /* Required for printf */
 #include "my_debug.h"
+#include "dht11_capture.h"
+#include "dht11_exti.h"
+#include "dht11_oversample.h"
+#include "timebase.h"
+#include "dht11_pin.h"
+#include "dht11_sink.h"
+#include "power.h"
+#include "dht11_prof.h"
+#include "dht11_classify.h"
+#include "dht11_health.h"
+#include "dht11_drift.h"
+#include "dht11_driver.h"
+#include "dht11_sampler.h"
+#include "irq_prio.h"
+#include "ramfunc.h"
+
+/* Response LOW + HIGH of the last bit-banged transaction (dht11_drift.h) */
+static uint32_t dht11_response_us = 0U;
+
 /**
  * @brief Initializes the DWT (Data Watchpoint and Trace) cycle counter.
  *        Used for precise microsecond delay generation.
  */
 void DWT_Init(void) {
-	/* Enable trace */
-	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
-
-	/* Reset cycle counter */
-	DWT->CYCCNT = 0U;
-
-	/* Enable cycle counter */
-	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	Timebase_EnableCycleCounter();
 
 	/* DEBUG_PRINT("DWT Initialized for microsecond delay\n"); */
 }
@@ -38,39 +50,31 @@ void DWT_Init(void) {
 /**
  * @brief Delays the code execution for given microseconds.
  * @param us: Delay in microseconds
- * @note Requires DWT_Init() to be called once during setup.
+ * @note Uses the cycles-per-us factor cached by Timebase_Init().
  */
-void delay_us(uint32_t us) {
-	uint32_t startTick = DWT->CYCCNT;
-	uint32_t delayTicks = us * (SystemCoreClock / 1000000); /* Convert us to CPU cycles */
-	while ((DWT->CYCCNT - startTick) < delayTicks)
-		;
+RAMFUNC void delay_us(uint32_t us) {
+	Timebase_DelayUs(us);
 }
 
 /**
  * @brief Configures the DHT11 data pin as an open-drain output.
  *        This is required when initiating communication by pulling the line low.
+ * @note  The pin is configured once by DHT11_Pin_Init(); this only makes
+ *        sure the GPIO (not TIM5) owns the pad.
  */
 void DHT11_SetPinOutput(void) {
-	GPIO_InitTypeDef GPIO_InitStruct = { 0 };
-	GPIO_InitStruct.Pin = DHT_PIN_Pin;
-	GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_OD; /* Open-drain output */
-	GPIO_InitStruct.Pull = GPIO_NOPULL;
-	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
-	HAL_GPIO_Init(DHT_PIN_GPIO_Port, &GPIO_InitStruct);
+	DHT11_Pin_ModeGpio();
 	/*DEBUG_PRINT("DHT11 Pin set to OUTPUT mode\n");*/
 }
 
 /**
  * @brief Configures the DHT11 data pin as input.
  *        This allows the microcontroller to read data sent by the sensor.
+ * @note  An open-drain output left high is an input: releasing the line is
+ *        a single BSRR write.
  */
 void DHT11_SetPinInput(void) {
-	GPIO_InitTypeDef GPIO_InitStruct = { 0 };
-	GPIO_InitStruct.Pin = DHT_PIN_Pin;
-	GPIO_InitStruct.Mode = GPIO_MODE_INPUT;
-	GPIO_InitStruct.Pull = GPIO_NOPULL;
-	HAL_GPIO_Init(DHT_PIN_GPIO_Port, &GPIO_InitStruct);
+	DHT11_Pin_Release();
 	/*DEBUG_PRINT("DHT11 Pin set to INPUT mode\n");*/
 }
 
@@ -86,16 +90,16 @@ void DHT11_Start(void) {
 	DHT11_SetPinOutput();
 
 	/* Pull LOW */
-	HAL_GPIO_WritePin(DHT_PIN_GPIO_Port, DHT_PIN_Pin, GPIO_PIN_RESET);
+	DHT11_Pin_Low();
 
-	/* Delay ≥18 ms (Previously 18 ms; increased to 20 ms for reliability) */
-	HAL_Delay(18U);
+	/* Delay ≥18 ms for a DHT11, the sensor type's pulse otherwise */
+	HAL_Delay(DHT11_Driver_StartMs(0U));
 
 	/* Pull HIGH */
-	HAL_GPIO_WritePin(DHT_PIN_GPIO_Port, DHT_PIN_Pin, GPIO_PIN_SET);
+	DHT11_Pin_Release();
 
 	/* Wait for 20–40 us (Previously 30 us; increased to 40 us) */
-	delay_us(30U);
+	Timebase_DelayUsShort(30U);
 
 	/* Set as input to read response */
 	DHT11_SetPinInput();
@@ -108,89 +112,244 @@ void DHT11_Start(void) {
 }
 
 /**
- * @brief Checks the DHT11 sensor’s response after the start signal.
- * @retval 1 if sensor responds correctly, 0 otherwise.
- * @note DHT11 responds with LOW for 80us, then HIGH for 80us.
+ * @brief Waits while the data line stays at the given level.
+ * @param high: Non-zero to wait while HIGH, zero to wait while LOW.
+ * @param timeout_us: Deadline for the level to change.
+ * @retval 1 if the level changed in time, 0 on timeout.
  */
+RAMFUNC static uint8_t DHT11_WaitWhile(uint32_t high, uint32_t timeout_us) {
+	timebase_deadline_t deadline;
 
-uint8_t DHT11_CheckResponse(void) {
-	/*DEBUG_PRINT("Pin state before response wait: %d\r\n", HAL_GPIO_ReadPin(DHT_PIN_GPIO_Port, DHT_PIN_Pin)); */
-
-	uint8_t response = 0;
-	uint32_t timeout = 100; /*100 us max wait */
-
-	/*Wait for LOW signal from sensor*/
-	while (HAL_GPIO_ReadPin(DHT_PIN_GPIO_Port, DHT_PIN_Pin) && timeout--)
-		delay_us(1);
-
-	/*	 After start signal, DHT11 pulls LOW within 20-40us */
-
-	/*delay_us(40); */
-
-	if (!(HAL_GPIO_ReadPin(DHT_PIN_GPIO_Port, DHT_PIN_Pin))) /*Expect LOW */
-	{
-		DEBUG_INFO("DHT11 pulled line LOW (expected)\r\n");
-		delay_us(80);
-		if (HAL_GPIO_ReadPin(DHT_PIN_GPIO_Port, DHT_PIN_Pin)) /* Then HIGH */
-		{
-			response = 1;
+	Timebase_DeadlineStart(&deadline, timeout_us);
+	while ((DHT11_Pin_Read() != 0U) == (high != 0U)) {
+		if (Timebase_DeadlineExpired(&deadline) != 0U) {
+			return 0U;
 		}
 	}
-	/* Wait for HIGH to end (DHT11 keeps HIGH for ~80us) */
+	return 1U;
+}
 
-	/*while (HAL_GPIO_ReadPin(DHT_PIN_GPIO_Port, DHT_PIN_Pin));*/
+/**
+ * @brief Checks the DHT11 sensor’s response after the start signal.
+ * @retval DHT11_OK if the LOW and HIGH response phases were seen.
+ * @note DHT11 responds with LOW for 80us, then HIGH for 80us; the two are
+ *       timed together for the drift statistics.
+ */
+RAMFUNC dht11_status_t DHT11_CheckResponse(void) {
+	timebase_deadline_t response;
+	dht11_status_t status = DHT11_OK;
 
-	timeout = 100;
-	while (HAL_GPIO_ReadPin(DHT_PIN_GPIO_Port, DHT_PIN_Pin) && timeout--)
-		delay_us(1);
+	/* After start signal, DHT11 pulls LOW within 20-40us */
+	if (DHT11_WaitWhile(1U, DHT11_RESPONSE_WAIT_US) == 0U) {
+		status = DHT11_ERR_NO_RESPONSE;
+	} else {
+		Timebase_DeadlineStart(&response, 0U);
+		if (DHT11_WaitWhile(0U, DHT11_RESPONSE_WAIT_US) == 0U) {
+			/* LOW phase, ~80 us */
+			status = DHT11_ERR_STUCK_LOW;
+		} else if (DHT11_WaitWhile(1U, DHT11_RESPONSE_WAIT_US) == 0U) {
+			/* HIGH phase, ~80 us, ends with the first bit preamble */
+			status = DHT11_ERR_STUCK_HIGH;
+		}
+		dht11_response_us = Timebase_DeadlineElapsedUs(&response);
+	}
 
 	/* Debug print moved AFTER timing critical operations */
-	if (response) {
+	if (status == DHT11_OK) {
 		DEBUG_INFO("DHT11 Response OK (Initial LOW + HIGH confirmed)\n");
 	} else {
-		DEBUG_ERROR("DHT11 Response Failed (Initial LOW or HIGH missing)\n");
+		DEBUG_ERROR("DHT11 Response Failed (%s)\n", DHT11_StatusName(status));
 	}
-	return response;
+	return status;
 }
 
 /**
  * @brief Reads one byte (8 bits) from the DHT11 sensor.
  *        Each bit is transmitted based on pulse width timing.
- * @retval The byte read (can be humidity, temperature, or checksum).
- * @note 0 is ~26-28us HIGH, 1 is ~70us HIGH after initial LOW.
+ * @param byte: Receives the byte read (humidity, temperature, or checksum).
+ * @retval DHT11_OK, or DHT11_ERR_BIT_TIMEOUT if a bit phase overran.
+ * @note 0 is ~26-28us HIGH, 1 is ~70us HIGH after initial LOW. The HIGH
+ *       time is measured on CYCCNT; a bit is '1' if it lasts longer than
+ *       DHT11_BIT_SAMPLE_US, the same decision as sampling at that instant.
  */
-uint8_t DHT11_ReadByte(void) {
+RAMFUNC dht11_status_t DHT11_ReadByte(uint8_t *byte) {
+	timebase_deadline_t high;
+	uint32_t width_us;
 	uint8_t i;
-	uint8_t byte = 0U;
+	uint8_t value = 0U;
 
 	for (i = 0U; i < 8U; i++) {
-		/* Wait for HIGH */
-		while (HAL_GPIO_ReadPin(DHT_PIN_GPIO_Port, DHT_PIN_Pin)
-				== GPIO_PIN_RESET) {
-			/* Wait */
+		/* Wait for HIGH (end of the 50 us preamble) */
+		if (DHT11_WaitWhile(0U, DHT11_BIT_LOW_WAIT_US) == 0U) {
+			return DHT11_ERR_BIT_TIMEOUT;
 		}
+		Timebase_DeadlineStart(&high, 0U);
 
-		/* Wait for pulse duration */
-		delay_us(40U);
+		/* Wait for pin to go LOW */
+		if (DHT11_WaitWhile(1U, DHT11_BIT_SAMPLE_US + DHT11_BIT_HIGH_WAIT_US)
+				== 0U) {
+			return DHT11_ERR_BIT_TIMEOUT;
+		}
+		width_us = Timebase_DeadlineElapsedUs(&high);
 
-		/* If still HIGH after 40us, it is a ‘1’ */
-		if (HAL_GPIO_ReadPin(DHT_PIN_GPIO_Port, DHT_PIN_Pin) == GPIO_PIN_SET) {
-			/* Set bit */
-			byte |= (uint8_t) (1U << (7U - i));
+		/* If HIGH for more than 40us, it is a ‘1’ */
+		value = (uint8_t) (value << 1);
+		if (width_us > DHT11_BIT_SAMPLE_US) {
+			value |= 1U;
+		}
+	}
+
+	DEBUG_PRINT("Read Byte: 0x%02X\n", value);
+
+	*byte = value;
+	return DHT11_OK;
+}
+
+/**
+ * @brief Measures the HIGH time of all 40 data bits.
+ */
+RAMFUNC dht11_status_t DHT11_ReadPulseWidths(uint16_t widths[40]) {
+	timebase_deadline_t high;
+	dht11_status_t status = DHT11_OK;
+	uint32_t basepri;
+	uint32_t i;
+
+	for (i = 0U; i < 40U; i++) {
+		/* Both edges of the HIGH time are timed with less urgent interrupts
+		 * held off; they run in the ~50 us LOW preamble of the next bit */
+		basepri = Irq_MaskFrom(IRQ_PRIO_TIMEBASE);
+		if (DHT11_WaitWhile(0U, DHT11_BIT_LOW_WAIT_US) == 0U) {
+			status = DHT11_ERR_BIT_TIMEOUT;
 		} else {
-			/* Clear bit */
-			byte &= (uint8_t) (~(1U << (7U - i)));
+			Timebase_DeadlineStart(&high, 0U);
+			if (DHT11_WaitWhile(1U,
+					DHT11_BIT_SAMPLE_US + DHT11_BIT_HIGH_WAIT_US) == 0U) {
+				status = DHT11_ERR_BIT_TIMEOUT;
+			}
+			widths[i] = (uint16_t) Timebase_DeadlineElapsedUs(&high);
 		}
+		Irq_Unmask(basepri);
+		if (status != DHT11_OK) {
+			return status;
+		}
+	}
+	return DHT11_OK;
+}
 
-		/* Wait for pin to go LOW */
-		while (HAL_GPIO_ReadPin(DHT_PIN_GPIO_Port, DHT_PIN_Pin) == GPIO_PIN_SET) {
-			/* Wait */
+/**
+ * @brief Short printable name of a status code.
+ */
+const char* DHT11_StatusName(dht11_status_t status) {
+	static const char *const names[] = { "ok", "busy", "no response",
+			"timeout", "frame", "checksum", "stuck low", "stuck high",
+			"bit timeout" };
+
+	if ((uint32_t) status >= (sizeof(names) / sizeof(names[0]))) {
+		return "?";
+	}
+	return names[status];
+}
+
+/**
+ * @brief Reads one 5-byte frame using the configured acquisition path.
+ * @param data: Output buffer for the 5 frame bytes.
+ * @retval Transaction status.
+ */
+static dht11_status_t DHT11_ReadFrame(uint8_t data[5]) {
+#if DHT11_USE_EXTI
+	return DHT11_Exti_Read(data);
+#elif DHT11_USE_OVERSAMPLE
+	return DHT11_Oversample_Read(data);
+#elif DHT11_USE_CAPTURE
+	return DHT11_Capture_Read(data);
+#else
+	dht11_classifier_t *cls = DHT11_Classify_Get(0U);
+	uint16_t widths[40];
+	dht11_status_t status;
+
+	DHT11_PROF_BEGIN();
+	DHT11_Start(); /*  Send start signal to DHT11 */
+	DHT11_PROF_MARK(DHT11_PROF_START);
+	status = DHT11_CheckResponse();
+	if (status != DHT11_OK) {
+		return status;
+	}
+	DHT11_PROF_MARK(DHT11_PROF_RESPONSE);
+
+	/** Read 5 bytes from DHT11: humidity integer, humidity decimal,
+	 * temperature integer, temperature decimal, checksum. All 40 HIGH
+	 * times are measured first and classified together. */
+	status = DHT11_ReadPulseWidths(widths);
+	if (status != DHT11_OK) {
+		return status;
+	}
+	DHT11_PROF_MARK(DHT11_PROF_DATA);
+	DHT11_Classify(cls, widths, data);
+
+	/* Validate checksum; only confirmed frames tune the threshold */
+	if (data[4] != (uint8_t) (data[0] + data[1] + data[2] + data[3])) {
+		status = DHT11_ERR_CHECKSUM;
+	} else {
+		DHT11_Classify_Learn(cls);
+	}
+	DHT11_DRIFT_FRAME(0U, dht11_response_us, widths, data,
+			(status == DHT11_OK) ? 1U : 0U);
+	DHT11_PROF_MARK(DHT11_PROF_CHECKSUM);
+	return status;
+#endif /* DHT11_USE_EXTI / DHT11_USE_OVERSAMPLE / DHT11_USE_CAPTURE */
+}
+
+/**
+ * @brief Acquires one validated reading, retrying transient failures.
+ */
+dht11_status_t DHT11_Read(dht11_reading_t *reading) {
+	dht11_status_t status;
+	uint8_t attempt = 0U;
+	uint32_t delay_ms;
+	uint32_t elapsed_ms;
+
+	reading->sensor_id = 0U;
+	for (;;) {
+		reading->timestamp_ms = HAL_GetTick();
+		status = DHT11_ReadFrame(reading->raw);
+		if (status == DHT11_OK) {
+			status = DHT11_Driver_Decode(0U, reading->raw);
+		}
+		DHT11_PROF_RESULT(status);
+
+		delay_ms = DHT11_Health_RetryDelayMs(0U, status, attempt);
+		if (delay_ms == 0U) {
+			break;
+		}
+		attempt++;
+		/* Spacing is start-to-start: the failed attempt already used some */
+		elapsed_ms = HAL_GetTick() - reading->timestamp_ms;
+		if (elapsed_ms < delay_ms) {
+			Power_DelayMs(delay_ms - elapsed_ms);
 		}
 	}
+	DHT11_Health_Report(0U, status);
+	/* The last start, for an on-demand request (DHT11_Sampler_Request()) */
+	DHT11_Sampler_Done(1UL << 0U, reading->timestamp_ms);
+
+	reading->status = status;
+	reading->retries = attempt;
+	reading->confidence = DHT11_Classify_Get(0U)->confidence;
+	return status;
+}
 
-	DEBUG_PRINT("Read Byte: 0x%02X\n", byte);
+/**
+ * @brief One attempt through the configured path, no retry.
+ */
+dht11_status_t DHT11_ReadOnce(uint8_t data[5]) {
+	dht11_status_t status;
 
-	return byte;
+	status = DHT11_ReadFrame(data);
+	if (status == DHT11_OK) {
+		status = DHT11_Driver_Decode(0U, data);
+	}
+	DHT11_PROF_RESULT(status);
+	return status;
 }
 
 /**
@@ -204,49 +363,53 @@ uint8_t DHT11_ReadByte(void) {
  *   - Temperature decimal part
  *   - Checksum (for data integrity validation)
  *
- * If the checksum is valid, it toggles an onboard LED (e.g., GPIOA Pin 5) and prints the
- * humidity and temperature readings via UART using both `printf` and `DEBUG_PRINT` macros.
- * If the checksum fails, it prints an error message.
+ * Acquisition goes through DHT11_Read(); the result is handed to the active
+ * sink (dht11_sink.h), which by default toggles the LED and prints the
+ * humidity and temperature readings via UART.
  *
- * The function waits 2 seconds before returning to allow the DHT11 sensor to be ready
- * for the next read (as per DHT11 timing specifications).
+ * It returns the time left until the next read: the period of sensor 0 in
+ * the sampling plan (dht11_sampler.h, 2 s by default and never under the
+ * DHT11's 1 s) from the start pulse, or the longer probe interval of
+ * dht11_health.h once the sensor has failed persistently; while a shared
+ * sync pulse holds the lock (dht11_sync.h), the slot it sets. Being
+ * non-blocking, it runs as a sched.h timer task.
  */
 
-void ReadAndDisplayDHT11(void) {
+uint32_t DHT11_ReadAndEmit(void) {
 
-	uint8_t rh_int;
-	uint8_t rh_dec;
-	uint8_t t_int;
-	uint8_t t_dec;
-	uint8_t checksum;
-	HAL_Delay(1); /*  Give DHT11 time to stabilize */
-	DHT11_Start(); /*  Send start signal to DHT11 */
+	dht11_reading_t reading;
+	uint32_t interval_ms;
+	uint32_t next_ms;
+	uint32_t now;
 
-	if (DHT11_CheckResponse()) {
-		/** Read 5 bytes from DHT11: humidity integer, humidity decimal,
-		 * temperature integer, temperature decimal, checksum */
-		rh_int = DHT11_ReadByte();
-		rh_dec = DHT11_ReadByte();
-		t_int = DHT11_ReadByte();
-		t_dec = DHT11_ReadByte();
-		checksum = DHT11_ReadByte();
-
-		/* Validate checksum */
-		if (checksum == (rh_int + rh_dec + t_int + t_dec)) {
-			HAL_GPIO_TogglePin(GPIOA, GPIO_PIN_5);
-			/* Insert a 100ms delay */
-			/* HAL_Delay(100); */
-			/* printf("Raw received1: %s\r\n", rx_buffer); */
-
-			DEBUG_INFO("DHT11 Initialized\r\n");
-			DEBUG_PRINT("Humidity: %d.%d %%\tTemperature: %d.%d °C\r\n", rh_int,
-					rh_dec, t_int, t_dec);
-			printf("Humidity: %d.%d %% RH \t Temperature: %d.%d deg C\r\n",
-					rh_int, rh_dec, t_int, t_dec);
-		} else {
-			printf("DHT11 checksum error\r\n");
-		}
+	interval_ms = DHT11_Sampler_IntervalMs(0U);
+	if (interval_ms == 0U) {
+		return DHT11_SAMPLER_MIN_PERIOD_MS; /* Not sampled: look again later */
+	}
 
-		HAL_Delay(2000); /* Wait 2 seconds before next reading */
+	HAL_Delay(1); /*  Give DHT11 time to stabilize */
+	if (DHT11_Read(&reading) != DHT11_ERR_NO_RESPONSE) {
+		DHT11_Sink_Emit(&reading);
 	}
+
+	/* One period from the last start pulse, or the next sync slot */
+	next_ms = DHT11_Sampler_NextStartMs(0U, reading.timestamp_ms);
+	now = HAL_GetTick();
+	return ((int32_t) (next_ms - now) > 0) ? (next_ms - now) : 0U;
+}
+
+/**
+ * @brief Time left until the sensor may be read after power-up.
+ */
+uint32_t DHT11_PowerUpRemainingMs(void) {
+	uint32_t now = HAL_GetTick();
+
+	return (now < DHT11_POWERUP_MS) ? (DHT11_POWERUP_MS - now) : 0U;
+}
+
+/**
+ * @brief Reads and emits one reading, then waits for the next interval.
+ */
+void ReadAndDisplayDHT11(void) {
+	Power_DelayMs(DHT11_ReadAndEmit());
 }
@@ -0,0 +1,243 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_agg.c
+ * @brief          : Windowed min/max/mean aggregation per sensor.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "dht11_agg.h"
+#include "dht11_calib.h"
+#include "dht11_sink.h"
+#include "wallclock.h"
+#include <string.h>
+
+/**
+ * @brief Running state of one open window.
+ */
+typedef struct {
+	uint8_t open;
+	uint8_t utc;
+	uint16_t count;
+	uint16_t failures;
+	int16_t temp_min;
+	int16_t temp_max;
+	int16_t hum_min;
+	int16_t hum_max;
+	int32_t temp_sum;
+	int32_t hum_sum;
+	uint32_t end_ms;         /*!< HAL tick at the window's end */
+} agg_window_t;
+
+static dht11_agg_cfg_t agg_cfg;
+static agg_window_t agg_state[DHT11_AGG_SENSORS][DHT11_AGG_WINDOWS];
+static uint32_t agg_summaries = 0U;
+
+/**
+ * @brief Reports whether any window is on.
+ */
+static uint8_t Agg_AnyWindow(void) {
+	uint32_t w;
+
+	for (w = 0U; w < DHT11_AGG_WINDOWS; w++) {
+		if (agg_cfg.window_s[w] != 0U) {
+			return 1U;
+		}
+	}
+	return 0U;
+}
+
+/**
+ * @brief Mean of count values, rounded half away from zero.
+ */
+static int16_t Agg_Mean(int32_t sum, uint16_t count) {
+	int32_t half = (int32_t) count / 2;
+
+	return (int16_t) (((sum < 0) ? (sum - half) : (sum + half))
+			/ (int32_t) count);
+}
+
+/**
+ * @brief Starts a window around tick_ms: its end is the next multiple of
+ *        the length, of UTC when synced, else of the tick.
+ */
+static void Agg_Open(agg_window_t *win, uint32_t window_s, uint32_t tick_ms) {
+	uint32_t pos_ms;
+#if WALLCLOCK_USE_SYNC
+	uint32_t unix_s;
+	uint32_t ms;
+#endif /* WALLCLOCK_USE_SYNC */
+
+	memset(win, 0, sizeof(*win));
+#if WALLCLOCK_USE_SYNC
+	if (Wallclock_IsSynced() != 0U) {
+		unix_s = Wallclock_FromTick(tick_ms, &ms);
+		pos_ms = ((unix_s % window_s) * 1000U) + ms;
+		win->utc = 1U;
+	} else
+#endif /* WALLCLOCK_USE_SYNC */
+	{
+		pos_ms = tick_ms % (window_s * 1000U);
+	}
+	win->end_ms = tick_ms - pos_ms + (window_s * 1000U);
+	win->open = 1U;
+}
+
+/**
+ * @brief Sends the summary of an open window and closes it.
+ */
+static void Agg_Close(agg_window_t *win, uint8_t sensor_id, uint8_t window) {
+	dht11_agg_summary_t summary;
+
+	memset(&summary, 0, sizeof(summary));
+	summary.sensor_id = sensor_id;
+	summary.window = window;
+	summary.utc = win->utc;
+	summary.window_s = agg_cfg.window_s[window];
+	summary.start_ms = win->end_ms - (summary.window_s * 1000U);
+	summary.count = win->count;
+	summary.failures = win->failures;
+	if (win->count != 0U) {
+		summary.temp_min = win->temp_min;
+		summary.temp_mean = Agg_Mean(win->temp_sum, win->count);
+		summary.temp_max = win->temp_max;
+		summary.hum_min = win->hum_min;
+		summary.hum_mean = Agg_Mean(win->hum_sum, win->count);
+		summary.hum_max = win->hum_max;
+	}
+	win->open = 0U;
+	agg_summaries++;
+	DHT11_Sink_Summary(&summary);
+}
+
+/**
+ * @brief Turns all windows off and raw readings on.
+ */
+void DHT11_Agg_Init(void) {
+	dht11_agg_cfg_t cfg;
+
+	memset(&cfg, 0, sizeof(cfg));
+	cfg.raw = 1U;
+	DHT11_Agg_SetConfig(&cfg);
+	agg_summaries = 0U;
+}
+
+/**
+ * @brief Replaces the windows; open windows are dropped.
+ */
+void DHT11_Agg_SetConfig(const dht11_agg_cfg_t *cfg) {
+	uint32_t w;
+
+	agg_cfg = *cfg;
+	for (w = 0U; w < DHT11_AGG_WINDOWS; w++) {
+		if (agg_cfg.window_s[w] > DHT11_AGG_WINDOW_MAX) {
+			agg_cfg.window_s[w] = DHT11_AGG_WINDOW_MAX;
+		}
+	}
+	memset(agg_state, 0, sizeof(agg_state));
+}
+
+/**
+ * @brief Current windows.
+ */
+dht11_agg_cfg_t DHT11_Agg_GetConfig(void) {
+	return agg_cfg;
+}
+
+/**
+ * @brief Adds a reading, closing the windows it is past first.
+ */
+void DHT11_Agg_Add(const dht11_reading_t *reading) {
+	dht11_values_t values = { 0 };
+	agg_window_t *win;
+	uint8_t good;
+	uint32_t w;
+
+	if (reading->sensor_id >= DHT11_AGG_SENSORS) {
+		return;
+	}
+	good = DHT11_Calib_Process(reading, &values);
+
+	for (w = 0U; w < DHT11_AGG_WINDOWS; w++) {
+		if (agg_cfg.window_s[w] == 0U) {
+			continue;
+		}
+		win = &agg_state[reading->sensor_id][w];
+		if ((win->open != 0U)
+				&& ((int32_t) (reading->timestamp_ms - win->end_ms) >= 0)) {
+			Agg_Close(win, reading->sensor_id, (uint8_t) w);
+		}
+		if (win->open == 0U) {
+			Agg_Open(win, agg_cfg.window_s[w], reading->timestamp_ms);
+		}
+
+		if (good == 0U) {
+			if (win->failures != 0xFFFFU) {
+				win->failures++;
+			}
+		} else if (win->count == 0U) {
+			win->temp_min = values.temp;
+			win->temp_max = values.temp;
+			win->hum_min = values.hum;
+			win->hum_max = values.hum;
+			win->temp_sum = values.temp;
+			win->hum_sum = values.hum;
+			win->count = 1U;
+		} else if (win->count != 0xFFFFU) {
+			win->temp_min = (values.temp < win->temp_min) ? values.temp : win->temp_min;
+			win->temp_max = (values.temp > win->temp_max) ? values.temp : win->temp_max;
+			win->hum_min = (values.hum < win->hum_min) ? values.hum : win->hum_min;
+			win->hum_max = (values.hum > win->hum_max) ? values.hum : win->hum_max;
+			win->temp_sum += values.temp;
+			win->hum_sum += values.hum;
+			win->count++;
+		}
+	}
+}
+
+/**
+ * @brief Closes windows whose end passed DHT11_AGG_GRACE_MS ago.
+ */
+void DHT11_Agg_Poll(void) {
+	uint32_t now;
+	uint32_t s;
+	uint32_t w;
+
+	if (Agg_AnyWindow() == 0U) {
+		return;
+	}
+	now = HAL_GetTick();
+	for (s = 0U; s < DHT11_AGG_SENSORS; s++) {
+		for (w = 0U; w < DHT11_AGG_WINDOWS; w++) {
+			if ((agg_state[s][w].open != 0U)
+					&& ((int32_t) (now - agg_state[s][w].end_ms)
+							>= (int32_t) DHT11_AGG_GRACE_MS)) {
+				Agg_Close(&agg_state[s][w], (uint8_t) s, (uint8_t) w);
+			}
+		}
+	}
+}
+
+/**
+ * @brief Reports whether raw readings go on to the sink.
+ */
+uint8_t DHT11_Agg_PassRaw(void) {
+	return ((agg_cfg.raw != 0U) || (Agg_AnyWindow() == 0U)) ? 1U : 0U;
+}
+
+/**
+ * @brief Reports whether any window is on.
+ */
+uint8_t DHT11_Agg_IsOn(void) {
+	return Agg_AnyWindow();
+}
+
+/**
+ * @brief Summaries sent since DHT11_Agg_Init().
+ */
+uint32_t DHT11_Agg_GetSummaries(void) {
+	return agg_summaries;
+}
@@ -0,0 +1,408 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_async.c
+ * @brief          : Non-blocking DHT11 driver built on the capture engine.
+ *
+ *                   States:
+ *                     IDLE     -> nothing scheduled
+ *                     START    -> line held LOW, CC1 fires at the end of
+ *                                 the sensor type's start pulse
+ *                     CAPTURE  -> DMA collecting edges, CC1 = frame timeout
+ *                     DONE     -> frame ready for DHT11_Poll() to decode
+ *                     WAIT     -> CC1 fires at the next refresh instant,
+ *                                 or at a retry (dht11_health.h)
+ *
+ *                   Decoding and the user callback run from DHT11_Poll(),
+ *                   never from interrupt context.
+ *
+ *                   The refresh instants form a grid on TIM5: each is one
+ *                   interval after the slot of the previous reading, not
+ *                   after its start pulse, so neither the compare
+ *                   interrupt latency nor a retry moves later samples.
+ *                   Slots that have passed by the time a reading is done
+ *                   are skipped and counted.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "dht11_async.h"
+#include "my_debug.h"
+#include "dht11_prof.h"
+#include "dht11_health.h"
+#include "dht11_driver.h"
+#include "dht11_supply.h"
+#include "dht11_sync.h"
+#include <stddef.h>
+
+extern TIM_HandleTypeDef htim5;
+
+typedef enum {
+	DHT11_ASYNC_IDLE = 0,
+	DHT11_ASYNC_START,
+	DHT11_ASYNC_CAPTURE,
+	DHT11_ASYNC_DONE,
+	DHT11_ASYNC_WAIT
+} dht11_async_state_t;
+
+static volatile dht11_async_state_t async_state = DHT11_ASYNC_IDLE;
+static volatile dht11_status_t async_capture_status = DHT11_OK;
+static volatile uint8_t async_data_ready = 0U;
+
+/* Start-pulse timestamp of the current transaction, in TIM5 ticks */
+static uint32_t async_start_tick = 0U;
+/* Grid slot of the current reading (its first start pulse when off the
+ * grid), anchoring the cadence */
+static uint32_t async_cycle_tick = 0U;
+/* Slot the WAIT deadline was set for, while async_on_slot */
+static uint32_t async_slot_tick = 0U;
+static uint8_t async_on_slot = 0U;
+static uint32_t async_slots = 0U;
+static uint32_t async_missed = 0U;
+static uint32_t async_max_late_us = 0U;
+static uint8_t async_attempt = 0U;
+static uint32_t async_interval_us = DHT11_ASYNC_INTERVAL_MS * 1000U;
+
+/* HAL tick of the current start pulse, reported as the reading timestamp */
+static uint32_t async_start_ms = 0U;
+
+static dht11_async_cb_t async_callback = NULL;
+static dht11_reading_t async_result;
+
+/**
+ * @brief Programs the channel 1 compare for an absolute TIM5 tick.
+ *        If the deadline has already passed, the event is forced in
+ *        software rather than waiting for the counter to wrap.
+ */
+static void DHT11_Async_SetDeadline(uint32_t tick) {
+	TIM_TypeDef *tim = htim5.Instance;
+
+	tim->CCR1 = tick;
+	tim->SR = ~TIM_SR_CC1IF;
+	tim->DIER |= TIM_DIER_CC1IE;
+	if ((int32_t) (tick - tim->CNT) <= 0) {
+		tim->EGR = TIM_EGR_CC1G;
+	}
+}
+
+/**
+ * @brief Disables the channel 1 compare interrupt.
+ */
+static void DHT11_Async_ClearDeadline(void) {
+	htim5.Instance->DIER &= ~TIM_DIER_CC1IE;
+	htim5.Instance->SR = ~TIM_SR_CC1IF;
+}
+
+/**
+ * @brief Begins the LOW start pulse (any context).
+ */
+static void DHT11_Async_BeginStart(void) {
+	async_start_tick = htim5.Instance->CNT;
+	if ((async_attempt == 0U) && (async_on_slot != 0U)) {
+		/* On the grid: anchor on the slot, not on when the compare ran */
+		async_cycle_tick = async_slot_tick;
+		async_slots++;
+		if ((async_start_tick - async_slot_tick) > async_max_late_us) {
+			async_max_late_us = async_start_tick - async_slot_tick;
+		}
+	} else if (async_attempt == 0U) {
+		async_cycle_tick = async_start_tick;
+	}
+	async_on_slot = 0U;
+	async_start_ms = HAL_GetTick();
+	DHT11_PROF_BEGIN();
+#if DHT11_CAPTURE_USE_HW_START
+	/* TIM8 ends the pulse and hands the line to the capture: nothing to
+	 * do until the frame is in or the deadline passes */
+	if (DHT11_Capture_StartPulse(DHT11_Driver_Get(0U)->start_us) != DHT11_OK) {
+		async_capture_status = DHT11_ERR_BUSY;
+		async_state = DHT11_ASYNC_DONE;
+		DHT11_Async_ClearDeadline();
+		return;
+	}
+	DHT11_PROF_MARK(DHT11_PROF_START); /* Pulse begun, not ended */
+	async_state = DHT11_ASYNC_CAPTURE;
+	DHT11_Async_SetDeadline(async_start_tick + DHT11_Driver_Get(0U)->start_us
+			+ (DHT11_CAPTURE_TIMEOUT_MS * 1000U));
+#else
+	async_state = DHT11_ASYNC_START;
+	DHT11_Capture_DriveLow();
+	DHT11_Async_SetDeadline(async_start_tick + DHT11_Driver_Get(0U)->start_us);
+#endif /* DHT11_CAPTURE_USE_HW_START */
+}
+
+/**
+ * @brief Resets the state machine.
+ */
+void DHT11_Async_Init(void) {
+	DHT11_Async_ClearDeadline();
+	async_state = DHT11_ASYNC_IDLE;
+	async_data_ready = 0U;
+	async_result.status = DHT11_ERR_BUSY;
+}
+
+/**
+ * @brief Registers the completion callback.
+ */
+void DHT11_Async_SetCallback(dht11_async_cb_t cb) {
+	async_callback = cb;
+}
+
+/**
+ * @brief Sets the automatic refresh interval (0 = single shot).
+ */
+void DHT11_Async_SetInterval(uint32_t interval_ms) {
+	async_interval_us = interval_ms * 1000U;
+}
+
+/**
+ * @brief Returns the refresh interval in milliseconds.
+ */
+uint32_t DHT11_Async_GetInterval(void) {
+	return async_interval_us / 1000U;
+}
+
+/**
+ * @brief Fills the sample clock counters.
+ */
+void DHT11_Async_GetClock(dht11_async_clock_t *clock) {
+	clock->slots = async_slots;
+	clock->missed = async_missed;
+	clock->max_late_us = async_max_late_us;
+}
+
+/**
+ * @brief Reports whether a transaction is in progress.
+ */
+uint8_t DHT11_Async_IsBusy(void) {
+	return ((async_state != DHT11_ASYNC_IDLE)
+			&& (async_state != DHT11_ASYNC_WAIT)) ? 1U : 0U;
+}
+
+/**
+ * @brief Time until the state machine next needs the CPU or TIM5.
+ */
+uint32_t DHT11_Async_GetIdleUs(void) {
+	int32_t remaining;
+
+	if (async_state == DHT11_ASYNC_IDLE) {
+		return 0xFFFFFFFFU;
+	}
+	if (async_state != DHT11_ASYNC_WAIT) {
+		return 0U;
+	}
+	remaining = (int32_t) (htim5.Instance->CCR1 - htim5.Instance->CNT);
+	return (remaining > 0) ? (uint32_t) remaining : 0U;
+}
+
+/**
+ * @brief Re-arms the refresh after TIM5 was stepped over a stop.
+ */
+void DHT11_Async_AdvanceTime(uint32_t us) {
+	if ((us == 0U) || (DHT11_Async_IsBusy() != 0U)) {
+		return;
+	}
+	/* Power_Stop() has already moved TIM5 on (SysTime_Advance()) */
+	if (async_state == DHT11_ASYNC_WAIT) {
+		/* Fires at once if the advance stepped over the compare */
+		DHT11_Async_SetDeadline(htim5.Instance->CCR1);
+	}
+}
+
+/**
+ * @brief Begins a transaction.
+ */
+dht11_status_t DHT11_StartAsync(void) {
+	if ((async_state != DHT11_ASYNC_IDLE) && (async_state != DHT11_ASYNC_WAIT)) {
+		return DHT11_ERR_BUSY;
+	}
+	DHT11_Async_ClearDeadline();
+	async_attempt = 0U;
+	async_on_slot = 0U; /* A new grid starts here */
+	DHT11_Async_BeginStart();
+	return DHT11_OK;
+}
+
+/**
+ * @brief Brings the next refresh forward for an on-demand reading.
+ */
+dht11_status_t DHT11_Async_Trigger(void) {
+	dht11_status_t status = DHT11_ERR_BUSY;
+	uint32_t spacing_ms = DHT11_Health_MinSpacingMs(0U);
+
+	/* The compare handler runs at level 0: BASEPRI cannot hold it off */
+	__disable_irq();
+	if (((async_state == DHT11_ASYNC_WAIT) && (async_attempt == 0U))
+			|| ((async_state == DHT11_ASYNC_IDLE) && (async_data_ready != 0U))) {
+		async_state = DHT11_ASYNC_WAIT;
+		async_on_slot = 0U; /* The cadence restarts from this reading */
+		/* Rested already (on the HAL tick, as an idle line may have waited
+		 * longer than TIM5 compares safely): fire now */
+		DHT11_Async_SetDeadline(((HAL_GetTick() - async_start_ms) >= spacing_ms) ?
+				htim5.Instance->CNT : (async_start_tick + (spacing_ms * 1000U)));
+		status = DHT11_OK;
+	}
+	__enable_irq();
+	return status;
+}
+
+/**
+ * @brief TIM5 channel 1 compare: advances the state machine.
+ */
+void DHT11_Async_TimerCallback(void) {
+	switch (async_state) {
+	case DHT11_ASYNC_START:
+		/* Start pulse complete: release the line and capture the frame */
+		if (DHT11_Capture_Arm() != DHT11_OK) {
+			async_capture_status = DHT11_ERR_BUSY;
+			async_state = DHT11_ASYNC_DONE;
+			DHT11_Async_ClearDeadline();
+			break;
+		}
+		DHT11_PROF_MARK(DHT11_PROF_START);
+		async_state = DHT11_ASYNC_CAPTURE;
+		DHT11_Async_SetDeadline(
+				htim5.Instance->CNT + (DHT11_CAPTURE_TIMEOUT_MS * 1000U));
+		break;
+
+	case DHT11_ASYNC_CAPTURE:
+		/* Frame timeout; DHT11_Poll() reports it */
+		DHT11_Async_ClearDeadline();
+		if (DHT11_Capture_IsComplete() != 0U) {
+			async_capture_status = DHT11_OK;
+		} else {
+			async_capture_status =
+					(DHT11_Capture_EdgeCount() == 0U) ?
+							DHT11_ERR_NO_RESPONSE : DHT11_ERR_TIMEOUT;
+			DHT11_Capture_Abort();
+		}
+		async_state = DHT11_ASYNC_DONE;
+		break;
+
+	case DHT11_ASYNC_WAIT:
+#if DHT11_USE_SUPPLY
+		if (DHT11_Supply_ReadyInMs(0U) != 0U) {
+			/* Powered up late (reset or slow poll): wait out the warm-up */
+			DHT11_Async_SetDeadline(htim5.Instance->CNT
+					+ (DHT11_Supply_ReadyInMs(0U) * 1000U));
+			break;
+		}
+#endif /* DHT11_USE_SUPPLY */
+		DHT11_Async_BeginStart();
+		break;
+
+	default:
+		DHT11_Async_ClearDeadline();
+		break;
+	}
+}
+
+/**
+ * @brief Completes a finished transaction from thread context.
+ */
+uint8_t DHT11_Poll(void) {
+	dht11_status_t status;
+	uint8_t raw[5] = { 0U };
+	uint32_t delay_ms;
+	uint32_t interval_us;
+	uint32_t next_tick;
+	uint32_t spacing_tick;
+	uint32_t now;
+	uint8_t i;
+
+	if ((async_state == DHT11_ASYNC_CAPTURE)
+			&& (DHT11_Capture_IsComplete() != 0U)) {
+		DHT11_Async_ClearDeadline();
+		async_capture_status = DHT11_OK;
+		async_state = DHT11_ASYNC_DONE;
+	}
+
+	if (async_state != DHT11_ASYNC_DONE) {
+		return 0U;
+	}
+
+	status = async_capture_status;
+	if (status == DHT11_OK) {
+		/* Data phase ends here, so it includes the main-loop latency */
+		DHT11_PROF_MARK(DHT11_PROF_DATA);
+		status = DHT11_Capture_Decode(raw);
+		if (status == DHT11_OK) {
+			status = DHT11_Driver_Decode(0U, raw);
+		}
+		DHT11_PROF_MARK(DHT11_PROF_CHECKSUM);
+	} else if (status != DHT11_ERR_BUSY) {
+		DHT11_Capture_Trace(status); /* Timed out with what it got */
+	}
+	DHT11_PROF_RESULT(status);
+
+	/* Transient failure: retry silently, spaced from this start pulse */
+	delay_ms = DHT11_Health_RetryDelayMs(0U, status, async_attempt);
+	if (delay_ms != 0U) {
+		async_attempt++;
+		async_state = DHT11_ASYNC_WAIT;
+		DHT11_Async_SetDeadline(async_start_tick + (delay_ms * 1000U));
+		return 0U;
+	}
+	DHT11_Health_Report(0U, status);
+
+	for (i = 0U; i < 5U; i++) {
+		async_result.raw[i] = raw[i];
+	}
+	async_result.status = status;
+	async_result.timestamp_ms = async_start_ms;
+	async_result.retries = async_attempt;
+	async_result.sensor_id = 0U;
+	async_result.confidence = DHT11_Classify_Get(0U)->confidence;
+	async_data_ready = 1U;
+	async_attempt = 0U;
+
+	/* Re-arm the refresh timer relative to the first start pulse of the
+	 * reading so the cadence does not drift by the transaction or retry
+	 * time, but never closer than the minimum spacing to the last one.
+	 * Locked to a sync pulse (dht11_sync.h), the next slot instead. */
+	if (async_interval_us != 0U) {
+		interval_us = DHT11_Health_NextIntervalMs(0U, async_interval_us / 1000U)
+				* 1000U;
+		next_tick = async_cycle_tick + interval_us;
+		spacing_tick = async_start_tick
+				+ (DHT11_Health_MinSpacingMs(0U) * 1000U);
+		if (DHT11_SYNC_SLOT_US(spacing_tick, interval_us, &next_tick) == 0U) {
+			/* Free-running: the first slot of the grid still ahead */
+			now = htim5.Instance->CNT;
+			while (((int32_t) (next_tick - spacing_tick) < 0)
+					|| ((int32_t) (next_tick - now) < 0)) {
+				next_tick += interval_us;
+				async_missed++;
+			}
+		} else if ((int32_t) (next_tick - spacing_tick) < 0) {
+			next_tick = spacing_tick;
+		}
+		async_state = DHT11_ASYNC_WAIT;
+		async_slot_tick = next_tick;
+		async_on_slot = 1U;
+		DHT11_Async_SetDeadline(next_tick);
+	} else {
+		async_state = DHT11_ASYNC_IDLE;
+	}
+
+	if (status != DHT11_OK) {
+		DEBUG_WARN("DHT11 async read failed (%d)\r\n", (int) status);
+	}
+	if (async_callback != NULL) {
+		async_callback(&async_result);
+	}
+	return 1U;
+}
+
+/**
+ * @brief Returns the most recent result.
+ */
+dht11_status_t DHT11_GetResult(dht11_reading_t *reading) {
+	if (async_data_ready == 0U) {
+		return DHT11_ERR_BUSY;
+	}
+	*reading = async_result;
+	return async_result.status;
+}
@@ -0,0 +1,499 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_calib.c
+ * @brief          : Per-sensor calibration and derived metrics in fixed
+ *                   point, or in single precision on the FPU.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "dht11_calib.h"
+#include "dht11_delta.h"
+#include "irq_prio.h"
+
+/** Range of the vapour pressure table, tenths of a degree C */
+#define CALIB_TEMP_MIN    (-400)
+#define CALIB_TEMP_MAX    (800)
+#define CALIB_TEMP_STEP   (20)
+#define CALIB_LUT_LEN     (((CALIB_TEMP_MAX - CALIB_TEMP_MIN) / CALIB_TEMP_STEP) + 1)
+
+/** 0 C in hundredths of a kelvin */
+#define CALIB_ZERO_C_K100 (27315)
+
+/** Mw / R = 2.16679e-3 g K / (m3 Pa), for e in 0.1 Pa, T in 0.01 K and
+ * the result in 0.01 g/m3 */
+#define CALIB_AH_FACTOR   (2167U)
+
+/** Saturation vapour pressure over water in 0.1 Pa at -40, -38 ... 80 C:
+ * 6112 * exp(17.62 T / (243.12 + T)) */
+static const uint32_t calib_es_lut[CALIB_LUT_LEN] = {
+		190U, 234U, 286U, 348U, 423U, 512U,
+		617U, 741U, 887U, 1059U, 1260U, 1494U,
+		1766U, 2083U, 2448U, 2870U, 3356U, 3913U,
+		4552U, 5281U, 6112U, 7057U, 8129U, 9343U,
+		10714U, 12260U, 14000U, 15953U, 18142U, 20591U,
+		23326U, 26374U, 29766U, 33533U, 37711U, 42337U,
+		47450U, 53094U, 59313U, 66156U, 73675U, 81924U,
+		90963U, 100852U, 111659U, 123452U, 136304U, 150294U,
+		165504U, 182020U, 199933U, 219338U, 240337U, 263035U,
+		287543U, 313977U, 342458U, 373114U, 406077U, 441487U,
+		479489U };
+
+static dht11_calib_t calib_table[DHT11_CALIB_SENSORS][2];
+static dht11_calib_path_t calib_path[CLOCK_PROFILE_COUNT];
+static dht11_calib_bench_t calib_bench[CLOCK_PROFILE_COUNT];
+
+/**
+ * @brief num / den rounded to nearest, den > 0.
+ */
+static int32_t Calib_DivRound(int32_t num, int32_t den) {
+	return (num >= 0) ? ((num + (den / 2)) / den) : -((-num + (den / 2)) / den);
+}
+
+/**
+ * @brief Clamps v to [lo, hi].
+ */
+static int32_t Calib_Clamp(int32_t v, int32_t lo, int32_t hi) {
+	return (v < lo) ? lo : ((v > hi) ? hi : v);
+}
+
+/**
+ * @brief Integer square root of v.
+ */
+static uint32_t Calib_Isqrt(uint32_t v) {
+	uint32_t root = 0U;
+	uint32_t bit = 1UL << 30;
+
+	while (bit > v) {
+		bit >>= 2;
+	}
+	while (bit != 0U) {
+		if (v >= (root + bit)) {
+			v -= root + bit;
+			root = (root >> 1) + bit;
+		} else {
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+	return root;
+}
+
+/**
+ * @brief Saturation vapour pressure in 0.1 Pa at temp tenths of a degree.
+ */
+static uint32_t Calib_SatPressure(int32_t temp) {
+	int32_t pos = temp - CALIB_TEMP_MIN;
+	int32_t i = pos / CALIB_TEMP_STEP;
+	int32_t frac = pos % CALIB_TEMP_STEP;
+
+	if (i >= (CALIB_LUT_LEN - 1)) {
+		return calib_es_lut[CALIB_LUT_LEN - 1];
+	}
+	return calib_es_lut[i] + (uint32_t) (((calib_es_lut[i + 1] - calib_es_lut[i])
+			* (uint32_t) frac + (CALIB_TEMP_STEP / 2)) / CALIB_TEMP_STEP);
+}
+
+/**
+ * @brief Temperature, tenths of a degree, at which e in 0.1 Pa saturates.
+ *        Searches down from temp: the dew point is never above it.
+ */
+static int32_t Calib_DewPoint(uint32_t e, int32_t temp) {
+	int32_t i = (temp - CALIB_TEMP_MIN) / CALIB_TEMP_STEP;
+	uint32_t span;
+
+	if (i > (CALIB_LUT_LEN - 2)) {
+		i = CALIB_LUT_LEN - 2;
+	}
+	while ((i > 0) && (calib_es_lut[i] > e)) {
+		i--;
+	}
+	if (e <= calib_es_lut[i]) {
+		return CALIB_TEMP_MIN + (i * CALIB_TEMP_STEP);
+	}
+	span = calib_es_lut[i + 1] - calib_es_lut[i];
+	return CALIB_TEMP_MIN + (i * CALIB_TEMP_STEP)
+			+ (int32_t) (((e - calib_es_lut[i]) * CALIB_TEMP_STEP + (span / 2U))
+					/ span);
+}
+
+/**
+ * @brief Rothfusz regression in tenths of a degree F, from t and rh in
+ *        tenths of a degree F and of %RH.
+ */
+static int32_t Calib_Rothfusz(int32_t t, int32_t rh) {
+	/* Coefficients * 1e8 over powers of ten that undo the tenths; the sum
+	 * is HI * 1e12 */
+	int64_t t1 = t;
+	int64_t r1 = rh;
+	int64_t sum;
+
+	sum = (-4237900000LL * 10000LL) + (204901523LL * t1 * 1000LL)
+			+ (1014333127LL * r1 * 1000LL) - (22475541LL * t1 * r1 * 100LL)
+			- (683783LL * t1 * t1 * 100LL) - (5481717LL * r1 * r1 * 100LL)
+			+ (122874LL * t1 * t1 * r1 * 10LL) + (85282LL * t1 * r1 * r1 * 10LL)
+			- (199LL * t1 * t1 * r1 * r1);
+	return (int32_t) ((sum >= 0) ? ((sum + 50000000000LL) / 100000000000LL)
+			: -((-sum + 50000000000LL) / 100000000000LL));
+}
+
+/**
+ * @brief NWS heat index in tenths of a degree C.
+ */
+static int32_t Calib_HeatIndex(int32_t temp, int32_t rh) {
+	int32_t t = Calib_DivRound(temp * 9, 5) + 320; /* Tenths of a degree F */
+	int32_t hi;
+	int32_t dt;
+
+	/* Steadman's simple formula, which the NWS uses below 80 F */
+	hi = (t + 610 + Calib_DivRound((t - 680) * 12, 10) + Calib_DivRound(rh * 94, 1000))
+			/ 2;
+	if (((hi + t) / 2) >= 800) {
+		hi = Calib_Rothfusz(t, rh);
+		if ((rh < 130) && (t >= 800) && (t <= 1120)) {
+			dt = (t > 950) ? (t - 950) : (950 - t);
+			hi -= (int32_t) (((uint32_t) (130 - rh)
+					* Calib_Isqrt((uint32_t) ((170 - dt) * 10000) / 170U)) / 400U);
+		} else if ((rh > 850) && (t >= 800) && (t <= 870)) {
+			hi += ((rh - 850) * (870 - t)) / 500;
+		}
+	}
+	return Calib_DivRound((hi - 320) * 5, 9);
+}
+
+/**
+ * @brief Dew point, heat index and absolute humidity in integers.
+ */
+static void Calib_DeriveFixed(int32_t temp, int32_t hum, dht11_values_t *values) {
+	uint32_t e;
+
+	/* Actual vapour pressure, 0.1 Pa; at most 479489 * 1000 */
+	e = (Calib_SatPressure(temp) * (uint32_t) hum + 500U) / 1000U;
+
+	values->dew_point = (int16_t) ((hum == 0) ? CALIB_TEMP_MIN
+			: Calib_DewPoint(e, temp));
+	values->heat_index = (int16_t) Calib_HeatIndex(temp, hum);
+	values->abs_hum = (uint16_t) ((e * CALIB_AH_FACTOR
+			+ ((uint32_t) (CALIB_ZERO_C_K100 + (temp * 10)) / 2U))
+			/ (uint32_t) (CALIB_ZERO_C_K100 + (temp * 10)));
+}
+
+#if DHT11_CALIB_USE_FPU
+/**
+ * @brief Rounds to the nearest integer, halves away from zero.
+ */
+static int32_t Calib_RoundF(float x) {
+	return (int32_t) ((x >= 0.0f) ? (x + 0.5f) : (x - 0.5f));
+}
+
+/**
+ * @brief e^x for |x| < 80: 2^i by the exponent bits, 2^f by a degree 6
+ *        series (relative error below 2e-6).
+ */
+static float Calib_ExpF(float x) {
+	float t = x * 1.44269504f;
+	int32_t i = (int32_t) t;
+	float f;
+	float p;
+	union {
+		float f;
+		uint32_t u;
+	} scale;
+
+	if (t < (float) i) {
+		i--; /* Truncation rounded a negative t up */
+	}
+	f = t - (float) i;
+	p = 1.0f + (f * (0.693147181f + (f * (0.240226507f + (f * (0.0555041087f
+			+ (f * (0.00961812911f + (f * (0.00133335581f
+					+ (f * 0.000154035304f)))))))))));
+	scale.u = (uint32_t) (i + 127) << 23;
+	return p * scale.f;
+}
+
+/**
+ * @brief ln(x) for x > 0: the exponent bits, and 2 atanh((m - 1) / (m + 1))
+ *        for the mantissa m centred on 1 (error below 1e-7).
+ */
+static float Calib_LogF(float x) {
+	union {
+		float f;
+		uint32_t u;
+	} v;
+	int32_t e;
+	float s;
+	float s2;
+
+	v.f = x;
+	e = (int32_t) ((v.u >> 23) & 0xFFU) - 127;
+	v.u = (v.u & 0x007FFFFFU) | 0x3F800000U; /* m in [1, 2) */
+	if (v.f > 1.41421356f) {
+		v.f *= 0.5f;
+		e++;
+	}
+	s = (v.f - 1.0f) / (v.f + 1.0f);
+	s2 = s * s;
+	return ((float) e * 0.693147181f)
+			+ (2.0f * s * (1.0f + (s2 * (0.333333333f + (s2 * (0.2f
+					+ (s2 * 0.142857143f)))))));
+}
+
+/**
+ * @brief The NWS heat index in degrees F, from t in degrees F and rh in %.
+ */
+static float Calib_HeatIndexF(float t, float rh) {
+	float hi;
+
+	hi = 0.5f * (t + 61.0f + ((t - 68.0f) * 1.2f) + (rh * 0.094f));
+	if (((hi + t) * 0.5f) < 80.0f) {
+		return hi;
+	}
+	hi = -42.379f + (2.04901523f * t) + (10.14333127f * rh)
+			- (0.22475541f * t * rh) - (0.00683783f * t * t)
+			- (0.05481717f * rh * rh) + (0.00122874f * t * t * rh)
+			+ (0.00085282f * t * rh * rh) - (0.00000199f * t * t * rh * rh);
+	if ((rh < 13.0f) && (t >= 80.0f) && (t <= 112.0f)) {
+		hi -= ((13.0f - rh) * 0.25f)
+				* __builtin_sqrtf((17.0f - __builtin_fabsf(t - 95.0f))
+						* (1.0f / 17.0f));
+	} else if ((rh > 85.0f) && (t >= 80.0f) && (t <= 87.0f)) {
+		hi += ((rh - 85.0f) * 0.1f) * ((87.0f - t) * 0.2f);
+	}
+	return hi;
+}
+
+/**
+ * @brief Dew point, heat index and absolute humidity in single precision.
+ */
+static void Calib_DeriveFloat(int32_t temp, int32_t hum, dht11_values_t *values) {
+	float t = (float) temp * 0.1f;
+	float rh = (float) hum * 0.1f;
+	float magnus = (17.62f * t) / (243.12f + t);
+	float e_hpa = 0.06112f * Calib_ExpF(magnus) * rh; /* 6.112 hPa * rh / 100 */
+	float gamma;
+	float dew;
+
+	if (hum == 0) {
+		dew = (float) CALIB_TEMP_MIN * 0.1f;
+	} else {
+		gamma = Calib_LogF(rh * 0.01f) + magnus;
+		dew = (243.12f * gamma) / (17.62f - gamma);
+		if (dew < ((float) CALIB_TEMP_MIN * 0.1f)) {
+			dew = (float) CALIB_TEMP_MIN * 0.1f; /* Where the table ends */
+		}
+	}
+	values->dew_point = (int16_t) Calib_RoundF(dew * 10.0f);
+	values->heat_index = (int16_t) Calib_RoundF(
+			(Calib_HeatIndexF((t * 1.8f) + 32.0f, rh) - 32.0f) * (10.0f / 1.8f));
+	/* e in Pa * Mw / (R * T), in 0.01 g/m3: 216.679 g K / (m3 hPa) * 100 */
+	values->abs_hum = (uint16_t) Calib_RoundF(
+			(e_hpa * 21667.9f) / (t + 273.15f));
+}
+#endif /* DHT11_CALIB_USE_FPU */
+
+/**
+ * @brief Derived metrics of calibrated values on one path.
+ */
+static void Calib_Derive(dht11_calib_path_t path, int32_t temp, int32_t hum,
+		dht11_values_t *values) {
+#if DHT11_CALIB_USE_FPU
+	if (path == DHT11_CALIB_PATH_FPU) {
+		Calib_DeriveFloat(temp, hum, values);
+		return;
+	}
+#else
+	(void) path;
+#endif /* DHT11_CALIB_USE_FPU */
+	Calib_DeriveFixed(temp, hum, values);
+}
+
+/**
+ * @brief Resets the calibration and the path of every profile.
+ */
+void DHT11_Calib_Init(void) {
+	uint32_t i;
+
+	for (i = 0U; i < CLOCK_PROFILE_COUNT; i++) {
+		calib_path[i] = DHT11_CALIB_DEFAULT_PATH;
+		calib_bench[i].samples = 0U;
+	}
+	for (i = 0U; i < DHT11_CALIB_SENSORS; i++) {
+		calib_table[i][DHT11_CALIB_TEMP].gain = DHT11_CALIB_ONE;
+		calib_table[i][DHT11_CALIB_TEMP].offset = 0;
+		calib_table[i][DHT11_CALIB_HUM].gain = DHT11_CALIB_ONE;
+		calib_table[i][DHT11_CALIB_HUM].offset = 0;
+	}
+}
+
+/**
+ * @brief Sets the calibration of one sensor quantity.
+ */
+uint8_t DHT11_Calib_Set(uint8_t sensor_id, dht11_calib_qty_t qty, int32_t gain,
+		int16_t offset) {
+	if ((sensor_id >= DHT11_CALIB_SENSORS) || ((uint32_t) qty > DHT11_CALIB_HUM)
+			|| (gain <= 0) || (gain > DHT11_CALIB_GAIN_MAX)) {
+		return 0U;
+	}
+	calib_table[sensor_id][qty].gain = gain;
+	calib_table[sensor_id][qty].offset = offset;
+	return 1U;
+}
+
+/**
+ * @brief Calibration of one sensor quantity.
+ */
+dht11_calib_t DHT11_Calib_Get(uint8_t sensor_id, dht11_calib_qty_t qty) {
+	dht11_calib_t identity = { DHT11_CALIB_ONE, 0 };
+
+	if ((sensor_id >= DHT11_CALIB_SENSORS) || ((uint32_t) qty > DHT11_CALIB_HUM)) {
+		return identity;
+	}
+	return calib_table[sensor_id][qty];
+}
+
+/**
+ * @brief Applies a gain and offset to a value in tenths.
+ */
+static int32_t Calib_Apply(dht11_calib_t cal, int32_t value) {
+	/* |value| < 2700 (raw bytes) and gain <= 4.0: the product fits 32 bits */
+	return ((value * cal.gain + (DHT11_CALIB_ONE / 2)) >> 16) + cal.offset;
+}
+
+/**
+ * @brief Calibrates a reading and derives the other values.
+ */
+uint8_t DHT11_Calib_Process(const dht11_reading_t *reading,
+		dht11_values_t *values) {
+	int32_t temp;
+	int32_t hum;
+
+	if (reading->status != DHT11_OK) {
+		return 0U;
+	}
+	temp = Calib_Apply(DHT11_Calib_Get(reading->sensor_id, DHT11_CALIB_TEMP),
+			DHT11_Delta_TempTenths(reading));
+	hum = Calib_Apply(DHT11_Calib_Get(reading->sensor_id, DHT11_CALIB_HUM),
+			DHT11_Delta_HumTenths(reading));
+	temp = Calib_Clamp(temp, CALIB_TEMP_MIN, CALIB_TEMP_MAX);
+	hum = Calib_Clamp(hum, 0, 1000);
+
+	values->temp = (int16_t) temp;
+	values->hum = (int16_t) hum;
+	Calib_Derive(calib_path[Clock_GetProfile()], temp, hum, values);
+	return 1U;
+}
+
+/**
+ * @brief Selects the derived-metrics path of a clock profile.
+ */
+uint8_t DHT11_Calib_SetPath(clock_profile_t profile, dht11_calib_path_t path) {
+	if ((profile >= CLOCK_PROFILE_COUNT) || (path >= DHT11_CALIB_PATHS)
+			|| ((DHT11_CALIB_USE_FPU == 0) && (path == DHT11_CALIB_PATH_FPU))) {
+		return 0U;
+	}
+	calib_path[profile] = path;
+	return 1U;
+}
+
+/**
+ * @brief Derived-metrics path of a clock profile.
+ */
+dht11_calib_path_t DHT11_Calib_GetPath(clock_profile_t profile) {
+	return (profile < CLOCK_PROFILE_COUNT) ?
+			calib_path[profile] : DHT11_CALIB_DEFAULT_PATH;
+}
+
+/**
+ * @brief Larger of a running maximum and |a - b|.
+ */
+static uint16_t Calib_MaxDiff(uint16_t diff, int32_t a, int32_t b) {
+	int32_t d = (a > b) ? (a - b) : (b - a);
+
+	return ((uint32_t) d > diff) ? (uint16_t) d : diff;
+}
+
+/**
+ * @brief Times both paths at the current clock profile.
+ */
+dht11_calib_path_t DHT11_Calib_Bench(dht11_calib_bench_t *result) {
+	dht11_values_t values[DHT11_CALIB_PATHS];
+	uint64_t total[DHT11_CALIB_PATHS] = { 0U };
+	uint32_t basepri;
+	uint32_t start;
+	uint32_t cycles;
+	uint32_t path;
+	uint32_t n = 0U;
+	int32_t temp;
+	int32_t hum;
+
+	result->samples = 0U;
+	result->diff_dew = 0U;
+	result->diff_heat = 0U;
+	result->diff_abs = 0U;
+	for (path = 0U; path < DHT11_CALIB_PATHS; path++) {
+		result->cycles[path] = 0U;
+		result->worst[path] = 0U;
+		/* One untimed pass fills the ART caches as a live reading finds them */
+		Calib_Derive((dht11_calib_path_t) path, 250, 500, &values[path]);
+	}
+	for (temp = CALIB_TEMP_MIN; temp <= CALIB_TEMP_MAX; temp += 100) {
+		for (hum = 0; hum <= 1000; hum += 100) {
+			for (path = 0U; path < DHT11_CALIB_PATHS; path++) {
+				if ((DHT11_CALIB_USE_FPU == 0) && (path == DHT11_CALIB_PATH_FPU)) {
+					continue;
+				}
+				basepri = Irq_MaskFrom(IRQ_PRIO_TIMEBASE);
+				start = DWT->CYCCNT;
+				Calib_Derive((dht11_calib_path_t) path, temp, hum, &values[path]);
+				cycles = DWT->CYCCNT - start;
+				Irq_Unmask(basepri);
+				total[path] += cycles;
+				if (cycles > result->worst[path]) {
+					result->worst[path] = cycles;
+				}
+			}
+#if DHT11_CALIB_USE_FPU
+			result->diff_dew = Calib_MaxDiff(result->diff_dew,
+					values[DHT11_CALIB_PATH_FIXED].dew_point,
+					values[DHT11_CALIB_PATH_FPU].dew_point);
+			result->diff_heat = Calib_MaxDiff(result->diff_heat,
+					values[DHT11_CALIB_PATH_FIXED].heat_index,
+					values[DHT11_CALIB_PATH_FPU].heat_index);
+			result->diff_abs = Calib_MaxDiff(result->diff_abs,
+					values[DHT11_CALIB_PATH_FIXED].abs_hum,
+					values[DHT11_CALIB_PATH_FPU].abs_hum);
+#endif /* DHT11_CALIB_USE_FPU */
+			n++;
+		}
+	}
+	for (path = 0U; path < DHT11_CALIB_PATHS; path++) {
+		result->cycles[path] = (uint32_t) ((total[path] + (n / 2U)) / n);
+	}
+	result->samples = n;
+	calib_bench[Clock_GetProfile()] = *result;
+
+	return ((DHT11_CALIB_USE_FPU != 0)
+			&& (result->cycles[DHT11_CALIB_PATH_FPU]
+					< result->cycles[DHT11_CALIB_PATH_FIXED])) ?
+			DHT11_CALIB_PATH_FPU : DHT11_CALIB_PATH_FIXED;
+}
+
+/**
+ * @brief Last benchmark of a clock profile.
+ */
+const dht11_calib_bench_t* DHT11_Calib_GetBench(clock_profile_t profile) {
+	return &calib_bench[(profile < CLOCK_PROFILE_COUNT) ?
+			profile : Clock_GetProfile()];
+}
+
+/**
+ * @brief Short printable name of a path.
+ */
+const char* DHT11_Calib_PathName(dht11_calib_path_t path) {
+	static const char *const names[DHT11_CALIB_PATHS] = { "fixed", "fpu" };
+
+	return (path < DHT11_CALIB_PATHS) ? names[path] : "?";
+}
@@ -0,0 +1,576 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_capture.c
+ * @brief          : Timer input-capture + DMA engine for the DHT11 bit stream.
+ *
+ *                   TIM5 runs as a 1 MHz free-running counter. Channel 2
+ *                   captures every falling edge on PA1 and DMA stores the
+ *                   timestamps. Falling-to-falling periods are then
+ *                   classified: ~78 us (50 us LOW + 28 us HIGH) is a '0',
+ *                   ~120 us (50 us LOW + 70 us HIGH) is a '1'.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "dht11_capture.h"
+#include "clock_config.h"
+#include "dht11_pin.h"
+#include "my_debug.h"
+#include "dht11_prof.h"
+#include "dht11_drift.h"
+#include "dht11_trace.h"
+#include "irq_prio.h"
+#include "memmap.h"
+#include "dht11_driver.h"
+#include "timebase.h"
+
+extern TIM_HandleTypeDef htim5;
+
+#if DHT11_CAPTURE_USE_HW_START
+/** Start pulse timer and the stream its CC4 match requests */
+#define CAPTURE_START_TIM        (TIM8)
+#define CAPTURE_START_DMA        (DMA2_Stream7)
+#define CAPTURE_START_DMA_CH     (7U)       /* TIM8_CH4 */
+#define CAPTURE_START_DMA_FLAGS  (DMA_HIFCR_CTCIF7 | DMA_HIFCR_CHTIF7 \
+		| DMA_HIFCR_CTEIF7 | DMA_HIFCR_CDMEIF7 | DMA_HIFCR_CFEIF7)
+#endif /* DHT11_CAPTURE_USE_HW_START */
+
+#if APP_USE_FASTPATH
+/** Edge stream (TIM5_CH2, set up by HAL_DMA_Init()) and its flags */
+#define CAPTURE_DMA              (DMA1_Stream4)
+#define CAPTURE_DMA_IRQS         (DMA_SxCR_TCIE | DMA_SxCR_TEIE | DMA_SxCR_DMEIE)
+#define CAPTURE_DMA_FLAGS        (DMA_HIFCR_CTCIF4 | DMA_HIFCR_CHTIF4 \
+		| DMA_HIFCR_CTEIF4 | DMA_HIFCR_CDMEIF4 | DMA_HIFCR_CFEIF4)
+#endif /* APP_USE_FASTPATH */
+
+/* Edge timestamps written by DMA1 Stream4: falling only, or both with a
+ * guard */
+static volatile uint32_t capture_edges[DHT11_CAPTURE_BOTH_EDGES] DMA_BUFFER;
+
+static volatile uint8_t capture_busy = 0U;
+static volatile uint8_t capture_done = 0U;
+static volatile uint32_t capture_count = 0U;  /* Edges once done         */
+static uint32_t capture_len = DHT11_CAPTURE_EDGES; /* DMA length of the frame */
+static uint8_t capture_both = 0U;             /* Both edges this frame   */
+static uint32_t capture_release = 0U;         /* TIM5 count at release   */
+
+static dht11_capture_filter_t capture_filter[DHT11_CAPTURE_SENSORS];
+static uint32_t capture_glitches[DHT11_CAPTURE_SENSORS];
+
+/**
+ * @brief Drives the data pin as open-drain GPIO output (start pulse phase).
+ */
+static void DHT11_Capture_SetPinOutput(void) {
+	DHT11_Pin_ModeGpio();
+}
+
+/**
+ * @brief Hands the data pin to TIM5_CH2. The timer input does not drive
+ *        the pin, so this also releases the line to the pull-up.
+ */
+static void DHT11_Capture_SetPinCapture(void) {
+	DHT11_Pin_ModeCapture();
+}
+
+/**
+ * @brief Disables the CC2 capture and its DMA request.
+ */
+static void DHT11_Capture_Stop(void) {
+	__HAL_TIM_DISABLE_DMA(&htim5, TIM_DMA_CC2);
+	htim5.Instance->CCER &= ~TIM_CCER_CC2E;
+}
+
+/**
+ * @brief DMA transfer-complete callback: the whole frame has been captured.
+ */
+static void DHT11_Capture_DmaCplt(DMA_HandleTypeDef *hdma) {
+	(void) hdma;
+	DHT11_Capture_Stop();
+	capture_count = capture_len;
+	capture_busy = 0U;
+	capture_done = 1U;
+}
+
+/**
+ * @brief DMA error callback: drop the frame, the caller will time out.
+ */
+static void DHT11_Capture_DmaError(DMA_HandleTypeDef *hdma) {
+	(void) hdma;
+	DHT11_Capture_Stop();
+	capture_busy = 0U;
+}
+
+/**
+ * @brief Computes the TIM5 prescaler for a 1 us tick.
+ * @note  APB1 timers run at twice PCLK1 whenever the APB1 divider is not 1.
+ */
+uint32_t DHT11_Capture_TimerPrescaler(void) {
+	return (Clock_GetApb1TimerHz() / DHT11_CAPTURE_TICK_HZ) - 1U;
+}
+
+/**
+ * @brief Starts the free-running capture counter.
+ */
+void DHT11_Capture_Init(void) {
+#if DHT11_CAPTURE_USE_HW_START
+	__HAL_RCC_TIM8_CLK_ENABLE();
+	__HAL_RCC_DMA2_CLK_ENABLE();
+	CAPTURE_START_TIM->CR1 = 0U;
+	CAPTURE_START_DMA->CR = 0U;
+	CAPTURE_START_DMA->PAR = (uint32_t) &DHT_PIN_GPIO_Port->MODER;
+	CAPTURE_START_DMA->CR = (CAPTURE_START_DMA_CH << DMA_SxCR_CHSEL_Pos)
+			| DMA_SxCR_PL | DMA_SxCR_DIR_0 | DMA_SxCR_PSIZE_1 | DMA_SxCR_MSIZE_1;
+#endif /* DHT11_CAPTURE_USE_HW_START */
+	DHT11_Capture_Stop();
+	if (HAL_TIM_Base_Start(&htim5) != HAL_OK) {
+		Error_Handler();
+	}
+	DHT11_Capture_SetPinCapture();
+}
+
+/**
+ * @brief Drives the data line LOW to begin the start pulse.
+ */
+void DHT11_Capture_DriveLow(void) {
+	DHT11_Pin_Low();
+	DHT11_Capture_SetPinOutput();
+}
+
+/**
+ * @brief Sets sensor 0's filter and polarity and starts the DMA stream;
+ *        CC2 stays off.
+ */
+static dht11_status_t DHT11_Capture_Prepare(void) {
+#if !APP_USE_FASTPATH
+	DMA_HandleTypeDef *hdma = htim5.hdma[TIM_DMA_ID_CC2];
+#endif /* !APP_USE_FASTPATH */
+
+	if (capture_busy != 0U) {
+		return DHT11_ERR_BUSY;
+	}
+
+	/* Filter and edge polarity of sensor 0, set while CC2 is off; the
+	 * recorder wants the HIGH times too */
+	capture_both = ((capture_filter[0].min_pulse_us != 0U)
+			|| (DHT11_TRACE_BOTH_EDGES() != 0U)) ? 1U : 0U;
+	capture_len = (capture_both != 0U) ?
+			DHT11_CAPTURE_BOTH_EDGES : DHT11_CAPTURE_EDGES;
+	htim5.Instance->CCMR1 = (htim5.Instance->CCMR1 & ~TIM_CCMR1_IC2F)
+			| ((uint32_t) capture_filter[0].ic_filter << TIM_CCMR1_IC2F_Pos);
+	htim5.Instance->CCER = (htim5.Instance->CCER & ~TIM_CCER_CC2NP)
+			| TIM_CCER_CC2P | ((capture_both != 0U) ? TIM_CCER_CC2NP : 0U);
+
+	capture_done = 0U;
+	capture_count = 0U;
+#if APP_USE_FASTPATH
+	/* Channel, direction, widths and priority stay as HAL_DMA_Init() left
+	 * them; only the addresses, count and interrupts are set per frame */
+	if ((CAPTURE_DMA->CR & DMA_SxCR_EN) != 0U) {
+		return DHT11_ERR_BUSY;
+	}
+	DMA1->HIFCR = CAPTURE_DMA_FLAGS;
+	CAPTURE_DMA->PAR = (uint32_t) &htim5.Instance->CCR2;
+	CAPTURE_DMA->M0AR = (uint32_t) capture_edges;
+	CAPTURE_DMA->NDTR = capture_len;
+	CAPTURE_DMA->CR |= CAPTURE_DMA_IRQS | DMA_SxCR_EN;
+#else
+	hdma->XferCpltCallback = DHT11_Capture_DmaCplt;
+	hdma->XferErrorCallback = DHT11_Capture_DmaError;
+	if (HAL_DMA_Start_IT(hdma, (uint32_t) &htim5.Instance->CCR2,
+			(uint32_t) capture_edges, capture_len) != HAL_OK) {
+		return DHT11_ERR_BUSY;
+	}
+#endif /* APP_USE_FASTPATH */
+	capture_busy = 1U;
+	return DHT11_OK;
+}
+
+/**
+ * @brief Lets CC2 capture edges into the running DMA stream.
+ */
+static void DHT11_Capture_Enable(void) {
+	__HAL_TIM_CLEAR_FLAG(&htim5, TIM_FLAG_CC2 | TIM_FLAG_CC2OF);
+	__HAL_TIM_ENABLE_DMA(&htim5, TIM_DMA_CC2);
+	htim5.Instance->CCER |= TIM_CCER_CC2E;
+}
+
+/**
+ * @brief Edges before the response: the release itself, when both edges
+ *        are captured and it got through the input filter after CC2E.
+ */
+static uint32_t DHT11_Capture_Leading(uint32_t stored) {
+	return ((capture_both != 0U) && (stored != 0U)
+			&& ((capture_edges[0] - capture_release) < DHT11_CAPTURE_RELEASE_US)) ?
+			1U : 0U;
+}
+
+/**
+ * @brief Arms DMA capture, then releases the line to the sensor.
+ */
+dht11_status_t DHT11_Capture_Arm(void) {
+	uint32_t basepri;
+
+	if (DHT11_Capture_Prepare() != DHT11_OK) {
+		return DHT11_ERR_BUSY;
+	}
+
+	/* Release the line first: with falling edges only the rising edge of
+	 * the release is never recorded. The sensor answers 20-40 us after
+	 * the release; nothing less urgent than the capture handlers may
+	 * delay enabling the capture past that. */
+	basepri = Irq_MaskFrom(IRQ_PRIO_TIMEBASE);
+	DHT11_Capture_SetPinCapture();
+	capture_release = htim5.Instance->CNT;
+	DHT11_Capture_Enable();
+	Irq_Unmask(basepri);
+
+	return DHT11_OK;
+}
+
+#if DHT11_CAPTURE_USE_HW_START
+/**
+ * @brief Drives the line LOW and hands it to the capture low_us later.
+ */
+dht11_status_t DHT11_Capture_StartPulse(uint32_t low_us) {
+	static uint32_t moder;
+	uint32_t basepri;
+
+	if ((low_us == 0U) || (low_us > 0xFFFFU)
+			|| (DHT11_Capture_Prepare() != DHT11_OK)) {
+		return DHT11_ERR_BUSY;
+	}
+
+	/* One pulse at 1 MHz; the CC4 match at its end requests the MODER
+	 * write. UG loads the prescaler with no DMA request enabled. */
+	CAPTURE_START_TIM->CR1 = TIM_CR1_OPM;
+	CAPTURE_START_TIM->DIER = 0U;
+	CAPTURE_START_TIM->PSC = (Clock_GetApb2TimerHz() / DHT11_CAPTURE_TICK_HZ) - 1U;
+	CAPTURE_START_TIM->ARR = low_us;
+	CAPTURE_START_TIM->CCR4 = low_us;
+	CAPTURE_START_TIM->EGR = TIM_EGR_UG;
+	CAPTURE_START_TIM->SR = 0U;
+	CAPTURE_START_TIM->DIER = TIM_DIER_CC4DE;
+
+	moder = (DHT_PIN_GPIO_Port->MODER & ~DHT11_PIN_MODER_MASK(DHT11_PIN_NUM))
+			| DHT11_PIN_MODER_AF(DHT11_PIN_NUM);
+	DMA2->HIFCR = CAPTURE_START_DMA_FLAGS;
+	CAPTURE_START_DMA->M0AR = (uint32_t) &moder;
+	CAPTURE_START_DMA->NDTR = 1U;
+	CAPTURE_START_DMA->CR |= DMA_SxCR_EN;
+
+	/* LOW and the pulse timer start together; the release is due at a
+	 * known TIM5 count */
+	basepri = Irq_MaskFrom(IRQ_PRIO_TIMEBASE);
+	DHT11_Capture_DriveLow();
+	CAPTURE_START_TIM->CR1 |= TIM_CR1_CEN;
+	capture_release = htim5.Instance->CNT + low_us;
+	Irq_Unmask(basepri);
+
+	/* Past the input filter, so the falling edge is not captured */
+	Timebase_DelayUsShort(DHT11_CAPTURE_RELEASE_US / 2U);
+	DHT11_Capture_Enable();
+	return DHT11_OK;
+}
+#endif /* DHT11_CAPTURE_USE_HW_START */
+
+/**
+ * @brief Edges stored so far, the release included.
+ */
+static uint32_t DHT11_Capture_Stored(void) {
+	if (capture_done != 0U) {
+		return capture_count;
+	}
+#if APP_USE_FASTPATH
+	return capture_len - CAPTURE_DMA->NDTR;
+#else
+	return capture_len - __HAL_DMA_GET_COUNTER(htim5.hdma[TIM_DMA_ID_CC2]);
+#endif /* APP_USE_FASTPATH */
+}
+
+/**
+ * @brief Aborts a running capture.
+ */
+void DHT11_Capture_Abort(void) {
+#if DHT11_CAPTURE_USE_HW_START
+	CAPTURE_START_TIM->CR1 &= ~TIM_CR1_CEN;
+	CAPTURE_START_TIM->DIER = 0U;
+	CAPTURE_START_DMA->CR &= ~DMA_SxCR_EN;
+#endif /* DHT11_CAPTURE_USE_HW_START */
+	DHT11_Capture_Stop();
+#if APP_USE_FASTPATH
+	CAPTURE_DMA->CR &= ~(CAPTURE_DMA_IRQS | DMA_SxCR_EN);
+	while ((CAPTURE_DMA->CR & DMA_SxCR_EN) != 0U) {
+		/* Clears once the word in transfer is written */
+	}
+	DMA1->HIFCR = CAPTURE_DMA_FLAGS;
+#else
+	(void) HAL_DMA_Abort(htim5.hdma[TIM_DMA_ID_CC2]);
+#endif /* APP_USE_FASTPATH */
+	if ((capture_done == 0U) && (capture_busy != 0U)) {
+		capture_count = DHT11_Capture_Stored(); /* Kept for the recorder */
+	}
+	capture_busy = 0U;
+}
+
+#if APP_USE_FASTPATH
+/**
+ * @brief DMA1 Stream4 interrupt, in place of HAL_DMA_IRQHandler().
+ */
+void DHT11_Capture_DmaIRQHandler(void) {
+	uint32_t hisr = DMA1->HISR;
+
+	DMA1->HIFCR = CAPTURE_DMA_FLAGS;
+	if ((hisr & (DMA_HISR_TEIF4 | DMA_HISR_DMEIF4)) != 0U) {
+		CAPTURE_DMA->CR &= ~(CAPTURE_DMA_IRQS | DMA_SxCR_EN);
+		DHT11_Capture_DmaError(NULL);
+	} else if ((hisr & DMA_HISR_TCIF4) != 0U) {
+		CAPTURE_DMA->CR &= ~CAPTURE_DMA_IRQS;
+		DHT11_Capture_DmaCplt(NULL);
+	}
+}
+#endif /* APP_USE_FASTPATH */
+
+/**
+ * @brief Reports whether the current frame is complete.
+ */
+uint8_t DHT11_Capture_IsComplete(void) {
+	uint32_t count;
+
+	if ((capture_done != 0U) || (capture_both == 0U) || (capture_busy == 0U)) {
+		return capture_done;
+	}
+	/* Guarded: the response and the 41 data edges are in, plus any glitch
+	 * pairs, once nothing has moved for longer than any real segment */
+	count = DHT11_Capture_Stored();
+	if ((count >= ((2U * DHT11_CAPTURE_EDGES) - 1U + DHT11_Capture_Leading(count)))
+			&& ((htim5.Instance->CNT - capture_edges[count - 1U])
+					>= DHT11_CAPTURE_QUIET_US)) {
+		DHT11_Capture_Abort();
+		capture_count = count;
+		capture_done = 1U;
+	}
+	return capture_done;
+}
+
+/**
+ * @brief Number of edges stored so far, derived from the DMA counter.
+ */
+uint32_t DHT11_Capture_EdgeCount(void) {
+	uint32_t stored = DHT11_Capture_Stored();
+
+	return stored - DHT11_Capture_Leading(stored);
+}
+
+/**
+ * @brief Removes short pulses from a both-edge list, keeps falling edges.
+ */
+uint32_t DHT11_Capture_Deglitch(uint8_t sensor, uint32_t *edges,
+		uint32_t count) {
+	uint32_t min_us = DHT11_Capture_GetFilter(sensor).min_pulse_us;
+	uint32_t kept = 0U;
+	uint32_t i;
+
+	for (i = 0U; i < count; i++) {
+		if ((kept >= 2U) && ((edges[i] - edges[kept - 1U]) < min_us)) {
+			/* The pulse from the last kept edge to this one is a glitch:
+			 * drop both, the segment before it goes on */
+			kept--;
+			capture_glitches[sensor]++;
+		} else {
+			edges[kept++] = edges[i];
+		}
+	}
+	/* Even entries are falling */
+	for (i = 0U; (2U * i) < kept; i++) {
+		edges[i] = edges[2U * i];
+	}
+	return i;
+}
+
+/**
+ * @brief Sets a sensor's glitch filter.
+ */
+uint8_t DHT11_Capture_SetFilter(uint8_t sensor,
+		const dht11_capture_filter_t *filter) {
+	if ((sensor >= DHT11_CAPTURE_SENSORS)
+			|| (filter->ic_filter > DHT11_CAPTURE_IC_FILTER_MAX)
+			|| ((filter->ic_filter != 0U) && (sensor != 0U))
+			|| (filter->min_pulse_us > DHT11_CAPTURE_GUARD_MAX_US)) {
+		return 0U;
+	}
+	capture_filter[sensor] = *filter;
+	return 1U;
+}
+
+/**
+ * @brief A sensor's glitch filter.
+ */
+dht11_capture_filter_t DHT11_Capture_GetFilter(uint8_t sensor) {
+	dht11_capture_filter_t none = { 0U, 0U };
+
+	return (sensor < DHT11_CAPTURE_SENSORS) ? capture_filter[sensor] : none;
+}
+
+/**
+ * @brief Shortest spike an IC2F setting passes: N samples at fDTS/div,
+ *        fDTS being the TIM5 kernel clock (CKD = 0).
+ */
+uint32_t DHT11_Capture_FilterNs(uint8_t ic_filter) {
+	/* div * N per ICxF value, RM0390 TIMx_CCMR1 */
+	static const uint16_t clocks[DHT11_CAPTURE_IC_FILTER_MAX + 1U] = { 0U, 2U,
+			4U, 8U, 12U, 16U, 24U, 32U, 48U, 64U, 80U, 96U, 128U, 160U, 192U,
+			256U };
+
+	if (ic_filter > DHT11_CAPTURE_IC_FILTER_MAX) {
+		return 0U;
+	}
+	return ((uint32_t) clocks[ic_filter] * 1000000U)
+			/ (Clock_GetApb1TimerHz() / 1000U);
+}
+
+/**
+ * @brief Pulses a sensor's guard has removed since boot.
+ */
+uint32_t DHT11_Capture_GetGlitches(uint8_t sensor) {
+	return (sensor < DHT11_CAPTURE_SENSORS) ? capture_glitches[sensor] : 0U;
+}
+
+/**
+ * @brief Classifies a list of falling-edge timestamps.
+ */
+dht11_status_t DHT11_Capture_DecodeEdges(const uint32_t *edges,
+		uint8_t sensor, uint8_t data[5]) {
+	dht11_classifier_t *cls = DHT11_Classify_Get(sensor);
+	uint16_t widths[40];
+	uint32_t response;
+	uint32_t period;
+	uint32_t bit;
+
+	/* Response: 80 us LOW + 80 us HIGH between the first two edges */
+	response = edges[1] - edges[0];
+	if ((response < DHT11_CAPTURE_RESP_MIN_US)
+			|| (response > DHT11_CAPTURE_RESP_MAX_US)) {
+		DEBUG_ERROR("DHT11 capture: bad response period %lu us\r\n", response);
+		return DHT11_ERR_FRAME;
+	}
+
+	for (bit = 0U; bit < 40U; bit++) {
+		period = edges[bit + 2U] - edges[bit + 1U];
+		if ((period < DHT11_CAPTURE_BIT_MIN_US)
+				|| (period > DHT11_CAPTURE_BIT_MAX_US)) {
+			DEBUG_ERROR("DHT11 capture: bit %lu period %lu us\r\n", bit, period);
+			return DHT11_ERR_FRAME;
+		}
+		widths[bit] = (uint16_t) period;
+	}
+
+	DHT11_Classify(cls, widths, data);
+	if (data[4] != (uint8_t) (data[0] + data[1] + data[2] + data[3])) {
+		DHT11_DRIFT_FRAME(sensor, response, widths, data, 0U);
+		return DHT11_ERR_CHECKSUM;
+	}
+	DHT11_Classify_Learn(cls);
+	DHT11_DRIFT_FRAME(sensor, response, widths, data, 1U);
+	return DHT11_OK;
+}
+
+/**
+ * @brief Classifies the captured falling-to-falling periods.
+ */
+static dht11_status_t DHT11_Capture_DecodeFrame(uint8_t data[5]) {
+	uint32_t edges[DHT11_CAPTURE_BOTH_EDGES];
+	uint32_t skip = DHT11_Capture_Leading(capture_count);
+	uint32_t count = capture_count - skip;
+	uint32_t i;
+
+	if (capture_both == 0U) {
+		return DHT11_Capture_DecodeEdges((const uint32_t*) capture_edges, 0U,
+				data);
+	}
+	for (i = 0U; i < count; i++) {
+		edges[i] = capture_edges[i + skip];
+	}
+	count = DHT11_Capture_Deglitch(0U, edges, count);
+	if (count < DHT11_CAPTURE_EDGES) {
+		DEBUG_ERROR("DHT11 capture: %lu edges left after the guard\r\n", count);
+		return DHT11_ERR_FRAME;
+	}
+	return DHT11_Capture_DecodeEdges(edges, 0U, data);
+}
+
+/**
+ * @brief Decodes the frame and hands its edges to the recorder.
+ */
+dht11_status_t DHT11_Capture_Decode(uint8_t data[5]) {
+	dht11_status_t status = DHT11_Capture_DecodeFrame(data);
+
+	DHT11_Capture_Trace(status);
+	return status;
+}
+
+/**
+ * @brief Records the edges of the last frame, from the release.
+ */
+void DHT11_Capture_Trace(dht11_status_t status) {
+	uint32_t skip = DHT11_Capture_Leading(capture_count);
+	uint32_t i;
+
+	if (DHT11_TRACE_BEGIN(0U, DHT11_TRACE_RELEASE
+			| ((capture_both != 0U) ? DHT11_TRACE_BOTH : 0U)) == 0U) {
+		return;
+	}
+	for (i = skip; i < capture_count; i++) {
+		DHT11_TRACE_EDGE(capture_edges[i] - capture_release);
+	}
+	DHT11_TRACE_END(status);
+}
+
+/**
+ * @brief Blocking transaction through the capture engine.
+ */
+dht11_status_t DHT11_Capture_Read(uint8_t data[5]) {
+	dht11_status_t status;
+	uint32_t startTick;
+	uint32_t edges;
+
+	/* Pull LOW for the sensor type's start pulse, ≥18 ms for a DHT11 */
+	DHT11_PROF_BEGIN();
+#if DHT11_CAPTURE_USE_HW_START
+	status = DHT11_Capture_StartPulse(DHT11_Driver_Get(0U)->start_us);
+	if (status != DHT11_OK) {
+		return status;
+	}
+	DHT11_PROF_MARK(DHT11_PROF_START); /* Pulse begun, not ended */
+	startTick = HAL_GetTick() + DHT11_Driver_StartMs(0U);
+#else
+	DHT11_Capture_DriveLow();
+	HAL_Delay(DHT11_Driver_StartMs(0U));
+
+	status = DHT11_Capture_Arm();
+	if (status != DHT11_OK) {
+		return status;
+	}
+	DHT11_PROF_MARK(DHT11_PROF_START);
+	startTick = HAL_GetTick();
+#endif /* DHT11_CAPTURE_USE_HW_START */
+
+	while (DHT11_Capture_IsComplete() == 0U) {
+		if ((int32_t) (HAL_GetTick() - startTick)
+				>= (int32_t) DHT11_CAPTURE_TIMEOUT_MS) {
+			edges = DHT11_Capture_EdgeCount();
+			DHT11_Capture_Abort();
+			DEBUG_ERROR("DHT11 capture timeout after %lu edges\r\n", edges);
+			status = (edges == 0U) ? DHT11_ERR_NO_RESPONSE : DHT11_ERR_TIMEOUT;
+			DHT11_Capture_Trace(status);
+			return status;
+		}
+	}
+
+	DHT11_PROF_MARK(DHT11_PROF_DATA); /* Includes the response */
+	status = DHT11_Capture_Decode(data);
+	DHT11_PROF_MARK(DHT11_PROF_CHECKSUM);
+	return status;
+}
@@ -0,0 +1,191 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_classify.c
+ * @brief          : Adaptive '0'/'1' classification of DHT11 bit widths.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "dht11_classify.h"
+#include "dht11_capture.h"
+#include "dht11_prof.h"
+
+static dht11_classifier_t classifiers[DHT11_CLASSIFY_SENSORS];
+
+/**
+ * @brief Statistics of the widths on each side of a threshold.
+ */
+typedef struct {
+	uint32_t n[2];
+	uint32_t mean_q4[2];   /*!< 0 when the side is empty */
+	uint32_t max0_us;
+	uint32_t min1_us;
+} dht11_split_t;
+
+/**
+ * @brief Splits the widths at thr_q4 (a width equal to it counts as '0').
+ */
+static void DHT11_Classify_Split(const uint16_t widths[40], uint32_t thr_q4,
+		dht11_split_t *split) {
+	uint32_t sum[2] = { 0U, 0U };
+	uint32_t side;
+	uint32_t i;
+
+	split->n[0] = 0U;
+	split->n[1] = 0U;
+	split->max0_us = 0U;
+	split->min1_us = 0xFFFFU;
+	for (i = 0U; i < 40U; i++) {
+		side = (((uint32_t) widths[i] << 4) > thr_q4) ? 1U : 0U;
+		sum[side] += widths[i];
+		split->n[side]++;
+		if ((side == 0U) && (widths[i] > split->max0_us)) {
+			split->max0_us = widths[i];
+		}
+		if ((side == 1U) && (widths[i] < split->min1_us)) {
+			split->min1_us = widths[i];
+		}
+	}
+	for (side = 0U; side < 2U; side++) {
+		split->mean_q4[side] =
+				(split->n[side] != 0U) ? ((sum[side] << 4) / split->n[side]) : 0U;
+	}
+}
+
+/**
+ * @brief Seeds a classifier.
+ */
+static void DHT11_Classify_Seed(dht11_classifier_t *cls, uint32_t zero_us,
+		uint32_t one_us) {
+	cls->zero_q4 = zero_us << 4;
+	cls->one_q4 = one_us << 4;
+	cls->frame_zero_q4 = 0U;
+	cls->frame_one_q4 = 0U;
+	cls->learnt = 0U;
+	cls->confidence = 0U;
+	cls->clean = 0U;
+}
+
+/**
+ * @brief Seeds every classifier with the nominal widths of its path.
+ */
+void DHT11_Classify_Init(void) {
+	uint32_t i;
+
+	for (i = 0U; i < DHT11_CLASSIFY_SENSORS; i++) {
+		DHT11_Classify_Seed(&classifiers[i], DHT11_CLASSIFY_PERIOD_ZERO_US,
+				DHT11_CLASSIFY_PERIOD_ONE_US);
+	}
+#if !DHT11_USE_CAPTURE
+	DHT11_Classify_Seed(&classifiers[0], DHT11_CLASSIFY_HIGH_ZERO_US,
+			DHT11_CLASSIFY_HIGH_ONE_US);
+#endif /* !DHT11_USE_CAPTURE */
+}
+
+/**
+ * @brief Returns the classifier of a sensor.
+ */
+dht11_classifier_t* DHT11_Classify_Get(uint32_t sensor) {
+	if (sensor >= DHT11_CLASSIFY_SENSORS) {
+		sensor = 0U;
+	}
+	return &classifiers[sensor];
+}
+
+/**
+ * @brief Decodes 40 widths into 5 bytes.
+ */
+void DHT11_Classify(dht11_classifier_t *cls, const uint16_t widths[40],
+		uint8_t data[5]) {
+	dht11_split_t split;
+	uint32_t thr_q4;
+	uint32_t half_q4;
+	uint32_t dist_q4;
+	uint32_t min_dist_q4 = 0xFFFFFFFFU;
+	uint32_t w_q4;
+	uint32_t conf;
+	uint32_t i;
+
+	/* 1. Running midpoint */
+	thr_q4 = (cls->zero_q4 + cls->one_q4) / 2U;
+	DHT11_Classify_Split(widths, thr_q4, &split);
+	cls->clean = 0U;
+
+#if DHT11_USE_ADAPTIVE
+	/* 2. Frame midpoint, kept only if the clusters separate cleanly */
+	if ((split.n[0] != 0U) && (split.n[1] != 0U)) {
+		dht11_split_t frame;
+		uint32_t frame_thr_q4 = (split.mean_q4[0] + split.mean_q4[1]) / 2U;
+
+		DHT11_Classify_Split(widths, frame_thr_q4, &frame);
+		if ((frame.n[0] != 0U) && (frame.n[1] != 0U)
+				&& (frame.min1_us >= (frame.max0_us + DHT11_CLASSIFY_MIN_GAP_US))) {
+			thr_q4 = frame_thr_q4;
+			split = frame;
+			cls->clean = 1U;
+		}
+	}
+#endif /* DHT11_USE_ADAPTIVE */
+
+	for (i = 0U; i < 5U; i++) {
+		data[i] = 0U;
+	}
+	for (i = 0U; i < 40U; i++) {
+		w_q4 = (uint32_t) widths[i] << 4;
+		data[i >> 3] = (uint8_t) (data[i >> 3] << 1);
+		if (w_q4 > thr_q4) {
+			data[i >> 3] |= 1U;
+			dist_q4 = w_q4 - thr_q4;
+		} else {
+			dist_q4 = thr_q4 - w_q4;
+		}
+		if (dist_q4 < min_dist_q4) {
+			min_dist_q4 = dist_q4;
+		}
+		DHT11_PROF_BIT(i, data[i >> 3] & 1U, widths[i]);
+	}
+
+	/* Confidence against the frame's own spread when it has both values */
+	if ((split.n[0] != 0U) && (split.n[1] != 0U)
+			&& (split.mean_q4[1] > split.mean_q4[0])) {
+		half_q4 = (split.mean_q4[1] - split.mean_q4[0]) / 2U;
+	} else {
+		half_q4 = (cls->one_q4 - cls->zero_q4) / 2U;
+	}
+	conf = (half_q4 != 0U) ? ((min_dist_q4 * 100U) / half_q4) : 0U;
+	cls->confidence = (uint8_t) ((conf > 100U) ? 100U : conf);
+	cls->frame_zero_q4 = split.mean_q4[0];
+	cls->frame_one_q4 = split.mean_q4[1];
+}
+
+/**
+ * @brief Folds the last frame into the running means.
+ */
+void DHT11_Classify_Learn(dht11_classifier_t *cls) {
+#if DHT11_USE_ADAPTIVE
+	if ((cls->frame_zero_q4 == 0U) || (cls->frame_one_q4 == 0U)
+			|| (cls->frame_one_q4
+					< (cls->frame_zero_q4 + (DHT11_CLASSIFY_MIN_SEP_US << 4)))) {
+		return;
+	}
+	cls->zero_q4 = (uint32_t) ((int32_t) cls->zero_q4
+			+ (((int32_t) cls->frame_zero_q4 - (int32_t) cls->zero_q4)
+					>> DHT11_CLASSIFY_EMA_SHIFT));
+	cls->one_q4 = (uint32_t) ((int32_t) cls->one_q4
+			+ (((int32_t) cls->frame_one_q4 - (int32_t) cls->one_q4)
+					>> DHT11_CLASSIFY_EMA_SHIFT));
+	cls->learnt++;
+#else
+	(void) cls;
+#endif /* DHT11_USE_ADAPTIVE */
+}
+
+/**
+ * @brief Current running threshold in microseconds.
+ */
+uint32_t DHT11_Classify_Threshold(const dht11_classifier_t *cls) {
+	return ((cls->zero_q4 + cls->one_q4) / 2U) >> 4;
+}
@@ -0,0 +1,96 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_delta.c
+ * @brief          : Delta and run-length encoding stage for readings.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "dht11_delta.h"
+
+/**
+ * @brief Forgets the sensor's state.
+ */
+void DHT11_Delta_Reset(dht11_delta_enc_t *enc) {
+	enc->hum = 0;
+	enc->temp = 0;
+	enc->run = 0U;
+	enc->since_key = 0U;
+	enc->valid = 0U;
+}
+
+/**
+ * @brief Encodes one successful reading.
+ */
+dht11_delta_kind_t DHT11_Delta_Encode(dht11_delta_enc_t *enc,
+		const dht11_delta_limits_t *limits, int16_t hum, int16_t temp,
+		uint32_t flags, dht11_delta_t *out) {
+	int32_t dh = (int32_t) hum - enc->hum;
+	int32_t dtemp = (int32_t) temp - enc->temp;
+	dht11_delta_kind_t kind;
+
+	enc->since_key++;
+	if ((enc->valid == 0U) || ((flags & DHT11_DELTA_FORCE_KEY) != 0U)
+			|| ((limits->key_every != 0U)
+					&& (enc->since_key >= limits->key_every))
+			|| (dh < limits->step_min) || (dh > limits->step_max)
+			|| (dtemp < limits->step_min) || (dtemp > limits->step_max)) {
+		kind = DHT11_DELTA_KEY;
+	} else if ((dh == 0) && (dtemp == 0)
+			&& ((flags & DHT11_DELTA_NO_RUN) == 0U)
+			&& (enc->run < limits->run_max)) {
+		enc->run++;
+		return DHT11_DELTA_RUN;
+	} else {
+		kind = DHT11_DELTA_STEP;
+	}
+
+	out->kind = kind;
+	out->run = enc->run;
+	out->hum = hum;
+	out->temp = temp;
+	out->dh = (int16_t) dh;
+	out->dtemp = (int16_t) dtemp;
+
+	enc->run = 0U;
+	enc->hum = hum;
+	enc->temp = temp;
+	if (kind == DHT11_DELTA_KEY) {
+		enc->since_key = 0U;
+		enc->valid = 1U;
+	}
+	return kind;
+}
+
+/**
+ * @brief Ends the current run.
+ */
+uint32_t DHT11_Delta_TakeRun(dht11_delta_enc_t *enc) {
+	uint32_t run = enc->run;
+
+	enc->run = 0U;
+	return run;
+}
+
+/**
+ * @brief Relative humidity in tenths of %RH.
+ */
+int16_t DHT11_Delta_HumTenths(const dht11_reading_t *reading) {
+	return (int16_t) ((reading->raw[0] * 10) + reading->raw[1]);
+}
+
+/**
+ * @brief Temperature in tenths of a degree.
+ */
+int16_t DHT11_Delta_TempTenths(const dht11_reading_t *reading) {
+	int16_t temp;
+
+	temp = (int16_t) ((reading->raw[2] * 10) + (reading->raw[3] & 0x7FU));
+	if ((reading->raw[3] & 0x80U) != 0U) {
+		temp = (int16_t) -temp;
+	}
+	return temp;
+}
@@ -0,0 +1,135 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_discover.c
+ * @brief          : Sensor discovery and hot-plug detection on the candidate
+ *                   data lines.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "dht11_discover.h"
+#include "dht11_sampler.h"
+#include "my_debug.h"
+
+#if DHT11_USE_DISCOVERY
+
+/**
+ * @brief Presence of one sensor.
+ */
+typedef struct {
+	dht11_presence_t presence;
+	uint32_t misses;     /*!< Readings without a response in a row */
+} discover_sensor_t;
+
+static discover_sensor_t discover_sensors[DHT11_DISCOVER_SENSORS];
+static uint32_t discover_found = 0U;
+static uint32_t discover_lost = 0U;
+static uint32_t discover_rechecks = 0U;
+
+/**
+ * @brief Marks every sensor unknown.
+ */
+void DHT11_Discover_Init(void) {
+	uint32_t i;
+
+	for (i = 0U; i < DHT11_DISCOVER_SENSORS; i++) {
+		discover_sensors[i].presence = DHT11_PRESENCE_UNKNOWN;
+		discover_sensors[i].misses = 0U;
+	}
+	discover_found = 0U;
+	discover_lost = 0U;
+	discover_rechecks = 0U;
+}
+
+/**
+ * @brief Updates the presence of a sensor from a final status.
+ */
+void DHT11_Discover_Report(uint32_t sensor, dht11_status_t status) {
+	discover_sensor_t *s;
+	dht11_presence_t before;
+
+	if (sensor >= DHT11_DISCOVER_SENSORS) {
+		return;
+	}
+	s = &discover_sensors[sensor];
+	before = s->presence;
+	if (before == DHT11_PRESENCE_ABSENT) {
+		discover_rechecks++;
+	}
+
+	if (status != DHT11_ERR_NO_RESPONSE) {
+		/* Something drove the line: a sensor, even with a bad frame */
+		s->misses = 0U;
+		s->presence = DHT11_PRESENCE_PRESENT;
+	} else {
+		s->misses++;
+		if ((before != DHT11_PRESENCE_PRESENT)
+				|| (s->misses >= DHT11_DISCOVER_LOST_AFTER)) {
+			s->presence = DHT11_PRESENCE_ABSENT;
+		}
+	}
+	if (s->presence == before) {
+		return;
+	}
+
+	if (s->presence == DHT11_PRESENCE_PRESENT) {
+		discover_found++;
+		DEBUG_INFO("DHT11 sensor %lu found\r\n", sensor);
+		if (before == DHT11_PRESENCE_ABSENT) {
+			/* Plugged in: read it now, not a recheck period on */
+			(void) DHT11_Sampler_Request(1UL << sensor, HAL_GetTick());
+		}
+	} else {
+		if (before == DHT11_PRESENCE_PRESENT) {
+			discover_lost++;
+		}
+		DEBUG_INFO("DHT11 sensor %lu absent\r\n", sensor);
+	}
+}
+
+/**
+ * @brief Presence of a sensor.
+ */
+dht11_presence_t DHT11_Discover_Get(uint32_t sensor) {
+	if (sensor >= DHT11_DISCOVER_SENSORS) {
+		return DHT11_PRESENCE_UNKNOWN;
+	}
+	return discover_sensors[sensor].presence;
+}
+
+/**
+ * @brief Copies the discovery counters.
+ */
+void DHT11_Discover_GetStats(dht11_discover_stats_t *stats) {
+	uint32_t i;
+
+	stats->present = 0U;
+	stats->absent = 0U;
+	for (i = 0U; i < DHT11_DISCOVER_SENSORS; i++) {
+		if (discover_sensors[i].presence == DHT11_PRESENCE_PRESENT) {
+			stats->present |= 1UL << i;
+		} else if (discover_sensors[i].presence == DHT11_PRESENCE_ABSENT) {
+			stats->absent |= 1UL << i;
+		}
+	}
+	stats->found = discover_found;
+	stats->lost = discover_lost;
+	stats->rechecks = discover_rechecks;
+}
+
+/**
+ * @brief Short printable name of a presence state.
+ */
+const char* DHT11_Discover_Name(dht11_presence_t presence) {
+	static const char *const names[] = { "unknown", "present", "absent" };
+
+	if ((uint32_t) presence >= (sizeof(names) / sizeof(names[0]))) {
+		return "?";
+	}
+	return names[presence];
+}
+
+#endif /* DHT11_USE_DISCOVERY */
@@ -0,0 +1,225 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_drift.c
+ * @brief          : Per-sensor long-term timing drift and health events.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "dht11_drift.h"
+#include "my_debug.h"
+#include <string.h>
+
+static dht11_drift_t drift_ctx[DHT11_DRIFT_SENSORS];
+
+/**
+ * @brief Returns the context of a sensor; out-of-range maps to sensor 0.
+ */
+static dht11_drift_t* DHT11_Drift_Ctx(uint32_t sensor) {
+	if (sensor >= DHT11_DRIFT_SENSORS) {
+		sensor = 0U;
+	}
+	return &drift_ctx[sensor];
+}
+
+/**
+ * @brief Integer square root.
+ */
+static uint32_t DHT11_Drift_Isqrt(uint32_t x) {
+	uint32_t root = 0U;
+	uint32_t bit = 1UL << 30;
+
+	while (bit > x) {
+		bit >>= 2;
+	}
+	while (bit != 0U) {
+		if (x >= (root + bit)) {
+			x -= root + bit;
+			root = (root >> 1) + bit;
+		} else {
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+	return root;
+}
+
+/**
+ * @brief Folds one sample (mean, spread already inside it) into a running
+ *        statistic; the first sample seeds it.
+ */
+static void DHT11_Drift_Fold(dht11_drift_stat_t *stat, uint32_t first,
+		uint32_t x_q8, uint32_t spread_q8) {
+	int32_t d_q8;
+	uint32_t d2_q8;
+
+	if (first != 0U) {
+		stat->mean_q8 = x_q8;
+		stat->var_q8 = spread_q8;
+		return;
+	}
+	d_q8 = (int32_t) x_q8 - (int32_t) stat->mean_q8;
+	d2_q8 = (uint32_t) (((int64_t) d_q8 * d_q8) >> 8);
+	stat->mean_q8 = (uint32_t) ((int32_t) stat->mean_q8
+			+ (d_q8 / (1 << DHT11_DRIFT_SHIFT)));
+	stat->var_q8 = (uint32_t) ((int32_t) stat->var_q8
+			+ (((int32_t) (spread_q8 + d2_q8) - (int32_t) stat->var_q8)
+					/ (1 << DHT11_DRIFT_SHIFT)));
+}
+
+/**
+ * @brief Folds the widths of one cluster of a good frame; a cluster seeds
+ *        on the first frame that has its bit value.
+ */
+static void DHT11_Drift_Cluster(dht11_drift_t *ctx, uint32_t value,
+		const uint16_t widths[40], const uint8_t data[5]) {
+	uint32_t n = 0U;
+	uint32_t sum = 0U;
+	uint32_t sumsq = 0U;
+	uint32_t spread_q8;
+	uint32_t i;
+
+	for (i = 0U; i < 40U; i++) {
+		if (((uint32_t) (data[i >> 3] >> (7U - (i & 7U))) & 1U) == value) {
+			n++;
+			sum += widths[i];
+			sumsq += (uint32_t) widths[i] * widths[i];
+		}
+	}
+	if (n == 0U) {
+		return;
+	}
+	spread_q8 = (uint32_t) ((((uint64_t) n * sumsq - (uint64_t) sum * sum)
+			<< 8) / ((uint64_t) n * n));
+	DHT11_Drift_Fold(&ctx->bit[value], (ctx->bit[value].mean_q8 == 0U) ? 1U : 0U,
+			(sum << 8) / n, spread_q8);
+}
+
+/**
+ * @brief Re-evaluates the events of a sensor and logs the ones raised.
+ */
+static void DHT11_Drift_Check(uint32_t sensor, dht11_drift_t *ctx) {
+	int32_t margin_min;
+	int32_t margin_rel;
+	int32_t off;
+	uint8_t events = ctx->events;
+	uint8_t raised;
+	uint32_t i;
+
+	if (ctx->baseline == 0U) {
+		return;
+	}
+
+	margin_min = (int32_t) DHT11_DRIFT_MARGIN_MIN_US * 16;
+	margin_rel = (ctx->base_margin_q4
+			* (int32_t) (100U - DHT11_DRIFT_MARGIN_LOSS_PCT)) / 100;
+	if (margin_rel > margin_min) {
+		margin_min = margin_rel;
+	}
+	if (ctx->margin_q4 < margin_min) {
+		events |= DHT11_DRIFT_EV_MARGIN;
+	} else if (ctx->margin_q4
+			>= (margin_min + ((int32_t) DHT11_DRIFT_HYST_US * 16))) {
+		events &= (uint8_t) ~DHT11_DRIFT_EV_MARGIN;
+	}
+
+	off = (int32_t) ctx->response.mean_q8 - (int32_t) ctx->base_response_q8;
+	if (off < 0) {
+		off = -off;
+	}
+	if (off > ((int32_t) DHT11_DRIFT_RESPONSE_US * 256)) {
+		events |= DHT11_DRIFT_EV_RESPONSE;
+	} else if (off <= ((int32_t) (DHT11_DRIFT_RESPONSE_US
+			- DHT11_DRIFT_HYST_US) * 256)) {
+		events &= (uint8_t) ~DHT11_DRIFT_EV_RESPONSE;
+	}
+
+	if (ctx->fail_permille > DHT11_DRIFT_FAIL_PERMILLE) {
+		events |= DHT11_DRIFT_EV_CHECKSUM;
+	} else if (ctx->fail_permille <= (DHT11_DRIFT_FAIL_PERMILLE / 2U)) {
+		events &= (uint8_t) ~DHT11_DRIFT_EV_CHECKSUM;
+	}
+
+	raised = events & (uint8_t) ~ctx->events;
+	ctx->events = events;
+	for (i = 0U; i < DHT11_DRIFT_EVENTS; i++) {
+		if ((raised & (1U << i)) != 0U) {
+			ctx->raised++;
+			DEBUG_WARN("DHT11 sensor %lu: drift %s\r\n", sensor,
+					DHT11_Drift_EventName(i));
+		}
+	}
+}
+
+/**
+ * @brief Clears every sensor's statistics.
+ */
+void DHT11_Drift_Init(void) {
+	memset(drift_ctx, 0, sizeof(drift_ctx));
+}
+
+/**
+ * @brief Clears one sensor's statistics and baseline.
+ */
+void DHT11_Drift_Reset(uint32_t sensor) {
+	memset(DHT11_Drift_Ctx(sensor), 0, sizeof(dht11_drift_t));
+}
+
+/**
+ * @brief Folds one fully timed frame in.
+ */
+void DHT11_Drift_Frame(uint32_t sensor, uint32_t response_us,
+		const uint16_t widths[40], const uint8_t data[5], uint8_t checksum_ok) {
+	dht11_drift_t *ctx = DHT11_Drift_Ctx(sensor);
+	int32_t target = (checksum_ok != 0U) ? 0 : 65536;
+
+	DHT11_Drift_Fold(&ctx->response, (ctx->frames == 0U) ? 1U : 0U,
+			response_us << 8, 0U);
+	ctx->fail_q16 = (uint32_t) ((int32_t) ctx->fail_q16
+			+ ((target - (int32_t) ctx->fail_q16) / (1 << DHT11_DRIFT_SHIFT)));
+	ctx->fail_permille = (uint16_t) ((ctx->fail_q16 * 1000U) >> 16);
+	ctx->frames++;
+
+	if (checksum_ok != 0U) {
+		DHT11_Drift_Cluster(ctx, 0U, widths, data);
+		DHT11_Drift_Cluster(ctx, 1U, widths, data);
+		ctx->good++;
+		ctx->margin_q4 = ((int32_t) (ctx->bit[1].mean_q8 >> 4)
+				- (3 * (int32_t) DHT11_Drift_SdQ4(&ctx->bit[1])))
+				- ((int32_t) (ctx->bit[0].mean_q8 >> 4)
+						+ (3 * (int32_t) DHT11_Drift_SdQ4(&ctx->bit[0])));
+		if ((ctx->baseline == 0U) && (ctx->good >= DHT11_DRIFT_LEARN_FRAMES)) {
+			ctx->base_margin_q4 = ctx->margin_q4;
+			ctx->base_response_q8 = ctx->response.mean_q8;
+			ctx->baseline = 1U;
+		}
+	}
+	DHT11_Drift_Check(sensor, ctx);
+}
+
+/**
+ * @brief Read-only view of a sensor's statistics.
+ */
+const dht11_drift_t* DHT11_Drift_Get(uint32_t sensor) {
+	return DHT11_Drift_Ctx(sensor);
+}
+
+/**
+ * @brief Standard deviation of a statistic, 1/16 us.
+ */
+uint32_t DHT11_Drift_SdQ4(const dht11_drift_stat_t *stat) {
+	return DHT11_Drift_Isqrt(stat->var_q8);
+}
+
+/**
+ * @brief Short printable name of event flag i.
+ */
+const char* DHT11_Drift_EventName(uint32_t i) {
+	static const char *const names[DHT11_DRIFT_EVENTS] = { "margin",
+			"response", "checksum" };
+
+	return (i < DHT11_DRIFT_EVENTS) ? names[i] : "?";
+}
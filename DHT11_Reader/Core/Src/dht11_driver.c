@@ -0,0 +1,123 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_driver.c
+ * @brief          : Sensor-type descriptors, so DHT11 and DHT22/AM2302
+ *                   sensors run on the same engines.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "dht11_driver.h"
+#include <stddef.h>
+#include <string.h>
+
+/** DHT22 range, tenths */
+#define DRIVER_DHT22_HUM_MAX   (1000U)
+#define DRIVER_DHT22_TEMP_MAX  (800U)
+
+static dht11_status_t Driver_DecodeDht11(uint8_t raw[5]);
+static dht11_status_t Driver_DecodeDht22(uint8_t raw[5]);
+
+const dht11_driver_t dht11_driver_dht11 = { "dht11", 18000U, 1000U,
+		Driver_DecodeDht11 };
+const dht11_driver_t dht11_driver_dht22 = { "dht22", 1100U, 2000U,
+		Driver_DecodeDht22 };
+
+static const dht11_driver_t *const driver_builtin[] = { &dht11_driver_dht11,
+		&dht11_driver_dht22 };
+
+/* NULL: never set, the DHT11 */
+static const dht11_driver_t *driver_sensors[DHT11_DRIVER_SENSORS];
+
+/**
+ * @brief DHT11 frames already are the reading layout.
+ */
+static dht11_status_t Driver_DecodeDht11(uint8_t raw[5]) {
+	(void) raw;
+	return DHT11_OK;
+}
+
+/**
+ * @brief DHT22: 16-bit humidity, then 16-bit sign-magnitude temperature,
+ *        both in tenths, big-endian.
+ */
+static dht11_status_t Driver_DecodeDht22(uint8_t raw[5]) {
+	uint32_t hum = ((uint32_t) raw[0] << 8) | raw[1];
+	uint32_t temp = ((uint32_t) (raw[2] & 0x7FU) << 8) | raw[3];
+	uint8_t negative = raw[2] & 0x80U;
+
+	if ((hum > DRIVER_DHT22_HUM_MAX) || (temp > DRIVER_DHT22_TEMP_MAX)) {
+		return DHT11_ERR_FRAME;
+	}
+	raw[0] = (uint8_t) (hum / 10U);
+	raw[1] = (uint8_t) (hum % 10U);
+	raw[2] = (uint8_t) (temp / 10U);
+	raw[3] = (uint8_t) ((temp % 10U) | ((negative != 0U) ? 0x80U : 0U));
+	raw[4] = (uint8_t) (raw[0] + raw[1] + raw[2] + raw[3]);
+	return DHT11_OK;
+}
+
+/**
+ * @brief Makes every sensor a DHT11.
+ */
+void DHT11_Driver_Init(void) {
+	uint32_t i;
+
+	for (i = 0U; i < DHT11_DRIVER_SENSORS; i++) {
+		driver_sensors[i] = &dht11_driver_dht11;
+	}
+}
+
+/**
+ * @brief Sets the type of one sensor.
+ */
+uint8_t DHT11_Driver_Set(uint8_t sensor_id, const dht11_driver_t *driver) {
+	if ((sensor_id >= DHT11_DRIVER_SENSORS) || (driver == NULL)
+			|| (driver->decode == NULL)) {
+		return 0U;
+	}
+	driver_sensors[sensor_id] = driver;
+	return 1U;
+}
+
+/**
+ * @brief Type of one sensor.
+ */
+const dht11_driver_t* DHT11_Driver_Get(uint8_t sensor_id) {
+	if ((sensor_id >= DHT11_DRIVER_SENSORS)
+			|| (driver_sensors[sensor_id] == NULL)) {
+		return &dht11_driver_dht11;
+	}
+	return driver_sensors[sensor_id];
+}
+
+/**
+ * @brief Built-in type by name.
+ */
+const dht11_driver_t* DHT11_Driver_Find(const char *name) {
+	uint32_t i;
+
+	for (i = 0U; i < (sizeof(driver_builtin) / sizeof(driver_builtin[0])); i++) {
+		if (strcmp(driver_builtin[i]->name, name) == 0) {
+			return driver_builtin[i];
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @brief Decodes a checksum-valid frame of one sensor in place.
+ */
+dht11_status_t DHT11_Driver_Decode(uint8_t sensor_id, uint8_t raw[5]) {
+	return DHT11_Driver_Get(sensor_id)->decode(raw);
+}
+
+/**
+ * @brief Start pulse in whole milliseconds, rounded up.
+ */
+uint32_t DHT11_Driver_StartMs(uint8_t sensor_id) {
+	return (DHT11_Driver_Get(sensor_id)->start_us + 999U) / 1000U;
+}
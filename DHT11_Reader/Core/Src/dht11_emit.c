@@ -0,0 +1,174 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_emit.c
+ * @brief          : Emission policy between acquisition and the output sink.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "dht11_emit.h"
+#include "dht11_calib.h"
+#include <string.h>
+
+/**
+ * @brief What was last sent for one sensor.
+ */
+typedef struct {
+	uint8_t valid;           /*!< 0 until the first reading is sent */
+	uint8_t status;          /*!< dht11_status_t                    */
+	uint8_t temp_high;       /*!< Threshold state                   */
+	uint8_t hum_high;
+	int16_t temp;            /*!< Calibrated, tenths                */
+	int16_t hum;
+	uint32_t sent_ms;
+} emit_state_t;
+
+static dht11_emit_cfg_t emit_cfg;
+static emit_state_t emit_state[DHT11_EMIT_SENSORS];
+static uint32_t emit_suppressed = 0U;
+
+/**
+ * @brief Updates a threshold state; nonzero when it flipped.
+ */
+static uint8_t Emit_Cross(uint8_t *high, int16_t value, int16_t level,
+		int16_t hysteresis) {
+	if ((*high == 0U) && (value >= level)) {
+		*high = 1U;
+		return 1U;
+	}
+	if ((*high != 0U) && (value < (level - hysteresis))) {
+		*high = 0U;
+		return 1U;
+	}
+	return 0U;
+}
+
+/**
+ * @brief Absolute difference.
+ */
+static int16_t Emit_Diff(int16_t a, int16_t b) {
+	return (int16_t) ((a > b) ? (a - b) : (b - a));
+}
+
+/**
+ * @brief Restores the default policy.
+ */
+void DHT11_Emit_Init(void) {
+	dht11_emit_cfg_t cfg;
+
+	memset(&cfg, 0, sizeof(cfg));
+	cfg.mode = DHT11_EMIT_PERIODIC;
+	cfg.deadband_temp = 5;
+	cfg.deadband_hum = 20;
+	cfg.level_temp = 300;
+	cfg.level_hum = 700;
+	cfg.hysteresis = 10;
+	DHT11_Emit_SetConfig(&cfg);
+	emit_suppressed = 0U;
+}
+
+/**
+ * @brief Replaces the policy and forgets what was sent.
+ */
+void DHT11_Emit_SetConfig(const dht11_emit_cfg_t *cfg) {
+	emit_cfg = *cfg;
+	memset(emit_state, 0, sizeof(emit_state));
+}
+
+/**
+ * @brief Current policy.
+ */
+dht11_emit_cfg_t DHT11_Emit_GetConfig(void) {
+	return emit_cfg;
+}
+
+/**
+ * @brief Decides whether a reading goes to the sink.
+ */
+uint8_t DHT11_Emit_Decide(const dht11_reading_t *reading) {
+	dht11_values_t values = { 0 };
+	emit_state_t *st;
+	uint8_t send = 0U;
+	uint8_t good;
+	uint8_t crossed;
+
+	if (reading->sensor_id >= DHT11_EMIT_SENSORS) {
+		return 1U;
+	}
+	st = &emit_state[reading->sensor_id];
+	good = DHT11_Calib_Process(reading, &values);
+
+	crossed = 0U;
+	if ((emit_cfg.mode == DHT11_EMIT_THRESHOLD) && (good != 0U)) {
+		if (st->valid == 0U) {
+			/* Start from the side of each level the first reading is on */
+			st->temp_high = (values.temp >= emit_cfg.level_temp) ? 1U : 0U;
+			st->hum_high = (values.hum >= emit_cfg.level_hum) ? 1U : 0U;
+		} else {
+			/* Both states advance on every reading, sent or not */
+			crossed = Emit_Cross(&st->temp_high, values.temp,
+					emit_cfg.level_temp, emit_cfg.hysteresis);
+			crossed |= Emit_Cross(&st->hum_high, values.hum, emit_cfg.level_hum,
+					emit_cfg.hysteresis);
+		}
+	}
+
+	if ((st->valid == 0U) || (reading->status != st->status)) {
+		send = 1U;
+	} else if ((emit_cfg.heartbeat_ms != 0U)
+			&& ((reading->timestamp_ms - st->sent_ms) >= emit_cfg.heartbeat_ms)) {
+		send = 1U;
+	} else if (good != 0U) {
+		switch (emit_cfg.mode) {
+		case DHT11_EMIT_CHANGE:
+			send = ((Emit_Diff(values.temp, st->temp) >= emit_cfg.deadband_temp)
+					|| (Emit_Diff(values.hum, st->hum) >= emit_cfg.deadband_hum)) ?
+					1U : 0U;
+			break;
+		case DHT11_EMIT_THRESHOLD:
+			send = crossed;
+			break;
+		case DHT11_EMIT_PERIODIC:
+		default:
+			send = ((emit_cfg.period_ms == 0U)
+					|| ((reading->timestamp_ms - st->sent_ms) >= emit_cfg.period_ms)) ?
+					1U : 0U;
+			break;
+		}
+	}
+
+	if (send == 0U) {
+		emit_suppressed++;
+		return 0U;
+	}
+	st->valid = 1U;
+	st->status = (uint8_t) reading->status;
+	st->sent_ms = reading->timestamp_ms;
+	if (good != 0U) {
+		st->temp = values.temp;
+		st->hum = values.hum;
+	}
+	return 1U;
+}
+
+/**
+ * @brief Readings suppressed since DHT11_Emit_Init().
+ */
+uint32_t DHT11_Emit_GetSuppressed(void) {
+	return emit_suppressed;
+}
+
+/**
+ * @brief Printable mode name.
+ */
+const char* DHT11_Emit_ModeName(dht11_emit_mode_t mode) {
+	static const char *const names[] = { "periodic", "change", "threshold" };
+
+	if ((uint32_t) mode >= (sizeof(names) / sizeof(names[0]))) {
+		return "?";
+	}
+	return names[mode];
+}
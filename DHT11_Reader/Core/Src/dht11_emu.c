@@ -0,0 +1,347 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_emu.c
+ * @brief          : DHT11 emulator on PB10 for loopback decoder benchmarks.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "dht11_emu.h"
+#include "irq_prio.h"
+#include "clock_config.h"
+#include "dht11_async.h"
+#include "dht11_multi.h"
+#include "app_rtos.h"
+#include <stdio.h>
+#include <string.h>
+
+#if DHT11_EMU_USE_LOOPBACK
+
+/** Emulated data line, TIM2_CH3 */
+#define EMU_Pin             GPIO_PIN_10
+#define EMU_GPIO_Port       GPIOB
+#define EMU_EXTI_LINE       (1UL << 10)
+
+/** Edge timer, 1 MHz, and the stream that reloads its compare */
+#define EMU_TIM             (TIM2)
+#define EMU_TIM_HZ          (1000000U)
+#define EMU_DMA             (DMA1_Stream1)
+#define EMU_DMA_CH          (3U)       /* TIM2_UP / TIM2_CH3 */
+#define EMU_DMA_FLAGS       (DMA_LIFCR_CTCIF1 | DMA_LIFCR_CHTIF1 \
+		| DMA_LIFCR_CTEIF1 | DMA_LIFCR_CDMEIF1 | DMA_LIFCR_CFEIF1)
+
+/** OC3M: line released now, toggled per compare, released on compare */
+#define EMU_OC_FORCE_HIGH   (TIM_CCMR2_OC3M_2 | TIM_CCMR2_OC3M_0)
+#define EMU_OC_TOGGLE       (TIM_CCMR2_OC3M_1 | TIM_CCMR2_OC3M_0)
+#define EMU_OC_SET_HIGH     (TIM_CCMR2_OC3M_0)
+
+static dht11_emu_cfg_t emu_cfg;
+
+/** Edge times from the release, two tables: one plays, one is drawn */
+static uint32_t emu_edges[2][DHT11_EMU_EDGES];
+static volatile uint8_t emu_fill = 0U;   /* Table being drawn         */
+static volatile uint8_t emu_ready = 0U;  /* emu_fill holds a new draw */
+static uint8_t emu_play = 1U;            /* Table last played, ISR    */
+static volatile uint32_t emu_fall = 0U;  /* TIM2 count at the last LOW */
+static uint32_t emu_rand = 0x2545F491U;
+
+static dht11_emu_stats_t emu_stats;
+static uint32_t emu_run_start = 0U;
+#if DHT11_USE_ASYNC
+static uint32_t emu_saved_interval = 0U;
+#endif /* DHT11_USE_ASYNC */
+
+/**
+ * @brief Sets TIM2 to 1 MHz from the APB1 timer clock.
+ */
+static void Emu_TimerPrescaler(void) {
+	EMU_TIM->PSC = (Clock_GetApb1TimerHz() / EMU_TIM_HZ) - 1U;
+	EMU_TIM->EGR = TIM_EGR_UG;
+	EMU_TIM->SR = 0U;
+}
+
+/**
+ * @brief One segment with jitter applied (xorshift32).
+ */
+static uint32_t Emu_Segment(uint32_t us) {
+	uint32_t jitter = emu_cfg.jitter_us;
+	int32_t value;
+
+	if (jitter == 0U) {
+		return us;
+	}
+	emu_rand ^= emu_rand << 13;
+	emu_rand ^= emu_rand >> 17;
+	emu_rand ^= emu_rand << 5;
+	value = (int32_t) us + (int32_t) (emu_rand % ((2U * jitter) + 1U))
+			- (int32_t) jitter;
+	return (value < (int32_t) DHT11_EMU_SEGMENT_MIN) ?
+			DHT11_EMU_SEGMENT_MIN : (uint32_t) value;
+}
+
+/**
+ * @brief Draws the edge table of the next frame into emu_fill.
+ */
+static void Emu_Build(void) {
+	uint32_t *edges = emu_edges[emu_fill];
+	uint32_t t;
+	uint32_t i;
+	uint32_t bit;
+
+	t = Emu_Segment(emu_cfg.wait_us);
+	edges[0] = t;                             /* Response LOW  */
+	t += Emu_Segment(emu_cfg.resp_us);
+	edges[1] = t;                             /* Response HIGH */
+	t += Emu_Segment(emu_cfg.resp_us);
+	edges[2] = t;                             /* First preamble */
+	for (i = 0U; i < 40U; i++) {
+		bit = (emu_cfg.frame[i / 8U] >> (7U - (i % 8U))) & 1U;
+		t += Emu_Segment(emu_cfg.low_us);
+		edges[3U + (2U * i)] = t;
+		t += Emu_Segment((bit != 0U) ? emu_cfg.one_us : emu_cfg.zero_us);
+		edges[4U + (2U * i)] = t;
+	}
+	t += Emu_Segment(emu_cfg.low_us);
+	edges[DHT11_EMU_EDGES - 1U] = t;          /* Release */
+
+	__DMB();
+	emu_ready = 1U;
+}
+
+/**
+ * @brief Plays a frame from now: the counter restarts at the release and
+ *        the DMA feeds CCR3 one edge ahead.
+ */
+static void Emu_Play(void) {
+	const uint32_t *edges;
+
+	if (emu_ready != 0U) {
+		emu_play = emu_fill;
+		emu_fill ^= 1U;
+		emu_ready = 0U;
+	} else {
+		emu_stats.stale++; /* Poll loop fell behind: same jitter again */
+	}
+	edges = emu_edges[emu_play];
+
+	EXTI->IMR &= ~EMU_EXTI_LINE; /* Its own edges are no start pulses */
+	EMU_DMA->CR = 0U;
+	DMA1->LIFCR = EMU_DMA_FLAGS;
+	EMU_TIM->DIER = 0U;
+	EMU_TIM->CCMR2 = (EMU_TIM->CCMR2 & ~TIM_CCMR2_OC3M) | EMU_OC_FORCE_HIGH;
+	EMU_TIM->CNT = 0U;
+	EMU_TIM->CCR3 = edges[0];
+	EMU_TIM->SR = ~TIM_SR_CC3IF;
+	EMU_DMA->M0AR = (uint32_t) &edges[1];
+	EMU_DMA->NDTR = DHT11_EMU_EDGES - 1U;
+	EMU_DMA->CR = (EMU_DMA_CH << DMA_SxCR_CHSEL_Pos) | DMA_SxCR_PL_1
+			| DMA_SxCR_MSIZE_1 | DMA_SxCR_PSIZE_1 | DMA_SxCR_MINC
+			| DMA_SxCR_DIR_0 | DMA_SxCR_TCIE | DMA_SxCR_EN;
+	EMU_TIM->CCMR2 = (EMU_TIM->CCMR2 & ~TIM_CCMR2_OC3M) | EMU_OC_TOGGLE;
+	EMU_TIM->DIER = TIM_DIER_CC3DE;
+	emu_stats.frames_sent++;
+}
+
+/**
+ * @brief Restores the async refresh after a bench.
+ */
+static void Emu_EndRun(void) {
+#if DHT11_USE_ASYNC
+	DHT11_Async_SetInterval(emu_saved_interval);
+	if (emu_saved_interval != 0U) {
+		(void) DHT11_StartAsync();
+	}
+#endif /* DHT11_USE_ASYNC */
+}
+
+/**
+ * @brief Claims PB10, TIM2, DMA1 Stream1 and EXTI10.
+ */
+void DHT11_Emu_Init(void) {
+	static const dht11_emu_cfg_t nominal = { { 40U, 0U, 23U, 5U, 68U }, 30U,
+			80U, 50U, 26U, 70U, 0U };
+	GPIO_InitTypeDef GPIO_InitStruct = { 0 };
+
+	(void) memset(&emu_stats, 0, sizeof(emu_stats));
+	DHT11_Emu_SetConfig(&nominal);
+	Emu_Build();
+	emu_play = emu_fill;
+
+	__HAL_RCC_TIM2_CLK_ENABLE();
+	__HAL_RCC_DMA1_CLK_ENABLE();
+	__HAL_RCC_SYSCFG_CLK_ENABLE();
+	EMU_TIM->CR1 = 0U;
+	EMU_TIM->ARR = 0xFFFFFFFFU;
+	Emu_TimerPrescaler();
+	EMU_TIM->CCMR2 = EMU_OC_FORCE_HIGH;
+	EMU_TIM->CCER = TIM_CCER_CC3E;
+	EMU_TIM->CR1 = TIM_CR1_CEN;
+
+	/* Released before the pin is handed to the timer */
+	__HAL_RCC_GPIOB_CLK_ENABLE();
+	GPIO_InitStruct.Pin = EMU_Pin;
+	GPIO_InitStruct.Mode = GPIO_MODE_AF_OD;
+	GPIO_InitStruct.Pull = GPIO_NOPULL;
+	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+	GPIO_InitStruct.Alternate = GPIO_AF1_TIM2;
+	HAL_GPIO_Init(EMU_GPIO_Port, &GPIO_InitStruct);
+
+	EMU_DMA->CR = 0U;
+	EMU_DMA->PAR = (uint32_t) &EMU_TIM->CCR3;
+	DMA1->LIFCR = EMU_DMA_FLAGS;
+
+	SYSCFG->EXTICR[2] = (SYSCFG->EXTICR[2] & ~SYSCFG_EXTICR3_EXTI10)
+			| SYSCFG_EXTICR3_EXTI10_PB;
+	EXTI->RTSR |= EMU_EXTI_LINE;
+	EXTI->FTSR |= EMU_EXTI_LINE;
+	EXTI->EMR &= ~EMU_EXTI_LINE;
+	EXTI->PR = EMU_EXTI_LINE;
+	EXTI->IMR |= EMU_EXTI_LINE;
+
+	/* The response is due 20-40 us after the release */
+	HAL_NVIC_SetPriority(EXTI15_10_IRQn, IRQ_PRIO_CAPTURE, 0U);
+	HAL_NVIC_SetPriority(DMA1_Stream1_IRQn, IRQ_PRIO_UART, 0U);
+	HAL_NVIC_EnableIRQ(EXTI15_10_IRQn);
+	HAL_NVIC_EnableIRQ(DMA1_Stream1_IRQn);
+}
+
+/**
+ * @brief Replaces the frame and timing.
+ */
+void DHT11_Emu_SetConfig(const dht11_emu_cfg_t *cfg) {
+	emu_cfg = *cfg;
+	if (emu_cfg.jitter_us > DHT11_EMU_JITTER_MAX) {
+		emu_cfg.jitter_us = DHT11_EMU_JITTER_MAX;
+	}
+	emu_ready = 0U; /* The pending draw has the old settings */
+}
+
+/**
+ * @brief Current frame and timing.
+ */
+dht11_emu_cfg_t DHT11_Emu_GetConfig(void) {
+	return emu_cfg;
+}
+
+/**
+ * @brief Starts a bench of frames reads.
+ */
+uint8_t DHT11_Emu_Run(uint32_t frames) {
+#if APP_USE_RTOS || DHT11_USE_MULTI
+	(void) frames;
+	return 0U;
+#else
+	uint32_t sent = emu_stats.frames_sent;
+	uint32_t stale = emu_stats.stale;
+
+#if DHT11_USE_ASYNC
+	if (emu_stats.run_left == 0U) {
+		emu_saved_interval = DHT11_Async_GetInterval();
+	}
+	DHT11_Async_SetInterval(0U); /* The refresh in progress ends the cycle */
+#endif /* DHT11_USE_ASYNC */
+	(void) memset(&emu_stats, 0, sizeof(emu_stats));
+	emu_stats.frames_sent = sent;
+	emu_stats.stale = stale;
+	DHT11_Prof_Reset();
+	emu_run_start = HAL_GetTick();
+	emu_stats.run_left = frames;
+	if (frames == 0U) {
+		Emu_EndRun();
+	}
+	return 1U;
+#endif /* APP_USE_RTOS || DHT11_USE_MULTI */
+}
+
+/**
+ * @brief Draws the next edge table and reads one bench frame.
+ */
+void DHT11_Emu_Poll(void) {
+	uint8_t data[5] = { 0U };
+	dht11_status_t status;
+
+	if (emu_ready == 0U) {
+		Emu_Build();
+	}
+	if (emu_stats.run_left == 0U) {
+		return;
+	}
+#if DHT11_USE_ASYNC
+	if (DHT11_Async_GetIdleUs() != 0xFFFFFFFFU) {
+		return;
+	}
+#endif /* DHT11_USE_ASYNC */
+
+	status = DHT11_ReadOnce(data);
+	emu_stats.reads++;
+	if ((uint32_t) status < DHT11_PROF_STATUSES) {
+		emu_stats.status[status]++;
+	}
+	if (status == DHT11_OK) {
+		if (memcmp(data, emu_cfg.frame, sizeof(data)) == 0) {
+			emu_stats.ok++;
+		} else {
+			emu_stats.wrong++;
+		}
+	}
+	emu_stats.elapsed_ms = HAL_GetTick() - emu_run_start;
+	emu_stats.run_left--;
+	if (emu_stats.run_left == 0U) {
+		Emu_EndRun();
+		printf("emu done %lu reads %lu ok %lu wrong in %lu ms\r\n",
+				emu_stats.reads, emu_stats.ok, emu_stats.wrong,
+				emu_stats.elapsed_ms);
+	}
+}
+
+/**
+ * @brief Copies the counters.
+ */
+void DHT11_Emu_GetStats(dht11_emu_stats_t *stats) {
+	*stats = emu_stats;
+}
+
+/**
+ * @brief Recomputes the TIM2 prescaler.
+ */
+void DHT11_Emu_ClockChanged(void) {
+	Emu_TimerPrescaler();
+}
+
+/**
+ * @brief Host LOW start and release.
+ */
+void DHT11_Emu_ExtiIRQHandler(void) {
+	uint32_t now = EMU_TIM->CNT;
+
+	if ((EXTI->PR & EMU_EXTI_LINE) == 0U) {
+		return; /* Another line of EXTI15_10 (dht11_trigger.h) */
+	}
+	EXTI->PR = EMU_EXTI_LINE;
+	if ((EMU_GPIO_Port->IDR & EMU_Pin) == 0U) {
+		emu_fall = now;
+		return;
+	}
+	if ((now - emu_fall) >= DHT11_EMU_START_MIN_US) {
+		Emu_Play();
+	}
+}
+
+/**
+ * @brief Last edge time loaded.
+ */
+void DHT11_Emu_DmaIRQHandler(void) {
+	DMA1->LIFCR = EMU_DMA_FLAGS;
+	EMU_TIM->DIER = 0U;
+	/* The release is in CCR3: end on it, whether it has passed or not */
+	EMU_TIM->CCMR2 = (EMU_TIM->CCMR2 & ~TIM_CCMR2_OC3M) | EMU_OC_SET_HIGH;
+	/* Listen again; the final 50 us LOW is too short to start a frame */
+	emu_fall = EMU_TIM->CNT;
+	EXTI->PR = EMU_EXTI_LINE;
+	EXTI->IMR |= EMU_EXTI_LINE;
+}
+
+#endif /* DHT11_EMU_USE_LOOPBACK */
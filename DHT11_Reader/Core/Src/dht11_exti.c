@@ -0,0 +1,223 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_exti.c
+ * @brief          : EXTI edge-interrupt decoder for the DHT11 bit stream.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "dht11_exti.h"
+#include "timebase.h"
+#include "dht11_prof.h"
+#include "my_debug.h"
+#include "irq_prio.h"
+#include "dht11_driver.h"
+#include "dht11_trace.h"
+#include <stddef.h>
+
+#if DHT11_USE_EXTI
+
+/* Falling-edge cycle stamps, written by the EXTI handler */
+static volatile uint32_t exti_edges[DHT11_CAPTURE_EDGES];
+static volatile uint32_t exti_count = 0U;
+static volatile uint8_t exti_high = 1U;     /* Level after the last edge */
+static volatile uint8_t exti_lost = 0U;     /* An edge was missed        */
+static volatile uint8_t exti_busy = 0U;
+static volatile uint8_t exti_done = 0U;
+static dht11_exti_cb_t exti_cb = NULL;
+
+/**
+ * @brief Masks the line and clears a pending edge.
+ */
+static void DHT11_Exti_Stop(void) {
+	EXTI->IMR &= ~DHT11_EXTI_LINE;
+	EXTI->PR = DHT11_EXTI_LINE;
+}
+
+/**
+ * @brief Ends the frame and runs the hook.
+ */
+static void DHT11_Exti_Finish(void) {
+	DHT11_Exti_Stop();
+	exti_busy = 0U;
+	exti_done = 1U;
+	if (exti_cb != NULL) {
+		exti_cb();
+	}
+}
+
+/**
+ * @brief Routes PA1 to EXTI line 1 on both edges.
+ */
+void DHT11_Exti_Init(void) {
+	__HAL_RCC_SYSCFG_CLK_ENABLE();
+	DHT11_Exti_Stop();
+	SYSCFG->EXTICR[DHT11_PIN_NUM / 4U] &= ~(0xFUL << (4U * (DHT11_PIN_NUM % 4U))); /* Port A */
+	EXTI->RTSR |= DHT11_EXTI_LINE;
+	EXTI->FTSR |= DHT11_EXTI_LINE;
+	EXTI->EMR &= ~DHT11_EXTI_LINE;
+	HAL_NVIC_SetPriority(DHT11_EXTI_IRQn, IRQ_PRIO_CAPTURE, 0U);
+	HAL_NVIC_EnableIRQ(DHT11_EXTI_IRQn);
+}
+
+/**
+ * @brief Installs the completion hook.
+ */
+void DHT11_Exti_SetCallback(dht11_exti_cb_t cb) {
+	exti_cb = cb;
+}
+
+/**
+ * @brief Drives the data line LOW to begin the start pulse.
+ */
+void DHT11_Exti_DriveLow(void) {
+	DHT11_Pin_Low();
+	DHT11_Pin_ModeGpio();
+}
+
+/**
+ * @brief Releases the line, then unmasks the EXTI line.
+ */
+dht11_status_t DHT11_Exti_Arm(void) {
+	uint32_t basepri;
+
+	if (exti_busy != 0U) {
+		return DHT11_ERR_BUSY;
+	}
+	exti_count = 0U;
+	exti_high = 1U;
+	exti_lost = 0U;
+	exti_done = 0U;
+	exti_busy = 1U;
+
+	/* The rising edge of the release itself is cleared before unmasking;
+	 * the sensor answers 20-40 us later */
+	basepri = Irq_MaskFrom(IRQ_PRIO_TIMEBASE);
+	DHT11_Pin_Release();
+	__DSB();
+	EXTI->PR = DHT11_EXTI_LINE;
+	EXTI->IMR |= DHT11_EXTI_LINE;
+	Irq_Unmask(basepri);
+
+	return DHT11_OK;
+}
+
+/**
+ * @brief Masks the line and drops the frame.
+ */
+void DHT11_Exti_Abort(void) {
+	DHT11_Exti_Stop();
+	exti_busy = 0U;
+}
+
+/**
+ * @brief Reports whether the frame has ended.
+ */
+uint8_t DHT11_Exti_IsComplete(void) {
+	return exti_done;
+}
+
+/**
+ * @brief Falling edges stamped so far.
+ */
+uint32_t DHT11_Exti_EdgeCount(void) {
+	return exti_count;
+}
+
+/**
+ * @brief Converts the stamps to microseconds and decodes them.
+ */
+dht11_status_t DHT11_Exti_Decode(uint8_t data[5]) {
+	uint32_t edges[DHT11_CAPTURE_EDGES];
+	uint32_t cycles_per_us = Timebase_CyclesPerUs();
+	dht11_status_t status;
+	uint32_t i;
+
+	/* Falling edges only, from the first */
+	if (DHT11_TRACE_BEGIN(0U, 0U) != 0U) {
+		for (i = 0U; (i < exti_count) && (i < DHT11_CAPTURE_EDGES); i++) {
+			DHT11_TRACE_EDGE((exti_edges[i] - exti_edges[0]) / cycles_per_us);
+		}
+	}
+	if ((exti_lost != 0U) || (exti_count < DHT11_CAPTURE_EDGES)) {
+		DEBUG_ERROR("DHT11 exti: edge lost after %lu falling edges\r\n",
+				exti_count);
+		DHT11_TRACE_END(DHT11_ERR_FRAME);
+		return DHT11_ERR_FRAME;
+	}
+	for (i = 0U; i < DHT11_CAPTURE_EDGES; i++) {
+		/* Relative to the first edge, so a CYCCNT wrap does not matter */
+		edges[i] = (exti_edges[i] - exti_edges[0]) / cycles_per_us;
+	}
+	status = DHT11_Capture_DecodeEdges(edges, 0U, data);
+	DHT11_TRACE_END(status);
+	return status;
+}
+
+/**
+ * @brief Blocking transaction through the EXTI decoder.
+ */
+dht11_status_t DHT11_Exti_Read(uint8_t data[5]) {
+	dht11_status_t status;
+	uint32_t startTick;
+	uint32_t edges;
+
+	/* Pull LOW for the sensor type's start pulse, ≥18 ms for a DHT11 */
+	DHT11_PROF_BEGIN();
+	DHT11_Exti_DriveLow();
+	HAL_Delay(DHT11_Driver_StartMs(0U));
+
+	status = DHT11_Exti_Arm();
+	if (status != DHT11_OK) {
+		return status;
+	}
+	DHT11_PROF_MARK(DHT11_PROF_START);
+
+	startTick = HAL_GetTick();
+	while (DHT11_Exti_IsComplete() == 0U) {
+		if ((HAL_GetTick() - startTick) >= DHT11_CAPTURE_TIMEOUT_MS) {
+			edges = DHT11_Exti_EdgeCount();
+			DHT11_Exti_Abort();
+			DEBUG_ERROR("DHT11 exti timeout after %lu edges\r\n", edges);
+			return (edges == 0U) ? DHT11_ERR_NO_RESPONSE : DHT11_ERR_TIMEOUT;
+		}
+	}
+
+	DHT11_PROF_MARK(DHT11_PROF_DATA); /* Includes the response */
+	status = DHT11_Exti_Decode(data);
+	DHT11_PROF_MARK(DHT11_PROF_CHECKSUM);
+	return status;
+}
+
+/**
+ * @brief Stamps one edge.
+ */
+void DHT11_Exti_IRQHandler(void) {
+	uint32_t now = DWT->CYCCNT;
+	uint8_t high;
+
+	EXTI->PR = DHT11_EXTI_LINE;
+	if (exti_busy == 0U) {
+		return;
+	}
+	high = (DHT11_Pin_Read() != 0U) ? 1U : 0U;
+	if (high == exti_high) {
+		/* Two edges merged into one interrupt */
+		exti_lost = 1U;
+		DHT11_Exti_Finish();
+		return;
+	}
+	exti_high = high;
+	if (high == 0U) {
+		exti_edges[exti_count] = now;
+		exti_count++;
+		if (exti_count >= DHT11_CAPTURE_EDGES) {
+			DHT11_Exti_Finish();
+		}
+	}
+}
+
+#endif /* DHT11_USE_EXTI */
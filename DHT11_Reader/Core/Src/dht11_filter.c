@@ -0,0 +1,288 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_filter.c
+ * @brief          : Streaming median, Hampel and EMA filter stage for
+ *                   readings.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "dht11_filter.h"
+#include "dht11_delta.h"
+#include <string.h>
+
+/** Quantities filtered per sensor */
+#define FILTER_TEMP  (0U)
+#define FILTER_HUM   (1U)
+
+/** MAD to standard deviation of a normal distribution, * 1000 */
+#define FILTER_MAD_SCALE (1483U)
+
+_Static_assert((DHT11_FILTER_WINDOW_MAX & 1U) != 0U,
+		"DHT11_FILTER_WINDOW_MAX must be odd");
+
+/**
+ * @brief Window of one quantity.
+ */
+typedef struct {
+	int16_t ring[DHT11_FILTER_WINDOW_MAX];    /*!< Arrival order   */
+	int16_t sorted[DHT11_FILTER_WINDOW_MAX];  /*!< Same, ascending */
+	uint8_t head;        /*!< Next ring slot            */
+	uint8_t count;       /*!< Values in the window      */
+	uint8_t ema_valid;
+	int32_t ema;         /*!< Q16.16 tenths             */
+} filter_chan_t;
+
+/**
+ * @brief State of one sensor.
+ */
+typedef struct {
+	dht11_filter_cfg_t cfg;
+	filter_chan_t chan[2];
+	uint32_t rejected;
+} filter_sensor_t;
+
+static filter_sensor_t filter_sensors[DHT11_FILTER_SENSORS];
+
+static const int16_t filter_min_dev[2] = { DHT11_FILTER_MIN_DEV_TEMP,
+		DHT11_FILTER_MIN_DEV_HUM };
+
+/**
+ * @brief Default configuration.
+ */
+static dht11_filter_cfg_t Filter_Default(void) {
+	dht11_filter_cfg_t cfg;
+
+	cfg.window = DHT11_FILTER_DEFAULT_WINDOW;
+	cfg.median = 0U;
+	cfg.hampel_k = DHT11_FILTER_DEFAULT_HAMPEL_K;
+	cfg.ema_alpha = DHT11_FILTER_ONE;
+	return cfg;
+}
+
+/**
+ * @brief First index in sorted[0..count) whose value is >= v.
+ */
+static uint32_t Filter_LowerBound(const int16_t *sorted, uint32_t count,
+		int16_t v) {
+	uint32_t lo = 0U;
+	uint32_t hi = count;
+	uint32_t mid;
+
+	while (lo < hi) {
+		mid = (lo + hi) / 2U;
+		if (sorted[mid] < v) {
+			lo = mid + 1U;
+		} else {
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+/**
+ * @brief Median of the window, tenths; mean of the middle pair if even.
+ */
+static int32_t Filter_Median(const filter_chan_t *c) {
+	uint32_t mid = ((uint32_t) c->count - 1U) / 2U;
+
+	if ((c->count & 1U) != 0U) {
+		return c->sorted[mid];
+	}
+	return ((int32_t) c->sorted[mid] + c->sorted[mid + 1U]) / 2;
+}
+
+/**
+ * @brief Median absolute deviation from median: the deviations on either
+ *        side of the median are already sorted, so merge outwards.
+ */
+static int32_t Filter_Mad(const filter_chan_t *c, int32_t median) {
+	int32_t l = ((int32_t) c->count - 1) / 2;
+	int32_t r = l + 1;
+	int32_t dev = 0;
+	int32_t dl;
+	int32_t dr;
+	uint32_t i;
+
+	for (i = 0U; i <= ((uint32_t) c->count - 1U) / 2U; i++) {
+		dl = (l >= 0) ? (median - c->sorted[l]) : INT32_MAX;
+		dr = (r < (int32_t) c->count) ? (c->sorted[r] - median) : INT32_MAX;
+		if (dl <= dr) {
+			dev = dl;
+			l--;
+		} else {
+			dev = dr;
+			r++;
+		}
+	}
+	return dev;
+}
+
+/**
+ * @brief Adds a value, dropping the oldest once the window is full.
+ */
+static void Filter_Push(filter_chan_t *c, uint32_t window, int16_t v) {
+	uint32_t pos;
+
+	if (c->count >= window) {
+		pos = Filter_LowerBound(c->sorted, c->count, c->ring[c->head]);
+		memmove(&c->sorted[pos], &c->sorted[pos + 1U],
+				((uint32_t) c->count - pos - 1U) * sizeof(c->sorted[0]));
+		c->count--;
+	}
+	pos = Filter_LowerBound(c->sorted, c->count, v);
+	memmove(&c->sorted[pos + 1U], &c->sorted[pos],
+			((uint32_t) c->count - pos) * sizeof(c->sorted[0]));
+	c->sorted[pos] = v;
+	c->count++;
+	c->ring[c->head] = v;
+	c->head = (uint8_t) ((c->head + 1U) % window);
+}
+
+/**
+ * @brief Runs one value through the stage.
+ * @param outlier: Set to 1 if the Hampel test replaced v.
+ */
+static int16_t Filter_Step(const dht11_filter_cfg_t *cfg, filter_chan_t *c,
+		int16_t min_dev, int16_t v, uint8_t *outlier) {
+	int32_t out = v;
+	int32_t median;
+	int32_t thr;
+	int32_t dev;
+
+	*outlier = 0U;
+	if ((cfg->hampel_k != 0U) && (c->count >= 3U)) {
+		median = Filter_Median(c);
+		thr = (int32_t) (((uint32_t) Filter_Mad(c, median) * cfg->hampel_k
+				* FILTER_MAD_SCALE + 5000U) / 10000U);
+		if (thr < min_dev) {
+			thr = min_dev;
+		}
+		dev = (v > median) ? (v - median) : (median - v);
+		if (dev > thr) {
+			out = median;
+			*outlier = 1U;
+		}
+	}
+
+	/* The raw value enters the window either way, so a lasting step wins */
+	Filter_Push(c, cfg->window, v);
+	if ((cfg->median != 0U) && (*outlier == 0U)) {
+		out = Filter_Median(c);
+	}
+
+	if (cfg->ema_alpha < DHT11_FILTER_ONE) {
+		if (c->ema_valid == 0U) {
+			c->ema = out * DHT11_FILTER_ONE;
+			c->ema_valid = 1U;
+		} else {
+			c->ema += (int32_t) (((int64_t) cfg->ema_alpha
+					* ((out * DHT11_FILTER_ONE) - c->ema)) >> 16);
+		}
+		out = (c->ema + (DHT11_FILTER_ONE / 2)) >> 16;
+	}
+	return (int16_t) out;
+}
+
+/**
+ * @brief Writes humidity and temperature tenths back as DHT11 bytes.
+ */
+static void Filter_Store(dht11_reading_t *reading, int16_t hum, int16_t temp) {
+	uint16_t mag = (uint16_t) ((temp < 0) ? -temp : temp);
+
+	if (hum < 0) {
+		hum = 0;
+	}
+	reading->raw[0] = (uint8_t) (hum / 10);
+	reading->raw[1] = (uint8_t) (hum % 10);
+	reading->raw[2] = (uint8_t) (mag / 10U);
+	reading->raw[3] = (uint8_t) ((mag % 10U) | ((temp < 0) ? 0x80U : 0U));
+	reading->raw[4] = (uint8_t) (reading->raw[0] + reading->raw[1]
+			+ reading->raw[2] + reading->raw[3]);
+}
+
+/**
+ * @brief Applies the default configuration to every sensor.
+ */
+void DHT11_Filter_Init(void) {
+	dht11_filter_cfg_t cfg = Filter_Default();
+	uint32_t i;
+
+	memset(filter_sensors, 0, sizeof(filter_sensors));
+	for (i = 0U; i < DHT11_FILTER_SENSORS; i++) {
+		filter_sensors[i].cfg = cfg;
+	}
+}
+
+/**
+ * @brief Sets one sensor's configuration and empties its windows.
+ */
+uint8_t DHT11_Filter_SetConfig(uint8_t sensor_id, const dht11_filter_cfg_t *cfg) {
+	filter_sensor_t *s;
+
+	if ((sensor_id >= DHT11_FILTER_SENSORS) || (cfg->window == 0U)
+			|| (cfg->window > DHT11_FILTER_WINDOW_MAX)
+			|| ((cfg->window & 1U) == 0U) || (cfg->ema_alpha <= 0)
+			|| (cfg->ema_alpha > DHT11_FILTER_ONE)) {
+		return 0U;
+	}
+	s = &filter_sensors[sensor_id];
+	memset(s->chan, 0, sizeof(s->chan));
+	s->cfg = *cfg;
+	return 1U;
+}
+
+/**
+ * @brief Configuration of one sensor.
+ */
+dht11_filter_cfg_t DHT11_Filter_GetConfig(uint8_t sensor_id) {
+	if (sensor_id >= DHT11_FILTER_SENSORS) {
+		return Filter_Default();
+	}
+	return filter_sensors[sensor_id].cfg;
+}
+
+/**
+ * @brief Filters a good reading in place.
+ */
+uint8_t DHT11_Filter_Apply(dht11_reading_t *reading) {
+	filter_sensor_t *s;
+	uint8_t temp_out;
+	uint8_t hum_out;
+	int16_t temp_in;
+	int16_t hum_in;
+	int16_t temp;
+	int16_t hum;
+
+	if ((reading->status != DHT11_OK)
+			|| (reading->sensor_id >= DHT11_FILTER_SENSORS)) {
+		return 0U;
+	}
+	s = &filter_sensors[reading->sensor_id];
+	temp_in = DHT11_Delta_TempTenths(reading);
+	hum_in = DHT11_Delta_HumTenths(reading);
+	temp = Filter_Step(&s->cfg, &s->chan[FILTER_TEMP],
+			filter_min_dev[FILTER_TEMP], temp_in, &temp_out);
+	hum = Filter_Step(&s->cfg, &s->chan[FILTER_HUM], filter_min_dev[FILTER_HUM],
+			hum_in, &hum_out);
+	if ((temp != temp_in) || (hum != hum_in)) {
+		Filter_Store(reading, hum, temp);
+	}
+
+	if ((temp_out | hum_out) != 0U) {
+		s->rejected++;
+		return 1U;
+	}
+	return 0U;
+}
+
+/**
+ * @brief Outliers replaced for one sensor.
+ */
+uint32_t DHT11_Filter_GetRejected(uint8_t sensor_id) {
+	return (sensor_id < DHT11_FILTER_SENSORS) ?
+			filter_sensors[sensor_id].rejected : 0U;
+}
@@ -0,0 +1,209 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_health.c
+ * @brief          : Per-sensor retry policy and health state machine.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "dht11_health.h"
+#include "my_debug.h"
+#include "dht11_driver.h"
+#include "dht11_supply.h"
+#include "dht11_discover.h"
+
+/**
+ * @brief Runtime state of one sensor.
+ */
+typedef struct {
+	dht11_policy_t policy;
+	dht11_health_t health;
+	uint32_t failures;   /*!< Failed readings in a row */
+	uint32_t successes;  /*!< Good readings in a row   */
+} dht11_health_ctx_t;
+
+static const dht11_policy_t health_default_policy = {
+	DHT11_READ_RETRIES, 0U, DHT11_HEALTH_FAIL_THRESHOLD,
+	DHT11_HEALTH_RECOVER_COUNT, DHT11_HEALTH_MIN_SPACING_MS,
+	DHT11_HEALTH_BACKOFF_BASE_MS, DHT11_HEALTH_BACKOFF_MAX_MS
+};
+
+static dht11_health_ctx_t health_ctx[DHT11_HEALTH_SENSORS];
+
+/**
+ * @brief Returns the context of a sensor; out-of-range maps to sensor 0.
+ */
+static dht11_health_ctx_t* DHT11_Health_Ctx(uint32_t sensor) {
+	if (sensor >= DHT11_HEALTH_SENSORS) {
+		sensor = 0U;
+	}
+	return &health_ctx[sensor];
+}
+
+/**
+ * @brief base << shift, capped, without overflowing.
+ */
+static uint32_t DHT11_Health_Backoff(const dht11_policy_t *policy,
+		uint32_t shift, uint32_t spacing) {
+	uint32_t delay = policy->backoff_base_ms;
+
+	while ((shift != 0U) && (delay < policy->backoff_max_ms)) {
+		delay <<= 1;
+		shift--;
+	}
+	if (delay > policy->backoff_max_ms) {
+		delay = policy->backoff_max_ms;
+	}
+	if (delay < spacing) {
+		delay = spacing;
+	}
+	return delay;
+}
+
+/**
+ * @brief Applies the default policy to every sensor and marks them OK.
+ */
+void DHT11_Health_Init(void) {
+	uint32_t i;
+
+	for (i = 0U; i < DHT11_HEALTH_SENSORS; i++) {
+		health_ctx[i].policy = health_default_policy;
+		health_ctx[i].health = DHT11_HEALTH_OK;
+		health_ctx[i].failures = 0U;
+		health_ctx[i].successes = 0U;
+	}
+}
+
+/**
+ * @brief Replaces the retry policy of a sensor.
+ */
+void DHT11_Health_SetPolicy(uint32_t sensor, const dht11_policy_t *policy) {
+	DHT11_Health_Ctx(sensor)->policy = *policy;
+}
+
+/**
+ * @brief Returns the retry policy of a sensor.
+ */
+const dht11_policy_t* DHT11_Health_GetPolicy(uint32_t sensor) {
+	return &DHT11_Health_Ctx(sensor)->policy;
+}
+
+/**
+ * @brief Shortest start-to-start spacing: the policy's or the sensor
+ *        type's (dht11_driver.h), whichever is longer.
+ */
+uint32_t DHT11_Health_MinSpacingMs(uint32_t sensor) {
+	uint32_t spacing = DHT11_Health_Ctx(sensor)->policy.min_spacing_ms;
+	uint32_t type_ms = DHT11_Driver_Get((uint8_t) sensor)->min_interval_ms;
+
+	return (type_ms > spacing) ? type_ms : spacing;
+}
+
+/**
+ * @brief Decides whether a failed attempt is retried.
+ */
+uint32_t DHT11_Health_RetryDelayMs(uint32_t sensor, dht11_status_t status,
+		uint8_t retries) {
+	const dht11_health_ctx_t *ctx = DHT11_Health_Ctx(sensor);
+
+	if ((status == DHT11_OK) || (retries >= ctx->policy.max_retries)
+			|| (ctx->health == DHT11_HEALTH_FAILED)
+			|| DHT11_DISCOVER_IS_ABSENT(sensor)) {
+		return 0U;
+	}
+	/* A missing sensor will not answer a retry either */
+	if ((status == DHT11_ERR_NO_RESPONSE) && (ctx->policy.retry_no_response == 0U)) {
+		return 0U;
+	}
+	return DHT11_Health_Backoff(&ctx->policy, retries,
+			DHT11_Health_MinSpacingMs(sensor));
+}
+
+/**
+ * @brief Feeds the final status of a reading into the state machine.
+ */
+void DHT11_Health_Report(uint32_t sensor, dht11_status_t status) {
+	dht11_health_ctx_t *ctx = DHT11_Health_Ctx(sensor);
+	dht11_health_t before = ctx->health;
+
+	if (status == DHT11_OK) {
+		ctx->failures = 0U;
+		ctx->successes++;
+		if (ctx->health == DHT11_HEALTH_FAILED) {
+			ctx->health = DHT11_HEALTH_DEGRADED;
+		} else if (ctx->successes >= ctx->policy.recover_count) {
+			ctx->health = DHT11_HEALTH_OK;
+		}
+	} else {
+		ctx->successes = 0U;
+		ctx->failures++;
+		if (ctx->failures >= ctx->policy.fail_threshold) {
+			ctx->health = DHT11_HEALTH_FAILED;
+		} else {
+			ctx->health = DHT11_HEALTH_DEGRADED;
+		}
+	}
+
+	if (ctx->health != before) {
+		DEBUG_WARN("DHT11 sensor %lu: %s -> %s\r\n", sensor,
+				DHT11_Health_Name(before), DHT11_Health_Name(ctx->health));
+	}
+	DHT11_DISCOVER_REPORT(sensor, status);
+#if DHT11_USE_SUPPLY
+	/* Gate it until the next reading, or power-cycle a latched sensor */
+	DHT11_Supply_Report(sensor, status);
+#endif /* DHT11_USE_SUPPLY */
+}
+
+/**
+ * @brief Start-to-start period until the next reading.
+ */
+uint32_t DHT11_Health_NextIntervalMs(uint32_t sensor, uint32_t nominal_ms) {
+	const dht11_health_ctx_t *ctx = DHT11_Health_Ctx(sensor);
+	uint32_t spacing = DHT11_Health_MinSpacingMs(sensor);
+	uint32_t probe;
+
+	if (nominal_ms < spacing) {
+		nominal_ms = spacing;
+	}
+	if (DHT11_DISCOVER_IS_ABSENT(sensor)) {
+		/* Empty header (dht11_discover.h): recheck it now and then */
+		return (nominal_ms > DHT11_DISCOVER_RECHECK_MS) ?
+				nominal_ms : DHT11_DISCOVER_RECHECK_MS;
+	}
+	if (ctx->health != DHT11_HEALTH_FAILED) {
+		return nominal_ms;
+	}
+	probe = DHT11_Health_Backoff(&ctx->policy,
+			ctx->failures - ctx->policy.fail_threshold, spacing);
+	return (probe > nominal_ms) ? probe : nominal_ms;
+}
+
+/**
+ * @brief Current health of a sensor.
+ */
+dht11_health_t DHT11_Health_Get(uint32_t sensor) {
+	return DHT11_Health_Ctx(sensor)->health;
+}
+
+/**
+ * @brief Failed readings in a row.
+ */
+uint32_t DHT11_Health_GetFailures(uint32_t sensor) {
+	return DHT11_Health_Ctx(sensor)->failures;
+}
+
+/**
+ * @brief Short printable name of a health state.
+ */
+const char* DHT11_Health_Name(dht11_health_t health) {
+	static const char *const names[] = { "ok", "degraded", "failed" };
+
+	if ((uint32_t) health >= (sizeof(names) / sizeof(names[0]))) {
+		return "?";
+	}
+	return names[health];
+}
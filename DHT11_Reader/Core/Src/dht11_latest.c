@@ -0,0 +1,66 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_latest.c
+ * @brief          : Latest state of every sensor, published through
+ *                   seqlock.h.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "dht11_latest.h"
+#include "seqlock.h"
+#include <string.h>
+
+SEQLOCK_DEFINE(dht11_latest_lock_t, DHT11_LatestLock, dht11_latest_t)
+
+static dht11_latest_lock_t latest_lock[DHT11_LATEST_SENSORS];
+
+/** Writer-side copy each publication starts from */
+static dht11_latest_t latest_stage[DHT11_LATEST_SENSORS];
+
+/**
+ * @brief Forgets every sensor.
+ */
+void DHT11_Latest_Init(void) {
+	uint32_t i;
+
+	(void) memset(latest_stage, 0, sizeof(latest_stage));
+	for (i = 0U; i < DHT11_LATEST_SENSORS; i++) {
+		DHT11_LatestLock_Init(&latest_lock[i]);
+	}
+}
+
+/**
+ * @brief Publishes a reading of its sensor.
+ */
+void DHT11_Latest_Publish(const dht11_reading_t *reading) {
+	dht11_latest_t *stage;
+	dht11_values_t values;
+
+	if (reading->sensor_id >= DHT11_LATEST_SENSORS) {
+		return;
+	}
+	stage = &latest_stage[reading->sensor_id];
+	stage->reading = *reading;
+	stage->failures = DHT11_Health_GetFailures(reading->sensor_id);
+	stage->health = DHT11_Health_Get(reading->sensor_id);
+	if (DHT11_Calib_Process(reading, &values) != 0U) {
+		stage->values = values;
+		stage->good_ms = reading->timestamp_ms;
+		stage->has_values = 1U;
+	}
+	DHT11_LatestLock_Write(&latest_lock[reading->sensor_id], stage);
+}
+
+/**
+ * @brief Copies a sensor's latest state.
+ */
+uint32_t DHT11_Latest_Get(uint8_t sensor_id, dht11_latest_t *entry) {
+	if (sensor_id >= DHT11_LATEST_SENSORS) {
+		return 0U;
+	}
+	return DHT11_LatestLock_Read(&latest_lock[sensor_id], entry);
+}
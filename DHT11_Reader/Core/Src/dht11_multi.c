@@ -0,0 +1,549 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_multi.c
+ * @brief          : Parallel acquisition of up to 8 DHT11 sensors on up to
+ *                   four GPIO ports, by timer-triggered DMA sampling of
+ *                   their IDRs. Slot 0's stream is the HAL one CubeMX
+ *                   generates; the others are driven on their registers.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "dht11_multi.h"
+#include "dht11_capture.h"
+#include "clock_config.h"
+#include "my_debug.h"
+#include "dht11_prof.h"
+#include "dht11_health.h"
+#include "dht11_driver.h"
+#include "dht11_trace.h"
+#include "memmap.h"
+
+#if DHT11_USE_MULTI
+
+extern TIM_HandleTypeDef htim1;
+
+#define MULTI_PIN_ENTRY(ch, slot, num)  [ch] = (uint16_t) DHT11_PIN_MASK(num),
+#define MULTI_SLOT_ENTRY(ch, slot, num) [ch] = (uint8_t) (slot),
+#define MULTI_PIN_COUNT(ch, slot, num)  + 1U
+#define MULTI_SLOT_MAX(ch, slot, num)   | (((slot) >= DHT11_MULTI_PORTS) ? 1U : 0U)
+
+_Static_assert((0U DHT11_MULTI_PINS(MULTI_PIN_COUNT)) == DHT11_MULTI_CHANNELS,
+		"DHT11_MULTI_PINS must list every channel");
+_Static_assert((0U DHT11_MULTI_PINS(MULTI_SLOT_MAX)) == 0U,
+		"DHT11_MULTI_PINS slots must be below DHT11_MULTI_PORTS");
+
+static const uint16_t multi_pins[DHT11_MULTI_CHANNELS] = {
+		DHT11_MULTI_PINS(MULTI_PIN_ENTRY) };
+static const uint8_t multi_slot[DHT11_MULTI_CHANNELS] = {
+		DHT11_MULTI_PINS(MULTI_SLOT_ENTRY) };
+
+/**
+ * @brief A port slot: its GPIO, the DMA2 stream that samples it and the
+ *        TIM1 request that paces that stream.
+ */
+typedef struct {
+	GPIO_TypeDef *port;
+	DMA_Stream_TypeDef *stream;
+	uint8_t stream_num;
+	uint16_t request;           /*!< TIM1 DIER DMA request enable bit */
+} multi_slot_hw_t;
+
+static const multi_slot_hw_t multi_hw[4] = {
+		{ DHT11_MULTI_PORT_0, DMA2_Stream5, 5U, TIM_DIER_UDE },
+		{ DHT11_MULTI_PORT_1, DMA2_Stream3, 3U, TIM_DIER_CC1DE },
+		{ DHT11_MULTI_PORT_2, DMA2_Stream2, 2U, TIM_DIER_CC2DE },
+		{ DHT11_MULTI_PORT_3, DMA2_Stream6, 6U, TIM_DIER_CC3DE } };
+
+/* TIM1 requests of every slot in use */
+#define MULTI_REQUESTS  (TIM_DIER_UDE \
+		| ((DHT11_MULTI_PORTS > 1U) ? TIM_DIER_CC1DE : 0U) \
+		| ((DHT11_MULTI_PORTS > 2U) ? TIM_DIER_CC2DE : 0U) \
+		| ((DHT11_MULTI_PORTS > 3U) ? TIM_DIER_CC3DE : 0U))
+
+/* IDR snapshots, one buffer per port per frame in flight */
+static volatile uint16_t multi_samples[DHT11_MULTI_BUFFERS][DHT11_MULTI_PORTS][DHT11_MULTI_SAMPLES] DMA_BUFFER;
+
+/* Pins of every channel on each port */
+static uint16_t multi_port_mask[DHT11_MULTI_PORTS];
+
+/** Life of a sample buffer */
+#define MULTI_FREE      (0U)   /* Collected, may be reused   */
+#define MULTI_PULSE     (1U)   /* Channels held LOW          */
+#define MULTI_SAMPLING  (2U)   /* DMA filling it             */
+#define MULTI_FULL      (3U)   /* Window ended, not collected */
+
+/**
+ * @brief One frame and the buffer it samples into.
+ */
+typedef struct {
+	uint32_t channels;          /*!< Channels pulsed                    */
+	uint32_t start_ms;          /*!< HAL tick at the start of the pulse */
+	uint32_t pulse_ms;          /*!< Start pulse length                 */
+	volatile uint8_t state;     /*!< MULTI_FREE .. MULTI_FULL           */
+	dht11_status_t status;      /*!< Window result if not DHT11_OK      */
+} multi_frame_t;
+
+static multi_frame_t multi_frames[DHT11_MULTI_BUFFERS];
+
+/* Port pins held LOW while their sensors are unpowered */
+static uint16_t multi_held[DHT11_MULTI_PORTS];
+
+/* Buffer of the frame begun last, and the one filled last */
+static uint8_t multi_fill = 0U;
+static volatile uint8_t multi_last = 0U;
+
+/**
+ * @brief Clears every event flag of a DMA2 stream.
+ */
+static void DHT11_Multi_ClearStream(uint32_t num) {
+	static const uint8_t shift[4] = { 0U, 6U, 16U, 22U };
+	uint32_t flags = 0x3DUL << shift[num & 3U];
+
+	if (num < 4U) {
+		DMA2->LIFCR = flags;
+	} else {
+		DMA2->HIFCR = flags;
+	}
+}
+
+/**
+ * @brief Reports a transfer error on a DMA2 stream.
+ */
+static uint8_t DHT11_Multi_StreamError(uint32_t num) {
+	static const uint8_t shift[4] = { 0U, 6U, 16U, 22U };
+	uint32_t isr = (num < 4U) ? DMA2->LISR : DMA2->HISR;
+
+	return ((isr & (DMA_LISR_TEIF0 << shift[num & 3U])) != 0U) ? 1U : 0U;
+}
+
+/**
+ * @brief Disables the streams of slots 1 and up.
+ */
+static void DHT11_Multi_StopSlots(void) {
+	uint32_t s;
+
+	for (s = 1U; s < DHT11_MULTI_PORTS; s++) {
+		multi_hw[s].stream->CR &= ~DMA_SxCR_EN;
+		while ((multi_hw[s].stream->CR & DMA_SxCR_EN) != 0U) {
+			/* Clears once the halfword in transfer is written */
+		}
+	}
+}
+
+/**
+ * @brief Stops the sampling trigger.
+ */
+static void DHT11_Multi_Stop(void) {
+	htim1.Instance->DIER &= ~MULTI_REQUESTS;
+	__HAL_TIM_DISABLE(&htim1);
+}
+
+/**
+ * @brief Checks that the other ports' windows filled with slot 0's: their
+ *        requests come 1 us before its own, so they are done by now.
+ */
+static dht11_status_t DHT11_Multi_SlotsStatus(void) {
+	dht11_status_t status = DHT11_OK;
+	uint32_t s;
+
+	for (s = 1U; s < DHT11_MULTI_PORTS; s++) {
+		if ((multi_hw[s].stream->NDTR != 0U)
+				|| (DHT11_Multi_StreamError(multi_hw[s].stream_num) != 0U)) {
+			status = DHT11_ERR_TIMEOUT;
+		}
+	}
+	DHT11_Multi_StopSlots();
+	return status;
+}
+
+/**
+ * @brief DMA transfer-complete callback: the frame's window is filled and
+ *        the next Begin() takes the other buffer.
+ */
+static void DHT11_Multi_DmaCplt(DMA_HandleTypeDef *hdma) {
+	(void) hdma;
+	DHT11_Multi_Stop();
+	multi_frames[multi_fill].status = DHT11_Multi_SlotsStatus();
+	multi_frames[multi_fill].state = MULTI_FULL;
+	multi_last = multi_fill;
+}
+
+/**
+ * @brief DMA error callback: the window is dropped.
+ */
+static void DHT11_Multi_DmaError(DMA_HandleTypeDef *hdma) {
+	(void) hdma;
+	DHT11_Multi_Stop();
+	DHT11_Multi_StopSlots();
+	multi_frames[multi_fill].status = DHT11_ERR_TIMEOUT;
+	multi_frames[multi_fill].state = MULTI_FULL;
+}
+
+/**
+ * @brief Ends a window that has not filled in time.
+ */
+static void DHT11_Multi_Expire(void) {
+	multi_frame_t *f = &multi_frames[multi_fill];
+
+	if ((f->state != MULTI_SAMPLING) || ((HAL_GetTick() - f->start_ms)
+			< (f->pulse_ms + DHT11_CAPTURE_TIMEOUT_MS))) {
+		return;
+	}
+	DHT11_Multi_Stop();
+	(void) HAL_DMA_Abort(htim1.hdma[TIM_DMA_ID_UPDATE]);
+	DHT11_Multi_StopSlots();
+	f->status = DHT11_ERR_TIMEOUT;
+	f->state = MULTI_FULL;
+}
+
+/**
+ * @brief Demultiplexes and decodes one channel of a frame's buffers.
+ */
+static dht11_status_t DHT11_Multi_DecodeSamples(uint32_t buf,
+		uint32_t channel, uint8_t data[5]) {
+	const volatile uint16_t *samples;
+	uint32_t edges[DHT11_CAPTURE_BOTH_EDGES];
+	uint32_t count = 0U;
+	dht11_status_t status;
+	uint16_t pin;
+	uint16_t prev;
+	uint16_t level;
+	uint32_t i;
+
+	if (channel >= DHT11_MULTI_CHANNELS) {
+		return DHT11_ERR_FRAME;
+	}
+	pin = multi_pins[channel];
+	samples = multi_samples[buf][multi_slot[channel]];
+
+	/* Both edges, from the released line, then the channel's guard keeps
+	 * the falling edges of pulses that are long enough. The recorder gets
+	 * every change, past the ones kept too. */
+	(void) DHT11_TRACE_BEGIN((uint8_t) channel,
+			DHT11_TRACE_BOTH | DHT11_TRACE_RELEASE);
+	prev = pin;
+	for (i = 0U; i < DHT11_MULTI_SAMPLES; i++) {
+		level = samples[i] & pin;
+		if (level != prev) {
+			DHT11_TRACE_EDGE((i + 1U) * DHT11_MULTI_SAMPLE_US);
+			if (count < DHT11_CAPTURE_BOTH_EDGES) {
+				edges[count++] = i * DHT11_MULTI_SAMPLE_US;
+			}
+		}
+		prev = level;
+	}
+	count = DHT11_Capture_Deglitch((uint8_t) channel, edges, count);
+
+	if (count == 0U) {
+		status = DHT11_ERR_NO_RESPONSE;
+	} else if (count < DHT11_CAPTURE_EDGES) {
+		DEBUG_ERROR("DHT11 multi ch%lu: %lu edges\r\n", channel, count);
+		status = DHT11_ERR_TIMEOUT;
+	} else {
+		status = DHT11_Capture_DecodeEdges(edges, (uint8_t) channel, data);
+	}
+	DHT11_TRACE_END(status);
+	return status;
+}
+
+/**
+ * @brief Fills one channel's reading and reports it to the profile and
+ *        the health tracker.
+ * @param buf: The frame's buffers, or DHT11_MULTI_BUFFERS to report status
+ *        as is.
+ */
+static void DHT11_Multi_Result(uint32_t buf, uint32_t ch,
+		uint32_t start_ms, dht11_status_t status, dht11_reading_t *reading) {
+	reading->sensor_id = (uint8_t) ch;
+	reading->timestamp_ms = start_ms;
+	reading->retries = 0U;
+	reading->confidence = 0U;
+	if ((status == DHT11_OK) && (buf < DHT11_MULTI_BUFFERS)) {
+		reading->status = DHT11_Multi_DecodeSamples(buf, ch, reading->raw);
+		if (reading->status == DHT11_OK) {
+			reading->status = DHT11_Driver_Decode((uint8_t) ch, reading->raw);
+		}
+		reading->confidence = DHT11_Classify_Get(ch)->confidence;
+	} else {
+		reading->status = status;
+	}
+	DHT11_PROF_RESULT(reading->status);
+	DHT11_Health_Report(ch, reading->status);
+}
+
+/**
+ * @brief Configures every channel pin and the streams of slots 1 and up.
+ */
+void DHT11_Multi_Init(void) {
+	GPIO_InitTypeDef GPIO_InitStruct = { 0 };
+	GPIO_TypeDef *port;
+	uint32_t ch;
+	uint32_t s;
+
+	for (s = 0U; s < DHT11_MULTI_PORTS; s++) {
+		multi_port_mask[s] = 0U;
+		multi_held[s] = 0U;
+	}
+	for (ch = 0U; ch < DHT11_MULTI_CHANNELS; ch++) {
+		multi_port_mask[multi_slot[ch]] |= multi_pins[ch];
+	}
+
+	for (s = 0U; s < DHT11_MULTI_PORTS; s++) {
+		port = multi_hw[s].port;
+		RCC->AHB1ENR |= 1UL << (((uint32_t) port - GPIOA_BASE) / 0x400U);
+		(void) RCC->AHB1ENR;
+		port->BSRR = multi_port_mask[s];
+		GPIO_InitStruct.Pin = multi_port_mask[s];
+		GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_OD;
+		GPIO_InitStruct.Pull = GPIO_PULLUP;
+		GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+		HAL_GPIO_Init(port, &GPIO_InitStruct);
+	}
+
+	/* Slot 0's stream as hdma_tim1_up: TIM1 request on channel 6,
+	 * halfword IDR to RAM, very high priority; no interrupts, slot 0
+	 * ends the window */
+	for (s = 1U; s < DHT11_MULTI_PORTS; s++) {
+		multi_hw[s].stream->CR = 0U;
+		multi_hw[s].stream->FCR = 0U;
+		multi_hw[s].stream->PAR = (uint32_t) &multi_hw[s].port->IDR;
+		multi_hw[s].stream->CR = (6UL << DMA_SxCR_CHSEL_Pos) | DMA_SxCR_PL
+				| DMA_SxCR_MSIZE_0 | DMA_SxCR_PSIZE_0 | DMA_SxCR_MINC;
+	}
+	/* Compares one count before the update: other ports sample first */
+	htim1.Instance->CCR1 = htim1.Instance->ARR;
+	htim1.Instance->CCR2 = htim1.Instance->ARR;
+	htim1.Instance->CCR3 = htim1.Instance->ARR;
+
+	DHT11_Multi_Stop();
+}
+
+/**
+ * @brief TIM1 prescaler for a 1 MHz count.
+ */
+uint32_t DHT11_Multi_TimerPrescaler(void) {
+	return (Clock_GetApb2TimerHz() / 1000000U) - 1U;
+}
+
+/**
+ * @brief Pins of the given channels on each port.
+ */
+static void DHT11_Multi_Pins(uint32_t channels,
+		uint16_t pins[DHT11_MULTI_PORTS]) {
+	uint32_t ch;
+	uint32_t s;
+
+	for (s = 0U; s < DHT11_MULTI_PORTS; s++) {
+		pins[s] = ((channels & DHT11_MULTI_ALL) == DHT11_MULTI_ALL) ?
+				multi_port_mask[s] : 0U;
+	}
+	if ((channels & DHT11_MULTI_ALL) == DHT11_MULTI_ALL) {
+		return;
+	}
+	for (ch = 0U; ch < DHT11_MULTI_CHANNELS; ch++) {
+		if ((channels & (1UL << ch)) != 0U) {
+			pins[multi_slot[ch]] |= multi_pins[ch];
+		}
+	}
+}
+
+/**
+ * @brief Releases every line not held, one BSRR write per port.
+ */
+static void DHT11_Multi_ReleaseAll(void) {
+	uint32_t s;
+
+	for (s = 0U; s < DHT11_MULTI_PORTS; s++) {
+		multi_hw[s].port->BSRR = (uint32_t) (multi_port_mask[s] & ~multi_held[s]);
+	}
+}
+
+/**
+ * @brief Pulls the lines of the given channels low together.
+ */
+void DHT11_Multi_DriveLow(uint32_t channels) {
+	uint16_t pins[DHT11_MULTI_PORTS];
+	uint32_t s;
+
+	DHT11_Multi_Pins(channels, pins);
+	for (s = 0U; s < DHT11_MULTI_PORTS; s++) {
+		multi_hw[s].port->BSRR = (uint32_t) pins[s] << 16U;
+	}
+}
+
+/**
+ * @brief Holds the lines of the given channels LOW across frames.
+ */
+void DHT11_Multi_Hold(uint32_t channels) {
+	uint16_t pins[DHT11_MULTI_PORTS];
+	uint16_t freed;
+	uint32_t s;
+
+	DHT11_Multi_Pins(channels, pins);
+	for (s = 0U; s < DHT11_MULTI_PORTS; s++) {
+		freed = multi_held[s] & (uint16_t) ~pins[s];
+		multi_held[s] = pins[s];
+		multi_hw[s].port->BSRR = ((uint32_t) pins[s] << 16U) | freed;
+	}
+}
+
+/**
+ * @brief Begins a frame in the next sample buffer.
+ */
+dht11_status_t DHT11_Multi_Begin(uint32_t channels, uint32_t *pulse_ms) {
+	uint8_t next = multi_fill ^ 1U;
+	multi_frame_t *f = &multi_frames[next];
+	uint32_t start_ms = 0U;
+	uint32_t ch;
+
+	if ((DHT11_Multi_IsComplete() == 0U) || (f->state != MULTI_FREE)) {
+		return DHT11_ERR_BUSY;
+	}
+
+	/* One pulse for every channel: the longest their sensor types need */
+	for (ch = 0U; ch < DHT11_MULTI_CHANNELS; ch++) {
+		if (((channels & (1UL << ch)) != 0U)
+				&& (DHT11_Driver_StartMs((uint8_t) ch) > start_ms)) {
+			start_ms = DHT11_Driver_StartMs((uint8_t) ch);
+		}
+	}
+
+	f->channels = channels;
+	f->start_ms = HAL_GetTick();
+	f->pulse_ms = start_ms;
+	f->status = DHT11_OK;
+	f->state = MULTI_PULSE;
+	multi_fill = next;
+	DHT11_Multi_DriveLow(channels);
+	*pulse_ms = start_ms;
+	return DHT11_OK;
+}
+
+/**
+ * @brief Starts IDR sampling into the frame's buffers and releases all lines.
+ */
+dht11_status_t DHT11_Multi_Arm(void) {
+	DMA_HandleTypeDef *hdma = htim1.hdma[TIM_DMA_ID_UPDATE];
+	multi_frame_t *f = &multi_frames[multi_fill];
+	uint32_t s;
+
+	if (f->state != MULTI_PULSE) {
+		return DHT11_ERR_BUSY;
+	}
+
+	/* The other ports' streams wait for their compares */
+	for (s = 1U; s < DHT11_MULTI_PORTS; s++) {
+		DHT11_Multi_ClearStream(multi_hw[s].stream_num);
+		multi_hw[s].stream->M0AR = (uint32_t) multi_samples[multi_fill][s];
+		multi_hw[s].stream->NDTR = DHT11_MULTI_SAMPLES;
+		multi_hw[s].stream->CR |= DMA_SxCR_EN;
+	}
+
+	hdma->XferCpltCallback = DHT11_Multi_DmaCplt;
+	hdma->XferErrorCallback = DHT11_Multi_DmaError;
+	f->state = MULTI_SAMPLING;
+	if (HAL_DMA_Start_IT(hdma, (uint32_t) &DHT11_MULTI_PORT_0->IDR,
+			(uint32_t) multi_samples[multi_fill][0], DHT11_MULTI_SAMPLES)
+			!= HAL_OK) {
+		/* Released all the same; the channels report the failure */
+		DHT11_Multi_StopSlots();
+		DHT11_Multi_ReleaseAll();
+		f->status = DHT11_ERR_BUSY;
+		f->state = MULTI_FULL;
+		return DHT11_ERR_BUSY;
+	}
+
+	htim1.Instance->CNT = 0U;
+	htim1.Instance->SR = ~(TIM_SR_UIF | TIM_SR_CC1IF | TIM_SR_CC2IF | TIM_SR_CC3IF);
+	htim1.Instance->DIER |= MULTI_REQUESTS;
+
+	/* Release and start the trigger back to back: sample 0 is taken one
+	 * period after the release */
+	DHT11_Multi_ReleaseAll();
+	__HAL_TIM_ENABLE(&htim1);
+
+	return DHT11_OK;
+}
+
+/**
+ * @brief Reports whether the frame begun last has left its pulse and window.
+ */
+uint8_t DHT11_Multi_IsComplete(void) {
+	uint8_t state = multi_frames[multi_fill].state;
+
+	return ((state != MULTI_PULSE) && (state != MULTI_SAMPLING)) ? 1U : 0U;
+}
+
+/**
+ * @brief Decodes and reports the oldest filled frame and frees its buffer.
+ */
+uint32_t DHT11_Multi_Collect(dht11_reading_t readings[DHT11_MULTI_CHANNELS]) {
+	uint8_t buf = multi_fill ^ 1U;
+	multi_frame_t *f;
+	uint32_t ch;
+
+	DHT11_Multi_Expire();
+	/* The other buffer is older: a frame can only begin once it is free */
+	if (multi_frames[buf].state != MULTI_FULL) {
+		buf = multi_fill;
+		if (multi_frames[buf].state != MULTI_FULL) {
+			return 0U;
+		}
+	}
+	f = &multi_frames[buf];
+
+	for (ch = 0U; ch < DHT11_MULTI_CHANNELS; ch++) {
+		if ((f->channels & (1UL << ch)) != 0U) {
+			DHT11_Multi_Result(buf, ch, f->start_ms, f->status, &readings[ch]);
+		}
+	}
+	f->state = MULTI_FREE;
+	return f->channels;
+}
+
+/**
+ * @brief Demultiplexes and decodes one channel from the last filled buffer.
+ */
+dht11_status_t DHT11_Multi_Decode(uint32_t channel, uint8_t data[5]) {
+	return DHT11_Multi_DecodeSamples(multi_last, channel, data);
+}
+
+/**
+ * @brief Blocking read of the given channels.
+ */
+uint32_t DHT11_Multi_Read(uint32_t channels,
+		dht11_reading_t readings[DHT11_MULTI_CHANNELS]) {
+	uint32_t start_ms = HAL_GetTick();
+	uint32_t pulse_ms;
+	uint32_t ok = 0U;
+	uint32_t ch;
+
+	if (DHT11_Multi_Begin(channels, &pulse_ms) == DHT11_OK) {
+		HAL_Delay(pulse_ms);
+		(void) DHT11_Multi_Arm();
+		while (DHT11_Multi_IsComplete() == 0U) {
+			DHT11_Multi_Expire();
+		}
+		channels = DHT11_Multi_Collect(readings);
+	} else {
+		for (ch = 0U; ch < DHT11_MULTI_CHANNELS; ch++) {
+			if ((channels & (1UL << ch)) != 0U) {
+				DHT11_Multi_Result(DHT11_MULTI_BUFFERS, ch, start_ms,
+						DHT11_ERR_BUSY, &readings[ch]);
+			}
+		}
+	}
+
+	for (ch = 0U; ch < DHT11_MULTI_CHANNELS; ch++) {
+		if (((channels & (1UL << ch)) != 0U) && (readings[ch].status == DHT11_OK)) {
+			ok++;
+		}
+	}
+	return ok;
+}
+
+#endif /* DHT11_USE_MULTI */
@@ -0,0 +1,270 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_oversample.c
+ * @brief          : Oversampled DHT11 decoder: timer-triggered DMA samples
+ *                   of GPIO IDR, run-length encoded with glitch voting.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "dht11_oversample.h"
+#include "clock_config.h"
+#include "timebase.h"
+#include "dht11_prof.h"
+#include "dht11_driver.h"
+#include "dht11_trace.h"
+#include "my_debug.h"
+#include "irq_prio.h"
+#include "memmap.h"
+
+#if DHT11_USE_OVERSAMPLE
+
+/** Sampling trigger and the stream its update event requests */
+#define OVS_TIM             (TIM8)
+#define OVS_DMA             (DMA2_Stream1)
+#define OVS_DMA_CH          (7U)       /* TIM8_UP */
+#define OVS_DMA_FLAGS       (DMA_LIFCR_CTCIF1 | DMA_LIFCR_CHTIF1 \
+		| DMA_LIFCR_CTEIF1 | DMA_LIFCR_CDMEIF1 | DMA_LIFCR_CFEIF1)
+
+/** The IDR byte holding the data pin, and the pin's bit in it */
+#define OVS_IDR_BYTE        ((uint32_t) &DHT_PIN_GPIO_Port->IDR + (DHT11_PIN_NUM / 8U))
+#define OVS_BIT             (1UL << (DHT11_PIN_NUM % 8U))
+
+/** The pin's bit in each of the four samples of a word */
+#define OVS_WORD_BITS       (OVS_BIT * 0x01010101UL)
+
+#define OVS_WORDS           (DHT11_OVERSAMPLE_SAMPLES / 4U)
+#define OVS_GLITCH_SAMPLES  (DHT11_OVERSAMPLE_GLITCH_US / DHT11_OVERSAMPLE_US)
+
+/* IDR bytes written by DMA2 Stream1, read back a word at a time */
+static volatile uint8_t ovs_samples[DHT11_OVERSAMPLE_SAMPLES] DMA_BUFFER;
+
+/* Run lengths in samples, alternating from the released (HIGH) line */
+static uint16_t ovs_runs[DHT11_OVERSAMPLE_RUNS];
+static uint32_t ovs_glitches = 0U;
+
+/**
+ * @brief Stops the trigger and the stream and clears its flags.
+ */
+static void Ovs_Stop(void) {
+	OVS_TIM->CR1 &= ~TIM_CR1_CEN;
+	OVS_TIM->DIER = 0U;
+	OVS_DMA->CR &= ~DMA_SxCR_EN;
+	while ((OVS_DMA->CR & DMA_SxCR_EN) != 0U) {
+		/* Disabling completes after the current transfer */
+	}
+	DMA2->LIFCR = OVS_DMA_FLAGS;
+}
+
+/**
+ * @brief Run-length encodes the window into ovs_runs, merging runs shorter
+ *        than OVS_GLITCH_SAMPLES into their neighbours.
+ * @retval Number of runs, 0 if there were more than DHT11_OVERSAMPLE_RUNS.
+ */
+static uint32_t Ovs_Runs(void) {
+	const volatile uint32_t *words = (const volatile uint32_t*) ovs_samples;
+	uint32_t level = OVS_WORD_BITS; /* Released line */
+	uint32_t len = 0U;
+	uint32_t n = 0U;
+	uint32_t bits;
+	uint32_t i;
+	uint32_t k;
+
+	for (i = 0U; i < OVS_WORDS; i++) {
+		bits = words[i] & OVS_WORD_BITS;
+		if (bits == level) {
+			len += 4U;
+			continue;
+		}
+		/* Little-endian: the first sample is the low byte */
+		for (k = 0U; k < 4U; k++) {
+			if (((bits >> (8U * k)) & OVS_BIT) == (level & OVS_BIT)) {
+				len++;
+				continue;
+			}
+			if ((len < OVS_GLITCH_SAMPLES) && (n != 0U)) {
+				/* Outvoted: the line is back at the level before the
+				 * glitch, so that run goes on */
+				n--;
+				len = ovs_runs[n] + len + 1U;
+				ovs_glitches++;
+			} else {
+				if (n >= DHT11_OVERSAMPLE_RUNS) {
+					return 0U;
+				}
+				ovs_runs[n++] = (uint16_t) len;
+				len = 1U;
+			}
+			level ^= OVS_WORD_BITS;
+		}
+	}
+	if (n >= DHT11_OVERSAMPLE_RUNS) {
+		return 0U;
+	}
+	ovs_runs[n++] = (uint16_t) len;
+	return n;
+}
+
+/**
+ * @brief Clocks TIM8 and DMA2 and sets the sampling rate.
+ */
+void DHT11_Oversample_Init(void) {
+	__HAL_RCC_TIM8_CLK_ENABLE();
+	__HAL_RCC_DMA2_CLK_ENABLE();
+	OVS_TIM->CR1 = 0U;
+	OVS_TIM->PSC = 0U;
+	DHT11_Oversample_ClockChanged();
+	Ovs_Stop();
+	OVS_DMA->PAR = OVS_IDR_BYTE;
+	OVS_DMA->M0AR = (uint32_t) ovs_samples;
+}
+
+/**
+ * @brief Recomputes the TIM8 period.
+ */
+void DHT11_Oversample_ClockChanged(void) {
+	OVS_TIM->ARR = ((Clock_GetApb2TimerHz() / 1000000U) * DHT11_OVERSAMPLE_US)
+			- 1U;
+	/* UG loads ARR at once; DMA requests are off, so none is issued */
+	OVS_TIM->EGR = TIM_EGR_UG;
+}
+
+/**
+ * @brief Drives the data line LOW to begin the start pulse.
+ */
+void DHT11_Oversample_DriveLow(void) {
+	DHT11_Pin_Low();
+	DHT11_Pin_ModeGpio();
+}
+
+/**
+ * @brief Starts sampling and releases the data line.
+ */
+dht11_status_t DHT11_Oversample_Arm(void) {
+	uint32_t basepri;
+
+	if ((OVS_DMA->CR & DMA_SxCR_EN) != 0U) {
+		return DHT11_ERR_BUSY;
+	}
+	DMA2->LIFCR = OVS_DMA_FLAGS;
+	OVS_DMA->NDTR = DHT11_OVERSAMPLE_SAMPLES;
+	OVS_DMA->CR = (OVS_DMA_CH << DMA_SxCR_CHSEL_Pos) | DMA_SxCR_PL | DMA_SxCR_MINC;
+	OVS_DMA->CR |= DMA_SxCR_EN;
+
+	OVS_TIM->CNT = 0U;
+	OVS_TIM->SR = 0U;
+	OVS_TIM->DIER = TIM_DIER_UDE;
+
+	/* Release and start the trigger back to back: sample 0 is taken one
+	 * period after the release */
+	basepri = Irq_MaskFrom(IRQ_PRIO_TIMEBASE);
+	DHT11_Pin_Release();
+	OVS_TIM->CR1 |= TIM_CR1_CEN;
+	Irq_Unmask(basepri);
+
+	return DHT11_OK;
+}
+
+/**
+ * @brief Reports whether the sampling window has been filled.
+ */
+uint8_t DHT11_Oversample_IsComplete(void) {
+	return ((DMA2->LISR & DMA_LISR_TCIF1) != 0U) ? 1U : 0U;
+}
+
+/**
+ * @brief Stops sampling and drops the window.
+ */
+void DHT11_Oversample_Abort(void) {
+	Ovs_Stop();
+}
+
+/**
+ * @brief Filters the window and decodes its falling edges.
+ */
+dht11_status_t DHT11_Oversample_Decode(uint8_t data[5]) {
+	uint32_t edges[DHT11_CAPTURE_EDGES];
+	uint32_t count = 0U;
+	dht11_status_t status;
+	uint32_t t = 0U;
+	uint32_t n;
+	uint32_t i;
+
+	n = Ovs_Runs();
+	if (n == 0U) {
+		DEBUG_ERROR("DHT11 oversample: over %lu runs\r\n",
+				(uint32_t) DHT11_OVERSAMPLE_RUNS);
+		return DHT11_ERR_FRAME;
+	}
+
+	/* Odd runs are LOW: each starts at a falling edge. The recorder gets
+	 * every run boundary. */
+	(void) DHT11_TRACE_BEGIN(0U, DHT11_TRACE_BOTH | DHT11_TRACE_RELEASE);
+	for (i = 0U; i < n; i++) {
+		if (i != 0U) {
+			DHT11_TRACE_EDGE((t + 1U) * DHT11_OVERSAMPLE_US);
+		}
+		if (((i & 1U) != 0U) && (count < DHT11_CAPTURE_EDGES)) {
+			edges[count++] = t * DHT11_OVERSAMPLE_US;
+		}
+		t += ovs_runs[i];
+	}
+
+	if (count == 0U) {
+		status = DHT11_ERR_NO_RESPONSE;
+	} else if (count < DHT11_CAPTURE_EDGES) {
+		DEBUG_ERROR("DHT11 oversample: %lu edges\r\n", count);
+		status = DHT11_ERR_TIMEOUT;
+	} else {
+		status = DHT11_Capture_DecodeEdges(edges, 0U, data);
+	}
+	DHT11_TRACE_END(status);
+	return status;
+}
+
+/**
+ * @brief Blocking transaction through the oversampled decoder.
+ */
+dht11_status_t DHT11_Oversample_Read(uint8_t data[5]) {
+	dht11_status_t status;
+	uint32_t startTick;
+
+	/* Pull LOW for the sensor type's start pulse, ≥18 ms for a DHT11 */
+	DHT11_PROF_BEGIN();
+	DHT11_Oversample_DriveLow();
+	HAL_Delay(DHT11_Driver_StartMs(0U));
+
+	status = DHT11_Oversample_Arm();
+	if (status != DHT11_OK) {
+		return status;
+	}
+	DHT11_PROF_MARK(DHT11_PROF_START);
+
+	startTick = HAL_GetTick();
+	while (DHT11_Oversample_IsComplete() == 0U) {
+		if (((DMA2->LISR & DMA_LISR_TEIF1) != 0U)
+				|| ((HAL_GetTick() - startTick) >= DHT11_CAPTURE_TIMEOUT_MS)) {
+			DHT11_Oversample_Abort();
+			DEBUG_ERROR("DHT11 oversample: window not filled\r\n");
+			return DHT11_ERR_TIMEOUT;
+		}
+	}
+	Ovs_Stop();
+
+	DHT11_PROF_MARK(DHT11_PROF_DATA); /* Includes the response */
+	status = DHT11_Oversample_Decode(data);
+	DHT11_PROF_MARK(DHT11_PROF_CHECKSUM);
+	return status;
+}
+
+/**
+ * @brief Runs outvoted by their neighbours since boot.
+ */
+uint32_t DHT11_Oversample_GetGlitches(void) {
+	return ovs_glitches;
+}
+
+#endif /* DHT11_USE_OVERSAMPLE */
@@ -0,0 +1,33 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_pin.c
+ * @brief          : One-time configuration of the DHT11 data line.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "dht11_pin.h"
+
+/**
+ * @brief One-time configuration of the data line. Leaves it released.
+ */
+void DHT11_Pin_Init(void) {
+	GPIO_InitTypeDef GPIO_InitStruct = { 0 };
+
+	/* ODR high first so switching to GPIO mode never glitches the line */
+	DHT11_Pin_Release();
+
+	/* AF_OD programs OTYPER, OSPEEDR, PUPDR and AFR in one go; later
+	 * hand-overs only rewrite the MODER field */
+	GPIO_InitStruct.Pin = DHT_PIN_Pin;
+	GPIO_InitStruct.Mode = GPIO_MODE_AF_OD;
+	GPIO_InitStruct.Pull = GPIO_PULLUP;
+	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+	GPIO_InitStruct.Alternate = GPIO_AF2_TIM5;
+	HAL_GPIO_Init(DHT_PIN_GPIO_Port, &GPIO_InitStruct);
+
+	DHT11_Pin_ModeGpio();
+}
@@ -0,0 +1,165 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_prof.c
+ * @brief          : DWT cycle-counter profiling of DHT11 transactions.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "dht11_prof.h"
+#include "dht11_capture.h"
+#include "dht11_classify.h"
+#include "timebase.h"
+#include "swo.h"
+#include <stdio.h>
+#include <string.h>
+
+static dht11_prof_t prof;
+static uint32_t prof_last_cycles = 0U;
+
+/**
+ * @brief Adds one sample to a running statistic.
+ */
+static void DHT11_Prof_Add(dht11_prof_stat_t *stat, uint32_t us) {
+	if ((stat->count == 0U) || (us < stat->min_us)) {
+		stat->min_us = us;
+	}
+	if (us > stat->max_us) {
+		stat->max_us = us;
+	}
+	stat->sum_us += us;
+	stat->count++;
+}
+
+/**
+ * @brief Prints one statistic line.
+ */
+static void DHT11_Prof_Print(const char *name, const dht11_prof_stat_t *stat) {
+	uint32_t mean = 0U;
+
+	if (stat->count != 0U) {
+		mean = (uint32_t) (stat->sum_us / stat->count);
+	}
+	printf("  %-9s n=%lu min=%lu mean=%lu max=%lu us\r\n", name, stat->count,
+			stat->min_us, mean, stat->max_us);
+}
+
+/**
+ * @brief Clears all statistics.
+ */
+void DHT11_Prof_Reset(void) {
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	memset(&prof, 0, sizeof(prof));
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @brief Latches CYCCNT at the start of a transaction.
+ */
+void DHT11_Prof_Begin(void) {
+	prof_last_cycles = DWT->CYCCNT;
+}
+
+/**
+ * @brief Ends a phase: records the time since the previous mark.
+ */
+void DHT11_Prof_Mark(dht11_prof_phase_t phase) {
+	uint32_t now = DWT->CYCCNT;
+	uint32_t us;
+
+	if (phase < DHT11_PROF_PHASES) {
+		us = (now - prof_last_cycles) / Timebase_CyclesPerUs();
+		DHT11_Prof_Add(&prof.phase[phase], us);
+		SWO_EVENT(SWO_EVENT_PHASE, ((uint32_t) phase << 16)
+				| ((us > 0xFFFFU) ? 0xFFFFU : us));
+	}
+	prof_last_cycles = now;
+}
+
+/**
+ * @brief Records one decoded bit.
+ */
+void DHT11_Prof_Bit(uint32_t index, uint32_t value, uint32_t width_us) {
+	uint32_t bin = width_us / DHT11_PROF_BIN_US;
+
+	value = (value != 0U) ? 1U : 0U;
+	if (bin >= DHT11_PROF_BINS) {
+		bin = DHT11_PROF_BINS - 1U;
+	}
+	DHT11_Prof_Add(&prof.bit[value], width_us);
+	prof.hist[value][bin]++;
+	if (index < 40U) {
+		prof.last_width_us[index] = (uint16_t) width_us;
+	}
+	SWO_EVENT(SWO_EVENT_BIT, ((index & 0xFFU) << 16) | (value << 15)
+			| (width_us & 0x7FFFU));
+}
+
+/**
+ * @brief Counts the outcome of one attempt.
+ */
+void DHT11_Prof_Result(dht11_status_t status) {
+	if ((uint32_t) status < DHT11_PROF_STATUSES) {
+		prof.status[status]++;
+	}
+	SWO_EVENT(SWO_EVENT_RESULT, (uint32_t) status);
+}
+
+/**
+ * @brief Read-only view of the statistics.
+ */
+const dht11_prof_t* DHT11_Prof_Get(void) {
+	return &prof;
+}
+
+/**
+ * @brief Prints the statistics through printf.
+ */
+void DHT11_Prof_Dump(void) {
+	static const char *const phases[DHT11_PROF_PHASES] = { "start",
+			"response", "data", "checksum" };
+	uint32_t i;
+
+	printf("DHT11 profile: bit %s, threshold %lu us\r\n",
+			(DHT11_USE_CAPTURE != 0) ? "period" : "HIGH time",
+			DHT11_Classify_Threshold(DHT11_Classify_Get(0U)));
+
+	for (i = 0U; i < (uint32_t) DHT11_PROF_PHASES; i++) {
+		if (prof.phase[i].count != 0U) {
+			DHT11_Prof_Print(phases[i], &prof.phase[i]);
+		}
+	}
+	DHT11_Prof_Print("bit 0", &prof.bit[0]);
+	DHT11_Prof_Print("bit 1", &prof.bit[1]);
+	if ((prof.bit[0].count != 0U) && (prof.bit[1].count != 0U)) {
+		printf("  margin    %ld us\r\n",
+				(int32_t) prof.bit[1].min_us - (int32_t) prof.bit[0].max_us);
+	}
+
+	printf("  histogram (us: zeros ones)\r\n");
+	for (i = 0U; i < DHT11_PROF_BINS; i++) {
+		if ((prof.hist[0][i] | prof.hist[1][i]) != 0U) {
+			printf("  %3lu-%3lu: %lu %lu\r\n", i * DHT11_PROF_BIN_US,
+					((i + 1U) * DHT11_PROF_BIN_US) - 1U, prof.hist[0][i],
+					prof.hist[1][i]);
+		}
+	}
+
+	printf("  last frame:");
+	for (i = 0U; i < 40U; i++) {
+		printf("%s%u", ((i & 7U) == 0U) ? " | " : " ", prof.last_width_us[i]);
+	}
+	printf("\r\n");
+
+	for (i = 0U; i < DHT11_PROF_STATUSES; i++) {
+		if (prof.status[i] != 0U) {
+			printf("  %-11s %lu\r\n", DHT11_StatusName((dht11_status_t) i),
+					prof.status[i]);
+		}
+	}
+}
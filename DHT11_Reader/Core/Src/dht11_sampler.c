@@ -0,0 +1,252 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_sampler.c
+ * @brief          : Per-sensor sampling plan: period, phase and the DHT11
+ *                   minimum re-trigger spacing.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "dht11_sampler.h"
+#include "dht11_health.h"
+#include "dht11_supply.h"
+#include "dht11_sync.h"
+#include <string.h>
+
+/**
+ * @brief Plan and timing of one sensor.
+ */
+typedef struct {
+	dht11_sampler_cfg_t cfg;
+	uint32_t next_ms;        /*!< Planned start                */
+	uint32_t last_ms;        /*!< Previous start               */
+	uint8_t started;         /*!< last_ms is valid             */
+} sampler_sensor_t;
+
+static sampler_sensor_t sampler_sensors[DHT11_SAMPLER_SENSORS];
+static uint32_t sampler_frame_ms = 0U;   /* Start of the previous frame */
+static uint8_t sampler_framed = 0U;
+
+/**
+ * @brief Wrap-safe a < b on the millisecond tick.
+ */
+static uint8_t Sampler_Before(uint32_t a, uint32_t b) {
+	return ((int32_t) (a - b) < 0) ? 1U : 0U;
+}
+
+/**
+ * @brief Shortest start-to-start spacing of a sensor.
+ */
+static uint32_t Sampler_MinSpacing(uint8_t sensor_id) {
+	uint32_t spacing = DHT11_Health_MinSpacingMs(sensor_id);
+
+	return (spacing > DHT11_SAMPLER_MIN_PERIOD_MS) ?
+			spacing : DHT11_SAMPLER_MIN_PERIOD_MS;
+}
+
+/**
+ * @brief Planned start of a sensor, no sooner than its rest and the
+ *        warm-up of a switched supply allow.
+ */
+static uint32_t Sampler_DueMs(uint8_t sensor_id) {
+	const sampler_sensor_t *s = &sampler_sensors[sensor_id];
+	uint32_t due = s->next_ms;
+	uint32_t earliest;
+
+	if (s->started != 0U) {
+		earliest = s->last_ms + Sampler_MinSpacing(sensor_id);
+		if (Sampler_Before(due, earliest) != 0U) {
+			due = earliest;
+		}
+	}
+#if DHT11_USE_SUPPLY
+	earliest = HAL_GetTick() + DHT11_Supply_ReadyInMs(sensor_id);
+	if (Sampler_Before(due, earliest) != 0U) {
+		due = earliest;
+	}
+#endif /* DHT11_USE_SUPPLY */
+	return due;
+}
+
+/**
+ * @brief Applies the default plan to every sensor.
+ */
+void DHT11_Sampler_Init(void) {
+	uint32_t i;
+
+	memset(sampler_sensors, 0, sizeof(sampler_sensors));
+	sampler_framed = 0U;
+	for (i = 0U; i < DHT11_SAMPLER_SENSORS; i++) {
+		(void) DHT11_Sampler_Set((uint8_t) i, DHT11_SAMPLER_DEFAULT_PERIOD_MS,
+				0U);
+	}
+}
+
+/**
+ * @brief Sets the plan of one sensor.
+ */
+uint8_t DHT11_Sampler_Set(uint8_t sensor_id, uint32_t period_ms,
+		uint32_t phase_ms) {
+	sampler_sensor_t *s;
+
+	if ((sensor_id >= DHT11_SAMPLER_SENSORS)
+			|| ((period_ms != 0U)
+					&& ((period_ms < Sampler_MinSpacing(sensor_id))
+							|| (phase_ms >= period_ms)))) {
+		return 0U;
+	}
+	s = &sampler_sensors[sensor_id];
+	s->cfg.period_ms = period_ms;
+	s->cfg.phase_ms = (period_ms != 0U) ? phase_ms : 0U;
+	s->next_ms = HAL_GetTick() + s->cfg.phase_ms;
+	return 1U;
+}
+
+/**
+ * @brief Plan of one sensor.
+ */
+dht11_sampler_cfg_t DHT11_Sampler_Get(uint8_t sensor_id) {
+	dht11_sampler_cfg_t cfg = { 0U, 0U };
+
+	if (sensor_id < DHT11_SAMPLER_SENSORS) {
+		cfg = sampler_sensors[sensor_id].cfg;
+	}
+	return cfg;
+}
+
+/**
+ * @brief Time until the next frame and, when it is due, its sensors.
+ */
+uint32_t DHT11_Sampler_Next(uint32_t now_ms, uint32_t *due) {
+	uint32_t frame = 0U;
+	uint32_t t;
+	uint8_t found = 0U;
+	uint32_t i;
+
+	*due = 0U;
+	for (i = 0U; i < DHT11_SAMPLER_SENSORS; i++) {
+		if (sampler_sensors[i].cfg.period_ms == 0U) {
+			continue;
+		}
+		t = Sampler_DueMs((uint8_t) i);
+		if ((found == 0U) || (Sampler_Before(t, frame) != 0U)) {
+			frame = t;
+			found = 1U;
+		}
+	}
+	if (found == 0U) {
+		return DHT11_SAMPLER_MIN_PERIOD_MS; /* Nothing planned: look again later */
+	}
+
+	if (Sampler_Before(frame, now_ms) != 0U) {
+		frame = now_ms;
+	}
+	if ((sampler_framed != 0U)
+			&& ((frame - sampler_frame_ms) < DHT11_SAMPLER_SLOT_MS)) {
+		/* Keep out of the previous frame's response window */
+		frame = sampler_frame_ms + DHT11_SAMPLER_SLOT_MS;
+	}
+	if (Sampler_Before(now_ms, frame) != 0U) {
+		return frame - now_ms;
+	}
+
+	/* Everything due within this slot goes in the same frame, as long as
+	 * it does not cut a sensor's rest short */
+	for (i = 0U; i < DHT11_SAMPLER_SENSORS; i++) {
+		if (sampler_sensors[i].cfg.period_ms == 0U) {
+			continue;
+		}
+		t = Sampler_DueMs((uint8_t) i);
+		if ((Sampler_Before(t, now_ms + DHT11_SAMPLER_SLOT_MS) != 0U)
+				&& ((sampler_sensors[i].started == 0U)
+						|| ((now_ms - sampler_sensors[i].last_ms)
+								>= Sampler_MinSpacing((uint8_t) i)))) {
+			*due |= 1UL << i;
+		}
+	}
+	return 0U;
+}
+
+/**
+ * @brief Records a frame for the sensors in due.
+ */
+void DHT11_Sampler_Done(uint32_t due, uint32_t start_ms) {
+	sampler_sensor_t *s;
+	uint32_t interval;
+	uint32_t i;
+
+	for (i = 0U; i < DHT11_SAMPLER_SENSORS; i++) {
+		s = &sampler_sensors[i];
+		if (((due & (1UL << i)) == 0U) || (s->cfg.period_ms == 0U)) {
+			continue;
+		}
+		interval = DHT11_Sampler_IntervalMs((uint8_t) i);
+		s->next_ms += interval;
+		if (Sampler_Before(s->next_ms, start_ms + Sampler_MinSpacing((uint8_t) i))
+				!= 0U) {
+			/* Ran late: drop the missed slots rather than burst */
+			s->next_ms = start_ms + interval;
+		}
+		/* Locked (dht11_sync.h): the slot of the shared pulse instead */
+		(void) DHT11_SYNC_SLOT_MS(start_ms + Sampler_MinSpacing((uint8_t) i),
+				interval, s->cfg.phase_ms, &s->next_ms);
+		s->last_ms = start_ms;
+		s->started = 1U;
+	}
+	sampler_frame_ms = start_ms;
+	sampler_framed = 1U;
+}
+
+/**
+ * @brief Brings the sensors in mask forward to now.
+ */
+uint32_t DHT11_Sampler_Request(uint32_t mask, uint32_t now_ms) {
+	uint32_t wait = 0U;
+	uint32_t t;
+	uint8_t found = 0U;
+	uint32_t i;
+
+	for (i = 0U; i < DHT11_SAMPLER_SENSORS; i++) {
+		if (((mask & (1UL << i)) == 0U)
+				|| (sampler_sensors[i].cfg.period_ms == 0U)) {
+			continue;
+		}
+		sampler_sensors[i].next_ms = now_ms;
+		t = Sampler_DueMs((uint8_t) i);
+		t = (Sampler_Before(now_ms, t) != 0U) ? (t - now_ms) : 0U;
+		if ((found == 0U) || (t < wait)) {
+			wait = t;
+			found = 1U;
+		}
+	}
+	return (found != 0U) ? wait : DHT11_SAMPLER_MIN_PERIOD_MS;
+}
+
+/**
+ * @brief Next start of a single-sensor loop.
+ */
+uint32_t DHT11_Sampler_NextStartMs(uint8_t sensor_id, uint32_t start_ms) {
+	uint32_t interval = DHT11_Sampler_IntervalMs(sensor_id);
+	uint32_t next_ms = start_ms + interval;
+
+	if (interval != 0U) {
+		(void) DHT11_SYNC_SLOT_MS(start_ms + Sampler_MinSpacing(sensor_id),
+				interval, sampler_sensors[sensor_id].cfg.phase_ms, &next_ms);
+	}
+	return next_ms;
+}
+
+/**
+ * @brief Nominal interval of a single-sensor loop.
+ */
+uint32_t DHT11_Sampler_IntervalMs(uint8_t sensor_id) {
+	uint32_t period_ms = DHT11_Sampler_Get(sensor_id).period_ms;
+
+	if (period_ms == 0U) {
+		return 0U;
+	}
+	return DHT11_Health_NextIntervalMs(sensor_id, period_ms);
+}
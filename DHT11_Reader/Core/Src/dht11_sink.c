@@ -0,0 +1,246 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_sink.c
+ * @brief          : Presentation of dht11_reading_t results.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "dht11_sink.h"
+#include <stdio.h>
+#include "my_debug.h"
+#include "telemetry.h"
+#include "history.h"
+#include "flashlog.h"
+#include "fmt.h"
+#include "dht11_calib.h"
+#include "dht11_filter.h"
+#include "dht11_emit.h"
+#include "swo.h"
+#include "can_bus.h"
+#include "i2c_regmap.h"
+#include "dht11_latest.h"
+#include "dht11_agg.h"
+#include "wallclock.h"
+#include "uart_tx.h"
+#include "status_led.h"
+#include "adc_mon.h"
+
+/* Built-in sink per dht11_format_t */
+static const dht11_sink_t sink_formats[] = { DHT11_Sink_Text, Telemetry_Sink,
+		Telemetry_DeltaSink, NULL, Telemetry_BatchSink, Telemetry_SchemaSink };
+
+static dht11_sink_t sink_active = DHT11_SINK_DEFAULT;
+static uint32_t sink_shed = 0U;
+
+/**
+ * @brief Reports whether the TX ring's backpressure holds an output back:
+ *        a stalled link takes nothing, a backed-up one only the window
+ *        summaries, if windows are on to stand in for the raw readings.
+ * @param summary: 1 for a window summary, 0 for a reading.
+ */
+static uint8_t DHT11_Sink_Shed(uint8_t summary) {
+	uart_tx_pressure_t pressure = UART_TX_GetPressure();
+
+	if ((pressure == UART_TX_PRESSURE_STALLED)
+			|| ((pressure == UART_TX_PRESSURE_HIGH) && (summary == 0U)
+					&& (DHT11_Agg_IsOn() != 0U))) {
+		sink_shed++;
+		return 1U;
+	}
+	return 0U;
+}
+
+/**
+ * @brief Selects the active sink.
+ */
+void DHT11_Sink_Set(dht11_sink_t sink) {
+	if ((sink_active == Telemetry_BatchSink) && (sink != Telemetry_BatchSink)) {
+		Telemetry_BatchFlush();
+	}
+	sink_active = sink;
+}
+
+/**
+ * @brief Returns the active sink.
+ */
+dht11_sink_t DHT11_Sink_Get(void) {
+	return sink_active;
+}
+
+/**
+ * @brief Selects one of the built-in sinks by wire format.
+ */
+void DHT11_Sink_SetFormat(dht11_format_t format) {
+	if ((uint32_t) format < (sizeof(sink_formats) / sizeof(sink_formats[0]))) {
+		if (format == DHT11_FORMAT_DELTA) {
+			Telemetry_DeltaReset(); /* The host starts from keyframes */
+		}
+		if (format == DHT11_FORMAT_SCHEMA) {
+			Telemetry_SchemaReset(); /* ... or from the schema */
+		}
+		DHT11_Sink_Set(sink_formats[format]);
+	}
+}
+
+/**
+ * @brief Returns the format of the active sink.
+ */
+dht11_format_t DHT11_Sink_GetFormat(void) {
+	if (sink_active == DHT11_Sink_Text) {
+		return DHT11_FORMAT_TEXT;
+	}
+	if (sink_active == Telemetry_Sink) {
+		return DHT11_FORMAT_BINARY;
+	}
+	if (sink_active == Telemetry_DeltaSink) {
+		return DHT11_FORMAT_DELTA;
+	}
+	if (sink_active == Telemetry_BatchSink) {
+		return DHT11_FORMAT_BATCH;
+	}
+	if (sink_active == Telemetry_SchemaSink) {
+		return DHT11_FORMAT_SCHEMA;
+	}
+	return DHT11_FORMAT_NONE;
+}
+
+/**
+ * @brief Updates the status LED (status_led.h), filters the reading
+ *        (dht11_filter.h), publishes it as the sensor's latest
+ *        (dht11_latest.h), records it
+ *        in the backup SRAM history, the flash log and the I2C register
+ *        map (i2c_regmap.h), checks it against the die temperature
+ *        (adc_mon.h), adds it to the aggregation windows
+ *        (dht11_agg.h), and forwards it to the sink and the CAN bus
+ *        (can_bus.h) if raw readings are on and the emission policy
+ *        (dht11_emit.h) lets it; the sink only while the TX ring's
+ *        backpressure allows (uart_tx.h).
+ */
+void DHT11_Sink_Emit(const dht11_reading_t *reading) {
+	dht11_reading_t filtered = *reading;
+
+	Status_Led_Update(&filtered);
+	SWO_READING(reading);
+	(void) DHT11_Filter_Apply(&filtered);
+	ADC_MON_CHECK(&filtered);
+	DHT11_Latest_Publish(&filtered);
+	History_Append(&filtered);
+	FlashLog_Append(&filtered);
+	I2C_REGMAP_READING(&filtered);
+	DHT11_Agg_Add(&filtered);
+	if (DHT11_Agg_PassRaw() == 0U) {
+		return;
+	}
+	if ((sink_active == NULL) && (Can_Bus_IsStarted() == 0U)) {
+		return;
+	}
+	if (DHT11_Emit_Decide(&filtered) == 0U) {
+		return;
+	}
+	if ((sink_active != NULL) && (DHT11_Sink_Shed(0U) == 0U)) {
+		sink_active(&filtered);
+	}
+	CAN_BUS_READING(&filtered);
+}
+
+/**
+ * @brief Human-readable line of the calibrated and derived values; a
+ *        reading goes through fmt.h, not printf. Once the wall clock is
+ *        synced, lines start with the UTC time of the acquisition.
+ */
+void DHT11_Sink_Text(const dht11_reading_t *reading) {
+	dht11_values_t values;
+	fmt_t line;
+	uint8_t valid;
+
+	valid = DHT11_Calib_Process(reading, &values);
+	if ((valid == 0U) && (reading->status == DHT11_ERR_NO_RESPONSE)) {
+		return;
+	}
+
+	Fmt_Begin(&line);
+	Wallclock_Stamp(&line, reading->timestamp_ms);
+	if (valid != 0U) {
+		DEBUG_PRINT("Humidity: %d.%d %%\tTemperature: %d.%d °C\r\n",
+				reading->raw[0], reading->raw[1], reading->raw[2], reading->raw[3]);
+		Fmt_Str(&line, "Humidity: ");
+		Fmt_Fixed(&line, values.hum, 1U);
+		Fmt_Str(&line, " % RH \t Temperature: ");
+		Fmt_Fixed(&line, values.temp, 1U);
+		Fmt_Str(&line, " deg C \t Dew point: ");
+		Fmt_Fixed(&line, values.dew_point, 1U);
+		Fmt_Str(&line, " deg C \t Heat index: ");
+		Fmt_Fixed(&line, values.heat_index, 1U);
+		Fmt_Str(&line, " deg C \t Abs humidity: ");
+		Fmt_Fixed(&line, (int32_t) values.abs_hum, 2U);
+		Fmt_Str(&line, " g/m3 \t Confidence: ");
+		Fmt_Uint(&line, reading->confidence, 0U, ' ');
+		Fmt_Str(&line, " %\r\n");
+	} else if (reading->status == DHT11_ERR_CHECKSUM) {
+		Fmt_Str(&line, "DHT11 checksum error\r\n");
+	} else {
+		Fmt_Str(&line, "DHT11 ");
+		Fmt_Str(&line, DHT11_StatusName(reading->status));
+		Fmt_Str(&line, " error\r\n");
+	}
+	(void) Fmt_End(&line);
+}
+
+/**
+ * @brief Sends a window summary in the active sink's format.
+ */
+void DHT11_Sink_Summary(const dht11_agg_summary_t *summary) {
+	fmt_t line;
+
+	if ((sink_active == NULL) || (DHT11_Sink_Shed(1U) != 0U)) {
+		return;
+	}
+	if ((sink_active == Telemetry_Sink) || (sink_active == Telemetry_DeltaSink)
+			|| (sink_active == Telemetry_BatchSink)
+			|| (sink_active == Telemetry_SchemaSink)) {
+		Telemetry_SendSummary(summary);
+		return;
+	}
+	if (sink_active != DHT11_Sink_Text) {
+		return;
+	}
+
+	Fmt_Begin(&line);
+	Wallclock_Stamp(&line, summary->start_ms);
+	Fmt_Str(&line, "Sensor ");
+	Fmt_Uint(&line, summary->sensor_id, 0U, ' ');
+	Fmt_Str(&line, " \t ");
+	Fmt_Uint(&line, summary->window_s, 0U, ' ');
+	Fmt_Str(&line, " s \t Readings: ");
+	Fmt_Uint(&line, summary->count, 0U, ' ');
+	Fmt_Str(&line, " \t Failed: ");
+	Fmt_Uint(&line, summary->failures, 0U, ' ');
+	if (summary->count != 0U) {
+		Fmt_Str(&line, " \t Temperature min/mean/max: ");
+		Fmt_Fixed(&line, summary->temp_min, 1U);
+		Fmt_Char(&line, '/');
+		Fmt_Fixed(&line, summary->temp_mean, 1U);
+		Fmt_Char(&line, '/');
+		Fmt_Fixed(&line, summary->temp_max, 1U);
+		Fmt_Str(&line, " deg C \t Humidity min/mean/max: ");
+		Fmt_Fixed(&line, summary->hum_min, 1U);
+		Fmt_Char(&line, '/');
+		Fmt_Fixed(&line, summary->hum_mean, 1U);
+		Fmt_Char(&line, '/');
+		Fmt_Fixed(&line, summary->hum_max, 1U);
+		Fmt_Str(&line, " % RH");
+	}
+	Fmt_Str(&line, "\r\n");
+	(void) Fmt_End(&line);
+}
+
+/**
+ * @brief Readings and summaries held back by backpressure.
+ */
+uint32_t DHT11_Sink_GetShed(void) {
+	return sink_shed;
+}
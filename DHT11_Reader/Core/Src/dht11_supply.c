@@ -0,0 +1,309 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_supply.c
+ * @brief          : GPIO-switched sensor supply: power gating between
+ *                   readings and power-cycle recovery of hung sensors.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "dht11_supply.h"
+#include "dht11_health.h"
+#include "dht11_sampler.h"
+#include "dht11_pin.h"
+#include "dht11_multi.h"
+#include "my_debug.h"
+
+#if DHT11_USE_SUPPLY
+
+/** Switch-on ahead of the warm-up: one poll period and one frame slot */
+#define SUPPLY_LEAD_MS  (DHT11_SUPPLY_POLL_MS + DHT11_SAMPLER_SLOT_MS)
+
+/**
+ * @brief Supply output of one sensor; port NULL when not switched.
+ */
+typedef struct {
+	GPIO_TypeDef *port;
+	uint16_t mask;
+} supply_pin_t;
+
+/**
+ * @brief Switching state of one sensor.
+ */
+typedef struct {
+	dht11_supply_state_t state;
+	uint8_t gating;
+	uint32_t switch_ms;      /*!< Off: when to power up. On: when powered */
+	uint32_t off_since_ms;
+	uint32_t cycle_failures; /*!< Failure count at the last power cycle   */
+	uint32_t cycles;
+	uint32_t off_ms;
+} supply_sensor_t;
+
+#define SUPPLY_PIN_ENTRY(sensor, p, num) \
+	[sensor] = { (p), (uint16_t) DHT11_PIN_MASK(num) },
+
+static const supply_pin_t supply_pins[DHT11_HEALTH_SENSORS] = {
+		DHT11_SUPPLY_PINS(SUPPLY_PIN_ENTRY) };
+
+static supply_sensor_t supply_sensors[DHT11_HEALTH_SENSORS];
+
+#if DHT11_USE_MULTI
+/* Channels held LOW for the multi-sensor reader */
+static uint32_t supply_held = 0U;
+#endif /* DHT11_USE_MULTI */
+
+/**
+ * @brief Drives a supply output.
+ */
+static void Supply_Output(uint32_t sensor, uint8_t on) {
+	const supply_pin_t *pin = &supply_pins[sensor];
+
+	if ((on != 0U) != (DHT11_SUPPLY_ACTIVE_LOW != 0)) {
+		pin->port->BSRR = pin->mask;
+	} else {
+		pin->port->BSRR = (uint32_t) pin->mask << 16U;
+	}
+}
+
+/**
+ * @brief Holds a sensor's data line LOW while it is unpowered, or releases
+ *        it to the pull-up.
+ */
+static void Supply_Line(uint32_t sensor, uint8_t hold) {
+#if DHT11_USE_MULTI
+	if (hold != 0U) {
+		supply_held |= 1UL << sensor;
+	} else {
+		supply_held &= ~(1UL << sensor);
+	}
+	DHT11_Multi_Hold(supply_held);
+#else
+	if (sensor != 0U) {
+		return;
+	}
+	if (hold != 0U) {
+		DHT11_Pin_Low();
+		DHT11_Pin_ModeGpio();
+	} else {
+		DHT11_Pin_Release();
+	}
+#endif /* DHT11_USE_MULTI */
+}
+
+/**
+ * @brief Removes power until on_ms.
+ */
+static void Supply_Off(uint32_t sensor, dht11_supply_state_t state,
+		uint32_t on_ms) {
+	supply_sensor_t *s = &supply_sensors[sensor];
+
+	if (s->state == DHT11_SUPPLY_ON) {
+		s->off_since_ms = HAL_GetTick();
+	}
+	Supply_Line(sensor, 1U);
+	Supply_Output(sensor, 0U);
+	s->state = state;
+	s->switch_ms = on_ms;
+}
+
+/**
+ * @brief Powers a sensor; it is warm DHT11_SUPPLY_WARMUP_MS later.
+ */
+static void Supply_On(uint32_t sensor, uint32_t now) {
+	supply_sensor_t *s = &supply_sensors[sensor];
+
+	if (s->state != DHT11_SUPPLY_ON) {
+		s->off_ms += now - s->off_since_ms;
+	}
+	Supply_Output(sensor, 1U);
+	Supply_Line(sensor, 0U);
+	s->state = DHT11_SUPPLY_ON;
+	s->switch_ms = now;
+}
+
+/**
+ * @brief Configures the supply outputs and powers every sensor.
+ */
+void DHT11_Supply_Init(void) {
+	GPIO_InitTypeDef GPIO_InitStruct = { 0 };
+	uint32_t i;
+
+	for (i = 0U; i < DHT11_HEALTH_SENSORS; i++) {
+		supply_sensors[i].state = DHT11_SUPPLY_UNSWITCHED;
+		if (supply_pins[i].port == NULL) {
+			continue;
+		}
+		/* Set the level first so the sensor never sees a glitch */
+		Supply_Output(i, 1U);
+		GPIO_InitStruct.Pin = supply_pins[i].mask;
+		GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
+		GPIO_InitStruct.Pull = GPIO_NOPULL;
+		GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+		HAL_GPIO_Init(supply_pins[i].port, &GPIO_InitStruct);
+
+		supply_sensors[i].state = DHT11_SUPPLY_ON;
+		supply_sensors[i].gating = 1U;
+		supply_sensors[i].switch_ms = 0U; /* Warm at DHT11_POWERUP_MS */
+	}
+}
+
+/**
+ * @brief Switches sensors on whose reading or reset is due.
+ */
+uint32_t DHT11_Supply_Poll(void) {
+	uint32_t now = HAL_GetTick();
+	uint32_t next = DHT11_SUPPLY_POLL_MS;
+	supply_sensor_t *s;
+	uint32_t i;
+
+	for (i = 0U; i < DHT11_HEALTH_SENSORS; i++) {
+		s = &supply_sensors[i];
+		if ((s->state != DHT11_SUPPLY_GATED) && (s->state != DHT11_SUPPLY_CYCLING)) {
+			continue;
+		}
+		if ((int32_t) (now - s->switch_ms) >= 0) {
+			if (s->state == DHT11_SUPPLY_CYCLING) {
+				DEBUG_INFO("DHT11 sensor %lu: powered up after reset\r\n", i);
+			}
+			Supply_On(i, now);
+		} else if ((s->switch_ms - now) < next) {
+			next = s->switch_ms - now;
+		}
+	}
+	return next;
+}
+
+/**
+ * @brief Gating or power cycle after a reading.
+ */
+void DHT11_Supply_Report(uint32_t sensor, dht11_status_t status) {
+	supply_sensor_t *s;
+	uint32_t failures;
+	uint32_t interval;
+	uint32_t now;
+
+	if ((sensor >= DHT11_HEALTH_SENSORS) || (supply_pins[sensor].port == NULL)) {
+		return;
+	}
+	s = &supply_sensors[sensor];
+	if (s->state != DHT11_SUPPLY_ON) {
+		return;
+	}
+	now = HAL_GetTick();
+
+	/* A latched sensor answers no retry: power it down after every run of
+	 * DHT11_SUPPLY_RESET_FAILURES failures */
+	failures = DHT11_Health_GetFailures(sensor);
+	if (status == DHT11_OK) {
+		s->cycle_failures = 0U;
+	} else if (failures >= (s->cycle_failures + DHT11_SUPPLY_RESET_FAILURES)) {
+		DEBUG_WARN("DHT11 sensor %lu: %lu failures, power cycle\r\n", sensor,
+				failures);
+		s->cycle_failures = failures;
+		s->cycles++;
+		Supply_Off(sensor, DHT11_SUPPLY_CYCLING, now + DHT11_SUPPLY_OFF_MS);
+		return;
+	}
+
+	interval = DHT11_Sampler_IntervalMs((uint8_t) sensor);
+	if ((s->gating != 0U) && (interval >= (DHT11_SUPPLY_WARMUP_MS
+			+ DHT11_SUPPLY_GATE_MIN_MS + SUPPLY_LEAD_MS))) {
+		Supply_Off(sensor, DHT11_SUPPLY_GATED,
+				now + interval - DHT11_SUPPLY_WARMUP_MS - SUPPLY_LEAD_MS);
+	}
+}
+
+/**
+ * @brief Time until a sensor has power and has warmed up.
+ */
+uint32_t DHT11_Supply_ReadyInMs(uint32_t sensor) {
+	const supply_sensor_t *s;
+	uint32_t now = HAL_GetTick();
+	int32_t left;
+
+	if (sensor >= DHT11_HEALTH_SENSORS) {
+		return 0U;
+	}
+	s = &supply_sensors[sensor];
+	switch (s->state) {
+	case DHT11_SUPPLY_ON:
+		left = (int32_t) (s->switch_ms + DHT11_SUPPLY_WARMUP_MS - now);
+		return (left > 0) ? (uint32_t) left : 0U;
+	case DHT11_SUPPLY_GATED:
+	case DHT11_SUPPLY_CYCLING:
+		left = (int32_t) (s->switch_ms - now);
+		return ((left > 0) ? (uint32_t) left : 0U) + DHT11_SUPPLY_WARMUP_MS;
+	default:
+		return 0U;
+	}
+}
+
+/**
+ * @brief Enables or disables gating of one sensor.
+ */
+uint8_t DHT11_Supply_SetGating(uint32_t sensor, uint8_t gating) {
+	if ((sensor >= DHT11_HEALTH_SENSORS) || (supply_pins[sensor].port == NULL)) {
+		return 0U;
+	}
+	supply_sensors[sensor].gating = (gating != 0U) ? 1U : 0U;
+	if ((gating == 0U) && (supply_sensors[sensor].state == DHT11_SUPPLY_GATED)) {
+		Supply_On(sensor, HAL_GetTick());
+	}
+	return 1U;
+}
+
+/**
+ * @brief Starts a power cycle of one sensor now.
+ */
+uint8_t DHT11_Supply_Cycle(uint32_t sensor) {
+	if ((sensor >= DHT11_HEALTH_SENSORS) || (supply_pins[sensor].port == NULL)) {
+		return 0U;
+	}
+	supply_sensors[sensor].cycles++;
+	Supply_Off(sensor, DHT11_SUPPLY_CYCLING, HAL_GetTick() + DHT11_SUPPLY_OFF_MS);
+	return 1U;
+}
+
+/**
+ * @brief Supply state and counters of one sensor.
+ */
+dht11_supply_info_t DHT11_Supply_GetInfo(uint32_t sensor) {
+	dht11_supply_info_t info = { DHT11_SUPPLY_UNSWITCHED, 0U, 0U, 0U, 0U };
+	const supply_sensor_t *s;
+
+	if (sensor >= DHT11_HEALTH_SENSORS) {
+		return info;
+	}
+	s = &supply_sensors[sensor];
+	info.state = s->state;
+	info.gating = s->gating;
+	info.ready_in_ms = DHT11_Supply_ReadyInMs(sensor);
+	info.cycles = s->cycles;
+	info.off_ms = s->off_ms;
+	if ((s->state == DHT11_SUPPLY_GATED) || (s->state == DHT11_SUPPLY_CYCLING)) {
+		info.off_ms += HAL_GetTick() - s->off_since_ms;
+	}
+	return info;
+}
+
+/**
+ * @brief Short printable name of a supply state.
+ */
+const char* DHT11_Supply_Name(dht11_supply_state_t state) {
+	switch (state) {
+	case DHT11_SUPPLY_ON:
+		return "on";
+	case DHT11_SUPPLY_GATED:
+		return "gated";
+	case DHT11_SUPPLY_CYCLING:
+		return "cycling";
+	default:
+		return "unswitched";
+	}
+}
+
+#endif /* DHT11_USE_SUPPLY */
@@ -0,0 +1,248 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_sync.c
+ * @brief          : Cross-board sampling lock to a shared sync pulse.
+ *
+ *                   The handler keeps the last two pulse stamps; readers
+ *                   copy them with the handler's level masked, then do the
+ *                   slot arithmetic on the copy. Differences are taken on
+ *                   the wrapping counts, which holds while the holdover
+ *                   stays far below the 71.6 min TIM5 wrap.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "dht11_sync.h"
+#include "systime.h"
+#include "irq_prio.h"
+
+#define DHT11_SYNC_EXTI_LINE (1UL << DHT11_SYNC_PIN_NUM)
+
+/* Written by the handler and by DHT11_Sync_StopEnd() */
+static volatile uint32_t sync_pulse_us = 0U;
+static volatile uint32_t sync_pulse_ms = 0U;
+static volatile uint32_t sync_prev_us = 0U;
+static volatile uint32_t sync_pulses = 0U;
+static volatile uint32_t sync_rejected = 0U;
+static volatile uint32_t sync_interval_us = 0U;
+static volatile uint32_t sync_jitter_us = 0U;
+static volatile uint8_t sync_stopped = 0U;    /* Counts frozen          */
+static volatile uint8_t sync_stop_pulse = 0U; /* Pulse woke or hit STOP */
+
+static uint32_t sync_offset_ms = DHT11_SYNC_DEFAULT_OFFSET_MS;
+
+/**
+ * @brief Takes the interval ending at the last stamp into the statistics.
+ */
+static void DHT11_Sync_Measure(void) {
+	uint32_t interval;
+	uint32_t change;
+
+	if (sync_pulses < 2U) {
+		return;
+	}
+	interval = sync_pulse_us - sync_prev_us;
+	if (sync_interval_us != 0U) {
+		change = (interval > sync_interval_us) ?
+				(interval - sync_interval_us) : (sync_interval_us - interval);
+		/* A missed pulse doubles the interval; that is not jitter */
+		if ((change < (sync_interval_us / 4U)) && (change > sync_jitter_us)) {
+			sync_jitter_us = change;
+		}
+	}
+	sync_interval_us = interval;
+}
+
+/**
+ * @brief Takes a pulse unless it follows the last one too closely.
+ *        Handler level or masked.
+ */
+static void DHT11_Sync_Stamp(uint32_t now_us) {
+	if ((sync_pulses != 0U)
+			&& ((now_us - sync_pulse_us) < (DHT11_SYNC_MIN_PULSE_MS * 1000U))) {
+		sync_rejected++;
+		return;
+	}
+	sync_prev_us = sync_pulse_us;
+	sync_pulse_us = now_us;
+	sync_pulse_ms = HAL_GetTick();
+	sync_pulses++;
+	DHT11_Sync_Measure();
+}
+
+/**
+ * @brief First slot of base + k * period at or after a time, on a
+ *        wrapping count.
+ */
+static uint32_t DHT11_Sync_Slot(uint32_t base, uint32_t after, uint32_t period) {
+	uint32_t d;
+
+	if ((int32_t) (after - base) <= 0) {
+		d = base - after;
+		return base - ((d / period) * period);
+	}
+	d = after - base;
+	return base + (((d + period - 1U) / period) * period);
+}
+
+/**
+ * @brief Copies the last stamp; 0 if the lock has expired.
+ */
+static uint8_t DHT11_Sync_Last(uint32_t *pulse_us, uint32_t *pulse_ms) {
+	uint32_t basepri = Irq_MaskFrom(IRQ_PRIO_TIMEBASE);
+	uint32_t pulses = sync_pulses;
+
+	*pulse_us = sync_pulse_us;
+	*pulse_ms = sync_pulse_ms;
+	Irq_Unmask(basepri);
+	return ((pulses != 0U)
+			&& ((HAL_GetTick() - *pulse_ms) < DHT11_SYNC_HOLDOVER_MS)) ? 1U : 0U;
+}
+
+/**
+ * @brief Configures PA0 and EXTI0 and clears the lock.
+ */
+void DHT11_Sync_Init(void) {
+	uint32_t basepri = Irq_MaskFrom(IRQ_PRIO_TIMEBASE);
+
+	sync_pulses = 0U;
+	sync_rejected = 0U;
+	sync_interval_us = 0U;
+	sync_jitter_us = 0U;
+	sync_offset_ms = DHT11_SYNC_DEFAULT_OFFSET_MS;
+	Irq_Unmask(basepri);
+
+	__HAL_RCC_GPIOA_CLK_ENABLE();
+	__HAL_RCC_SYSCFG_CLK_ENABLE();
+	DHT11_SYNC_GPIO_Port->MODER &= ~(GPIO_MODER_MODER0 << (2U * DHT11_SYNC_PIN_NUM));
+	DHT11_SYNC_GPIO_Port->PUPDR = (DHT11_SYNC_GPIO_Port->PUPDR
+			& ~(GPIO_PUPDR_PUPDR0 << (2U * DHT11_SYNC_PIN_NUM)))
+			| (GPIO_PUPDR_PUPDR0_1 << (2U * DHT11_SYNC_PIN_NUM)); /* Pull-down */
+
+	SYSCFG->EXTICR[DHT11_SYNC_PIN_NUM / 4U] &=
+			~(0xFUL << (4U * (DHT11_SYNC_PIN_NUM % 4U))); /* Port A */
+	EXTI->RTSR |= DHT11_SYNC_EXTI_LINE;
+	EXTI->FTSR &= ~DHT11_SYNC_EXTI_LINE;
+	EXTI->EMR &= ~DHT11_SYNC_EXTI_LINE;
+	EXTI->PR = DHT11_SYNC_EXTI_LINE;
+	EXTI->IMR |= DHT11_SYNC_EXTI_LINE; /* Also wakes from STOP */
+	HAL_NVIC_SetPriority(EXTI0_IRQn, IRQ_PRIO_TIMEBASE, 0U);
+	HAL_NVIC_EnableIRQ(EXTI0_IRQn);
+}
+
+/**
+ * @brief Sets the node offset from the pulse.
+ */
+uint8_t DHT11_Sync_SetOffset(uint32_t offset_ms) {
+	if (offset_ms > DHT11_SYNC_MAX_OFFSET_MS) {
+		return 0U;
+	}
+	sync_offset_ms = offset_ms;
+	return 1U;
+}
+
+/**
+ * @brief Node offset from the pulse.
+ */
+uint32_t DHT11_Sync_GetOffset(void) {
+	return sync_offset_ms;
+}
+
+/**
+ * @brief Reports whether the lock holds.
+ */
+uint8_t DHT11_Sync_IsLocked(void) {
+	uint32_t pulse_us;
+	uint32_t pulse_ms;
+
+	return DHT11_Sync_Last(&pulse_us, &pulse_ms);
+}
+
+/**
+ * @brief First locked slot at or after a HAL tick.
+ */
+uint8_t DHT11_Sync_SlotMs(uint32_t after_ms, uint32_t period_ms,
+		uint32_t phase_ms, uint32_t *slot_ms) {
+	uint32_t pulse_us;
+	uint32_t pulse_ms;
+
+	if ((period_ms == 0U) || (DHT11_Sync_Last(&pulse_us, &pulse_ms) == 0U)) {
+		return 0U;
+	}
+	*slot_ms = DHT11_Sync_Slot(pulse_ms + sync_offset_ms + phase_ms, after_ms,
+			period_ms);
+	return 1U;
+}
+
+/**
+ * @brief First locked slot at or after a TIM5 count.
+ */
+uint8_t DHT11_Sync_SlotUs(uint32_t after_us, uint32_t period_us,
+		uint32_t *slot_us) {
+	uint32_t pulse_us;
+	uint32_t pulse_ms;
+
+	if ((period_us == 0U) || (DHT11_Sync_Last(&pulse_us, &pulse_ms) == 0U)) {
+		return 0U;
+	}
+	*slot_us = DHT11_Sync_Slot(pulse_us + (sync_offset_ms * 1000U), after_us,
+			period_us);
+	return 1U;
+}
+
+/**
+ * @brief Fills the lock state.
+ */
+void DHT11_Sync_GetStats(dht11_sync_stats_t *stats) {
+	uint32_t pulse_us;
+	uint32_t pulse_ms;
+	uint32_t basepri;
+
+	stats->locked = DHT11_Sync_Last(&pulse_us, &pulse_ms);
+	basepri = Irq_MaskFrom(IRQ_PRIO_TIMEBASE);
+	stats->pulses = sync_pulses;
+	stats->rejected = sync_rejected;
+	stats->interval_us = sync_interval_us;
+	stats->jitter_us = sync_jitter_us;
+	Irq_Unmask(basepri);
+	stats->age_ms = (stats->pulses != 0U) ? (HAL_GetTick() - pulse_ms) : 0U;
+}
+
+/**
+ * @brief Holds pulse stamps back while TIM5 and the tick are frozen.
+ */
+void DHT11_Sync_StopBegin(void) {
+	sync_stopped = 1U;
+}
+
+/**
+ * @brief Stamps a pulse that arrived during STOP, now that the counts have
+ *        been stepped over it.
+ */
+void DHT11_Sync_StopEnd(void) {
+	uint32_t basepri = Irq_MaskFrom(IRQ_PRIO_TIMEBASE);
+
+	sync_stopped = 0U;
+	if (sync_stop_pulse != 0U) {
+		sync_stop_pulse = 0U;
+		DHT11_Sync_Stamp(SysTime_Now());
+	}
+	Irq_Unmask(basepri);
+}
+
+/**
+ * @brief EXTI line 0: stamps a pulse, or leaves it to DHT11_Sync_StopEnd().
+ */
+void DHT11_Sync_IRQHandler(void) {
+	uint32_t now_us = SysTime_Now();
+
+	EXTI->PR = DHT11_SYNC_EXTI_LINE;
+	if (sync_stopped != 0U) {
+		sync_stop_pulse = 1U;
+		return;
+	}
+	DHT11_Sync_Stamp(now_us);
+}
@@ -0,0 +1,263 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_trace.c
+ * @brief          : Raw frame recorder and its bulk dump.
+ *
+ *                   A frame is built in a scratch record and copied into
+ *                   the ring only when its status is kept, so a run of
+ *                   good frames in DHT11_TRACE_FAILED mode never pushes a
+ *                   failure out. The copy into the ring and the copy out
+ *                   of it are the only sections with interrupts masked.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "dht11_trace.h"
+#include "telemetry.h"
+#include "crc.h"
+#include "uart_tx.h"
+#include "app_pools.h"
+#include <stddef.h>
+#include <string.h>
+
+_Static_assert(TELEMETRY_COBS_MAX(TELEMETRY_TRACE_LEN(DHT11_TRACE_EDGES))
+		<= APP_POOL_PACKET_SIZE, "trace packet larger than a packet buffer");
+
+static dht11_trace_rec_t trace_ring[DHT11_TRACE_RECORDS];
+static dht11_trace_rec_t trace_open;
+static uint8_t trace_is_open = 0U;
+static uint32_t trace_head = 0U;
+static uint32_t trace_tail = 0U;
+static uint32_t trace_recorded = 0U;
+static uint32_t trace_overwritten = 0U;
+static uint16_t trace_seq = 0U;
+static dht11_trace_mode_t trace_mode = DHT11_TRACE_DEFAULT_MODE;
+
+/**
+ * @brief Empties the ring and applies the default mode.
+ */
+void DHT11_Trace_Init(void) {
+	trace_head = 0U;
+	trace_tail = 0U;
+	trace_is_open = 0U;
+	trace_recorded = 0U;
+	trace_overwritten = 0U;
+	trace_seq = 0U;
+	trace_mode = DHT11_TRACE_DEFAULT_MODE;
+}
+
+/**
+ * @brief Selects which frames are recorded.
+ */
+void DHT11_Trace_SetMode(dht11_trace_mode_t mode) {
+	if (mode < DHT11_TRACE_MODES) {
+		trace_mode = mode;
+	}
+}
+
+/**
+ * @brief Active mode.
+ */
+dht11_trace_mode_t DHT11_Trace_GetMode(void) {
+	return trace_mode;
+}
+
+/**
+ * @brief Reports whether frames are being recorded.
+ */
+uint8_t DHT11_Trace_IsOn(void) {
+	return (trace_mode != DHT11_TRACE_OFF) ? 1U : 0U;
+}
+
+/**
+ * @brief Opens the scratch record for one frame.
+ */
+uint8_t DHT11_Trace_Begin(uint8_t sensor, uint8_t flags) {
+	if (trace_mode == DHT11_TRACE_OFF) {
+		trace_is_open = 0U;
+		return 0U;
+	}
+	trace_open.sensor_id = sensor;
+	trace_open.flags = flags & (DHT11_TRACE_BOTH | DHT11_TRACE_RELEASE);
+	trace_open.n = 0U;
+	trace_is_open = 1U;
+	return 1U;
+}
+
+/**
+ * @brief Adds one edge time to the open record.
+ */
+void DHT11_Trace_Edge(uint32_t t_us) {
+	if (trace_is_open == 0U) {
+		return;
+	}
+	if (trace_open.n >= DHT11_TRACE_EDGES) {
+		trace_open.flags |= DHT11_TRACE_CUT;
+		return;
+	}
+	trace_open.t_us[trace_open.n++] = (t_us > 0xFFFFU) ?
+			0xFFFFU : (uint16_t) t_us;
+}
+
+/**
+ * @brief Closes the open record, keeping it if the mode takes the status.
+ */
+void DHT11_Trace_End(dht11_status_t status) {
+	uint32_t primask;
+
+	if (trace_is_open == 0U) {
+		return;
+	}
+	trace_is_open = 0U;
+	if ((trace_mode == DHT11_TRACE_FAILED) && (status == DHT11_OK)) {
+		return;
+	}
+	trace_open.status = (uint8_t) status;
+	trace_open.timestamp_ms = HAL_GetTick();
+	trace_open.seq = trace_seq++;
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	if ((trace_head - trace_tail) >= DHT11_TRACE_RECORDS) {
+		trace_tail++;
+		trace_overwritten++;
+	}
+	memcpy(&trace_ring[trace_head & (DHT11_TRACE_RECORDS - 1U)], &trace_open,
+			offsetof(dht11_trace_rec_t, t_us)
+					+ ((uint32_t) trace_open.n * sizeof(uint16_t)));
+	trace_head++;
+	trace_recorded++;
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @brief Records waiting in the ring.
+ */
+uint32_t DHT11_Trace_Count(void) {
+	return trace_head - trace_tail;
+}
+
+/**
+ * @brief Frames recorded since boot.
+ */
+uint32_t DHT11_Trace_GetRecorded(void) {
+	return trace_recorded;
+}
+
+/**
+ * @brief Records lost because the ring was full.
+ */
+uint32_t DHT11_Trace_GetOverwritten(void) {
+	return trace_overwritten;
+}
+
+/**
+ * @brief Builds the 0x0A packet of the oldest record.
+ * @retval Packet length with the CRC, 0 if the ring is empty.
+ */
+static uint32_t DHT11_Trace_Packet(uint8_t *pkt) {
+	const dht11_trace_rec_t *rec;
+	uint32_t primask;
+	uint32_t len;
+	uint32_t i;
+	uint16_t crc;
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	if (trace_head == trace_tail) {
+		__set_PRIMASK(primask);
+		return 0U;
+	}
+	rec = &trace_ring[trace_tail & (DHT11_TRACE_RECORDS - 1U)];
+	pkt[0] = TELEMETRY_TYPE_TRACE;
+	pkt[1] = rec->n;
+	pkt[2] = rec->sensor_id;
+	pkt[3] = rec->status;
+	pkt[4] = rec->flags;
+	pkt[5] = (uint8_t) rec->seq;
+	pkt[6] = (uint8_t) (rec->seq >> 8);
+	pkt[7] = (uint8_t) rec->timestamp_ms;
+	pkt[8] = (uint8_t) (rec->timestamp_ms >> 8);
+	pkt[9] = (uint8_t) (rec->timestamp_ms >> 16);
+	pkt[10] = (uint8_t) (rec->timestamp_ms >> 24);
+	len = TELEMETRY_TRACE_HEADER;
+	for (i = 0U; i < rec->n; i++) {
+		pkt[len++] = (uint8_t) rec->t_us[i];
+		pkt[len++] = (uint8_t) (rec->t_us[i] >> 8);
+	}
+	__set_PRIMASK(primask);
+
+	crc = Crc_Ccitt16(pkt, len);
+	pkt[len++] = (uint8_t) crc;
+	pkt[len++] = (uint8_t) (crc >> 8);
+	return len;
+}
+
+/**
+ * @brief Removes the oldest record once sent, unless a frame recorded
+ *        meanwhile already pushed it out.
+ */
+static void DHT11_Trace_Retire(uint16_t seq) {
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	if ((trace_head != trace_tail)
+			&& (trace_ring[trace_tail & (DHT11_TRACE_RECORDS - 1U)].seq == seq)) {
+		trace_tail++;
+	}
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @brief Sends the oldest records as 0x0A packets.
+ */
+uint32_t DHT11_Trace_Drain(uint32_t max_records) {
+	uint8_t pkt[TELEMETRY_TRACE_LEN(DHT11_TRACE_EDGES)];
+	app_packet_t *frame;
+	uint32_t sent = 0U;
+	uint32_t len;
+
+	frame = AppPacketPool_Alloc(&app_packet_pool);
+	if (frame == NULL) {
+		return 0U;
+	}
+	while (sent < max_records) {
+		len = DHT11_Trace_Packet(pkt);
+		if (len == 0U) {
+			break;
+		}
+		len = Telemetry_CobsEncode(pkt, len, frame->data);
+		if (UART_TX_Free() < len) {
+			break; /* Caller flushes and calls again */
+		}
+		(void) UART_TX_Write(frame->data, len);
+		DHT11_Trace_Retire((uint16_t) (pkt[5] | ((uint16_t) pkt[6] << 8)));
+		sent++;
+	}
+	(void) AppPacketPool_Free(&app_packet_pool, frame);
+	return sent;
+}
+
+/**
+ * @brief Drops every waiting record.
+ */
+void DHT11_Trace_Clear(void) {
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	trace_tail = trace_head;
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @brief Short printable name of a mode.
+ */
+const char* DHT11_Trace_ModeName(dht11_trace_mode_t mode) {
+	static const char *const names[DHT11_TRACE_MODES] = { "off", "failed",
+			"all" };
+
+	return (mode < DHT11_TRACE_MODES) ? names[mode] : "?";
+}
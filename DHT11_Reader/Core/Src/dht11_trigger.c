@@ -0,0 +1,111 @@
+/**
+ ******************************************************************************
+ * @file           : dht11_trigger.c
+ * @brief          : On-demand readings from the user button B1 or a command.
+ *
+ *                   The handler and the command each count their own
+ *                   requests and the loop remembers the total it has
+ *                   taken, so no side needs to mask the other: a request
+ *                   is pending while the sum is ahead of what was taken.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "dht11_trigger.h"
+#include "dht11_emu.h"
+#include "irq_prio.h"
+
+#define DHT11_TRIGGER_EXTI_LINE (1UL << DHT11_TRIGGER_PIN_NUM)
+
+/* Written by the handler */
+static volatile uint32_t trigger_presses = 0U;
+static volatile uint32_t trigger_bounces = 0U;
+static uint32_t trigger_press_ms = 0U;
+
+/* Written by the thread */
+static volatile uint32_t trigger_commands = 0U;
+static uint32_t trigger_taken = 0U;
+static uint32_t trigger_served = 0U;
+
+/**
+ * @brief Configures PC13 and EXTI13.
+ */
+void DHT11_Trigger_Init(void) {
+	__HAL_RCC_GPIOC_CLK_ENABLE();
+	__HAL_RCC_SYSCFG_CLK_ENABLE();
+
+	/* Input, no pull: B1 has its own pull-up */
+	DHT11_TRIGGER_GPIO_Port->MODER &=
+			~(GPIO_MODER_MODER0 << (2U * DHT11_TRIGGER_PIN_NUM));
+	DHT11_TRIGGER_GPIO_Port->PUPDR &=
+			~(GPIO_PUPDR_PUPDR0 << (2U * DHT11_TRIGGER_PIN_NUM));
+
+	SYSCFG->EXTICR[DHT11_TRIGGER_PIN_NUM / 4U] =
+			(SYSCFG->EXTICR[DHT11_TRIGGER_PIN_NUM / 4U]
+					& ~(0xFUL << (4U * (DHT11_TRIGGER_PIN_NUM % 4U))))
+					| (2UL << (4U * (DHT11_TRIGGER_PIN_NUM % 4U))); /* Port C */
+	EXTI->FTSR |= DHT11_TRIGGER_EXTI_LINE;
+	EXTI->RTSR &= ~DHT11_TRIGGER_EXTI_LINE;
+	EXTI->EMR &= ~DHT11_TRIGGER_EXTI_LINE;
+	EXTI->PR = DHT11_TRIGGER_EXTI_LINE;
+	EXTI->IMR |= DHT11_TRIGGER_EXTI_LINE; /* Also wakes from STOP */
+#if !DHT11_EMU_USE_LOOPBACK
+	/* With the emulator the shared line keeps its capture level */
+	HAL_NVIC_SetPriority(EXTI15_10_IRQn, IRQ_PRIO_WAKEUP, 0U);
+#endif /* !DHT11_EMU_USE_LOOPBACK */
+	HAL_NVIC_EnableIRQ(EXTI15_10_IRQn);
+}
+
+/**
+ * @brief Asks for an on-demand reading.
+ */
+void DHT11_Trigger_Request(void) {
+	trigger_commands++;
+}
+
+/**
+ * @brief Takes the pending requests.
+ */
+uint8_t DHT11_Trigger_Take(void) {
+	uint32_t total = trigger_presses + trigger_commands;
+
+	if (total == trigger_taken) {
+		return 0U;
+	}
+	trigger_taken = total;
+	trigger_served++;
+	return 1U;
+}
+
+/**
+ * @brief Fills the trigger counters.
+ */
+void DHT11_Trigger_GetStats(dht11_trigger_stats_t *stats) {
+	stats->presses = trigger_presses;
+	stats->bounces = trigger_bounces;
+	stats->commands = trigger_commands;
+	stats->served = trigger_served;
+}
+
+/**
+ * @brief EXTI line 13: B1 pressed, unless it is still bouncing.
+ */
+void DHT11_Trigger_IRQHandler(void) {
+	uint32_t now;
+
+	if ((EXTI->PR & DHT11_TRIGGER_EXTI_LINE) == 0U) {
+		return;
+	}
+	EXTI->PR = DHT11_TRIGGER_EXTI_LINE;
+	now = HAL_GetTick();
+	if ((trigger_presses != 0U)
+			&& ((now - trigger_press_ms) < DHT11_TRIGGER_DEBOUNCE_MS)) {
+		trigger_bounces++;
+		return;
+	}
+	trigger_press_ms = now;
+	trigger_presses++;
+}
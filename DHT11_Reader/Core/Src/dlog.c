@@ -0,0 +1,177 @@
+/**
+ ******************************************************************************
+ * @file           : dlog.c
+ * @brief          : Deferred binary logging backend for the DEBUG_* macros.
+ *
+ *                   Writers reserve a slot by incrementing dlog_head with
+ *                   LDREX/STREX, fill it, then set its committed flag. The
+ *                   single reader (idle loop) consumes slots in order and
+ *                   stops at the first one that is not yet committed.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "dlog.h"
+#include "uart_tx.h"
+#include "systime.h"
+#include <stdio.h>
+#include <stdarg.h>
+
+#define DLOG_MASK        (DLOG_RING_ENTRIES - 1U)
+
+/** Start-of-record marker used by DLog_DumpBinary() */
+#define DLOG_SYNC_BYTE   (0xA5U)
+
+typedef struct {
+	const char *fmt;
+	uint32_t timestamp;
+	uint8_t level;
+	uint8_t nargs;
+	volatile uint8_t committed;
+	uint32_t args[DLOG_MAX_ARGS];
+} dlog_record_t;
+
+static dlog_record_t dlog_ring[DLOG_RING_ENTRIES];
+static volatile uint32_t dlog_head = 0U;
+static volatile uint32_t dlog_tail = 0U;
+static volatile uint32_t dlog_dropped = 0U;
+
+/* Prefixes match the printf-based macros in my_debug.h */
+static const char *const dlog_prefix[] = { "[INFO]  ", "[WARN]  ",
+		"[ERROR] ", "[DEBUG] " };
+
+/**
+ * @brief Stores one record.
+ */
+void DLog_Write(dlog_level_t level, const char *fmt, uint32_t nargs, ...) {
+	uint32_t idx;
+	uint32_t i;
+	dlog_record_t *rec;
+	va_list ap;
+
+	/* Reserve a slot without masking interrupts */
+	do {
+		idx = __LDREXW(&dlog_head);
+		if ((idx - dlog_tail) >= DLOG_RING_ENTRIES) {
+			__CLREX();
+			dlog_dropped++;
+			return;
+		}
+	} while (__STREXW(idx + 1U, &dlog_head) != 0U);
+
+	rec = &dlog_ring[idx & DLOG_MASK];
+	rec->fmt = fmt;
+	rec->timestamp = SysTime_Now();
+	rec->level = (uint8_t) level;
+	if (nargs > DLOG_MAX_ARGS) {
+		nargs = DLOG_MAX_ARGS;
+	}
+	rec->nargs = (uint8_t) nargs;
+
+	va_start(ap, nargs);
+	for (i = 0U; i < nargs; i++) {
+		rec->args[i] = va_arg(ap, uint32_t);
+	}
+	va_end(ap);
+
+	__DMB();
+	rec->committed = 1U;
+}
+
+/**
+ * @brief Copies out the oldest committed record.
+ * @retval 1 if a record was taken, 0 if none is ready.
+ */
+static uint8_t DLog_Take(dlog_record_t *out) {
+	dlog_record_t *rec;
+	uint32_t i;
+
+	if (dlog_tail == dlog_head) {
+		return 0U;
+	}
+	rec = &dlog_ring[dlog_tail & DLOG_MASK];
+	if (rec->committed == 0U) {
+		return 0U;
+	}
+
+	out->fmt = rec->fmt;
+	out->timestamp = rec->timestamp;
+	out->level = rec->level;
+	out->nargs = rec->nargs;
+	for (i = 0U; i < rec->nargs; i++) {
+		out->args[i] = rec->args[i];
+	}
+	for (; i < DLOG_MAX_ARGS; i++) {
+		out->args[i] = 0U;
+	}
+
+	rec->committed = 0U;
+	__DMB();
+	dlog_tail++;
+	return 1U;
+}
+
+/**
+ * @brief Formats pending records through printf.
+ */
+uint32_t DLog_Process(uint32_t max_records) {
+	dlog_record_t rec;
+	uint32_t count = 0U;
+
+	while ((count < max_records) && (DLog_Take(&rec) != 0U)) {
+		(void) printf("%s[%lu] ", dlog_prefix[rec.level & 3U], rec.timestamp);
+		/* Unused trailing arguments are ignored by printf */
+		(void) printf(rec.fmt, rec.args[0], rec.args[1], rec.args[2],
+				rec.args[3], rec.args[4], rec.args[5]);
+		count++;
+	}
+	return count;
+}
+
+/**
+ * @brief Sends pending records in binary form.
+ */
+uint32_t DLog_DumpBinary(uint32_t max_records) {
+	dlog_record_t rec;
+	uint8_t frame[12U + (4U * DLOG_MAX_ARGS)];
+	uint32_t count = 0U;
+	uint32_t len;
+	uint32_t word;
+	uint32_t i;
+	uint32_t b;
+
+	while ((count < max_records) && (DLog_Take(&rec) != 0U)) {
+		len = 0U;
+		frame[len++] = DLOG_SYNC_BYTE;
+		frame[len++] = (uint8_t) (10U + (4U * rec.nargs));
+		for (i = 0U; i < (2U + rec.nargs); i++) {
+			if (i == 0U) {
+				word = (uint32_t) rec.fmt;
+			} else if (i == 1U) {
+				word = rec.timestamp;
+			} else {
+				word = rec.args[i - 2U];
+			}
+			for (b = 0U; b < 4U; b++) {
+				frame[len++] = (uint8_t) (word >> (8U * b));
+			}
+			if (i == 1U) {
+				frame[len++] = rec.level;
+				frame[len++] = rec.nargs;
+			}
+		}
+		(void) UART_TX_Write(frame, len);
+		count++;
+	}
+	return count;
+}
+
+/**
+ * @brief Number of records lost because the ring was full.
+ */
+uint32_t DLog_GetDropped(void) {
+	return dlog_dropped;
+}
@@ -0,0 +1,143 @@
+/**
+ ******************************************************************************
+ * @file           : dvfs.c
+ * @brief          : Clock scaling around the scheduler's bursts of work.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "dvfs.h"
+#include "timebase.h"
+#include "uart_tx.h"
+#include "uart_baud.h"
+#include "app_rtos.h"
+#include "usb_cdc.h"
+#include "can_bus.h"
+#include "i2c_regmap.h"
+#include "modbus.h"
+#include "dht11_emu.h"
+#include "dht11_async.h"
+#include "dht11_multi.h"
+
+#if DVFS_USE_SCALING
+
+#if APP_USE_RTOS
+#error "DVFS_USE_SCALING hooks the cooperative scheduler's idle: set APP_USE_RTOS to 0"
+#endif
+
+extern UART_HandleTypeDef huart2;
+
+static clock_profile_t dvfs_burst = CLOCK_DEFAULT_PROFILE;
+static uint8_t dvfs_lowered = 0U;  /* Dropped by Dvfs_Idle(), not ramped yet */
+static uint32_t dvfs_drop_ms = 0U;
+static dvfs_stats_t dvfs_stats = { 0 };
+
+/**
+ * @brief Reports whether a profile switch would cut anything short.
+ */
+static uint8_t Dvfs_CanSwitch(void) {
+	if ((UART_Baud_IsPending() != 0U) || (UART_TX_Flush(0U) == 0U)
+			|| ((huart2.Instance->SR & USART_SR_TC) == 0U)
+			|| (Can_Bus_IsStarted() != 0U) || (I2C_Regmap_IsEnabled() != 0U)
+			|| (Modbus_IsActive() != 0U) || (DHT11_Emu_IsEnabled() != 0U)) {
+		return 0U;
+	}
+#if DHT11_USE_ASYNC
+	if (DHT11_Async_IsBusy() != 0U) {
+		return 0U;
+	}
+#endif /* DHT11_USE_ASYNC */
+#if DHT11_USE_MULTI
+	if (DHT11_Multi_IsComplete() == 0U) {
+		return 0U;
+	}
+#endif /* DHT11_USE_MULTI */
+	return 1U;
+}
+
+/**
+ * @brief Switches profile, anchoring the timebase at the old rate first.
+ */
+static HAL_StatusTypeDef Dvfs_Switch(clock_profile_t profile) {
+	Timebase_Recalibrate();
+	return Clock_SetProfile(profile);
+}
+
+/**
+ * @brief Takes the active profile as the burst profile.
+ */
+void Dvfs_Init(void) {
+	dvfs_burst = Clock_GetProfile();
+}
+
+/**
+ * @brief Lowers the clock for an idle period.
+ */
+uint32_t Dvfs_Idle(uint32_t budget_us) {
+	if (dvfs_lowered != 0U) {
+		if (budget_us > DVFS_RAMP_US) {
+			return budget_us - DVFS_RAMP_US;
+		}
+		/* Near the deadline: ramp now, the ramp is the wait */
+		Dvfs_Burst();
+		return 0U;
+	}
+	if ((budget_us < DVFS_IDLE_MIN_US) || (dvfs_burst == DVFS_IDLE_PROFILE)
+			|| (Usb_Cdc_IsStarted() != 0U)) {
+		return budget_us;
+	}
+	if ((Dvfs_CanSwitch() == 0U) || (Dvfs_Switch(DVFS_IDLE_PROFILE) != HAL_OK)) {
+		dvfs_stats.skipped++;
+		return budget_us;
+	}
+	dvfs_stats.drops++;
+	dvfs_lowered = 1U;
+	dvfs_drop_ms = HAL_GetTick();
+	return budget_us - DVFS_RAMP_US;
+}
+
+/**
+ * @brief Returns to the burst profile.
+ */
+void Dvfs_Burst(void) {
+	if (dvfs_lowered == 0U) {
+		return;
+	}
+	if ((Dvfs_CanSwitch() == 0U) || (Dvfs_Switch(dvfs_burst) != HAL_OK)) {
+		dvfs_stats.skipped++;
+		return;
+	}
+	dvfs_lowered = 0U;
+	dvfs_stats.ramps++;
+	dvfs_stats.idle_ms += HAL_GetTick() - dvfs_drop_ms;
+}
+
+/**
+ * @brief Sets the profile used for bursts and switches to it now.
+ */
+HAL_StatusTypeDef Dvfs_SetBurstProfile(clock_profile_t profile) {
+	if (profile >= CLOCK_PROFILE_COUNT) {
+		return HAL_ERROR;
+	}
+	if (dvfs_lowered != 0U) {
+		dvfs_lowered = 0U;
+		dvfs_stats.idle_ms += HAL_GetTick() - dvfs_drop_ms;
+	}
+	dvfs_burst = profile;
+	return Dvfs_Switch(profile);
+}
+
+/**
+ * @brief Copies the counters.
+ */
+void Dvfs_GetStats(dvfs_stats_t *stats) {
+	*stats = dvfs_stats;
+	if (dvfs_lowered != 0U) {
+		stats->idle_ms += HAL_GetTick() - dvfs_drop_ms;
+	}
+}
+
+#endif /* DVFS_USE_SCALING */
@@ -0,0 +1,1260 @@
+/**
+ ******************************************************************************
+ * @file           : flashlog.c
+ * @brief          : Wear-levelled reading log in the upper flash sectors.
+ *
+ *                   Word layout (bit 31 always 0, tag in bits 30:29):
+ *                     00 marker    kind 28:24, payload 23:0; a run is
+ *                                  sensor 23:21, count 20:0
+ *                     01 keyframe  sensor 28:26, hum 25:16, temp 15:5,
+ *                                  followed by a word of RTC seconds
+ *                     10 event     sensor 28:26, status 25:22, dt 21:0
+ *                     11 pair      sensor 28:26, code 25:13, code 12:0
+ *                   A code is ddt 12:10, dh 9:5, dT 4:0 (signed), where
+ *                   ddt is the change of the reading interval in seconds
+ *                   and dh/dT the steps in tenths. 0x1FFF is no reading.
+ *                   Keyframe, step and run decisions come from the
+ *                   dht11_delta.h stage; a step needs ddt in range and a
+ *                   run an unchanged interval.
+ *                   A block (FLASHLOG_USE_BLOCKS) is marker kind 5:
+ *                   sensor 23:21, count - 1 20:15, widths wd 14:11,
+ *                   wh 10:7, wT 6:3, whole-unit flags hum 1 and temp 0;
+ *                   then the first reading's RTC seconds, then its hum
+ *                   30:21, temp 20:10 and the interval to the second 9:0;
+ *                   then the later readings' zigzag ddt, dh, dT fields,
+ *                   LSB first, 31 bits to a word.
+ *                   A full sector ends with a seal marker holding the low
+ *                   24 bits of the CRC-32 (crc.h) of every word before it.
+ *
+ *                   The index is built by decoding the log the way the
+ *                   host does, at boot for both sectors and then for each
+ *                   batch of words once written: every record that starts
+ *                   in a span widens that span's time range.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "flashlog.h"
+#include "dht11_delta.h"
+#include "power.h"
+#include "telemetry.h"
+#include "crc.h"
+#include "uart_tx.h"
+#include "app_pools.h"
+#include <stdio.h>
+#include <string.h>
+
+#define FLASHLOG_WORDS         (FLASHLOG_SECTOR_SIZE / 4U)
+#define FLASHLOG_ERASED        (0xFFFFFFFFU)
+
+#if FLASHLOG_USE_BLOCKS
+/** Widest interval change field; a larger change starts a new block */
+#define FLASHLOG_BLOCK_DDT_BITS (8U)
+#define FLASHLOG_BLOCK_BASE_MAX (0x3FFU)
+#define FLASHLOG_BLOCK_HUM_X10  (1U << 1)
+#define FLASHLOG_BLOCK_TEMP_X10 (1U << 0)
+
+/** Header and payload of a block at the widest fields */
+#define FLASHLOG_BLOCK_MAX_WORDS (3U + ((((FLASHLOG_BLOCK_SAMPLES - 1U) \
+		* (FLASHLOG_BLOCK_DDT_BITS + 24U)) + 30U) / 31U))
+
+/** Most words one FlashLog_Append() writes that are not held already */
+#define FLASHLOG_APPEND_WORDS  (FLASHLOG_BLOCK_MAX_WORDS)
+#else
+/** Most words one FlashLog_Append() writes: pending, run, keyframe */
+#define FLASHLOG_APPEND_WORDS  (4U)
+#endif /* FLASHLOG_USE_BLOCKS */
+
+#define FLASHLOG_TAG_MARKER    (0x0U << 29)
+#define FLASHLOG_TAG_KEYFRAME  (0x1U << 29)
+#define FLASHLOG_TAG_EVENT     (0x2U << 29)
+#define FLASHLOG_TAG_PAIR      (0x3U << 29)
+
+/** Marker kinds; padding replaces a word whose programming failed */
+#define FLASHLOG_MARK_PAD      (0U)
+#define FLASHLOG_MARK_BOOT     (1U)
+#define FLASHLOG_MARK_SECTOR   (2U)
+#define FLASHLOG_MARK_RUN      (3U)
+#define FLASHLOG_MARK_SEAL     (4U)
+#define FLASHLOG_MARK_BLOCK    (5U)
+#define FLASHLOG_MAGIC         (0x4C4F47U) /* "LOG" */
+
+#define FLASHLOG_MARKER(kind, payload) (FLASHLOG_TAG_MARKER \
+		| ((uint32_t) (kind) << 24) | ((payload) & 0x00FFFFFFU))
+
+#define FLASHLOG_INDEX_PAGES   (FLASHLOG_WORDS / FLASHLOG_INDEX_SPAN)
+#define FLASHLOG_INDEX_NONE    (0xFFFFU)
+
+#define FLASHLOG_CODE_NONE     (0x1FFFU)
+#define FLASHLOG_HUM_MAX       (1023)
+#define FLASHLOG_TEMP_MIN      (-1024)
+#define FLASHLOG_TEMP_MAX      (1023)
+#define FLASHLOG_EVENT_DT_MAX  (0x003FFFFFU)
+
+/** Dump frame: type, count, sector, generation, word offset, words, CRC */
+#define FLASHLOG_PKT_HEADER_LEN (TELEMETRY_FLASHLOG_HEADER)
+#define FLASHLOG_PKT_MAX_LEN    (FLASHLOG_PKT_HEADER_LEN \
+		+ (FLASHLOG_CHUNK_WORDS * 4U) + 2U)
+
+_Static_assert(TELEMETRY_COBS_MAX(FLASHLOG_PKT_MAX_LEN) <= APP_POOL_PACKET_SIZE,
+		"APP_POOL_PACKET_SIZE too small for a flash log chunk");
+_Static_assert(FLASHLOG_PKT_MAX_LEN <= TELEMETRY_PKT_MAX,
+		"flash log chunk longer than TELEMETRY_PKT_MAX");
+_Static_assert(((FLASHLOG_WORDS % FLASHLOG_INDEX_SPAN) == 0U)
+		&& (FLASHLOG_INDEX_SPAN > FLASHLOG_APPEND_WORDS),
+		"every index span must start a record");
+
+#if FLASHLOG_USE_BLOCKS
+/**
+ * @brief Readings of one sensor waiting for their block.
+ */
+typedef struct {
+	uint32_t t0;                            /*!< Time of the first   */
+	uint32_t t_last;                        /*!< Time of the last    */
+	uint32_t n;
+	uint16_t dt[FLASHLOG_BLOCK_SAMPLES];    /*!< Interval to each    */
+	int16_t hum[FLASHLOG_BLOCK_SAMPLES];
+	int16_t temp[FLASHLOG_BLOCK_SAMPLES];
+} flashlog_block_t;
+
+/**
+ * @brief Field widths and size of a block.
+ */
+typedef struct {
+	uint32_t wd;
+	uint32_t wh;
+	uint32_t wt;
+	uint32_t flags;  /*!< FLASHLOG_BLOCK_*_X10 */
+	uint32_t words;  /*!< Header included     */
+} flashlog_layout_t;
+
+/**
+ * @brief Bit-packing accumulator, 31 bits to a word.
+ */
+typedef struct {
+	uint64_t acc;
+	uint32_t bits;
+} flashlog_packer_t;
+#endif /* FLASHLOG_USE_BLOCKS */
+
+/**
+ * @brief Encoder state of one sensor; the decoder tracks the same.
+ */
+typedef struct {
+	dht11_delta_enc_t enc; /*!< Values, run and keyframe cadence      */
+	uint32_t time_s;       /*!< Time of the last reading or event     */
+	int32_t dt_s;          /*!< Interval that led to it               */
+	uint16_t pending;      /*!< Code waiting for a pair, or CODE_NONE */
+	uint8_t timed;         /*!< Has a record to be relative to        */
+#if FLASHLOG_USE_BLOCKS
+	flashlog_block_t block;
+#endif /* FLASHLOG_USE_BLOCKS */
+} flashlog_sensor_t;
+
+/**
+ * @brief Time range of the records starting in one span of a sector.
+ */
+typedef struct {
+	uint32_t lo_s;   /*!< Earliest reading, UINT32_MAX if none      */
+	uint32_t hi_s;   /*!< Latest reading in the log up to this span */
+	uint16_t offset; /*!< First record, FLASHLOG_INDEX_NONE if none  */
+} flashlog_index_t;
+
+/**
+ * @brief A sensor's time as the decoder sees it, for the index.
+ */
+typedef struct {
+	uint32_t time_s;
+	int32_t dt_s;
+	uint8_t valid;
+} flashlog_track_t;
+
+/**
+ * @brief Progress of a streamed dump.
+ */
+typedef struct {
+	uint8_t active;
+	uint8_t sector;
+	uint8_t stop_sector;  /*!< FLASHLOG_SECTORS: to the head */
+	uint32_t generation;  /*!< Of the sector being sent */
+	uint32_t offset;      /*!< Next word to send        */
+	uint32_t stop_offset; /*!< Ends at or before this   */
+} flashlog_dump_t;
+
+#if !FLASHLOG_USE_BLOCKS
+/* 5-bit steps; a keyframe every 1024 readings bounds what a torn word
+ * can corrupt */
+static const dht11_delta_limits_t flashlog_limits = { -16, 15,
+		FLASHLOG_RUN_HOLD, 1024U };
+#endif /* FLASHLOG_USE_BLOCKS */
+
+static flashlog_sensor_t flashlog_sensors[FLASHLOG_SENSORS];
+static flashlog_dump_t flashlog_dump;
+static flashlog_index_t flashlog_index[FLASHLOG_SECTORS][FLASHLOG_INDEX_PAGES];
+static flashlog_track_t flashlog_tracks[FLASHLOG_SENSORS];
+static uint32_t flashlog_index_pos = 0U; /* Next active word to index   */
+static uint32_t flashlog_index_hi = 0U;  /* Latest reading indexed      */
+static uint32_t flashlog_active = 0U;
+static uint32_t flashlog_head = 0U;
+static uint32_t flashlog_generation = 0U;
+static uint32_t flashlog_errors = 0U;
+static flashlog_seal_t flashlog_seal = FLASHLOG_SEAL_NONE;
+static uint32_t flashlog_seal_crc = 0U; /* Expected while the check runs */
+static uint8_t flashlog_ready = 0U;
+
+/**
+ * @brief Memory-mapped words of a log sector.
+ */
+static const uint32_t* FlashLog_Words(uint32_t sector) {
+	return (const uint32_t*) (FLASHLOG_BASE + (sector * FLASHLOG_SECTOR_SIZE));
+}
+
+/**
+ * @brief Reads a sector header.
+ * @retval 1 with its generation if the sector is formatted, 0 otherwise.
+ */
+static uint8_t FlashLog_ReadHeader(uint32_t sector, uint32_t *generation) {
+	const uint32_t *words = FlashLog_Words(sector);
+
+	if ((words[0] != FLASHLOG_MARKER(FLASHLOG_MARK_SECTOR, FLASHLOG_MAGIC))
+			|| (words[1] == FLASHLOG_ERASED)) {
+		return 0U;
+	}
+	*generation = words[1];
+	return 1U;
+}
+
+/**
+ * @brief First erased word of a formatted sector.
+ */
+static uint32_t FlashLog_FindEnd(uint32_t sector) {
+	const uint32_t *words = FlashLog_Words(sector);
+	uint32_t lo = 2U;
+	uint32_t hi = FLASHLOG_WORDS;
+	uint32_t mid;
+
+	while (lo < hi) {
+		mid = lo + ((hi - lo) / 2U);
+		if (words[mid] == FLASHLOG_ERASED) {
+			hi = mid;
+		} else {
+			lo = mid + 1U;
+		}
+	}
+	return lo;
+}
+
+/**
+ * @brief Sector written before the active one, if it still holds data.
+ * @retval 1 if it is valid, 0 otherwise.
+ */
+static uint8_t FlashLog_OlderSector(uint32_t *sector) {
+	uint32_t generation;
+
+	*sector = (flashlog_active + FLASHLOG_SECTORS - 1U) % FLASHLOG_SECTORS;
+	return ((FlashLog_ReadHeader(*sector, &generation) != 0U)
+			&& (generation == (flashlog_generation - 1U))) ? 1U : 0U;
+}
+
+/**
+ * @brief Sign-extends a field.
+ */
+static int32_t FlashLog_Signed(uint32_t v, uint32_t bits) {
+	return (int32_t) (v << (32U - bits)) >> (32U - bits);
+}
+
+/**
+ * @brief Reads a field of a block payload, 31 bits to a word.
+ */
+static uint32_t FlashLog_Field(const uint32_t *payload, uint32_t bit,
+		uint32_t width) {
+	uint32_t i = bit / 31U;
+	uint32_t shift = bit % 31U;
+	uint32_t v;
+
+	if (width == 0U) {
+		return 0U;
+	}
+	v = (payload[i] & 0x7FFFFFFFU) >> shift;
+	if ((shift + width) > 31U) {
+		v |= payload[i + 1U] << (31U - shift);
+	}
+	return v & ((1UL << width) - 1U);
+}
+
+/**
+ * @brief Takes a reading time into a span's range.
+ */
+static void FlashLog_IndexTime(flashlog_index_t *e, uint32_t t) {
+	if (t < e->lo_s) {
+		e->lo_s = t;
+	}
+	if (t > flashlog_index_hi) {
+		flashlog_index_hi = t;
+	}
+	e->hi_s = flashlog_index_hi;
+}
+
+/**
+ * @brief Steps a sensor's time through a block.
+ * @retval Words of the block, or of the sector left when it is cut.
+ */
+static uint32_t FlashLog_IndexBlock(const uint32_t *w, uint32_t left,
+		flashlog_index_t *e) {
+	flashlog_track_t *trk = &flashlog_tracks[(w[0] >> 21) & 0x7U];
+	uint32_t n = ((w[0] >> 15) & 0x3FU) + 1U;
+	uint32_t wd = (w[0] >> 11) & 0xFU;
+	uint32_t bits = wd + ((w[0] >> 7) & 0xFU) + ((w[0] >> 3) & 0xFU);
+	uint32_t len = 3U + ((((n - 1U) * bits) + 30U) / 31U);
+	uint32_t i;
+	uint32_t t;
+	uint32_t z;
+	int32_t interval;
+
+	if (len > left) {
+		return left;
+	}
+	t = w[1] & 0x7FFFFFFFU;
+	trk->dt_s = ((trk->valid != 0U) && (t >= trk->time_s)) ?
+			(int32_t) (t - trk->time_s) : 0;
+	FlashLog_IndexTime(e, t);
+	interval = (int32_t) (w[2] & 0x3FFU);
+	for (i = 1U; i < n; i++) {
+		z = FlashLog_Field(&w[3], (i - 1U) * bits, wd);
+		interval += (int32_t) (z >> 1) ^ -(int32_t) (z & 1U);
+		t += (uint32_t) interval;
+		trk->dt_s = interval;
+	}
+	trk->time_s = t;
+	trk->valid = 1U;
+	FlashLog_IndexTime(e, t);
+	return len;
+}
+
+/**
+ * @brief Decodes the times of one record into a span's range.
+ * @retval Words of the record.
+ */
+static uint32_t FlashLog_IndexRecord(const uint32_t *w, uint32_t left,
+		flashlog_index_t *e) {
+	flashlog_track_t *trk = &flashlog_tracks[(w[0] >> 26) & 0x7U];
+	uint32_t kind;
+	uint32_t code;
+	uint32_t t;
+	uint32_t i;
+
+	switch (w[0] & (0x3U << 29)) {
+	case FLASHLOG_TAG_MARKER:
+		kind = (w[0] >> 24) & 0x1FU;
+		if ((kind == FLASHLOG_MARK_BOOT) || (kind == FLASHLOG_MARK_SECTOR)) {
+			memset(flashlog_tracks, 0, sizeof(flashlog_tracks));
+			return ((kind == FLASHLOG_MARK_SECTOR) && (left >= 2U)) ? 2U : 1U;
+		}
+		if (kind == FLASHLOG_MARK_BLOCK) {
+			return FlashLog_IndexBlock(w, left, e);
+		}
+		trk = &flashlog_tracks[(w[0] >> 21) & 0x7U];
+		if ((kind == FLASHLOG_MARK_RUN) && (trk->valid != 0U)
+				&& ((w[0] & 0x1FFFFFU) != 0U)) {
+			FlashLog_IndexTime(e, trk->time_s + (uint32_t) trk->dt_s);
+			trk->time_s += (uint32_t) trk->dt_s * (w[0] & 0x1FFFFFU);
+			FlashLog_IndexTime(e, trk->time_s);
+		}
+		return 1U;
+	case FLASHLOG_TAG_KEYFRAME:
+		if (left < 2U) {
+			return left;
+		}
+		t = w[1] & 0x7FFFFFFFU;
+		trk->dt_s = ((trk->valid != 0U) && (t >= trk->time_s)) ?
+				(int32_t) (t - trk->time_s) : 0;
+		trk->time_s = t;
+		trk->valid = 1U;
+		FlashLog_IndexTime(e, t);
+		return 2U;
+	case FLASHLOG_TAG_EVENT:
+		if (trk->valid != 0U) {
+			trk->dt_s = (int32_t) (w[0] & FLASHLOG_EVENT_DT_MAX);
+			trk->time_s += (uint32_t) trk->dt_s;
+			FlashLog_IndexTime(e, trk->time_s);
+		}
+		return 1U;
+	default:
+		for (i = 0U; (i < 2U) && (trk->valid != 0U); i++) {
+			code = (i == 0U) ? ((w[0] >> 13) & 0x1FFFU) : (w[0] & 0x1FFFU);
+			if (code != FLASHLOG_CODE_NONE) {
+				trk->dt_s += FlashLog_Signed(code >> 10, 3U);
+				trk->time_s += (uint32_t) trk->dt_s;
+				FlashLog_IndexTime(e, trk->time_s);
+			}
+		}
+		return 1U;
+	}
+}
+
+/**
+ * @brief Indexes the records of a sector from one word up to another.
+ * @retval Word after the last record indexed.
+ */
+static uint32_t FlashLog_IndexScan(uint32_t sector, uint32_t pos, uint32_t end) {
+	const uint32_t *words = FlashLog_Words(sector);
+	flashlog_index_t *e;
+
+	while (pos < end) {
+		e = &flashlog_index[sector][pos / FLASHLOG_INDEX_SPAN];
+		if (e->offset == FLASHLOG_INDEX_NONE) {
+			e->offset = (uint16_t) pos;
+			e->lo_s = UINT32_MAX;
+			e->hi_s = flashlog_index_hi;
+		}
+		pos += FlashLog_IndexRecord(&words[pos], end - pos, e);
+	}
+	return pos;
+}
+
+/**
+ * @brief Indexes what was written to the active sector since last time.
+ */
+static void FlashLog_IndexUpdate(void) {
+	flashlog_index_pos = FlashLog_IndexScan(flashlog_active,
+			flashlog_index_pos, flashlog_head);
+}
+
+/**
+ * @brief Empties a sector's index.
+ */
+static void FlashLog_IndexClear(uint32_t sector) {
+	uint32_t i;
+
+	for (i = 0U; i < FLASHLOG_INDEX_PAGES; i++) {
+		flashlog_index[sector][i].offset = FLASHLOG_INDEX_NONE;
+	}
+}
+
+/**
+ * @brief Spans of a sector that hold a record.
+ */
+static uint32_t FlashLog_IndexSpans(uint32_t sector) {
+	uint32_t n = 0U;
+
+	while ((n < FLASHLOG_INDEX_PAGES)
+			&& (flashlog_index[sector][n].offset != FLASHLOG_INDEX_NONE)) {
+		n++;
+	}
+	return n;
+}
+
+/**
+ * @brief Unlocks the flash and clears stale error flags.
+ */
+static void FlashLog_BeginWrite(void) {
+	(void) HAL_FLASH_Unlock();
+	__HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FLASH_FLAG_OPERR
+			| FLASH_FLAG_WRPERR | FLASH_FLAG_PGAERR | FLASH_FLAG_PGPERR
+			| FLASH_FLAG_PGSERR);
+}
+
+/**
+ * @brief Locks the flash and drops data cache lines read before the write.
+ */
+static void FlashLog_EndWrite(void) {
+	(void) HAL_FLASH_Lock();
+	if ((FLASH->ACR & FLASH_ACR_DCEN) != 0U) {
+		__HAL_FLASH_DATA_CACHE_DISABLE();
+		__HAL_FLASH_DATA_CACHE_RESET();
+		__HAL_FLASH_DATA_CACHE_ENABLE();
+	}
+}
+
+/**
+ * @brief Appends one word at the head of the active sector.
+ */
+static void FlashLog_Program(uint32_t word) {
+	uint32_t addr;
+
+	if (flashlog_head >= FLASHLOG_WORDS) {
+		flashlog_errors++;
+		return;
+	}
+	addr = FLASHLOG_BASE + (flashlog_active * FLASHLOG_SECTOR_SIZE)
+			+ (flashlog_head * 4U);
+	if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, addr, word) != HAL_OK) {
+		flashlog_errors++;
+		/* Clearing the remaining bits turns the slot into padding */
+		(void) HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, addr,
+				FLASHLOG_MARKER(FLASHLOG_MARK_PAD, 0U));
+	}
+	flashlog_head++;
+}
+
+/**
+ * @brief Forgets every sensor's state; the next reading is a keyframe.
+ */
+static void FlashLog_ResetSensors(void) {
+	uint32_t i;
+
+	for (i = 0U; i < FLASHLOG_SENSORS; i++) {
+		memset(&flashlog_sensors[i], 0, sizeof(flashlog_sensors[i]));
+		DHT11_Delta_Reset(&flashlog_sensors[i].enc);
+		flashlog_sensors[i].pending = FLASHLOG_CODE_NONE;
+	}
+}
+
+#if !FLASHLOG_USE_BLOCKS
+/**
+ * @brief Writes a sensor's pending reading alone in a pair word.
+ */
+static void FlashLog_FlushPending(uint32_t id) {
+	flashlog_sensor_t *s = &flashlog_sensors[id];
+
+	if (s->pending != FLASHLOG_CODE_NONE) {
+		FlashLog_Program(FLASHLOG_TAG_PAIR | (id << 26)
+				| ((uint32_t) s->pending << 13) | FLASHLOG_CODE_NONE);
+		s->pending = FLASHLOG_CODE_NONE;
+	}
+}
+
+/**
+ * @brief Pairs a code with the pending one, or holds it.
+ */
+static void FlashLog_Code(uint32_t id, uint32_t code) {
+	flashlog_sensor_t *s = &flashlog_sensors[id];
+
+	if (s->pending == FLASHLOG_CODE_NONE) {
+		s->pending = (uint16_t) code;
+	} else {
+		FlashLog_Program(FLASHLOG_TAG_PAIR | (id << 26)
+				| ((uint32_t) s->pending << 13) | code);
+		s->pending = FLASHLOG_CODE_NONE;
+	}
+}
+
+/**
+ * @brief Writes unchanged readings that came after the pending one.
+ */
+static void FlashLog_WriteRun(uint32_t id, uint32_t run) {
+	if (run == 1U) {
+		FlashLog_Code(id, 0U); /* A zero step is half a word */
+	} else if (run > 1U) {
+		FlashLog_FlushPending(id);
+		FlashLog_Program(FLASHLOG_MARKER(FLASHLOG_MARK_RUN, (id << 21) | run));
+	}
+}
+#endif /* FLASHLOG_USE_BLOCKS */
+
+#if FLASHLOG_USE_BLOCKS
+/**
+ * @brief Zigzag code of a signed step: 0, -1, 1, -2 ... to 0, 1, 2, 3 ...
+ */
+static uint32_t FlashLog_Zigzag(int32_t v) {
+	return ((uint32_t) v << 1) ^ (uint32_t) (v >> 31);
+}
+
+/**
+ * @brief Bits needed for the widest of some zigzag codes ORed together.
+ */
+static uint32_t FlashLog_Width(uint32_t codes) {
+	uint32_t bits = 0U;
+
+	while (codes != 0U) {
+		bits++;
+		codes >>= 1;
+	}
+	return bits;
+}
+
+/**
+ * @brief Picks the field widths of a block and counts its words.
+ */
+static void FlashLog_Layout(const flashlog_block_t *b, flashlog_layout_t *l) {
+	uint32_t zd = 0U;
+	uint32_t zh = 0U;
+	uint32_t zt = 0U;
+	uint32_t zh10 = 0U;
+	uint32_t zt10 = 0U;
+	uint32_t i;
+	int32_t dh;
+	int32_t dtemp;
+
+	l->flags = FLASHLOG_BLOCK_HUM_X10 | FLASHLOG_BLOCK_TEMP_X10;
+	for (i = 0U; i < b->n; i++) {
+		if ((b->hum[i] % 10) != 0) {
+			l->flags &= ~FLASHLOG_BLOCK_HUM_X10;
+		}
+		if ((b->temp[i] % 10) != 0) {
+			l->flags &= ~FLASHLOG_BLOCK_TEMP_X10;
+		}
+		if (i == 0U) {
+			continue;
+		}
+		if (i >= 2U) {
+			zd |= FlashLog_Zigzag((int32_t) b->dt[i] - (int32_t) b->dt[i - 1U]);
+		}
+		dh = (int32_t) b->hum[i] - b->hum[i - 1U];
+		dtemp = (int32_t) b->temp[i] - b->temp[i - 1U];
+		zh |= FlashLog_Zigzag(dh);
+		zt |= FlashLog_Zigzag(dtemp);
+		zh10 |= FlashLog_Zigzag(dh / 10);
+		zt10 |= FlashLog_Zigzag(dtemp / 10);
+	}
+	l->wd = FlashLog_Width(zd);
+	l->wh = FlashLog_Width(((l->flags & FLASHLOG_BLOCK_HUM_X10) != 0U) ? zh10 : zh);
+	l->wt = FlashLog_Width(((l->flags & FLASHLOG_BLOCK_TEMP_X10) != 0U) ? zt10 : zt);
+	l->words = (b->n == 0U) ? 0U : (3U + ((((b->n - 1U)
+			* (l->wd + l->wh + l->wt)) + 30U) / 31U));
+}
+
+/**
+ * @brief Adds a field to the packed payload, writing each full word.
+ */
+static void FlashLog_Pack(flashlog_packer_t *p, uint32_t code, uint32_t width) {
+	p->acc |= (uint64_t) code << p->bits;
+	p->bits += width;
+	if (p->bits >= 31U) {
+		FlashLog_Program((uint32_t) p->acc & 0x7FFFFFFFU);
+		p->acc >>= 31;
+		p->bits -= 31U;
+	}
+}
+
+/**
+ * @brief Writes a sensor's open block and empties it.
+ */
+static void FlashLog_WriteBlock(uint32_t id) {
+	flashlog_block_t *b = &flashlog_sensors[id].block;
+	flashlog_layout_t l;
+	flashlog_packer_t p = { 0U, 0U };
+	uint32_t hum_div;
+	uint32_t temp_div;
+	uint32_t i;
+
+	if (b->n == 0U) {
+		return;
+	}
+	FlashLog_Layout(b, &l);
+	hum_div = ((l.flags & FLASHLOG_BLOCK_HUM_X10) != 0U) ? 10U : 1U;
+	temp_div = ((l.flags & FLASHLOG_BLOCK_TEMP_X10) != 0U) ? 10U : 1U;
+	FlashLog_Program(FLASHLOG_MARKER(FLASHLOG_MARK_BLOCK, (id << 21)
+			| ((b->n - 1U) << 15) | (l.wd << 11) | (l.wh << 7) | (l.wt << 3)
+			| l.flags));
+	FlashLog_Program(b->t0 & 0x7FFFFFFFU);
+	FlashLog_Program(((uint32_t) b->hum[0] << 21)
+			| (((uint32_t) b->temp[0] & 0x7FFU) << 10)
+			| ((b->n >= 2U) ? b->dt[1] : 0U));
+	for (i = 1U; i < b->n; i++) {
+		FlashLog_Pack(&p, (i >= 2U) ? FlashLog_Zigzag((int32_t) b->dt[i]
+				- (int32_t) b->dt[i - 1U]) : 0U, l.wd);
+		FlashLog_Pack(&p, FlashLog_Zigzag(((int32_t) b->hum[i]
+				- b->hum[i - 1U]) / (int32_t) hum_div), l.wh);
+		FlashLog_Pack(&p, FlashLog_Zigzag(((int32_t) b->temp[i]
+				- b->temp[i - 1U]) / (int32_t) temp_div), l.wt);
+	}
+	if (p.bits != 0U) {
+		FlashLog_Program((uint32_t) p.acc);
+	}
+	b->n = 0U;
+}
+
+/**
+ * @brief Words the open blocks will take.
+ */
+static uint32_t FlashLog_HeldWords(void) {
+	flashlog_layout_t l;
+	uint32_t words = 0U;
+	uint32_t i;
+
+	for (i = 0U; i < FLASHLOG_SENSORS; i++) {
+		FlashLog_Layout(&flashlog_sensors[i].block, &l);
+		words += l.words;
+	}
+	return words;
+}
+#else
+/**
+ * @brief Words the pending readings and runs will take.
+ */
+static uint32_t FlashLog_HeldWords(void) {
+	return 2U * FLASHLOG_SENSORS;
+}
+#endif /* FLASHLOG_USE_BLOCKS */
+
+/**
+ * @brief Writes everything a sensor holds in RAM.
+ */
+static void FlashLog_FlushSensor(uint32_t id) {
+#if FLASHLOG_USE_BLOCKS
+	FlashLog_WriteBlock(id);
+#else
+	FlashLog_WriteRun(id, DHT11_Delta_TakeRun(&flashlog_sensors[id].enc));
+	FlashLog_FlushPending(id);
+#endif /* FLASHLOG_USE_BLOCKS */
+}
+
+/**
+ * @brief Collects a running check of the older sector's seal.
+ */
+static void FlashLog_CheckSeal(void) {
+	uint32_t crc;
+	HAL_StatusTypeDef status;
+
+	if (flashlog_seal != FLASHLOG_SEAL_CHECKING) {
+		return;
+	}
+	status = Crc_Hw32Poll(&crc);
+	if (status == HAL_OK) {
+		flashlog_seal = (((crc ^ flashlog_seal_crc) & 0x00FFFFFFU) == 0U) ?
+				FLASHLOG_SEAL_OK : FLASHLOG_SEAL_BAD;
+	} else if (status == HAL_ERROR) {
+		flashlog_seal = FLASHLOG_SEAL_NONE;
+	}
+}
+
+/**
+ * @brief Starts checking the older sector against its seal, by DMA.
+ */
+static void FlashLog_StartSealCheck(void) {
+	const uint32_t *words;
+	uint32_t older;
+	uint32_t end;
+
+	flashlog_seal = FLASHLOG_SEAL_NONE;
+	if (FlashLog_OlderSector(&older) == 0U) {
+		return;
+	}
+	words = FlashLog_Words(older);
+	end = FlashLog_FindEnd(older);
+	if ((end <= 2U) || (words[end - 1U] & 0xFF000000U) != FLASHLOG_MARKER(FLASHLOG_MARK_SEAL, 0U)) {
+		return; /* Written before seals, or its last word failed */
+	}
+	flashlog_seal_crc = words[end - 1U];
+	if (Crc_Hw32Start(words, end - 1U) == HAL_OK) {
+		flashlog_seal = FLASHLOG_SEAL_CHECKING;
+	}
+}
+
+/**
+ * @brief Erases a sector and writes its header.
+ */
+static void FlashLog_Format(uint32_t sector, uint32_t generation) {
+	FLASH_EraseInitTypeDef erase;
+	uint32_t sector_error;
+
+	/* The check reads the sector about to be erased: finish it first */
+	while (flashlog_seal == FLASHLOG_SEAL_CHECKING) {
+		FlashLog_CheckSeal();
+	}
+	erase.TypeErase = FLASH_TYPEERASE_SECTORS;
+	erase.Banks = FLASH_BANK_1;
+	erase.Sector = FLASHLOG_FIRST_SECTOR + sector;
+	erase.NbSectors = 1U;
+	erase.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+	if (HAL_FLASHEx_Erase(&erase, &sector_error) != HAL_OK) {
+		flashlog_errors++;
+	}
+
+	flashlog_active = sector;
+	flashlog_head = 0U;
+	flashlog_generation = generation;
+	FlashLog_IndexClear(sector);
+	flashlog_index_pos = 0U;
+	FlashLog_Program(FLASHLOG_MARKER(FLASHLOG_MARK_SECTOR, FLASHLOG_MAGIC));
+	FlashLog_Program(generation & 0x7FFFFFFFU);
+	FlashLog_ResetSensors();
+}
+
+/**
+ * @brief Makes room for words, moving to the next sector when needed.
+ *        The reserve keeps space for what every sensor holds in RAM and
+ *        the seal.
+ */
+static void FlashLog_Reserve(uint32_t words) {
+	uint32_t errors = flashlog_errors;
+	uint32_t crc;
+	uint32_t i;
+
+	if ((flashlog_head + words + FlashLog_HeldWords()) < FLASHLOG_WORDS) {
+		return;
+	}
+	for (i = 0U; i < FLASHLOG_SENSORS; i++) {
+		FlashLog_FlushSensor(i);
+	}
+	/* CPU-fed: the erase that follows stalls the bus anyway */
+	crc = Crc_Hw32(FlashLog_Words(flashlog_active), flashlog_head);
+	FlashLog_Program(FLASHLOG_MARKER(FLASHLOG_MARK_SEAL, crc));
+	FlashLog_IndexUpdate();
+	FlashLog_Format((flashlog_active + 1U) % FLASHLOG_SECTORS,
+			flashlog_generation + 1U);
+	/* The sector just sealed is the older one now */
+	flashlog_seal = (flashlog_errors == errors) ?
+			FLASHLOG_SEAL_OK : FLASHLOG_SEAL_NONE;
+}
+
+/**
+ * @brief RTC second at which the acquisition started.
+ */
+static uint32_t FlashLog_ReadingTime(const dht11_reading_t *reading) {
+	return Power_GetRtcSeconds()
+			- ((HAL_GetTick() - reading->timestamp_ms) / 1000U);
+}
+
+/**
+ * @brief Sets the time of a sensor's latest record.
+ * @param valid: Whether the sensor had a time before this record.
+ */
+static void FlashLog_SetTime(flashlog_sensor_t *s, uint32_t t, uint8_t valid) {
+	s->dt_s = ((valid != 0U) && (t >= s->time_s)) ?
+			(int32_t) (t - s->time_s) : 0;
+	s->time_s = t;
+	s->timed = 1U;
+}
+
+/**
+ * @brief Checks that t can follow the sensor's last record.
+ */
+static uint8_t FlashLog_TimeFits(const flashlog_sensor_t *s, uint32_t t) {
+	return ((s->timed != 0U) && (t >= s->time_s)
+			&& ((t - s->time_s) <= FLASHLOG_EVENT_DT_MAX)) ? 1U : 0U;
+}
+
+/**
+ * @brief Logs a failed acquisition against the sensor's last record.
+ */
+static void FlashLog_Event(uint32_t id, dht11_status_t status, uint32_t t) {
+	flashlog_sensor_t *s = &flashlog_sensors[id];
+
+	if (FlashLog_TimeFits(s, t) == 0U) {
+		return; /* Nothing to be relative to; the next keyframe restarts */
+	}
+	FlashLog_FlushSensor(id);
+	FlashLog_Program(FLASHLOG_TAG_EVENT | (id << 26)
+			| (((uint32_t) status & 0xFU) << 22) | (t - s->time_s));
+	FlashLog_SetTime(s, t, 1U);
+}
+
+/**
+ * @brief Finds the active sector and its head, then marks the boot.
+ */
+void FlashLog_Init(void) {
+	uint32_t generation;
+	uint32_t best_gen = 0U;
+	uint32_t best = FLASHLOG_SECTORS;
+	uint32_t i;
+
+	FlashLog_ResetSensors();
+	memset(flashlog_tracks, 0, sizeof(flashlog_tracks));
+	flashlog_index_hi = 0U;
+	for (i = 0U; i < FLASHLOG_SECTORS; i++) {
+		FlashLog_IndexClear(i);
+		if ((FlashLog_ReadHeader(i, &generation) != 0U)
+				&& ((best == FLASHLOG_SECTORS) || (generation > best_gen))) {
+			best = i;
+			best_gen = generation;
+		}
+	}
+
+	FlashLog_BeginWrite();
+	if (best == FLASHLOG_SECTORS) {
+		FlashLog_Format(0U, 1U);
+	} else {
+		flashlog_active = best;
+		flashlog_generation = best_gen;
+		flashlog_head = FlashLog_FindEnd(best);
+		if (FlashLog_OlderSector(&i) != 0U) {
+			(void) FlashLog_IndexScan(i, 0U, FlashLog_FindEnd(i));
+		}
+		flashlog_index_pos = 0U;
+		FlashLog_IndexUpdate();
+	}
+	FlashLog_Reserve(1U);
+	FlashLog_Program(FLASHLOG_MARKER(FLASHLOG_MARK_BOOT, 0U));
+	FlashLog_EndWrite();
+	FlashLog_IndexUpdate();
+	FlashLog_StartSealCheck();
+	flashlog_ready = 1U;
+}
+
+#if FLASHLOG_USE_BLOCKS
+/**
+ * @brief Adds a good reading to the sensor's block, writing the block out
+ *        first when the reading's interval change does not fit it, and
+ *        once it is full.
+ */
+static void FlashLog_Reading(uint32_t id, uint32_t t, int16_t hum,
+		int16_t temp) {
+	flashlog_sensor_t *s = &flashlog_sensors[id];
+	flashlog_block_t *b = &s->block;
+	uint32_t dt = 0U;
+	uint8_t fits = 0U;
+
+	if ((b->n != 0U) && (t >= b->t_last)
+			&& ((t - b->t_last) <= FLASHLOG_EVENT_DT_MAX)) {
+		dt = t - b->t_last;
+		if (b->n == 1U) {
+			fits = (dt <= FLASHLOG_BLOCK_BASE_MAX) ? 1U : 0U;
+		} else {
+			fits = (FlashLog_Zigzag((int32_t) dt - (int32_t) b->dt[b->n - 1U])
+					< (1UL << FLASHLOG_BLOCK_DDT_BITS)) ? 1U : 0U;
+		}
+	}
+	if (fits == 0U) {
+		FlashLog_WriteBlock(id);
+		b->t0 = t;
+	}
+	b->dt[b->n] = (uint16_t) dt;
+	b->hum[b->n] = hum;
+	b->temp[b->n] = temp;
+	b->t_last = t;
+	b->n++;
+	if (b->n >= FLASHLOG_BLOCK_SAMPLES) {
+		FlashLog_WriteBlock(id);
+	}
+	FlashLog_SetTime(s, t, s->timed);
+}
+#else
+/**
+ * @brief Logs a good reading through the delta stage as a keyframe, a
+ *        code or part of a run.
+ */
+static void FlashLog_Reading(uint32_t id, uint32_t t, int16_t hum,
+		int16_t temp) {
+	flashlog_sensor_t *s = &flashlog_sensors[id];
+	dht11_delta_t d;
+	dht11_delta_kind_t kind;
+	uint32_t flags = 0U;
+	uint32_t code = FLASHLOG_CODE_NONE;
+	int32_t ddt = 0;
+	uint8_t had_state = s->enc.valid;
+	uint8_t fits = FlashLog_TimeFits(s, t);
+
+	if (fits != 0U) {
+		ddt = (int32_t) (t - s->time_s) - s->dt_s;
+	}
+	if ((fits == 0U) || (ddt < -4) || (ddt > 3)) {
+		flags = DHT11_DELTA_FORCE_KEY;
+	} else if (ddt != 0) {
+		flags = DHT11_DELTA_NO_RUN; /* A run implies the interval */
+	}
+
+	kind = DHT11_Delta_Encode(&s->enc, &flashlog_limits, hum, temp, flags, &d);
+	if (kind != DHT11_DELTA_RUN) {
+		FlashLog_WriteRun(id, d.run);
+		if (kind == DHT11_DELTA_STEP) {
+			code = (((uint32_t) ddt & 0x7U) << 10)
+					| (((uint32_t) d.dh & 0x1FU) << 5)
+					| ((uint32_t) d.dtemp & 0x1FU);
+		}
+		if (code == FLASHLOG_CODE_NONE) {
+			/* Also ddt = dh = dT = -1, which reads as no reading */
+			FlashLog_FlushPending(id);
+			FlashLog_Program(FLASHLOG_TAG_KEYFRAME | (id << 26)
+					| ((uint32_t) hum << 16)
+					| (((uint32_t) temp & 0x7FFU) << 5));
+			FlashLog_Program(t & 0x7FFFFFFFU);
+		} else {
+			FlashLog_Code(id, code);
+		}
+	}
+	FlashLog_SetTime(s, t, had_state);
+}
+#endif /* FLASHLOG_USE_BLOCKS */
+
+/**
+ * @brief Logs a reading.
+ */
+void FlashLog_Append(const dht11_reading_t *reading) {
+	uint32_t id = reading->sensor_id;
+	uint32_t t;
+	int16_t hum;
+	int16_t temp;
+
+	if ((flashlog_ready == 0U) || (reading->status == DHT11_ERR_NO_RESPONSE)
+			|| (id >= FLASHLOG_SENSORS)) {
+		return;
+	}
+	t = FlashLog_ReadingTime(reading);
+	hum = DHT11_Delta_HumTenths(reading);
+	temp = DHT11_Delta_TempTenths(reading);
+
+	FlashLog_BeginWrite();
+	FlashLog_Reserve(FLASHLOG_APPEND_WORDS);
+	if (reading->status != DHT11_OK) {
+		FlashLog_Event(id, reading->status, t);
+	} else if ((hum > FLASHLOG_HUM_MAX) || (temp < FLASHLOG_TEMP_MIN)
+			|| (temp > FLASHLOG_TEMP_MAX)) {
+		FlashLog_Event(id, DHT11_ERR_FRAME, t);
+	} else {
+		FlashLog_Reading(id, t, hum, temp);
+	}
+	FlashLog_EndWrite();
+	FlashLog_IndexUpdate();
+}
+
+/**
+ * @brief Writes out what each sensor holds in RAM.
+ */
+void FlashLog_Flush(void) {
+	uint32_t i;
+
+	if (flashlog_ready == 0U) {
+		return;
+	}
+	FlashLog_BeginWrite();
+	for (i = 0U; i < FLASHLOG_SENSORS; i++) {
+		FlashLog_FlushSensor(i);
+	}
+	FlashLog_EndWrite();
+	FlashLog_IndexUpdate();
+}
+
+/**
+ * @brief Points the dump at a word of a sector of the log.
+ */
+static void FlashLog_DumpFrom(uint32_t sector, uint32_t offset) {
+	flashlog_dump.sector = (uint8_t) sector;
+	flashlog_dump.generation = (sector == flashlog_active) ?
+			flashlog_generation : (flashlog_generation - 1U);
+	flashlog_dump.offset = offset;
+}
+
+/**
+ * @brief Flushes and starts streaming the log from the oldest word.
+ */
+uint32_t FlashLog_StartDump(void) {
+	uint32_t older;
+
+	FlashLog_Flush();
+	FlashLog_DumpFrom((FlashLog_OlderSector(&older) != 0U) ?
+			older : flashlog_active, 0U);
+	flashlog_dump.stop_sector = FLASHLOG_SECTORS; /* The head, wherever */
+	flashlog_dump.stop_offset = 0U;
+	flashlog_dump.active = flashlog_ready;
+	return FlashLog_GetUsedWords();
+}
+
+/**
+ * @brief Sector and first word of the k-th indexed span, oldest first;
+ *        the head past the last.
+ */
+static void FlashLog_SpanAt(uint32_t k, uint32_t older, uint32_t older_spans,
+		uint32_t spans, uint32_t *sector, uint32_t *offset) {
+	if (k >= spans) {
+		*sector = flashlog_active;
+		*offset = flashlog_head;
+	} else if (k < older_spans) {
+		*sector = older;
+		*offset = flashlog_index[older][k].offset;
+	} else {
+		*sector = flashlog_active;
+		*offset = flashlog_index[flashlog_active][k - older_spans].offset;
+	}
+}
+
+/**
+ * @brief Flushes and starts streaming the spans that can hold readings
+ *        from from_s to to_s.
+ */
+uint32_t FlashLog_StartRange(uint32_t from_s, uint32_t to_s) {
+	const flashlog_index_t *e;
+	uint32_t older = flashlog_active;
+	uint32_t older_spans = 0U;
+	uint32_t spans;
+	uint32_t first;
+	uint32_t last;
+	uint32_t lo;
+	uint32_t hi;
+	uint32_t mid;
+	uint32_t sector;
+	uint32_t offset;
+
+	if (flashlog_ready == 0U) {
+		return 0U;
+	}
+	FlashLog_Flush();
+	if (FlashLog_OlderSector(&older) != 0U) {
+		older_spans = FlashLog_IndexSpans(older);
+	}
+	spans = older_spans + FlashLog_IndexSpans(flashlog_active);
+
+	/* First span whose readings so far reach from_s; hi_s never falls */
+	lo = 0U;
+	hi = spans;
+	while (lo < hi) {
+		mid = lo + ((hi - lo) / 2U);
+		e = (mid < older_spans) ? &flashlog_index[older][mid]
+				: &flashlog_index[flashlog_active][mid - older_spans];
+		if (e->hi_s < from_s) {
+			lo = mid + 1U;
+		} else {
+			hi = mid;
+		}
+	}
+	first = lo;
+#if !FLASHLOG_USE_BLOCKS
+	/* Pair codes carry the interval from the keyframe before them; only a
+	 * sector header resets it for the decoder */
+	first = (first < older_spans) ? 0U : older_spans;
+#endif /* FLASHLOG_USE_BLOCKS */
+
+	/* Stop after the last span holding a reading up to to_s; at the
+	 * first one if none does */
+	last = first;
+	for (mid = spans; mid > first; mid--) {
+		e = (mid <= older_spans) ? &flashlog_index[older][mid - 1U]
+				: &flashlog_index[flashlog_active][mid - 1U - older_spans];
+		if (e->lo_s <= to_s) {
+			last = mid;
+			break;
+		}
+	}
+	FlashLog_SpanAt(first, older, older_spans, spans, &sector, &offset);
+	FlashLog_DumpFrom(sector, offset);
+	FlashLog_SpanAt(last, older, older_spans, spans, &sector, &offset);
+	flashlog_dump.stop_sector = (uint8_t) sector;
+	flashlog_dump.stop_offset = offset;
+	flashlog_dump.active = 1U;
+	if (flashlog_dump.sector == sector) {
+		return offset - flashlog_dump.offset;
+	}
+	return (FlashLog_FindEnd(flashlog_dump.sector) - flashlog_dump.offset)
+			+ offset;
+}
+
+/**
+ * @brief Queues dump frames while the TX ring has room.
+ */
+uint8_t FlashLog_Poll(void) {
+	uint8_t pkt[FLASHLOG_PKT_MAX_LEN];
+	app_packet_t *frame;
+	uint32_t generation;
+	uint32_t end;
+	uint32_t len;
+	uint32_t n;
+	uint16_t crc;
+
+	if (flashlog_dump.active == 0U) {
+		return 0U;
+	}
+	frame = AppPacketPool_Alloc(&app_packet_pool);
+	if (frame == NULL) {
+		return flashlog_dump.active; /* Retried at the next poll */
+	}
+	while (flashlog_dump.active != 0U) {
+		if ((FlashLog_ReadHeader(flashlog_dump.sector, &generation) == 0U)
+				|| (generation != flashlog_dump.generation)) {
+			/* Erased under the dump by a sector change */
+			flashlog_dump.active = 0U;
+			printf("ERR flashlog dump overrun\r\n");
+			break;
+		}
+		end = (flashlog_dump.sector == flashlog_active) ?
+				flashlog_head : FlashLog_FindEnd(flashlog_dump.sector);
+		if ((flashlog_dump.sector == flashlog_dump.stop_sector)
+				&& (flashlog_dump.stop_offset < end)) {
+			end = flashlog_dump.stop_offset;
+		}
+		if ((flashlog_dump.offset >= end)
+				&& (flashlog_dump.sector != flashlog_active)
+				&& (flashlog_dump.sector != flashlog_dump.stop_sector)) {
+			flashlog_dump.sector = (uint8_t) flashlog_active;
+			flashlog_dump.generation = flashlog_generation;
+			flashlog_dump.offset = 0U;
+			continue;
+		}
+
+		/* An empty frame at the head, or at the stop, ends the dump */
+		n = end - flashlog_dump.offset;
+		if (n > FLASHLOG_CHUNK_WORDS) {
+			n = FLASHLOG_CHUNK_WORDS;
+		}
+		pkt[0] = TELEMETRY_TYPE_FLASHLOG;
+		pkt[1] = (uint8_t) n;
+		pkt[2] = flashlog_dump.sector;
+		pkt[3] = (uint8_t) flashlog_dump.generation;
+		pkt[4] = (uint8_t) (flashlog_dump.generation >> 8);
+		pkt[5] = (uint8_t) (flashlog_dump.generation >> 16);
+		pkt[6] = (uint8_t) (flashlog_dump.generation >> 24);
+		pkt[7] = (uint8_t) flashlog_dump.offset;
+		pkt[8] = (uint8_t) (flashlog_dump.offset >> 8);
+		len = FLASHLOG_PKT_HEADER_LEN;
+		memcpy(&pkt[len], &FlashLog_Words(flashlog_dump.sector)[flashlog_dump.offset],
+				n * 4U);
+		len += n * 4U;
+		crc = Crc_Ccitt16(pkt, len);
+		pkt[len++] = (uint8_t) crc;
+		pkt[len++] = (uint8_t) (crc >> 8);
+
+		len = Telemetry_CobsEncode(pkt, len, frame->data);
+		if (UART_TX_Free() < len) {
+			break;
+		}
+		(void) UART_TX_Write(frame->data, len);
+		Power_NotifyActivity(); /* No STOP while the host is listening */
+		flashlog_dump.offset += n;
+		if (n == 0U) {
+			flashlog_dump.active = 0U;
+		}
+	}
+	(void) AppPacketPool_Free(&app_packet_pool, frame);
+	return flashlog_dump.active;
+}
+
+/**
+ * @brief Words written to the log, both sectors.
+ */
+uint32_t FlashLog_GetUsedWords(void) {
+	uint32_t older;
+	uint32_t used = flashlog_head;
+
+	if ((flashlog_ready != 0U) && (FlashLog_OlderSector(&older) != 0U)) {
+		used += FlashLog_FindEnd(older);
+	}
+	return used;
+}
+
+/**
+ * @brief Words the log holds when both sectors are full.
+ */
+uint32_t FlashLog_GetCapacityWords(void) {
+	return FLASHLOG_SECTORS * FLASHLOG_WORDS;
+}
+
+/**
+ * @brief Generation of the active sector.
+ */
+uint32_t FlashLog_GetGeneration(void) {
+	return flashlog_generation;
+}
+
+/**
+ * @brief Failed flash program or erase operations since boot.
+ */
+uint32_t FlashLog_GetErrors(void) {
+	return flashlog_errors;
+}
+
+/**
+ * @brief Result of checking the older sector against its seal.
+ */
+flashlog_seal_t FlashLog_GetSeal(void) {
+	FlashLog_CheckSeal();
+	return flashlog_seal;
+}
+
+/**
+ * @brief Short printable name of a seal state.
+ */
+const char* FlashLog_SealName(flashlog_seal_t seal) {
+	switch (seal) {
+	case FLASHLOG_SEAL_CHECKING:
+		return "checking";
+	case FLASHLOG_SEAL_OK:
+		return "ok";
+	case FLASHLOG_SEAL_BAD:
+		return "bad";
+	default:
+		return "none";
+	}
+}
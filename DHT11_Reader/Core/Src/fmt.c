@@ -0,0 +1,319 @@
+/**
+ ******************************************************************************
+ * @file           : fmt.c
+ * @brief          : Small integer formatter writing into the TX ring.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "fmt.h"
+#include "uart_tx.h"
+#include <stddef.h>
+#include <stdint.h>
+
+static const char fmt_digits_lower[] = "0123456789abcdef";
+static const char fmt_digits_upper[] = "0123456789ABCDEF";
+
+/**
+ * @brief Copies the buffered bytes into the TX ring.
+ */
+static void Fmt_Flush(fmt_t *f) {
+	if (f->len != 0U) {
+		(void) UART_TX_Write((const uint8_t*) f->buf, f->len);
+		f->len = 0U;
+	}
+}
+
+/**
+ * @brief Appends count copies of c.
+ */
+static void Fmt_Repeat(fmt_t *f, char c, uint32_t count) {
+	while (count-- != 0U) {
+		Fmt_Char(f, c);
+	}
+}
+
+/**
+ * @brief Appends a magnitude with sign and padding.
+ * @param left: Nonzero to pad on the right with spaces instead.
+ */
+static void Fmt_Number(fmt_t *f, uint32_t mag, uint8_t neg, uint32_t base,
+		uint8_t upper, uint32_t width, char pad, uint8_t left) {
+	const char *digits = (upper != 0U) ? fmt_digits_upper : fmt_digits_lower;
+	char tmp[10];
+	uint32_t n = 0U;
+	uint32_t len;
+
+	do {
+		tmp[n++] = digits[mag % base];
+		mag /= base;
+	} while (mag != 0U);
+
+	len = n + ((neg != 0U) ? 1U : 0U);
+	if ((left == 0U) && (pad != '0') && (width > len)) {
+		Fmt_Repeat(f, ' ', width - len);
+	}
+	if (neg != 0U) {
+		Fmt_Char(f, '-');
+	}
+	if ((left == 0U) && (pad == '0') && (width > len)) {
+		Fmt_Repeat(f, '0', width - len);
+	}
+	while (n != 0U) {
+		Fmt_Char(f, tmp[--n]);
+	}
+	if ((left != 0U) && (width > len)) {
+		Fmt_Repeat(f, ' ', width - len);
+	}
+}
+
+/**
+ * @brief Starts an empty line.
+ */
+void Fmt_Begin(fmt_t *f) {
+	f->len = 0U;
+	f->total = 0U;
+}
+
+/**
+ * @brief Appends one character.
+ */
+void Fmt_Char(fmt_t *f, char c) {
+	if (f->len >= FMT_LINE_MAX) {
+		Fmt_Flush(f);
+	}
+	f->buf[f->len++] = c;
+	f->total++;
+}
+
+/**
+ * @brief Appends a NUL-terminated string.
+ */
+void Fmt_Str(fmt_t *f, const char *s) {
+	if (s == NULL) {
+		s = "(null)";
+	}
+	while (*s != '\0') {
+		Fmt_Char(f, *s++);
+	}
+}
+
+/**
+ * @brief Appends an unsigned decimal.
+ */
+void Fmt_Uint(fmt_t *f, uint32_t value, uint32_t width, char pad) {
+	Fmt_Number(f, value, 0U, 10U, 0U, width, pad, 0U);
+}
+
+/**
+ * @brief Appends a signed decimal.
+ */
+void Fmt_Int(fmt_t *f, int32_t value, uint32_t width, char pad) {
+	uint32_t mag = (value < 0) ? (0U - (uint32_t) value) : (uint32_t) value;
+
+	Fmt_Number(f, mag, (value < 0) ? 1U : 0U, 10U, 0U, width, pad, 0U);
+}
+
+/**
+ * @brief Appends hexadecimal digits.
+ */
+void Fmt_Hex(fmt_t *f, uint32_t value, uint32_t digits, uint8_t upper) {
+	Fmt_Number(f, value, 0U, 16U, upper, digits, '0', 0U);
+}
+
+/**
+ * @brief Appends a fixed-point value with decimals digits after the point.
+ */
+void Fmt_Fixed(fmt_t *f, int32_t value, uint32_t decimals) {
+	uint32_t mag = (value < 0) ? (0U - (uint32_t) value) : (uint32_t) value;
+	uint32_t scale = 1U;
+	uint32_t i;
+
+	if (decimals > 9U) {
+		decimals = 9U;
+	}
+	for (i = 0U; i < decimals; i++) {
+		scale *= 10U;
+	}
+	if (value < 0) {
+		Fmt_Char(f, '-');
+	}
+	Fmt_Uint(f, mag / scale, 0U, ' ');
+	if (decimals != 0U) {
+		Fmt_Char(f, '.');
+		Fmt_Uint(f, mag % scale, decimals, '0');
+	}
+}
+
+/**
+ * @brief Writes the rest of the line to the TX ring.
+ */
+uint32_t Fmt_End(fmt_t *f) {
+	Fmt_Flush(f);
+	return f->total;
+}
+
+/**
+ * @brief Appends a printf-style format to a line.
+ */
+void Fmt_VFormat(fmt_t *f, const char *format, va_list ap) {
+	const char *p = format;
+	const char *spec;
+	const char *s;
+	uint32_t width;
+	uint32_t len;
+	uint32_t value;
+	int32_t ivalue;
+	uint8_t is_long;
+	uint8_t left;
+	char pad;
+
+	while (*p != '\0') {
+		if (*p != '%') {
+			Fmt_Char(f, *p++);
+			continue;
+		}
+		spec = p++;
+		left = 0U;
+		pad = ' ';
+		width = 0U;
+		is_long = 0U;
+		for (; (*p == '-') || (*p == '0'); p++) {
+			if (*p == '-') {
+				left = 1U;
+			} else {
+				pad = '0';
+			}
+		}
+		while ((*p >= '0') && (*p <= '9')) {
+			width = (width * 10U) + (uint32_t) (*p++ - '0');
+		}
+		if (*p == 'l') {
+			is_long = 1U;
+			p++;
+		}
+
+		switch (*p) {
+		case 'd':
+		case 'i':
+			ivalue = (is_long != 0U) ? (int32_t) va_arg(ap, long)
+					: (int32_t) va_arg(ap, int);
+			value = (ivalue < 0) ? (0U - (uint32_t) ivalue) : (uint32_t) ivalue;
+			Fmt_Number(f, value, (ivalue < 0) ? 1U : 0U, 10U, 0U, width, pad,
+					left);
+			break;
+		case 'u':
+		case 'x':
+		case 'X':
+			value = (is_long != 0U) ? (uint32_t) va_arg(ap, unsigned long)
+					: (uint32_t) va_arg(ap, unsigned int);
+			Fmt_Number(f, value, 0U, (*p == 'u') ? 10U : 16U,
+					(*p == 'X') ? 1U : 0U, width, pad, left);
+			break;
+		case 'p':
+			Fmt_Str(f, "0x");
+			Fmt_Hex(f, (uint32_t) (uintptr_t) va_arg(ap, void*), 8U, 0U);
+			break;
+		case 'c':
+			Fmt_Char(f, (char) va_arg(ap, int));
+			break;
+		case 's':
+			s = va_arg(ap, const char*);
+			if (s == NULL) {
+				s = "(null)";
+			}
+			for (len = 0U; s[len] != '\0'; len++) {
+			}
+			if ((left == 0U) && (width > len)) {
+				Fmt_Repeat(f, ' ', width - len);
+			}
+			Fmt_Str(f, s);
+			if ((left != 0U) && (width > len)) {
+				Fmt_Repeat(f, ' ', width - len);
+			}
+			break;
+		case '%':
+			Fmt_Char(f, '%');
+			break;
+		default:
+			/* Unsupported: copy the specification through as text */
+			while (spec < p) {
+				Fmt_Char(f, *spec++);
+			}
+			if (*p == '\0') {
+				return;
+			}
+			Fmt_Char(f, *p);
+			break;
+		}
+		p++;
+	}
+}
+
+/**
+ * @brief Formats one printf-style line straight into the TX ring.
+ */
+uint32_t Fmt_Print(const char *format, ...) {
+	fmt_t f;
+	va_list ap;
+
+	Fmt_Begin(&f);
+	va_start(ap, format);
+	Fmt_VFormat(&f, format, ap);
+	va_end(ap);
+	return Fmt_End(&f);
+}
+
+#if FMT_PRINTF_SHIM
+/* printf() compatibility: GCC also turns some printf() calls into puts()
+ * and putchar(), so those are provided too */
+
+/**
+ * @brief vprintf() on Fmt_VFormat().
+ */
+int vprintf(const char *format, va_list ap) {
+	fmt_t f;
+
+	Fmt_Begin(&f);
+	Fmt_VFormat(&f, format, ap);
+	return (int) Fmt_End(&f);
+}
+
+/**
+ * @brief printf() on Fmt_VFormat().
+ */
+int printf(const char *format, ...) {
+	va_list ap;
+	int n;
+
+	va_start(ap, format);
+	n = vprintf(format, ap);
+	va_end(ap);
+	return n;
+}
+
+/**
+ * @brief String and newline into the TX ring.
+ */
+int puts(const char *s) {
+	fmt_t f;
+
+	Fmt_Begin(&f);
+	Fmt_Str(&f, s);
+	Fmt_Char(&f, '\n');
+	return (int) Fmt_End(&f);
+}
+
+/**
+ * @brief One byte into the TX ring.
+ */
+int putchar(int c) {
+	uint8_t byte = (uint8_t) c;
+
+	(void) UART_TX_Write(&byte, 1U);
+	return (int) byte;
+}
+#endif /* FMT_PRINTF_SHIM */
@@ -0,0 +1,247 @@
+/**
+ ******************************************************************************
+ * @file           : history.c
+ * @brief          : Reading history in the 4 KB battery-backed SRAM.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "history.h"
+#include "telemetry.h"
+#include "crc.h"
+#include "uart_tx.h"
+#include "app_pools.h"
+#include <stddef.h>
+#include <string.h>
+
+#define HISTORY_MAGIC          (0x48535431U) /* "HST1" */
+
+/** Batch packet: type, count, first sequence number, records, CRC */
+#define HISTORY_PKT_HEADER_LEN (TELEMETRY_HISTORY_HEADER)
+#define HISTORY_PKT_MAX_LEN    (HISTORY_PKT_HEADER_LEN \
+		+ (HISTORY_DRAIN_BATCH * sizeof(history_record_t)) + 2U)
+
+_Static_assert(TELEMETRY_COBS_MAX(HISTORY_PKT_MAX_LEN) <= APP_POOL_PACKET_SIZE,
+		"APP_POOL_PACKET_SIZE too small for a history batch");
+_Static_assert((sizeof(history_record_t) == TELEMETRY_HISTORY_RECORD)
+		&& (HISTORY_PKT_MAX_LEN <= TELEMETRY_PKT_MAX),
+		"history batch does not match telemetry_frames.h");
+
+/**
+ * @brief Ring bookkeeping, first in BKPSRAM.
+ */
+typedef struct {
+	uint32_t magic;
+	uint16_t version;
+	uint16_t record_size;
+	uint16_t capacity;
+	uint16_t head;         /*!< Next slot written                  */
+	uint16_t count;        /*!< Stored records                     */
+	uint16_t boot;
+	uint32_t appended;     /*!< Records ever stored; newest is n-1 */
+	uint32_t overwritten;
+	uint16_t reserved;
+	uint16_t crc;          /*!< CRC-16 of everything above         */
+} history_header_t;
+
+#define HISTORY_CAPACITY ((HISTORY_BKPSRAM_SIZE - sizeof(history_header_t)) \
+		/ sizeof(history_record_t))
+
+typedef struct {
+	history_header_t header;
+	history_record_t records[HISTORY_CAPACITY];
+} history_store_t;
+
+static history_store_t history __attribute__((section(".bkpsram")));
+
+/**
+ * @brief CRC of the header fields.
+ */
+static uint16_t History_HeaderCrc(const history_header_t *header) {
+	return Crc_Ccitt16((const uint8_t*) header,
+			offsetof(history_header_t, crc));
+}
+
+/**
+ * @brief Seals the header after a change.
+ */
+static void History_Commit(void) {
+	__DSB(); /* Record bytes land before the header that publishes them */
+	history.header.crc = History_HeaderCrc(&history.header);
+}
+
+/**
+ * @brief Checks that the header describes this build's ring.
+ */
+static uint8_t History_IsValid(void) {
+	const history_header_t *h = &history.header;
+
+	return ((h->magic == HISTORY_MAGIC) && (h->version == HISTORY_VERSION)
+			&& (h->record_size == sizeof(history_record_t))
+			&& (h->capacity == HISTORY_CAPACITY) && (h->head < HISTORY_CAPACITY)
+			&& (h->count <= HISTORY_CAPACITY)
+			&& (h->crc == History_HeaderCrc(h))) ? 1U : 0U;
+}
+
+/**
+ * @brief Slot of the index-th oldest record.
+ */
+static uint32_t History_Slot(uint32_t index) {
+	return (history.header.head + HISTORY_CAPACITY - history.header.count
+			+ index) % HISTORY_CAPACITY;
+}
+
+/**
+ * @brief Enables BKPSRAM, validates or formats the ring, counts the boot.
+ */
+void History_Init(void) {
+	__HAL_RCC_PWR_CLK_ENABLE();
+	HAL_PWR_EnableBkUpAccess();
+	__HAL_RCC_BKPSRAM_CLK_ENABLE();
+	/* Keeps the contents on VBAT alone; fails harmlessly without a battery */
+	(void) HAL_PWREx_EnableBkUpReg();
+
+	if (History_IsValid() == 0U) {
+		memset(&history.header, 0, sizeof(history.header));
+		history.header.magic = HISTORY_MAGIC;
+		history.header.version = HISTORY_VERSION;
+		history.header.record_size = sizeof(history_record_t);
+		history.header.capacity = HISTORY_CAPACITY;
+	}
+	history.header.boot++;
+	History_Commit();
+}
+
+/**
+ * @brief Stores a reading, overwriting the oldest one when full.
+ */
+void History_Append(const dht11_reading_t *reading) {
+	history_record_t *rec;
+
+	if (reading->status == DHT11_ERR_NO_RESPONSE) {
+		return;
+	}
+	rec = &history.records[history.header.head];
+	rec->timestamp_ms = reading->timestamp_ms;
+	rec->boot = history.header.boot;
+	rec->sensor_id = reading->sensor_id;
+	rec->status = (uint8_t) reading->status;
+	memcpy(rec->raw, reading->raw, sizeof(rec->raw));
+
+	history.header.head = (uint16_t) ((history.header.head + 1U)
+			% HISTORY_CAPACITY);
+	if (history.header.count < HISTORY_CAPACITY) {
+		history.header.count++;
+	} else {
+		history.header.overwritten++;
+	}
+	history.header.appended++;
+	History_Commit();
+}
+
+/**
+ * @brief Copies a stored record.
+ */
+uint8_t History_Get(uint32_t index, history_record_t *record) {
+	if (index >= history.header.count) {
+		return 0U;
+	}
+	*record = history.records[History_Slot(index)];
+	return 1U;
+}
+
+/**
+ * @brief Sends the oldest records in batches and removes them.
+ */
+uint32_t History_Drain(uint32_t max_records) {
+	uint8_t pkt[HISTORY_PKT_MAX_LEN];
+	app_packet_t *frame;
+	uint32_t sent = 0U;
+	uint32_t first_seq;
+	uint32_t len;
+	uint32_t n;
+	uint32_t i;
+	uint16_t crc;
+
+	frame = AppPacketPool_Alloc(&app_packet_pool);
+	if (frame == NULL) {
+		return 0U;
+	}
+	while ((sent < max_records) && (history.header.count != 0U)) {
+		n = history.header.count;
+		if (n > HISTORY_DRAIN_BATCH) {
+			n = HISTORY_DRAIN_BATCH;
+		}
+		if (n > (max_records - sent)) {
+			n = max_records - sent;
+		}
+		first_seq = history.header.appended - history.header.count;
+
+		pkt[0] = TELEMETRY_TYPE_HISTORY;
+		pkt[1] = (uint8_t) n;
+		pkt[2] = (uint8_t) first_seq;
+		pkt[3] = (uint8_t) (first_seq >> 8);
+		pkt[4] = (uint8_t) (first_seq >> 16);
+		pkt[5] = (uint8_t) (first_seq >> 24);
+		len = HISTORY_PKT_HEADER_LEN;
+		for (i = 0U; i < n; i++) {
+			memcpy(&pkt[len], &history.records[History_Slot(i)],
+					sizeof(history_record_t));
+			len += sizeof(history_record_t);
+		}
+		crc = Crc_Ccitt16(pkt, len);
+		pkt[len++] = (uint8_t) crc;
+		pkt[len++] = (uint8_t) (crc >> 8);
+
+		len = Telemetry_CobsEncode(pkt, len, frame->data);
+		if (UART_TX_Free() < len) {
+			break; /* Caller flushes and calls again */
+		}
+		(void) UART_TX_Write(frame->data, len);
+
+		history.header.count = (uint16_t) (history.header.count - n);
+		History_Commit();
+		sent += n;
+	}
+	(void) AppPacketPool_Free(&app_packet_pool, frame);
+	return sent;
+}
+
+/**
+ * @brief Discards every stored record.
+ */
+void History_Clear(void) {
+	history.header.count = 0U;
+	History_Commit();
+}
+
+/**
+ * @brief Number of stored records.
+ */
+uint32_t History_Count(void) {
+	return history.header.count;
+}
+
+/**
+ * @brief Records the ring can hold.
+ */
+uint32_t History_Capacity(void) {
+	return HISTORY_CAPACITY;
+}
+
+/**
+ * @brief Current boot number.
+ */
+uint32_t History_GetBoot(void) {
+	return history.header.boot;
+}
+
+/**
+ * @brief Records lost to overwriting since the ring was formatted.
+ */
+uint32_t History_GetOverwritten(void) {
+	return history.header.overwritten;
+}
@@ -0,0 +1,350 @@
+/**
+ ******************************************************************************
+ * @file           : i2c_regmap.c
+ * @brief          : I2C slave register map served by DMA from snapshots.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "i2c_regmap.h"
+#include "irq_prio.h"
+#include "dht11_sink.h"
+#include "dht11_async.h"
+#include "dht11_calib.h"
+#include "dht11_health.h"
+#include "uart_tx.h"
+#include "uart_rx.h"
+#include "crash.h"
+#include <string.h>
+
+#if I2C_USE_REGMAP
+
+/** SCL, SDA */
+#define I2C_REGMAP_Pins      (GPIO_PIN_6 | GPIO_PIN_7)
+#define I2C_REGMAP_GPIO_Port GPIOB
+
+/** I2C1_TX request: DMA1 stream 7, channel 1 */
+#define I2C_REGMAP_DMA       (DMA1_Stream7)
+#define I2C_REGMAP_DMA_CH    (1U)
+#define I2C_REGMAP_DMA_FLAGS (DMA_HIFCR_CTCIF7 | DMA_HIFCR_CHTIF7 \
+		| DMA_HIFCR_CTEIF7 | DMA_HIFCR_CDMEIF7 | DMA_HIFCR_CFEIF7)
+
+#define I2C_REGMAP_SIZE      (sizeof(i2c_regmap_t))
+
+/** i2c_serving while no read is in progress */
+#define I2C_REGMAP_IDLE      (0xFFU)
+
+/** Sent once the DMA has given the host the whole map */
+#define I2C_REGMAP_PAD       (0xFFU)
+
+static i2c_regmap_t i2c_stage;         /* Thread only */
+static i2c_regmap_t i2c_snap[2];
+static volatile uint8_t i2c_active = 0U;
+static volatile uint8_t i2c_serving = I2C_REGMAP_IDLE;
+static uint8_t i2c_dirty = 0U;
+static uint32_t i2c_published_ms = 0U;
+static uint8_t i2c_enabled = 0U;
+
+/* Host writes: collected by the event handler, applied by the thread */
+static uint8_t i2c_pointer = 0U;
+static uint32_t i2c_wcount = 0U;
+static uint8_t i2c_wdata[I2C_REGMAP_WRITE_MAX];
+static volatile uint8_t i2c_wpending = 0U;
+static uint8_t i2c_wreg;
+static uint32_t i2c_wlen;
+static uint8_t i2c_wbuf[I2C_REGMAP_WRITE_MAX];
+
+static volatile uint32_t i2c_reads = 0U;
+static volatile uint32_t i2c_errors = 0U;
+
+/**
+ * @brief Programs CR2.FREQ, which the slave needs for its timing.
+ */
+static void I2C_Regmap_SetFreq(void) {
+	uint32_t mhz = HAL_RCC_GetPCLK1Freq() / 1000000U;
+
+	I2C1->CR1 &= ~I2C_CR1_PE;
+	I2C1->CR2 = (I2C1->CR2 & ~I2C_CR2_FREQ) | (mhz & I2C_CR2_FREQ);
+	I2C1->CR1 |= I2C_CR1_PE;
+	I2C1->CR1 |= I2C_CR1_ACK;    /* Cleared with PE */
+}
+
+/**
+ * @brief Refreshes the header counters and copies the staging map into
+ *        the snapshot the host is not reading, then makes it current.
+ */
+static void I2C_Regmap_Publish(void) {
+	uint8_t target = i2c_active ^ 1U;
+
+	i2c_stage.format = (uint8_t) DHT11_Sink_GetFormat();
+	i2c_stage.uptime_ms = HAL_GetTick();
+#if DHT11_USE_ASYNC
+	i2c_stage.interval_ms = DHT11_Async_GetInterval();
+#endif /* DHT11_USE_ASYNC */
+	i2c_stage.tx_dropped = UART_TX_GetDropped();
+	i2c_stage.rx_errors = UART_RX_GetErrors();
+	i2c_stage.crashes = Crash_GetCount();
+	i2c_stage.reads = i2c_reads;
+
+	/* The read in progress may still be on the other snapshot */
+	if (i2c_serving == target) {
+		i2c_dirty = 1U;
+		return;
+	}
+	i2c_stage.snapshot++;
+	(void) memcpy(&i2c_snap[target], &i2c_stage, I2C_REGMAP_SIZE);
+	__DMB(); /* Snapshot complete before the next read can pick it */
+	i2c_active = target;
+	i2c_dirty = 0U;
+	i2c_published_ms = i2c_stage.uptime_ms;
+}
+
+/**
+ * @brief Claims the pins, enables the slave and publishes an empty map.
+ */
+void I2C_Regmap_Init(void) {
+	GPIO_InitTypeDef GPIO_InitStruct = { 0 };
+
+	(void) memset(&i2c_stage, 0, sizeof(i2c_stage));
+	i2c_stage.magic = I2C_REGMAP_MAGIC;
+	i2c_stage.version = I2C_REGMAP_VERSION;
+	i2c_stage.sensors = I2C_REGMAP_SENSORS;
+	i2c_serving = I2C_REGMAP_IDLE;
+	I2C_Regmap_Publish();
+	I2C_Regmap_Publish();   /* Both snapshots valid */
+
+	__HAL_RCC_GPIOB_CLK_ENABLE();
+	GPIO_InitStruct.Pin = I2C_REGMAP_Pins;
+	GPIO_InitStruct.Mode = GPIO_MODE_AF_OD;
+	GPIO_InitStruct.Pull = GPIO_NOPULL;
+	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+	GPIO_InitStruct.Alternate = GPIO_AF4_I2C1;
+	HAL_GPIO_Init(I2C_REGMAP_GPIO_Port, &GPIO_InitStruct);
+	__HAL_RCC_I2C1_CLK_ENABLE();
+	__HAL_RCC_DMA1_CLK_ENABLE();
+
+	I2C1->CR1 = I2C_CR1_SWRST;
+	I2C1->CR1 = 0U;
+	I2C1->OAR1 = (1UL << 14) | ((uint32_t) I2C_REGMAP_ADDRESS << 1);
+	I2C1->CR2 = I2C_CR2_ITEVTEN | I2C_CR2_ITERREN;
+
+	I2C_REGMAP_DMA->CR = 0U;
+	I2C_REGMAP_DMA->PAR = (uint32_t) &I2C1->DR;
+	DMA1->HIFCR = I2C_REGMAP_DMA_FLAGS;
+
+	HAL_NVIC_SetPriority(I2C1_EV_IRQn, IRQ_PRIO_UART, 0U);
+	HAL_NVIC_SetPriority(I2C1_ER_IRQn, IRQ_PRIO_UART, 0U);
+	HAL_NVIC_SetPriority(DMA1_Stream7_IRQn, IRQ_PRIO_UART, 0U);
+	HAL_NVIC_EnableIRQ(I2C1_EV_IRQn);
+	HAL_NVIC_EnableIRQ(I2C1_ER_IRQn);
+	HAL_NVIC_EnableIRQ(DMA1_Stream7_IRQn);
+
+	I2C_Regmap_SetFreq();
+	i2c_enabled = 1U;
+}
+
+/**
+ * @brief Reports whether the slave is listening.
+ */
+uint8_t I2C_Regmap_IsEnabled(void) {
+	return i2c_enabled;
+}
+
+/**
+ * @brief Records a reading and publishes the map.
+ */
+void I2C_Regmap_Reading(const dht11_reading_t *reading) {
+	i2c_regmap_sensor_t *s;
+	dht11_values_t values;
+	uint32_t failures;
+
+	if (reading->sensor_id >= I2C_REGMAP_SENSORS) {
+		return;
+	}
+	s = &i2c_stage.sensor[reading->sensor_id];
+	s->status = (uint8_t) reading->status;
+	s->confidence = reading->confidence;
+	s->retries = reading->retries;
+	s->health = (uint8_t) DHT11_Health_Get(reading->sensor_id);
+	if (DHT11_Calib_Process(reading, &values) != 0U) {
+		s->temp = values.temp;
+		s->hum = values.hum;
+	}
+	s->timestamp_ms = reading->timestamp_ms;
+	s->readings++;
+	failures = DHT11_Health_GetFailures(reading->sensor_id);
+	s->failures = (uint16_t) ((failures > 0xFFFFU) ? 0xFFFFU : failures);
+	I2C_Regmap_Publish();
+}
+
+/**
+ * @brief Applies one host write to the rw registers.
+ */
+static void I2C_Regmap_Apply(uint8_t reg, const uint8_t *data, uint32_t len) {
+	uint32_t i;
+
+	for (i = 0U; i < len; i++) {
+		if (((reg + i) == I2C_REGMAP_REG_FORMAT)
+				&& (data[i] <= (uint8_t) DHT11_FORMAT_SCHEMA)) {
+			DHT11_Sink_SetFormat((dht11_format_t) data[i]);
+		}
+	}
+#if DHT11_USE_ASYNC
+	if ((reg <= I2C_REGMAP_REG_INTERVAL)
+			&& ((reg + len) >= (I2C_REGMAP_REG_INTERVAL + 4U))) {
+		i = I2C_REGMAP_REG_INTERVAL - reg;
+		DHT11_Async_SetInterval((uint32_t) data[i]
+				| ((uint32_t) data[i + 1U] << 8)
+				| ((uint32_t) data[i + 2U] << 16)
+				| ((uint32_t) data[i + 3U] << 24));
+	}
+#endif /* DHT11_USE_ASYNC */
+}
+
+/**
+ * @brief Applies host writes and publishes what is due.
+ */
+void I2C_Regmap_Poll(void) {
+	if (i2c_wpending != 0U) {
+		I2C_Regmap_Apply(i2c_wreg, i2c_wbuf, i2c_wlen);
+		__DMB(); /* Buffer consumed before the handler may refill it */
+		i2c_wpending = 0U;
+		i2c_dirty = 1U;
+	}
+	if ((i2c_dirty != 0U)
+			|| ((HAL_GetTick() - i2c_published_ms) >= I2C_REGMAP_REFRESH_MS)) {
+		I2C_Regmap_Publish();
+	}
+}
+
+/**
+ * @brief Read transactions served.
+ */
+uint32_t I2C_Regmap_GetReads(void) {
+	return i2c_reads;
+}
+
+/**
+ * @brief Bus errors seen.
+ */
+uint32_t I2C_Regmap_GetErrors(void) {
+	return i2c_errors;
+}
+
+/**
+ * @brief Reprograms CR2.FREQ from the new PCLK1.
+ */
+void I2C_Regmap_ClockChanged(void) {
+	if (i2c_enabled != 0U) {
+		I2C_Regmap_SetFreq();
+	}
+}
+
+/**
+ * @brief Hands the bytes written after the register byte to the thread.
+ */
+static void I2C_Regmap_EndWrite(void) {
+	if (i2c_wcount > 1U) {
+		if (i2c_wpending == 0U) {
+			i2c_wreg = i2c_pointer;
+			i2c_wlen = i2c_wcount - 1U;
+			(void) memcpy(i2c_wbuf, i2c_wdata, i2c_wlen);
+			i2c_wpending = 1U;
+		} else {
+			i2c_errors++;
+		}
+	}
+	i2c_wcount = 0U;
+}
+
+/**
+ * @brief Ends a read: stops the DMA and releases the snapshot.
+ */
+static void I2C_Regmap_EndRead(void) {
+	I2C_REGMAP_DMA->CR &= ~DMA_SxCR_EN;
+	DMA1->HIFCR = I2C_REGMAP_DMA_FLAGS;
+	I2C1->CR2 &= ~(I2C_CR2_DMAEN | I2C_CR2_ITBUFEN);
+	if (i2c_serving != I2C_REGMAP_IDLE) {
+		i2c_serving = I2C_REGMAP_IDLE;
+		i2c_reads++;
+	}
+}
+
+/**
+ * @brief Address match, received bytes, padding and STOP.
+ */
+void I2C_Regmap_EvIRQHandler(void) {
+	uint32_t sr1 = I2C1->SR1;
+	uint32_t sr2;
+	uint8_t byte;
+
+	if ((sr1 & I2C_SR1_ADDR) != 0U) {
+		I2C_Regmap_EndWrite();   /* Repeated start after a write */
+		sr2 = I2C1->SR2;         /* SR1 then SR2 clears ADDR */
+		if ((sr2 & I2C_SR2_TRA) != 0U) {
+			/* The core stretches SCL until the DMA supplies DR */
+			i2c_serving = i2c_active;
+			I2C_REGMAP_DMA->CR = 0U;
+			DMA1->HIFCR = I2C_REGMAP_DMA_FLAGS;
+			I2C_REGMAP_DMA->M0AR = (uint32_t) ((const uint8_t *)
+					&i2c_snap[i2c_serving] + i2c_pointer);
+			I2C_REGMAP_DMA->NDTR = I2C_REGMAP_SIZE - i2c_pointer;
+			I2C_REGMAP_DMA->CR = (I2C_REGMAP_DMA_CH << DMA_SxCR_CHSEL_Pos)
+					| DMA_SxCR_DIR_0 | DMA_SxCR_MINC | DMA_SxCR_TCIE
+					| DMA_SxCR_EN;
+			I2C1->CR2 = (I2C1->CR2 & ~I2C_CR2_ITBUFEN) | I2C_CR2_DMAEN;
+		} else {
+			I2C1->CR2 |= I2C_CR2_ITBUFEN;
+		}
+		return;
+	}
+	if ((sr1 & I2C_SR1_RXNE) != 0U) {
+		byte = (uint8_t) I2C1->DR;
+		if (i2c_wcount == 0U) {
+			i2c_pointer = (byte < I2C_REGMAP_SIZE) ? byte : 0U;
+		} else if (i2c_wcount <= I2C_REGMAP_WRITE_MAX) {
+			i2c_wdata[i2c_wcount - 1U] = byte;
+		}
+		if (i2c_wcount <= I2C_REGMAP_WRITE_MAX) {
+			i2c_wcount++;
+		}
+	}
+	if (((sr1 & I2C_SR1_TXE) != 0U)
+			&& ((I2C1->CR2 & I2C_CR2_ITBUFEN) != 0U)
+			&& (i2c_serving != I2C_REGMAP_IDLE)) {
+		I2C1->DR = I2C_REGMAP_PAD;
+	}
+	if ((sr1 & I2C_SR1_STOPF) != 0U) {
+		I2C1->CR1 |= I2C_CR1_PE; /* SR1 then CR1 clears STOPF */
+		I2C1->CR2 &= ~I2C_CR2_ITBUFEN;
+		I2C_Regmap_EndWrite();
+	}
+}
+
+/**
+ * @brief NACK from the host ends a read; bus errors reset the transfer.
+ */
+void I2C_Regmap_ErIRQHandler(void) {
+	uint32_t sr1 = I2C1->SR1;
+
+	if ((sr1 & (I2C_SR1_BERR | I2C_SR1_ARLO | I2C_SR1_OVR)) != 0U) {
+		i2c_errors++;
+		i2c_wcount = 0U;
+	}
+	I2C1->SR1 = ~(sr1 & (I2C_SR1_AF | I2C_SR1_BERR | I2C_SR1_ARLO
+			| I2C_SR1_OVR));
+	I2C_Regmap_EndRead();
+}
+
+/**
+ * @brief DMA has sent the last register; the event handler pads from here.
+ */
+void I2C_Regmap_DmaIRQHandler(void) {
+	DMA1->HIFCR = I2C_REGMAP_DMA_FLAGS;
+	I2C1->CR2 = (I2C1->CR2 & ~I2C_CR2_DMAEN) | I2C_CR2_ITBUFEN;
+}
+
+#endif /* I2C_USE_REGMAP */
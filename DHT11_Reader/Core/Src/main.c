@@ -29,7 +29,67 @@
 
 /* Private includes ----------------------------------------------------------*/
 #include "dht11.h"
+#include "dht11_capture.h"
+#include "dht11_pin.h"
+#include "dht11_multi.h"
+#include "dht11_sink.h"
+#include "telemetry.h"
+#include "dht11_async.h"
+#include "dht11_classify.h"
+#include "dht11_health.h"
+#include "dht11_drift.h"
+#include "dht11_trace.h"
+#include "dht11_sync.h"
+#include "dht11_trigger.h"
+#include "uart_tx.h"
+#include "uart_rx.h"
+#include "uart_flow.h"
+#include "status_led.h"
+#include "cli.h"
+#include "dlog.h"
 #include "my_debug.h"
+#include "clock_config.h"
+#include "timebase.h"
+#include "systime.h"
+#include "power.h"
+#include "history.h"
+#include "flashlog.h"
+#include "crc.h"
+#include "config.h"
+#include "sched.h"
+#include "app_rtos.h"
+#include "irq_prio.h"
+#include "crash.h"
+#include "watchdog.h"
+#include "ramfunc.h"
+#include "app_pools.h"
+#include "fmt.h"
+#include "dht11_calib.h"
+#include "dht11_latest.h"
+#include "dht11_filter.h"
+#include "dht11_emit.h"
+#include "dht11_agg.h"
+#include "dht11_sampler.h"
+#include "dht11_exti.h"
+#include "dht11_oversample.h"
+#include "dht11_driver.h"
+#include "swo.h"
+#include "perf.h"
+#include "uart_baud.h"
+#include "usb_cdc.h"
+#include "can_bus.h"
+#include "i2c_regmap.h"
+#include "app_bench.h"
+#include "modbus.h"
+#include "dht11_emu.h"
+#include "wallclock.h"
+#include "dvfs.h"
+#include "dht11_supply.h"
+#include "dht11_discover.h"
+#include "adc_mon.h"
+#include "rs485_gw.h"
+#include "watermark.h"
+#include "tickless.h"
 
 /* USER CODE BEGIN Includes */
 
@@ -55,13 +115,24 @@
 /* USER CODE END PM */
 
 /* Private variables ---------------------------------------------------------*/
+TIM_HandleTypeDef htim1;
+TIM_HandleTypeDef htim5;
 TIM_HandleTypeDef htim6;
+DMA_HandleTypeDef hdma_tim1_up;
+DMA_HandleTypeDef hdma_tim5_ch2;
 UART_HandleTypeDef huart2;
+DMA_HandleTypeDef hdma_usart2_rx;
+DMA_HandleTypeDef hdma_usart2_tx;
 
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
 static void MX_GPIO_Init(void);
+static void MX_DMA_Init(void);
 static void MX_USART2_UART_Init(void);
+#if DHT11_USE_MULTI
+static void MX_TIM1_Init(void);
+#endif /* DHT11_USE_MULTI */
+static void MX_TIM5_Init(void);
 static void MX_TIM6_Init(void);
 
 /* Private user code ---------------------------------------------------------*/
@@ -77,7 +148,12 @@ static void MX_TIM6_Init(void);
 #endif
 
 PUTCHAR_PROTOTYPE {
-	HAL_UART_Transmit(&huart2, (uint8_t*) &ch, 1, 0xFFFF);
+	uint8_t c = (uint8_t) ch;
+#if SWO_USE_ITM && SWO_USE_PRINTF
+	Swo_PutChar(c);
+#else
+	(void) UART_TX_Write(&c, 1U);
+#endif /* SWO_USE_ITM && SWO_USE_PRINTF */
 	return (ch);
 }
 
@@ -89,6 +165,180 @@ PUTCHAR_PROTOTYPE {
  return ch;
  }*/
 
+/* Scheduler tasks ----------------------------------------------------------*/
+
+#if !APP_USE_RTOS
+/* Sensor liveness token, checked in after every completed read */
+static uint8_t wdg_sensor = WATCHDOG_NO_TOKEN;
+#if DHT11_USE_MULTI || !DHT11_USE_ASYNC
+/* Acquisition timer task, woken early for an on-demand reading */
+static uint8_t task_sensor = SCHED_NO_TASK;
+#endif /* DHT11_USE_MULTI || !DHT11_USE_ASYNC */
+
+#if DHT11_USE_MULTI
+/**
+ * @brief Reads the channels the sampling plan (dht11_sampler.h) has due
+ *        and emits the sensors that answered, one step per run: the next
+ *        frame is begun as soon as the last window has filled, and the
+ *        last frame is decoded and published while its pulse and window
+ *        run.
+ * @retval Delay until the next step.
+ */
+static uint32_t Task_MultiRead(void) {
+	static uint8_t pulsing = 0U;    /* A frame is in its start pulse */
+	static uint32_t pulse_end = 0U; /* HAL tick its pulse may end at */
+	dht11_reading_t readings[DHT11_MULTI_CHANNELS];
+	uint32_t now = HAL_GetTick();
+	uint32_t pulse_ms;
+	uint32_t due;
+	uint32_t ch;
+
+	Watchdog_Checkin(wdg_sensor);
+	if ((pulsing != 0U) && ((int32_t) (now - pulse_end) >= 0)) {
+		pulsing = 0U;
+		(void) DHT11_Multi_Arm();
+	}
+	if ((pulsing == 0U) && (DHT11_Multi_IsComplete() != 0U)) {
+		(void) DHT11_Sampler_Next(now, &due);
+		if ((due != 0U) && (DHT11_Multi_Begin(due, &pulse_ms) == DHT11_OK)) {
+			DHT11_Sampler_Done(due, now);
+			pulsing = 1U;
+			pulse_end = now + pulse_ms;
+		}
+	}
+
+	due = DHT11_Multi_Collect(readings);
+	for (ch = 0U; ch < DHT11_MULTI_CHANNELS; ch++) {
+		if (((due & (1UL << ch)) == 0U)
+				|| (readings[ch].status == DHT11_ERR_NO_RESPONSE)) {
+			continue;
+		}
+		(void) Fmt_Print("ch%lu: ", ch); /* Same path as the text sink */
+		DHT11_Sink_Emit(&readings[ch]);
+	}
+
+	now = HAL_GetTick();
+	if (pulsing != 0U) {
+		return ((int32_t) (pulse_end - now) > 0) ? (pulse_end - now) : 0U;
+	}
+	if (DHT11_Multi_IsComplete() == 0U) {
+		return DHT11_MULTI_WINDOW_MS;
+	}
+	return DHT11_Sampler_Next(now, &due);
+}
+#elif DHT11_USE_ASYNC
+/**
+ * @brief Starts the asynchronous reads once the sensor has powered up.
+ */
+static uint32_t Task_AsyncStart(void) {
+	(void) DHT11_StartAsync();
+	return SCHED_STOP;
+}
+
+/**
+ * @brief Completes a finished asynchronous transaction.
+ */
+static uint32_t Task_AsyncPoll(void) {
+	if (DHT11_Poll() != 0U) {
+		Watchdog_Checkin(wdg_sensor);
+	}
+	return 0U;
+}
+#else
+/**
+ * @brief Reads and emits one reading.
+ * @retval Delay until the next reading.
+ */
+static uint32_t Task_Read(void) {
+	uint32_t next_ms;
+
+#if DHT11_USE_SUPPLY
+	next_ms = DHT11_Supply_ReadyInMs(0U);
+	if (next_ms != 0U) {
+		return next_ms; /* Powered up late: wait out the warm-up */
+	}
+#endif /* DHT11_USE_SUPPLY */
+	next_ms = DHT11_ReadAndEmit();
+	Watchdog_Checkin(wdg_sensor);
+	return next_ms;
+}
+#endif /* DHT11_USE_MULTI / DHT11_USE_ASYNC */
+
+#if DHT11_USE_TRIGGER
+/**
+ * @brief Serves a B1 press or "read" command (dht11_trigger.h) once the
+ *        sensor has powered up: the next reading is brought forward.
+ */
+static uint32_t Task_Trigger(void) {
+	if ((DHT11_PowerUpRemainingMs() != 0U) || (DHT11_Trigger_Take() == 0U)) {
+		return 0U;
+	}
+#if DHT11_USE_MULTI
+	/* The task plans its own frame; it may also be mid-frame */
+	(void) DHT11_Sampler_Request((1UL << DHT11_MULTI_CHANNELS) - 1U,
+			HAL_GetTick());
+	Sched_Wake(task_sensor, 0U);
+#elif DHT11_USE_ASYNC
+	(void) DHT11_Async_Trigger();
+#else
+	/* Never later than the periodic reading, which is a period on */
+	Sched_Wake(task_sensor, DHT11_Sampler_Request(1UL << 0U, HAL_GetTick()));
+#endif /* DHT11_USE_MULTI / DHT11_USE_ASYNC */
+	return 0U;
+}
+#endif /* DHT11_USE_TRIGGER */
+
+#if DHT11_USE_SUPPLY
+/**
+ * @brief Powers up the sensors whose reading or reset is due.
+ */
+static uint32_t Task_Supply(void) {
+	return DHT11_Supply_Poll();
+}
+#endif /* DHT11_USE_SUPPLY */
+
+/**
+ * @brief Executes any complete command line.
+ */
+static uint32_t Task_CliPoll(void) {
+	CLI_Poll();
+	return 0U;
+}
+
+/**
+ * @brief Formats deferred debug records; asks for another pass while a
+ *        full batch was processed.
+ */
+static uint32_t Task_DLogProcess(void) {
+	return (DLog_Process(4U) == 4U) ? 1U : 0U;
+}
+
+/**
+ * @brief Streams a requested flash log dump as the TX ring drains. The TX
+ *        DMA interrupt ends the sleep, so it never asks for another pass.
+ */
+static uint32_t Task_FlashLogPoll(void) {
+	(void) FlashLog_Poll();
+	return 0U;
+}
+
+/**
+ * @brief Sends a batch of readings that has waited TELEMETRY_BATCH_MS.
+ */
+static uint32_t Task_BatchPoll(void) {
+	return Telemetry_BatchPoll();
+}
+
+/**
+ * @brief Refreshes the watchdog while every token is fresh. Its deadline
+ *        also bounds each STOP period below the IWDG timeout.
+ */
+static uint32_t Task_Watchdog(void) {
+	Watchdog_Service();
+	return WATCHDOG_SERVICE_MS;
+}
+#endif /* !APP_USE_RTOS */
+
 /**
  * @brief  The application entry point.
  * @retval int
@@ -97,25 +347,182 @@ PUTCHAR_PROTOTYPE {
 int main(void) {
 	/* Initialize the HAL Library */
 	HAL_Init();
+	Crc_Init(); /* CRC unit, DMA2 Stream0 feeds it large blocks */
+#if CONFIG_USE_STORE
+	Config_Load(); /* Saved settings, if a copy checks out, for what follows */
+#endif /* CONFIG_USE_STORE */
+
+#if APP_FAST_BOOT
+	/* The HSE starts up while the GPIOs are set up from HSI */
+	Clock_StartHse();
+	MX_GPIO_Init();
+	DHT11_Pin_Init(); /* PA1 open-drain + pull-up, configured once */
 
 	/* Configure the system clock */
 	SystemClock_Config();
+#else
+	/* Configure the system clock */
+	SystemClock_Config();
 
 	/* Initialize all configured peripherals */
 	MX_GPIO_Init();
+	DHT11_Pin_Init(); /* PA1 open-drain + pull-up, configured once */
+#endif /* APP_FAST_BOOT */
+	MX_DMA_Init();
 	MX_USART2_UART_Init();
+	AppPools_Init(); /* Fixed-block pools, no heap */
+	UART_TX_Init(); /* printf now queues into the DMA-drained TX ring */
+	UART_Baud_Init(); /* 115200 until a host negotiates more (baud) */
+#if CONFIG_USE_STORE
+	Config_ApplyBaud(); /* Or the saved rate, before the first line */
+#endif /* CONFIG_USE_STORE */
+	UART_RX_Init(); /* Circular DMA receive, IDLE line ends a burst */
+#if UART_FLOW_USE_RTSCTS
+	UART_Flow_Init(); /* CTS on PB5 paces TX, RTS on PA9 paces the host */
+#endif /* UART_FLOW_USE_RTSCTS */
+#if USB_USE_CDC
+	(void) Usb_Cdc_Start(); /* CDC-ACM on PA11/PA12; output stays on USART2 */
+#endif /* USB_USE_CDC */
+#if CAN_USE_BUS
+	(void) Can_Bus_Init(); /* CAN1 on PB8/PB9, readings and commands */
+#endif /* CAN_USE_BUS */
+#if I2C_USE_REGMAP
+	I2C_Regmap_Init(); /* Register map for a host on PB6/PB7 */
+#endif /* I2C_USE_REGMAP */
+#if MODBUS_USE_RTU
+	Modbus_Init(); /* USART2 answers a Modbus master from here on */
+#endif /* MODBUS_USE_RTU */
+#if RS485_USE_GATEWAY
+	Rs485_Gw_Init(); /* Polls downstream boards on USART3 (PC10/PC11) */
+#endif /* RS485_USE_GATEWAY */
+	CLI_Init();
+	Crash_Init(); /* Report the crash that caused this reset, if any */
+	Watchdog_Init(); /* Report the token that tripped the watchdog, if any */
+	MX_TIM5_Init();
 	MX_TIM6_Init();
-	HAL_TIM_Base_Start(&htim6); /* Start TIM6 for any timing operations (optional) */
-	DWT_Init(); /* Enable DWT-based microsecond delay*/
+#if DHT11_USE_MULTI
+	MX_TIM1_Init();
+	DHT11_Multi_Init(); /* Channel pins on their ports, released */
+#endif /* DHT11_USE_MULTI */
+	Timebase_Init(); /* 1 MHz TIM6 + DWT cycle counter, derived from RCC */
+#if SWO_USE_ITM
+	Swo_Init(); /* ITM log, reading and event ports on SWO (PB3) */
+#endif /* SWO_USE_ITM */
+	Perf_Init(); /* DWT load accounting window starts here */
+#if WATERMARK_USE_LATENCY
+	Watermark_Init(); /* Latency scales; the TIM11 probe only with SysTick */
+#endif /* WATERMARK_USE_LATENCY */
+	DHT11_Capture_Init(); /* Start the 1 MHz capture timebase on TIM5 */
+	SysTime_Init(); /* TIM5 wraps extend it to 64-bit timestamps */
+#if TICKLESS_IS_ACTIVE
+	Tickless_Start(); /* SysTick off: HAL_GetTick() on TIM5, sleeps on CC3 */
+#endif /* TICKLESS_IS_ACTIVE */
+#if DHT11_USE_EXTI
+	DHT11_Exti_Init(); /* PA1 edges on EXTI1, masked until a frame */
+#endif /* DHT11_USE_EXTI */
+#if DHT11_USE_OVERSAMPLE
+	DHT11_Oversample_Init(); /* TIM8 at 1 MHz, DMA2 Stream1 idle until a frame */
+#endif /* DHT11_USE_OVERSAMPLE */
+#if DHT11_EMU_USE_LOOPBACK
+	DHT11_Emu_Init(); /* Emulated DHT11 on PB10, jumpered to PA1 */
+#endif /* DHT11_EMU_USE_LOOPBACK */
+	DHT11_Classify_Init(); /* Nominal bit widths until sensors are learnt */
+	DHT11_Health_Init(); /* Default retry policy, all sensors OK */
+#if DHT11_USE_DISCOVERY
+	DHT11_Discover_Init(); /* Presence unknown until the first frame */
+#endif /* DHT11_USE_DISCOVERY */
+	Status_Led_Init(); /* LD2 breathes on TIM2 until a sensor or the link fails */
+	DHT11_Drift_Init(); /* No baseline until sensors have been watched */
+	DHT11_Trace_Init(); /* Raw frame recorder empty and off */
+#if DHT11_USE_SYNC
+	DHT11_Sync_Init(); /* Free-running until a pulse arrives on PA0 */
+#endif /* DHT11_USE_SYNC */
+#if DHT11_USE_TRIGGER
+	DHT11_Trigger_Init(); /* B1 on EXTI13 asks for a reading now */
+#endif /* DHT11_USE_TRIGGER */
+	DHT11_Calib_Init(); /* Identity calibration for every sensor */
+	DHT11_Latest_Init(); /* No reading published yet */
+	DHT11_Filter_Init(); /* Hampel outlier rejection, empty windows */
+	DHT11_Emit_Init(); /* Periodic, every reading */
+	DHT11_Agg_Init(); /* No window, raw readings on */
+	DHT11_Driver_Init(); /* Every sensor a DHT11 */
+	DHT11_Sampler_Init(); /* Every sensor every 2 s, one frame */
+#if DHT11_USE_SUPPLY
+	DHT11_Supply_Init(); /* Switched sensors powered, gated after a reading */
+#endif /* DHT11_USE_SUPPLY */
+	Power_Init(); /* RTC on LSE or TIM5-calibrated LSI, wakeup for STOP */
+#if WALLCLOCK_USE_SYNC
+	Wallclock_Init(); /* UTC from an earlier host sync, if any */
+#endif /* WALLCLOCK_USE_SYNC */
+	History_Init(); /* Reading ring in backup SRAM, kept across resets */
+#if ADC_MON_USE_ADC
+	Adc_Mon_Init(); /* ADC1 scans of VREFINT and the die sensor on TIM3 */
+#endif /* ADC_MON_USE_ADC */
+	FlashLog_Init(); /* Long-term log in flash sectors 6-7 */
+#if CONFIG_USE_STORE
+	Config_Apply(); /* Saved plan, format, sensor types and calibration */
+#endif /* CONFIG_USE_STORE */
 	printf("*******Welcome to the DHT11_Reader *********\r\n");
-	HAL_Delay(1000); /* Give DHT11 time to stabilize */
-
-	/* Infinite loop to read DHT11 sensor
-	 * Main loop: Continuously read temperature and humidity from DHT11 sensor
-	 * and display the values over UART every 2 seconds.*/
-	while (1) {
-		ReadAndDisplayDHT11();
-	}
+	printf("Clock: %s, SYSCLK %lu Hz\r\n", Clock_GetProfileName(Clock_GetProfile()),
+			HAL_RCC_GetSysClockFreq());
+#if RAMFUNC_REPORT
+	Ramfunc_Report(); /* Where the timing-critical functions were linked */
+#endif /* RAMFUNC_REPORT */
+#if !APP_FAST_BOOT
+	HAL_Delay(DHT11_POWERUP_MS); /* Give DHT11 time to stabilize */
+#endif /* !APP_FAST_BOOT */
+#if APP_USE_BENCH
+	AppBench_Run(); /* Bench build: timing table at every clock profile */
+#endif /* APP_USE_BENCH */
+
+	/* Supervision starts with the main loop; each path checks in its own
+	 * tokens */
+	(void) Watchdog_Register("uart_tx", WATCHDOG_AGE_UART_MS, UART_TX_IsDraining);
+	Watchdog_Start(WATCHDOG_TIMEOUT_MS);
+
+#if APP_USE_RTOS
+	/* Sensor, telemetry and service tasks with fixed priorities */
+	AppRtos_Start();
+#else
+	/* Main loop: every job is a task of the cooperative scheduler, which
+	 * sleeps (STOP when possible) whenever none is due */
+	wdg_sensor = Watchdog_Register("sensor", WATCHDOG_AGE_SENSOR_MS, NULL);
+#if DHT11_USE_MULTI
+	/* All channels are read in one frame every 2 seconds, the first once
+	 * the sensors have powered up */
+	task_sensor = Sched_AddTimer("multi", Task_MultiRead,
+			DHT11_PowerUpRemainingMs());
+#elif DHT11_USE_ASYNC
+	/* The DHT11 transaction runs from TIM5/DMA interrupts and is
+	 * re-triggered every 2 seconds, or at the saved interval (config.h);
+	 * a poll task only completes results. STOP freezes TIM5, so the
+	 * scheduler hands the stopped time back. */
+	DHT11_Async_Init();
+	DHT11_Async_SetCallback(DHT11_Sink_Emit);
+	(void) Sched_AddTimer("start", Task_AsyncStart, DHT11_PowerUpRemainingMs());
+	(void) Sched_AddPoll("dht11", Task_AsyncPoll);
+	Sched_SetIdle(DHT11_Async_GetIdleUs, DHT11_Async_AdvanceTime);
+#else
+	/* Read temperature and humidity every 2 seconds, the first time once
+	 * the sensor has powered up */
+	task_sensor = Sched_AddTimer("dht11", Task_Read, DHT11_PowerUpRemainingMs());
+#endif /* DHT11_USE_MULTI / DHT11_USE_ASYNC */
+#if DHT11_USE_TRIGGER
+	(void) Sched_AddPoll("trigger", Task_Trigger); /* B1 and "read" requests */
+#endif /* DHT11_USE_TRIGGER */
+	(void) Sched_AddPoll("cli", Task_CliPoll); /* Execute complete command lines */
+	(void) Sched_AddPoll("dlog", Task_DLogProcess); /* Deferred debug records */
+	(void) Sched_AddPoll("flashlog", Task_FlashLogPoll); /* Requested dump */
+	(void) Sched_AddTimer("batch", Task_BatchPoll, TELEMETRY_BATCH_MS);
+	(void) Sched_AddTimer("wdg", Task_Watchdog, WATCHDOG_SERVICE_MS);
+#if DHT11_USE_SUPPLY
+	(void) Sched_AddTimer("supply", Task_Supply, DHT11_SUPPLY_POLL_MS);
+#endif /* DHT11_USE_SUPPLY */
+#if DVFS_USE_SCALING
+	Dvfs_Init(); /* Bursts at the boot profile, idle at low power */
+#endif /* DVFS_USE_SCALING */
+	Sched_Run();
+#endif /* APP_USE_RTOS */
 }
 
 /**
@@ -123,42 +530,103 @@ int main(void) {
  * @retval None
  */
 void SystemClock_Config(void) {
-	RCC_OscInitTypeDef RCC_OscInitStruct = { 0 };
-	RCC_ClkInitTypeDef RCC_ClkInitStruct = { 0 };
-
-	/** Configure the main internal regulator output voltage
+	/** Oscillators, PLL, regulator scale, over-drive, bus dividers and
+	 * flash wait states all come from the selected profile: the saved
+	 * one (config.h), or CLOCK_DEFAULT_PROFILE.
 	 */
-	__HAL_RCC_PWR_CLK_ENABLE();
-	__HAL_PWR_VOLTAGESCALING_CONFIG(PWR_REGULATOR_VOLTAGE_SCALE3);
+	if (Clock_ApplyProfile(Config_BootProfile()) != HAL_OK) {
+		Error_Handler();
+	}
+}
 
-	/** Initializes the RCC Oscillators according to the specified parameters
-	 * in the RCC_OscInitTypeDef structure.
-	 */
-	RCC_OscInitStruct.OscillatorType = RCC_OSCILLATORTYPE_HSE;
-	RCC_OscInitStruct.HSEState = RCC_HSE_ON;
-	RCC_OscInitStruct.PLL.PLLState = RCC_PLL_ON;
-	RCC_OscInitStruct.PLL.PLLSource = RCC_PLLSOURCE_HSE;
-	RCC_OscInitStruct.PLL.PLLM = 4;
-	RCC_OscInitStruct.PLL.PLLN = 50;
-	RCC_OscInitStruct.PLL.PLLP = RCC_PLLP_DIV2;
-	RCC_OscInitStruct.PLL.PLLQ = 2;
-	RCC_OscInitStruct.PLL.PLLR = 2;
-	if (HAL_RCC_OscConfig(&RCC_OscInitStruct) != HAL_OK) {
+#if DHT11_USE_MULTI
+/**
+ * @brief TIM1 Initialization Function
+ *        Update event every DHT11_MULTI_SAMPLE_US requests DMA2 Stream5 to
+ *        sample slot 0's IDR, CC1-CC3 the other ports'.
+ *        The counter is started by the driver.
+ * @param None
+ * @retval None
+ */
+static void MX_TIM1_Init(void) {
+
+	/* USER CODE BEGIN TIM1_Init 0 */
+
+	/* USER CODE END TIM1_Init 0 */
+
+	TIM_MasterConfigTypeDef sMasterConfig = { 0 };
+
+	/* USER CODE BEGIN TIM1_Init 1 */
+
+	/* USER CODE END TIM1_Init 1 */
+	htim1.Instance = TIM1;
+	htim1.Init.Prescaler = DHT11_Multi_TimerPrescaler();
+	htim1.Init.CounterMode = TIM_COUNTERMODE_UP;
+	htim1.Init.Period = DHT11_MULTI_SAMPLE_US - 1U;
+	htim1.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+	htim1.Init.RepetitionCounter = 0;
+	htim1.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+	if (HAL_TIM_Base_Init(&htim1) != HAL_OK) {
+		Error_Handler();
+	}
+	sMasterConfig.MasterOutputTrigger = TIM_TRGO_RESET;
+	sMasterConfig.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
+	if (HAL_TIMEx_MasterConfigSynchronization(&htim1, &sMasterConfig)
+			!= HAL_OK) {
 		Error_Handler();
 	}
+	/* USER CODE BEGIN TIM1_Init 2 */
 
-	/** Initializes the CPU, AHB and APB buses clocks
-	 */
-	RCC_ClkInitStruct.ClockType = RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_SYSCLK
-			| RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
-	RCC_ClkInitStruct.SYSCLKSource = RCC_SYSCLKSOURCE_PLLCLK;
-	RCC_ClkInitStruct.AHBCLKDivider = RCC_SYSCLK_DIV1;
-	RCC_ClkInitStruct.APB1CLKDivider = RCC_HCLK_DIV2;
-	RCC_ClkInitStruct.APB2CLKDivider = RCC_HCLK_DIV1;
-
-	if (HAL_RCC_ClockConfig(&RCC_ClkInitStruct, FLASH_LATENCY_1) != HAL_OK) {
+	/* USER CODE END TIM1_Init 2 */
+
+}
+#endif /* DHT11_USE_MULTI */
+
+/**
+ * @brief TIM5 Initialization Function
+ *        32-bit free-running 1 MHz counter, CH2 captures falling edges of
+ *        the DHT11 data line (PA1) through DMA1 Stream4.
+ * @param None
+ * @retval None
+ */
+static void MX_TIM5_Init(void) {
+
+	/* USER CODE BEGIN TIM5_Init 0 */
+
+	/* USER CODE END TIM5_Init 0 */
+
+	TIM_MasterConfigTypeDef sMasterConfig = { 0 };
+	TIM_IC_InitTypeDef sConfigIC = { 0 };
+
+	/* USER CODE BEGIN TIM5_Init 1 */
+
+	/* USER CODE END TIM5_Init 1 */
+	htim5.Instance = TIM5;
+	htim5.Init.Prescaler = DHT11_Capture_TimerPrescaler();
+	htim5.Init.CounterMode = TIM_COUNTERMODE_UP;
+	htim5.Init.Period = 0xFFFFFFFF;
+	htim5.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+	htim5.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+	if (HAL_TIM_IC_Init(&htim5) != HAL_OK) {
 		Error_Handler();
 	}
+	sMasterConfig.MasterOutputTrigger = TIM_TRGO_RESET;
+	sMasterConfig.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
+	if (HAL_TIMEx_MasterConfigSynchronization(&htim5, &sMasterConfig)
+			!= HAL_OK) {
+		Error_Handler();
+	}
+	sConfigIC.ICPolarity = TIM_INPUTCHANNELPOLARITY_FALLING;
+	sConfigIC.ICSelection = TIM_ICSELECTION_DIRECTTI;
+	sConfigIC.ICPrescaler = TIM_ICPSC_DIV1;
+	sConfigIC.ICFilter = 0;
+	if (HAL_TIM_IC_ConfigChannel(&htim5, &sConfigIC, TIM_CHANNEL_2) != HAL_OK) {
+		Error_Handler();
+	}
+	/* USER CODE BEGIN TIM5_Init 2 */
+
+	/* USER CODE END TIM5_Init 2 */
+
 }
 
 /**
@@ -178,9 +646,9 @@ static void MX_TIM6_Init(void) {
 
 	/* USER CODE END TIM6_Init 1 */
 	htim6.Instance = TIM6;
-	htim6.Init.Prescaler = 84 - 1;
+	htim6.Init.Prescaler = Timebase_TIM6Prescaler();
 	htim6.Init.CounterMode = TIM_COUNTERMODE_UP;
-	htim6.Init.Period = 0xFFFF - 1;
+	htim6.Init.Period = 0xFFFF;
 	htim6.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
 	if (HAL_TIM_Base_Init(&htim6) != HAL_OK) {
 		Error_Handler();
@@ -228,6 +696,31 @@ static void MX_USART2_UART_Init(void) {
 
 }
 
+/**
+ * Enable DMA controller clock
+ */
+static void MX_DMA_Init(void) {
+
+	/* DMA controller clock enable */
+	__HAL_RCC_DMA1_CLK_ENABLE();
+	__HAL_RCC_DMA2_CLK_ENABLE();
+
+	/* DMA interrupt init */
+	/* DMA1_Stream4_IRQn interrupt configuration */
+	HAL_NVIC_SetPriority(DMA1_Stream4_IRQn, IRQ_PRIO_CAPTURE, 0);
+	HAL_NVIC_EnableIRQ(DMA1_Stream4_IRQn);
+	/* DMA1_Stream5_IRQn interrupt configuration */
+	HAL_NVIC_SetPriority(DMA1_Stream5_IRQn, IRQ_PRIO_UART, 0);
+	HAL_NVIC_EnableIRQ(DMA1_Stream5_IRQn);
+	/* DMA1_Stream6_IRQn interrupt configuration */
+	HAL_NVIC_SetPriority(DMA1_Stream6_IRQn, IRQ_PRIO_UART, 0);
+	HAL_NVIC_EnableIRQ(DMA1_Stream6_IRQn);
+	/* DMA2_Stream5_IRQn interrupt configuration */
+	HAL_NVIC_SetPriority(DMA2_Stream5_IRQn, IRQ_PRIO_CAPTURE, 0);
+	HAL_NVIC_EnableIRQ(DMA2_Stream5_IRQn);
+
+}
+
 /**
  * @brief GPIO Initialization Function
  * @param None
@@ -274,6 +767,171 @@ static void MX_GPIO_Init(void) {
 
 /* USER CODE BEGIN 4 */
 
+/**
+ * @brief  Output compare callback, dispatched from HAL_TIM_IRQHandler().
+ * @param  htim: TIM handle
+ * @retval None
+ */
+void HAL_TIM_OC_DelayElapsedCallback(TIM_HandleTypeDef *htim) {
+	if ((htim->Instance == TIM5)
+			&& (htim->Channel == HAL_TIM_ACTIVE_CHANNEL_1)) {
+		DHT11_Async_TimerCallback();
+	}
+}
+
+/**
+ * @brief  Period elapsed callback, dispatched from HAL_TIM_IRQHandler().
+ * @param  htim: TIM handle
+ * @retval None
+ */
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim) {
+	if (htim->Instance == TIM5) {
+		SysTime_OverflowCallback();
+	}
+	if (htim->Instance == TIM6) {
+		Timebase_TIM6UpdateCallback();
+	}
+#if APP_USE_RTOS
+	if (htim->Instance == TIM7) {
+		HAL_IncTick(); /* HAL timebase while the kernel owns SysTick */
+	}
+#endif /* APP_USE_RTOS */
+}
+
+/**
+ * @brief  Tx transfer completed callback.
+ * @param  huart: UART handle
+ * @retval None
+ */
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
+	if (huart->Instance == USART2) {
+#if MODBUS_USE_RTU
+		if (Modbus_IsActive() != 0U) {
+			Modbus_TxCompleteCallback();
+			return;
+		}
+#endif /* MODBUS_USE_RTU */
+		UART_TX_CompleteCallback();
+	}
+}
+
+/**
+ * @brief  UART error callback.
+ * @param  huart: UART handle
+ * @retval None
+ */
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart) {
+	if (huart->Instance == USART2) {
+		UART_TX_ErrorCallback();
+		UART_RX_ErrorCallback();
+#if MODBUS_USE_RTU
+		Modbus_ErrorCallback();
+#endif /* MODBUS_USE_RTU */
+	}
+}
+
+/**
+ * @brief  EXTI line detection callback.
+ * @param  GPIO_Pin: Pin whose line triggered
+ * @retval None
+ */
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin) {
+	if (GPIO_Pin == USART_RX_Pin) {
+		Power_RxWakeCallback();
+	}
+}
+
+/**
+ * @brief  Reception event callback (IDLE line, half or full buffer).
+ * @param  huart: UART handle
+ * @param  Size: Write position in the receive buffer
+ * @retval None
+ */
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size) {
+	if (huart->Instance == USART2) {
+		UART_RX_EventCallback(Size);
+#if MODBUS_USE_RTU
+		Modbus_RxEventCallback();
+#endif /* MODBUS_USE_RTU */
+	}
+}
+
+/**
+ * @brief  Re-derives bus-clock dependent timing after a profile switch.
+ * @param  profile: Newly active clock profile
+ * @retval None
+ */
+void Clock_ProfileChangedCallback(clock_profile_t profile) {
+	uint32_t cnt;
+	uint32_t primask;
+
+	(void) profile;
+
+	/* Baud rate divisor and oversampling from the new PCLK1 */
+	UART_Baud_ClockChanged();
+#if USB_USE_CDC
+	/* No 48 MHz without the HSE: off, and output back on USART2 */
+	Usb_Cdc_ClockChanged();
+#endif /* USB_USE_CDC */
+#if CAN_USE_BUS
+	/* Bit timing from the new PCLK1 */
+	Can_Bus_ClockChanged();
+#endif /* CAN_USE_BUS */
+#if I2C_USE_REGMAP
+	I2C_Regmap_ClockChanged();
+#endif /* I2C_USE_REGMAP */
+#if MODBUS_USE_RTU
+	Modbus_ClockChanged();
+#endif /* MODBUS_USE_RTU */
+#if RS485_USE_GATEWAY
+	Rs485_Gw_ClockChanged();
+#endif /* RS485_USE_GATEWAY */
+
+	/* Keep TIM5 and TIM6 at 1 MHz; UG loads the new prescaler at once and
+	 * restarts the counters, so switch only while no DHT11 read is pending.
+	 * TIM5's count is put back: the async refresh deadline on CCR1 holds */
+	htim5.Init.Prescaler = DHT11_Capture_TimerPrescaler();
+	htim5.Instance->PSC = htim5.Init.Prescaler;
+	primask = __get_PRIMASK();
+	__disable_irq(); /* No handler may read the count at 0 (tickless.h) */
+	cnt = htim5.Instance->CNT;
+	htim5.Instance->EGR = TIM_EGR_UG;
+	htim5.Instance->CNT = cnt;
+	__set_PRIMASK(primask);
+	htim6.Init.Prescaler = Timebase_TIM6Prescaler();
+	htim6.Instance->PSC = htim6.Init.Prescaler;
+	htim6.Instance->EGR = TIM_EGR_UG;
+
+#if DHT11_USE_OVERSAMPLE
+	DHT11_Oversample_ClockChanged();
+#endif /* DHT11_USE_OVERSAMPLE */
+#if DHT11_EMU_USE_LOOPBACK
+	DHT11_Emu_ClockChanged();
+#endif /* DHT11_EMU_USE_LOOPBACK */
+#if STATUS_LED_USE_PWM
+	Status_Led_ClockChanged();
+#endif /* STATUS_LED_USE_PWM */
+#if ADC_MON_USE_ADC
+	Adc_Mon_ClockChanged();
+#endif /* ADC_MON_USE_ADC */
+#if WATERMARK_USE_LATENCY
+	Watermark_ClockChanged();
+#endif /* WATERMARK_USE_LATENCY */
+#if DHT11_USE_MULTI
+	htim1.Init.Prescaler = DHT11_Multi_TimerPrescaler();
+	htim1.Instance->PSC = htim1.Init.Prescaler;
+	htim1.Instance->EGR = TIM_EGR_UG;
+#endif /* DHT11_USE_MULTI */
+
+	Timebase_Recalibrate();
+#if SWO_USE_ITM
+	Swo_ClockChanged();
+#endif /* SWO_USE_ITM */
+#if APP_USE_RTOS
+	AppRtos_ClockChanged();
+#endif /* APP_USE_RTOS */
+}
+
 /* USER CODE END 4 */
 
 /**
@@ -282,10 +940,8 @@ static void MX_GPIO_Init(void) {
  */
 void Error_Handler(void) {
 	/* USER CODE BEGIN Error_Handler_Debug */
-	/* User can add his own implementation to report the HAL error return state */
-	__disable_irq();
-	while (1) {
-	}
+	/* Record the caller in the crash log and reset (crash.h) */
+	Crash_Error((uint32_t) __builtin_return_address(0));
 	/* USER CODE END Error_Handler_Debug */
 }
 
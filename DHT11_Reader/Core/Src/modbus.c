@@ -0,0 +1,504 @@
+/**
+ ******************************************************************************
+ * @file           : modbus.c
+ * @brief          : Modbus RTU slave on USART2.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "modbus.h"
+#include "irq_prio.h"
+#include "uart_tx.h"
+#include "uart_rx.h"
+#include "uart_baud.h"
+#include "usb_cdc.h"
+#include "clock_config.h"
+#include "dht11_sink.h"
+#include "dht11_async.h"
+#include "dht11_latest.h"
+#include "memmap.h"
+#include "crc.h"
+#include <string.h>
+
+#if MODBUS_USE_RTU
+
+/** RS-485 driver enable */
+#define MODBUS_DE_Pin       GPIO_PIN_8
+#define MODBUS_DE_GPIO_Port GPIOA
+
+/** t3.5 timer, 1 MHz one-pulse */
+#define MODBUS_TIM          (TIM4)
+#define MODBUS_TIM_HZ       (1000000U)
+
+/** Fixed t3.5 above 19200 baud, from the RTU spec */
+#define MODBUS_T35_FAST_US  (1750U)
+#define MODBUS_FAST_BAUD    (19200U)
+
+/** 8N1: start, eight data bits, stop */
+#define MODBUS_CHAR_BITS    (10U)
+
+/** Function codes and exceptions */
+#define MODBUS_FC_READ_HOLDING   (0x03U)
+#define MODBUS_FC_READ_INPUT     (0x04U)
+#define MODBUS_FC_WRITE_SINGLE   (0x06U)
+#define MODBUS_FC_WRITE_MULTIPLE (0x10U)
+#define MODBUS_EX_FUNCTION       (0x01U)
+#define MODBUS_EX_ADDRESS        (0x02U)
+#define MODBUS_EX_VALUE          (0x03U)
+
+/** Register counts per request, from the spec */
+#define MODBUS_READ_MAX     (125U)
+#define MODBUS_WRITE_MAX    (123U)
+
+#define MODBUS_BROADCAST    (0U)
+#define MODBUS_ADDRESS_MAX  (247U)
+#define MODBUS_INPUT_COUNT  (MODBUS_SENSORS * MODBUS_REGS_PER_SENSOR)
+#define MODBUS_STATS_COUNT  (4U)
+
+extern UART_HandleTypeDef huart2;
+
+static uint8_t mb_rx[MODBUS_ADU_MAX];
+static uint8_t mb_tx[MODBUS_ADU_MAX] DMA_BUFFER;
+/** Sensor a read request is answered from; taken at its first register,
+ * so one reply never mixes two readings (TIM4 interrupt only) */
+static dht11_latest_t mb_snap;
+static uint32_t mb_snap_count = 0U;
+static uint32_t mb_snap_sensor = MODBUS_SENSORS;
+static uint16_t mb_holding[MODBUS_HOLDING_COUNT];
+static volatile uint32_t mb_hold_dirty = 0U;
+static volatile uint8_t mb_address = MODBUS_ADDRESS;
+static volatile uint8_t mb_active = 0U;
+static volatile uint8_t mb_sending = 0U;
+static uint32_t mb_arm_pos = 0U;
+static modbus_stats_t mb_stats;
+
+/**
+ * @brief Big-endian register field of a request.
+ */
+static uint16_t Modbus_Get16(const uint8_t *p) {
+	return (uint16_t) (((uint16_t) p[0] << 8) | p[1]);
+}
+
+static void Modbus_Put16(uint8_t *p, uint16_t v) {
+	p[0] = (uint8_t) (v >> 8);
+	p[1] = (uint8_t) v;
+}
+
+/**
+ * @brief Sets TIM4 to 1 MHz from the APB1 timer clock.
+ */
+static void Modbus_TimerPrescaler(void) {
+	MODBUS_TIM->PSC = (Clock_GetApb1TimerHz() / MODBUS_TIM_HZ) - 1U;
+	MODBUS_TIM->EGR = TIM_EGR_UG;          /* URS: no update interrupt */
+	MODBUS_TIM->SR = 0U;
+}
+
+/**
+ * @brief Holding registers from the live settings, unless a write is
+ *        still to be applied.
+ */
+static void Modbus_SyncHolding(void) {
+	uint32_t interval = 0U;
+	uint32_t basepri;
+
+#if DHT11_USE_ASYNC
+	interval = DHT11_Async_GetInterval();
+#endif /* DHT11_USE_ASYNC */
+	basepri = Irq_MaskFrom(IRQ_PRIO_UART);
+	if (mb_hold_dirty == 0U) {
+		mb_holding[MODBUS_HOLD_INTERVAL_HI] = (uint16_t) (interval >> 16);
+		mb_holding[MODBUS_HOLD_INTERVAL_LO] = (uint16_t) interval;
+		mb_holding[MODBUS_HOLD_FORMAT] = (uint16_t) DHT11_Sink_GetFormat();
+		mb_holding[MODBUS_HOLD_ADDRESS] = mb_address;
+	}
+	Irq_Unmask(basepri);
+}
+
+/**
+ * @brief Moves console output off USART2 and starts listening.
+ */
+void Modbus_Init(void) {
+	GPIO_InitTypeDef GPIO_InitStruct = { 0 };
+
+	(void) memset(&mb_stats, 0, sizeof(mb_stats));
+	mb_address = MODBUS_ADDRESS;
+	mb_hold_dirty = 0U;
+	Modbus_SyncHolding();
+
+	/* The master would read text as garbled frames */
+	(void) UART_TX_Flush(UART_TX_SWITCH_MS);
+	(void) UART_TX_SetTransport((Usb_Cdc_IsStarted() != 0U) ?
+			UART_TX_TRANSPORT_USB : UART_TX_TRANSPORT_NONE);
+
+	__HAL_RCC_GPIOA_CLK_ENABLE();
+	HAL_GPIO_WritePin(MODBUS_DE_GPIO_Port, MODBUS_DE_Pin, GPIO_PIN_RESET);
+	GPIO_InitStruct.Pin = MODBUS_DE_Pin;
+	GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
+	GPIO_InitStruct.Pull = GPIO_NOPULL;
+	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+	HAL_GPIO_Init(MODBUS_DE_GPIO_Port, &GPIO_InitStruct);
+
+	__HAL_RCC_TIM4_CLK_ENABLE();
+	MODBUS_TIM->CR1 = TIM_CR1_OPM | TIM_CR1_URS;
+	Modbus_TimerPrescaler();
+	MODBUS_TIM->DIER = TIM_DIER_UIE;
+	HAL_NVIC_SetPriority(TIM4_IRQn, IRQ_PRIO_UART, 0U);
+	HAL_NVIC_EnableIRQ(TIM4_IRQn);
+
+	/* Whatever the console left in the ring is not a request */
+	while (UART_RX_Read(mb_rx, sizeof(mb_rx)) != 0U) {
+	}
+	mb_active = 1U;
+}
+
+/**
+ * @brief Reports whether USART2 belongs to Modbus.
+ */
+uint8_t Modbus_IsActive(void) {
+	return mb_active;
+}
+
+/**
+ * @brief Applies holding register writes.
+ */
+void Modbus_Poll(void) {
+	uint32_t dirty;
+	uint32_t interval;
+	uint32_t basepri;
+
+	if (mb_hold_dirty == 0U) {
+		return;
+	}
+	basepri = Irq_MaskFrom(IRQ_PRIO_UART);
+	dirty = mb_hold_dirty;
+	interval = ((uint32_t) mb_holding[MODBUS_HOLD_INTERVAL_HI] << 16)
+			| mb_holding[MODBUS_HOLD_INTERVAL_LO];
+	mb_hold_dirty = 0U;
+	Irq_Unmask(basepri);
+
+#if DHT11_USE_ASYNC
+	/* Same floor as the CLI: the DHT11 needs 1 s between reads */
+	if (((dirty & ((1UL << MODBUS_HOLD_INTERVAL_HI)
+			| (1UL << MODBUS_HOLD_INTERVAL_LO))) != 0U)
+			&& ((interval == 0U) || (interval >= 1000U))) {
+		DHT11_Async_SetInterval(interval);
+		if ((interval != 0U) && (DHT11_Async_IsBusy() == 0U)) {
+			(void) DHT11_StartAsync();
+		}
+	}
+#else
+	(void) interval;
+#endif /* DHT11_USE_ASYNC */
+	if ((dirty & (1UL << MODBUS_HOLD_FORMAT)) != 0U) {
+		DHT11_Sink_SetFormat((dht11_format_t) mb_holding[MODBUS_HOLD_FORMAT]);
+	}
+	if ((dirty & (1UL << MODBUS_HOLD_ADDRESS)) != 0U) {
+		mb_address = (uint8_t) mb_holding[MODBUS_HOLD_ADDRESS];
+	}
+	Modbus_SyncHolding();
+}
+
+/**
+ * @brief Copies the frame counters.
+ */
+void Modbus_GetStats(modbus_stats_t *stats) {
+	uint32_t basepri = Irq_MaskFrom(IRQ_PRIO_UART);
+
+	*stats = mb_stats;
+	Irq_Unmask(basepri);
+}
+
+/**
+ * @brief Recomputes the TIM4 prescaler.
+ */
+void Modbus_ClockChanged(void) {
+	if (mb_active != 0U) {
+		Modbus_TimerPrescaler();
+	}
+}
+
+/**
+ * @brief Value of one input register.
+ * @retval 1 if mapped.
+ */
+static uint8_t Modbus_InputReg(uint32_t addr, uint16_t *value) {
+	uint32_t uptime_s = HAL_GetTick() / 1000U;
+	uint32_t failures;
+
+	if (addr < MODBUS_INPUT_COUNT) {
+		if ((addr / MODBUS_REGS_PER_SENSOR) != mb_snap_sensor) {
+			mb_snap_sensor = addr / MODBUS_REGS_PER_SENSOR;
+			mb_snap_count = DHT11_Latest_Get((uint8_t) mb_snap_sensor,
+					&mb_snap);
+		}
+		failures = mb_snap.failures;
+		switch (addr % MODBUS_REGS_PER_SENSOR) {
+		case 0U:
+			*value = (uint16_t) mb_snap.reading.status;
+			break;
+		case 1U:
+			*value = (uint16_t) mb_snap.values.temp;
+			break;
+		case 2U:
+			*value = (uint16_t) mb_snap.values.hum;
+			break;
+		case 3U:
+			*value = (uint16_t) mb_snap.values.dew_point;
+			break;
+		case 4U:
+			*value = mb_snap.reading.confidence;
+			break;
+		case 5U:
+			*value = (uint16_t) mb_snap.health;
+			break;
+		case 6U:
+			*value = (uint16_t) mb_snap_count;
+			break;
+		default:
+			*value = (uint16_t) ((failures > 0xFFFFU) ? 0xFFFFU : failures);
+			break;
+		}
+		return 1U;
+	}
+	switch (addr) {
+	case MODBUS_INPUT_STATS:
+		*value = (uint16_t) (uptime_s >> 16);
+		return 1U;
+	case MODBUS_INPUT_STATS + 1U:
+		*value = (uint16_t) uptime_s;
+		return 1U;
+	case MODBUS_INPUT_STATS + 2U:
+		*value = (uint16_t) mb_stats.frames;
+		return 1U;
+	case MODBUS_INPUT_STATS + 3U:
+		*value = (uint16_t) mb_stats.crc_errors;
+		return 1U;
+	default:
+		return 0U;
+	}
+}
+
+/**
+ * @brief Checks a value for a holding register.
+ */
+static uint8_t Modbus_HoldingValid(uint32_t reg, uint16_t value) {
+	switch (reg) {
+	case MODBUS_HOLD_FORMAT:
+		return (value <= (uint16_t) DHT11_FORMAT_SCHEMA) ? 1U : 0U;
+	case MODBUS_HOLD_ADDRESS:
+		return ((value != MODBUS_BROADCAST) && (value <= MODBUS_ADDRESS_MAX)) ?
+				1U : 0U;
+	default:
+		return 1U;
+	}
+}
+
+/**
+ * @brief Stores a validated holding register; the address takes effect
+ *        after the reply, which still carries the old one.
+ */
+static void Modbus_HoldingWrite(uint32_t reg, uint16_t value) {
+	mb_holding[reg] = value;
+	mb_hold_dirty |= 1UL << reg;
+}
+
+/**
+ * @brief Builds an exception reply.
+ */
+static uint32_t Modbus_Exception(uint8_t fc, uint8_t code) {
+	mb_tx[1] = fc | 0x80U;
+	mb_tx[2] = code;
+	mb_stats.exceptions++;
+	return 3U;
+}
+
+/**
+ * @brief Executes a request addressed to this slave.
+ * @retval Reply length without the CRC.
+ */
+static uint32_t Modbus_Execute(const uint8_t *req, uint32_t len) {
+	uint8_t fc = req[1];
+	uint32_t start;
+	uint32_t qty;
+	uint32_t i;
+	uint16_t value;
+
+	mb_tx[0] = req[0];
+	mb_tx[1] = fc;
+	switch (fc) {
+	case MODBUS_FC_READ_HOLDING:
+	case MODBUS_FC_READ_INPUT:
+		if (len != 6U) {
+			return Modbus_Exception(fc, MODBUS_EX_VALUE);
+		}
+		start = Modbus_Get16(&req[2]);
+		qty = Modbus_Get16(&req[4]);
+		if ((qty == 0U) || (qty > MODBUS_READ_MAX)) {
+			return Modbus_Exception(fc, MODBUS_EX_VALUE);
+		}
+		mb_snap_sensor = MODBUS_SENSORS;
+		for (i = 0U; i < qty; i++) {
+			if (fc == MODBUS_FC_READ_HOLDING) {
+				if ((start + i) >= MODBUS_HOLDING_COUNT) {
+					return Modbus_Exception(fc, MODBUS_EX_ADDRESS);
+				}
+				value = mb_holding[start + i];
+			} else if (Modbus_InputReg(start + i, &value) == 0U) {
+				return Modbus_Exception(fc, MODBUS_EX_ADDRESS);
+			}
+			Modbus_Put16(&mb_tx[3U + (2U * i)], value);
+		}
+		mb_tx[2] = (uint8_t) (2U * qty);
+		return 3U + (2U * qty);
+
+	case MODBUS_FC_WRITE_SINGLE:
+		if (len != 6U) {
+			return Modbus_Exception(fc, MODBUS_EX_VALUE);
+		}
+		start = Modbus_Get16(&req[2]);
+		value = Modbus_Get16(&req[4]);
+		if (start >= MODBUS_HOLDING_COUNT) {
+			return Modbus_Exception(fc, MODBUS_EX_ADDRESS);
+		}
+		if (Modbus_HoldingValid(start, value) == 0U) {
+			return Modbus_Exception(fc, MODBUS_EX_VALUE);
+		}
+		Modbus_HoldingWrite(start, value);
+		(void) memcpy(&mb_tx[2], &req[2], 4U);   /* Echo */
+		return 6U;
+
+	case MODBUS_FC_WRITE_MULTIPLE:
+		if (len < 7U) {
+			return Modbus_Exception(fc, MODBUS_EX_VALUE);
+		}
+		start = Modbus_Get16(&req[2]);
+		qty = Modbus_Get16(&req[4]);
+		if ((qty == 0U) || (qty > MODBUS_WRITE_MAX) || (req[6] != (2U * qty))
+				|| (len != (7U + (2U * qty)))) {
+			return Modbus_Exception(fc, MODBUS_EX_VALUE);
+		}
+		if ((start + qty) > MODBUS_HOLDING_COUNT) {
+			return Modbus_Exception(fc, MODBUS_EX_ADDRESS);
+		}
+		/* All or nothing */
+		for (i = 0U; i < qty; i++) {
+			if (Modbus_HoldingValid(start + i,
+					Modbus_Get16(&req[7U + (2U * i)])) == 0U) {
+				return Modbus_Exception(fc, MODBUS_EX_VALUE);
+			}
+		}
+		for (i = 0U; i < qty; i++) {
+			Modbus_HoldingWrite(start + i, Modbus_Get16(&req[7U + (2U * i)]));
+		}
+		(void) memcpy(&mb_tx[2], &req[2], 4U);
+		return 6U;
+
+	default:
+		return Modbus_Exception(fc, MODBUS_EX_FUNCTION);
+	}
+}
+
+/**
+ * @brief Validates a complete frame and starts the reply.
+ */
+static void Modbus_Frame(uint32_t len) {
+	uint8_t addr;
+	uint16_t crc;
+	uint32_t n;
+
+	if (len < 4U) {
+		return;
+	}
+	crc = Crc_Modbus16(mb_rx, len - 2U);
+	if ((mb_rx[len - 2U] != (uint8_t) crc)
+			|| (mb_rx[len - 1U] != (uint8_t) (crc >> 8))) {
+		mb_stats.crc_errors++;
+		return;
+	}
+	addr = mb_rx[0];
+	if ((addr != mb_address) && (addr != MODBUS_BROADCAST)) {
+		mb_stats.foreign++;
+		return;
+	}
+	n = Modbus_Execute(mb_rx, len - 2U);
+	mb_stats.frames++;
+	if ((addr == MODBUS_BROADCAST) || (mb_sending != 0U)) {
+		return;
+	}
+	crc = Crc_Modbus16(mb_tx, n);
+	mb_tx[n++] = (uint8_t) crc;
+	mb_tx[n++] = (uint8_t) (crc >> 8);
+
+	HAL_GPIO_WritePin(MODBUS_DE_GPIO_Port, MODBUS_DE_Pin, GPIO_PIN_SET);
+	if (HAL_UART_Transmit_DMA(&huart2, mb_tx, (uint16_t) n) == HAL_OK) {
+		mb_sending = 1U;
+	} else {
+		HAL_GPIO_WritePin(MODBUS_DE_GPIO_Port, MODBUS_DE_Pin, GPIO_PIN_RESET);
+	}
+}
+
+/**
+ * @brief Restarts the t3.5 timer from the current ring position.
+ */
+void Modbus_RxEventCallback(void) {
+	uint32_t baud = UART_Baud_Get();
+	uint32_t char_us = (MODBUS_CHAR_BITS * 1000000U) / baud;
+	uint32_t t35_us = (baud > MODBUS_FAST_BAUD) ? MODBUS_T35_FAST_US
+			: ((35U * char_us) / 10U);
+
+	if (mb_active == 0U) {
+		return;
+	}
+	/* IDLE already waited one character of the silence */
+	mb_arm_pos = UART_RX_GetPosition();
+	MODBUS_TIM->CR1 &= ~TIM_CR1_CEN;
+	MODBUS_TIM->CNT = 0U;
+	MODBUS_TIM->ARR = (t35_us > char_us) ? (t35_us - char_us) : 1U;
+	MODBUS_TIM->SR = 0U;
+	MODBUS_TIM->CR1 |= TIM_CR1_CEN;
+}
+
+/**
+ * @brief Line released once the last stop bit left; any echo of the
+ *        reply (half-duplex transceivers) is not a request.
+ */
+void Modbus_TxCompleteCallback(void) {
+	HAL_GPIO_WritePin(MODBUS_DE_GPIO_Port, MODBUS_DE_Pin, GPIO_PIN_RESET);
+	while (UART_RX_Read(mb_rx, sizeof(mb_rx)) != 0U) {
+	}
+	mb_sending = 0U;
+}
+
+/**
+ * @brief UART error: a reply HAL aborted is over.
+ */
+void Modbus_ErrorCallback(void) {
+	if ((mb_sending != 0U) && (huart2.gState == HAL_UART_STATE_READY)) {
+		Modbus_TxCompleteCallback();
+	}
+}
+
+/**
+ * @brief t3.5 expired: a frame ends here unless bytes arrived meanwhile.
+ */
+void Modbus_TimerIRQHandler(void) {
+	uint32_t len;
+
+	MODBUS_TIM->SR = 0U;
+	if (UART_RX_GetPosition() != mb_arm_pos) {
+		return;    /* Still receiving; the next IDLE rearms */
+	}
+	len = UART_RX_Read(mb_rx, sizeof(mb_rx));
+	if (len == sizeof(mb_rx)) {
+		/* Longer than any RTU frame: drop the rest too */
+		while (UART_RX_Read(mb_rx, sizeof(mb_rx)) != 0U) {
+		}
+		return;
+	}
+	Modbus_Frame(len);
+}
+
+#endif /* MODBUS_USE_RTU */
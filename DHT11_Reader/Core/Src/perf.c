@@ -0,0 +1,295 @@
+/**
+ ******************************************************************************
+ * @file           : perf.c
+ * @brief          : CPU time accounting from the DWT counters.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "perf.h"
+#include "timebase.h"
+#include "power.h"
+#include "sched.h"
+#include "telemetry.h"
+#include "crc.h"
+#include "uart_tx.h"
+#include "watermark.h"
+#include <stdio.h>
+#include <string.h>
+
+/** Packet: type, n, timestamp, window, stop, 3 shares, n shares, CRC */
+#define PERF_PKT_HEADER_LEN (TELEMETRY_PERF_HEADER)
+#define PERF_PKT_LEN        (PERF_PKT_HEADER_LEN + (2U * PERF_ISR_COUNT) + 2U)
+
+_Static_assert(PERF_PKT_LEN <= TELEMETRY_PKT_MAX,
+		"CPU load packet longer than TELEMETRY_PKT_MAX");
+
+static const char *const perf_isr_names[PERF_ISR_COUNT] = { "systick",
+		"rtc_wkup", "exti1", "exti3", "dma1_s4", "dma1_s5", "dma1_s6",
+		"usart2", "tim5", "tim6", "tim7", "dma2_s5", "otg_fs",
+		"can1_tx", "can1_rx0", "can1_sce",
+		"i2c1_ev", "i2c1_er", "dma1_s7", "tim4", "exti15_10", "dma1_s1",
+		"exti0", "exti9_5", "tim2", "adc", "usart3", "tim12", "tim11" };
+
+/* Written by the handlers, with interrupts masked */
+static perf_isr_stat_t perf_isr[PERF_ISR_COUNT];
+static uint64_t perf_isr_cycles = 0U;  /* Since boot                     */
+static uint64_t perf_exc_cycles = 0U;  /* In the window                  */
+static uint32_t perf_nested = 0U;      /* Of the running handler         */
+static uint8_t perf_exc_last = 0U;
+
+/* Thread context */
+static uint64_t perf_sleep_cycles = 0U;
+static uint32_t perf_idle_start = 0U;
+static uint64_t perf_idle_isr = 0U;
+static uint64_t perf_window_start = 0U;
+static uint64_t perf_window_isr = 0U;  /* perf_isr_cycles at the start   */
+static uint32_t perf_window_tick = 0U;
+static uint32_t perf_window_stop_ms = 0U;
+
+/**
+ * @brief Little-endian stores into a packet.
+ */
+static void Perf_Put16(uint8_t *p, uint32_t v) {
+	p[0] = (uint8_t) v;
+	p[1] = (uint8_t) (v >> 8);
+}
+
+static void Perf_Put32(uint8_t *p, uint32_t v) {
+	Perf_Put16(p, v);
+	Perf_Put16(&p[2], v >> 16);
+}
+
+/**
+ * @brief Enables the DWT event counters and starts a window.
+ */
+void Perf_Init(void) {
+	Timebase_EnableCycleCounter();
+	DWT->EXCCNT = 0U;
+	DWT->LSUCNT = 0U;
+	DWT->FOLDCNT = 0U;
+	DWT->CTRL |= DWT_CTRL_EXCEVTENA_Msk | DWT_CTRL_LSUEVTENA_Msk
+			| DWT_CTRL_FOLDEVTENA_Msk;
+	perf_exc_last = 0U;
+	Perf_Reset();
+}
+
+/**
+ * @brief Starts a new window.
+ */
+void Perf_Reset(void) {
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	memset(perf_isr, 0, sizeof(perf_isr));
+	perf_exc_cycles = 0U;
+	perf_window_isr = perf_isr_cycles;
+	__set_PRIMASK(primask);
+
+	perf_sleep_cycles = 0U;
+	perf_window_start = Timebase_Cycles64();
+	perf_window_tick = HAL_GetTick();
+	perf_window_stop_ms = Power_GetStopTimeMs();
+	Sched_ResetLoad();
+#if WATERMARK_USE_LATENCY
+	Watermark_ResetLatency();
+#endif /* WATERMARK_USE_LATENCY */
+}
+
+/**
+ * @brief Marks a handler entry.
+ */
+void Perf_IsrEnter(perf_frame_t *frame) {
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	frame->start = DWT->CYCCNT;
+	frame->outer = perf_nested;
+	perf_nested = 0U;
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @brief Charges a handler its run time less the handlers nested in it.
+ */
+void Perf_IsrExit(perf_frame_t *frame, perf_isr_t isr) {
+	perf_isr_stat_t *stat = &perf_isr[isr];
+	uint32_t primask = __get_PRIMASK();
+	uint32_t total;
+	uint32_t self;
+	uint8_t exc;
+
+	__disable_irq();
+	total = DWT->CYCCNT - frame->start;
+	self = total - perf_nested;
+	stat->count++;
+	stat->cycles += self;
+	if (self > stat->max_cycles) {
+		stat->max_cycles = self;
+	}
+	perf_isr_cycles += self;
+	exc = (uint8_t) DWT->EXCCNT;
+	perf_exc_cycles += (uint8_t) (exc - perf_exc_last);
+	perf_exc_last = exc;
+	perf_nested = frame->outer + total;
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @brief Cycles spent in handler bodies since boot.
+ */
+uint64_t Perf_IsrCycles(void) {
+	uint32_t primask = __get_PRIMASK();
+	uint64_t cycles;
+
+	__disable_irq();
+	cycles = perf_isr_cycles;
+	__set_PRIMASK(primask);
+	return cycles;
+}
+
+/**
+ * @brief Call right before a WFI.
+ */
+void Perf_IdleBegin(void) {
+	perf_idle_isr = Perf_IsrCycles();
+	perf_idle_start = DWT->CYCCNT;
+}
+
+/**
+ * @brief Call right after the WFI returns. The wake-up handler runs
+ *        before WFI returns, so its time is taken back out.
+ */
+void Perf_IdleEnd(void) {
+	uint32_t elapsed = DWT->CYCCNT - perf_idle_start;
+	uint64_t isr = Perf_IsrCycles() - perf_idle_isr;
+
+	if (elapsed > isr) {
+		perf_sleep_cycles += elapsed - isr;
+	}
+}
+
+/**
+ * @brief Awake cycles in the current window.
+ */
+uint64_t Perf_WindowCycles(void) {
+	return Timebase_Cycles64() - perf_window_start;
+}
+
+/**
+ * @brief Share of the window, permille.
+ */
+uint32_t Perf_Permille(uint64_t cycles, uint64_t window) {
+	if (window == 0U) {
+		return 0U;
+	}
+	if (cycles >= window) {
+		return 1000U;
+	}
+	return (uint32_t) ((cycles * 1000U) / window);
+}
+
+/**
+ * @brief Computes the shares of the current window.
+ */
+void Perf_GetLoad(perf_load_t *load) {
+	uint64_t window = Perf_WindowCycles();
+	uint64_t sleep = perf_sleep_cycles;
+	uint64_t isr = Perf_IsrCycles() - perf_window_isr;
+	uint32_t primask;
+	uint64_t exc;
+	uint32_t i;
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	exc = perf_exc_cycles;
+	for (i = 0U; i < PERF_ISR_COUNT; i++) {
+		load->isr_each_pm[i] = (uint16_t) Perf_Permille(perf_isr[i].cycles,
+				window);
+	}
+	__set_PRIMASK(primask);
+
+	load->window_ms = HAL_GetTick() - perf_window_tick;
+	load->stop_ms = Power_GetStopTimeMs() - perf_window_stop_ms;
+	load->busy_pm = (uint16_t) (1000U - Perf_Permille(sleep, window));
+	load->isr_pm = (uint16_t) Perf_Permille(isr, window);
+	load->exc_pm = (uint16_t) Perf_Permille(exc, window);
+}
+
+/**
+ * @brief Accounting of one handler in the current window.
+ */
+const perf_isr_stat_t* Perf_GetIsr(perf_isr_t isr) {
+	return &perf_isr[(isr < PERF_ISR_COUNT) ? isr : PERF_ISR_SYSTICK];
+}
+
+/**
+ * @brief Short handler name.
+ */
+const char* Perf_IsrName(perf_isr_t isr) {
+	return (isr < PERF_ISR_COUNT) ? perf_isr_names[isr] : "?";
+}
+
+/**
+ * @brief Prints the window shares and one line per handler that ran.
+ */
+void Perf_Dump(void) {
+	perf_load_t load;
+	perf_isr_stat_t stat;
+	uint32_t primask;
+	uint32_t i;
+
+	Perf_GetLoad(&load);
+	printf("perf window_ms %lu stop_ms %lu busy %u.%u%% isr %u.%u%% exc %u.%u%%\r\n",
+			load.window_ms, load.stop_ms, load.busy_pm / 10U,
+			load.busy_pm % 10U, load.isr_pm / 10U, load.isr_pm % 10U,
+			load.exc_pm / 10U, load.exc_pm % 10U);
+	for (i = 0U; i < PERF_ISR_COUNT; i++) {
+		primask = __get_PRIMASK();
+		__disable_irq();
+		stat = perf_isr[i];
+		__set_PRIMASK(primask);
+		if (stat.count == 0U) {
+			continue;
+		}
+		printf("isr %s n %lu load %u.%u%% max_us %lu\r\n", perf_isr_names[i],
+				stat.count, load.isr_each_pm[i] / 10U,
+				load.isr_each_pm[i] % 10U,
+				stat.max_cycles / Timebase_CyclesPerUs());
+	}
+}
+
+/**
+ * @brief Queues the window shares as one TELEMETRY_TYPE_PERF packet.
+ */
+void Perf_Send(void) {
+	uint8_t pkt[PERF_PKT_LEN];
+	uint8_t frame[TELEMETRY_COBS_MAX(PERF_PKT_LEN)];
+	perf_load_t load;
+	uint32_t len = PERF_PKT_HEADER_LEN;
+	uint16_t crc;
+	uint32_t i;
+
+	Perf_GetLoad(&load);
+	pkt[0] = TELEMETRY_TYPE_PERF;
+	pkt[1] = (uint8_t) PERF_ISR_COUNT;
+	Perf_Put32(&pkt[2], HAL_GetTick());
+	Perf_Put32(&pkt[6], load.window_ms);
+	Perf_Put32(&pkt[10], load.stop_ms);
+	Perf_Put16(&pkt[14], load.busy_pm);
+	Perf_Put16(&pkt[16], load.isr_pm);
+	Perf_Put16(&pkt[18], load.exc_pm);
+	for (i = 0U; i < PERF_ISR_COUNT; i++) {
+		Perf_Put16(&pkt[len], load.isr_each_pm[i]);
+		len += 2U;
+	}
+	crc = Crc_Ccitt16(pkt, len);
+	Perf_Put16(&pkt[len], crc);
+	len += 2U;
+
+	len = Telemetry_CobsEncode(pkt, len, frame);
+	(void) UART_TX_Write(frame, len);
+}
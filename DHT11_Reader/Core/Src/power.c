@@ -0,0 +1,557 @@
+/**
+ ******************************************************************************
+ * @file           : power.c
+ * @brief          : STOP-mode idle with RTC wakeup.
+ *
+ *                   RTC on the LSE when it starts, else on the LSI:
+ *                   PREDIV_A = 1, PREDIV_S = RTCCLK/2 - 1, so the sub-second
+ *                   counter runs at RTCCLK/2 (~61 us) and the calendar at
+ *                   1 Hz. Shadow registers are bypassed so the counters can
+ *                   be read right after a STOP wake without waiting for
+ *                   RSF. The wakeup timer runs at RTC/16.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "power.h"
+#include "clock_config.h"
+#include "uart_tx.h"
+#include "uart_baud.h"
+#include "app_rtos.h"
+#include "irq_prio.h"
+#include "perf.h"
+#include "usb_cdc.h"
+#include "can_bus.h"
+#include "i2c_regmap.h"
+#include "modbus.h"
+#include "dht11_emu.h"
+#include "systime.h"
+#include "dht11_sync.h"
+#include "status_led.h"
+#include "rs485_gw.h"
+#include "tickless.h"
+
+extern TIM_HandleTypeDef htim5;
+extern UART_HandleTypeDef huart2;
+
+/** LSI calibration: TIM5 CH4 captures every 8th LSI edge, this many times */
+#define POWER_LSI_CAPTURES   (16U)
+#define POWER_LSI_TIMEOUT_MS (10U)
+
+/** Wakeup timer clock divider (WUCKSEL = 000: RTC/16) */
+#define POWER_WUT_DIV        (16U)
+
+#define POWER_RTC_DAY_S      (86400U)
+
+static uint32_t power_lsi_hz = POWER_LSI_NOMINAL_HZ;
+static uint32_t power_rtc_hz = POWER_LSI_NOMINAL_HZ;
+static uint32_t power_subsec_hz = POWER_LSI_NOMINAL_HZ / 2U;
+static uint32_t power_rtcsel = RCC_BDCR_RTCSEL_1;
+static uint32_t power_activity_ms = 0U;
+static uint32_t power_tick_rem_us = 0U;
+static uint32_t power_stop_count = 0U;
+static uint32_t power_stop_ms = 0U;
+static uint8_t power_ready = 0U;
+
+/**
+ * @brief Measures the LSI on TIM5 CH4 (internal TI4 remap), 1 us ticks.
+ */
+static uint32_t Power_MeasureLsi(void) {
+	TIM_TypeDef *tim = htim5.Instance;
+	uint32_t startTick = HAL_GetTick();
+	uint32_t first = 0U;
+	uint32_t last = 0U;
+	uint32_t n = 0U;
+
+	tim->CCER &= ~TIM_CCER_CC4E;
+	tim->OR = (tim->OR & ~TIM_OR_TI4_RMP) | TIM_OR_TI4_RMP_0;
+	tim->CCMR2 = (tim->CCMR2
+			& ~(TIM_CCMR2_CC4S | TIM_CCMR2_IC4PSC | TIM_CCMR2_IC4F))
+			| TIM_CCMR2_CC4S_0 | TIM_CCMR2_IC4PSC;
+	tim->SR = ~TIM_SR_CC4IF;
+	tim->CCER |= TIM_CCER_CC4E;
+
+	while (n <= POWER_LSI_CAPTURES) {
+		if ((tim->SR & TIM_SR_CC4IF) != 0U) {
+			last = tim->CCR4; /* Reading CCR4 clears CC4IF */
+			if (n == 0U) {
+				first = last;
+			}
+			n++;
+		} else if ((HAL_GetTick() - startTick) > POWER_LSI_TIMEOUT_MS) {
+			break;
+		}
+	}
+
+	tim->CCER &= ~TIM_CCER_CC4E;
+	tim->CCMR2 &= ~(TIM_CCMR2_CC4S | TIM_CCMR2_IC4PSC);
+	tim->OR &= ~TIM_OR_TI4_RMP;
+
+	if ((n <= POWER_LSI_CAPTURES) || (last == first)) {
+		return POWER_LSI_NOMINAL_HZ;
+	}
+	return (uint32_t) ((((uint64_t) POWER_LSI_CAPTURES * 8U * 1000000U)
+			+ ((last - first) / 2U)) / (last - first));
+}
+
+/**
+ * @brief Removes RTC write protection.
+ */
+static void Power_RtcUnlock(void) {
+	RTC->WPR = 0xCAU;
+	RTC->WPR = 0x53U;
+}
+
+/**
+ * @brief Restores RTC write protection.
+ */
+static void Power_RtcLock(void) {
+	RTC->WPR = 0xFFU;
+}
+
+/**
+ * @brief Clears the wakeup flag without touching the other ISR flags.
+ */
+static void Power_RtcClearWakeup(void) {
+	RTC->ISR = (~(RTC_ISR_WUTF | RTC_ISR_INIT) & 0x0000FFFFU)
+			| (RTC->ISR & RTC_ISR_INIT);
+	EXTI->PR = EXTI_PR_PR22;
+}
+
+/**
+ * @brief Seconds since 2000-01-01 00:00 and sub-second ticks elapsed in the
+ *        current second, from the live RTC counters. An SSR above PREDIV_S
+ *        (after a SHIFTR delay) belongs to the previous second.
+ */
+static uint32_t Power_RtcRead(uint32_t *ticks) {
+	static const uint16_t month_days[12] = { 0U, 31U, 59U, 90U, 120U, 151U,
+			181U, 212U, 243U, 273U, 304U, 334U };
+	uint32_t ssr;
+	uint32_t tr;
+	uint32_t dr;
+	uint32_t year;
+	uint32_t month;
+	uint32_t days;
+	uint32_t secs;
+
+	/* Shadows are bypassed: an unchanged SSR means no second ended
+	 * between the reads */
+	do {
+		ssr = RTC->SSR;
+		tr = RTC->TR;
+		dr = RTC->DR;
+	} while (ssr != RTC->SSR);
+
+	year = (((dr & RTC_DR_YT) >> RTC_DR_YT_Pos) * 10U)
+			+ ((dr & RTC_DR_YU) >> RTC_DR_YU_Pos);
+	month = (((dr & RTC_DR_MT) >> RTC_DR_MT_Pos) * 10U)
+			+ ((dr & RTC_DR_MU) >> RTC_DR_MU_Pos);
+	if ((month < 1U) || (month > 12U)) {
+		month = 1U;
+	}
+	days = (year * 365U) + ((year + 3U) / 4U) + month_days[month - 1U]
+			+ (((dr & RTC_DR_DT) >> RTC_DR_DT_Pos) * 10U)
+			+ ((dr & RTC_DR_DU) >> RTC_DR_DU_Pos) - 1U;
+	if (((year % 4U) == 0U) && (month > 2U)) {
+		days++; /* 2000-2099: every fourth year is a leap year */
+	}
+
+	secs = ((((tr & RTC_TR_HT) >> RTC_TR_HT_Pos) * 10U)
+			+ ((tr & RTC_TR_HU) >> RTC_TR_HU_Pos)) * 3600U;
+	secs += ((((tr & RTC_TR_MNT) >> RTC_TR_MNT_Pos) * 10U)
+			+ ((tr & RTC_TR_MNU) >> RTC_TR_MNU_Pos)) * 60U;
+	secs += (((tr & RTC_TR_ST) >> RTC_TR_ST_Pos) * 10U)
+			+ ((tr & RTC_TR_SU) >> RTC_TR_SU_Pos);
+	secs += days * POWER_RTC_DAY_S;
+
+	if (ssr >= power_subsec_hz) {
+		*ticks = (power_subsec_hz - 1U) + power_subsec_hz - ssr;
+		return secs - 1U;
+	}
+	*ticks = (power_subsec_hz - 1U) - ssr;
+	return secs;
+}
+
+#if POWER_USE_STOP
+/**
+ * @brief Sub-second ticks since midnight, from the live RTC counters.
+ */
+static uint32_t Power_RtcNow(void) {
+	uint32_t ticks;
+	uint32_t secs;
+
+	secs = Power_RtcRead(&ticks);
+	return ((secs % POWER_RTC_DAY_S) * power_subsec_hz) + ticks;
+}
+
+/**
+ * @brief Programs and starts the wakeup timer.
+ */
+static void Power_ArmWakeup(uint32_t ticks) {
+	Power_RtcUnlock();
+	RTC->CR &= ~(RTC_CR_WUTE | RTC_CR_WUTIE);
+	while ((RTC->ISR & RTC_ISR_WUTWF) == 0U) {
+		/* Up to two RTCCLK periods */
+	}
+	RTC->WUTR = ticks - 1U;
+	Power_RtcClearWakeup();
+	RTC->CR |= RTC_CR_WUTE | RTC_CR_WUTIE;
+	Power_RtcLock();
+}
+
+/**
+ * @brief Stops the wakeup timer.
+ */
+static void Power_DisarmWakeup(void) {
+	Power_RtcUnlock();
+	RTC->CR &= ~(RTC_CR_WUTE | RTC_CR_WUTIE);
+	Power_RtcLock();
+	Power_RtcClearWakeup();
+}
+#endif /* POWER_USE_STOP */
+
+/**
+ * @brief Checks whether the backup domain still holds the RTC setup of
+ *        Power_Init() from before a warm reset.
+ */
+static uint8_t Power_RtcIsConfigured(void) {
+	return (((RCC->BDCR & (RCC_BDCR_RTCSEL | RCC_BDCR_RTCEN))
+			== (power_rtcsel | RCC_BDCR_RTCEN))
+			&& ((RTC->PRER & RTC_PRER_PREDIV_A)
+					== (1U << RTC_PRER_PREDIV_A_Pos))) ? 1U : 0U;
+}
+
+#if POWER_USE_LSE
+/**
+ * @brief Starts the LSE. An RTC already on the LSI means an earlier boot
+ *        found no crystal; that choice holds until the backup domain is
+ *        reset, so warm resets do not wait for it again.
+ */
+static uint8_t Power_StartLse(void) {
+	uint32_t startTick;
+
+	if ((RCC->BDCR & RCC_BDCR_RTCSEL) == RCC_BDCR_RTCSEL_1) {
+		return 0U;
+	}
+	if ((RCC->BDCR & RCC_BDCR_RTCSEL) == RCC_BDCR_RTCSEL) {
+		/* Left on the HSE: switching needs the reset, which stops the LSE */
+		RCC->BDCR |= RCC_BDCR_BDRST;
+		RCC->BDCR &= ~RCC_BDCR_BDRST;
+	}
+	if ((RCC->BDCR & RCC_BDCR_LSERDY) != 0U) {
+		return 1U;
+	}
+
+	RCC->BDCR |= RCC_BDCR_LSEON;
+	startTick = HAL_GetTick();
+	while ((RCC->BDCR & RCC_BDCR_LSERDY) == 0U) {
+		if ((HAL_GetTick() - startTick) > POWER_LSE_TIMEOUT_MS) {
+			RCC->BDCR &= ~RCC_BDCR_LSEON;
+			return 0U;
+		}
+	}
+	return 1U;
+}
+#endif /* POWER_USE_LSE */
+
+/**
+ * @brief Selects power_rtcsel as RTC clock and programs the prescalers from
+ *        power_subsec_hz.
+ */
+static void Power_RtcConfigure(void) {
+	/* The RTC clock source can only be changed by a backup domain reset */
+	if ((RCC->BDCR & RCC_BDCR_RTCSEL) != power_rtcsel) {
+		if ((RCC->BDCR & RCC_BDCR_RTCSEL) != 0U) {
+			RCC->BDCR |= RCC_BDCR_BDRST;
+			RCC->BDCR &= ~RCC_BDCR_BDRST;
+		}
+		RCC->BDCR |= power_rtcsel;
+	}
+	RCC->BDCR |= RCC_BDCR_RTCEN;
+
+	/* Prescalers are rewritten from the fresh calibration; the calendar
+	 * keeps running across warm resets */
+	Power_RtcUnlock();
+	RTC->ISR |= RTC_ISR_INIT;
+	while ((RTC->ISR & RTC_ISR_INITF) == 0U) {
+		/* Up to two RTCCLK periods */
+	}
+	RTC->PRER = power_subsec_hz - 1U;
+	RTC->PRER |= 1U << RTC_PRER_PREDIV_A_Pos;
+	RTC->CR = (RTC->CR & ~(RTC_CR_WUCKSEL | RTC_CR_FMT | RTC_CR_WUTE
+			| RTC_CR_WUTIE)) | RTC_CR_BYPSHAD;
+	RTC->ISR &= ~RTC_ISR_INIT;
+	Power_RtcLock();
+}
+
+/**
+ * @brief Starts the LSI, calibrates it and configures the RTC; a warm
+ *        reset keeps the previous setup under APP_FAST_BOOT, and always on
+ *        the LSE, whose prescalers never change.
+ */
+void Power_Init(void) {
+	uint32_t startTick;
+
+	__HAL_RCC_PWR_CLK_ENABLE();
+	HAL_PWR_EnableBkUpAccess();
+
+	RCC->CSR |= RCC_CSR_LSION;
+	startTick = HAL_GetTick();
+	while ((RCC->CSR & RCC_CSR_LSIRDY) == 0U) {
+		if ((HAL_GetTick() - startTick) > POWER_LSI_TIMEOUT_MS) {
+			return; /* No LSI: Power_Sleep() stays on WFI */
+		}
+	}
+
+#if POWER_USE_LSE
+	if (Power_StartLse() != 0U) {
+		power_rtcsel = RCC_BDCR_RTCSEL_0;
+	}
+#endif /* POWER_USE_LSE */
+
+	if ((Power_RtcIsConfigured() != 0U) && ((APP_FAST_BOOT != 0)
+			|| (power_rtcsel == RCC_BDCR_RTCSEL_0))) {
+		/* Warm reset: reuse the prescalers and leave the calendar running,
+		 * so the wall clock (wallclock.h) keeps its sub-second phase */
+		power_subsec_hz = (RTC->PRER & RTC_PRER_PREDIV_S) + 1U;
+		power_rtc_hz = power_subsec_hz * 2U;
+		power_lsi_hz = (power_rtcsel == RCC_BDCR_RTCSEL_1) ?
+				power_rtc_hz : Power_MeasureLsi();
+		Power_RtcUnlock();
+		RTC->CR = (RTC->CR & ~(RTC_CR_WUCKSEL | RTC_CR_WUTE | RTC_CR_WUTIE))
+				| RTC_CR_BYPSHAD;
+		Power_RtcLock();
+	} else {
+		power_lsi_hz = Power_MeasureLsi();
+		power_rtc_hz = (power_rtcsel == RCC_BDCR_RTCSEL_0) ?
+				POWER_LSE_HZ : power_lsi_hz;
+		power_subsec_hz = power_rtc_hz / 2U;
+		Power_RtcConfigure();
+	}
+	Power_RtcClearWakeup();
+
+	/* RTC wakeup on EXTI line 22, rising edge */
+	EXTI->RTSR |= EXTI_RTSR_TR22;
+	EXTI->IMR |= EXTI_IMR_MR22;
+	HAL_NVIC_SetPriority(RTC_WKUP_IRQn, IRQ_PRIO_WAKEUP, 0);
+	HAL_NVIC_EnableIRQ(RTC_WKUP_IRQn);
+
+	/* PA3 (USART2 RX) start bit on EXTI line 3; unmasked only while stopped */
+	SYSCFG->EXTICR[0] &= ~SYSCFG_EXTICR1_EXTI3;
+	EXTI->FTSR |= EXTI_FTSR_TR3;
+	EXTI->IMR &= ~EXTI_IMR_MR3;
+	EXTI->PR = EXTI_PR_PR3;
+	HAL_NVIC_SetPriority(EXTI3_IRQn, IRQ_PRIO_WAKEUP, 0);
+	HAL_NVIC_EnableIRQ(EXTI3_IRQn);
+
+	HAL_PWREx_EnableFlashPowerDown();
+	power_activity_ms = HAL_GetTick() - POWER_ACTIVITY_HOLDOFF_MS;
+	power_ready = 1U;
+}
+
+#if POWER_USE_STOP
+/**
+ * @brief Enters STOP for about stop_us.
+ * @retval Measured time spent stopped in microseconds.
+ */
+static uint32_t Power_Stop(uint32_t stop_us) {
+	uint32_t ticks;
+	uint32_t before;
+	uint32_t after;
+	uint32_t elapsed;
+	uint32_t slept_us;
+#if !TICKLESS_IS_ACTIVE
+	uint32_t basepri;
+#endif /* !TICKLESS_IS_ACTIVE */
+
+	ticks = (uint32_t) (((uint64_t) stop_us * (power_rtc_hz / POWER_WUT_DIV))
+			/ 1000000U);
+	if (ticks == 0U) {
+		return 0U;
+	}
+	if (ticks > 0x10000U) {
+		ticks = 0x10000U;
+	}
+
+	Power_ArmWakeup(ticks);
+	EXTI->PR = EXTI_PR_PR3;
+	EXTI->IMR |= EXTI_IMR_MR3;
+	before = Power_RtcNow();
+#if DHT11_USE_SYNC
+	DHT11_Sync_StopBegin(); /* A pulse from here on finds the counts frozen */
+#endif /* DHT11_USE_SYNC */
+	STATUS_LED_STOP_BEGIN();
+
+	HAL_SuspendTick();
+	Perf_IdleBegin();
+	HAL_PWR_EnterSTOPMode(PWR_LOWPOWERREGULATOR_ON, PWR_STOPENTRY_WFI);
+	Perf_IdleEnd();
+
+	/* Running from HSI again. The tick resumes first: the RCC drivers time
+	 * out on it. Timers keep their prescalers across the restore. */
+	after = Power_RtcNow();
+	HAL_ResumeTick();
+	if (Clock_ApplyProfile(Clock_GetProfile()) != HAL_OK) {
+		Error_Handler();
+	}
+	EXTI->IMR &= ~EXTI_IMR_MR3;
+	Power_DisarmWakeup();
+
+	elapsed = (after + (POWER_RTC_DAY_S * power_subsec_hz) - before)
+			% (POWER_RTC_DAY_S * power_subsec_hz);
+	slept_us = (uint32_t) (((uint64_t) elapsed * 1000000U) / power_subsec_hz);
+
+	/* Catch the HAL tick up, carrying sub-millisecond remainders. The
+	 * tickless HAL tick follows TIM5 over the stop (SysTime_Advance()) */
+	power_tick_rem_us += slept_us;
+#if !TICKLESS_IS_ACTIVE
+	basepri = Irq_MaskFrom(IRQ_PRIO_TICK); /* Races only HAL_IncTick() */
+	uwTick += power_tick_rem_us / 1000U;
+	Irq_Unmask(basepri);
+#endif /* !TICKLESS_IS_ACTIVE */
+	power_stop_ms += power_tick_rem_us / 1000U;
+	power_tick_rem_us %= 1000U;
+	power_stop_count++;
+
+	/* TIM5 is the timestamp clock: step it over the stop */
+	SysTime_Advance(slept_us);
+#if DHT11_USE_SYNC
+	DHT11_Sync_StopEnd();
+#endif /* DHT11_USE_SYNC */
+	STATUS_LED_STOP_END();
+
+	return slept_us;
+}
+#endif /* POWER_USE_STOP */
+
+/**
+ * @brief Idles for at most budget_us.
+ */
+uint32_t Power_Sleep(uint32_t budget_us) {
+#if POWER_USE_STOP
+	if ((power_ready != 0U) && (budget_us >= POWER_STOP_MIN_US)
+			&& ((HAL_GetTick() - power_activity_ms) >= POWER_ACTIVITY_HOLDOFF_MS)
+			&& (UART_Baud_IsPending() == 0U)
+			&& (Usb_Cdc_IsStarted() == 0U)
+			&& (Can_Bus_IsStarted() == 0U)
+			&& (I2C_Regmap_IsEnabled() == 0U)
+			&& (Modbus_IsActive() == 0U)
+			&& (RS485_GW_IS_ACTIVE() == 0U)
+			&& (DHT11_Emu_IsEnabled() == 0U)
+			&& (STATUS_LED_HOLDS_STOP() == 0U)
+			&& (UART_TX_Flush(0U) != 0U)
+			&& ((huart2.Instance->SR & USART_SR_TC) != 0U)) {
+		if (budget_us > POWER_STOP_MAX_US) {
+			budget_us = POWER_STOP_MAX_US;
+		}
+		return Power_Stop(budget_us - POWER_STOP_LATENCY_US);
+	}
+#else
+	(void) budget_us;
+#endif /* POWER_USE_STOP */
+
+	TICKLESS_ARM_WAKEUP(budget_us); /* Without SysTick, nothing else may */
+	Perf_IdleBegin();
+	__WFI();
+	Perf_IdleEnd();
+	TICKLESS_DISARM_WAKEUP();
+	return 0U;
+}
+
+/**
+ * @brief Low-power replacement for HAL_Delay().
+ */
+void Power_DelayMs(uint32_t ms) {
+#if APP_USE_RTOS
+	HAL_Delay(ms); /* Blocks the calling task only */
+#else
+	uint32_t startTick = HAL_GetTick();
+	uint32_t elapsed;
+
+	while ((elapsed = HAL_GetTick() - startTick) < ms) {
+		(void) Power_Sleep((ms - elapsed) * 1000U);
+	}
+#endif /* APP_USE_RTOS */
+}
+
+/**
+ * @brief Holds off STOP for POWER_ACTIVITY_HOLDOFF_MS.
+ */
+void Power_NotifyActivity(void) {
+	power_activity_ms = HAL_GetTick();
+}
+
+/**
+ * @brief Calibrated LSI frequency in Hz.
+ */
+uint32_t Power_GetLsiHz(void) {
+	return power_lsi_hz;
+}
+
+/**
+ * @brief RTC clock in Hz: POWER_LSE_HZ or the calibrated LSI.
+ */
+uint32_t Power_GetRtcHz(void) {
+	return power_rtc_hz;
+}
+
+/**
+ * @brief Seconds since 2000-01-01 00:00 from the RTC calendar.
+ */
+uint32_t Power_GetRtcSeconds(void) {
+	return Power_GetRtcTime(NULL);
+}
+
+/**
+ * @brief Seconds since 2000-01-01 00:00 and microseconds into the second.
+ */
+uint32_t Power_GetRtcTime(uint32_t *us) {
+	uint32_t tick;
+	uint32_t ticks;
+	uint32_t secs;
+
+	if (power_ready == 0U) {
+		tick = HAL_GetTick();
+		if (us != NULL) {
+			*us = (tick % 1000U) * 1000U;
+		}
+		return tick / 1000U;
+	}
+
+	secs = Power_RtcRead(&ticks);
+	if (us != NULL) {
+		*us = (uint32_t) (((uint64_t) ticks * 1000000U) / power_subsec_hz);
+	}
+	return secs;
+}
+
+/**
+ * @brief Number of STOP periods entered.
+ */
+uint32_t Power_GetStopCount(void) {
+	return power_stop_count;
+}
+
+/**
+ * @brief Total time spent in STOP, in milliseconds.
+ */
+uint32_t Power_GetStopTimeMs(void) {
+	return power_stop_ms;
+}
+
+/**
+ * @brief RTC wakeup handler.
+ */
+void Power_WakeupIRQHandler(void) {
+	Power_RtcClearWakeup();
+}
+
+/**
+ * @brief RX line wake handler.
+ */
+void Power_RxWakeCallback(void) {
+	Power_NotifyActivity();
+}
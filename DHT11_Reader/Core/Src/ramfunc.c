@@ -0,0 +1,65 @@
+/**
+ ******************************************************************************
+ * @file           : ramfunc.c
+ * @brief          : Placement report of the RAMFUNC functions.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "ramfunc.h"
+
+#if RAMFUNC_REPORT
+
+#include "main.h"
+#include "dht11.h"
+#include "timebase.h"
+#include <stdio.h>
+
+/** Bounds of the SRAM code, from the linker script */
+extern uint32_t _sramfunc;
+extern uint32_t _eramfunc;
+
+/**
+ * @brief One reported function.
+ */
+typedef struct {
+	const char *name;
+	void (*fn)(void);
+} ramfunc_entry_t;
+
+#define RAMFUNC_ENTRY(f) { #f, (void (*)(void)) (f) }
+
+/* Every public RAMFUNC; the static level wait of dht11.c is not listed */
+static const ramfunc_entry_t ramfunc_entries[] = {
+	RAMFUNC_ENTRY(delay_us),
+	RAMFUNC_ENTRY(Timebase_DelayUs),
+	RAMFUNC_ENTRY(Timebase_CyclesPerUs),
+	RAMFUNC_ENTRY(Timebase_CyclesPerNsQ16),
+	RAMFUNC_ENTRY(Timebase_DelayOverhead),
+	RAMFUNC_ENTRY(DHT11_CheckResponse),
+	RAMFUNC_ENTRY(DHT11_ReadByte),
+	RAMFUNC_ENTRY(DHT11_ReadPulseWidths)
+};
+
+/**
+ * @brief Prints where each RAMFUNC function ended up.
+ */
+void Ramfunc_Report(void) {
+	uint32_t start = (uint32_t) &_sramfunc;
+	uint32_t end = (uint32_t) &_eramfunc;
+	uint32_t addr;
+	uint32_t i;
+
+	printf("ramfunc %lu bytes at %08lx\r\n", end - start, start);
+	for (i = 0U; i < (sizeof(ramfunc_entries) / sizeof(ramfunc_entries[0]));
+			i++) {
+		addr = (uint32_t) ramfunc_entries[i].fn & ~1UL; /* Thumb bit */
+		printf("ramfunc %s %08lx %s\r\n", ramfunc_entries[i].name, addr,
+				((addr >= start) && (addr < end)) ? "sram" : "flash");
+	}
+}
+
+#endif /* RAMFUNC_REPORT */
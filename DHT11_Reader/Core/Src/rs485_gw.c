@@ -0,0 +1,645 @@
+/**
+ ******************************************************************************
+ * @file           : rs485_gw.c
+ * @brief          : RS-485 gateway, Modbus RTU master on USART3.
+ *
+ *                   The poll sequence belongs to the interrupts from
+ *                   Rs485_Gw_Poll() starting a round until gw_round_done
+ *                   is set; the thread reads the node table only between
+ *                   the two, so the table needs no locking.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "rs485_gw.h"
+
+#if RS485_USE_GATEWAY
+#include "irq_prio.h"
+#include "uart_tx.h"
+#include "clock_config.h"
+#include "dht11_sink.h"
+#include "dht11_health.h"
+#include "telemetry.h"
+#include "modbus.h"
+#include "memmap.h"
+#include "crc.h"
+#include "fmt.h"
+#include <string.h>
+
+#define RS485_GW_USART       (USART3)
+#define RS485_GW_TX_DMA      (DMA1_Stream3)
+#define RS485_GW_RX_DMA      (DMA1_Stream1)
+#define RS485_GW_DMA_CH      (4UL)   /* USART3 on both streams */
+
+#define RS485_GW_Pins        (GPIO_PIN_10 | GPIO_PIN_11)
+#define RS485_GW_GPIO_Port   GPIOC
+#define RS485_GW_DE_Pin      GPIO_PIN_12
+
+/** Timeout and gap timer, 0.1 ms one-pulse */
+#define RS485_GW_TIM         (TIM12)
+#define RS485_GW_TIM_HZ      (10000U)
+
+/** t3.5 between frames: 1.75 ms above 19200 baud, in timer ticks */
+#define RS485_GW_GAP_TICKS   (18U)
+
+/** 8N1: start, eight data bits, stop */
+#define RS485_GW_CHAR_BITS   (10U)
+
+#define RS485_GW_FC_READ_INPUT (0x04U)
+#define RS485_GW_REGS        (RS485_GW_SENSORS * MODBUS_REGS_PER_SENSOR)
+#define RS485_GW_REQ_LEN     (8U)
+#define RS485_GW_REPLY_LEN   (5U + (2U * RS485_GW_REGS))
+#define RS485_GW_EXC_LEN     (5U)
+
+/** Register of each sensor block the records carry */
+#define RS485_GW_REG_STATUS  (0U)
+#define RS485_GW_REG_TEMP    (1U)
+#define RS485_GW_REG_HUM     (2U)
+#define RS485_GW_REG_HEALTH  (5U)
+#define RS485_GW_REG_COUNT   (6U)
+
+#if (RS485_GW_SENSORS == 0U) || (RS485_GW_SENSORS > MODBUS_SENSORS)
+#error "RS485_GW_SENSORS: 1 to MODBUS_SENSORS"
+#endif
+#if (RS485_GW_NODES == 0U) || (RS485_GW_NODES > RS485_GW_NODES_MAX)
+#error "RS485_GW_NODES: 1 to RS485_GW_NODES_MAX"
+#endif
+
+/**
+ * @brief Where the poll sequence stands.
+ */
+typedef enum {
+	RS485_GW_IDLE = 0,    /*!< Between rounds: the thread's          */
+	RS485_GW_GAP,         /*!< t3.5 before gw_index's request        */
+	RS485_GW_SENDING,     /*!< Request on TX DMA, DE high            */
+	RS485_GW_WAITING      /*!< Reply on RX DMA                       */
+} rs485_gw_state_t;
+
+static uint8_t gw_tx[RS485_GW_REQ_LEN] DMA_BUFFER;
+static uint8_t gw_rx[RS485_GW_REPLY_LEN] DMA_BUFFER;
+
+/* Node table: written in the interrupts during a round */
+static rs485_gw_node_t gw_node[RS485_GW_NODES_MAX];
+static uint16_t gw_regs[RS485_GW_NODES_MAX][RS485_GW_REGS];
+static uint8_t gw_polled[RS485_GW_NODES_MAX];
+static uint8_t gw_misses[RS485_GW_NODES_MAX];
+static uint32_t gw_last_round[RS485_GW_NODES_MAX];
+static uint32_t gw_index = 0U;
+static volatile uint8_t gw_state = RS485_GW_IDLE;
+static volatile uint8_t gw_round_done = 0U;
+static rs485_gw_stats_t gw_stats;
+
+/* Thread only */
+static uint16_t gw_last_count[RS485_GW_NODES_MAX][RS485_GW_SENSORS];
+static uint8_t gw_seen[RS485_GW_NODES_MAX];
+static uint8_t gw_batch[TELEMETRY_GATEWAY_LEN(TELEMETRY_GATEWAY_MAX)];
+static uint32_t gw_batch_n = 0U;
+static uint16_t gw_seq = 0U;
+static uint32_t gw_round = 0U;
+static uint32_t gw_round_ms = 0U;
+static uint32_t gw_round_tick = 0U;
+
+static volatile uint32_t gw_nodes = RS485_GW_NODES;
+static volatile uint32_t gw_period_ms = RS485_GW_PERIOD_MS;
+static volatile uint32_t gw_timeout_ms = RS485_GW_TIMEOUT_MS;
+
+/**
+ * @brief USART3 rate from PCLK1, oversampling by 16.
+ */
+static void Rs485_Gw_Rate(void) {
+	RS485_GW_USART->BRR = (HAL_RCC_GetPCLK1Freq() + (RS485_GW_BAUD / 2U))
+			/ RS485_GW_BAUD;
+	RS485_GW_TIM->PSC = (Clock_GetApb1TimerHz() / RS485_GW_TIM_HZ) - 1U;
+}
+
+/**
+ * @brief Starts TIM12 for ticks; UG loads a changed prescaler first.
+ */
+static void Rs485_Gw_Arm(uint32_t ticks) {
+	RS485_GW_TIM->CR1 &= ~TIM_CR1_CEN;
+	RS485_GW_TIM->EGR = TIM_EGR_UG;          /* URS: no update interrupt */
+	RS485_GW_TIM->ARR = (ticks != 0U) ? ticks : 1U;
+	RS485_GW_TIM->SR = 0U;
+	RS485_GW_TIM->CR1 |= TIM_CR1_CEN;
+}
+
+/**
+ * @brief Stops a DMA stream and clears its flags.
+ */
+static void Rs485_Gw_StopDma(DMA_Stream_TypeDef *stream, uint32_t flags) {
+	stream->CR &= ~DMA_SxCR_EN;
+	while ((stream->CR & DMA_SxCR_EN) != 0U) {
+		/* The stream finishes its current transfer */
+	}
+	DMA1->LIFCR = flags;
+}
+
+#define RS485_GW_TX_FLAGS (DMA_LIFCR_CTCIF3 | DMA_LIFCR_CHTIF3 \
+		| DMA_LIFCR_CTEIF3 | DMA_LIFCR_CDMEIF3 | DMA_LIFCR_CFEIF3)
+#define RS485_GW_RX_FLAGS (DMA_LIFCR_CTCIF1 | DMA_LIFCR_CHTIF1 \
+		| DMA_LIFCR_CTEIF1 | DMA_LIFCR_CDMEIF1 | DMA_LIFCR_CFEIF1)
+
+/**
+ * @brief Reports whether a down node sits this round out.
+ */
+static uint8_t Rs485_Gw_Skip(uint32_t i) {
+	return ((gw_node[i].down != 0U)
+			&& ((gw_round - gw_last_round[i]) < RS485_GW_DOWN_RETRY)) ? 1U : 0U;
+}
+
+/**
+ * @brief Waits t3.5 before the next node due, or ends the round.
+ */
+static void Rs485_Gw_Next(void) {
+	while ((gw_index < gw_nodes) && (Rs485_Gw_Skip(gw_index) != 0U)) {
+		gw_index++;
+	}
+	if (gw_index >= gw_nodes) {
+		gw_state = RS485_GW_IDLE;
+		gw_round_done = 1U;
+		return;
+	}
+	gw_state = RS485_GW_GAP;
+	Rs485_Gw_Arm(RS485_GW_GAP_TICKS);
+}
+
+/**
+ * @brief Sends the read request to node gw_index. The timeout covers the
+ *        request's own time on the line.
+ */
+static void Rs485_Gw_Send(void) {
+	rs485_gw_node_t *node = &gw_node[gw_index];
+	uint16_t crc;
+
+	gw_tx[0] = node->address;
+	gw_tx[1] = RS485_GW_FC_READ_INPUT;
+	gw_tx[2] = 0U;
+	gw_tx[3] = 0U;
+	gw_tx[4] = 0U;
+	gw_tx[5] = (uint8_t) RS485_GW_REGS;
+	crc = Crc_Modbus16(gw_tx, 6U);
+	gw_tx[6] = (uint8_t) crc;
+	gw_tx[7] = (uint8_t) (crc >> 8);
+
+	node->polls++;
+	gw_stats.polls++;
+	gw_polled[gw_index] = 1U;
+	gw_last_round[gw_index] = gw_round;
+
+	HAL_GPIO_WritePin(RS485_GW_GPIO_Port, RS485_GW_DE_Pin, GPIO_PIN_SET);
+	Rs485_Gw_StopDma(RS485_GW_TX_DMA, RS485_GW_TX_FLAGS);
+	RS485_GW_TX_DMA->NDTR = RS485_GW_REQ_LEN;
+	RS485_GW_USART->SR = ~USART_SR_TC;
+	gw_state = RS485_GW_SENDING;
+	RS485_GW_TX_DMA->CR |= DMA_SxCR_EN;
+	RS485_GW_USART->CR1 |= USART_CR1_TCIE;
+	Rs485_Gw_Arm((gw_timeout_ms * (RS485_GW_TIM_HZ / 1000U))
+			+ ((RS485_GW_REQ_LEN * RS485_GW_CHAR_BITS * RS485_GW_TIM_HZ)
+					/ RS485_GW_BAUD) + 1U);
+}
+
+/**
+ * @brief Records how node gw_index's poll ended and moves on.
+ */
+static void Rs485_Gw_End(rs485_gw_link_t link) {
+	rs485_gw_node_t *node = &gw_node[gw_index];
+
+	node->link = (uint8_t) link;
+	if ((link == RS485_GW_LINK_TIMEOUT) || (link == RS485_GW_LINK_CRC)) {
+		if (gw_misses[gw_index] < RS485_GW_DOWN_AFTER) {
+			gw_misses[gw_index]++;
+		}
+		if (gw_misses[gw_index] >= RS485_GW_DOWN_AFTER) {
+			node->down = 1U;
+		}
+	} else {
+		/* An exception still proves the node is there */
+		gw_misses[gw_index] = 0U;
+		node->down = 0U;
+	}
+	gw_index++;
+	Rs485_Gw_Next();
+}
+
+/**
+ * @brief Checks a complete reply and stores its registers.
+ */
+static void Rs485_Gw_Reply(void) {
+	rs485_gw_node_t *node = &gw_node[gw_index];
+	uint32_t len = ((gw_rx[1] & 0x80U) != 0U) ? RS485_GW_EXC_LEN
+			: RS485_GW_REPLY_LEN;
+	uint16_t crc = Crc_Modbus16(gw_rx, len - 2U);
+	uint32_t i;
+
+	RS485_GW_TIM->CR1 &= ~TIM_CR1_CEN;
+	Rs485_Gw_StopDma(RS485_GW_RX_DMA, RS485_GW_RX_FLAGS);
+	if ((gw_rx[len - 2U] != (uint8_t) crc)
+			|| (gw_rx[len - 1U] != (uint8_t) (crc >> 8))
+			|| (gw_rx[0] != node->address)
+			|| ((gw_rx[1] & 0x7FU) != RS485_GW_FC_READ_INPUT)
+			|| ((len == RS485_GW_REPLY_LEN)
+					&& (gw_rx[2] != (2U * RS485_GW_REGS)))) {
+		node->errors++;
+		gw_stats.crc_errors++;
+		Rs485_Gw_End(RS485_GW_LINK_CRC);
+		return;
+	}
+	if (len == RS485_GW_EXC_LEN) {
+		node->errors++;
+		gw_stats.exceptions++;
+		Rs485_Gw_End(RS485_GW_LINK_EXCEPTION);
+		return;
+	}
+	for (i = 0U; i < RS485_GW_REGS; i++) {
+		gw_regs[gw_index][i] = (uint16_t) (((uint16_t) gw_rx[3U + (2U * i)] << 8)
+				| gw_rx[4U + (2U * i)]);
+	}
+	Rs485_Gw_End(RS485_GW_LINK_OK);
+}
+
+/**
+ * @brief Claims USART3, PC10-PC12, DMA1 Streams 1 and 3 and TIM12.
+ */
+void Rs485_Gw_Init(void) {
+	GPIO_InitTypeDef GPIO_InitStruct = { 0 };
+	uint32_t i;
+
+	(void) memset(&gw_stats, 0, sizeof(gw_stats));
+	(void) memset(gw_node, 0, sizeof(gw_node));
+	for (i = 0U; i < RS485_GW_NODES_MAX; i++) {
+		gw_node[i].address = (uint8_t) (RS485_GW_FIRST_ADDRESS + i);
+		gw_node[i].link = (uint8_t) RS485_GW_LINK_NONE;
+	}
+
+	__HAL_RCC_GPIOC_CLK_ENABLE();
+	__HAL_RCC_USART3_CLK_ENABLE();
+	__HAL_RCC_DMA1_CLK_ENABLE();
+	__HAL_RCC_TIM12_CLK_ENABLE();
+
+	HAL_GPIO_WritePin(RS485_GW_GPIO_Port, RS485_GW_DE_Pin, GPIO_PIN_RESET);
+	GPIO_InitStruct.Pin = RS485_GW_DE_Pin;
+	GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
+	GPIO_InitStruct.Pull = GPIO_NOPULL;
+	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+	HAL_GPIO_Init(RS485_GW_GPIO_Port, &GPIO_InitStruct);
+	GPIO_InitStruct.Pin = RS485_GW_Pins;
+	GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+	GPIO_InitStruct.Pull = GPIO_PULLUP;      /* RX idles high off the bus */
+	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+	GPIO_InitStruct.Alternate = GPIO_AF7_USART3;
+	HAL_GPIO_Init(RS485_GW_GPIO_Port, &GPIO_InitStruct);
+
+	RS485_GW_USART->CR1 = 0U;
+	RS485_GW_USART->CR2 = 0U;
+	RS485_GW_USART->CR3 = USART_CR3_DMAT | USART_CR3_DMAR;
+	RS485_GW_TIM->CR1 = TIM_CR1_OPM | TIM_CR1_URS;
+	Rs485_Gw_Rate();
+	RS485_GW_TIM->DIER = TIM_DIER_UIE;
+
+	/* Memory to USART3 and back, bytes, no DMA interrupts: the USART's
+	 * TC and IDLE drive the sequence */
+	Rs485_Gw_StopDma(RS485_GW_TX_DMA, RS485_GW_TX_FLAGS);
+	RS485_GW_TX_DMA->PAR = (uint32_t) &RS485_GW_USART->DR;
+	RS485_GW_TX_DMA->M0AR = (uint32_t) gw_tx;
+	RS485_GW_TX_DMA->FCR = 0U;
+	RS485_GW_TX_DMA->CR = (RS485_GW_DMA_CH << DMA_SxCR_CHSEL_Pos)
+			| DMA_SxCR_MINC | DMA_SxCR_DIR_0 | DMA_SxCR_PL_0;
+	Rs485_Gw_StopDma(RS485_GW_RX_DMA, RS485_GW_RX_FLAGS);
+	RS485_GW_RX_DMA->PAR = (uint32_t) &RS485_GW_USART->DR;
+	RS485_GW_RX_DMA->M0AR = (uint32_t) gw_rx;
+	RS485_GW_RX_DMA->FCR = 0U;
+	RS485_GW_RX_DMA->CR = (RS485_GW_DMA_CH << DMA_SxCR_CHSEL_Pos)
+			| DMA_SxCR_MINC | DMA_SxCR_PL_0;
+
+	RS485_GW_USART->CR1 = USART_CR1_UE | USART_CR1_TE | USART_CR1_RE
+			| USART_CR1_IDLEIE;
+
+	HAL_NVIC_SetPriority(USART3_IRQn, IRQ_PRIO_UART, 0U);
+	HAL_NVIC_EnableIRQ(USART3_IRQn);
+	HAL_NVIC_SetPriority(TIM8_BRK_TIM12_IRQn, IRQ_PRIO_UART, 0U);
+	HAL_NVIC_EnableIRQ(TIM8_BRK_TIM12_IRQn);
+
+	/* First round on the first poll */
+	gw_round_ms = HAL_GetTick() - gw_period_ms;
+}
+
+/**
+ * @brief Sends the pending gateway packet, if any.
+ */
+static void Rs485_Gw_Flush(void) {
+	uint8_t frame[TELEMETRY_COBS_MAX(TELEMETRY_GATEWAY_LEN(TELEMETRY_GATEWAY_MAX))];
+	uint32_t len;
+	uint16_t crc;
+
+	if (gw_batch_n == 0U) {
+		return;
+	}
+	len = TELEMETRY_GATEWAY_LEN(gw_batch_n);
+	gw_batch[0] = TELEMETRY_TYPE_GATEWAY;
+	gw_batch[1] = (uint8_t) gw_batch_n;
+	gw_batch[2] = (uint8_t) gw_seq;
+	gw_batch[3] = (uint8_t) (gw_seq >> 8);
+	gw_batch[4] = (uint8_t) gw_round_tick;
+	gw_batch[5] = (uint8_t) (gw_round_tick >> 8);
+	gw_batch[6] = (uint8_t) (gw_round_tick >> 16);
+	gw_batch[7] = (uint8_t) (gw_round_tick >> 24);
+	crc = Crc_Ccitt16(gw_batch, len - 2U);
+	gw_batch[len - 2U] = (uint8_t) crc;
+	gw_batch[len - 1U] = (uint8_t) (crc >> 8);
+
+	/* One ring write: the TX DMA sends the packet in one transfer */
+	len = Telemetry_CobsEncode(gw_batch, len, frame);
+	(void) UART_TX_Write(frame, len);
+	gw_seq++;
+	gw_batch_n = 0U;
+}
+
+/**
+ * @brief Sends one record in the sink's format.
+ */
+static void Rs485_Gw_Record(uint8_t node, uint8_t sensor, const uint16_t *regs,
+		rs485_gw_link_t link) {
+	dht11_format_t format = DHT11_Sink_GetFormat();
+	uint8_t *p;
+	fmt_t line;
+
+	if (format == DHT11_FORMAT_NONE) {
+		return;
+	}
+	gw_stats.records++;
+	if (format == DHT11_FORMAT_TEXT) {
+		Fmt_Begin(&line);
+		Fmt_Str(&line, "Node ");
+		Fmt_Uint(&line, node, 0U, ' ');
+		if (regs == NULL) {
+			Fmt_Str(&line, ": ");
+			Fmt_Str(&line, Rs485_Gw_LinkName(link));
+		} else {
+			Fmt_Str(&line, " sensor ");
+			Fmt_Uint(&line, sensor, 0U, ' ');
+			if (regs[RS485_GW_REG_STATUS] == (uint16_t) DHT11_OK) {
+				Fmt_Str(&line, ": Humidity: ");
+				Fmt_Fixed(&line, (int16_t) regs[RS485_GW_REG_HUM], 1U);
+				Fmt_Str(&line, " % RH \t Temperature: ");
+				Fmt_Fixed(&line, (int16_t) regs[RS485_GW_REG_TEMP], 1U);
+				Fmt_Str(&line, " deg C");
+			} else {
+				Fmt_Str(&line, ": DHT11 ");
+				Fmt_Str(&line, DHT11_StatusName(
+						(dht11_status_t) regs[RS485_GW_REG_STATUS]));
+				Fmt_Str(&line, " error");
+			}
+			Fmt_Str(&line, " \t Health: ");
+			Fmt_Str(&line, DHT11_Health_Name(
+					(dht11_health_t) regs[RS485_GW_REG_HEALTH]));
+		}
+		Fmt_Str(&line, "\r\n");
+		(void) Fmt_End(&line);
+		return;
+	}
+
+	p = &gw_batch[TELEMETRY_GATEWAY_HEADER
+			+ (gw_batch_n * TELEMETRY_GATEWAY_RECORD)];
+	(void) memset(p, 0, TELEMETRY_GATEWAY_RECORD);
+	p[0] = node;
+	if (regs == NULL) {
+		p[1] = TELEMETRY_GATEWAY_LINK;
+		p[2] = (uint8_t) link;
+	} else {
+		p[1] = sensor;
+		p[2] = (uint8_t) regs[RS485_GW_REG_STATUS];
+		p[3] = (uint8_t) regs[RS485_GW_REG_HEALTH];
+		p[4] = (uint8_t) regs[RS485_GW_REG_COUNT];
+		p[5] = (uint8_t) (regs[RS485_GW_REG_COUNT] >> 8);
+		p[6] = (uint8_t) regs[RS485_GW_REG_TEMP];
+		p[7] = (uint8_t) (regs[RS485_GW_REG_TEMP] >> 8);
+		p[8] = (uint8_t) regs[RS485_GW_REG_HUM];
+		p[9] = (uint8_t) (regs[RS485_GW_REG_HUM] >> 8);
+	}
+	gw_batch_n++;
+	if (gw_batch_n >= TELEMETRY_GATEWAY_MAX) {
+		Rs485_Gw_Flush();
+	}
+}
+
+/**
+ * @brief Sends what the finished round learned: new readings, bad links.
+ */
+static void Rs485_Gw_Forward(void) {
+	const uint16_t *regs;
+	uint32_t nodes = gw_nodes;
+	uint32_t i;
+	uint32_t s;
+	uint8_t fresh;
+
+	for (i = 0U; i < nodes; i++) {
+		if (gw_polled[i] == 0U) {
+			continue;
+		}
+		if (gw_node[i].link != (uint8_t) RS485_GW_LINK_OK) {
+			Rs485_Gw_Record(gw_node[i].address, 0U, NULL,
+					(rs485_gw_link_t) gw_node[i].link);
+			continue;
+		}
+		for (s = 0U; s < RS485_GW_SENSORS; s++) {
+			regs = &gw_regs[i][s * MODBUS_REGS_PER_SENSOR];
+			/* On first contact, a sensor never read has nothing to say */
+			fresh = (gw_seen[i] != 0U) ?
+					(regs[RS485_GW_REG_COUNT] != gw_last_count[i][s]) :
+					(regs[RS485_GW_REG_COUNT] != 0U);
+			gw_last_count[i][s] = regs[RS485_GW_REG_COUNT];
+			if (fresh != 0U) {
+				Rs485_Gw_Record(gw_node[i].address, (uint8_t) s, regs,
+						RS485_GW_LINK_OK);
+			}
+		}
+		gw_seen[i] = 1U;
+	}
+	Rs485_Gw_Flush();
+}
+
+/**
+ * @brief Forwards a finished round and starts the next one when due.
+ */
+void Rs485_Gw_Poll(void) {
+	uint32_t now = HAL_GetTick();
+	uint32_t basepri;
+
+	if (gw_round_done != 0U) {
+		Rs485_Gw_Forward();
+		gw_round_done = 0U;
+	}
+	/* A round that ended since the check above is forwarded next time */
+	if ((gw_round_done != 0U) || (gw_state != RS485_GW_IDLE)
+			|| ((now - gw_round_ms) < gw_period_ms)) {
+		return;
+	}
+	/* On the period grid unless a whole period was lost */
+	if ((now - gw_round_ms) >= (2U * gw_period_ms)) {
+		gw_stats.overruns++;
+		gw_round_ms = now;
+	} else {
+		gw_round_ms += gw_period_ms;
+	}
+	gw_round_tick = now;
+	gw_round++;
+	gw_stats.rounds++;
+	(void) memset(gw_polled, 0, sizeof(gw_polled));
+	gw_index = 0U;
+	basepri = Irq_MaskFrom(IRQ_PRIO_UART);
+	Rs485_Gw_Next();
+	Irq_Unmask(basepri);
+}
+
+/**
+ * @brief Sets the nodes polled.
+ */
+uint8_t Rs485_Gw_SetNodes(uint32_t nodes) {
+	if ((nodes == 0U) || (nodes > RS485_GW_NODES_MAX)) {
+		return 0U;
+	}
+	gw_nodes = nodes;
+	return 1U;
+}
+
+/**
+ * @brief Sets the round period, 100 ms to 1 h.
+ */
+uint8_t Rs485_Gw_SetPeriod(uint32_t period_ms) {
+	if ((period_ms < 100U) || (period_ms > 3600000U)) {
+		return 0U;
+	}
+	gw_period_ms = period_ms;
+	return 1U;
+}
+
+/**
+ * @brief Sets the per-node timeout.
+ */
+uint8_t Rs485_Gw_SetTimeout(uint32_t timeout_ms) {
+	if ((timeout_ms == 0U) || (timeout_ms > 1000U)) {
+		return 0U;
+	}
+	gw_timeout_ms = timeout_ms;
+	return 1U;
+}
+
+uint32_t Rs485_Gw_GetNodes(void) {
+	return gw_nodes;
+}
+
+uint32_t Rs485_Gw_GetPeriod(void) {
+	return gw_period_ms;
+}
+
+uint32_t Rs485_Gw_GetTimeout(void) {
+	return gw_timeout_ms;
+}
+
+/**
+ * @brief Copies the counters of one node.
+ */
+void Rs485_Gw_GetNode(uint32_t index, rs485_gw_node_t *node) {
+	uint32_t basepri;
+
+	if (index >= RS485_GW_NODES_MAX) {
+		(void) memset(node, 0, sizeof(*node));
+		return;
+	}
+	basepri = Irq_MaskFrom(IRQ_PRIO_UART);
+	*node = gw_node[index];
+	Irq_Unmask(basepri);
+}
+
+/**
+ * @brief Short printable name of a link state.
+ */
+const char* Rs485_Gw_LinkName(rs485_gw_link_t link) {
+	static const char *const names[] = { "ok", "timeout", "crc", "exception",
+			"none" };
+
+	if ((uint32_t) link >= (sizeof(names) / sizeof(names[0]))) {
+		return "?";
+	}
+	return names[link];
+}
+
+/**
+ * @brief Copies the gateway counters.
+ */
+void Rs485_Gw_GetStats(rs485_gw_stats_t *stats) {
+	uint32_t basepri = Irq_MaskFrom(IRQ_PRIO_UART);
+
+	*stats = gw_stats;
+	Irq_Unmask(basepri);
+}
+
+/**
+ * @brief Recomputes the rate and the prescaler; a poll on the line keeps
+ *        the old timer rate until it ends.
+ */
+void Rs485_Gw_ClockChanged(void) {
+	Rs485_Gw_Rate();
+}
+
+/**
+ * @brief USART3: the request left (DE released, reply armed), or the line
+ *        went idle after a reply.
+ */
+void Rs485_Gw_UartIRQHandler(void) {
+	uint32_t sr = RS485_GW_USART->SR;
+	uint32_t got;
+
+	if (((RS485_GW_USART->CR1 & USART_CR1_TCIE) != 0U)
+			&& ((sr & USART_SR_TC) != 0U)) {
+		RS485_GW_USART->CR1 &= ~USART_CR1_TCIE;
+		HAL_GPIO_WritePin(RS485_GW_GPIO_Port, RS485_GW_DE_Pin, GPIO_PIN_RESET);
+		/* Any echo of the request is not the reply */
+		(void) RS485_GW_USART->DR;
+		Rs485_Gw_StopDma(RS485_GW_RX_DMA, RS485_GW_RX_FLAGS);
+		RS485_GW_RX_DMA->NDTR = RS485_GW_REPLY_LEN;
+		RS485_GW_RX_DMA->CR |= DMA_SxCR_EN;
+		gw_state = RS485_GW_WAITING;
+	}
+	if ((sr & (USART_SR_IDLE | USART_SR_ORE | USART_SR_FE | USART_SR_NE)) != 0U) {
+		(void) RS485_GW_USART->DR;            /* SR then DR clears them */
+		if ((gw_state != RS485_GW_WAITING) || ((sr & USART_SR_IDLE) == 0U)) {
+			return;
+		}
+		got = RS485_GW_REPLY_LEN - RS485_GW_RX_DMA->NDTR;
+		/* A gap inside the reply waits for the rest or the timeout */
+		if ((got >= RS485_GW_REPLY_LEN)
+				|| ((got >= RS485_GW_EXC_LEN) && ((gw_rx[1] & 0x80U) != 0U))) {
+			Rs485_Gw_Reply();
+		}
+	}
+}
+
+/**
+ * @brief TIM12: the turnaround gap is over, or the node did not answer
+ *        in time.
+ */
+void Rs485_Gw_TimerIRQHandler(void) {
+	RS485_GW_TIM->SR = 0U;
+	switch (gw_state) {
+	case RS485_GW_GAP:
+		Rs485_Gw_Send();
+		break;
+	case RS485_GW_SENDING:
+	case RS485_GW_WAITING:
+		RS485_GW_USART->CR1 &= ~USART_CR1_TCIE;
+		HAL_GPIO_WritePin(RS485_GW_GPIO_Port, RS485_GW_DE_Pin, GPIO_PIN_RESET);
+		Rs485_Gw_StopDma(RS485_GW_TX_DMA, RS485_GW_TX_FLAGS);
+		Rs485_Gw_StopDma(RS485_GW_RX_DMA, RS485_GW_RX_FLAGS);
+		gw_node[gw_index].timeouts++;
+		gw_stats.timeouts++;
+		Rs485_Gw_End(RS485_GW_LINK_TIMEOUT);
+		break;
+	default:
+		break;
+	}
+}
+#endif /* RS485_USE_GATEWAY */
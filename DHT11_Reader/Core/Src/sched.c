@@ -0,0 +1,370 @@
+/**
+ ******************************************************************************
+ * @file           : sched.c
+ * @brief          : Cooperative run-to-completion scheduler.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "sched.h"
+#include "power.h"
+#include "timebase.h"
+#include "perf.h"
+#include "dvfs.h"
+#include "tickless.h"
+#include "systime.h"
+#include <stdio.h>
+
+/**
+ * @brief One task slot.
+ */
+typedef struct {
+	const char *name;
+	sched_timer_fn_t timer;  /*!< NULL for a poll task           */
+	sched_poll_fn_t poll;
+	uint32_t due_ms;         /*!< Deadline while queued          */
+	uint32_t runs;
+	uint32_t max_run_us;
+	uint32_t max_late_ms;    /*!< Start after the deadline       */
+	uint64_t cycles;         /*!< Since Perf_Reset(), no ISRs    */
+	uint8_t queued;          /*!< 1 while in the deadline heap   */
+} sched_task_t;
+
+static sched_task_t sched_tasks[SCHED_MAX_TASKS];
+static uint32_t sched_task_count = 0U;
+
+/* Min-heap of timer task ids, earliest deadline first */
+static uint8_t sched_heap[SCHED_MAX_TASKS];
+static uint32_t sched_heap_len = 0U;
+
+static uint32_t (*sched_idle_budget)(void) = NULL;
+static void (*sched_idle_advance)(uint32_t us) = NULL;
+
+static volatile uint8_t sched_sleeping = 0U;
+static volatile uint32_t sched_ticks = 0U;
+static volatile uint32_t sched_idle_ticks = 0U;
+#if TICKLESS_IS_ACTIVE
+static uint64_t sched_idle_us = 0U;         /* WFI time, no tick to sample it */
+#endif /* TICKLESS_IS_ACTIVE */
+
+/**
+ * @brief Wrap-safe deadline order of two queued tasks.
+ */
+static uint8_t Sched_Before(uint8_t a, uint8_t b) {
+	return ((int32_t) (sched_tasks[a].due_ms - sched_tasks[b].due_ms) < 0) ?
+			1U : 0U;
+}
+
+static void Sched_Swap(uint32_t i, uint32_t j) {
+	uint8_t tmp = sched_heap[i];
+
+	sched_heap[i] = sched_heap[j];
+	sched_heap[j] = tmp;
+}
+
+static void Sched_SiftUp(uint32_t i) {
+	while ((i > 0U)
+			&& (Sched_Before(sched_heap[i], sched_heap[(i - 1U) / 2U]) != 0U)) {
+		Sched_Swap(i, (i - 1U) / 2U);
+		i = (i - 1U) / 2U;
+	}
+}
+
+static void Sched_SiftDown(uint32_t i) {
+	uint32_t child;
+
+	for (;;) {
+		child = (2U * i) + 1U;
+		if (child >= sched_heap_len) {
+			break;
+		}
+		if (((child + 1U) < sched_heap_len)
+				&& (Sched_Before(sched_heap[child + 1U], sched_heap[child]) != 0U)) {
+			child++;
+		}
+		if (Sched_Before(sched_heap[child], sched_heap[i]) == 0U) {
+			break;
+		}
+		Sched_Swap(i, child);
+		i = child;
+	}
+}
+
+/**
+ * @brief Queues a timer task at its due_ms.
+ */
+static void Sched_Push(uint8_t id) {
+	sched_heap[sched_heap_len] = id;
+	sched_tasks[id].queued = 1U;
+	sched_heap_len++;
+	Sched_SiftUp(sched_heap_len - 1U);
+}
+
+/**
+ * @brief Removes the heap entry at index i.
+ */
+static void Sched_RemoveAt(uint32_t i) {
+	sched_tasks[sched_heap[i]].queued = 0U;
+	sched_heap_len--;
+	if (i != sched_heap_len) {
+		sched_heap[i] = sched_heap[sched_heap_len];
+		Sched_SiftUp(i);
+		Sched_SiftDown(i);
+	}
+}
+
+/**
+ * @brief Claims a task slot.
+ */
+static uint8_t Sched_Add(const char *name, sched_timer_fn_t timer,
+		sched_poll_fn_t poll) {
+	sched_task_t *task;
+
+	if (sched_task_count >= SCHED_MAX_TASKS) {
+		return SCHED_NO_TASK;
+	}
+	task = &sched_tasks[sched_task_count];
+	task->name = name;
+	task->timer = timer;
+	task->poll = poll;
+	return (uint8_t) sched_task_count++;
+}
+
+/**
+ * @brief Adds a timer task.
+ */
+uint8_t Sched_AddTimer(const char *name, sched_timer_fn_t fn, uint32_t delay_ms) {
+	uint8_t id = Sched_Add(name, fn, NULL);
+
+	if (id != SCHED_NO_TASK) {
+		Sched_Wake(id, delay_ms);
+	}
+	return id;
+}
+
+/**
+ * @brief Adds a poll task.
+ */
+uint8_t Sched_AddPoll(const char *name, sched_poll_fn_t fn) {
+	return Sched_Add(name, NULL, fn);
+}
+
+/**
+ * @brief (Re)schedules a timer task.
+ */
+void Sched_Wake(uint8_t id, uint32_t delay_ms) {
+	uint32_t i;
+
+	if ((id >= sched_task_count) || (sched_tasks[id].timer == NULL)) {
+		return;
+	}
+	if (sched_tasks[id].queued != 0U) {
+		for (i = 0U; sched_heap[i] != id; i++) {
+			/* At most SCHED_MAX_TASKS entries */
+		}
+		Sched_RemoveAt(i);
+	}
+	sched_tasks[id].due_ms = HAL_GetTick() + delay_ms;
+	Sched_Push(id);
+}
+
+/**
+ * @brief Installs the idle hook.
+ */
+void Sched_SetIdle(uint32_t (*budget_us)(void), void (*advance)(uint32_t us)) {
+	sched_idle_budget = budget_us;
+	sched_idle_advance = advance;
+}
+
+/**
+ * @brief Runs one task and records its timing.
+ * @retval The task's return value.
+ */
+static uint32_t Sched_Exec(sched_task_t *task) {
+	uint32_t start_us = Timebase_Micros();
+	uint64_t start_isr = Perf_IsrCycles();
+	uint32_t start_cycles = DWT->CYCCNT;
+	uint32_t ret;
+	uint32_t run_us;
+	uint32_t cycles;
+	uint64_t isr;
+
+	ret = (task->timer != NULL) ? task->timer() : task->poll();
+	cycles = DWT->CYCCNT - start_cycles;
+	isr = Perf_IsrCycles() - start_isr;
+	run_us = Timebase_Micros() - start_us;
+	if (run_us > task->max_run_us) {
+		task->max_run_us = run_us;
+	}
+	if (cycles > isr) {
+		task->cycles += cycles - isr;
+	}
+	task->runs++;
+	return ret;
+}
+
+/**
+ * @brief Runs every timer task whose deadline has passed.
+ */
+static void Sched_RunTimers(void) {
+	sched_task_t *task;
+	uint32_t now;
+	uint32_t next;
+	uint8_t id;
+
+	while (sched_heap_len != 0U) {
+		id = sched_heap[0];
+		task = &sched_tasks[id];
+		now = HAL_GetTick();
+		if ((int32_t) (now - task->due_ms) < 0) {
+			break;
+		}
+		if ((now - task->due_ms) > task->max_late_ms) {
+			task->max_late_ms = now - task->due_ms;
+		}
+		Sched_RemoveAt(0U);
+#if DVFS_USE_SCALING
+		Dvfs_Burst(); /* Due work runs at the burst profile */
+#endif /* DVFS_USE_SCALING */
+		next = Sched_Exec(task);
+		if ((next != SCHED_STOP) && (task->queued == 0U)) {
+			task->due_ms = HAL_GetTick() + next;
+			Sched_Push(id);
+		}
+	}
+}
+
+/**
+ * @brief Sleeps until the next deadline or interrupt.
+ */
+static void Sched_Idle(void) {
+	uint32_t budget_us = 0xFFFFFFFFU;
+	uint32_t wait_ms;
+	uint32_t slept_us;
+	uint32_t hook_us;
+#if TICKLESS_IS_ACTIVE
+	uint32_t start_us;
+#endif /* TICKLESS_IS_ACTIVE */
+
+	if (sched_heap_len != 0U) {
+		wait_ms = sched_tasks[sched_heap[0]].due_ms - HAL_GetTick();
+		if ((int32_t) wait_ms <= 0) {
+			return;
+		}
+		budget_us = (wait_ms < (0xFFFFFFFFU / 1000U)) ?
+				(wait_ms * 1000U) : 0xFFFFFFFFU;
+	}
+	if (sched_idle_budget != NULL) {
+		hook_us = sched_idle_budget();
+		if (hook_us < budget_us) {
+			budget_us = hook_us;
+		}
+	}
+#if DVFS_USE_SCALING
+	budget_us = Dvfs_Idle(budget_us);
+#endif /* DVFS_USE_SCALING */
+	if (budget_us == 0U) {
+		return;
+	}
+
+#if TICKLESS_IS_ACTIVE
+	start_us = SysTime_Now();
+#endif /* TICKLESS_IS_ACTIVE */
+	sched_sleeping = 1U;
+	slept_us = Power_Sleep(budget_us);
+	sched_sleeping = 0U;
+#if TICKLESS_IS_ACTIVE
+	/* TIM5 was stepped over any STOP, which power.c counts itself */
+	sched_idle_us += SysTime_Since(start_us) - slept_us;
+#endif /* TICKLESS_IS_ACTIVE */
+
+	if (sched_idle_advance != NULL) {
+		sched_idle_advance(slept_us);
+	}
+}
+
+/**
+ * @brief Runs the tasks forever.
+ */
+void Sched_Run(void) {
+	uint32_t busy;
+	uint32_t i;
+
+	for (;;) {
+		Sched_RunTimers();
+
+		busy = 0U;
+		for (i = 0U; i < sched_task_count; i++) {
+			if (sched_tasks[i].poll != NULL) {
+				busy |= Sched_Exec(&sched_tasks[i]);
+			}
+		}
+		if (busy == 0U) {
+			Sched_Idle();
+		}
+	}
+}
+
+/**
+ * @brief Idle accounting; called from SysTick_Handler().
+ */
+void Sched_TickHandler(void) {
+	sched_ticks++;
+	if (sched_sleeping != 0U) {
+		sched_idle_ticks++;
+	}
+}
+
+/**
+ * @brief Share of time spent sleeping since boot.
+ */
+uint32_t Sched_GetIdlePercent(void) {
+	/* SysTick is suspended in STOP; that time is counted by power.c */
+	uint64_t stop_ms = Power_GetStopTimeMs();
+#if TICKLESS_IS_ACTIVE
+	uint64_t ticks = HAL_GetTick();
+	uint64_t idle = (sched_idle_us / 1000U) + stop_ms;
+#else
+	uint64_t ticks = sched_ticks + stop_ms;
+	uint64_t idle = sched_idle_ticks + stop_ms;
+#endif /* TICKLESS_IS_ACTIVE */
+
+	if (ticks == 0U) {
+		return 0U;
+	}
+	return (uint32_t) ((idle * 100U) / ticks);
+}
+
+/**
+ * @brief Prints one line per task.
+ */
+void Sched_Dump(void) {
+	const sched_task_t *task;
+	uint64_t window = Perf_WindowCycles();
+	uint32_t load;
+	uint32_t i;
+
+	for (i = 0U; i < sched_task_count; i++) {
+		task = &sched_tasks[i];
+		load = Perf_Permille(task->cycles, window);
+		printf("task %s %s runs %lu max_us %lu late_ms %lu load %lu.%lu%%\r\n",
+				task->name, (task->timer != NULL) ? "timer" : "poll",
+				task->runs, task->max_run_us, task->max_late_ms,
+				load / 10U, load % 10U);
+	}
+	printf("idle %lu %%\r\n", Sched_GetIdlePercent());
+}
+
+/**
+ * @brief Clears the per-task run time.
+ */
+void Sched_ResetLoad(void) {
+	uint32_t i;
+
+	for (i = 0U; i < sched_task_count; i++) {
+		sched_tasks[i].cycles = 0U;
+	}
+}
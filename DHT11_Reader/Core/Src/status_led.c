@@ -0,0 +1,294 @@
+/**
+ ******************************************************************************
+ * @file           : status_led.c
+ * @brief          : LD2 status patterns on TIM2 PWM.
+ *
+ *                   ARR and CCR1 are preloaded: the update interrupt that
+ *                   starts one period writes the values of the next, so a
+ *                   segment change never glitches the output. A level is
+ *                   a percentage squared into the on time, so the
+ *                   breathing ramp looks even to the eye.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "status_led.h"
+#include "dht11_health.h"
+#include "uart_tx.h"
+#include "clock_config.h"
+#include "irq_prio.h"
+#include <stddef.h>
+
+/**
+ * @brief Part of a pattern: steps PWM periods ramping from one level to
+ *        another (or holding it, for from == to).
+ */
+typedef struct {
+	uint16_t period;  /*!< TIM2 ticks per PWM period */
+	uint8_t from;     /*!< Level 0-100, first period */
+	uint8_t to;       /*!< Level 0-100, last period  */
+	uint8_t steps;    /*!< Periods, at least 1       */
+} status_led_seg_t;
+
+typedef struct {
+	const status_led_seg_t *segs;
+	uint8_t count;
+} status_led_pattern_t;
+
+/** 100 Hz PWM for the breathing ramps */
+#define STATUS_LED_PWM_PERIOD (STATUS_LED_TIM_HZ / 100U)
+
+/** TIM2 ticks in a millisecond */
+#define STATUS_LED_MS(ms)     ((uint16_t) (((ms) * STATUS_LED_TIM_HZ) / 1000U))
+
+static const char *const led_names[STATUS_LED_STATES] = { "ok", "retrying",
+		"link_down", "fault" };
+
+#if STATUS_LED_USE_PWM
+static const status_led_seg_t led_ok[] = {
+	{ STATUS_LED_PWM_PERIOD, 0U, 100U, 150U },
+	{ STATUS_LED_PWM_PERIOD, 100U, 0U, 150U }
+};
+static const status_led_seg_t led_retrying[] = {
+	{ STATUS_LED_MS(100U), 100U, 100U, 1U },
+	{ STATUS_LED_MS(150U), 0U, 0U, 1U },
+	{ STATUS_LED_MS(100U), 100U, 100U, 1U },
+	{ STATUS_LED_MS(1150U), 0U, 0U, 1U }
+};
+static const status_led_seg_t led_link_down[] = {
+	{ STATUS_LED_MS(100U), 100U, 100U, 1U },
+	{ STATUS_LED_MS(1900U), 0U, 0U, 1U }
+};
+static const status_led_seg_t led_fault[] = {
+	{ STATUS_LED_MS(100U), 100U, 100U, 1U },
+	{ STATUS_LED_MS(100U), 0U, 0U, 1U }
+};
+
+#define STATUS_LED_PATTERN(p) { (p), (uint8_t) (sizeof(p) / sizeof((p)[0])) }
+
+static const status_led_pattern_t led_patterns[STATUS_LED_STATES] = {
+	STATUS_LED_PATTERN(led_ok), STATUS_LED_PATTERN(led_retrying),
+	STATUS_LED_PATTERN(led_link_down), STATUS_LED_PATTERN(led_fault)
+};
+
+/* Position of the period whose values sit in the preload registers */
+static const status_led_pattern_t *led_pattern = NULL;
+static uint8_t led_seg = 0U;
+static uint8_t led_step = 0U;
+#endif /* STATUS_LED_USE_PWM */
+
+static uint8_t led_sensor[STATUS_LED_SENSORS];
+static status_led_state_t led_shown = STATUS_LED_OK;
+static status_led_state_t led_forced = STATUS_LED_STATES;
+
+#if STATUS_LED_USE_PWM
+/**
+ * @brief Sets TIM2 to STATUS_LED_TIM_HZ from the APB1 timer clock.
+ */
+static void Status_Led_Prescaler(void) {
+	TIM2->PSC = (Clock_GetApb1TimerHz() / STATUS_LED_TIM_HZ) - 1U;
+}
+
+/**
+ * @brief Writes the period at the current position into ARR and CCR1.
+ */
+static void Status_Led_Load(void) {
+	const status_led_seg_t *seg = &led_pattern->segs[led_seg];
+	int32_t level = seg->from;
+
+	if (seg->steps > 1U) {
+		level += (((int32_t) seg->to - (int32_t) seg->from) * (int32_t) led_step)
+				/ ((int32_t) seg->steps - 1);
+	}
+	TIM2->ARR = (uint32_t) seg->period - 1U;
+	TIM2->CCR1 = ((uint32_t) seg->period * (uint32_t) (level * level)) / 10000U;
+}
+
+/**
+ * @brief Moves to the next period, wrapping at the end of the pattern.
+ */
+static void Status_Led_Next(void) {
+	if (++led_step >= led_pattern->segs[led_seg].steps) {
+		led_step = 0U;
+		if (++led_seg >= led_pattern->count) {
+			led_seg = 0U;
+		}
+	}
+}
+
+/**
+ * @brief Restarts TIM2 on the first period of a state's pattern.
+ */
+static void Status_Led_Start(status_led_state_t state) {
+	uint32_t basepri = Irq_MaskFrom(IRQ_PRIO_TICK);
+
+	TIM2->CR1 &= ~TIM_CR1_CEN;
+	led_pattern = &led_patterns[state];
+	led_seg = 0U;
+	led_step = 0U;
+	Status_Led_Load();
+	TIM2->EGR = TIM_EGR_UG; /* Into the shadows; URS keeps UIF clear */
+	Status_Led_Next();
+	Status_Led_Load();
+	TIM2->CR1 |= TIM_CR1_CEN;
+	Irq_Unmask(basepri);
+}
+#endif /* STATUS_LED_USE_PWM */
+
+/**
+ * @brief Shows a state, reprogramming the timer only on a change.
+ */
+static void Status_Led_Show(status_led_state_t state) {
+	if (state == led_shown) {
+		return;
+	}
+	led_shown = state;
+#if STATUS_LED_USE_PWM
+	Status_Led_Start(state);
+#endif /* STATUS_LED_USE_PWM */
+}
+
+/**
+ * @brief Claims PA5 and TIM2 and starts the OK pattern.
+ */
+void Status_Led_Init(void) {
+	uint32_t i;
+
+	for (i = 0U; i < STATUS_LED_SENSORS; i++) {
+		led_sensor[i] = (uint8_t) STATUS_LED_OK;
+	}
+	led_shown = STATUS_LED_OK;
+	led_forced = STATUS_LED_STATES;
+#if STATUS_LED_USE_PWM
+	__HAL_RCC_GPIOA_CLK_ENABLE();
+	__HAL_RCC_TIM2_CLK_ENABLE();
+
+	TIM2->CR1 = TIM_CR1_ARPE | TIM_CR1_URS;
+	TIM2->CCMR1 = TIM_CCMR1_OC1M_2 | TIM_CCMR1_OC1M_1 | TIM_CCMR1_OC1PE; /* PWM 1 */
+	TIM2->CCER = TIM_CCER_CC1E;
+	Status_Led_Prescaler();
+	TIM2->SR = 0U;
+	TIM2->DIER = TIM_DIER_UIE;
+
+	LD2_GPIO_Port->AFR[0] = (LD2_GPIO_Port->AFR[0] & ~(0xFUL << (4U * 5U)))
+			| (GPIO_AF1_TIM2 << (4U * 5U));
+	LD2_GPIO_Port->MODER = (LD2_GPIO_Port->MODER & ~GPIO_MODER_MODER5)
+			| GPIO_MODER_MODER5_1;
+
+	HAL_NVIC_SetPriority(TIM2_IRQn, IRQ_PRIO_TICK, 0U);
+	HAL_NVIC_EnableIRQ(TIM2_IRQn);
+	Status_Led_Start(STATUS_LED_OK);
+#endif /* STATUS_LED_USE_PWM */
+}
+
+/**
+ * @brief Takes one emitted reading's sensor health and the link state.
+ */
+void Status_Led_Update(const dht11_reading_t *reading) {
+	status_led_state_t state = STATUS_LED_OK;
+	dht11_health_t health;
+	uint32_t i;
+
+#if !STATUS_LED_USE_PWM
+	if (reading->status == DHT11_OK) {
+		HAL_GPIO_TogglePin(LD2_GPIO_Port, LD2_Pin);
+	}
+#endif /* !STATUS_LED_USE_PWM */
+	if (reading->sensor_id < STATUS_LED_SENSORS) {
+		health = DHT11_Health_Get(reading->sensor_id);
+		led_sensor[reading->sensor_id] = (uint8_t) ((health == DHT11_HEALTH_FAILED) ?
+				STATUS_LED_FAULT : ((health == DHT11_HEALTH_DEGRADED) ?
+						STATUS_LED_RETRYING : STATUS_LED_OK));
+	}
+	if (UART_TX_GetPressure() == UART_TX_PRESSURE_STALLED) {
+		state = STATUS_LED_LINK_DOWN;
+	}
+	for (i = 0U; i < STATUS_LED_SENSORS; i++) {
+		if (led_sensor[i] > (uint8_t) state) {
+			state = (status_led_state_t) led_sensor[i];
+		}
+	}
+	if (led_forced == STATUS_LED_STATES) {
+		Status_Led_Show(state);
+	}
+}
+
+/**
+ * @brief Shows one state whatever the readings say.
+ */
+void Status_Led_Force(status_led_state_t state) {
+	led_forced = (state < STATUS_LED_STATES) ? state : STATUS_LED_STATES;
+	if (led_forced != STATUS_LED_STATES) {
+		Status_Led_Show(led_forced);
+	}
+}
+
+/**
+ * @brief State shown now.
+ */
+status_led_state_t Status_Led_Get(void) {
+	return led_shown;
+}
+
+/**
+ * @brief Reports whether a state is being forced.
+ */
+uint8_t Status_Led_IsForced(void) {
+	return (led_forced != STATUS_LED_STATES) ? 1U : 0U;
+}
+
+/**
+ * @brief Short printable name of a state.
+ */
+const char* Status_Led_Name(status_led_state_t state) {
+	return (state < STATUS_LED_STATES) ? led_names[state] : "?";
+}
+
+#if STATUS_LED_USE_PWM
+/**
+ * @brief Forces CH1 inactive: the frozen counter would hold LD2 either way.
+ */
+void Status_Led_StopBegin(void) {
+	TIM2->CCMR1 = (TIM2->CCMR1 & ~TIM_CCMR1_OC1M) | TIM_CCMR1_OC1M_2;
+}
+
+/**
+ * @brief Back to PWM, from the start of the pattern.
+ */
+void Status_Led_StopEnd(void) {
+	TIM2->CCMR1 = (TIM2->CCMR1 & ~TIM_CCMR1_OC1M) | TIM_CCMR1_OC1M_2
+			| TIM_CCMR1_OC1M_1;
+	Status_Led_Start(led_shown);
+}
+
+/**
+ * @brief Reports whether the shown state keeps the node out of STOP.
+ */
+uint8_t Status_Led_HoldsStop(void) {
+	return ((STATUS_LED_HOLD_STOP != 0) && (led_shown != STATUS_LED_OK)) ?
+			1U : 0U;
+}
+
+/**
+ * @brief Recomputes the TIM2 prescaler; it applies from the next period.
+ */
+void Status_Led_ClockChanged(void) {
+	Status_Led_Prescaler();
+}
+
+/**
+ * @brief TIM2 update: the period just started came from the preloads;
+ *        write the one after it.
+ */
+void Status_Led_IRQHandler(void) {
+	if ((TIM2->SR & TIM_SR_UIF) == 0U) {
+		return;
+	}
+	TIM2->SR = ~TIM_SR_UIF;
+	Status_Led_Next();
+	Status_Led_Load();
+}
+#endif /* STATUS_LED_USE_PWM */
@@ -0,0 +1,98 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    stm32f4xx_hal_timebase_tim.c
+  * @brief   HAL time base based on the hardware TIM7.
+  *
+  *          Only used by the FreeRTOS build (app_rtos.h), where the kernel
+  *          owns SysTick. TIM7 counts at 1 MHz and updates every 1 ms;
+  *          HAL_InitTick() runs again on every clock change from
+  *          HAL_RCC_ClockConfig() and recomputes the prescaler.
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "stm32f4xx_hal_tim.h"
+#include "app_rtos.h"
+#include "clock_config.h"
+
+#if APP_USE_RTOS
+
+/* Private variables ---------------------------------------------------------*/
+TIM_HandleTypeDef htim7;
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  This function configures the TIM7 as a time base source.
+  *         The time source is configured to have 1ms time base with a dedicated
+  *         Tick interrupt priority.
+  * @note   This function is called automatically at the beginning of program after
+  *         reset by HAL_Init() or at any time when clock is configured, by HAL_RCC_ClockConfig().
+  * @param  TickPriority: Tick interrupt priority.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_InitTick(uint32_t TickPriority)
+{
+  HAL_StatusTypeDef status;
+
+  if (TickPriority >= (1UL << __NVIC_PRIO_BITS))
+  {
+    return HAL_ERROR;
+  }
+
+  /* Enable TIM7 clock */
+  __HAL_RCC_TIM7_CLK_ENABLE();
+
+  /* 1 MHz counter clock from the APB1 timer clock, update every 1 ms */
+  htim7.Instance = TIM7;
+  htim7.Init.Period = (1000000U / 1000U) - 1U;
+  htim7.Init.Prescaler = (Clock_GetApb1TimerHz() / 1000000U) - 1U;
+  htim7.Init.ClockDivision = 0;
+  htim7.Init.CounterMode = TIM_COUNTERMODE_UP;
+  htim7.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+
+  status = HAL_TIM_Base_Init(&htim7);
+  if (status == HAL_OK)
+  {
+    /* Start the TIM time Base generation in interrupt mode */
+    status = HAL_TIM_Base_Start_IT(&htim7);
+  }
+  if (status == HAL_OK)
+  {
+    HAL_NVIC_SetPriority(TIM7_IRQn, TickPriority, 0U);
+    HAL_NVIC_EnableIRQ(TIM7_IRQn);
+    uwTickPrio = TickPriority;
+  }
+
+  /* Return function status */
+  return status;
+}
+
+/**
+  * @brief  Suspend Tick increment.
+  * @note   Disable the tick increment by disabling TIM7 update interrupt.
+  * @param  None
+  * @retval None
+  */
+void HAL_SuspendTick(void)
+{
+  /* Disable TIM7 update Interrupt */
+  __HAL_TIM_DISABLE_IT(&htim7, TIM_IT_UPDATE);
+}
+
+/**
+  * @brief  Resume Tick increment.
+  * @note   Enable the tick increment by Enabling TIM7 update interrupt.
+  * @param  None
+  * @retval None
+  */
+void HAL_ResumeTick(void)
+{
+  /* Enable TIM7 Update interrupt */
+  __HAL_TIM_ENABLE_IT(&htim7, TIM_IT_UPDATE);
+}
+
+#endif /* APP_USE_RTOS */
@@ -22,6 +22,33 @@
 #include "stm32f4xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "power.h"
+#include "sched.h"
+#include "app_rtos.h"
+#include "crash.h"
+#include "dht11_exti.h"
+#include "perf.h"
+#include "usb_cdc.h"
+#include "can_bus.h"
+#include "i2c_regmap.h"
+#include "modbus.h"
+#include "dht11_emu.h"
+#include "dht11_sync.h"
+#include "dht11_trigger.h"
+#include "dht11_capture.h"
+#include "dht11_async.h"
+#include "systime.h"
+#include "timebase.h"
+#include "uart_tx.h"
+#include "uart_flow.h"
+#include "status_led.h"
+#include "adc_mon.h"
+#include "rs485_gw.h"
+#include "watermark.h"
+#if APP_USE_RTOS
+#include "FreeRTOS.h"
+#include "task.h"
+#endif /* APP_USE_RTOS */
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -51,10 +78,55 @@
 
 /* Private user code ---------------------------------------------------------*/
 /* USER CODE BEGIN 0 */
+#if APP_USE_FASTPATH
+/**
+  * @brief TIM5 flags in place of HAL_TIM_IRQHandler(): CC1 is the async
+  *        refresh deadline, the update a SysTime wrap, CC3 only ends a
+  *        tickless sleep (tickless.h).
+  */
+static void Fast_TIM5Dispatch(void)
+{
+  uint32_t sr = TIM5->SR & TIM5->DIER
+      & (TIM_SR_CC1IF | TIM_SR_CC3IF | TIM_SR_UIF);
+
+  TIM5->SR = ~sr;
+  if ((sr & TIM_SR_CC1IF) != 0U)
+  {
+    DHT11_Async_TimerCallback();
+  }
+  if ((sr & TIM_SR_UIF) != 0U)
+  {
+    SysTime_OverflowCallback();
+  }
+}
+
+/**
+  * @brief TIM6 update in place of HAL_TIM_IRQHandler().
+  */
+static void Fast_TIM6Dispatch(void)
+{
+  if ((TIM6->SR & TIM_SR_UIF) != 0U)
+  {
+    TIM6->SR = ~TIM_SR_UIF;
+    Timebase_TIM6UpdateCallback();
+  }
+}
+#endif /* APP_USE_FASTPATH */
 
 /* USER CODE END 0 */
 
 /* External variables --------------------------------------------------------*/
+extern DMA_HandleTypeDef hdma_tim1_up;
+extern DMA_HandleTypeDef hdma_tim5_ch2;
+extern TIM_HandleTypeDef htim5;
+extern TIM_HandleTypeDef htim6;
+#if APP_USE_RTOS
+extern TIM_HandleTypeDef htim7;
+extern void xPortSysTickHandler(void);
+#endif /* APP_USE_RTOS */
+extern DMA_HandleTypeDef hdma_usart2_rx;
+extern DMA_HandleTypeDef hdma_usart2_tx;
+extern UART_HandleTypeDef huart2;
 
 /* USER CODE BEGIN EV */
 
@@ -81,63 +153,48 @@ void NMI_Handler(void)
 /**
   * @brief This function handles Hard fault interrupt.
   */
-void HardFault_Handler(void)
+__attribute__((naked)) void HardFault_Handler(void)
 {
   /* USER CODE BEGIN HardFault_IRQn 0 */
-
+  /* Save the frame and fault status to .noinit, then reset (crash.h) */
+  CRASH_FAULT_ENTRY(CRASH_REASON_HARDFAULT);
   /* USER CODE END HardFault_IRQn 0 */
-  while (1)
-  {
-    /* USER CODE BEGIN W1_HardFault_IRQn 0 */
-    /* USER CODE END W1_HardFault_IRQn 0 */
-  }
 }
 
 /**
   * @brief This function handles Memory management fault.
   */
-void MemManage_Handler(void)
+__attribute__((naked)) void MemManage_Handler(void)
 {
   /* USER CODE BEGIN MemoryManagement_IRQn 0 */
-
+  /* Save the frame and fault status to .noinit, then reset (crash.h) */
+  CRASH_FAULT_ENTRY(CRASH_REASON_MEMMANAGE);
   /* USER CODE END MemoryManagement_IRQn 0 */
-  while (1)
-  {
-    /* USER CODE BEGIN W1_MemoryManagement_IRQn 0 */
-    /* USER CODE END W1_MemoryManagement_IRQn 0 */
-  }
 }
 
 /**
   * @brief This function handles Pre-fetch fault, memory access fault.
   */
-void BusFault_Handler(void)
+__attribute__((naked)) void BusFault_Handler(void)
 {
   /* USER CODE BEGIN BusFault_IRQn 0 */
-
+  /* Save the frame and fault status to .noinit, then reset (crash.h) */
+  CRASH_FAULT_ENTRY(CRASH_REASON_BUSFAULT);
   /* USER CODE END BusFault_IRQn 0 */
-  while (1)
-  {
-    /* USER CODE BEGIN W1_BusFault_IRQn 0 */
-    /* USER CODE END W1_BusFault_IRQn 0 */
-  }
 }
 
 /**
   * @brief This function handles Undefined instruction or illegal state.
   */
-void UsageFault_Handler(void)
+__attribute__((naked)) void UsageFault_Handler(void)
 {
   /* USER CODE BEGIN UsageFault_IRQn 0 */
-
+  /* Save the frame and fault status to .noinit, then reset (crash.h) */
+  CRASH_FAULT_ENTRY(CRASH_REASON_USAGEFAULT);
   /* USER CODE END UsageFault_IRQn 0 */
-  while (1)
-  {
-    /* USER CODE BEGIN W1_UsageFault_IRQn 0 */
-    /* USER CODE END W1_UsageFault_IRQn 0 */
-  }
 }
 
+#if !APP_USE_RTOS
 /**
   * @brief This function handles System service call via SWI instruction.
   */
@@ -150,6 +207,7 @@ void SVC_Handler(void)
 
   /* USER CODE END SVCall_IRQn 1 */
 }
+#endif /* !APP_USE_RTOS */
 
 /**
   * @brief This function handles Debug monitor.
@@ -164,6 +222,7 @@ void DebugMon_Handler(void)
   /* USER CODE END DebugMonitor_IRQn 1 */
 }
 
+#if !APP_USE_RTOS
 /**
   * @brief This function handles Pendable request for system service.
   */
@@ -176,6 +235,7 @@ void PendSV_Handler(void)
 
   /* USER CODE END PendSV_IRQn 1 */
 }
+#endif /* !APP_USE_RTOS */
 
 /**
   * @brief This function handles System tick timer.
@@ -183,10 +243,22 @@ void PendSV_Handler(void)
 void SysTick_Handler(void)
 {
   /* USER CODE BEGIN SysTick_IRQn 0 */
-
+  WATERMARK_SYSTICK_ENTRY();
+  PERF_ISR_ENTER();
+#if APP_USE_RTOS
+  /* Kernel tick; the HAL tick runs on TIM7 */
+  if (xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED)
+  {
+    xPortSysTickHandler();
+  }
+  PERF_ISR_EXIT(PERF_ISR_SYSTICK);
+  return;
+#endif /* APP_USE_RTOS */
   /* USER CODE END SysTick_IRQn 0 */
   HAL_IncTick();
   /* USER CODE BEGIN SysTick_IRQn 1 */
+  Sched_TickHandler();
+  PERF_ISR_EXIT(PERF_ISR_SYSTICK);
 
   /* USER CODE END SysTick_IRQn 1 */
 }
@@ -198,6 +270,402 @@ void SysTick_Handler(void)
 /* please refer to the startup file (startup_stm32f4xx.s).                    */
 /******************************************************************************/
 
+/**
+  * @brief This function handles RTC wake-up interrupt through EXTI line 22.
+  */
+void RTC_WKUP_IRQHandler(void)
+{
+  /* USER CODE BEGIN RTC_WKUP_IRQn 0 */
+  PERF_ISR_ENTER();
+
+  /* USER CODE END RTC_WKUP_IRQn 0 */
+  Power_WakeupIRQHandler();
+  /* USER CODE BEGIN RTC_WKUP_IRQn 1 */
+  PERF_ISR_EXIT(PERF_ISR_RTC_WKUP);
+
+  /* USER CODE END RTC_WKUP_IRQn 1 */
+}
+
+#if DHT11_USE_EXTI
+/**
+  * @brief This function handles EXTI line1 interrupt.
+  */
+void EXTI1_IRQHandler(void)
+{
+  /* USER CODE BEGIN EXTI1_IRQn 0 */
+  PERF_ISR_ENTER();
+
+  /* USER CODE END EXTI1_IRQn 0 */
+  DHT11_Exti_IRQHandler();
+  /* USER CODE BEGIN EXTI1_IRQn 1 */
+  PERF_ISR_EXIT(PERF_ISR_EXTI1);
+
+  /* USER CODE END EXTI1_IRQn 1 */
+}
+#endif /* DHT11_USE_EXTI */
+
+/**
+  * @brief This function handles EXTI line3 interrupt.
+  */
+void EXTI3_IRQHandler(void)
+{
+  /* USER CODE BEGIN EXTI3_IRQn 0 */
+  PERF_ISR_ENTER();
+
+  /* USER CODE END EXTI3_IRQn 0 */
+  HAL_GPIO_EXTI_IRQHandler(USART_RX_Pin);
+  /* USER CODE BEGIN EXTI3_IRQn 1 */
+  PERF_ISR_EXIT(PERF_ISR_EXTI3);
+
+  /* USER CODE END EXTI3_IRQn 1 */
+}
+
+/**
+  * @brief This function handles DMA1 stream4 global interrupt.
+  */
+void DMA1_Stream4_IRQHandler(void)
+{
+  /* USER CODE BEGIN DMA1_Stream4_IRQn 0 */
+  PERF_ISR_ENTER();
+#if APP_USE_FASTPATH
+  DHT11_Capture_DmaIRQHandler();
+  PERF_ISR_EXIT(PERF_ISR_DMA1_S4);
+  return;
+#endif /* APP_USE_FASTPATH */
+
+  /* USER CODE END DMA1_Stream4_IRQn 0 */
+  HAL_DMA_IRQHandler(&hdma_tim5_ch2);
+  /* USER CODE BEGIN DMA1_Stream4_IRQn 1 */
+  PERF_ISR_EXIT(PERF_ISR_DMA1_S4);
+
+  /* USER CODE END DMA1_Stream4_IRQn 1 */
+}
+
+/**
+  * @brief This function handles DMA1 stream5 global interrupt.
+  */
+void DMA1_Stream5_IRQHandler(void)
+{
+  /* USER CODE BEGIN DMA1_Stream5_IRQn 0 */
+  PERF_ISR_ENTER();
+
+  /* USER CODE END DMA1_Stream5_IRQn 0 */
+  HAL_DMA_IRQHandler(&hdma_usart2_rx);
+  /* USER CODE BEGIN DMA1_Stream5_IRQn 1 */
+  PERF_ISR_EXIT(PERF_ISR_DMA1_S5);
+
+  /* USER CODE END DMA1_Stream5_IRQn 1 */
+}
+
+/**
+  * @brief This function handles DMA1 stream6 global interrupt.
+  */
+void DMA1_Stream6_IRQHandler(void)
+{
+  /* USER CODE BEGIN DMA1_Stream6_IRQn 0 */
+  PERF_ISR_ENTER();
+#if APP_USE_FASTPATH && UART_TX_USE_DMA
+  if (UART_TX_DmaIRQHandler() != 0U)
+  {
+    PERF_ISR_EXIT(PERF_ISR_DMA1_S6);
+    return;
+  }
+#endif /* APP_USE_FASTPATH && UART_TX_USE_DMA */
+
+  /* USER CODE END DMA1_Stream6_IRQn 0 */
+  HAL_DMA_IRQHandler(&hdma_usart2_tx);
+  /* USER CODE BEGIN DMA1_Stream6_IRQn 1 */
+  PERF_ISR_EXIT(PERF_ISR_DMA1_S6);
+
+  /* USER CODE END DMA1_Stream6_IRQn 1 */
+}
+
+/**
+  * @brief This function handles USART2 global interrupt.
+  */
+void USART2_IRQHandler(void)
+{
+  /* USER CODE BEGIN USART2_IRQn 0 */
+  PERF_ISR_ENTER();
+#if !UART_TX_USE_DMA
+  UART_TX_IRQHandler(); /* TXE; HAL_UART_IRQHandler() ignores it when idle */
+#endif /* !UART_TX_USE_DMA */
+
+  /* USER CODE END USART2_IRQn 0 */
+  HAL_UART_IRQHandler(&huart2);
+  /* USER CODE BEGIN USART2_IRQn 1 */
+  PERF_ISR_EXIT(PERF_ISR_USART2);
+
+  /* USER CODE END USART2_IRQn 1 */
+}
+
+/**
+  * @brief This function handles TIM5 global interrupt.
+  */
+void TIM5_IRQHandler(void)
+{
+  /* USER CODE BEGIN TIM5_IRQn 0 */
+  PERF_ISR_ENTER();
+#if APP_USE_FASTPATH
+  Fast_TIM5Dispatch();
+  PERF_ISR_EXIT(PERF_ISR_TIM5);
+  return;
+#endif /* APP_USE_FASTPATH */
+
+  /* USER CODE END TIM5_IRQn 0 */
+  HAL_TIM_IRQHandler(&htim5);
+  /* USER CODE BEGIN TIM5_IRQn 1 */
+  PERF_ISR_EXIT(PERF_ISR_TIM5);
+
+  /* USER CODE END TIM5_IRQn 1 */
+}
+
+/**
+  * @brief This function handles TIM6 global interrupt, DAC1 and DAC2 underrun error interrupts.
+  */
+void TIM6_DAC_IRQHandler(void)
+{
+  /* USER CODE BEGIN TIM6_DAC_IRQn 0 */
+  WATERMARK_TIM6_ENTRY();
+  PERF_ISR_ENTER();
+#if APP_USE_FASTPATH
+  Fast_TIM6Dispatch();
+  PERF_ISR_EXIT(PERF_ISR_TIM6);
+  return;
+#endif /* APP_USE_FASTPATH */
+
+  /* USER CODE END TIM6_DAC_IRQn 0 */
+  HAL_TIM_IRQHandler(&htim6);
+  /* USER CODE BEGIN TIM6_DAC_IRQn 1 */
+  PERF_ISR_EXIT(PERF_ISR_TIM6);
+
+  /* USER CODE END TIM6_DAC_IRQn 1 */
+}
+
+#if APP_USE_RTOS
+/**
+  * @brief This function handles TIM7 global interrupt (HAL tick).
+  */
+void TIM7_IRQHandler(void)
+{
+  /* USER CODE BEGIN TIM7_IRQn 0 */
+  PERF_ISR_ENTER();
+
+  /* USER CODE END TIM7_IRQn 0 */
+  HAL_TIM_IRQHandler(&htim7);
+  /* USER CODE BEGIN TIM7_IRQn 1 */
+  PERF_ISR_EXIT(PERF_ISR_TIM7);
+
+  /* USER CODE END TIM7_IRQn 1 */
+}
+#endif /* APP_USE_RTOS */
+
+/**
+  * @brief This function handles DMA2 stream5 global interrupt.
+  */
+void DMA2_Stream5_IRQHandler(void)
+{
+  /* USER CODE BEGIN DMA2_Stream5_IRQn 0 */
+  PERF_ISR_ENTER();
+
+  /* USER CODE END DMA2_Stream5_IRQn 0 */
+  HAL_DMA_IRQHandler(&hdma_tim1_up);
+  /* USER CODE BEGIN DMA2_Stream5_IRQn 1 */
+  PERF_ISR_EXIT(PERF_ISR_DMA2_S5);
+
+  /* USER CODE END DMA2_Stream5_IRQn 1 */
+}
+
 /* USER CODE BEGIN 1 */
+#if USB_USE_CDC
+/**
+  * @brief This function handles USB On The Go FS global interrupt.
+  */
+void OTG_FS_IRQHandler(void)
+{
+  PERF_ISR_ENTER();
+  Usb_Cdc_IRQHandler();
+  PERF_ISR_EXIT(PERF_ISR_OTG_FS);
+}
+#endif /* USB_USE_CDC */
+#if CAN_USE_BUS
+/**
+  * @brief This function handles CAN1 TX interrupts.
+  */
+void CAN1_TX_IRQHandler(void)
+{
+  PERF_ISR_ENTER();
+  Can_Bus_TxIRQHandler();
+  PERF_ISR_EXIT(PERF_ISR_CAN1_TX);
+}
+
+/**
+  * @brief This function handles CAN1 RX0 interrupts.
+  */
+void CAN1_RX0_IRQHandler(void)
+{
+  PERF_ISR_ENTER();
+  Can_Bus_Rx0IRQHandler();
+  PERF_ISR_EXIT(PERF_ISR_CAN1_RX0);
+}
+
+/**
+  * @brief This function handles CAN1 SCE interrupt.
+  */
+void CAN1_SCE_IRQHandler(void)
+{
+  PERF_ISR_ENTER();
+  Can_Bus_SceIRQHandler();
+  PERF_ISR_EXIT(PERF_ISR_CAN1_SCE);
+}
+#endif /* CAN_USE_BUS */
+#if I2C_USE_REGMAP
+/**
+  * @brief This function handles I2C1 event interrupt.
+  */
+void I2C1_EV_IRQHandler(void)
+{
+  PERF_ISR_ENTER();
+  I2C_Regmap_EvIRQHandler();
+  PERF_ISR_EXIT(PERF_ISR_I2C1_EV);
+}
+
+/**
+  * @brief This function handles I2C1 error interrupt.
+  */
+void I2C1_ER_IRQHandler(void)
+{
+  PERF_ISR_ENTER();
+  I2C_Regmap_ErIRQHandler();
+  PERF_ISR_EXIT(PERF_ISR_I2C1_ER);
+}
+
+/**
+  * @brief This function handles DMA1 stream7 global interrupt.
+  */
+void DMA1_Stream7_IRQHandler(void)
+{
+  PERF_ISR_ENTER();
+  I2C_Regmap_DmaIRQHandler();
+  PERF_ISR_EXIT(PERF_ISR_DMA1_S7);
+}
+#endif /* I2C_USE_REGMAP */
+#if MODBUS_USE_RTU
+/**
+  * @brief This function handles TIM4 global interrupt.
+  */
+void TIM4_IRQHandler(void)
+{
+  PERF_ISR_ENTER();
+  Modbus_TimerIRQHandler();
+  PERF_ISR_EXIT(PERF_ISR_TIM4);
+}
+#endif /* MODBUS_USE_RTU */
+#if DHT11_EMU_USE_LOOPBACK || DHT11_USE_TRIGGER
+/**
+  * @brief This function handles EXTI line[15:10] interrupts.
+  */
+void EXTI15_10_IRQHandler(void)
+{
+  PERF_ISR_ENTER();
+#if DHT11_EMU_USE_LOOPBACK
+  DHT11_Emu_ExtiIRQHandler();
+#endif /* DHT11_EMU_USE_LOOPBACK */
+#if DHT11_USE_TRIGGER
+  DHT11_Trigger_IRQHandler();
+#endif /* DHT11_USE_TRIGGER */
+  PERF_ISR_EXIT(PERF_ISR_EXTI15_10);
+}
+#endif /* DHT11_EMU_USE_LOOPBACK || DHT11_USE_TRIGGER */
+#if DHT11_EMU_USE_LOOPBACK
+/**
+  * @brief This function handles DMA1 stream1 global interrupt.
+  */
+void DMA1_Stream1_IRQHandler(void)
+{
+  PERF_ISR_ENTER();
+  DHT11_Emu_DmaIRQHandler();
+  PERF_ISR_EXIT(PERF_ISR_DMA1_S1);
+}
+#endif /* DHT11_EMU_USE_LOOPBACK */
+#if DHT11_USE_SYNC
+/**
+  * @brief This function handles EXTI line0 interrupt.
+  */
+void EXTI0_IRQHandler(void)
+{
+  PERF_ISR_ENTER();
+  DHT11_Sync_IRQHandler();
+  PERF_ISR_EXIT(PERF_ISR_EXTI0);
+}
+#endif /* DHT11_USE_SYNC */
+#if UART_FLOW_USE_RTSCTS
+/**
+  * @brief This function handles EXTI line[9:5] interrupts.
+  */
+void EXTI9_5_IRQHandler(void)
+{
+  PERF_ISR_ENTER();
+  UART_Flow_IRQHandler();
+  PERF_ISR_EXIT(PERF_ISR_EXTI9_5);
+}
+#endif /* UART_FLOW_USE_RTSCTS */
+#if STATUS_LED_USE_PWM
+/**
+  * @brief This function handles TIM2 global interrupt.
+  */
+void TIM2_IRQHandler(void)
+{
+  PERF_ISR_ENTER();
+  Status_Led_IRQHandler();
+  PERF_ISR_EXIT(PERF_ISR_TIM2);
+}
+#endif /* STATUS_LED_USE_PWM */
+#if ADC_MON_USE_ADC
+/**
+  * @brief This function handles ADC1, ADC2 and ADC3 global interrupts.
+  */
+void ADC_IRQHandler(void)
+{
+  PERF_ISR_ENTER();
+  Adc_Mon_IRQHandler();
+  PERF_ISR_EXIT(PERF_ISR_ADC);
+}
+#endif /* ADC_MON_USE_ADC */
+#if RS485_USE_GATEWAY
+/**
+  * @brief This function handles USART3 global interrupt.
+  */
+void USART3_IRQHandler(void)
+{
+  PERF_ISR_ENTER();
+  Rs485_Gw_UartIRQHandler();
+  PERF_ISR_EXIT(PERF_ISR_USART3);
+}
+
+/**
+  * @brief This function handles TIM8 break and TIM12 global interrupts.
+  */
+void TIM8_BRK_TIM12_IRQHandler(void)
+{
+  PERF_ISR_ENTER();
+  Rs485_Gw_TimerIRQHandler();
+  PERF_ISR_EXIT(PERF_ISR_TIM12);
+}
+#endif /* RS485_USE_GATEWAY */
+#if WATERMARK_USE_PROBE
+/**
+  * @brief This function handles TIM1 trigger and commutation and TIM11
+  *        global interrupts.
+  */
+void TIM1_TRG_COM_TIM11_IRQHandler(void)
+{
+  uint32_t cnt = TIM11->CNT; /* First: the probe's latency ends here */
+
+  PERF_ISR_ENTER();
+  Watermark_ProbeIRQHandler(cnt);
+  PERF_ISR_EXIT(PERF_ISR_TIM11);
+}
+#endif /* WATERMARK_USE_PROBE */
 
 /* USER CODE END 1 */
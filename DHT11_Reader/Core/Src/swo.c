@@ -0,0 +1,155 @@
+/**
+ ******************************************************************************
+ * @file           : swo.c
+ * @brief          : ITM trace output over the SWO pin (PB3).
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "swo.h"
+#include "telemetry.h"
+
+#if SWO_USE_ITM
+
+/** ITM lock access key */
+#define SWO_ITM_UNLOCK   (0xC5ACCE55UL)
+
+/** TPIU selected pin protocol: asynchronous NRZ */
+#define SWO_TPI_SPPR_NRZ (2UL)
+
+/** TPIU formatter: bypassed, TrigIn kept on */
+#define SWO_TPI_FFCR     (0x100UL)
+
+/**
+ * @brief Ports are written only while tracing is on and the port enabled.
+ */
+static inline uint8_t Swo_PortOn(uint32_t port) {
+	return (((ITM->TCR & ITM_TCR_ITMENA_Msk) != 0U)
+			&& ((ITM->TER & (1UL << port)) != 0U)) ? 1U : 0U;
+}
+
+/**
+ * @brief Routes TRACESWO to PB3 and configures TPIU, ITM and DWT.
+ */
+void Swo_Init(void) {
+	GPIO_InitTypeDef GPIO_InitStruct = { 0 };
+	uint32_t tcr;
+
+	__HAL_RCC_GPIOB_CLK_ENABLE();
+	GPIO_InitStruct.Pin = SWO_Pin;
+	GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+	GPIO_InitStruct.Pull = GPIO_NOPULL;
+	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+	GPIO_InitStruct.Alternate = GPIO_AF0_TRACE;
+	HAL_GPIO_Init(SWO_GPIO_Port, &GPIO_InitStruct);
+
+	/* Asynchronous trace: TRACE_MODE 00, only TRACESWO is claimed */
+	DBGMCU->CR = (DBGMCU->CR & ~DBGMCU_CR_TRACE_MODE) | DBGMCU_CR_TRACE_IOEN;
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+
+	TPI->CSPSR = 1UL;
+	Swo_ClockChanged();
+	TPI->SPPR = SWO_TPI_SPPR_NRZ;
+	TPI->FFCR = SWO_TPI_FFCR;
+
+	/* Local timestamps at the CPU clock, DWT packets on trace bus 1 */
+	tcr = ITM_TCR_ITMENA_Msk | ITM_TCR_TSENA_Msk | ITM_TCR_SYNCENA_Msk
+			| (1UL << ITM_TCR_TraceBusID_Pos);
+#if SWO_USE_PC_SAMPLING || SWO_USE_EXC_TRACE
+	tcr |= ITM_TCR_DWTENA_Msk;
+#endif
+	ITM->LAR = SWO_ITM_UNLOCK;
+	ITM->TCR = 0UL;
+	ITM->TPR = 0UL;
+	ITM->TER = (1UL << SWO_PORT_LOG) | (1UL << SWO_PORT_READING)
+			| (1UL << SWO_PORT_EVENT);
+	ITM->TCR = tcr;
+
+	/* CYCCNT stays on for timebase.h; only the trace sources change */
+	DWT->CTRL &= ~(DWT_CTRL_PCSAMPLENA_Msk | DWT_CTRL_EXCTRCENA_Msk
+			| DWT_CTRL_CYCTAP_Msk | DWT_CTRL_POSTPRESET_Msk);
+#if SWO_USE_PC_SAMPLING
+	DWT->CTRL |= DWT_CTRL_CYCTAP_Msk
+			| (((SWO_PC_SAMPLE_CYCLES / 1024U) - 1U) << DWT_CTRL_POSTPRESET_Pos)
+			| DWT_CTRL_PCSAMPLENA_Msk;
+#endif
+#if SWO_USE_EXC_TRACE
+	DWT->CTRL |= DWT_CTRL_EXCTRCENA_Msk;
+#endif
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+ * @brief Recomputes the SWO baud divider from the current HCLK.
+ */
+void Swo_ClockChanged(void) {
+	TPI->ACPR = (HAL_RCC_GetHCLKFreq() / SWO_BAUD) - 1UL;
+}
+
+/**
+ * @brief Writes bytes to a stimulus port, 32 bits at a time.
+ */
+void Swo_Write(uint32_t port, const uint8_t *data, uint32_t len) {
+	uint32_t word;
+	uint32_t i = 0U;
+
+	if (Swo_PortOn(port) == 0U) {
+		return;
+	}
+	for (; (i + 4U) <= len; i += 4U) {
+		word = (uint32_t) data[i] | ((uint32_t) data[i + 1U] << 8)
+				| ((uint32_t) data[i + 2U] << 16)
+				| ((uint32_t) data[i + 3U] << 24);
+		while (ITM->PORT[port].u32 == 0UL) {
+		}
+		ITM->PORT[port].u32 = word;
+	}
+	for (; i < len; i++) {
+		while (ITM->PORT[port].u32 == 0UL) {
+		}
+		ITM->PORT[port].u8 = data[i];
+	}
+}
+
+/**
+ * @brief Writes one character to SWO_PORT_LOG.
+ */
+void Swo_PutChar(uint8_t ch) {
+	if (Swo_PortOn(SWO_PORT_LOG) == 0U) {
+		return;
+	}
+	while (ITM->PORT[SWO_PORT_LOG].u32 == 0UL) {
+	}
+	ITM->PORT[SWO_PORT_LOG].u8 = ch;
+}
+
+/**
+ * @brief Writes one event word to SWO_PORT_EVENT.
+ */
+void Swo_Event(uint32_t id, uint32_t value) {
+	if (Swo_PortOn(SWO_PORT_EVENT) == 0U) {
+		return;
+	}
+	while (ITM->PORT[SWO_PORT_EVENT].u32 == 0UL) {
+	}
+	ITM->PORT[SWO_PORT_EVENT].u32 = (id << 24) | (value & 0x00FFFFFFUL);
+}
+
+/**
+ * @brief Writes a reading as a telemetry frame to SWO_PORT_READING.
+ */
+void Swo_Reading(const dht11_reading_t *reading) {
+	uint8_t frame[TELEMETRY_COBS_MAX(TELEMETRY_READING_LEN)];
+	uint32_t len;
+
+	if (Swo_PortOn(SWO_PORT_READING) == 0U) {
+		return;
+	}
+	len = Telemetry_EncodeReading(reading, frame);
+	Swo_Write(SWO_PORT_READING, frame, len);
+}
+
+#endif /* SWO_USE_ITM */
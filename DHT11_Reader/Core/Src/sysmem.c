@@ -23,6 +23,28 @@
 /* Includes */
 #include <errno.h>
 #include <stdint.h>
+#include <stddef.h>
+#include "app_pools.h"
+
+#if APP_NO_HEAP
+
+/**
+ * Never defined: the link fails with this name if the heap is used
+ */
+extern void *APP_NO_HEAP_malloc_is_linked(ptrdiff_t incr);
+
+/**
+ * @brief _sbrk() of the heap-free build (app_pools.h). Only the C library
+ *        allocator calls it, and --gc-sections drops it when none is linked.
+ * @param incr Memory size
+ * @return Does not link
+ */
+void *_sbrk(ptrdiff_t incr)
+{
+  return APP_NO_HEAP_malloc_is_linked(incr);
+}
+
+#else
 
 /**
  * Pointer to the current high watermark of the heap usage
@@ -78,3 +100,5 @@ void *_sbrk(ptrdiff_t incr)
 
   return (void *)prev_heap_end;
 }
+
+#endif /* APP_NO_HEAP */
@@ -0,0 +1,92 @@
+/**
+ ******************************************************************************
+ * @file           : systime.c
+ * @brief          : System timestamp service on the 32-bit TIM5 counter.
+ *
+ *                   SysTime_Now64() = wraps << 32 | CNT, where a wrap whose
+ *                   update interrupt is still pending is counted from the
+ *                   flag. The sections are a few instructions under
+ *                   __disable_irq(): TIM5 and the capture handlers run at
+ *                   level 0, which BASEPRI cannot mask.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "systime.h"
+
+static volatile uint32_t systime_wraps = 0U;
+
+/**
+ * @brief Enables the TIM5 overflow interrupt.
+ */
+void SysTime_Init(void) {
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	systime_wraps = 0U;
+	SYSTIME_TIM->CR1 |= TIM_CR1_URS; /* UG restarts do not raise UIF */
+	SYSTIME_TIM->SR = ~TIM_SR_UIF;
+	SYSTIME_TIM->DIER |= TIM_DIER_UIE;
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @brief Monotonic microseconds since TIM5 started.
+ */
+uint64_t SysTime_Now64(void) {
+	uint32_t primask = __get_PRIMASK();
+	uint32_t wraps;
+	uint32_t cnt;
+
+	__disable_irq();
+	wraps = systime_wraps;
+	cnt = SYSTIME_TIM->CNT;
+	/* Wrapped but not yet serviced; a count read just before the wrap is
+	 * still in the upper half */
+	if (((SYSTIME_TIM->SR & TIM_SR_UIF) != 0U) && (cnt < 0x80000000U)) {
+		wraps++;
+	}
+	__set_PRIMASK(primask);
+	return ((uint64_t) wraps << 32) | cnt;
+}
+
+/**
+ * @brief Moves the count forward by time TIM5 spent frozen.
+ */
+void SysTime_Advance(uint32_t us) {
+	uint32_t primask = __get_PRIMASK();
+	uint32_t cnt;
+
+	if (us == 0U) {
+		return;
+	}
+	__disable_irq();
+	/* Take a pending wrap here; HAL_TIM_IRQHandler() then finds no flag */
+	if ((SYSTIME_TIM->SR & TIM_SR_UIF) != 0U) {
+		SYSTIME_TIM->SR = ~TIM_SR_UIF;
+		systime_wraps++;
+	}
+	cnt = SYSTIME_TIM->CNT;
+	if ((cnt + us) < cnt) {
+		systime_wraps++; /* A CNT write never raises UIF */
+	}
+	SYSTIME_TIM->CNT = cnt + us;
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @brief Overflows counted so far.
+ */
+uint32_t SysTime_GetWraps(void) {
+	return systime_wraps;
+}
+
+/**
+ * @brief TIM5 update handler.
+ */
+void SysTime_OverflowCallback(void) {
+	systime_wraps++;
+}
@@ -0,0 +1,523 @@
+/**
+ ******************************************************************************
+ * @file           : telemetry.c
+ * @brief          : Compact binary telemetry frames over USART2.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "telemetry.h"
+#include "crc.h"
+#include "dht11_delta.h"
+#include "uart_tx.h"
+#include "wallclock.h"
+#include "dht11_driver.h"
+#include "usb_cdc.h"
+
+/* int8 steps, uint8 run count */
+static const dht11_delta_limits_t telemetry_delta_limits = { -128, 127, 255U,
+		TELEMETRY_DELTA_KEY_EVERY };
+
+static uint16_t telemetry_seq = 0U;
+static uint16_t telemetry_delta_seq = 0U;
+static dht11_delta_enc_t telemetry_delta[TELEMETRY_DELTA_SENSORS];
+
+/** Time of each sensor's last delta packet, as the host reconstructs it */
+static uint32_t telemetry_delta_ms[TELEMETRY_DELTA_SENSORS];
+
+#if WALLCLOCK_USE_SYNC
+/** Wall-clock syncs seen by the last time mark, readings since */
+static uint32_t telemetry_time_syncs = 0U;
+static uint32_t telemetry_time_count = 0U;
+#endif /* WALLCLOCK_USE_SYNC */
+
+_Static_assert(TELEMETRY_BATCH_LEN(TELEMETRY_BATCH_MAX) <= TELEMETRY_PKT_MAX,
+		"batch packet longer than TELEMETRY_PKT_MAX");
+
+/** Pending batch; the packet is built in place */
+static uint8_t telemetry_batch[TELEMETRY_BATCH_LEN(TELEMETRY_BATCH_MAX)];
+static uint32_t telemetry_batch_count = 0U;
+static uint32_t telemetry_batch_opened = 0U;
+static uint16_t telemetry_batch_seq = 0U;
+
+/** Values of the 0x0C packets, in packet order */
+static const telemetry_schema_field_t telemetry_schema_fields[] = {
+	{ TELEMETRY_FIELD_DT, TELEMETRY_ENC_U16, -2, TELEMETRY_UNIT_SECOND },
+	{ TELEMETRY_FIELD_TEMP, TELEMETRY_ENC_I16, -1, TELEMETRY_UNIT_CELSIUS },
+	{ TELEMETRY_FIELD_HUM, TELEMETRY_ENC_U16, -1, TELEMETRY_UNIT_RH }
+};
+
+#define TELEMETRY_SCHEMA_FIELDS \
+	(sizeof(telemetry_schema_fields) / sizeof(telemetry_schema_fields[0]))
+#define TELEMETRY_SCHEMA_PKT_LEN \
+	TELEMETRY_SCHEMA_LEN(TELEMETRY_SCHEMA_FIELDS, DHT11_DRIVER_SENSORS)
+#define TELEMETRY_COMPACT_LEN    (TELEMETRY_COMPACT_HEADER + 6U + 2U)
+
+/** Longest packet Telemetry_Send() frames */
+#define TELEMETRY_SEND_MAX       (TELEMETRY_SCHEMA_PKT_LEN)
+
+_Static_assert((TELEMETRY_SEND_MAX >= TELEMETRY_DELTA_KEY_LEN)
+		&& (TELEMETRY_SEND_MAX >= TELEMETRY_TIME_LEN)
+		&& (TELEMETRY_SEND_MAX >= TELEMETRY_COMPACT_LEN),
+		"Telemetry_Send() frame too short");
+
+/** Schema stream: ID and sensor kinds last described, readings since,
+ * link the schema was sent on, time of the last packet as the host
+ * reconstructs it */
+static uint8_t telemetry_schema_id = 0U;
+static uint8_t telemetry_schema_kind[DHT11_DRIVER_SENSORS];
+static uint8_t telemetry_schema_due = 1U;
+static uint8_t telemetry_schema_seq = 0U;
+static uint32_t telemetry_schema_count = 0U;
+static uint32_t telemetry_schema_link = 0xFFFFFFFFU;
+static uint32_t telemetry_schema_ms = 0U;
+
+static void Telemetry_TimeMark(void);
+
+/**
+ * @brief COBS-encodes a buffer and appends the 0x00 delimiter.
+ */
+uint32_t Telemetry_CobsEncode(const uint8_t *in, uint32_t len, uint8_t *out) {
+	uint32_t code_idx = 0U;
+	uint32_t out_idx = 1U;
+	uint8_t code = 1U;
+	uint32_t i;
+
+	for (i = 0U; i < len; i++) {
+		if (in[i] == 0U) {
+			out[code_idx] = code;
+			code_idx = out_idx++;
+			code = 1U;
+		} else {
+			out[out_idx++] = in[i];
+			code++;
+			if (code == 0xFFU) {
+				out[code_idx] = code;
+				code_idx = out_idx++;
+				code = 1U;
+			}
+		}
+	}
+	out[code_idx] = code;
+	out[out_idx++] = 0x00U;
+	return out_idx;
+}
+
+/**
+ * @brief Builds a complete framed packet for one reading.
+ */
+uint32_t Telemetry_EncodeReading(const dht11_reading_t *reading, uint8_t *out) {
+	uint8_t pkt[TELEMETRY_READING_LEN];
+	uint16_t crc;
+	uint32_t i;
+
+	pkt[0] = TELEMETRY_TYPE_READING;
+	pkt[1] = reading->sensor_id;
+	pkt[2] = (uint8_t) telemetry_seq;
+	pkt[3] = (uint8_t) (telemetry_seq >> 8);
+	pkt[4] = (uint8_t) reading->timestamp_ms;
+	pkt[5] = (uint8_t) (reading->timestamp_ms >> 8);
+	pkt[6] = (uint8_t) (reading->timestamp_ms >> 16);
+	pkt[7] = (uint8_t) (reading->timestamp_ms >> 24);
+	pkt[8] = (uint8_t) reading->status;
+	pkt[9] = reading->retries;
+	for (i = 0U; i < 5U; i++) {
+		pkt[10U + i] = reading->raw[i];
+	}
+	crc = Crc_Ccitt16(pkt, TELEMETRY_READING_LEN - 2U);
+	pkt[15] = (uint8_t) crc;
+	pkt[16] = (uint8_t) (crc >> 8);
+
+	telemetry_seq++;
+	return Telemetry_CobsEncode(pkt, TELEMETRY_READING_LEN, out);
+}
+
+/**
+ * @brief dht11_sink_t that sends the reading as a binary frame.
+ */
+void Telemetry_Sink(const dht11_reading_t *reading) {
+	uint8_t frame[TELEMETRY_COBS_MAX(TELEMETRY_READING_LEN)];
+	uint32_t len;
+
+	Telemetry_TimeMark();
+	len = Telemetry_EncodeReading(reading, frame);
+	(void) UART_TX_Write(frame, len);
+}
+
+/**
+ * @brief Frames and queues a packet whose CRC goes in its last 2 bytes.
+ */
+static void Telemetry_Send(uint8_t *pkt, uint32_t len) {
+	uint8_t frame[TELEMETRY_COBS_MAX(TELEMETRY_SEND_MAX)];
+	uint16_t crc;
+
+	crc = Crc_Ccitt16(pkt, len - 2U);
+	pkt[len - 2U] = (uint8_t) crc;
+	pkt[len - 1U] = (uint8_t) (crc >> 8);
+	len = Telemetry_CobsEncode(pkt, len, frame);
+	(void) UART_TX_Write(frame, len);
+}
+
+/**
+ * @brief Sends a time mark when the wall clock was synced since the last
+ *        one or TELEMETRY_TIME_EVERY readings went by.
+ */
+static void Telemetry_TimeMark(void) {
+#if WALLCLOCK_USE_SYNC
+	uint8_t pkt[TELEMETRY_TIME_LEN];
+	wallclock_stats_t stats;
+	uint32_t tick;
+	uint32_t secs;
+	uint32_t ms;
+
+	if (Wallclock_IsSynced() == 0U) {
+		return;
+	}
+	Wallclock_GetStats(&stats);
+	if ((stats.syncs == telemetry_time_syncs)
+			&& (++telemetry_time_count < TELEMETRY_TIME_EVERY)) {
+		return;
+	}
+	telemetry_time_syncs = stats.syncs;
+	telemetry_time_count = 0U;
+
+	tick = HAL_GetTick();
+	secs = Wallclock_FromTick(tick, &ms);
+	pkt[0] = TELEMETRY_TYPE_TIME;
+	pkt[1] = (stats.slew_ms != 0U) ? 1U : 0U;
+	pkt[2] = (uint8_t) tick;
+	pkt[3] = (uint8_t) (tick >> 8);
+	pkt[4] = (uint8_t) (tick >> 16);
+	pkt[5] = (uint8_t) (tick >> 24);
+	pkt[6] = (uint8_t) secs;
+	pkt[7] = (uint8_t) (secs >> 8);
+	pkt[8] = (uint8_t) (secs >> 16);
+	pkt[9] = (uint8_t) (secs >> 24);
+	pkt[10] = (uint8_t) ms;
+	pkt[11] = (uint8_t) (ms >> 8);
+	Telemetry_Send(pkt, TELEMETRY_TIME_LEN);
+#endif /* WALLCLOCK_USE_SYNC */
+}
+
+/**
+ * @brief dht11_sink_t that sends keyframes, steps and runs.
+ */
+void Telemetry_DeltaSink(const dht11_reading_t *reading) {
+	uint8_t pkt[TELEMETRY_DELTA_KEY_LEN];
+	dht11_delta_t d;
+	uint32_t id = reading->sensor_id;
+	uint32_t dt;
+	uint32_t flags = 0U;
+
+	if ((reading->status != DHT11_OK) || (id >= TELEMETRY_DELTA_SENSORS)) {
+		Telemetry_Sink(reading);
+		return;
+	}
+	Telemetry_TimeMark();
+
+	/* Step packets carry the time since the last packet in 10 ms units */
+	dt = (reading->timestamp_ms - telemetry_delta_ms[id]) / 10U;
+	if (dt > 0xFFFFU) {
+		flags = DHT11_DELTA_FORCE_KEY;
+	}
+	if (DHT11_Delta_Encode(&telemetry_delta[id], &telemetry_delta_limits,
+			DHT11_Delta_HumTenths(reading), DHT11_Delta_TempTenths(reading),
+			flags, &d) == DHT11_DELTA_RUN) {
+		return;
+	}
+
+	pkt[1] = reading->sensor_id;
+	if (d.kind == DHT11_DELTA_KEY) {
+		pkt[0] = TELEMETRY_TYPE_DELTA_KEY;
+		pkt[2] = (uint8_t) telemetry_delta_seq;
+		pkt[3] = (uint8_t) (telemetry_delta_seq >> 8);
+		pkt[4] = (uint8_t) reading->timestamp_ms;
+		pkt[5] = (uint8_t) (reading->timestamp_ms >> 8);
+		pkt[6] = (uint8_t) (reading->timestamp_ms >> 16);
+		pkt[7] = (uint8_t) (reading->timestamp_ms >> 24);
+		pkt[8] = (uint8_t) d.run;
+		pkt[9] = (uint8_t) d.hum;
+		pkt[10] = (uint8_t) ((uint16_t) d.hum >> 8);
+		pkt[11] = (uint8_t) d.temp;
+		pkt[12] = (uint8_t) ((uint16_t) d.temp >> 8);
+		telemetry_delta_ms[id] = reading->timestamp_ms;
+		Telemetry_Send(pkt, TELEMETRY_DELTA_KEY_LEN);
+	} else {
+		pkt[0] = TELEMETRY_TYPE_DELTA;
+		pkt[2] = (uint8_t) telemetry_delta_seq;
+		pkt[3] = (uint8_t) d.run;
+		pkt[4] = (uint8_t) dt;
+		pkt[5] = (uint8_t) (dt >> 8);
+		pkt[6] = (uint8_t) d.dh;
+		pkt[7] = (uint8_t) d.dtemp;
+		/* Rounded like the host, so the time error does not accumulate */
+		telemetry_delta_ms[id] += dt * 10U;
+		Telemetry_Send(pkt, TELEMETRY_DELTA_LEN);
+	}
+	telemetry_delta_seq++;
+}
+
+/**
+ * @brief Restarts the delta stream.
+ */
+void Telemetry_DeltaReset(void) {
+	uint32_t i;
+
+	for (i = 0U; i < TELEMETRY_DELTA_SENSORS; i++) {
+		DHT11_Delta_Reset(&telemetry_delta[i]);
+	}
+}
+
+/**
+ * @brief Sends the pending batch now, if any.
+ */
+void Telemetry_BatchFlush(void) {
+	uint8_t frame[TELEMETRY_COBS_MAX(TELEMETRY_BATCH_LEN(TELEMETRY_BATCH_MAX))];
+	uint32_t len;
+	uint16_t crc;
+
+	if (telemetry_batch_count == 0U) {
+		return;
+	}
+	len = TELEMETRY_BATCH_LEN(telemetry_batch_count);
+	telemetry_batch[0] = TELEMETRY_TYPE_BATCH;
+	telemetry_batch[1] = (uint8_t) telemetry_batch_count;
+	telemetry_batch[2] = (uint8_t) telemetry_batch_seq;
+	telemetry_batch[3] = (uint8_t) (telemetry_batch_seq >> 8);
+	crc = Crc_Ccitt16(telemetry_batch, len - 2U);
+	telemetry_batch[len - 2U] = (uint8_t) crc;
+	telemetry_batch[len - 1U] = (uint8_t) (crc >> 8);
+
+	/* One ring write: the TX DMA sends the batch in one transfer */
+	len = Telemetry_CobsEncode(telemetry_batch, len, frame);
+	(void) UART_TX_Write(frame, len);
+	telemetry_batch_seq++;
+	telemetry_batch_count = 0U;
+}
+
+/**
+ * @brief dht11_sink_t that adds the reading to the pending batch.
+ */
+void Telemetry_BatchSink(const dht11_reading_t *reading) {
+	uint8_t *p;
+	uint32_t base;
+	uint32_t dt;
+	uint32_t i;
+
+	Telemetry_TimeMark();
+	if (telemetry_batch_count != 0U) {
+		base = (uint32_t) telemetry_batch[4] | ((uint32_t) telemetry_batch[5] << 8)
+				| ((uint32_t) telemetry_batch[6] << 16)
+				| ((uint32_t) telemetry_batch[7] << 24);
+		/* Offsets are 16-bit ms: an older or too distant reading starts
+		 * a new batch */
+		if ((reading->timestamp_ms - base) > 0xFFFFU) {
+			Telemetry_BatchFlush();
+		}
+	}
+	if (telemetry_batch_count == 0U) {
+		telemetry_batch[4] = (uint8_t) reading->timestamp_ms;
+		telemetry_batch[5] = (uint8_t) (reading->timestamp_ms >> 8);
+		telemetry_batch[6] = (uint8_t) (reading->timestamp_ms >> 16);
+		telemetry_batch[7] = (uint8_t) (reading->timestamp_ms >> 24);
+		telemetry_batch_opened = HAL_GetTick();
+		base = reading->timestamp_ms;
+	}
+
+	dt = reading->timestamp_ms - base;
+	p = &telemetry_batch[TELEMETRY_BATCH_HEADER
+			+ (telemetry_batch_count * TELEMETRY_BATCH_SAMPLE)];
+	p[0] = reading->sensor_id;
+	p[1] = (uint8_t) reading->status;
+	p[2] = reading->retries;
+	p[3] = (uint8_t) dt;
+	p[4] = (uint8_t) (dt >> 8);
+	for (i = 0U; i < 5U; i++) {
+		p[5U + i] = reading->raw[i];
+	}
+	telemetry_batch_count++;
+	if (telemetry_batch_count >= TELEMETRY_BATCH_MAX) {
+		Telemetry_BatchFlush();
+	}
+}
+
+/**
+ * @brief Sends the pending batch once TELEMETRY_BATCH_MS old.
+ */
+uint32_t Telemetry_BatchPoll(void) {
+	uint32_t age;
+
+	if (telemetry_batch_count == 0U) {
+		return TELEMETRY_BATCH_MS;
+	}
+	age = HAL_GetTick() - telemetry_batch_opened;
+	if (age >= TELEMETRY_BATCH_MS) {
+		Telemetry_BatchFlush();
+		return TELEMETRY_BATCH_MS;
+	}
+	return TELEMETRY_BATCH_MS - age;
+}
+
+/**
+ * @brief Stores a 16-bit value little-endian.
+ */
+static void Telemetry_Put16(uint8_t *p, uint16_t value) {
+	p[0] = (uint8_t) value;
+	p[1] = (uint8_t) (value >> 8);
+}
+
+/**
+ * @brief Sends a window summary (0x09).
+ */
+void Telemetry_SendSummary(const dht11_agg_summary_t *summary) {
+	uint8_t pkt[TELEMETRY_SUMMARY_LEN];
+	uint8_t frame[TELEMETRY_COBS_MAX(TELEMETRY_SUMMARY_LEN)];
+	uint32_t len;
+	uint16_t crc;
+
+	Telemetry_TimeMark();
+	pkt[0] = TELEMETRY_TYPE_SUMMARY;
+	pkt[1] = summary->sensor_id;
+	pkt[2] = summary->window;
+	pkt[3] = summary->utc;
+	pkt[4] = (uint8_t) summary->start_ms;
+	pkt[5] = (uint8_t) (summary->start_ms >> 8);
+	pkt[6] = (uint8_t) (summary->start_ms >> 16);
+	pkt[7] = (uint8_t) (summary->start_ms >> 24);
+	pkt[8] = (uint8_t) summary->window_s;
+	pkt[9] = (uint8_t) (summary->window_s >> 8);
+	pkt[10] = (uint8_t) (summary->window_s >> 16);
+	pkt[11] = (uint8_t) (summary->window_s >> 24);
+	Telemetry_Put16(&pkt[12], summary->count);
+	Telemetry_Put16(&pkt[14], summary->failures);
+	Telemetry_Put16(&pkt[16], (uint16_t) summary->temp_min);
+	Telemetry_Put16(&pkt[18], (uint16_t) summary->temp_mean);
+	Telemetry_Put16(&pkt[20], (uint16_t) summary->temp_max);
+	Telemetry_Put16(&pkt[22], (uint16_t) summary->hum_min);
+	Telemetry_Put16(&pkt[24], (uint16_t) summary->hum_mean);
+	Telemetry_Put16(&pkt[26], (uint16_t) summary->hum_max);
+	crc = Crc_Ccitt16(pkt, TELEMETRY_SUMMARY_LEN - 2U);
+	Telemetry_Put16(&pkt[28], crc);
+
+	len = Telemetry_CobsEncode(pkt, TELEMETRY_SUMMARY_LEN, frame);
+	(void) UART_TX_Write(frame, len);
+}
+
+/**
+ * @brief Schema kind of one sensor's driver.
+ */
+static uint8_t Telemetry_SensorKind(uint8_t sensor_id) {
+	return (DHT11_Driver_Get(sensor_id) == &dht11_driver_dht22) ?
+			TELEMETRY_SENSOR_DHT22 : TELEMETRY_SENSOR_DHT11;
+}
+
+/**
+ * @brief Sends the schema (0x0B), anchoring the DT chain at a tick.
+ */
+static void Telemetry_SendSchema(uint32_t timestamp_ms) {
+	uint8_t pkt[TELEMETRY_SCHEMA_PKT_LEN];
+	uint8_t *p;
+	uint32_t i;
+
+	pkt[0] = TELEMETRY_TYPE_SCHEMA;
+	pkt[1] = telemetry_schema_id;
+	pkt[2] = telemetry_schema_seq++;
+	pkt[3] = (uint8_t) TELEMETRY_SCHEMA_FIELDS;
+	pkt[4] = (uint8_t) DHT11_DRIVER_SENSORS;
+	pkt[5] = (uint8_t) timestamp_ms;
+	pkt[6] = (uint8_t) (timestamp_ms >> 8);
+	pkt[7] = (uint8_t) (timestamp_ms >> 16);
+	pkt[8] = (uint8_t) (timestamp_ms >> 24);
+	p = &pkt[TELEMETRY_SCHEMA_HEADER];
+	for (i = 0U; i < TELEMETRY_SCHEMA_FIELDS; i++) {
+		*p++ = telemetry_schema_fields[i].id;
+		*p++ = telemetry_schema_fields[i].enc;
+		*p++ = (uint8_t) telemetry_schema_fields[i].scale;
+		*p++ = telemetry_schema_fields[i].unit;
+	}
+	for (i = 0U; i < DHT11_DRIVER_SENSORS; i++) {
+		*p++ = (uint8_t) i;
+		*p++ = telemetry_schema_kind[i];
+	}
+	Telemetry_Send(pkt, TELEMETRY_SCHEMA_PKT_LEN);
+
+	telemetry_schema_ms = timestamp_ms;
+	telemetry_schema_count = 0U;
+	telemetry_schema_due = 0U;
+}
+
+/**
+ * @brief Sends the schema first when it changed, the host may have just
+ *        connected, the DT chain cannot reach the reading, or
+ *        TELEMETRY_SCHEMA_EVERY readings went by.
+ */
+static void Telemetry_SchemaCheck(uint32_t timestamp_ms) {
+	uint32_t link;
+	uint32_t i;
+	uint8_t kind;
+	uint8_t changed = 0U;
+
+	for (i = 0U; i < DHT11_DRIVER_SENSORS; i++) {
+		kind = Telemetry_SensorKind((uint8_t) i);
+		if (kind != telemetry_schema_kind[i]) {
+			telemetry_schema_kind[i] = kind;
+			changed = 1U;
+		}
+	}
+	if (changed != 0U) {
+		telemetry_schema_id++;
+		telemetry_schema_due = 1U;
+	}
+	/* A transport switch or a CDC port opening is a new listener */
+	link = (uint32_t) UART_TX_GetTransport() | ((uint32_t) Usb_Cdc_IsOpen() << 8);
+	if (link != telemetry_schema_link) {
+		telemetry_schema_link = link;
+		telemetry_schema_due = 1U;
+	}
+	if ((++telemetry_schema_count >= TELEMETRY_SCHEMA_EVERY)
+			|| ((int32_t) (timestamp_ms - telemetry_schema_ms) < 0)
+			|| (((timestamp_ms - telemetry_schema_ms) / 10U) > 0xFFFFU)) {
+		telemetry_schema_due = 1U;
+	}
+	if (telemetry_schema_due != 0U) {
+		Telemetry_SendSchema(timestamp_ms);
+	}
+}
+
+/**
+ * @brief dht11_sink_t that sends the values laid out by the schema.
+ */
+void Telemetry_SchemaSink(const dht11_reading_t *reading) {
+	uint8_t pkt[TELEMETRY_COMPACT_LEN];
+	uint32_t dt;
+
+	if ((reading->status != DHT11_OK)
+			|| (reading->sensor_id >= DHT11_DRIVER_SENSORS)) {
+		Telemetry_Sink(reading);
+		return;
+	}
+	Telemetry_TimeMark();
+	Telemetry_SchemaCheck(reading->timestamp_ms);
+
+	dt = (reading->timestamp_ms - telemetry_schema_ms) / 10U;
+	pkt[0] = TELEMETRY_TYPE_COMPACT;
+	pkt[1] = telemetry_schema_id;
+	pkt[2] = reading->sensor_id;
+	pkt[3] = telemetry_schema_seq++;
+	Telemetry_Put16(&pkt[4], (uint16_t) dt);
+	Telemetry_Put16(&pkt[6], (uint16_t) DHT11_Delta_TempTenths(reading));
+	Telemetry_Put16(&pkt[8], (uint16_t) DHT11_Delta_HumTenths(reading));
+	/* Rounded like the host, so the time error does not accumulate */
+	telemetry_schema_ms += dt * 10U;
+	Telemetry_Send(pkt, TELEMETRY_COMPACT_LEN);
+}
+
+/**
+ * @brief Sends the schema before the next reading.
+ */
+void Telemetry_SchemaReset(void) {
+	telemetry_schema_due = 1U;
+}
@@ -0,0 +1,104 @@
+/**
+ ******************************************************************************
+ * @file           : tickless.c
+ * @brief          : Tickless HAL timebase: no 1 kHz SysTick interrupt.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "tickless.h"
+#include "systime.h"
+
+#if TICKLESS_IS_ACTIVE
+
+/* SysTime_Now64() + tickless_base_us is the HAL time in microseconds */
+static uint64_t tickless_base_us = 0U;
+static volatile uint8_t tickless_started = 0U;
+
+/**
+ * @brief HAL_InitTick() of the HAL, SysTick at 1 kHz, until
+ *        Tickless_Start(); afterwards clock changes leave SysTick off.
+ */
+HAL_StatusTypeDef HAL_InitTick(uint32_t TickPriority) {
+	if (TickPriority >= (1UL << __NVIC_PRIO_BITS)) {
+		return HAL_ERROR;
+	}
+	uwTickPrio = TickPriority;
+	if (tickless_started != 0U) {
+		return HAL_OK;
+	}
+	if (HAL_SYSTICK_Config(SystemCoreClock / (1000U / uwTickFreq)) > 0U) {
+		return HAL_ERROR;
+	}
+	HAL_NVIC_SetPriority(SysTick_IRQn, TickPriority, 0U);
+	return HAL_OK;
+}
+
+/**
+ * @brief Milliseconds: SysTick's count until Tickless_Start(), TIM5's after.
+ */
+uint32_t HAL_GetTick(void) {
+	if (tickless_started == 0U) {
+		return uwTick;
+	}
+	return (uint32_t) ((SysTime_Now64() + tickless_base_us) / 1000U);
+}
+
+/**
+ * @brief Stops SysTick and moves HAL_GetTick() onto TIM5.
+ */
+void Tickless_Start(void) {
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	SysTick->CTRL = 0U;
+	SCB->ICSR = SCB_ICSR_PENDSTCLR_Msk;
+	/* Wraps modulo 2^64 to the same sum: the count goes on from uwTick */
+	tickless_base_us = ((uint64_t) uwTick * 1000U) - SysTime_Now64();
+	tickless_started = 1U;
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @brief Arms the TIM5 channel 3 wakeup us from now.
+ */
+void Tickless_ArmWakeup(uint32_t us) {
+	TIM_TypeDef *tim = SYSTIME_TIM;
+	uint32_t primask = __get_PRIMASK();
+	uint32_t due;
+
+	if (tickless_started == 0U) {
+		return;
+	}
+	if (us > TICKLESS_MAX_SLEEP_US) {
+		us = TICKLESS_MAX_SLEEP_US;
+	}
+	/* DIER is shared with the capture level: no read-modify-write races */
+	__disable_irq();
+	due = tim->CNT + us;
+	tim->CCR3 = due;
+	tim->SR = ~TIM_SR_CC3IF;
+	tim->DIER |= TIM_DIER_CC3IE;
+	if ((int32_t) (due - tim->CNT) <= 0) {
+		tim->EGR = TIM_EGR_CC3G; /* Passed already: wake at once */
+	}
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @brief Disarms the wakeup.
+ */
+void Tickless_DisarmWakeup(void) {
+	TIM_TypeDef *tim = SYSTIME_TIM;
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	tim->DIER &= ~TIM_DIER_CC3IE;
+	tim->SR = ~TIM_SR_CC3IF;
+	__set_PRIMASK(primask);
+}
+
+#endif /* TICKLESS_IS_ACTIVE */
@@ -0,0 +1,236 @@
+/**
+ ******************************************************************************
+ * @file           : timebase.c
+ * @brief          : Clock-aware microsecond timebase.
+ *
+ *                   Timebase_Micros64() = us_base + (cyc64 - cyc_base) / cpu
+ *                   where cyc_base/us_base are re-anchored on every
+ *                   recalibration, so a clock switch never makes time jump.
+ *
+ *                   The delay overhead is the smallest excess over a
+ *                   TIMEBASE_CAL_CYCLES spin in TIMEBASE_CAL_RUNS tries, so
+ *                   a cache or flash stall during calibration does not
+ *                   shorten later delays.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "timebase.h"
+#include "clock_config.h"
+#include "tickless.h"
+
+extern TIM_HandleTypeDef htim6;
+
+/** Largest busy-wait chunk; 1 s * 180 cycles/us still fits in 32 bits */
+#define TIMEBASE_CHUNK_US   (1000000U)
+
+/** Spin the overhead is measured over; long enough to enter the loop */
+#define TIMEBASE_CAL_CYCLES (200U)
+#define TIMEBASE_CAL_RUNS   (8U)
+
+static uint32_t tb_cycles_per_us = 16U;
+static uint32_t tb_cycles_per_ns_q16 = (16U << 16) / 1000U;
+static uint32_t tb_delay_overhead = 0U;
+static uint32_t tb_delay_us_overhead = 0U;
+static uint32_t tb_cyc_high = 0U;
+static uint32_t tb_cyc_last = 0U;
+static uint64_t tb_cyc_base = 0U;
+static uint64_t tb_us_base = 0U;
+
+/**
+ * @brief Enables the DWT cycle counter. Idempotent.
+ */
+void Timebase_EnableCycleCounter(void) {
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+ * @brief Caches the clock factors, enables DWT and starts TIM6.
+ */
+void Timebase_Init(void) {
+	Timebase_EnableCycleCounter();
+	tb_cycles_per_us = HAL_RCC_GetHCLKFreq() / 1000000U;
+	tb_cycles_per_ns_q16 = (tb_cycles_per_us << 16) / 1000U;
+	tb_cyc_high = 0U;
+	tb_cyc_last = DWT->CYCCNT;
+	tb_cyc_base = Timebase_Cycles64();
+	tb_us_base = 0U;
+	(void) Timebase_CalibrateDelay();
+
+	if (HAL_TIM_Base_Start_IT(&htim6) != HAL_OK) {
+		Error_Handler();
+	}
+}
+
+/**
+ * @brief Re-reads HCLK after a clock change.
+ */
+void Timebase_Recalibrate(void) {
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	tb_us_base = Timebase_Micros64();
+	tb_cyc_base = Timebase_Cycles64();
+	tb_cycles_per_us = HAL_RCC_GetHCLKFreq() / 1000000U;
+	tb_cycles_per_ns_q16 = (tb_cycles_per_us << 16) / 1000U;
+	__set_PRIMASK(primask);
+	/* Flash wait states, and so the overhead, change with the profile */
+	(void) Timebase_CalibrateDelay();
+}
+
+/**
+ * @brief Measures the cost of the delays around their spin.
+ */
+uint32_t Timebase_CalibrateDelay(void) {
+	uint32_t primask = __get_PRIMASK();
+	uint32_t inline_min = UINT32_MAX;
+	uint32_t call_min = UINT32_MAX;
+	uint32_t start;
+	uint32_t cycles;
+	uint32_t i;
+
+	__disable_irq();
+	tb_delay_overhead = 0U;
+	tb_delay_us_overhead = 0U;
+	for (i = 0U; i < TIMEBASE_CAL_RUNS; i++) {
+		start = DWT->CYCCNT;
+		Timebase_DelayCycles(TIMEBASE_CAL_CYCLES);
+		cycles = DWT->CYCCNT - start;
+		if (cycles < inline_min) {
+			inline_min = cycles;
+		}
+		start = DWT->CYCCNT;
+		Timebase_DelayUs(1U);
+		cycles = DWT->CYCCNT - start;
+		if (cycles < call_min) {
+			call_min = cycles;
+		}
+	}
+	tb_delay_overhead = (inline_min > TIMEBASE_CAL_CYCLES) ?
+			(inline_min - TIMEBASE_CAL_CYCLES) : 0U;
+	tb_delay_us_overhead = (call_min > tb_cycles_per_us) ?
+			(call_min - tb_cycles_per_us) : 0U;
+	__set_PRIMASK(primask);
+	return tb_delay_overhead;
+}
+
+/**
+ * @brief Overhead of the inline delays in cycles.
+ */
+RAMFUNC uint32_t Timebase_DelayOverhead(void) {
+	return tb_delay_overhead;
+}
+
+/**
+ * @brief Cached HCLK cycles per nanosecond, Q16.
+ */
+RAMFUNC uint32_t Timebase_CyclesPerNsQ16(void) {
+	return tb_cycles_per_ns_q16;
+}
+
+/**
+ * @brief TIM6 prescaler for a TIMEBASE_TIM6_HZ count rate.
+ */
+uint32_t Timebase_TIM6Prescaler(void) {
+	return (Clock_GetApb1TimerHz() / TIMEBASE_TIM6_HZ) - 1U;
+}
+
+/**
+ * @brief Cached HCLK cycles per microsecond.
+ */
+RAMFUNC uint32_t Timebase_CyclesPerUs(void) {
+	return tb_cycles_per_us;
+}
+
+/**
+ * @brief 64-bit extension of DWT CYCCNT.
+ */
+uint64_t Timebase_Cycles64(void) {
+	uint32_t primask = __get_PRIMASK();
+	uint32_t now;
+	uint64_t cycles;
+
+	__disable_irq();
+	now = DWT->CYCCNT;
+	if (now < tb_cyc_last) {
+		tb_cyc_high++;
+	}
+	tb_cyc_last = now;
+	cycles = ((uint64_t) tb_cyc_high << 32) | now;
+	__set_PRIMASK(primask);
+	return cycles;
+}
+
+/**
+ * @brief Monotonic microseconds since Timebase_Init().
+ */
+uint64_t Timebase_Micros64(void) {
+	return tb_us_base + ((Timebase_Cycles64() - tb_cyc_base) / tb_cycles_per_us);
+}
+
+/**
+ * @brief Low 32 bits of Timebase_Micros64().
+ */
+uint32_t Timebase_Micros(void) {
+	return (uint32_t) Timebase_Micros64();
+}
+
+/**
+ * @brief Busy-waits on DWT CYCCNT.
+ */
+RAMFUNC void Timebase_DelayUs(uint32_t us) {
+	uint32_t overhead = tb_delay_us_overhead;
+	uint32_t start;
+	uint32_t ticks;
+	uint32_t step;
+
+	while (us > 0U) {
+		step = (us > TIMEBASE_CHUNK_US) ? TIMEBASE_CHUNK_US : us;
+		ticks = step * tb_cycles_per_us;
+		ticks = (ticks > overhead) ? (ticks - overhead) : 0U;
+		overhead = 0U;
+		start = DWT->CYCCNT;
+		while ((DWT->CYCCNT - start) < ticks) {
+			/* spin */
+		}
+		us -= step;
+	}
+}
+
+/**
+ * @brief Sleeps until close to the deadline, then spins.
+ */
+void Timebase_SleepUs(uint32_t us) {
+	uint64_t deadline = Timebase_Micros64() + us;
+	uint64_t now = Timebase_Micros64();
+
+	/* SysTick (1 ms), or the tickless wakeup, and TIM6 update bound each
+	 * WFI */
+	if ((deadline - now) > TIMEBASE_SLEEP_SPIN_US) {
+		TICKLESS_ARM_WAKEUP((uint32_t) (deadline - now) - TIMEBASE_SLEEP_SPIN_US);
+	}
+	while ((deadline - now) > TIMEBASE_SLEEP_SPIN_US) {
+		__WFI();
+		now = Timebase_Micros64();
+		if (now >= deadline) {
+			TICKLESS_DISARM_WAKEUP();
+			return;
+		}
+	}
+	TICKLESS_DISARM_WAKEUP();
+	if (deadline > now) {
+		Timebase_DelayUs((uint32_t) (deadline - now));
+	}
+}
+
+/**
+ * @brief TIM6 update handler.
+ */
+void Timebase_TIM6UpdateCallback(void) {
+	/* Touching the extension every 65.536 ms keeps wrap detection valid */
+	(void) Timebase_Cycles64();
+}
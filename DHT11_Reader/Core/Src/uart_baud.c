@@ -0,0 +1,235 @@
+/**
+ ******************************************************************************
+ * @file           : uart_baud.c
+ * @brief          : USART2 baud profiles and runtime rate negotiation.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "uart_baud.h"
+#include "uart_tx.h"
+#include "uart_rx.h"
+#include <stdio.h>
+
+/** Time allowed for the TX ring and the shift register to drain */
+#define UART_BAUD_DRAIN_MS (100U)
+
+extern UART_HandleTypeDef huart2;
+
+static const uint32_t baud_profiles[] = UART_BAUD_PROFILES;
+
+#define UART_BAUD_PROFILE_COUNT (sizeof(baud_profiles) / sizeof(baud_profiles[0]))
+
+static uint32_t baud_current = UART_BAUD_DEFAULT;
+static uint32_t baud_previous = UART_BAUD_DEFAULT;
+static uint8_t baud_over8 = 0U;
+static uint8_t baud_pending = 0U;
+static uint32_t baud_deadline_ms = 0U;
+static uint32_t baud_errors = 0U;    /* UART_RX_GetErrors() at the switch */
+
+/**
+ * @brief Divider and oversampling for a rate at the current PCLK1.
+ * @retval 1 if the rate is within UART_BAUD_MAX_ERROR_PPM.
+ */
+static uint8_t UART_Baud_Divider(uint32_t baud, uint32_t *n, uint8_t *over8) {
+	uint32_t pclk = HAL_RCC_GetPCLK1Freq();
+	uint32_t actual;
+	uint32_t err;
+
+	if (baud == 0U) {
+		return 0U;
+	}
+	*n = (pclk + (baud / 2U)) / baud;
+	if (*n < 8U) {
+		return 0U;
+	}
+	*over8 = (*n < 16U) ? 1U : 0U;
+	actual = pclk / *n;
+	err = (actual > baud) ? (actual - baud) : (baud - actual);
+	return ((((uint64_t) err * 1000000U) / baud) <= UART_BAUD_MAX_ERROR_PPM) ?
+			1U : 0U;
+}
+
+/**
+ * @brief Reprograms CR1.OVER8 and BRR with UE cleared. Receive DMA stays
+ *        armed across the switch.
+ */
+static uint8_t UART_Baud_Program(uint32_t baud) {
+	uint32_t n;
+	uint8_t over8;
+
+	if (UART_Baud_Divider(baud, &n, &over8) == 0U) {
+		return 0U;
+	}
+	huart2.Instance->CR1 &= ~USART_CR1_UE;
+	if (over8 != 0U) {
+		huart2.Instance->CR1 |= USART_CR1_OVER8;
+		/* OVER8: fraction in BRR[2:0], BRR[3] kept clear */
+		huart2.Instance->BRR = ((n & ~7U) << 1) | (n & 7U);
+		huart2.Init.OverSampling = UART_OVERSAMPLING_8;
+	} else {
+		huart2.Instance->CR1 &= ~USART_CR1_OVER8;
+		huart2.Instance->BRR = n;
+		huart2.Init.OverSampling = UART_OVERSAMPLING_16;
+	}
+	huart2.Instance->CR1 |= USART_CR1_UE;
+	huart2.Init.BaudRate = baud;
+	baud_current = baud;
+	baud_over8 = over8;
+	return 1U;
+}
+
+/**
+ * @brief Lets queued output and the last character leave at the old rate,
+ *        then switches.
+ */
+static uint8_t UART_Baud_Apply(uint32_t baud) {
+	uint32_t start;
+
+	(void) UART_TX_Flush(UART_BAUD_DRAIN_MS);
+	start = HAL_GetTick();
+	while (((huart2.Instance->SR & USART_SR_TC) == 0U)
+			&& ((HAL_GetTick() - start) < UART_BAUD_DRAIN_MS)) {
+	}
+	return UART_Baud_Program(baud);
+}
+
+/**
+ * @brief Applies UART_BAUD_DEFAULT with the best oversampling.
+ */
+void UART_Baud_Init(void) {
+	baud_pending = 0U;
+	if (UART_Baud_Program(UART_BAUD_DEFAULT) == 0U) {
+		Error_Handler();
+	}
+	baud_previous = baud_current;
+}
+
+/**
+ * @brief Current rate.
+ */
+uint32_t UART_Baud_Get(void) {
+	return baud_current;
+}
+
+/**
+ * @brief Reports whether the current rate uses 8x oversampling.
+ */
+uint8_t UART_Baud_IsOver8(void) {
+	return baud_over8;
+}
+
+/**
+ * @brief Number of entries in UART_BAUD_PROFILES.
+ */
+uint32_t UART_Baud_ProfileCount(void) {
+	return UART_BAUD_PROFILE_COUNT;
+}
+
+/**
+ * @brief Rate of one profile, 0 past the end.
+ */
+uint32_t UART_Baud_Profile(uint32_t index) {
+	return (index < UART_BAUD_PROFILE_COUNT) ? baud_profiles[index] : 0U;
+}
+
+/**
+ * @brief Reports whether a rate is a profile reachable from PCLK1.
+ */
+uint8_t UART_Baud_IsSupported(uint32_t baud) {
+	uint32_t n;
+	uint8_t over8;
+	uint32_t i;
+
+	for (i = 0U; i < UART_BAUD_PROFILE_COUNT; i++) {
+		if (baud_profiles[i] == baud) {
+			return UART_Baud_Divider(baud, &n, &over8);
+		}
+	}
+	return 0U;
+}
+
+/**
+ * @brief Drains TX, then switches to a new rate pending confirmation.
+ */
+uint8_t UART_Baud_Propose(uint32_t baud) {
+	uint32_t from = (baud_pending != 0U) ? baud_previous : baud_current;
+
+	if (UART_Baud_IsSupported(baud) == 0U) {
+		return 0U;
+	}
+	if (UART_Baud_Apply(baud) == 0U) {
+		return 0U;
+	}
+	baud_previous = from;
+	baud_errors = UART_RX_GetErrors();
+	baud_deadline_ms = HAL_GetTick() + UART_BAUD_CONFIRM_MS;
+	baud_pending = 1U;
+	return 1U;
+}
+
+/**
+ * @brief Keeps a proposed rate.
+ */
+uint8_t UART_Baud_Confirm(void) {
+	uint8_t was = baud_pending;
+
+	baud_pending = 0U;
+	baud_previous = baud_current;
+	return was;
+}
+
+/**
+ * @brief Switches to a saved rate with no confirmation.
+ */
+uint8_t UART_Baud_Restore(uint32_t baud) {
+	if ((UART_Baud_IsSupported(baud) == 0U) || (UART_Baud_Program(baud) == 0U)) {
+		return 0U;
+	}
+	baud_pending = 0U;
+	baud_previous = baud_current;
+	return 1U;
+}
+
+/**
+ * @brief Reports whether a proposed rate awaits confirmation.
+ */
+uint8_t UART_Baud_IsPending(void) {
+	return baud_pending;
+}
+
+/**
+ * @brief Falls back when the confirmation is late or errors pile up.
+ */
+void UART_Baud_Poll(void) {
+	if (baud_pending == 0U) {
+		return;
+	}
+	if (((int32_t) (HAL_GetTick() - baud_deadline_ms) < 0)
+			&& ((UART_RX_GetErrors() - baud_errors) < UART_BAUD_MAX_ERRORS)) {
+		return;
+	}
+	baud_pending = 0U;
+	(void) UART_Baud_Apply(baud_previous);
+	printf("ERR baud fallback %lu\r\n", baud_current);
+}
+
+/**
+ * @brief Recomputes BRR and oversampling after a PCLK1 change. Output in
+ *        flight is already garbled by the new clock, so nothing is drained.
+ */
+void UART_Baud_ClockChanged(void) {
+	uint32_t n;
+	uint8_t over8;
+
+	if (UART_Baud_Program(baud_current) == 0U) {
+		baud_pending = 0U;
+		(void) UART_Baud_Program(UART_BAUD_DEFAULT);
+	}
+	if (UART_Baud_Divider(baud_previous, &n, &over8) == 0U) {
+		baud_previous = UART_BAUD_DEFAULT;
+	}
+}
@@ -0,0 +1,156 @@
+/**
+ ******************************************************************************
+ * @file           : uart_flow.c
+ * @brief          : RTS/CTS flow control for the USART2 console.
+ *
+ *                   CTS is sampled when the drain is about to start a
+ *                   chunk, under the UART level; its falling edge is taken
+ *                   at the same level, so an edge between the sample and
+ *                   the return still finds the drain idle and restarts it.
+ *                   RTS is written by the RX DMA events and by the thread
+ *                   reading the ring, both as one BSRR store.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "uart_flow.h"
+#include "uart_tx.h"
+#include "uart_rx.h"
+#include "irq_prio.h"
+
+#define UART_FLOW_CTS_PIN   (1UL << UART_FLOW_CTS_PIN_NUM)
+#define UART_FLOW_RTS_PIN   (1UL << UART_FLOW_RTS_PIN_NUM)
+
+/** Unread RX bytes at which RTS goes high */
+#define UART_FLOW_RTS_FILL  (UART_RX_BUFFER_SIZE / 2U)
+
+static volatile uint8_t flow_on = 0U;
+static volatile uint8_t flow_rts_ready = 1U;
+static volatile uint32_t flow_cts_waits = 0U;
+static volatile uint32_t flow_rts_holds = 0U;
+
+/**
+ * @brief Drives RTS: low to let the host send, high to hold it.
+ */
+static void UART_Flow_Rts(uint8_t ready) {
+	UART_FLOW_RTS_GPIO_Port->BSRR = (ready != 0U) ?
+			(UART_FLOW_RTS_PIN << 16U) : UART_FLOW_RTS_PIN;
+	if ((ready == 0U) && (flow_rts_ready != 0U)) {
+		flow_rts_holds++;
+	}
+	flow_rts_ready = ready;
+}
+
+/**
+ * @brief Configures the pins and EXTI5 and applies the default.
+ */
+void UART_Flow_Init(void) {
+	__HAL_RCC_GPIOA_CLK_ENABLE();
+	__HAL_RCC_GPIOB_CLK_ENABLE();
+	__HAL_RCC_SYSCFG_CLK_ENABLE();
+
+	/* RTS low before the pin drives, so the host never sees a hold */
+	UART_FLOW_RTS_GPIO_Port->BSRR = UART_FLOW_RTS_PIN << 16U;
+	UART_FLOW_RTS_GPIO_Port->MODER = (UART_FLOW_RTS_GPIO_Port->MODER
+			& ~(GPIO_MODER_MODER0 << (2U * UART_FLOW_RTS_PIN_NUM)))
+			| (GPIO_MODER_MODER0_0 << (2U * UART_FLOW_RTS_PIN_NUM));
+	UART_FLOW_RTS_GPIO_Port->OTYPER &= ~UART_FLOW_RTS_PIN;
+
+	UART_FLOW_CTS_GPIO_Port->MODER &=
+			~(GPIO_MODER_MODER0 << (2U * UART_FLOW_CTS_PIN_NUM));
+	UART_FLOW_CTS_GPIO_Port->PUPDR = (UART_FLOW_CTS_GPIO_Port->PUPDR
+			& ~(GPIO_PUPDR_PUPDR0 << (2U * UART_FLOW_CTS_PIN_NUM)))
+			| (GPIO_PUPDR_PUPDR0_1 << (2U * UART_FLOW_CTS_PIN_NUM)); /* Pull-down */
+
+	SYSCFG->EXTICR[UART_FLOW_CTS_PIN_NUM / 4U] =
+			(SYSCFG->EXTICR[UART_FLOW_CTS_PIN_NUM / 4U]
+					& ~(0xFUL << (4U * (UART_FLOW_CTS_PIN_NUM % 4U))))
+					| (1UL << (4U * (UART_FLOW_CTS_PIN_NUM % 4U))); /* Port B */
+	EXTI->FTSR |= UART_FLOW_CTS_PIN;
+	EXTI->RTSR &= ~UART_FLOW_CTS_PIN;
+	EXTI->EMR &= ~UART_FLOW_CTS_PIN;
+	EXTI->PR = UART_FLOW_CTS_PIN;
+	EXTI->IMR |= UART_FLOW_CTS_PIN; /* Also wakes from STOP */
+	HAL_NVIC_SetPriority(EXTI9_5_IRQn, IRQ_PRIO_UART, 0U);
+	HAL_NVIC_EnableIRQ(EXTI9_5_IRQn);
+
+	flow_cts_waits = 0U;
+	flow_rts_holds = 0U;
+	UART_Flow_SetOn(UART_FLOW_DEFAULT_ON);
+}
+
+/**
+ * @brief Turns flow control on or off.
+ */
+void UART_Flow_SetOn(uint8_t on) {
+	uint32_t basepri = Irq_MaskFrom(IRQ_PRIO_UART);
+
+	flow_on = (on != 0U) ? 1U : 0U;
+	UART_Flow_Rts(1U);
+	Irq_Unmask(basepri);
+	UART_TX_Resume(); /* Whatever CTS held back goes now */
+}
+
+/**
+ * @brief Reports whether flow control is on.
+ */
+uint8_t UART_Flow_IsOn(void) {
+	return flow_on;
+}
+
+/**
+ * @brief Reports whether a chunk may start.
+ */
+uint8_t UART_Flow_IsClear(void) {
+	if ((flow_on == 0U)
+			|| ((UART_FLOW_CTS_GPIO_Port->IDR & UART_FLOW_CTS_PIN) == 0U)) {
+		return 1U;
+	}
+	flow_cts_waits++;
+	return 0U;
+}
+
+/**
+ * @brief Largest chunk the TX drain may start.
+ */
+uint32_t UART_Flow_ChunkMax(void) {
+	return (flow_on != 0U) ? UART_FLOW_CHUNK : 0U;
+}
+
+/**
+ * @brief Drives RTS from the unread RX bytes.
+ */
+void UART_Flow_RxFill(uint32_t unread) {
+	uint8_t ready = ((flow_on == 0U) || (unread < UART_FLOW_RTS_FILL)) ?
+			1U : 0U;
+
+	if (ready != flow_rts_ready) {
+		UART_Flow_Rts(ready);
+	}
+}
+
+/**
+ * @brief Fills the flow control state.
+ */
+void UART_Flow_GetStats(uart_flow_stats_t *stats) {
+	stats->cts_waits = flow_cts_waits;
+	stats->rts_holds = flow_rts_holds;
+	stats->on = flow_on;
+	stats->cts_clear = ((UART_FLOW_CTS_GPIO_Port->IDR & UART_FLOW_CTS_PIN)
+			== 0U) ? 1U : 0U;
+	stats->rts_ready = flow_rts_ready;
+}
+
+/**
+ * @brief EXTI lines 9..5: CTS fell, restart the drain.
+ */
+void UART_Flow_IRQHandler(void) {
+	if ((EXTI->PR & UART_FLOW_CTS_PIN) == 0U) {
+		return;
+	}
+	EXTI->PR = UART_FLOW_CTS_PIN;
+	UART_TX_Resume();
+}
@@ -0,0 +1,124 @@
+/**
+ ******************************************************************************
+ * @file           : uart_rx.c
+ * @brief          : Circular-DMA USART2 receive path with IDLE-line events.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "uart_rx.h"
+#include "memmap.h"
+#include "uart_flow.h"
+#include "irq_prio.h"
+
+extern UART_HandleTypeDef huart2;
+
+static uint8_t rx_buffer[UART_RX_BUFFER_SIZE] DMA_BUFFER;
+static uint32_t rx_tail = 0U;
+static volatile uint8_t rx_event = 0U;
+static volatile uint32_t rx_errors = 0U;
+
+/**
+ * @brief (Re)starts circular reception from the start of the ring.
+ */
+static void UART_RX_Start(void) {
+	rx_tail = 0U;
+	if (HAL_UARTEx_ReceiveToIdle_DMA(&huart2, rx_buffer, UART_RX_BUFFER_SIZE)
+			!= HAL_OK) {
+		rx_errors++;
+	}
+}
+
+#if UART_FLOW_USE_RTSCTS
+/**
+ * @brief Bytes between rx_tail and a DMA position.
+ */
+static uint32_t UART_RX_Unread(uint32_t head) {
+	return (head + UART_RX_BUFFER_SIZE - rx_tail) % UART_RX_BUFFER_SIZE;
+}
+#endif /* UART_FLOW_USE_RTSCTS */
+
+/**
+ * @brief Starts circular reception.
+ */
+void UART_RX_Init(void) {
+	rx_event = 0U;
+	UART_RX_Start();
+}
+
+/**
+ * @brief Reports whether a reception event is pending.
+ */
+uint8_t UART_RX_HasEvent(void) {
+	return rx_event;
+}
+
+/**
+ * @brief DMA write position in the ring.
+ */
+uint32_t UART_RX_GetPosition(void) {
+	uint32_t head = UART_RX_BUFFER_SIZE - __HAL_DMA_GET_COUNTER(huart2.hdmarx);
+
+	return (head >= UART_RX_BUFFER_SIZE) ? 0U : head;
+}
+
+/**
+ * @brief Copies out bytes received since the previous call.
+ */
+uint32_t UART_RX_Read(uint8_t *out, uint32_t max) {
+	uint32_t head;
+	uint32_t count = 0U;
+#if UART_FLOW_USE_RTSCTS
+	uint32_t basepri;
+#endif /* UART_FLOW_USE_RTSCTS */
+
+	rx_event = 0U;
+	head = UART_RX_GetPosition();
+
+	while ((rx_tail != head) && (count < max)) {
+		out[count++] = rx_buffer[rx_tail];
+		rx_tail++;
+		if (rx_tail >= UART_RX_BUFFER_SIZE) {
+			rx_tail = 0U;
+		}
+	}
+#if UART_FLOW_USE_RTSCTS
+	basepri = Irq_MaskFrom(IRQ_PRIO_UART);
+	UART_FLOW_RX_FILL(UART_RX_Unread(UART_RX_GetPosition()));
+	Irq_Unmask(basepri);
+#endif /* UART_FLOW_USE_RTSCTS */
+	return count;
+}
+
+/**
+ * @brief Number of receive errors so far.
+ */
+uint32_t UART_RX_GetErrors(void) {
+	return rx_errors;
+}
+
+/**
+ * @brief Reception event handler.
+ */
+void UART_RX_EventCallback(uint16_t pos) {
+	(void) pos;
+	rx_event = 1U;
+	UART_FLOW_RX_FILL(UART_RX_Unread((pos >= UART_RX_BUFFER_SIZE) ? 0U : pos));
+}
+
+/**
+ * @brief Error handler.
+ */
+void UART_RX_ErrorCallback(void) {
+	if ((huart2.ErrorCode & (HAL_UART_ERROR_ORE | HAL_UART_ERROR_FE
+			| HAL_UART_ERROR_NE | HAL_UART_ERROR_DMA)) == 0U) {
+		return;
+	}
+	rx_errors++;
+	if (huart2.RxState == HAL_UART_STATE_READY) {
+		UART_RX_Start();
+	}
+}
@@ -0,0 +1,474 @@
+/**
+ ******************************************************************************
+ * @file           : uart_tx.c
+ * @brief          : Ring-buffered, DMA-drained USART2 transmit path.
+ *
+ *                   Indices are free-running 32-bit counters masked on
+ *                   access:
+ *                     [tx_tail, tx_tail + tx_inflight)  owned by the DMA
+ *                     [tx_tail + tx_inflight, tx_head)  queued
+ *                   The DMA always sends one contiguous chunk; when it
+ *                   completes the next chunk (possibly the wrapped part) is
+ *                   started from the interrupt. With flow control a
+ *                   chunk starts only while CTS is low (uart_flow.h).
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "uart_tx.h"
+#include "irq_prio.h"
+#include "memmap.h"
+#include "fmt.h"
+#include "usb_cdc.h"
+#include "uart_flow.h"
+#include <stdio.h>
+#include <string.h>
+
+#define UART_TX_MASK (UART_TX_BUFFER_SIZE - 1U)
+
+#if APP_USE_FASTPATH && UART_TX_USE_DMA
+/** USART2 TX stream (set up by HAL_DMA_Init()) and its flags */
+#define UART_TX_DMA       (DMA1_Stream6)
+#define UART_TX_DMA_IRQS  (DMA_SxCR_TCIE | DMA_SxCR_TEIE)
+#define UART_TX_DMA_FLAGS (DMA_HIFCR_CTCIF6 | DMA_HIFCR_CHTIF6 \
+		| DMA_HIFCR_CTEIF6 | DMA_HIFCR_CDMEIF6 | DMA_HIFCR_CFEIF6)
+#endif /* APP_USE_FASTPATH && UART_TX_USE_DMA */
+
+extern UART_HandleTypeDef huart2;
+
+static uint8_t tx_buffer[UART_TX_BUFFER_SIZE] DMA_BUFFER;
+static volatile uint32_t tx_head = 0U;
+static volatile uint32_t tx_tail = 0U;
+static volatile uint32_t tx_inflight = 0U;
+static volatile uint32_t tx_dropped = 0U;
+static uart_tx_policy_t tx_policy = UART_TX_DEFAULT_POLICY;
+static volatile uart_tx_transport_t tx_transport = UART_TX_TRANSPORT_USART2;
+static uint32_t tx_probe_tail = 0U;
+static volatile uint32_t tx_moved_ms = 0U;   /* Last chunk, or burst start */
+static uart_tx_pressure_t tx_pressure = UART_TX_PRESSURE_NONE;
+static uint32_t tx_stalls = 0U;
+#if !UART_TX_USE_DMA
+static const uint8_t *volatile tx_irq_next = NULL; /* Next byte for TXE  */
+static volatile uint32_t tx_irq_left = 0U;         /* Of the chunk       */
+#endif /* !UART_TX_USE_DMA */
+
+#if !FMT_PRINTF_SHIM
+/* stdout buffer, in place of the one newlib would malloc() */
+static char tx_stdio_buffer[UART_TX_STDIO_SIZE];
+#endif /* !FMT_PRINTF_SHIM */
+
+/**
+ * @brief Starts the next DMA or USB chunk if the transport is idle.
+ * @note  Must run with the USART2/DMA/USB interrupts unable to preempt.
+ */
+static void UART_TX_Kick(void) {
+	uint32_t pending;
+	uint32_t offset;
+	uint32_t chunk;
+	uint32_t chunk_max;
+
+	if (tx_inflight != 0U) {
+		return;
+	}
+	pending = tx_head - tx_tail;
+	if (pending == 0U) {
+		return;
+	}
+
+	if (tx_transport == UART_TX_TRANSPORT_NONE) {
+		tx_dropped += pending;
+		tx_tail += pending;
+		return;
+	}
+	offset = tx_tail & UART_TX_MASK;
+	chunk = UART_TX_BUFFER_SIZE - offset;
+	if (chunk > pending) {
+		chunk = pending;
+	}
+#if USB_USE_CDC
+	if (tx_transport == UART_TX_TRANSPORT_USB) {
+		if (Usb_Cdc_IsOpen() == 0U) {
+			/* No host listening: gone, as on an unconnected USART */
+			tx_dropped += pending;
+			tx_tail += pending;
+			return;
+		}
+		if (chunk > USB_CDC_TX_CHUNK) {
+			chunk = USB_CDC_TX_CHUNK;
+		}
+		if (Usb_Cdc_Transmit(&tx_buffer[offset], chunk) != 0U) {
+			tx_inflight = chunk;
+		}
+		return;
+	}
+#endif /* USB_USE_CDC */
+	if (UART_FLOW_IS_CLEAR() == 0U) {
+		return; /* The CTS edge kicks again */
+	}
+	chunk_max = UART_FLOW_CHUNK_MAX();
+	if ((chunk_max != 0U) && (chunk > chunk_max)) {
+		chunk = chunk_max;
+	}
+#if !UART_TX_USE_DMA
+	/* TXE is set while the line is idle: the first byte goes at once */
+	tx_irq_next = &tx_buffer[offset];
+	tx_irq_left = chunk;
+	tx_inflight = chunk;
+	huart2.Instance->CR1 |= USART_CR1_TXEIE;
+#elif APP_USE_FASTPATH
+	/* The stream is free: a chunk ends with its DMA transfer, and the HAL
+	 * (Modbus) only transmits while the console is off USART2 */
+	DMA1->HIFCR = UART_TX_DMA_FLAGS;
+	UART_TX_DMA->PAR = (uint32_t) &huart2.Instance->DR;
+	UART_TX_DMA->M0AR = (uint32_t) &tx_buffer[offset];
+	UART_TX_DMA->NDTR = chunk;
+	huart2.Instance->SR = ~USART_SR_TC; /* Set again once the line idles */
+	UART_TX_DMA->CR |= UART_TX_DMA_IRQS | DMA_SxCR_EN;
+	huart2.Instance->CR3 |= USART_CR3_DMAT;
+	tx_inflight = chunk;
+#else
+	if (HAL_UART_Transmit_DMA(&huart2, &tx_buffer[offset], (uint16_t) chunk)
+			== HAL_OK) {
+		tx_inflight = chunk;
+	}
+#endif /* !UART_TX_USE_DMA */
+}
+
+/**
+ * @brief Kicks the DMA from thread context.
+ */
+static void UART_TX_KickSafe(void) {
+	uint32_t basepri = Irq_MaskFrom(IRQ_PRIO_UART);
+
+	UART_TX_Kick();
+	Irq_Unmask(basepri);
+}
+
+/**
+ * @brief Reports whether blocking could deadlock (ISR or IRQs masked).
+ */
+static uint8_t UART_TX_CannotBlock(void) {
+	return ((__get_PRIMASK() != 0U) || (Irq_IsMasked(IRQ_PRIO_UART) != 0U)
+			|| ((SCB->ICSR & SCB_ICSR_VECTACTIVE_Msk) != 0U)) ? 1U : 0U;
+}
+
+/**
+ * @brief Copies bytes into the ring at tx_head, handling the wrap.
+ * @note  The caller guarantees there is room for len bytes.
+ */
+static void UART_TX_CopyIn(const uint8_t *data, uint32_t len) {
+	uint32_t offset = tx_head & UART_TX_MASK;
+	uint32_t first = UART_TX_BUFFER_SIZE - offset;
+
+	if (first > len) {
+		first = len;
+	}
+	if (tx_head == tx_tail) {
+		tx_moved_ms = HAL_GetTick(); /* A stall is timed from here */
+	}
+	(void) memcpy(&tx_buffer[offset], data, first);
+	(void) memcpy(&tx_buffer[0], &data[first], len - first);
+	tx_head += len;
+}
+
+/**
+ * @brief Resets the ring.
+ */
+void UART_TX_Init(void) {
+	tx_head = 0U;
+	tx_tail = 0U;
+	tx_inflight = 0U;
+	tx_dropped = 0U;
+	tx_pressure = UART_TX_PRESSURE_NONE;
+	tx_stalls = 0U;
+	tx_policy = UART_TX_DEFAULT_POLICY;
+	tx_transport = UART_TX_TRANSPORT_USART2;
+#if !FMT_PRINTF_SHIM
+	(void) setvbuf(stdout, tx_stdio_buffer, _IOLBF, sizeof(tx_stdio_buffer));
+#endif /* !FMT_PRINTF_SHIM */
+}
+
+/**
+ * @brief Selects the overflow policy.
+ */
+void UART_TX_SetPolicy(uart_tx_policy_t policy) {
+	tx_policy = policy;
+}
+
+/**
+ * @brief Selects the transport once the chunk in flight is gone.
+ */
+uint8_t UART_TX_SetTransport(uart_tx_transport_t transport) {
+	uint32_t start = HAL_GetTick();
+	uint32_t basepri;
+
+#if !USB_USE_CDC
+	if (transport == UART_TX_TRANSPORT_USB) {
+		return 0U;
+	}
+#endif /* !USB_USE_CDC */
+	if (transport >= UART_TX_TRANSPORT_COUNT) {
+		return 0U;
+	}
+	for (;;) {
+		basepri = Irq_MaskFrom(IRQ_PRIO_UART);
+		if (tx_inflight == 0U) {
+			tx_transport = transport;
+			UART_TX_Kick();
+			Irq_Unmask(basepri);
+			return 1U;
+		}
+		Irq_Unmask(basepri);
+		if ((HAL_GetTick() - start) >= UART_TX_SWITCH_MS) {
+#if USB_USE_CDC
+			if (tx_transport == UART_TX_TRANSPORT_USB) {
+				Usb_Cdc_AbortTx();
+				continue;
+			}
+#endif /* USB_USE_CDC */
+			return 0U;
+		}
+	}
+}
+
+/**
+ * @brief Returns the active transport.
+ */
+uart_tx_transport_t UART_TX_GetTransport(void) {
+	return tx_transport;
+}
+
+/**
+ * @brief Free space in the ring.
+ */
+uint32_t UART_TX_Free(void) {
+	return UART_TX_BUFFER_SIZE - (tx_head - tx_tail);
+}
+
+/**
+ * @brief Queues bytes for transmission.
+ */
+uint32_t UART_TX_Write(const uint8_t *data, uint32_t len) {
+	uint32_t accepted = 0U;
+	uint32_t space;
+	uint32_t basepri;
+
+	if ((tx_policy == UART_TX_POLICY_BLOCK) && (UART_TX_CannotBlock() == 0U)) {
+		/* Copy as much as fits, let the DMA drain, repeat */
+		while (accepted < len) {
+			space = UART_TX_Free();
+			if (space == 0U) {
+				UART_TX_KickSafe();
+				continue;
+			}
+			if (space > (len - accepted)) {
+				space = len - accepted;
+			}
+			UART_TX_CopyIn(&data[accepted], space);
+			accepted += space;
+		}
+		UART_TX_KickSafe();
+		return accepted;
+	}
+
+	if ((tx_policy == UART_TX_POLICY_OVERWRITE) && (len > UART_TX_Free())) {
+		/* Drop everything queued but not yet handed to the DMA */
+		basepri = Irq_MaskFrom(IRQ_PRIO_UART);
+		tx_dropped += tx_head - (tx_tail + tx_inflight);
+		tx_head = tx_tail + tx_inflight;
+		Irq_Unmask(basepri);
+
+		/* Keep the newest bytes if the message alone is too long */
+		space = UART_TX_Free();
+		if (len > space) {
+			tx_dropped += len - space;
+			data = &data[len - space];
+			len = space;
+		}
+	}
+
+	space = UART_TX_Free();
+	accepted = (len > space) ? space : len;
+	tx_dropped += len - accepted;
+	UART_TX_CopyIn(data, accepted);
+	UART_TX_KickSafe();
+	return accepted;
+}
+
+/**
+ * @brief Waits for the ring to drain.
+ */
+uint8_t UART_TX_Flush(uint32_t timeout_ms) {
+	uint32_t startTick = HAL_GetTick();
+
+	while ((tx_head != tx_tail) || (tx_inflight != 0U)) {
+		if ((HAL_GetTick() - startTick) >= timeout_ms) {
+			return 0U;
+		}
+		UART_TX_KickSafe();
+	}
+	return 1U;
+}
+
+/**
+ * @brief Total bytes discarded.
+ */
+uint32_t UART_TX_GetDropped(void) {
+	return tx_dropped;
+}
+
+/**
+ * @brief Watchdog probe of the drain. A USB host that keeps the port open
+ *        but stops reading is not a firmware fault: its chunk is dropped.
+ */
+uint8_t UART_TX_IsDraining(void) {
+	uint32_t tail = tx_tail;
+	uint8_t draining = ((tx_head == tail) || (tail != tx_probe_tail)) ? 1U : 0U;
+
+#if USB_USE_CDC
+	if ((draining == 0U) && (tx_transport == UART_TX_TRANSPORT_USB)) {
+		Usb_Cdc_AbortTx();
+		draining = 1U;
+	}
+#endif /* USB_USE_CDC */
+	tx_probe_tail = tail;
+	return draining;
+}
+
+/**
+ * @brief Backpressure of the ring, with hysteresis between the fill marks.
+ */
+uart_tx_pressure_t UART_TX_GetPressure(void) {
+	uint32_t fill = tx_head - tx_tail;
+	uint8_t stalled = ((fill != 0U)
+			&& ((HAL_GetTick() - tx_moved_ms) >= UART_TX_STALL_MS)) ? 1U : 0U;
+
+	if (stalled != 0U) {
+		if (tx_pressure != UART_TX_PRESSURE_STALLED) {
+			tx_stalls++;
+		}
+		tx_pressure = UART_TX_PRESSURE_STALLED;
+	} else if (fill >= UART_TX_PRESSURE_HIGH_FILL) {
+		tx_pressure = UART_TX_PRESSURE_HIGH;
+	} else if (fill <= UART_TX_PRESSURE_LOW_FILL) {
+		tx_pressure = UART_TX_PRESSURE_NONE;
+	} else if (tx_pressure == UART_TX_PRESSURE_STALLED) {
+		tx_pressure = UART_TX_PRESSURE_HIGH; /* Moving, not yet drained */
+	}
+	return tx_pressure;
+}
+
+/**
+ * @brief Times the ring entered UART_TX_PRESSURE_STALLED.
+ */
+uint32_t UART_TX_GetStalls(void) {
+	return tx_stalls;
+}
+
+/**
+ * @brief Short printable name of a backpressure level.
+ */
+const char* UART_TX_PressureName(uart_tx_pressure_t pressure) {
+	static const char *const names[UART_TX_PRESSURE_LEVELS] = { "none",
+			"high", "stalled" };
+
+	return (pressure < UART_TX_PRESSURE_LEVELS) ? names[pressure] : "?";
+}
+
+/**
+ * @brief Restarts a drain that flow control held back.
+ */
+void UART_TX_Resume(void) {
+	UART_TX_KickSafe();
+}
+
+/**
+ * @brief Transfer complete: retire the chunk and chain the next one.
+ */
+void UART_TX_CompleteCallback(void) {
+	tx_tail += tx_inflight;
+	tx_inflight = 0U;
+	tx_moved_ms = HAL_GetTick();
+	UART_TX_Kick();
+}
+
+/**
+ * @brief Transfer cancelled: drop the chunk and resume.
+ */
+void UART_TX_AbortCallback(void) {
+	tx_dropped += tx_inflight;
+	UART_TX_CompleteCallback();
+}
+
+/**
+ * @brief UART error: if the TX DMA was aborted, drop that chunk and resume.
+ */
+void UART_TX_ErrorCallback(void) {
+#if !APP_USE_FASTPATH && UART_TX_USE_DMA
+	/* With the fast path gState stays READY and a stream error arrives
+	 * through UART_TX_DmaIRQHandler() instead; TXE draining has no error */
+	if ((tx_transport == UART_TX_TRANSPORT_USART2) && (tx_inflight != 0U)
+			&& (huart2.gState == HAL_UART_STATE_READY)) {
+		UART_TX_AbortCallback();
+	}
+#endif /* !APP_USE_FASTPATH && UART_TX_USE_DMA */
+}
+
+#if !UART_TX_USE_DMA
+/**
+ * @brief USART2 TXE interrupt: one byte of the chunk.
+ */
+void UART_TX_IRQHandler(void) {
+	if ((huart2.Instance->CR1 & USART_CR1_TXEIE) == 0U) {
+		return;
+	}
+	huart2.Instance->DR = *tx_irq_next++; /* Clears TXE */
+	if (--tx_irq_left == 0U) {
+		huart2.Instance->CR1 &= ~USART_CR1_TXEIE;
+		UART_TX_CompleteCallback();
+	}
+}
+#endif /* !UART_TX_USE_DMA */
+
+#if APP_USE_FASTPATH && UART_TX_USE_DMA
+/**
+ * @brief DMA1 Stream6 interrupt for console chunks.
+ */
+uint8_t UART_TX_DmaIRQHandler(void) {
+	uint32_t hisr;
+
+	if (huart2.gState != HAL_UART_STATE_READY) {
+		return 0U; /* HAL_UART_Transmit_DMA() owns the stream */
+	}
+	hisr = DMA1->HISR;
+	DMA1->HIFCR = UART_TX_DMA_FLAGS;
+	UART_TX_DMA->CR &= ~UART_TX_DMA_IRQS;
+	huart2.Instance->CR3 &= ~USART_CR3_DMAT;
+	if ((hisr & DMA_HISR_TEIF6) != 0U) {
+		UART_TX_DMA->CR &= ~DMA_SxCR_EN;
+		UART_TX_AbortCallback();
+	} else if ((hisr & DMA_HISR_TCIF6) != 0U) {
+		UART_TX_CompleteCallback();
+	}
+	return 1U;
+}
+#endif /* APP_USE_FASTPATH && UART_TX_USE_DMA */
+
+/**
+ * @brief newlib write hook: copies the whole buffer into the ring.
+ *        Overrides the weak implementation in syscalls.c.
+ */
+int _write(int file, char *ptr, int len) {
+	(void) file;
+	if (len <= 0) {
+		return 0;
+	}
+	(void) UART_TX_Write((const uint8_t*) ptr, (uint32_t) len);
+
+	/* Report everything as written; dropped bytes are counted instead of
+	 * making newlib retry. */
+	return len;
+}
@@ -0,0 +1,896 @@
+/**
+ ******************************************************************************
+ * @file           : usb_cdc.c
+ * @brief          : USB CDC-ACM device on OTG FS.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "usb_cdc.h"
+#include "uart_tx.h"
+#include "modbus.h"
+#include "irq_prio.h"
+#include "spsc.h"
+#include <string.h>
+
+#if USB_USE_CDC
+
+#define USB_CDC_OTG      (USB_OTG_FS)
+#define USB_CDC_DEV      ((USB_OTG_DeviceTypeDef *) (USB_OTG_FS_PERIPH_BASE \
+		+ USB_OTG_DEVICE_BASE))
+#define USB_CDC_IN(ep)   ((USB_OTG_INEndpointTypeDef *) (USB_OTG_FS_PERIPH_BASE \
+		+ USB_OTG_IN_ENDPOINT_BASE + ((ep) * USB_OTG_EP_REG_SIZE)))
+#define USB_CDC_OUT(ep)  ((USB_OTG_OUTEndpointTypeDef *) (USB_OTG_FS_PERIPH_BASE \
+		+ USB_OTG_OUT_ENDPOINT_BASE + ((ep) * USB_OTG_EP_REG_SIZE)))
+#define USB_CDC_FIFO(ep) (*(__IO uint32_t *) (USB_OTG_FS_PERIPH_BASE \
+		+ USB_OTG_FIFO_BASE + ((ep) * USB_OTG_FIFO_SIZE)))
+#define USB_CDC_PCGCCTL  (*(__IO uint32_t *) (USB_OTG_FS_PERIPH_BASE \
+		+ USB_OTG_PCGCCTL_BASE))
+
+/** D-/D+ */
+#define USB_CDC_Pins      (GPIO_PIN_11 | GPIO_PIN_12)
+#define USB_CDC_GPIO_Port GPIOA
+
+/** Endpoints: bulk IN/OUT pair and the ACM notification */
+#define USB_CDC_EP_DATA   (1U)
+#define USB_CDC_EP_NOTIFY (2U)
+#define USB_CDC_NOTIFY_MPS (8U)
+
+/** FIFO RAM in words (1.25 KB on OTG FS): RX, then one TX FIFO per IN EP */
+#define USB_CDC_RXFIFO_WORDS  (128U)
+#define USB_CDC_TXFIFO0_WORDS (USB_CDC_PACKET / 4U)
+#define USB_CDC_TXFIFO1_WORDS (USB_CDC_TX_CHUNK / 4U)
+#define USB_CDC_TXFIFO2_WORDS (16U)
+
+_Static_assert((USB_CDC_RXFIFO_WORDS + USB_CDC_TXFIFO0_WORDS
+		+ USB_CDC_TXFIFO1_WORDS + USB_CDC_TXFIFO2_WORDS) <= 320U,
+		"USB FIFOs exceed the 1.25 KB of OTG FS RAM");
+
+/** Turnaround time in PHY clocks, valid from USB_CDC_MIN_HCLK */
+#define USB_CDC_TRDT      (6U)
+#define USB_CDC_MIN_HCLK  (32000000U)
+
+/** Forced device mode takes effect after 25 ms */
+#define USB_CDC_FORCE_MS  (25U)
+
+/** Bounded waits on the core, in polls */
+#define USB_CDC_SPIN      (100000U)
+
+/** GRXSTSP packet status */
+#define USB_CDC_PKT_OUT   (2U)
+#define USB_CDC_PKT_SETUP (6U)
+
+/** Standard and CDC class requests */
+#define USB_CDC_REQ_GET_STATUS        (0x00U)
+#define USB_CDC_REQ_CLEAR_FEATURE     (0x01U)
+#define USB_CDC_REQ_SET_FEATURE       (0x03U)
+#define USB_CDC_REQ_SET_ADDRESS       (0x05U)
+#define USB_CDC_REQ_GET_DESCRIPTOR    (0x06U)
+#define USB_CDC_REQ_GET_CONFIGURATION (0x08U)
+#define USB_CDC_REQ_SET_CONFIGURATION (0x09U)
+#define USB_CDC_REQ_GET_INTERFACE     (0x0AU)
+#define USB_CDC_REQ_SET_INTERFACE     (0x0BU)
+#define USB_CDC_REQ_SET_LINE_CODING   (0x20U)
+#define USB_CDC_REQ_GET_LINE_CODING   (0x21U)
+#define USB_CDC_REQ_SET_LINE_STATE    (0x22U)
+#define USB_CDC_REQ_SEND_BREAK        (0x23U)
+
+/** bmRequestType type field */
+#define USB_CDC_TYPE_MASK     (0x60U)
+#define USB_CDC_TYPE_STANDARD (0x00U)
+#define USB_CDC_TYPE_CLASS    (0x20U)
+
+/** Descriptor types */
+#define USB_CDC_DESC_DEVICE   (0x01U)
+#define USB_CDC_DESC_CONFIG   (0x02U)
+#define USB_CDC_DESC_STRING   (0x03U)
+
+#define USB_CDC_LINE_CODING_LEN (7U)
+#define USB_CDC_CONFIG_LEN      (67U)
+
+static const uint8_t usb_device_desc[18] = {
+	18U, USB_CDC_DESC_DEVICE, 0x00U, 0x02U, /* USB 2.0                       */
+	0x02U, 0x00U, 0x00U, USB_CDC_PACKET,    /* CDC, EP0 packet               */
+	0x83U, 0x04U, 0x40U, 0x57U,             /* VID 0483, PID 5740            */
+	0x00U, 0x01U,                           /* Release 1.00                  */
+	1U, 2U, 3U, 1U                          /* Strings, one configuration    */
+};
+
+static const uint8_t usb_config_desc[USB_CDC_CONFIG_LEN] = {
+	/* Two interfaces, bus powered, 100 mA */
+	9U, USB_CDC_DESC_CONFIG, USB_CDC_CONFIG_LEN, 0U, 2U, 1U, 0U, 0x80U, 50U,
+	/* Interface 0: communication, abstract control model */
+	9U, 0x04U, 0U, 0U, 1U, 0x02U, 0x02U, 0x01U, 0U,
+	/* Header (CDC 1.10), call management, ACM (line coding and state),
+	 * union of interfaces 0 and 1 */
+	5U, 0x24U, 0x00U, 0x10U, 0x01U,
+	5U, 0x24U, 0x01U, 0x00U, 1U,
+	4U, 0x24U, 0x02U, 0x02U,
+	5U, 0x24U, 0x06U, 0U, 1U,
+	/* EP2 IN, interrupt, every 16 ms */
+	7U, 0x05U, 0x80U | USB_CDC_EP_NOTIFY, 0x03U, USB_CDC_NOTIFY_MPS, 0U, 16U,
+	/* Interface 1: data */
+	9U, 0x04U, 1U, 0U, 2U, 0x0AU, 0x00U, 0x00U, 0U,
+	/* EP1 OUT and EP1 IN, bulk */
+	7U, 0x05U, USB_CDC_EP_DATA, 0x02U, USB_CDC_PACKET, 0U, 0U,
+	7U, 0x05U, 0x80U | USB_CDC_EP_DATA, 0x02U, USB_CDC_PACKET, 0U, 0U
+};
+
+static const uint8_t usb_langid_desc[4] = { 4U, USB_CDC_DESC_STRING, 0x09U,
+		0x04U };
+
+/* Index 3, the serial number, is filled in from the unique ID */
+static const char *const usb_strings[] = { NULL, "DHT11_Reader",
+		"DHT11 Reader virtual COM port", NULL };
+
+#define USB_CDC_STRING_COUNT (sizeof(usb_strings) / sizeof(usb_strings[0]))
+
+SPSC_DEFINE(usb_rx_ring_t, UsbRxRing, uint8_t, USB_CDC_RX_SIZE)
+
+static usb_rx_ring_t usb_rx;
+static char usb_serial[25];
+static uint8_t usb_line_coding[USB_CDC_LINE_CODING_LEN] = { 0x00U, 0xC2U,
+		0x01U, 0x00U, 0U, 0U, 8U };        /* 115200 8N1, for show only */
+
+static uint8_t usb_wanted = 0U;
+static volatile uint8_t usb_started = 0U;
+static volatile uint8_t usb_configured = 0U;
+static volatile uint8_t usb_dtr = 0U;
+static volatile uint8_t usb_suspended = 0U;
+
+/* EP0, interrupt context */
+static uint8_t usb_setup[8];
+static uint8_t usb_ep0_buf[USB_CDC_PACKET];  /* Strings and OUT data */
+static const uint8_t *usb_ep0_data = NULL;
+static uint32_t usb_ep0_left = 0U;
+static uint8_t usb_ep0_zlp = 0U;
+static uint8_t usb_ep0_line_coding = 0U;     /* Awaiting SET_LINE_CODING data */
+
+/* EP1 */
+static volatile uint8_t usb_tx_busy = 0U;
+static uint32_t usb_tx_len = 0U;
+static uint8_t usb_tx_zlp = 0U;   /* Transfer ended on a full packet */
+static volatile uint8_t usb_rx_armed = 0U;
+
+/**
+ * @brief Copies bytes into an endpoint TX FIFO, a word at a time.
+ */
+static void Usb_Cdc_WriteFifo(uint32_t ep, const uint8_t *data, uint32_t len) {
+	uint32_t word;
+	uint32_t n;
+	uint32_t i;
+
+	for (i = 0U; i < len; i += 4U) {
+		n = ((len - i) < 4U) ? (len - i) : 4U;
+		word = 0U;
+		(void) memcpy(&word, &data[i], n);
+		USB_CDC_FIFO(ep) = word;
+	}
+}
+
+/**
+ * @brief Pops bytes from the RX FIFO; bytes beyond max are discarded.
+ */
+static void Usb_Cdc_ReadFifo(uint8_t *out, uint32_t len, uint32_t max) {
+	uint32_t word;
+	uint32_t n;
+	uint32_t i;
+
+	for (i = 0U; i < len; i += 4U) {
+		word = USB_CDC_FIFO(0U);
+		n = ((len - i) < 4U) ? (len - i) : 4U;
+		if ((i + n) <= max) {
+			(void) memcpy(&out[i], &word, n);
+		}
+	}
+}
+
+/**
+ * @brief Bounded wait for register bits to reach a state.
+ */
+static uint8_t Usb_Cdc_Wait(__IO uint32_t *reg, uint32_t mask, uint32_t value) {
+	uint32_t spin;
+
+	for (spin = 0U; spin < USB_CDC_SPIN; spin++) {
+		if ((*reg & mask) == value) {
+			return 1U;
+		}
+	}
+	return 0U;
+}
+
+/**
+ * @brief Flushes one TX FIFO, or all of them with 0x10.
+ */
+static void Usb_Cdc_FlushTx(uint32_t fifo) {
+	USB_CDC_OTG->GRSTCTL = USB_OTG_GRSTCTL_TXFFLSH
+			| (fifo << USB_OTG_GRSTCTL_TXFNUM_Pos);
+	(void) Usb_Cdc_Wait(&USB_CDC_OTG->GRSTCTL, USB_OTG_GRSTCTL_TXFFLSH, 0U);
+}
+
+/**
+ * @brief Reports whether the clock tree can feed PLLSAI and the core:
+ *        HSE as PLL source and HCLK at least USB_CDC_MIN_HCLK.
+ */
+static uint8_t Usb_Cdc_ClockOk(void) {
+	return (((RCC->CR & RCC_CR_HSERDY) != 0U)
+			&& ((RCC->PLLCFGR & RCC_PLLCFGR_PLLSRC) == RCC_PLLCFGR_PLLSRC_HSE)
+			&& (HAL_RCC_GetHCLKFreq() >= USB_CDC_MIN_HCLK)) ? 1U : 0U;
+}
+
+/**
+ * @brief Serial number string: the 96-bit unique ID in hex.
+ */
+static void Usb_Cdc_MakeSerial(void) {
+	static const char hex[] = "0123456789ABCDEF";
+	const uint8_t *uid = (const uint8_t*) UID_BASE;
+	uint32_t i;
+
+	for (i = 0U; i < 12U; i++) {
+		usb_serial[2U * i] = hex[uid[11U - i] >> 4];
+		usb_serial[(2U * i) + 1U] = hex[uid[11U - i] & 0x0FU];
+	}
+	usb_serial[24] = '\0';
+}
+
+/**
+ * @brief Re-arms EP0 OUT for SETUP packets and one data or status packet.
+ */
+static void Usb_Cdc_Ep0ArmOut(void) {
+	USB_CDC_OUT(0U)->DOEPTSIZ = (3U << USB_OTG_DOEPTSIZ_STUPCNT_Pos)
+			| (1U << USB_OTG_DOEPTSIZ_PKTCNT_Pos) | USB_CDC_PACKET;
+	USB_CDC_OUT(0U)->DOEPCTL |= USB_OTG_DOEPCTL_CNAK | USB_OTG_DOEPCTL_EPENA;
+}
+
+/**
+ * @brief Sends the next EP0 IN packet, a zero-length one when nothing is
+ *        left.
+ */
+static void Usb_Cdc_Ep0Packet(void) {
+	uint32_t n = (usb_ep0_left > USB_CDC_PACKET) ? USB_CDC_PACKET : usb_ep0_left;
+
+	USB_CDC_IN(0U)->DIEPTSIZ = (1U << USB_OTG_DIEPTSIZ_PKTCNT_Pos) | n;
+	USB_CDC_IN(0U)->DIEPCTL |= USB_OTG_DIEPCTL_CNAK | USB_OTG_DIEPCTL_EPENA;
+	if (n != 0U) {
+		Usb_Cdc_WriteFifo(0U, usb_ep0_data, n);
+		usb_ep0_data = &usb_ep0_data[n];
+		usb_ep0_left -= n;
+	}
+}
+
+/**
+ * @brief Starts the data stage of a control read, cut to what the host
+ *        asked for. A short reply ending on a full packet gets a ZLP.
+ */
+static void Usb_Cdc_Ep0Send(const uint8_t *data, uint32_t len, uint32_t max) {
+	if (len > max) {
+		len = max;
+	}
+	usb_ep0_zlp = ((len != 0U) && (len < max)
+			&& ((len % USB_CDC_PACKET) == 0U)) ? 1U : 0U;
+	usb_ep0_data = data;
+	usb_ep0_left = len;
+	Usb_Cdc_Ep0Packet();
+}
+
+/**
+ * @brief Zero-length status stage of a control write.
+ */
+static void Usb_Cdc_Ep0Status(void) {
+	Usb_Cdc_Ep0Send(NULL, 0U, 0U);
+}
+
+/**
+ * @brief Refuses a request; the core clears the stall on the next SETUP.
+ */
+static void Usb_Cdc_Ep0Stall(void) {
+	USB_CDC_IN(0U)->DIEPCTL |= USB_OTG_DIEPCTL_STALL;
+	USB_CDC_OUT(0U)->DOEPCTL |= USB_OTG_DOEPCTL_STALL;
+}
+
+/**
+ * @brief Arms EP1 OUT for one packet when the receive ring has room for
+ *        it; the host is NAKed meanwhile, so nothing is lost.
+ */
+static void Usb_Cdc_ArmRx(void) {
+	if (UsbRxRing_Free(&usb_rx) < USB_CDC_PACKET) {
+		usb_rx_armed = 0U;
+		return;
+	}
+	usb_rx_armed = 1U;
+	USB_CDC_OUT(USB_CDC_EP_DATA)->DOEPTSIZ = (1U << USB_OTG_DOEPTSIZ_PKTCNT_Pos)
+			| USB_CDC_PACKET;
+	USB_CDC_OUT(USB_CDC_EP_DATA)->DOEPCTL |= USB_OTG_DOEPCTL_CNAK
+			| USB_OTG_DOEPCTL_EPENA;
+}
+
+/**
+ * @brief Starts an EP1 IN transfer; data goes into the FIFO at once.
+ */
+static void Usb_Cdc_StartIn(const uint8_t *data, uint32_t len) {
+	USB_OTG_INEndpointTypeDef *ep = USB_CDC_IN(USB_CDC_EP_DATA);
+	uint32_t packets = (len == 0U) ? 1U :
+			((len + USB_CDC_PACKET - 1U) / USB_CDC_PACKET);
+
+	usb_tx_busy = 1U;
+	usb_tx_len = len;
+	usb_tx_zlp = ((len != 0U) && ((len % USB_CDC_PACKET) == 0U)) ? 1U : 0U;
+	ep->DIEPTSIZ = (packets << USB_OTG_DIEPTSIZ_PKTCNT_Pos) | len;
+	ep->DIEPCTL |= USB_OTG_DIEPCTL_CNAK | USB_OTG_DIEPCTL_EPENA;
+	Usb_Cdc_WriteFifo(USB_CDC_EP_DATA, data, len);
+}
+
+/**
+ * @brief Activates the data and notification endpoints (SET_CONFIGURATION 1).
+ */
+static void Usb_Cdc_Configure(void) {
+	USB_CDC_IN(USB_CDC_EP_DATA)->DIEPCTL = USB_OTG_DIEPCTL_USBAEP
+			| (2U << USB_OTG_DIEPCTL_EPTYP_Pos)
+			| (USB_CDC_EP_DATA << USB_OTG_DIEPCTL_TXFNUM_Pos)
+			| USB_OTG_DIEPCTL_SD0PID_SEVNFRM | USB_OTG_DIEPCTL_SNAK
+			| USB_CDC_PACKET;
+	USB_CDC_OUT(USB_CDC_EP_DATA)->DOEPCTL = USB_OTG_DOEPCTL_USBAEP
+			| (2U << USB_OTG_DOEPCTL_EPTYP_Pos)
+			| USB_OTG_DOEPCTL_SD0PID_SEVNFRM | USB_CDC_PACKET;
+	USB_CDC_IN(USB_CDC_EP_NOTIFY)->DIEPCTL = USB_OTG_DIEPCTL_USBAEP
+			| (3U << USB_OTG_DIEPCTL_EPTYP_Pos)
+			| (USB_CDC_EP_NOTIFY << USB_OTG_DIEPCTL_TXFNUM_Pos)
+			| USB_OTG_DIEPCTL_SD0PID_SEVNFRM | USB_OTG_DIEPCTL_SNAK
+			| USB_CDC_NOTIFY_MPS;
+	USB_CDC_DEV->DAINTMSK |= (1UL << USB_CDC_EP_DATA)
+			| (1UL << (16U + USB_CDC_EP_DATA));
+	usb_configured = 1U;
+	Usb_Cdc_ArmRx();
+}
+
+/**
+ * @brief Deactivates the endpoints and forgets the port state.
+ */
+static void Usb_Cdc_Deconfigure(void) {
+	usb_configured = 0U;
+	usb_dtr = 0U;
+	Usb_Cdc_AbortTx();
+	USB_CDC_IN(USB_CDC_EP_DATA)->DIEPCTL &= ~USB_OTG_DIEPCTL_USBAEP;
+	USB_CDC_OUT(USB_CDC_EP_DATA)->DOEPCTL &= ~USB_OTG_DOEPCTL_USBAEP;
+	USB_CDC_IN(USB_CDC_EP_NOTIFY)->DIEPCTL &= ~USB_OTG_DIEPCTL_USBAEP;
+	USB_CDC_DEV->DAINTMSK = (1UL << 0) | (1UL << 16);
+	usb_rx_armed = 0U;
+}
+
+/**
+ * @brief GET_DESCRIPTOR.
+ */
+static void Usb_Cdc_GetDescriptor(uint32_t value, uint32_t length) {
+	uint32_t index = value & 0xFFU;
+	const char *s;
+	uint32_t i;
+
+	switch (value >> 8) {
+	case USB_CDC_DESC_DEVICE:
+		Usb_Cdc_Ep0Send(usb_device_desc, sizeof(usb_device_desc), length);
+		break;
+	case USB_CDC_DESC_CONFIG:
+		Usb_Cdc_Ep0Send(usb_config_desc, sizeof(usb_config_desc), length);
+		break;
+	case USB_CDC_DESC_STRING:
+		if (index == 0U) {
+			Usb_Cdc_Ep0Send(usb_langid_desc, sizeof(usb_langid_desc), length);
+			break;
+		}
+		if (index >= USB_CDC_STRING_COUNT) {
+			Usb_Cdc_Ep0Stall();
+			break;
+		}
+		/* ASCII to UTF-16LE */
+		s = (usb_strings[index] != NULL) ? usb_strings[index] : usb_serial;
+		for (i = 0U; (s[i] != '\0') && (((2U * i) + 3U) < USB_CDC_PACKET); i++) {
+			usb_ep0_buf[(2U * i) + 2U] = (uint8_t) s[i];
+			usb_ep0_buf[(2U * i) + 3U] = 0U;
+		}
+		usb_ep0_buf[0] = (uint8_t) ((2U * i) + 2U);
+		usb_ep0_buf[1] = USB_CDC_DESC_STRING;
+		Usb_Cdc_Ep0Send(usb_ep0_buf, usb_ep0_buf[0], length);
+		break;
+	default:
+		/* Device qualifier included: full-speed only */
+		Usb_Cdc_Ep0Stall();
+		break;
+	}
+}
+
+/**
+ * @brief Chapter 9 requests.
+ */
+static void Usb_Cdc_StandardRequest(uint32_t request, uint32_t value,
+		uint32_t length) {
+	switch (request) {
+	case USB_CDC_REQ_GET_DESCRIPTOR:
+		Usb_Cdc_GetDescriptor(value, length);
+		break;
+	case USB_CDC_REQ_SET_ADDRESS:
+		/* This core takes the address before the status stage */
+		USB_CDC_DEV->DCFG = (USB_CDC_DEV->DCFG & ~USB_OTG_DCFG_DAD)
+				| ((value & 0x7FU) << USB_OTG_DCFG_DAD_Pos);
+		Usb_Cdc_Ep0Status();
+		break;
+	case USB_CDC_REQ_SET_CONFIGURATION:
+		if (value > 1U) {
+			Usb_Cdc_Ep0Stall();
+			break;
+		}
+		if (value == 1U) {
+			Usb_Cdc_Configure();
+		} else {
+			Usb_Cdc_Deconfigure();
+		}
+		Usb_Cdc_Ep0Status();
+		break;
+	case USB_CDC_REQ_GET_CONFIGURATION:
+		usb_ep0_buf[0] = usb_configured;
+		Usb_Cdc_Ep0Send(usb_ep0_buf, 1U, length);
+		break;
+	case USB_CDC_REQ_GET_INTERFACE:
+		usb_ep0_buf[0] = 0U;
+		Usb_Cdc_Ep0Send(usb_ep0_buf, 1U, length);
+		break;
+	case USB_CDC_REQ_GET_STATUS:
+		usb_ep0_buf[0] = 0U;
+		usb_ep0_buf[1] = 0U;
+		Usb_Cdc_Ep0Send(usb_ep0_buf, 2U, length);
+		break;
+	case USB_CDC_REQ_CLEAR_FEATURE:
+	case USB_CDC_REQ_SET_FEATURE:
+	case USB_CDC_REQ_SET_INTERFACE:
+		/* Endpoint halt is not used; one alternate setting */
+		Usb_Cdc_Ep0Status();
+		break;
+	default:
+		Usb_Cdc_Ep0Stall();
+		break;
+	}
+}
+
+/**
+ * @brief ACM requests. Line coding is kept for GET_LINE_CODING only, as
+ *        there is no UART behind the port; DTR opens and closes it.
+ */
+static void Usb_Cdc_ClassRequest(uint32_t request, uint32_t value,
+		uint32_t length) {
+	switch (request) {
+	case USB_CDC_REQ_SET_LINE_CODING:
+		/* Status follows the data stage (Usb_Cdc_OutEndpoints()) */
+		usb_ep0_line_coding = 1U;
+		break;
+	case USB_CDC_REQ_GET_LINE_CODING:
+		Usb_Cdc_Ep0Send(usb_line_coding, USB_CDC_LINE_CODING_LEN, length);
+		break;
+	case USB_CDC_REQ_SET_LINE_STATE:
+		usb_dtr = (uint8_t) (value & 1U);
+		if (usb_dtr == 0U) {
+			Usb_Cdc_AbortTx();
+		}
+		Usb_Cdc_Ep0Status();
+		break;
+	case USB_CDC_REQ_SEND_BREAK:
+		Usb_Cdc_Ep0Status();
+		break;
+	default:
+		Usb_Cdc_Ep0Stall();
+		break;
+	}
+}
+
+/**
+ * @brief Decodes the SETUP packet received on EP0.
+ */
+static void Usb_Cdc_Setup(void) {
+	uint32_t request = usb_setup[1];
+	uint32_t value = (uint32_t) usb_setup[2] | ((uint32_t) usb_setup[3] << 8);
+	uint32_t length = (uint32_t) usb_setup[6] | ((uint32_t) usb_setup[7] << 8);
+
+	usb_ep0_left = 0U;
+	usb_ep0_zlp = 0U;
+	usb_ep0_line_coding = 0U;
+	switch (usb_setup[0] & USB_CDC_TYPE_MASK) {
+	case USB_CDC_TYPE_STANDARD:
+		Usb_Cdc_StandardRequest(request, value, length);
+		break;
+	case USB_CDC_TYPE_CLASS:
+		Usb_Cdc_ClassRequest(request, value, length);
+		break;
+	default:
+		Usb_Cdc_Ep0Stall();
+		break;
+	}
+	Usb_Cdc_Ep0ArmOut();
+}
+
+/**
+ * @brief USB reset: back to the default address with only EP0.
+ */
+static void Usb_Cdc_BusReset(void) {
+	uint32_t ep;
+
+	USB_CDC_DEV->DCTL &= ~USB_OTG_DCTL_RWUSIG;
+	usb_suspended = 0U;
+	Usb_Cdc_Deconfigure();
+	Usb_Cdc_FlushTx(0x10U);
+	for (ep = 0U; ep <= USB_CDC_EP_NOTIFY; ep++) {
+		USB_CDC_IN(ep)->DIEPINT = 0xFFU;
+		USB_CDC_OUT(ep)->DOEPINT = 0xFFU;
+	}
+	USB_CDC_DEV->DIEPMSK = USB_OTG_DIEPMSK_XFRCM;
+	USB_CDC_DEV->DOEPMSK = USB_OTG_DOEPMSK_XFRCM | USB_OTG_DOEPMSK_STUPM;
+	USB_CDC_DEV->DCFG &= ~USB_OTG_DCFG_DAD;
+	Usb_Cdc_Ep0ArmOut();
+}
+
+/**
+ * @brief Pops one RX FIFO entry: a SETUP packet or OUT data.
+ */
+static void Usb_Cdc_RxLevel(void) {
+	uint32_t status = USB_CDC_OTG->GRXSTSP;
+	uint32_t ep = status & USB_OTG_GRXSTSP_EPNUM;
+	uint32_t count = (status & USB_OTG_GRXSTSP_BCNT) >> USB_OTG_GRXSTSP_BCNT_Pos;
+	uint8_t packet[USB_CDC_PACKET];
+	uint32_t i;
+
+	switch ((status & USB_OTG_GRXSTSP_PKTSTS) >> USB_OTG_GRXSTSP_PKTSTS_Pos) {
+	case USB_CDC_PKT_SETUP:
+		Usb_Cdc_ReadFifo(usb_setup, count, sizeof(usb_setup));
+		break;
+	case USB_CDC_PKT_OUT:
+		if (ep == 0U) {
+			Usb_Cdc_ReadFifo(usb_ep0_buf, count, sizeof(usb_ep0_buf));
+			if ((usb_ep0_line_coding != 0U)
+					&& (count >= USB_CDC_LINE_CODING_LEN)) {
+				(void) memcpy(usb_line_coding, usb_ep0_buf,
+						USB_CDC_LINE_CODING_LEN);
+			}
+		} else {
+			Usb_Cdc_ReadFifo(packet, count, sizeof(packet));
+			for (i = 0U; (i < count) && (i < sizeof(packet)); i++) {
+				(void) UsbRxRing_Push(&usb_rx, &packet[i]);
+			}
+		}
+		break;
+	default:
+		/* Transfer and setup completion, seen again as endpoint events */
+		break;
+	}
+}
+
+/**
+ * @brief OUT endpoint events: SETUP done, EP0 data, EP1 packet.
+ */
+static void Usb_Cdc_OutEndpoints(void) {
+	uint32_t daint = USB_CDC_DEV->DAINT & USB_CDC_DEV->DAINTMSK;
+	uint32_t flags;
+
+	if ((daint & (1UL << 16)) != 0U) {
+		flags = USB_CDC_OUT(0U)->DOEPINT & USB_CDC_DEV->DOEPMSK;
+		USB_CDC_OUT(0U)->DOEPINT = flags;
+		if ((flags & USB_OTG_DOEPINT_XFRC) != 0U) {
+			if (usb_ep0_line_coding != 0U) {
+				usb_ep0_line_coding = 0U;
+				Usb_Cdc_Ep0Status();
+			}
+			Usb_Cdc_Ep0ArmOut();
+		}
+		if ((flags & USB_OTG_DOEPINT_STUP) != 0U) {
+			Usb_Cdc_Setup();
+		}
+	}
+	if ((daint & (1UL << (16U + USB_CDC_EP_DATA))) != 0U) {
+		flags = USB_CDC_OUT(USB_CDC_EP_DATA)->DOEPINT;
+		USB_CDC_OUT(USB_CDC_EP_DATA)->DOEPINT = flags;
+		if ((flags & USB_OTG_DOEPINT_XFRC) != 0U) {
+			Usb_Cdc_ArmRx();
+		}
+	}
+}
+
+/**
+ * @brief IN endpoint events: next EP0 packet, EP1 transfer done.
+ */
+static void Usb_Cdc_InEndpoints(void) {
+	uint32_t daint = USB_CDC_DEV->DAINT & USB_CDC_DEV->DAINTMSK;
+	uint32_t flags;
+	uint32_t len;
+
+	if ((daint & (1UL << 0)) != 0U) {
+		flags = USB_CDC_IN(0U)->DIEPINT;
+		USB_CDC_IN(0U)->DIEPINT = flags;
+		if ((flags & USB_OTG_DIEPINT_XFRC) != 0U) {
+			if (usb_ep0_left != 0U) {
+				Usb_Cdc_Ep0Packet();
+			} else if (usb_ep0_zlp != 0U) {
+				usb_ep0_zlp = 0U;
+				Usb_Cdc_Ep0Packet();
+			}
+		}
+	}
+	if ((daint & (1UL << USB_CDC_EP_DATA)) != 0U) {
+		flags = USB_CDC_IN(USB_CDC_EP_DATA)->DIEPINT;
+		USB_CDC_IN(USB_CDC_EP_DATA)->DIEPINT = flags;
+		if (((flags & USB_OTG_DIEPINT_XFRC) != 0U) && (usb_tx_busy != 0U)) {
+			len = usb_tx_len;
+			usb_tx_busy = 0U;
+			/* Retire the chunk; the ring chains the next one from here */
+			UART_TX_CompleteCallback();
+			if ((usb_tx_busy == 0U) && (len != 0U) && (usb_tx_zlp != 0U)) {
+				/* Nothing follows a full last packet: end the host's read */
+				Usb_Cdc_StartIn(NULL, 0U);
+			}
+		}
+	}
+}
+
+/**
+ * @brief Starts PLLSAI, claims the pins and connects.
+ */
+uint8_t Usb_Cdc_Start(void) {
+	RCC_PeriphCLKInitTypeDef PeriphClkInitStruct = { 0 };
+	GPIO_InitTypeDef GPIO_InitStruct = { 0 };
+	USB_OTG_GlobalTypeDef *otg = USB_CDC_OTG;
+	uint32_t ep;
+
+	usb_wanted = 1U;
+	if (usb_started != 0U) {
+		return 1U;
+	}
+	if (Usb_Cdc_ClockOk() == 0U) {
+		return 0U;
+	}
+
+	/* 8 MHz HSE / 4 * 96 / 4 = 48 MHz on CK48 */
+	PeriphClkInitStruct.PeriphClockSelection = RCC_PERIPHCLK_CLK48;
+	PeriphClkInitStruct.PLLSAI.PLLSAIM = 4U;
+	PeriphClkInitStruct.PLLSAI.PLLSAIN = 96U;
+	PeriphClkInitStruct.PLLSAI.PLLSAIP = RCC_PLLSAIP_DIV4;
+	PeriphClkInitStruct.Clk48ClockSelection = RCC_CLK48CLKSOURCE_PLLSAIP;
+	if (HAL_RCCEx_PeriphCLKConfig(&PeriphClkInitStruct) != HAL_OK) {
+		return 0U;
+	}
+
+	__HAL_RCC_GPIOA_CLK_ENABLE();
+	GPIO_InitStruct.Pin = USB_CDC_Pins;
+	GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+	GPIO_InitStruct.Pull = GPIO_NOPULL;
+	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+	GPIO_InitStruct.Alternate = GPIO_AF10_OTG_FS;
+	HAL_GPIO_Init(USB_CDC_GPIO_Port, &GPIO_InitStruct);
+	__HAL_RCC_USB_OTG_FS_CLK_ENABLE();
+
+	/* Embedded PHY, core soft reset */
+	otg->GAHBCFG &= ~USB_OTG_GAHBCFG_GINT;
+	otg->GUSBCFG |= USB_OTG_GUSBCFG_PHYSEL;
+	(void) Usb_Cdc_Wait(&otg->GRSTCTL, USB_OTG_GRSTCTL_AHBIDL,
+			USB_OTG_GRSTCTL_AHBIDL);
+	otg->GRSTCTL |= USB_OTG_GRSTCTL_CSRST;
+	(void) Usb_Cdc_Wait(&otg->GRSTCTL, USB_OTG_GRSTCTL_CSRST, 0U);
+
+	/* Transceiver on, no VBUS pin: B-session forced valid */
+	otg->GCCFG = USB_OTG_GCCFG_PWRDWN;
+	otg->GOTGCTL |= USB_OTG_GOTGCTL_BVALOEN | USB_OTG_GOTGCTL_BVALOVAL;
+	otg->GUSBCFG = (otg->GUSBCFG
+			& ~(USB_OTG_GUSBCFG_FHMOD | USB_OTG_GUSBCFG_TRDT))
+			| USB_OTG_GUSBCFG_FDMOD | (USB_CDC_TRDT << USB_OTG_GUSBCFG_TRDT_Pos);
+	HAL_Delay(USB_CDC_FORCE_MS);
+
+	/* Device mode, full speed, disconnected while the FIFOs are set up */
+	USB_CDC_PCGCCTL = 0U;
+	USB_CDC_DEV->DCTL |= USB_OTG_DCTL_SDIS;
+	USB_CDC_DEV->DCFG = (USB_CDC_DEV->DCFG & ~(USB_OTG_DCFG_DSPD
+			| USB_OTG_DCFG_DAD)) | USB_OTG_DCFG_DSPD;
+	otg->GRXFSIZ = USB_CDC_RXFIFO_WORDS;
+	otg->DIEPTXF0_HNPTXFSIZ = (USB_CDC_TXFIFO0_WORDS << 16)
+			| USB_CDC_RXFIFO_WORDS;
+	otg->DIEPTXF[0] = (USB_CDC_TXFIFO1_WORDS << 16)
+			| (USB_CDC_RXFIFO_WORDS + USB_CDC_TXFIFO0_WORDS);
+	otg->DIEPTXF[1] = (USB_CDC_TXFIFO2_WORDS << 16)
+			| (USB_CDC_RXFIFO_WORDS + USB_CDC_TXFIFO0_WORDS
+					+ USB_CDC_TXFIFO1_WORDS);
+	Usb_Cdc_FlushTx(0x10U);
+	otg->GRSTCTL = USB_OTG_GRSTCTL_RXFFLSH;
+	(void) Usb_Cdc_Wait(&otg->GRSTCTL, USB_OTG_GRSTCTL_RXFFLSH, 0U);
+
+	USB_CDC_DEV->DIEPMSK = 0U;
+	USB_CDC_DEV->DOEPMSK = 0U;
+	USB_CDC_DEV->DAINTMSK = 0U;
+	for (ep = 0U; ep <= USB_CDC_EP_NOTIFY; ep++) {
+		USB_CDC_IN(ep)->DIEPINT = 0xFFU;
+		USB_CDC_OUT(ep)->DOEPINT = 0xFFU;
+	}
+	UsbRxRing_Init(&usb_rx);
+	Usb_Cdc_MakeSerial();
+	usb_configured = 0U;
+	usb_dtr = 0U;
+	usb_suspended = 0U;
+	usb_tx_busy = 0U;
+
+	otg->GINTSTS = 0xFFFFFFFFU;
+	otg->GINTMSK = USB_OTG_GINTMSK_USBRST | USB_OTG_GINTMSK_ENUMDNEM
+			| USB_OTG_GINTMSK_RXFLVLM | USB_OTG_GINTMSK_IEPINT
+			| USB_OTG_GINTMSK_OEPINT | USB_OTG_GINTMSK_USBSUSPM
+			| USB_OTG_GINTMSK_WUIM;
+	otg->GAHBCFG |= USB_OTG_GAHBCFG_GINT;
+	HAL_NVIC_SetPriority(OTG_FS_IRQn, IRQ_PRIO_UART, 0U);
+	HAL_NVIC_EnableIRQ(OTG_FS_IRQn);
+	usb_started = 1U;
+
+	/* D+ pull-up on: the host resets and enumerates the device */
+	USB_CDC_DEV->DCTL &= ~USB_OTG_DCTL_SDIS;
+	return 1U;
+}
+
+/**
+ * @brief Disconnects and powers down, leaving usb_wanted alone.
+ */
+static void Usb_Cdc_Shutdown(void) {
+	uint32_t basepri;
+
+	if (usb_started == 0U) {
+		return;
+	}
+	basepri = Irq_MaskFrom(IRQ_PRIO_UART);
+	usb_configured = 0U;
+	usb_dtr = 0U;
+	Usb_Cdc_AbortTx();
+	USB_CDC_DEV->DCTL |= USB_OTG_DCTL_SDIS;
+	HAL_NVIC_DisableIRQ(OTG_FS_IRQn);
+	usb_started = 0U;
+	Irq_Unmask(basepri);
+
+	/* Output goes back to the ST-LINK bridge, unless Modbus has it */
+	(void) UART_TX_SetTransport((Modbus_IsActive() != 0U) ?
+			UART_TX_TRANSPORT_NONE : UART_TX_TRANSPORT_USART2);
+
+	USB_CDC_OTG->GCCFG &= ~USB_OTG_GCCFG_PWRDWN;
+	__HAL_RCC_USB_OTG_FS_CLK_DISABLE();
+	HAL_GPIO_DeInit(USB_CDC_GPIO_Port, USB_CDC_Pins);
+	__HAL_RCC_PLLSAI_DISABLE();
+}
+
+/**
+ * @brief Disconnects and powers down.
+ */
+void Usb_Cdc_Stop(void) {
+	usb_wanted = 0U;
+	Usb_Cdc_Shutdown();
+}
+
+/**
+ * @brief Reports whether the device is started.
+ */
+uint8_t Usb_Cdc_IsStarted(void) {
+	return usb_started;
+}
+
+/**
+ * @brief Reports whether the host opened the port.
+ */
+uint8_t Usb_Cdc_IsOpen(void) {
+	return ((usb_started != 0U) && (usb_configured != 0U) && (usb_dtr != 0U)
+			&& (usb_suspended == 0U)) ? 1U : 0U;
+}
+
+/**
+ * @brief Starts one bulk IN transfer.
+ */
+uint8_t Usb_Cdc_Transmit(const uint8_t *data, uint32_t len) {
+	if ((usb_tx_busy != 0U) || (Usb_Cdc_IsOpen() == 0U) || (len == 0U)
+			|| (len > USB_CDC_TX_CHUNK)) {
+		return 0U;
+	}
+	Usb_Cdc_StartIn(data, len);
+	return 1U;
+}
+
+/**
+ * @brief Cancels the IN transfer in progress.
+ */
+void Usb_Cdc_AbortTx(void) {
+	USB_OTG_INEndpointTypeDef *ep = USB_CDC_IN(USB_CDC_EP_DATA);
+	uint32_t basepri = Irq_MaskFrom(IRQ_PRIO_UART);
+	uint32_t len = usb_tx_len;
+
+	if (usb_tx_busy == 0U) {
+		Irq_Unmask(basepri);
+		return;
+	}
+	if ((ep->DIEPCTL & USB_OTG_DIEPCTL_EPENA) != 0U) {
+		ep->DIEPCTL |= USB_OTG_DIEPCTL_SNAK;
+		(void) Usb_Cdc_Wait(&ep->DIEPINT, USB_OTG_DIEPINT_INEPNE,
+				USB_OTG_DIEPINT_INEPNE);
+		ep->DIEPCTL |= USB_OTG_DIEPCTL_EPDIS | USB_OTG_DIEPCTL_SNAK;
+		(void) Usb_Cdc_Wait(&ep->DIEPINT, USB_OTG_DIEPINT_EPDISD,
+				USB_OTG_DIEPINT_EPDISD);
+		ep->DIEPINT = USB_OTG_DIEPINT_EPDISD | USB_OTG_DIEPINT_INEPNE;
+	}
+	Usb_Cdc_FlushTx(USB_CDC_EP_DATA);
+	usb_tx_busy = 0U;
+	usb_tx_zlp = 0U;
+	if (len != 0U) {
+		UART_TX_AbortCallback();
+	}
+	Irq_Unmask(basepri);
+}
+
+/**
+ * @brief Copies out bytes received from the host.
+ */
+uint32_t Usb_Cdc_Read(uint8_t *out, uint32_t max) {
+	uint32_t count = 0U;
+	uint32_t basepri;
+
+	while ((count < max) && (UsbRxRing_Pop(&usb_rx, &out[count]) != 0U)) {
+		count++;
+	}
+	if ((usb_rx_armed == 0U) && (usb_configured != 0U)) {
+		basepri = Irq_MaskFrom(IRQ_PRIO_UART);
+		if ((usb_rx_armed == 0U) && (usb_configured != 0U)) {
+			Usb_Cdc_ArmRx();
+		}
+		Irq_Unmask(basepri);
+	}
+	return count;
+}
+
+/**
+ * @brief Follows a clock profile switch.
+ */
+void Usb_Cdc_ClockChanged(void) {
+	if (Usb_Cdc_ClockOk() == 0U) {
+		Usb_Cdc_Shutdown();
+	} else if ((usb_wanted != 0U) && (usb_started == 0U)) {
+		(void) Usb_Cdc_Start();
+	}
+}
+
+/**
+ * @brief OTG FS interrupt body.
+ */
+void Usb_Cdc_IRQHandler(void) {
+	USB_OTG_GlobalTypeDef *otg = USB_CDC_OTG;
+	uint32_t status = otg->GINTSTS & otg->GINTMSK;
+
+	if ((status & USB_OTG_GINTSTS_USBRST) != 0U) {
+		otg->GINTSTS = USB_OTG_GINTSTS_USBRST;
+		Usb_Cdc_BusReset();
+	}
+	if ((status & USB_OTG_GINTSTS_ENUMDNE) != 0U) {
+		otg->GINTSTS = USB_OTG_GINTSTS_ENUMDNE;
+		/* Full speed: EP0 packets of 64 bytes (MPSIZ 0) */
+		USB_CDC_IN(0U)->DIEPCTL &= ~USB_OTG_DIEPCTL_MPSIZ;
+		USB_CDC_DEV->DCTL |= USB_OTG_DCTL_CGINAK;
+	}
+	if ((status & USB_OTG_GINTSTS_RXFLVL) != 0U) {
+		otg->GINTMSK &= ~USB_OTG_GINTMSK_RXFLVLM;
+		while ((otg->GINTSTS & USB_OTG_GINTSTS_RXFLVL) != 0U) {
+			Usb_Cdc_RxLevel();
+		}
+		otg->GINTMSK |= USB_OTG_GINTMSK_RXFLVLM;
+	}
+	if ((status & USB_OTG_GINTSTS_OEPINT) != 0U) {
+		Usb_Cdc_OutEndpoints();
+	}
+	if ((status & USB_OTG_GINTSTS_IEPINT) != 0U) {
+		Usb_Cdc_InEndpoints();
+	}
+	if ((status & USB_OTG_GINTSTS_USBSUSP) != 0U) {
+		/* Host asleep or, without VBUS sensing, the cable pulled */
+		otg->GINTSTS = USB_OTG_GINTSTS_USBSUSP;
+		usb_suspended = 1U;
+		Usb_Cdc_AbortTx();
+	}
+	if ((status & USB_OTG_GINTSTS_WKUINT) != 0U) {
+		otg->GINTSTS = USB_OTG_GINTSTS_WKUINT;
+		usb_suspended = 0U;
+	}
+}
+
+#endif /* USB_USE_CDC */
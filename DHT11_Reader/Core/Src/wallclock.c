@@ -0,0 +1,401 @@
+/**
+ ******************************************************************************
+ * @file           : wallclock.c
+ * @brief          : UTC wall-clock time on the RTC, set by the host.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "wallclock.h"
+
+#if WALLCLOCK_USE_SYNC
+
+#include "power.h"
+
+/** RTC_BKP0R: magic in the upper half once synced, frequency below */
+#define WALLCLOCK_BKP_MAGIC  (0x57C1U)
+
+/** Smooth calibration: CALP adds 512 pulses, CALM removes up to 511,
+ * per window of 2^20 RTC cycles */
+#define WALLCLOCK_CAL_MIN    (-511)
+#define WALLCLOCK_CAL_MAX    (512)
+#define WALLCLOCK_CAL_WINDOW (1048576)
+
+#define WALLCLOCK_DAY_S      (86400U)
+
+static uint8_t wallclock_synced = 0U;
+static int32_t wallclock_freq = 0;
+static int32_t wallclock_slew = 0;         /* Pulses on top of the frequency */
+static uint32_t wallclock_slew_start = 0U;
+static uint32_t wallclock_slew_ms = 0U;
+static int64_t wallclock_base_ms = 0;      /* Host time the drift sum began */
+static int64_t wallclock_drift_ms = 0;     /* Offsets not due to a slew     */
+static wallclock_stats_t wallclock_stats;
+
+/**
+ * @brief Removes RTC write protection.
+ */
+static void Wallclock_RtcUnlock(void) {
+	RTC->WPR = 0xCAU;
+	RTC->WPR = 0x53U;
+}
+
+/**
+ * @brief Restores RTC write protection.
+ */
+static void Wallclock_RtcLock(void) {
+	RTC->WPR = 0xFFU;
+}
+
+/**
+ * @brief Two BCD digits.
+ */
+static uint32_t Wallclock_Bcd(uint32_t value) {
+	return ((value / 10U) << 4) | (value % 10U);
+}
+
+/**
+ * @brief Splits days since 2000-01-01 into year (0-99), month and day.
+ */
+static uint32_t Wallclock_Date(uint32_t days, uint32_t *month, uint32_t *day) {
+	static const uint8_t month_len[12] = { 31U, 28U, 31U, 30U, 31U, 30U,
+			31U, 31U, 30U, 31U, 30U, 31U };
+	uint32_t year = 0U;
+	uint32_t len;
+
+	/* 2000-2099: every fourth year is a leap year */
+	for (;;) {
+		len = ((year % 4U) == 0U) ? 366U : 365U;
+		if (days < len) {
+			break;
+		}
+		days -= len;
+		year++;
+	}
+	*month = 0U;
+	for (;;) {
+		len = month_len[*month];
+		if ((*month == 1U) && ((year % 4U) == 0U)) {
+			len++;
+		}
+		if (days < len) {
+			break;
+		}
+		days -= len;
+		(*month)++;
+	}
+	(*month)++;
+	*day = days + 1U;
+	return year;
+}
+
+/**
+ * @brief Milliseconds since 2000-01-01 00:00 on the RTC.
+ */
+static int64_t Wallclock_LocalMs(void) {
+	uint32_t secs;
+	uint32_t us;
+
+	secs = Power_GetRtcTime(&us);
+	return ((int64_t) secs * 1000) + (int64_t) (us / 1000U);
+}
+
+/**
+ * @brief Loads RTC_CALR; positive pulses speed the RTC up.
+ */
+static void Wallclock_SetCalibration(int32_t pulses) {
+	if (pulses > WALLCLOCK_CAL_MAX) {
+		pulses = WALLCLOCK_CAL_MAX;
+	} else if (pulses < WALLCLOCK_CAL_MIN) {
+		pulses = WALLCLOCK_CAL_MIN;
+	}
+
+	Wallclock_RtcUnlock();
+	while ((RTC->ISR & RTC_ISR_RECALPF) != 0U) {
+		/* Previous value still being taken over, a few RTCCLK periods */
+	}
+	RTC->CALR = (pulses > 0) ?
+			(RTC_CALR_CALP | (uint32_t) (WALLCLOCK_CAL_MAX - pulses)) :
+			(uint32_t) (0 - pulses);
+	Wallclock_RtcLock();
+}
+
+/**
+ * @brief Stores the synced state and frequency in the backup domain.
+ */
+static void Wallclock_Save(void) {
+	RTC->BKP0R = (WALLCLOCK_BKP_MAGIC << 16)
+			| ((uint32_t) wallclock_freq & 0xFFFFU);
+}
+
+/**
+ * @brief Sets the calendar to t_ms after 2000-01-01 00:00. The sub-second
+ *        counter restarts on leaving init mode; SHIFTR then advances it by
+ *        the milliseconds (one second forward, the rest delayed).
+ */
+static void Wallclock_SetCalendar(int64_t t_ms) {
+	uint32_t secs = (uint32_t) (t_ms / 1000);
+	uint32_t ms = (uint32_t) (t_ms % 1000);
+	uint32_t days = secs / WALLCLOCK_DAY_S;
+	uint32_t sod = secs % WALLCLOCK_DAY_S;
+	uint32_t subsec_hz = (RTC->PRER & RTC_PRER_PREDIV_S) + 1U;
+	uint32_t year;
+	uint32_t month;
+	uint32_t day;
+	uint32_t tr;
+	uint32_t dr;
+
+	year = Wallclock_Date(days, &month, &day);
+	tr = (Wallclock_Bcd(sod / 3600U) << RTC_TR_HU_Pos)
+			| (Wallclock_Bcd((sod / 60U) % 60U) << RTC_TR_MNU_Pos)
+			| (Wallclock_Bcd(sod % 60U) << RTC_TR_SU_Pos);
+	/* 2000-01-01 was a Saturday; WDU counts Monday as 1 */
+	dr = (Wallclock_Bcd(year) << RTC_DR_YU_Pos)
+			| ((((days + 5U) % 7U) + 1U) << RTC_DR_WDU_Pos)
+			| (Wallclock_Bcd(month) << RTC_DR_MU_Pos)
+			| (Wallclock_Bcd(day) << RTC_DR_DU_Pos);
+
+	Wallclock_RtcUnlock();
+	RTC->ISR |= RTC_ISR_INIT;
+	while ((RTC->ISR & RTC_ISR_INITF) == 0U) {
+		/* Up to two RTCCLK periods */
+	}
+	RTC->TR = tr;
+	RTC->DR = dr;
+	RTC->ISR &= ~RTC_ISR_INIT;
+	while ((RTC->ISR & RTC_ISR_INITF) != 0U) {
+		/* Counting restarts a few RTCCLK periods later */
+	}
+	if (ms != 0U) {
+		while ((RTC->ISR & RTC_ISR_SHPF) != 0U) {
+			/* No shift pending right after init */
+		}
+		RTC->SHIFTR = RTC_SHIFTR_ADD1S
+				| ((subsec_hz * (1000U - ms)) / 1000U);
+	}
+	Wallclock_RtcLock();
+}
+
+/**
+ * @brief Part of the last offset the running slew has yet to remove.
+ */
+static int64_t Wallclock_SlewPending(void) {
+	uint32_t elapsed;
+
+	if (wallclock_slew_ms == 0U) {
+		return 0;
+	}
+	elapsed = HAL_GetTick() - wallclock_slew_start;
+	if (elapsed >= wallclock_slew_ms) {
+		return 0;
+	}
+	return ((int64_t) (wallclock_slew_ms - elapsed) * wallclock_slew)
+			/ WALLCLOCK_CAL_WINDOW;
+}
+
+/**
+ * @brief Runs the RTC fast or slow for as long as offset_ms takes, within
+ *        what the calibration range leaves beside the frequency correction.
+ */
+static void Wallclock_StartSlew(int64_t offset_ms) {
+	int32_t slew = (offset_ms > 0) ? WALLCLOCK_SLEW_PULSES :
+			-WALLCLOCK_SLEW_PULSES;
+
+	if ((wallclock_freq + slew) > WALLCLOCK_CAL_MAX) {
+		slew = WALLCLOCK_CAL_MAX - wallclock_freq;
+	} else if ((wallclock_freq + slew) < WALLCLOCK_CAL_MIN) {
+		slew = WALLCLOCK_CAL_MIN - wallclock_freq;
+	}
+	if ((offset_ms == 0) || (slew == 0)) {
+		wallclock_slew_ms = 0U;
+		Wallclock_SetCalibration(wallclock_freq);
+		return;
+	}
+
+	wallclock_slew = slew;
+	wallclock_slew_ms = (uint32_t) ((offset_ms * WALLCLOCK_CAL_WINDOW) / slew);
+	wallclock_slew_start = HAL_GetTick();
+	Wallclock_SetCalibration(wallclock_freq + slew);
+}
+
+/**
+ * @brief Restores the synced state and frequency correction.
+ */
+void Wallclock_Init(void) {
+	uint32_t bkp = RTC->BKP0R;
+
+	if (((RCC->BDCR & RCC_BDCR_RTCEN) != 0U)
+			&& ((bkp >> 16) == WALLCLOCK_BKP_MAGIC)) {
+		wallclock_synced = 1U;
+		wallclock_freq = (int32_t) (int16_t) (bkp & 0xFFFFU);
+		/* Ends a slew the reset cut short */
+		Wallclock_SetCalibration(wallclock_freq);
+	}
+}
+
+/**
+ * @brief Reports whether the calendar holds host time.
+ */
+uint8_t Wallclock_IsSynced(void) {
+	return wallclock_synced;
+}
+
+/**
+ * @brief Current time in Unix seconds.
+ */
+uint32_t Wallclock_Now(uint32_t *ms) {
+	int64_t t = Wallclock_LocalMs();
+
+	if (ms != NULL) {
+		*ms = (uint32_t) (t % 1000);
+	}
+	return (uint32_t) (t / 1000) + WALLCLOCK_UNIX_2000;
+}
+
+/**
+ * @brief Time at which the HAL tick read tick_ms.
+ */
+uint32_t Wallclock_FromTick(uint32_t tick_ms, uint32_t *ms) {
+	int64_t t = Wallclock_LocalMs() - (int64_t) (HAL_GetTick() - tick_ms);
+
+	if (t < 0) {
+		t = 0;
+	}
+	if (ms != NULL) {
+		*ms = (uint32_t) (t % 1000);
+	}
+	return (uint32_t) (t / 1000) + WALLCLOCK_UNIX_2000;
+}
+
+/**
+ * @brief Takes the host's time and steps or slews towards it.
+ */
+wallclock_sync_t Wallclock_Sync(uint32_t unix_s, uint32_t ms,
+		int32_t *offset_ms) {
+	int64_t host;
+	int64_t offset;
+	int64_t span;
+	int64_t drift;
+
+	if ((unix_s < WALLCLOCK_UNIX_2000) || (unix_s > WALLCLOCK_UNIX_MAX)
+			|| (ms > 999U) || ((RCC->BDCR & RCC_BDCR_RTCEN) == 0U)) {
+		return WALLCLOCK_REJECTED;
+	}
+
+	host = ((int64_t) (unix_s - WALLCLOCK_UNIX_2000) * 1000) + (int64_t) ms;
+	offset = host - Wallclock_LocalMs();
+	if (offset > INT32_MAX) {
+		*offset_ms = INT32_MAX;
+	} else if (offset < INT32_MIN) {
+		*offset_ms = INT32_MIN;
+	} else {
+		*offset_ms = (int32_t) offset;
+	}
+	wallclock_stats.syncs++;
+	wallclock_stats.offset_ms = *offset_ms;
+
+	if ((wallclock_synced == 0U) || (offset > (int64_t) WALLCLOCK_STEP_MS)
+			|| (offset < -(int64_t) WALLCLOCK_STEP_MS)) {
+		Wallclock_SetCalendar(host);
+		wallclock_slew_ms = 0U;
+		Wallclock_SetCalibration(wallclock_freq);
+		wallclock_synced = 1U;
+		wallclock_base_ms = host;
+		wallclock_drift_ms = 0;
+		wallclock_stats.steps++;
+		Wallclock_Save();
+		return WALLCLOCK_STEPPED;
+	}
+
+	/* What the running slew would still have removed is not drift. Once
+	 * the sum spans long enough, half of it goes into the frequency. */
+	wallclock_drift_ms += offset - Wallclock_SlewPending();
+	span = host - wallclock_base_ms;
+	if (span >= (int64_t) WALLCLOCK_FREQ_MIN_MS) {
+		drift = (wallclock_drift_ms * WALLCLOCK_CAL_WINDOW) / span;
+		wallclock_freq += (int32_t) (drift / 2);
+		if (wallclock_freq > WALLCLOCK_CAL_MAX) {
+			wallclock_freq = WALLCLOCK_CAL_MAX;
+		} else if (wallclock_freq < WALLCLOCK_CAL_MIN) {
+			wallclock_freq = WALLCLOCK_CAL_MIN;
+		}
+		wallclock_base_ms = host;
+		wallclock_drift_ms = 0;
+		Wallclock_Save();
+	}
+
+	Wallclock_StartSlew(offset);
+	return WALLCLOCK_SLEWING;
+}
+
+/**
+ * @brief Ends a finished slew.
+ */
+void Wallclock_Poll(void) {
+	if ((wallclock_slew_ms != 0U)
+			&& ((HAL_GetTick() - wallclock_slew_start) >= wallclock_slew_ms)) {
+		wallclock_slew_ms = 0U;
+		Wallclock_SetCalibration(wallclock_freq);
+	}
+}
+
+/**
+ * @brief Copies the discipline state.
+ */
+void Wallclock_GetStats(wallclock_stats_t *stats) {
+	uint32_t elapsed = HAL_GetTick() - wallclock_slew_start;
+
+	*stats = wallclock_stats;
+	stats->freq = wallclock_freq;
+	stats->slew_ms = ((wallclock_slew_ms != 0U)
+			&& (elapsed < wallclock_slew_ms)) ?
+			(wallclock_slew_ms - elapsed) : 0U;
+}
+
+/**
+ * @brief Appends "YYYY-MM-DDTHH:MM:SS.mmmZ".
+ */
+void Wallclock_Format(fmt_t *f, uint32_t unix_s, uint32_t ms) {
+	uint32_t secs = (unix_s > WALLCLOCK_UNIX_2000) ?
+			(unix_s - WALLCLOCK_UNIX_2000) : 0U;
+	uint32_t sod = secs % WALLCLOCK_DAY_S;
+	uint32_t year;
+	uint32_t month;
+	uint32_t day;
+
+	year = Wallclock_Date(secs / WALLCLOCK_DAY_S, &month, &day);
+	Fmt_Uint(f, 2000U + year, 4U, '0');
+	Fmt_Char(f, '-');
+	Fmt_Uint(f, month, 2U, '0');
+	Fmt_Char(f, '-');
+	Fmt_Uint(f, day, 2U, '0');
+	Fmt_Char(f, 'T');
+	Fmt_Uint(f, sod / 3600U, 2U, '0');
+	Fmt_Char(f, ':');
+	Fmt_Uint(f, (sod / 60U) % 60U, 2U, '0');
+	Fmt_Char(f, ':');
+	Fmt_Uint(f, sod % 60U, 2U, '0');
+	Fmt_Char(f, '.');
+	Fmt_Uint(f, ms, 3U, '0');
+	Fmt_Char(f, 'Z');
+}
+
+/**
+ * @brief Appends the time of a HAL tick and a space once synced.
+ */
+void Wallclock_Stamp(fmt_t *f, uint32_t tick_ms) {
+	uint32_t secs;
+	uint32_t ms;
+
+	if (wallclock_synced == 0U) {
+		return;
+	}
+	secs = Wallclock_FromTick(tick_ms, &ms);
+	Wallclock_Format(f, secs, ms);
+	Fmt_Char(f, ' ');
+}
+
+#endif /* WALLCLOCK_USE_SYNC */
@@ -0,0 +1,213 @@
+/**
+ ******************************************************************************
+ * @file           : watchdog.c
+ * @brief          : IWDG supervisor refreshed only while every subsystem
+ *                   checks in.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "watchdog.h"
+#include "power.h"
+#include "memmap.h"
+#include <stdio.h>
+
+/** IWDG key register values */
+#define WATCHDOG_KEY_RELOAD   (0xAAAAU)
+#define WATCHDOG_KEY_ACCESS   (0x5555U)
+#define WATCHDOG_KEY_START    (0xCCCCU)
+
+/** Largest reload value plus one, and prescaler codes (LSI / 4 << PR) */
+#define WATCHDOG_RELOAD_MAX   (4096U)
+#define WATCHDOG_PR_MAX       (6U)
+
+#define WATCHDOG_MAGIC        (0x57444F47U) /* "WDOG" */
+#define WATCHDOG_NAME_LEN     (12U)
+
+/**
+ * @brief One liveness token.
+ */
+typedef struct {
+	const char *name;
+	uint32_t max_age_ms;
+	watchdog_probe_fn_t probe;
+	volatile uint32_t last_ms;  /*!< HAL tick of the last check-in */
+} watchdog_token_t;
+
+/**
+ * @brief Trip record kept across the IWDG reset in .noinit.
+ */
+typedef struct {
+	uint32_t magic;
+	char name[WATCHDOG_NAME_LEN];
+	uint32_t age_ms;
+	uint32_t check;             /*!< ~age_ms, against .noinit garbage */
+} watchdog_trip_t;
+
+static watchdog_token_t wdg_tokens[WATCHDOG_MAX_TOKENS];
+static uint32_t wdg_token_count = 0U;
+
+static watchdog_trip_t wdg_trip NOINIT;
+
+static uint32_t wdg_timeout_ms = 0U;
+static uint32_t wdg_last_service_ms = 0U;
+static uint8_t wdg_stale = WATCHDOG_NO_TOKEN;
+
+/**
+ * @brief Reports the token that tripped the supervisor before the reset.
+ */
+void Watchdog_Init(void) {
+	if ((wdg_trip.magic == WATCHDOG_MAGIC) && (wdg_trip.check == ~wdg_trip.age_ms)
+			&& (wdg_trip.name[WATCHDOG_NAME_LEN - 1U] == '\0')) {
+		printf("Watchdog: tripped by %s, silent %lu ms\r\n", wdg_trip.name,
+				wdg_trip.age_ms);
+	}
+	wdg_trip.magic = 0U;
+}
+
+/**
+ * @brief Adds a liveness token, fresh from now.
+ */
+uint8_t Watchdog_Register(const char *name, uint32_t max_age_ms,
+		watchdog_probe_fn_t probe) {
+	watchdog_token_t *token;
+
+	if (wdg_token_count >= WATCHDOG_MAX_TOKENS) {
+		return WATCHDOG_NO_TOKEN;
+	}
+	token = &wdg_tokens[wdg_token_count];
+	token->name = name;
+	token->max_age_ms = max_age_ms;
+	token->probe = probe;
+	token->last_ms = HAL_GetTick();
+	return (uint8_t) wdg_token_count++;
+}
+
+/**
+ * @brief Marks a token fresh.
+ */
+void Watchdog_Checkin(uint8_t id) {
+	if (id < wdg_token_count) {
+		wdg_tokens[id].last_ms = HAL_GetTick();
+	}
+}
+
+/**
+ * @brief Starts the IWDG or changes its timeout.
+ */
+void Watchdog_Start(uint32_t timeout_ms) {
+	uint32_t lsi_hz = Power_GetLsiHz();
+	uint32_t reload = 0U;
+	uint32_t pr;
+
+	/* Smallest prescaler that fits, for the finest resolution */
+	for (pr = 0U; pr <= WATCHDOG_PR_MAX; pr++) {
+		reload = (uint32_t) (((uint64_t) timeout_ms * lsi_hz)
+				/ ((4UL << pr) * 1000U));
+		if (reload <= WATCHDOG_RELOAD_MAX) {
+			break;
+		}
+	}
+	if (pr > WATCHDOG_PR_MAX) {
+		pr = WATCHDOG_PR_MAX;
+		reload = WATCHDOG_RELOAD_MAX;
+	}
+	if (reload == 0U) {
+		reload = 1U;
+	}
+
+	/* Counting on while the core is halted would reset it under a debugger */
+	DBGMCU->APB1FZ |= DBGMCU_APB1_FZ_DBG_IWDG_STOP;
+
+	IWDG->KR = WATCHDOG_KEY_START; /* Also starts the LSI, if it was off */
+	IWDG->KR = WATCHDOG_KEY_ACCESS;
+	IWDG->PR = pr;
+	IWDG->RLR = reload - 1U;
+	while (IWDG->SR != 0U) {
+		/* PR/RLR cross into the LSI domain in a few LSI periods */
+	}
+	IWDG->KR = WATCHDOG_KEY_RELOAD;
+
+	wdg_timeout_ms = (uint32_t) (((uint64_t) reload * (4UL << pr) * 1000U)
+			/ lsi_hz);
+	wdg_last_service_ms = HAL_GetTick();
+}
+
+/**
+ * @brief Latches the first stale token and records it for the next boot.
+ *        Prints nothing: under FreeRTOS this runs on the idle task stack.
+ */
+static void Watchdog_Trip(uint8_t id, uint32_t age_ms) {
+	const char *name = wdg_tokens[id].name;
+	uint32_t i;
+
+	wdg_stale = id;
+	for (i = 0U; (i < (WATCHDOG_NAME_LEN - 1U)) && (name[i] != '\0'); i++) {
+		wdg_trip.name[i] = name[i];
+	}
+	for (; i < WATCHDOG_NAME_LEN; i++) {
+		wdg_trip.name[i] = '\0';
+	}
+	wdg_trip.age_ms = age_ms;
+	wdg_trip.check = ~age_ms;
+	wdg_trip.magic = WATCHDOG_MAGIC;
+}
+
+/**
+ * @brief Checks the tokens and refreshes the IWDG if all are fresh.
+ */
+void Watchdog_Service(void) {
+	watchdog_token_t *token;
+	uint32_t now = HAL_GetTick();
+	uint32_t age;
+	uint32_t i;
+
+	if ((wdg_timeout_ms == 0U) || (wdg_stale != WATCHDOG_NO_TOKEN)
+			|| ((now - wdg_last_service_ms) < (WATCHDOG_SERVICE_MS / 2U))) {
+		return;
+	}
+	wdg_last_service_ms = now;
+
+	for (i = 0U; i < wdg_token_count; i++) {
+		token = &wdg_tokens[i];
+		if ((token->probe != NULL) && (token->probe() != 0U)) {
+			token->last_ms = now;
+		}
+		age = now - token->last_ms;
+		if ((int32_t) age > (int32_t) token->max_age_ms) {
+			Watchdog_Trip((uint8_t) i, age);
+			return;
+		}
+	}
+	IWDG->KR = WATCHDOG_KEY_RELOAD;
+}
+
+/**
+ * @brief Timeout actually programmed.
+ */
+uint32_t Watchdog_GetTimeoutMs(void) {
+	return wdg_timeout_ms;
+}
+
+/**
+ * @brief Name of the stale token.
+ */
+const char* Watchdog_GetStale(void) {
+	return (wdg_stale != WATCHDOG_NO_TOKEN) ? wdg_tokens[wdg_stale].name : "none";
+}
+
+/**
+ * @brief Prints one line per token with its age.
+ */
+void Watchdog_Dump(void) {
+	uint32_t now = HAL_GetTick();
+	uint32_t i;
+
+	for (i = 0U; i < wdg_token_count; i++) {
+		printf("wdg %s age %lu max %lu\r\n", wdg_tokens[i].name,
+				now - wdg_tokens[i].last_ms, wdg_tokens[i].max_age_ms);
+	}
+}
@@ -0,0 +1,247 @@
+/**
+ ******************************************************************************
+ * @file           : watermark.c
+ * @brief          : Stack high-water mark and interrupt entry latency.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "watermark.h"
+#include "app_pools.h"
+#include "clock_config.h"
+#include "power.h"
+#include <stddef.h>
+#include <string.h>
+
+/* Linker script symbols; only their addresses mean anything */
+extern uint32_t _spaint;
+extern uint32_t _estack;
+extern uint32_t _Min_Stack_Size;
+
+#if !APP_NO_HEAP
+extern void *_sbrk(ptrdiff_t incr);
+#endif /* !APP_NO_HEAP */
+
+/**
+ * @brief Measures the main stack use from the paint left.
+ */
+void Watermark_GetStack(watermark_stack_t *stack) {
+	const uint32_t *top = &_estack;
+	const uint32_t *floor = &_spaint;
+	const uint32_t *word;
+#if !APP_NO_HEAP
+	uint32_t heap = ((uint32_t) _sbrk(0) + 3U) & ~3U;
+
+	/* The heap may have grown over the paint: those words are not stack */
+	if (heap > (uint32_t) floor) {
+		floor = (const uint32_t*) heap;
+	}
+#endif /* !APP_NO_HEAP */
+
+	for (word = floor; (word < top) && (*word == WATERMARK_STACK_PAINT);
+			word++) {
+	}
+	stack->used = (uint32_t) (top - word) * 4U;
+	stack->reserved = (uint32_t) &_Min_Stack_Size;
+	stack->painted = (uint32_t) (top - floor) * 4U;
+	stack->exhausted = (word == floor) ? 1U : 0U;
+}
+
+#if WATERMARK_USE_LATENCY
+
+/** TIM11 ticks between probes stay within this, jitter included */
+#define WATERMARK_PROBE_MAX_STEP (52428U)
+
+static const char *const watermark_names[WATERMARK_IRQ_COUNT] = { "systick",
+		"tim6", "probe" };
+
+/* Each entry written by its own handler; the levels never nest */
+static watermark_lat_t watermark_lat[WATERMARK_IRQ_COUNT];
+static uint32_t watermark_scale[WATERMARK_IRQ_COUNT]; /* Cycles per tick */
+
+#if WATERMARK_USE_PROBE
+/* Probe, TIM11 handler and Watermark_ClockChanged() with it masked */
+static uint32_t probe_base = 0U;       /* Mean step, TIM11 ticks            */
+static uint32_t probe_wrap = 0U;       /* A full TIM11 count, in cycles    */
+static uint32_t probe_step = 0U;       /* Of the compare just served       */
+static uint32_t probe_entry = 0U;      /* CYCCNT at the last entry         */
+static uint32_t probe_last = 0U;       /* Its latency, in cycles           */
+static uint32_t probe_stops = 0U;      /* Power_GetStopCount() then        */
+static uint8_t probe_chain = 0U;       /* The above describe the last probe */
+static uint16_t probe_lfsr = 0xACE1U;
+#endif /* WATERMARK_USE_PROBE */
+
+/**
+ * @brief Adds one latency to a handler's figures.
+ */
+static void Watermark_Store(watermark_irq_t irq, uint32_t cycles) {
+	watermark_lat_t *lat = &watermark_lat[irq];
+
+	lat->count++;
+	lat->last = cycles;
+	lat->sum += cycles;
+	if (cycles > lat->max) {
+		lat->max = cycles;
+	}
+}
+
+#if WATERMARK_USE_PROBE
+/**
+ * @brief Next probe step: 0.75 to 1.25 of the base, pseudo-random.
+ */
+static uint32_t Watermark_NextStep(void) {
+	probe_lfsr = (uint16_t) ((probe_lfsr >> 1)
+			^ ((0U - (probe_lfsr & 1U)) & 0xB400U));
+	return (probe_base - (probe_base / 4U))
+			+ ((uint32_t) probe_lfsr % (probe_base / 2U));
+}
+#endif /* WATERMARK_USE_PROBE */
+
+/**
+ * @brief Tick scales of the sources and the TIM11 prescaler from the
+ *        clocks now; restarts the probe. TIM11 interrupt masked.
+ */
+static void Watermark_Clocks(void) {
+	uint32_t hclk = HAL_RCC_GetHCLKFreq();
+#if WATERMARK_USE_PROBE
+	uint32_t timer_hz = Clock_GetApb2TimerHz();
+	uint32_t ticks = (timer_hz / 1000000U) * WATERMARK_PROBE_US;
+	uint32_t psc = (ticks - 1U) / WATERMARK_PROBE_MAX_STEP;
+#endif /* WATERMARK_USE_PROBE */
+
+	watermark_scale[WATERMARK_IRQ_SYSTICK] =
+			((SysTick->CTRL & SysTick_CTRL_CLKSOURCE_Msk) != 0U) ? 1U : 8U;
+	watermark_scale[WATERMARK_IRQ_TIM6] = hclk / 1000000U;
+#if WATERMARK_USE_PROBE
+	watermark_scale[WATERMARK_IRQ_PROBE] = ((psc + 1U) * (hclk / 1000U))
+			/ (timer_hz / 1000U);
+	probe_base = ticks / (psc + 1U);
+	probe_wrap = 0x10000U * watermark_scale[WATERMARK_IRQ_PROBE];
+
+	TIM11->PSC = psc;
+	TIM11->EGR = TIM_EGR_UG; /* New prescaler now, count from 0 */
+	probe_step = Watermark_NextStep();
+	TIM11->CCR1 = probe_step;
+	TIM11->SR = ~TIM_SR_CC1IF;
+	probe_chain = 0U;
+#endif /* WATERMARK_USE_PROBE */
+}
+
+/**
+ * @brief Sets the tick scales; claims TIM11 and starts the probe.
+ */
+void Watermark_Init(void) {
+	Watermark_ResetLatency();
+
+#if WATERMARK_USE_PROBE
+	__HAL_RCC_TIM11_CLK_ENABLE();
+	TIM11->CR1 = 0U;
+	TIM11->ARR = 0xFFFFU;
+	TIM11->CCMR1 = 0U; /* Frozen output compare: just the event */
+	Watermark_Clocks();
+	TIM11->DIER = TIM_DIER_CC1IE;
+	HAL_NVIC_SetPriority(TIM1_TRG_COM_TIM11_IRQn, WATERMARK_PROBE_PRIO, 0U);
+	HAL_NVIC_EnableIRQ(TIM1_TRG_COM_TIM11_IRQn);
+	TIM11->CR1 = TIM_CR1_CEN;
+#else
+	Watermark_Clocks();
+#endif /* WATERMARK_USE_PROBE */
+}
+
+/**
+ * @brief Records a handler entry.
+ */
+void Watermark_Record(watermark_irq_t irq, uint32_t ticks) {
+	Watermark_Store(irq, ticks * watermark_scale[irq]);
+}
+
+/**
+ * @brief Copies the latency of one handler.
+ */
+void Watermark_GetLatency(watermark_irq_t irq, watermark_lat_t *lat) {
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	*lat = watermark_lat[(irq < WATERMARK_IRQ_COUNT) ?
+			irq : WATERMARK_IRQ_SYSTICK];
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @brief Clears the latencies.
+ */
+void Watermark_ResetLatency(void) {
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	memset(watermark_lat, 0, sizeof(watermark_lat));
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @brief Short printable name of a measured handler.
+ */
+const char* Watermark_IrqName(watermark_irq_t irq) {
+	return (irq < WATERMARK_IRQ_COUNT) ? watermark_names[irq] : "?";
+}
+
+/**
+ * @brief Recomputes the scales and the TIM11 prescaler.
+ */
+void Watermark_ClockChanged(void) {
+	uint32_t basepri = Irq_MaskFrom(WATERMARK_PROBE_PRIO);
+
+	Watermark_Clocks();
+	Irq_Unmask(basepri);
+}
+
+#endif /* WATERMARK_USE_LATENCY */
+
+#if WATERMARK_USE_PROBE
+
+/**
+ * @brief TIM11 compare: records the probe and schedules the next one.
+ */
+void Watermark_ProbeIRQHandler(uint32_t cnt) {
+	uint32_t now = DWT->CYCCNT;
+	uint32_t scale = watermark_scale[WATERMARK_IRQ_PROBE];
+	uint32_t stops = Power_GetStopCount();
+	uint32_t due;
+	uint32_t cycles;
+	int32_t chained;
+
+	if ((TIM11->SR & TIM_SR_CC1IF) == 0U) {
+		return;
+	}
+	TIM11->SR = ~TIM_SR_CC1IF;
+	due = TIM11->CCR1;
+	cycles = ((cnt - due) & 0xFFFFU) * scale;
+
+	/* Entries are a step apart plus the change in latency. Past a full
+	 * TIM11 count only CYCCNT tells; STOP halts it, so not across one */
+	if ((probe_chain != 0U) && (stops == probe_stops)) {
+		chained = (int32_t) (probe_last + (now - probe_entry)
+				- (probe_step * scale));
+		if (chained > (int32_t) probe_wrap) {
+			cycles = (uint32_t) chained;
+		}
+	}
+	Watermark_Store(WATERMARK_IRQ_PROBE, cycles);
+
+	probe_entry = now;
+	probe_last = cycles;
+	probe_stops = stops;
+	probe_chain = 1U;
+	probe_step = Watermark_NextStep();
+	TIM11->CCR1 = (due + probe_step) & 0xFFFFU;
+	if (((TIM11->CNT - due) & 0xFFFFU) >= probe_step) {
+		/* Already past the next compare: start over from now */
+		TIM11->CCR1 = (TIM11->CNT + probe_step) & 0xFFFFU;
+		probe_chain = 0U;
+	}
+}
+
+#endif /* WATERMARK_USE_PROBE */
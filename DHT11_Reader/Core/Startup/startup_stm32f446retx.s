@@ -91,6 +91,21 @@ LoopFillZerobss:
   cmp r2, r4
   bcc FillZerobss
 
+/* Paint the stack from _spaint up to sp for its high-water mark
+ * (watermark.h); WATERMARK_STACK_PAINT is the same word */
+  ldr r2, =_spaint
+  ldr r3, =0xA5A5A5A5
+  mov r4, sp
+  b LoopPaintStack
+
+PaintStack:
+  str  r3, [r2]
+  adds r2, r2, #4
+
+LoopPaintStack:
+  cmp r2, r4
+  bcc PaintStack
+
 /* Call the clock system initialization function.*/
   bl  SystemInit   
 /* Call static constructors */
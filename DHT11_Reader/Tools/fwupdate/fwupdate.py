@@ -0,0 +1,202 @@
+#!/usr/bin/env python3
+"""Firmware uploader for the resident bootloader (Bootloader/boot.c).
+
+Frames and commands follow Core/Inc/boot_layout.h; the flow is in
+Docs/bootloader.md. Needs pyserial.
+
+    fwupdate.py flash /dev/ttyACM0 app.bin     update and start the image
+    fwupdate.py desc app.bin desc.bin          descriptor for a debugger-
+                                               flashed image, at 0x08004000
+"""
+
+import argparse
+import struct
+import sys
+import time
+
+BOOT_BAUD = 1000000
+BOOT_APP_SIZE = 192 * 1024
+BOOT_DESC_MAGIC = 0x31505041
+BOOT_SOF = 0xA5
+BOOT_CHUNK = 4096
+BOOT_REPLY_LEN = 8
+BOOT_REPLY_FLAG = 0x80
+
+CMD_INFO, CMD_BEGIN, CMD_WRITE, CMD_END, CMD_RUN = 1, 2, 3, 4, 5
+STATUS = {0: "ok", 1: "crc", 2: "sync", 3: "cmd", 4: "range", 5: "state",
+          6: "flash", 7: "image"}
+RESEND = (1, 2)  # Frame damaged in transit: send it again
+
+WINDOW = 2       # Frames in flight; the bootloader has two buffers
+ACK_S = 5.0      # Longest reply wait: a 128 KB sector erase
+SYNC_S = 0.1     # Past the bootloader's 50 ms stalled-frame restart
+RETRIES = 5
+
+
+def _crc_table():
+    table = []
+    for i in range(256):
+        crc = i << 24
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x04C11DB7) if crc & 0x80000000 else crc << 1
+        table.append(crc & 0xFFFFFFFF)
+    return table
+
+
+CRC_TABLE = _crc_table()
+
+
+def crc32_mpeg2(data):
+    """CRC unit result over little-endian words: bytes most significant
+    first within each word."""
+    words = struct.unpack("<%dI" % (len(data) // 4), data)
+    crc = 0xFFFFFFFF
+    for b in struct.pack(">%dI" % len(words), *words):
+        crc = ((crc << 8) & 0xFFFFFFFF) ^ CRC_TABLE[(crc >> 24) ^ b]
+    return crc
+
+
+def load_image(path):
+    with open(path, "rb") as f:
+        image = f.read()
+    image += b"\xff" * (-len(image) % 4)
+    if not 8 <= len(image) <= BOOT_APP_SIZE:
+        sys.exit("%s: %d bytes, the application area holds %d"
+                 % (path, len(image), BOOT_APP_SIZE))
+    return image
+
+
+def descriptor(image):
+    crc = crc32_mpeg2(image)
+    check = ~(BOOT_DESC_MAGIC ^ len(image) ^ crc) & 0xFFFFFFFF
+    return struct.pack("<4I", BOOT_DESC_MAGIC, len(image), crc, check)
+
+
+def frame(cmd, arg, payload=b""):
+    """Fixed-length frame: header, padded payload, CRC."""
+    body = struct.pack("<BBHI", BOOT_SOF, cmd, len(payload), arg)
+    body += payload + b"\xff" * (BOOT_CHUNK - len(payload))
+    return body + struct.pack("<I", crc32_mpeg2(body))
+
+
+class Link:
+    def __init__(self, port):
+        import serial
+        self.port = serial.Serial(port, BOOT_BAUD, timeout=ACK_S)
+
+    def reply(self):
+        """Next reply as (cmd, status, value), None on timeout; bytes
+        before a start-of-frame are skipped."""
+        while True:
+            b = self.port.read(1)
+            if not b:
+                return None
+            if b[0] == BOOT_SOF:
+                break
+        rest = self.port.read(BOOT_REPLY_LEN - 1)
+        if len(rest) != BOOT_REPLY_LEN - 1:
+            return None
+        cmd, status, _seq, value = struct.unpack("<BBBI", rest)
+        return cmd & ~BOOT_REPLY_FLAG, status, value
+
+    def resync(self):
+        time.sleep(SYNC_S)
+        self.port.reset_input_buffer()
+
+    def run(self, frames):
+        """Sends (frame, cmd, expected value) tuples, WINDOW at a time, in
+        order; a damaged or lost frame is resent with the ones after it."""
+        sent = 0
+        acked = 0
+        tries = 0
+        while acked < len(frames):
+            while sent < len(frames) and sent - acked < WINDOW:
+                self.port.write(frames[sent][0])
+                sent += 1
+            r = self.reply()
+            _, cmd, expect = frames[acked]
+            if r is not None and r[1] == 0:
+                if r[0] == cmd and (expect is None or r[2] == expect):
+                    acked += 1
+                    tries = 0
+                    continue
+                continue  # Late reply to a frame already resent
+            if r is not None and r[1] not in RESEND:
+                sys.exit("bootloader: %s failed: %s (0x%08x)"
+                         % (cmd, STATUS.get(r[1], r[1]), r[2]))
+            tries += 1
+            if tries > RETRIES:
+                sys.exit("bootloader: no answer to frame %d" % acked)
+            self.resync()
+            sent = acked
+        return acked
+
+
+def request(port, baud):
+    """Asks the running application to reset into the bootloader."""
+    import serial
+    with serial.Serial(port, baud, timeout=1.0) as s:
+        s.reset_input_buffer()
+        s.write(b"\r\nupdate\r\n")
+        deadline = time.time() + 2.0
+        while time.time() < deadline:
+            if s.readline().startswith(b"OK update"):
+                return
+    print("no reply to update at %d baud, assuming the bootloader runs"
+          % baud)
+
+
+def flash(args):
+    image = load_image(args.image)
+    crc = crc32_mpeg2(image)
+    if not args.no_request:
+        request(args.port, args.baud)
+    link = Link(args.port)
+
+    link.resync()
+    link.run([(frame(CMD_INFO, 0), CMD_INFO, None)])
+    link.run([(frame(CMD_BEGIN, len(image), struct.pack("<I", crc)),
+               CMD_BEGIN, len(image))])
+
+    writes = []
+    for off in range(0, len(image), BOOT_CHUNK):
+        chunk = image[off:off + BOOT_CHUNK]
+        writes.append((frame(CMD_WRITE, off, chunk), CMD_WRITE,
+                       off + len(chunk)))
+    start = time.time()
+    link.run(writes)
+    elapsed = time.time() - start
+
+    link.run([(frame(CMD_END, 0), CMD_END, crc)])
+    link.run([(frame(CMD_RUN, 0), CMD_RUN, None)])
+    print("%d bytes in %.2f s (%.1f KB/s), crc 0x%08x"
+          % (len(image), elapsed, len(image) / 1024.0 / max(elapsed, 1e-3),
+             crc))
+
+
+def desc(args):
+    with open(args.out, "wb") as f:
+        f.write(descriptor(load_image(args.image)))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    sub = ap.add_subparsers(dest="what", required=True)
+    p = sub.add_parser("flash", help="update over USART2")
+    p.add_argument("port")
+    p.add_argument("image", help="raw binary (objcopy -O binary)")
+    p.add_argument("--baud", type=int, default=115200,
+                   help="rate of the running application's console")
+    p.add_argument("--no-request", action="store_true",
+                   help="bootloader already running (button held)")
+    p.set_defaults(fn=flash)
+    p = sub.add_parser("desc", help="write the image descriptor")
+    p.add_argument("image")
+    p.add_argument("out")
+    p.set_defaults(fn=desc)
+    args = ap.parse_args()
+    args.fn(args)
+
+
+if __name__ == "__main__":
+    main()
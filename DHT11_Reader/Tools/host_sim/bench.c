@@ -0,0 +1,344 @@
+/**
+ ******************************************************************************
+ * @file           : bench.c
+ * @brief          : Host benchmark of the bit-banged DHT11 driver against
+ *                   the waveform simulator (sim.h).
+ *
+ *                   For every jitter level, DHT11_Read() runs on a number of
+ *                   frames (random bytes, or a replayed trace) with retries
+ *                   disabled, and the results are compared with the bytes
+ *                   the trace carries. Reported per level:
+ *                     ok%        frames decoded to the right bytes
+ *                     false_ok   checksum passed on the wrong bytes
+ *                     checksum / response / bit_to / other  failures
+ *                     conf       mean classifier confidence of good frames
+ *                     cyc/frame  simulated CPU cycles from the start
+ *                                pulse release to DHT11_Read() returning
+ *                     acc/frame  GPIOA/DWT register accesses per frame
+ *                     ns/decode  host time of DHT11_Classify() on the
+ *                                level's widths, for comparing decoders
+ *
+ *                   With -c the exit status is 1 when a level within the
+ *                   gate's jitter range falls below the required ok%, so a
+ *                   CI job can fail on a decoder regression.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "sim.h"
+#include "dht11.h"
+#include "dht11_classify.h"
+#include "dht11_health.h"
+#include "dht11_prof.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_MAX_LEVELS      (32U)
+#define BENCH_DECODE_PASSES   (20U)
+
+/**
+ * @brief Command-line settings.
+ */
+typedef struct {
+	sim_config_t sim;
+	uint32_t frames;
+	uint32_t levels_us[BENCH_MAX_LEVELS];
+	uint32_t levels;
+	const char *trace;
+	uint32_t seed;
+	uint8_t profile;
+	uint32_t gate_pct;      /*!< 0: no gate */
+	uint32_t gate_jitter_us;
+} bench_args_t;
+
+/**
+ * @brief Outcome counters of one jitter level.
+ */
+typedef struct {
+	uint32_t ok;
+	uint32_t false_ok;
+	uint32_t checksum;
+	uint32_t response;
+	uint32_t bit_timeout;
+	uint32_t other;
+	uint64_t confidence;
+	uint64_t cycles;
+	uint64_t accesses;
+	double decode_ns;
+} bench_result_t;
+
+static void Bench_Usage(void) {
+	printf("usage: dht11_bench [options]\n"
+			"  -n FRAMES   frames per jitter level (1000)\n"
+			"  -j LIST     jitter levels in us, comma separated (0,2,4,6,8,10,12,15,20)\n"
+			"  -g PPM      glitch probability per data bit (0)\n"
+			"  -w US       glitch width (2)\n"
+			"  -e PPM      noise: probability of a flipped sample per read (0)\n"
+			"  -m MHZ      core clock (180)\n"
+			"  -a CYCLES   cycles per GPIOA/DWT access (4)\n"
+			"  -t FILE     replay a recorded trace instead of random frames\n"
+			"  -s SEED     random seed (1)\n"
+			"  -p          dump the driver profile after each level\n"
+			"  -c PCT      exit 1 if a gated level decodes below PCT %%\n"
+			"  -G US       highest jitter level the gate applies to (6)\n");
+}
+
+static uint32_t Bench_ParseList(const char *s, uint32_t *out, uint32_t max) {
+	uint32_t n = 0U;
+	char *end;
+
+	while ((*s != '\0') && (n < max)) {
+		out[n++] = (uint32_t) strtoul(s, &end, 10);
+		if (*end != ',') {
+			break;
+		}
+		s = end + 1;
+	}
+	return n;
+}
+
+static int Bench_ParseArgs(int argc, char *argv[], bench_args_t *args) {
+	int i;
+
+	Sim_DefaultConfig(&args->sim);
+	args->frames = 1000U;
+	args->levels = Bench_ParseList("0,2,4,6,8,10,12,15,20", args->levels_us,
+			BENCH_MAX_LEVELS);
+	args->trace = NULL;
+	args->seed = 1U;
+	args->profile = 0U;
+	args->gate_pct = 0U;
+	args->gate_jitter_us = 6U;
+
+	for (i = 1; i < argc; i++) {
+		const char *opt = argv[i];
+		const char *val = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+		if (strcmp(opt, "-p") == 0) {
+			args->profile = 1U;
+			continue;
+		}
+		if ((opt[0] != '-') || (opt[1] == '\0') || (opt[2] != '\0')
+				|| (val == NULL)) {
+			return -1;
+		}
+		i++;
+		switch (opt[1]) {
+		case 'n':
+			args->frames = (uint32_t) strtoul(val, NULL, 10);
+			break;
+		case 'j':
+			args->levels = Bench_ParseList(val, args->levels_us,
+					BENCH_MAX_LEVELS);
+			break;
+		case 'g':
+			args->sim.glitch_ppm = (uint32_t) strtoul(val, NULL, 10);
+			break;
+		case 'w':
+			args->sim.glitch_ns = (uint32_t) strtoul(val, NULL, 10) * 1000U;
+			break;
+		case 'e':
+			args->sim.noise_ppm = (uint32_t) strtoul(val, NULL, 10);
+			break;
+		case 'm':
+			args->sim.cpu_mhz = (uint32_t) strtoul(val, NULL, 10);
+			break;
+		case 'a':
+			args->sim.access_cycles = (uint32_t) strtoul(val, NULL, 10);
+			break;
+		case 't':
+			args->trace = val;
+			break;
+		case 's':
+			args->seed = (uint32_t) strtoul(val, NULL, 10);
+			break;
+		case 'c':
+			args->gate_pct = (uint32_t) strtoul(val, NULL, 10);
+			break;
+		case 'G':
+			args->gate_jitter_us = (uint32_t) strtoul(val, NULL, 10);
+			break;
+		default:
+			return -1;
+		}
+	}
+	if ((args->frames == 0U) || (args->levels == 0U)
+			|| (args->sim.cpu_mhz == 0U)) {
+		return -1;
+	}
+	return 0;
+}
+
+static double Bench_Now(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((double) ts.tv_sec * 1e9) + (double) ts.tv_nsec;
+}
+
+/**
+ * @brief Random humidity/temperature bytes with a valid checksum.
+ */
+static void Bench_RandomFrame(uint8_t data[5]) {
+	data[0] = (uint8_t) (20U + Sim_Random(70U));
+	data[1] = 0U;
+	data[2] = (uint8_t) Sim_Random(50U);
+	data[3] = (uint8_t) Sim_Random(10U);
+	data[4] = (uint8_t) (data[0] + data[1] + data[2] + data[3]);
+}
+
+/**
+ * @brief Times DHT11_Classify() over the widths the level produced.
+ */
+static double Bench_DecodeNs(const uint16_t *widths, uint32_t frames) {
+	dht11_classifier_t cls;
+	uint8_t data[5];
+	uint32_t sink = 0U;
+	uint32_t pass;
+	uint32_t f;
+	double t0;
+
+	t0 = Bench_Now();
+	for (pass = 0U; pass < BENCH_DECODE_PASSES; pass++) {
+		cls = *DHT11_Classify_Get(0U);
+		for (f = 0U; f < frames; f++) {
+			DHT11_Classify(&cls, &widths[f * 40U], data);
+			sink += data[4];
+		}
+	}
+	if (sink == 0xFFFFFFFFU) {
+		printf(" ");  /* Keeps the loop from being optimised away */
+	}
+	return (Bench_Now() - t0) / ((double) frames * BENCH_DECODE_PASSES);
+}
+
+static void Bench_RunLevel(const bench_args_t *args, uint32_t level,
+		uint16_t *widths, bench_result_t *res) {
+	static const dht11_policy_t no_retry = { 0U, 0U, 0xFFU, 1U, 0U, 0U, 0U };
+	sim_config_t cfg = args->sim;
+	dht11_reading_t reading;
+	uint8_t expected[5];
+	uint64_t accesses;
+	uint32_t f;
+
+	memset(res, 0, sizeof(*res));
+	cfg.jitter_ns = args->levels_us[level] * 1000U;
+	Sim_Init(&cfg, args->seed + level);
+	if (args->trace != NULL) {
+		(void) Sim_LoadTrace(args->trace);
+	}
+	DHT11_Classify_Init();
+	DHT11_Health_Init();
+	DHT11_Health_SetPolicy(0U, &no_retry);
+	DHT11_Prof_Reset();
+
+	for (f = 0U; f < args->frames; f++) {
+		if (args->trace == NULL) {
+			Bench_RandomFrame(expected);
+			Sim_SetFrame(expected);
+		}
+		Sim_GetFrame(expected);
+
+		accesses = Sim_Accesses();
+		(void) DHT11_Read(&reading);
+		res->cycles += Sim_Cycles() - Sim_TraceStart();
+		res->accesses += Sim_Accesses() - accesses;
+		Sim_GetWidths(&widths[f * 40U]);
+
+		switch (reading.status) {
+		case DHT11_OK:
+			if (memcmp(reading.raw, expected, 5U) == 0) {
+				res->ok++;
+				res->confidence += reading.confidence;
+			} else {
+				res->false_ok++;
+			}
+			break;
+		case DHT11_ERR_CHECKSUM:
+			res->checksum++;
+			break;
+		case DHT11_ERR_NO_RESPONSE:
+		case DHT11_ERR_STUCK_LOW:
+		case DHT11_ERR_STUCK_HIGH:
+			res->response++;
+			break;
+		case DHT11_ERR_BIT_TIMEOUT:
+			res->bit_timeout++;
+			break;
+		default:
+			res->other++;
+			break;
+		}
+		Sim_AdvanceUs(2000000U); /* Sensor's minimum read interval */
+	}
+
+	if (args->profile != 0U) {
+		DHT11_Prof_Dump();
+	}
+	res->decode_ns = Bench_DecodeNs(widths, args->frames);
+}
+
+int main(int argc, char *argv[]) {
+	bench_args_t args;
+	bench_result_t res;
+	uint16_t *widths;
+	uint32_t level;
+	double ok_pct;
+	int rc = 0;
+
+	if (Bench_ParseArgs(argc, argv, &args) != 0) {
+		Bench_Usage();
+		return 2;
+	}
+	if ((args.trace != NULL) && (Sim_LoadTrace(args.trace) != 0)) {
+		fprintf(stderr, "cannot read trace %s\n", args.trace);
+		return 2;
+	}
+	widths = malloc((size_t) args.frames * 40U * sizeof(uint16_t));
+	if (widths == NULL) {
+		return 2;
+	}
+
+	printf("DHT11 bit-bang decoder, %lu MHz, %lu cycles/access, "
+			"glitch %lu ppm x %lu us, noise %lu ppm, %s\n",
+			(unsigned long) args.sim.cpu_mhz,
+			(unsigned long) args.sim.access_cycles,
+			(unsigned long) args.sim.glitch_ppm,
+			(unsigned long) (args.sim.glitch_ns / 1000U),
+			(unsigned long) args.sim.noise_ppm,
+			(args.trace != NULL) ? args.trace : "random frames");
+	printf("jitter_us frames   ok%%  false_ok checksum response bit_to other"
+			"  conf cyc/frame acc/frame ns/decode\n");
+
+	for (level = 0U; level < args.levels; level++) {
+		Bench_RunLevel(&args, level, widths, &res);
+		ok_pct = (100.0 * res.ok) / args.frames;
+		printf("%9lu %6lu %6.2f %8lu %8lu %8lu %6lu %5lu %5lu %9llu %9llu %9.1f\n",
+				(unsigned long) args.levels_us[level],
+				(unsigned long) args.frames, ok_pct,
+				(unsigned long) res.false_ok, (unsigned long) res.checksum,
+				(unsigned long) res.response, (unsigned long) res.bit_timeout,
+				(unsigned long) res.other,
+				(unsigned long) ((res.ok != 0U) ? (res.confidence / res.ok) : 0U),
+				(unsigned long long) (res.cycles / args.frames),
+				(unsigned long long) (res.accesses / args.frames),
+				res.decode_ns);
+
+		if ((args.gate_pct != 0U) && (args.levels_us[level] <= args.gate_jitter_us)
+				&& ((ok_pct < (double) args.gate_pct) || (res.false_ok != 0U))) {
+			fflush(stdout);
+			fprintf(stderr, "FAIL: %lu us jitter: %.2f %% ok, %lu false ok\n",
+					(unsigned long) args.levels_us[level], ok_pct,
+					(unsigned long) res.false_ok);
+			rc = 1;
+		}
+	}
+
+	free(widths);
+	return rc;
+}
@@ -0,0 +1,118 @@
+/**
+ ******************************************************************************
+ * @file           : stm32f4xx_hal.h
+ * @brief          : Host stand-in for the STM32F4 HAL, pulled in by
+ *                   Core/Inc/main.h when Tools/host_sim/shim is first on the
+ *                   include path.
+ *
+ *                   Only what the bit-banged DHT11 path touches is provided.
+ *                   GPIOA and DWT are not fixed addresses but calls into the
+ *                   waveform simulator (sim.h): every register access lets
+ *                   simulated time advance and samples the line, so the
+ *                   driver's polling loops run unchanged against a trace.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef STM32F4XX_HAL_H_SHIM_
+#define STM32F4XX_HAL_H_SHIM_
+
+#include <stdint.h>
+
+#define __IO volatile
+
+typedef struct {
+	__IO uint32_t MODER;
+	__IO uint32_t OTYPER;
+	__IO uint32_t OSPEEDR;
+	__IO uint32_t PUPDR;
+	__IO uint32_t IDR;
+	__IO uint32_t ODR;
+	__IO uint32_t BSRR;
+	__IO uint32_t LCKR;
+	__IO uint32_t AFR[2];
+} GPIO_TypeDef;
+
+typedef struct {
+	__IO uint32_t CTRL;
+	__IO uint32_t CYCCNT;
+} DWT_Type;
+
+typedef enum {
+	GPIO_PIN_RESET = 0,
+	GPIO_PIN_SET
+} GPIO_PinState;
+
+#define GPIO_PIN_1   ((uint16_t) 0x0002U)
+#define GPIO_PIN_2   ((uint16_t) 0x0004U)
+#define GPIO_PIN_3   ((uint16_t) 0x0008U)
+#define GPIO_PIN_5   ((uint16_t) 0x0020U)
+#define GPIO_PIN_13  ((uint16_t) 0x2000U)
+#define GPIO_PIN_14  ((uint16_t) 0x4000U)
+
+#define GPIO_MODER_MODER0    (0x3U)
+#define GPIO_MODER_MODER0_0  (0x1U)
+#define GPIO_MODER_MODER0_1  (0x2U)
+
+GPIO_TypeDef* Sim_GpioA(void);
+GPIO_TypeDef* Sim_GpioIdle(void);
+DWT_Type* Sim_Dwt(void);
+
+#define GPIOA  (Sim_GpioA())
+#define GPIOB  (Sim_GpioIdle())
+#define GPIOC  (Sim_GpioIdle())
+#define DWT    (Sim_Dwt())
+
+void HAL_Delay(uint32_t Delay);
+uint32_t HAL_GetTick(void);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin,
+		GPIO_PinState PinState);
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+
+/* No interrupts on the host: PRIMASK is a plain variable */
+extern uint32_t sim_primask;
+
+static inline uint32_t __get_PRIMASK(void) {
+	return sim_primask;
+}
+
+static inline void __set_PRIMASK(uint32_t primask) {
+	sim_primask = primask;
+}
+
+static inline void __disable_irq(void) {
+	sim_primask = 1U;
+}
+
+static inline void __enable_irq(void) {
+	sim_primask = 0U;
+}
+
+/* BASEPRI masking (irq_prio.h), equally inert */
+#define __NVIC_PRIO_BITS   (4U)
+#define TICK_INT_PRIORITY  (15U)
+
+extern uint32_t sim_basepri;
+
+static inline uint32_t __get_BASEPRI(void) {
+	return sim_basepri;
+}
+
+static inline void __set_BASEPRI(uint32_t basepri) {
+	sim_basepri = basepri;
+}
+
+static inline void __set_BASEPRI_MAX(uint32_t basepri) {
+	if ((basepri != 0U) && ((sim_basepri == 0U) || (basepri < sim_basepri))) {
+		sim_basepri = basepri;
+	}
+}
+
+static inline void __ISB(void) {
+}
+
+#endif /* STM32F4XX_HAL_H_SHIM_ */
@@ -0,0 +1,424 @@
+/**
+ ******************************************************************************
+ * @file           : sim.c
+ * @brief          : DHT11 waveform simulator and the HAL/DWT/GPIO shim it
+ *                   backs.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "sim.h"
+#include "main.h"
+#include "dht11_pin.h"
+#include "dht11_sink.h"
+#include "timebase.h"
+#include "power.h"
+#include <stdio.h>
+#include <string.h>
+
+/** First template segment that can be a data bit: wait, LOW, HIGH, preamble */
+#define SIM_FIRST_BIT_SEGMENT (4U)
+
+/** Nominal HIGH time above which a template bit decodes as '1' */
+#define SIM_BIT_SPLIT_NS      ((SIM_T_ZERO_NS + SIM_T_ONE_NS) / 2U)
+
+/** Shortest realised segment, so jitter never removes an edge */
+#define SIM_MIN_SEGMENT_NS    (100U)
+
+/**
+ * @brief Realised segment: level until an absolute cycle count.
+ */
+typedef struct {
+	uint8_t level;
+	uint64_t end;
+} sim_edge_t;
+
+uint32_t sim_primask = 0U;
+uint32_t sim_basepri = 0U;
+
+static sim_config_t sim_cfg;
+static uint32_t sim_rng = 1U;
+static uint64_t sim_now = 0U;
+static uint64_t sim_accesses = 0U;
+
+static GPIO_TypeDef sim_gpioa;
+static GPIO_TypeDef sim_gpio_idle;
+static DWT_Type sim_dwt;
+
+/* MCU side of the line */
+static uint8_t sim_host_low = 0U;
+static uint64_t sim_low_start = 0U;
+
+/* Nominal trace and its current realisation */
+static sim_segment_t sim_template[SIM_MAX_SEGMENTS];
+static uint32_t sim_template_len = 0U;
+static sim_edge_t sim_real[SIM_MAX_SEGMENTS + (2U * 40U)];
+static uint32_t sim_real_len = 0U;
+static uint32_t sim_real_pos = 0U;
+static uint64_t sim_trace_start = 0U;
+static uint16_t sim_widths[40];
+
+/**
+ * @brief xorshift32: reproducible across hosts for a given seed.
+ */
+static uint32_t Sim_Next(void) {
+	sim_rng ^= sim_rng << 13;
+	sim_rng ^= sim_rng >> 17;
+	sim_rng ^= sim_rng << 5;
+	return sim_rng;
+}
+
+/**
+ * @brief Nanoseconds to cycles at the configured clock.
+ */
+static uint64_t Sim_NsToCycles(uint64_t ns) {
+	return (ns * sim_cfg.cpu_mhz) / 1000U;
+}
+
+/**
+ * @brief True with a probability of ppm / 1e6.
+ */
+static uint8_t Sim_Chance(uint32_t ppm) {
+	return ((ppm != 0U) && (Sim_Random(1000000U) < ppm)) ? 1U : 0U;
+}
+
+/**
+ * @brief Appends one realised segment.
+ */
+static void Sim_Emit(uint8_t level, uint64_t *t, uint32_t ns) {
+	if (sim_real_len >= (sizeof(sim_real) / sizeof(sim_real[0]))) {
+		return;
+	}
+	*t += Sim_NsToCycles(ns);
+	sim_real[sim_real_len].level = level;
+	sim_real[sim_real_len].end = *t;
+	sim_real_len++;
+}
+
+/**
+ * @brief Plays the template from now with fresh jitter and glitches.
+ */
+static void Sim_Realise(void) {
+	uint64_t t = sim_now;
+	uint32_t bit = 0U;
+	uint32_t i;
+	int64_t ns;
+	uint32_t at;
+
+	sim_real_len = 0U;
+	sim_real_pos = 0U;
+	sim_trace_start = sim_now;
+	memset(sim_widths, 0, sizeof(sim_widths));
+	for (i = 0U; i < sim_template_len; i++) {
+		ns = sim_template[i].ns;
+		if (sim_cfg.jitter_ns != 0U) {
+			ns += (int64_t) Sim_Random((2U * sim_cfg.jitter_ns) + 1U)
+					- (int64_t) sim_cfg.jitter_ns;
+		}
+		if (ns < (int64_t) SIM_MIN_SEGMENT_NS) {
+			ns = SIM_MIN_SEGMENT_NS;
+		}
+
+		if ((i >= SIM_FIRST_BIT_SEGMENT) && (sim_template[i].level != 0U)
+				&& (bit < 40U)) {
+			sim_widths[bit++] = (uint16_t) (ns / 1000);
+			if (Sim_Chance(sim_cfg.glitch_ppm) && (ns > sim_cfg.glitch_ns)) {
+				at = Sim_Random((uint32_t) ns - sim_cfg.glitch_ns);
+				Sim_Emit(1U, &t, at);
+				Sim_Emit(0U, &t, sim_cfg.glitch_ns);
+				Sim_Emit(1U, &t, (uint32_t) ns - at - sim_cfg.glitch_ns);
+				continue;
+			}
+		}
+		Sim_Emit(sim_template[i].level, &t, (uint32_t) ns);
+	}
+}
+
+/**
+ * @brief Sensor side of the line at the current time.
+ */
+static uint8_t Sim_SensorLevel(void) {
+	while ((sim_real_pos < sim_real_len)
+			&& (sim_now >= sim_real[sim_real_pos].end)) {
+		sim_real_pos++;
+	}
+	if (sim_real_pos >= sim_real_len) {
+		return 1U; /* Released to the pull-up */
+	}
+	return sim_real[sim_real_pos].level;
+}
+
+/**
+ * @brief Applies pending BSRR writes and reacts to start-pulse edges.
+ */
+static void Sim_Sync(void) {
+	uint32_t bsrr = sim_gpioa.BSRR;
+	uint32_t output;
+	uint8_t low;
+
+	if (bsrr != 0U) {
+		sim_gpioa.ODR = (sim_gpioa.ODR & ~(bsrr >> 16U)) | (bsrr & 0xFFFFU);
+		sim_gpioa.BSRR = 0U;
+	}
+	output = ((sim_gpioa.MODER & DHT11_PIN_MODER_MASK(DHT11_PIN_NUM))
+			== DHT11_PIN_MODER_OUTPUT(DHT11_PIN_NUM)) ? 1U : 0U;
+	low = ((output != 0U) && ((sim_gpioa.ODR & DHT_PIN_Pin) == 0U)) ? 1U : 0U;
+
+	if ((low != 0U) && (sim_host_low == 0U)) {
+		sim_low_start = sim_now;
+		sim_real_len = 0U; /* A start pulse aborts any frame in flight */
+	} else if ((low == 0U) && (sim_host_low != 0U)) {
+		if ((sim_cfg.present != 0U)
+				&& ((sim_now - sim_low_start)
+						>= Sim_NsToCycles((uint64_t) SIM_START_MIN_US * 1000U))) {
+			Sim_Realise();
+		}
+	}
+	sim_host_low = low;
+}
+
+/**
+ * @brief One register access: time moves, then the line is sampled.
+ */
+static void Sim_Access(void) {
+	uint8_t level;
+
+	Sim_Sync();
+	sim_now += sim_cfg.access_cycles;
+	sim_accesses++;
+
+	level = (sim_host_low != 0U) ? 0U : Sim_SensorLevel();
+	if (Sim_Chance(sim_cfg.noise_ppm)) {
+		level ^= 1U;
+	}
+	sim_gpioa.IDR =
+			(sim_gpioa.IDR & ~(uint32_t) DHT_PIN_Pin) | ((level != 0U) ? DHT_PIN_Pin : 0U);
+	sim_dwt.CYCCNT = (uint32_t) sim_now;
+}
+
+/**
+ * @brief Fills a configuration with nominal settings.
+ */
+void Sim_DefaultConfig(sim_config_t *cfg) {
+	cfg->cpu_mhz = 180U;
+	cfg->access_cycles = 4U;
+	cfg->jitter_ns = 0U;
+	cfg->glitch_ppm = 0U;
+	cfg->glitch_ns = 2000U;
+	cfg->noise_ppm = 0U;
+	cfg->present = 1U;
+}
+
+/**
+ * @brief Resets time and the line, applies a configuration and seeds.
+ */
+void Sim_Init(const sim_config_t *cfg, uint32_t seed) {
+	sim_cfg = *cfg;
+	sim_rng = (seed != 0U) ? seed : 1U;
+	sim_now = 0U;
+	sim_accesses = 0U;
+	memset(&sim_gpioa, 0, sizeof(sim_gpioa));
+	memset(&sim_dwt, 0, sizeof(sim_dwt));
+	/* As left by DHT11_Pin_Init(): open-drain output, released */
+	sim_gpioa.MODER = DHT11_PIN_MODER_OUTPUT(DHT11_PIN_NUM);
+	sim_gpioa.ODR = DHT_PIN_Pin;
+	sim_host_low = 0U;
+	sim_real_len = 0U;
+	sim_real_pos = 0U;
+}
+
+/**
+ * @brief Replaces the configuration, keeping time and the trace.
+ */
+void Sim_Configure(const sim_config_t *cfg) {
+	sim_cfg = *cfg;
+}
+
+/**
+ * @brief Builds a synthetic trace carrying these 5 bytes.
+ */
+void Sim_SetFrame(const uint8_t data[5]) {
+	uint32_t n = 0U;
+	uint32_t i;
+
+	sim_template[n++] = (sim_segment_t) { 1U, SIM_T_WAIT_NS };
+	sim_template[n++] = (sim_segment_t) { 0U, SIM_T_RESP_NS };
+	sim_template[n++] = (sim_segment_t) { 1U, SIM_T_RESP_NS };
+	for (i = 0U; i < 40U; i++) {
+		sim_template[n++] = (sim_segment_t) { 0U, SIM_T_BIT_LOW_NS };
+		sim_template[n++] = (sim_segment_t) { 1U,
+				((data[i >> 3] & (0x80U >> (i & 7U))) != 0U) ?
+						SIM_T_ONE_NS : SIM_T_ZERO_NS };
+	}
+	sim_template[n++] = (sim_segment_t) { 0U, SIM_T_BIT_LOW_NS };
+	sim_template_len = n;
+}
+
+/**
+ * @brief Loads a recorded trace.
+ */
+int Sim_LoadTrace(const char *path) {
+	FILE *f = fopen(path, "r");
+	char line[128];
+	unsigned level;
+	double us;
+	uint32_t n = 0U;
+
+	if (f == NULL) {
+		return -1;
+	}
+	while ((fgets(line, sizeof(line), f) != NULL) && (n < SIM_MAX_SEGMENTS)) {
+		if ((line[0] == '#') || (sscanf(line, "%u %lf", &level, &us) != 2)) {
+			continue;
+		}
+		sim_template[n].level = (level != 0U) ? 1U : 0U;
+		sim_template[n].ns = (uint32_t) ((us * 1000.0) + 0.5);
+		n++;
+	}
+	fclose(f);
+	if (n == 0U) {
+		return -1;
+	}
+	sim_template_len = n;
+	return 0;
+}
+
+/**
+ * @brief Bytes the current trace carries.
+ */
+void Sim_GetFrame(uint8_t data[5]) {
+	uint32_t bit = 0U;
+	uint32_t i;
+
+	memset(data, 0, 5U);
+	for (i = SIM_FIRST_BIT_SEGMENT; (i < sim_template_len) && (bit < 40U); i++) {
+		if (sim_template[i].level == 0U) {
+			continue;
+		}
+		if (sim_template[i].ns > SIM_BIT_SPLIT_NS) {
+			data[bit >> 3] |= (uint8_t) (0x80U >> (bit & 7U));
+		}
+		bit++;
+	}
+}
+
+/**
+ * @brief HIGH times of the 40 data bits of the last realisation.
+ */
+void Sim_GetWidths(uint16_t widths[40]) {
+	memcpy(widths, sim_widths, sizeof(sim_widths));
+}
+
+/**
+ * @brief Cycle count at which the sensor last started a trace.
+ */
+uint64_t Sim_TraceStart(void) {
+	return sim_trace_start;
+}
+
+/**
+ * @brief Current simulated time in cycles.
+ */
+uint64_t Sim_Cycles(void) {
+	return sim_now;
+}
+
+/**
+ * @brief Register accesses made by the driver so far.
+ */
+uint64_t Sim_Accesses(void) {
+	return sim_accesses;
+}
+
+/**
+ * @brief Moves simulated time forward.
+ */
+void Sim_AdvanceUs(uint32_t us) {
+	Sim_Sync();
+	sim_now += (uint64_t) us * sim_cfg.cpu_mhz;
+	sim_dwt.CYCCNT = (uint32_t) sim_now;
+}
+
+/**
+ * @brief Uniform random number in [0, n).
+ */
+uint32_t Sim_Random(uint32_t n) {
+	return (n != 0U) ? (Sim_Next() % n) : 0U;
+}
+
+/* HAL shim ------------------------------------------------------------------*/
+
+GPIO_TypeDef* Sim_GpioA(void) {
+	Sim_Access();
+	return &sim_gpioa;
+}
+
+GPIO_TypeDef* Sim_GpioIdle(void) {
+	sim_now += sim_cfg.access_cycles;
+	return &sim_gpio_idle;
+}
+
+DWT_Type* Sim_Dwt(void) {
+	Sim_Access();
+	return &sim_dwt;
+}
+
+void HAL_Delay(uint32_t Delay) {
+	Sim_AdvanceUs(Delay * 1000U);
+}
+
+uint32_t HAL_GetTick(void) {
+	return (uint32_t) (sim_now / ((uint64_t) sim_cfg.cpu_mhz * 1000U));
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin) {
+	return ((GPIOx->IDR & GPIO_Pin) != 0U) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin,
+		GPIO_PinState PinState) {
+	GPIOx->BSRR = (PinState != GPIO_PIN_RESET) ?
+			(uint32_t) GPIO_Pin : ((uint32_t) GPIO_Pin << 16U);
+	Sim_Sync();
+}
+
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin) {
+	GPIOx->ODR ^= GPIO_Pin;
+}
+
+/* Firmware modules not built on the host ------------------------------------*/
+
+void Timebase_EnableCycleCounter(void) {
+}
+
+uint32_t Timebase_CyclesPerUs(void) {
+	return sim_cfg.cpu_mhz;
+}
+
+void Timebase_DelayUs(uint32_t us) {
+	Sim_AdvanceUs(us);
+}
+
+uint32_t Timebase_CyclesPerNsQ16(void) {
+	return (sim_cfg.cpu_mhz << 16) / 1000U;
+}
+
+uint32_t Timebase_DelayOverhead(void) {
+	return 0U;
+}
+
+void Power_DelayMs(uint32_t ms) {
+	HAL_Delay(ms);
+}
+
+void DHT11_Sink_Emit(const dht11_reading_t *reading) {
+	(void) reading;
+}
+
+void Error_Handler(void) {
+	for (;;) {
+	}
+}
@@ -0,0 +1,137 @@
+/**
+ ******************************************************************************
+ * @file           : sim.h
+ * @brief          : DHT11 waveform simulator behind the host HAL shim.
+ *
+ *                   Simulated time runs in CPU cycles and only moves when the
+ *                   driver touches GPIOA or DWT (access_cycles per access)
+ *                   or delays. The data line is the wired-AND of the MCU
+ *                   output and the sensor:
+ *                     - the MCU holds it LOW through ODR/BSRR while MODER
+ *                       selects the output driver;
+ *                     - a release after at least SIM_START_MIN_US of LOW
+ *                       makes the sensor play one response trace.
+ *
+ *                   A trace is a list of (level, duration) segments starting
+ *                   at the release: synthetic from 5 data bytes, or replayed
+ *                   from a recorded file. Each transaction realises it anew
+ *                   with the configured impairments:
+ *                     - jitter: every segment lengthened or shortened by a
+ *                       uniform random amount of up to jitter_ns;
+ *                     - glitch: a data-bit HIGH is split by a LOW spike of
+ *                       glitch_ns, with probability glitch_ppm per bit;
+ *                     - noise: a single IDR read returns the wrong level,
+ *                       with probability noise_ppm per read.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef SIM_H_
+#define SIM_H_
+
+#include <stdint.h>
+
+/** Shortest start pulse the simulated sensor answers */
+#define SIM_START_MIN_US   (18000U)
+
+/** Longest trace, in segments */
+#define SIM_MAX_SEGMENTS   (256U)
+
+/** Nominal DHT11 timing used for synthetic traces, in nanoseconds */
+#define SIM_T_WAIT_NS      (30000U)  /*!< Release -> sensor pulls LOW */
+#define SIM_T_RESP_NS      (80000U)  /*!< Each response phase         */
+#define SIM_T_BIT_LOW_NS   (50000U)  /*!< Bit preamble                */
+#define SIM_T_ZERO_NS      (26000U)  /*!< '0' HIGH time               */
+#define SIM_T_ONE_NS       (70000U)  /*!< '1' HIGH time               */
+
+/**
+ * @brief Simulator settings.
+ */
+typedef struct {
+	uint32_t cpu_mhz;        /*!< Core clock; DWT counts at this rate      */
+	uint32_t access_cycles;  /*!< Cycles per GPIOA/DWT register access     */
+	uint32_t jitter_ns;      /*!< Per-segment uniform +/- jitter           */
+	uint32_t glitch_ppm;     /*!< Per-bit probability of a LOW spike       */
+	uint32_t glitch_ns;      /*!< Spike width                              */
+	uint32_t noise_ppm;      /*!< Per-read probability of a flipped sample */
+	uint8_t present;         /*!< 0: no sensor on the line                 */
+} sim_config_t;
+
+/**
+ * @brief One line level held for a duration.
+ */
+typedef struct {
+	uint8_t level;
+	uint32_t ns;
+} sim_segment_t;
+
+/**
+ * @brief Fills a configuration with nominal settings (180 MHz, clean line).
+ */
+void Sim_DefaultConfig(sim_config_t *cfg);
+
+/**
+ * @brief Resets time and the line, applies a configuration and seeds the
+ *        random generator.
+ */
+void Sim_Init(const sim_config_t *cfg, uint32_t seed);
+
+/**
+ * @brief Replaces the configuration, keeping time and the trace.
+ */
+void Sim_Configure(const sim_config_t *cfg);
+
+/**
+ * @brief Builds a synthetic trace carrying these 5 bytes.
+ */
+void Sim_SetFrame(const uint8_t data[5]);
+
+/**
+ * @brief Loads a recorded trace: one "level duration_us" pair per line,
+ *        '#' starts a comment, the first segment begins at the release.
+ * @retval 0 on success, -1 if the file cannot be read or is empty.
+ */
+int Sim_LoadTrace(const char *path);
+
+/**
+ * @brief Bytes the current trace carries, decoded from its nominal
+ *        timing.
+ */
+void Sim_GetFrame(uint8_t data[5]);
+
+/**
+ * @brief HIGH times of the 40 data bits of the last realisation, in
+ *        microseconds (ground truth for decoder benchmarks).
+ */
+void Sim_GetWidths(uint16_t widths[40]);
+
+/**
+ * @brief Cycle count at which the sensor last started a trace (the MCU's
+ *        release of the start pulse).
+ */
+uint64_t Sim_TraceStart(void);
+
+/**
+ * @brief Current simulated time in cycles.
+ */
+uint64_t Sim_Cycles(void);
+
+/**
+ * @brief Register accesses made by the driver so far.
+ */
+uint64_t Sim_Accesses(void);
+
+/**
+ * @brief Moves simulated time forward.
+ */
+void Sim_AdvanceUs(uint32_t us);
+
+/**
+ * @brief Uniform random number in [0, n).
+ */
+uint32_t Sim_Random(uint32_t n);
+
+#endif /* SIM_H_ */
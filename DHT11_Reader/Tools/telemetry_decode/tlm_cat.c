@@ -0,0 +1,306 @@
+/**
+ ******************************************************************************
+ * @file           : tlm_cat.c
+ * @brief          : Prints a captured telemetry stream (stdin or a file) as
+ *                   one text line per reading or packet, then the frame
+ *                   counters on stderr.
+ *
+ *                   Reads in 4 KB chunks and hands them straight to
+ *                   Tlm_StreamFeed(); the only buffer a packet lands in is
+ *                   the stream's TELEMETRY_PKT_MAX bytes. Compact packets
+ *                   (0x0C) are printed through the last schema (0x0B),
+ *                   gateway packets (0x0D) one line per record.
+ *
+ *                   With -t PREFIX each raw frame record (0x0A) is also
+ *                   written to PREFIX<seq>.trace as a host simulator trace
+ *                   (Docs/host_sim.md). Falling-edge-only records get the
+ *                   nominal 50 us LOW (80 us for the response) and the
+ *                   rest of each period HIGH; the file says so.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "tlm_decode.h"
+#include <stdio.h>
+#include <string.h>
+
+/** Nominal LOW times given to falling-edge-only records */
+#define CAT_TRACE_LOW_US      (50U)
+#define CAT_TRACE_RESP_LOW_US (80U)
+#define CAT_TRACE_WAIT_US     (30U)
+
+/**
+ * @brief Writes a trace packet as "level duration_us" segments from the
+ *        release.
+ */
+static void Cat_WriteTrace(const tlm_packet_t *pkt, const char *prefix) {
+	const telemetry_trace_hdr_t *h = pkt->v.trace;
+	char path[512];
+	FILE *out;
+	uint32_t prev = 0U;
+	uint32_t level = 1U;
+	uint32_t low;
+	uint32_t t;
+	uint32_t i;
+
+	(void) snprintf(path, sizeof(path), "%s%u.trace", prefix, h->seq);
+	out = fopen(path, "w");
+	if (out == NULL) {
+		perror(path);
+		return;
+	}
+	fprintf(out, "# sensor %u seq %u ts %lu status %u flags 0x%02x%s\n",
+			h->sensor_id, h->seq, (unsigned long) h->timestamp_ms, h->status,
+			h->flags, ((h->flags & TELEMETRY_TRACE_CUT) != 0U) ? " cut" : "");
+	fprintf(out, "# level duration_us; starts when the MCU releases the start pulse.\n");
+	if ((h->flags & TELEMETRY_TRACE_RELEASE) == 0U) {
+		fprintf(out, "# wait not recorded, nominal\n1 %u\n", CAT_TRACE_WAIT_US);
+		prev = (h->n != 0U) ? Tlm_TraceEdge(pkt, 0U) : 0U;
+		level = 0U;
+	}
+	if ((h->flags & TELEMETRY_TRACE_BOTH) == 0U) {
+		fprintf(out, "# falling edges only, nominal LOW times\n");
+	}
+	for (i = 0U; i < h->n; i++) {
+		t = Tlm_TraceEdge(pkt, i);
+		if (((h->flags & TELEMETRY_TRACE_RELEASE) == 0U) && (i == 0U)) {
+			continue;
+		}
+		if ((h->flags & TELEMETRY_TRACE_BOTH) != 0U) {
+			fprintf(out, "%lu %lu\n", (unsigned long) level,
+					(unsigned long) (t - prev));
+			level ^= 1U;
+		} else if (level != 0U) {
+			/* The wait, HIGH up to the response's falling edge */
+			fprintf(out, "1 %lu\n", (unsigned long) (t - prev));
+			level = 0U;
+		} else {
+			low = (prev == Tlm_TraceEdge(pkt, 0U)) ?
+					CAT_TRACE_RESP_LOW_US : CAT_TRACE_LOW_US;
+			if ((t - prev) <= low) {
+				low = (t - prev) / 2U;
+			}
+			fprintf(out, "0 %lu\n1 %lu\n", (unsigned long) low,
+					(unsigned long) (t - prev - low));
+		}
+		prev = t;
+	}
+	if (level == 0U) {
+		fprintf(out, "0 %u\n", CAT_TRACE_LOW_US);
+	}
+	fclose(out);
+}
+
+/**
+ * @brief Prints a schema packet and loads it.
+ */
+static void Cat_Schema(const tlm_packet_t *pkt, tlm_schema_t *schema) {
+	uint32_t i;
+
+	if (Tlm_SchemaLoad(schema, pkt) == 0) {
+		printf("schema id %u too large\n", pkt->v.schema->schema_id);
+		return;
+	}
+	printf("schema id %u ts %lu fields", schema->schema_id,
+			(unsigned long) schema->time_ms);
+	for (i = 0U; i < schema->nfields; i++) {
+		printf(" %u:0x%02x:%d:%u", schema->fields[i].id, schema->fields[i].enc,
+				schema->fields[i].scale, schema->fields[i].unit);
+	}
+	printf(" sensors");
+	for (i = 0U; i < schema->nsensors; i++) {
+		printf(" %u:0x%02x", schema->sensors[i].sensor_id,
+				schema->sensors[i].kind);
+	}
+	printf("\n");
+}
+
+/**
+ * @brief Prints a compact packet's values as "field=value" in the units
+ *        of its schema.
+ */
+static void Cat_Compact(const tlm_packet_t *pkt, tlm_schema_t *schema) {
+	static const char *const names[] = { "?", "dt", "temp", "hum" };
+	int32_t values[TLM_SCHEMA_FIELDS_MAX];
+	uint32_t ts;
+	uint32_t n;
+	uint32_t i;
+	uint8_t id;
+
+	n = Tlm_CompactDecode(schema, pkt, values, &ts);
+	if (n == 0U) {
+		printf("compact sensor %u seq %u schema %u dropped\n",
+				pkt->v.compact->sensor_id, pkt->v.compact->seq,
+				pkt->v.compact->schema_id);
+		return;
+	}
+	printf("compact sensor %u seq %u ts %lu", pkt->v.compact->sensor_id,
+			pkt->v.compact->seq, (unsigned long) ts);
+	for (i = 0U; i < n; i++) {
+		id = schema->fields[i].id;
+		printf(" %s=%lde%d", names[(id < 4U) ? id : 0U], (long) values[i],
+				schema->fields[i].scale);
+	}
+	printf("\n");
+}
+
+/**
+ * @brief Prints a gateway packet (0x0D), one line per record.
+ */
+static void Cat_Gateway(const tlm_packet_t *pkt) {
+	const telemetry_gateway_rec_t *rec = (const telemetry_gateway_rec_t*) (pkt->data
+			+ TELEMETRY_GATEWAY_HEADER);
+	uint32_t i;
+
+	for (i = 0U; i < pkt->v.gateway->n; i++, rec++) {
+		if (rec->sensor_id == TELEMETRY_GATEWAY_LINK) {
+			printf("gateway seq %u ts %lu node %u link %u\n",
+					pkt->v.gateway->seq,
+					(unsigned long) pkt->v.gateway->timestamp_ms, rec->node,
+					rec->status);
+			continue;
+		}
+		printf("gateway seq %u ts %lu node %u sensor %u status %u health %u"
+				" count %u temp %d hum %d\n", pkt->v.gateway->seq,
+				(unsigned long) pkt->v.gateway->timestamp_ms, rec->node,
+				rec->sensor_id, rec->status, rec->health, rec->count, rec->temp,
+				rec->hum);
+	}
+}
+
+/**
+ * @brief Prints one checked packet.
+ */
+static void Cat_Packet(const tlm_packet_t *pkt, const char *trace_prefix,
+		tlm_schema_t *schema) {
+	tlm_iter_t it;
+	tlm_sample_t sample;
+	uint32_t i;
+
+	Tlm_SamplesBegin(&it, pkt);
+	while (Tlm_SamplesNext(&it, &sample) != 0) {
+		printf("reading type 0x%02x sensor %u seq %lu ts %lu status %u raw",
+				pkt->type, sample.sensor_id, (unsigned long) sample.seq,
+				(unsigned long) sample.timestamp_ms, sample.status);
+		for (i = 0U; i < sample.raw_len; i++) {
+			printf(" %u", sample.raw[i]);
+		}
+		printf("\n");
+	}
+
+	switch (pkt->type) {
+	case TELEMETRY_TYPE_DELTA_KEY:
+		printf("key sensor %u ts %lu run %u hum %u temp %d\n",
+				pkt->v.delta_key->sensor_id,
+				(unsigned long) pkt->v.delta_key->timestamp_ms,
+				pkt->v.delta_key->run, pkt->v.delta_key->hum,
+				pkt->v.delta_key->temp);
+		break;
+	case TELEMETRY_TYPE_DELTA:
+		printf("step sensor %u run %u dt %u dh %d dtemp %d\n",
+				pkt->v.delta->sensor_id, pkt->v.delta->run, pkt->v.delta->dt,
+				pkt->v.delta->dh, pkt->v.delta->dtemp);
+		break;
+	case TELEMETRY_TYPE_TIME:
+		printf("time tick %lu unix %lu.%03u\n",
+				(unsigned long) pkt->v.time->tick,
+				(unsigned long) pkt->v.time->unix_s, pkt->v.time->ms);
+		break;
+	case TELEMETRY_TYPE_SUMMARY:
+		printf("summary sensor %u window %u start %lu count %u temp %d/%d/%d"
+				" hum %d/%d/%d\n", pkt->v.summary->sensor_id,
+				pkt->v.summary->window,
+				(unsigned long) pkt->v.summary->start_ms,
+				pkt->v.summary->count, pkt->v.summary->temp_min,
+				pkt->v.summary->temp_mean, pkt->v.summary->temp_max,
+				pkt->v.summary->hum_min, pkt->v.summary->hum_mean,
+				pkt->v.summary->hum_max);
+		break;
+	case TELEMETRY_TYPE_FLASHLOG:
+		printf("flashlog sector %u offset %u words %u\n",
+				pkt->v.flashlog->sector, pkt->v.flashlog->offset,
+				pkt->v.flashlog->n);
+		break;
+	case TELEMETRY_TYPE_PERF:
+		printf("perf busy %u isr %u exc %u\n", pkt->v.perf->busy,
+				pkt->v.perf->isr, pkt->v.perf->exc);
+		break;
+	case TELEMETRY_TYPE_TRACE:
+		printf("trace sensor %u seq %u ts %lu status %u flags 0x%02x edges",
+				pkt->v.trace->sensor_id, pkt->v.trace->seq,
+				(unsigned long) pkt->v.trace->timestamp_ms,
+				pkt->v.trace->status, pkt->v.trace->flags);
+		for (i = 0U; i < pkt->v.trace->n; i++) {
+			printf(" %u", Tlm_TraceEdge(pkt, i));
+		}
+		printf("\n");
+		if (trace_prefix != NULL) {
+			Cat_WriteTrace(pkt, trace_prefix);
+		}
+		break;
+	case TELEMETRY_TYPE_SCHEMA:
+		Cat_Schema(pkt, schema);
+		break;
+	case TELEMETRY_TYPE_COMPACT:
+		Cat_Compact(pkt, schema);
+		break;
+	case TELEMETRY_TYPE_GATEWAY:
+		Cat_Gateway(pkt);
+		break;
+	default:
+		break;
+	}
+}
+
+int main(int argc, char *argv[]) {
+	static uint8_t chunk[4096];
+	uint8_t buf[TELEMETRY_PKT_MAX];
+	tlm_stream_t stream;
+	tlm_packet_t pkt;
+	tlm_status_t status;
+	tlm_schema_t schema;
+	FILE *in = stdin;
+	const char *trace_prefix = NULL;
+	uint32_t consumed;
+	uint32_t off;
+	size_t n;
+	int arg = 1;
+	int i;
+
+	if ((argc > 2) && (strcmp(argv[1], "-t") == 0)) {
+		trace_prefix = argv[2];
+		arg = 3;
+	}
+	if (argc > arg) {
+		in = fopen(argv[arg], "rb");
+		if (in == NULL) {
+			perror(argv[arg]);
+			return 1;
+		}
+	}
+	Tlm_StreamInit(&stream, buf, sizeof(buf));
+	memset(&schema, 0, sizeof(schema));
+	while ((n = fread(chunk, 1U, sizeof(chunk), in)) != 0U) {
+		off = 0U;
+		while (off < n) {
+			status = Tlm_StreamFeed(&stream, &chunk[off], (uint32_t) n - off,
+					&consumed, &pkt);
+			off += consumed;
+			if (status == TLM_OK) {
+				Cat_Packet(&pkt, trace_prefix, &schema);
+			}
+		}
+	}
+
+	fprintf(stderr, "packets %lu empty %lu", (unsigned long) stream.stats.packets,
+			(unsigned long) stream.stats.empty);
+	for (i = TLM_ERR_COBS; i <= TLM_ERR_TYPE; i++) {
+		fprintf(stderr, " %s %lu", Tlm_StatusName((tlm_status_t) i),
+				(unsigned long) stream.stats.errors[i]);
+	}
+	fprintf(stderr, "\n");
+	return 0;
+}
@@ -0,0 +1,487 @@
+/**
+ ******************************************************************************
+ * @file           : tlm_decode.c
+ * @brief          : Host decoder of the binary telemetry stream: COBS
+ *                   frames split from a byte stream, checked and viewed in
+ *                   place through the firmware's packet structs.
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#include "tlm_decode.h"
+#include <string.h>
+
+/* Nibble table for CRC-16/CCITT-FALSE, as on the device */
+static const uint16_t tlm_crc_nibble[16] = { 0x0000U, 0x1021U, 0x2042U,
+		0x3063U, 0x4084U, 0x50A5U, 0x60C6U, 0x70E7U, 0x8108U, 0x9129U, 0xA14AU,
+		0xB16BU, 0xC18CU, 0xD1ADU, 0xE1CEU, 0xF1EFU };
+
+/**
+ * @brief Little-endian 16-bit field.
+ */
+static uint16_t Tlm_Get16(const uint8_t *p) {
+	return (uint16_t) (p[0] | ((uint16_t) p[1] << 8));
+}
+
+/**
+ * @brief Forgets the frame in progress.
+ */
+static void Tlm_StreamReset(tlm_stream_t *s) {
+	s->len = 0U;
+	s->block = 0U;
+	s->zero = 0U;
+	s->started = 0U;
+	s->fault = TLM_OK;
+}
+
+/**
+ * @brief Appends one unstuffed byte, or marks the frame too long.
+ */
+static void Tlm_StreamPut(tlm_stream_t *s, uint8_t byte) {
+	if (s->len >= s->size) {
+		s->fault = TLM_ERR_OVERFLOW;
+		return;
+	}
+	s->buf[s->len++] = byte;
+}
+
+/**
+ * @brief Starts a stream over a caller buffer.
+ */
+void Tlm_StreamInit(tlm_stream_t *s, uint8_t *buf, uint32_t size) {
+	memset(s, 0, sizeof(*s));
+	s->buf = buf;
+	s->size = size;
+	Tlm_StreamReset(s);
+}
+
+/**
+ * @brief Unstuffs bytes into the stream buffer up to the next delimiter.
+ */
+tlm_status_t Tlm_StreamFeed(tlm_stream_t *s, const uint8_t *data,
+		uint32_t len, uint32_t *consumed, tlm_packet_t *pkt) {
+	tlm_status_t status;
+	uint32_t i;
+	uint8_t byte;
+
+	for (i = 0U; i < len; i++) {
+		byte = data[i];
+		if (byte == 0x00U) {
+			if (s->started == 0U) {
+				s->stats.empty++;
+				continue;
+			}
+			if (s->fault != TLM_OK) {
+				status = s->fault;
+			} else if (s->block != 0U) {
+				status = TLM_ERR_COBS; /* Cut inside a block */
+			} else {
+				status = Tlm_Parse(s->buf, s->len, pkt);
+			}
+			if (status == TLM_OK) {
+				s->stats.packets++;
+			} else {
+				s->stats.errors[status]++;
+			}
+			Tlm_StreamReset(s);
+			*consumed = i + 1U;
+			return status;
+		}
+		if (s->fault != TLM_OK) {
+			continue;
+		}
+		if (s->block == 0U) {
+			/* Code byte: the previous block's implied zero comes first */
+			if ((s->started != 0U) && (s->zero != 0U)) {
+				Tlm_StreamPut(s, 0x00U);
+			}
+			s->block = (uint32_t) byte - 1U;
+			s->zero = (byte != 0xFFU) ? 1U : 0U;
+			s->started = 1U;
+		} else {
+			Tlm_StreamPut(s, byte);
+			s->block--;
+		}
+	}
+	*consumed = len;
+	return TLM_NEED_MORE;
+}
+
+/**
+ * @brief COBS-decodes a frame; out may be in for in-place decoding.
+ */
+uint32_t Tlm_CobsDecode(const uint8_t *in, uint32_t len, uint8_t *out,
+		uint32_t size) {
+	uint32_t i = 0U;
+	uint32_t o = 0U;
+	uint32_t code;
+
+	while (i < len) {
+		code = in[i];
+		if ((code == 0U) || ((i + code) > len) || ((o + code - 1U) > size)) {
+			return 0U;
+		}
+		/* o never passes i, so in place the block moves down or stays */
+		memmove(&out[o], &in[i + 1U], code - 1U);
+		o += code - 1U;
+		i += code;
+		if ((code < 0xFFU) && (i < len)) {
+			if (o >= size) {
+				return 0U;
+			}
+			out[o++] = 0x00U;
+		}
+	}
+	return o;
+}
+
+/**
+ * @brief Decodes a frame in place and parses it.
+ */
+tlm_status_t Tlm_DecodeFrame(uint8_t *frame, uint32_t len, tlm_packet_t *pkt) {
+	uint32_t n = Tlm_CobsDecode(frame, len, frame, len);
+
+	if (n == 0U) {
+		return TLM_ERR_COBS;
+	}
+	return Tlm_Parse(frame, n, pkt);
+}
+
+/**
+ * @brief Checks an unstuffed packet and sets its view.
+ */
+tlm_status_t Tlm_Parse(const uint8_t *data, uint32_t len, tlm_packet_t *pkt) {
+	uint32_t expect;
+
+	if (len < 3U) {
+		return TLM_ERR_LENGTH;
+	}
+	switch (data[0]) {
+	case TELEMETRY_TYPE_READING:
+		expect = TELEMETRY_READING_LEN;
+		break;
+	case TELEMETRY_TYPE_HISTORY:
+		expect = TELEMETRY_HISTORY_HEADER
+				+ (data[1] * TELEMETRY_HISTORY_RECORD) + 2U;
+		break;
+	case TELEMETRY_TYPE_FLASHLOG:
+		expect = TELEMETRY_FLASHLOG_HEADER + (data[1] * 4U) + 2U;
+		break;
+	case TELEMETRY_TYPE_DELTA_KEY:
+		expect = TELEMETRY_DELTA_KEY_LEN;
+		break;
+	case TELEMETRY_TYPE_DELTA:
+		expect = TELEMETRY_DELTA_LEN;
+		break;
+	case TELEMETRY_TYPE_PERF:
+		expect = TELEMETRY_PERF_HEADER + (data[1] * 2U) + 2U;
+		break;
+	case TELEMETRY_TYPE_TIME:
+		expect = TELEMETRY_TIME_LEN;
+		break;
+	case TELEMETRY_TYPE_BATCH:
+		expect = (data[1] != 0U) ? TELEMETRY_BATCH_LEN(data[1]) : 0U;
+		break;
+	case TELEMETRY_TYPE_SUMMARY:
+		expect = TELEMETRY_SUMMARY_LEN;
+		break;
+	case TELEMETRY_TYPE_TRACE:
+		expect = (data[1] <= TELEMETRY_TRACE_MAX) ? TELEMETRY_TRACE_LEN(data[1]) : 0U;
+		break;
+	case TELEMETRY_TYPE_SCHEMA:
+		expect = (len >= TELEMETRY_SCHEMA_HEADER) ?
+				TELEMETRY_SCHEMA_LEN(data[3], data[4]) : 0U;
+		break;
+	case TELEMETRY_TYPE_GATEWAY:
+		expect = (data[1] <= TELEMETRY_GATEWAY_MAX) ?
+				TELEMETRY_GATEWAY_LEN(data[1]) : 0U;
+		break;
+	case TELEMETRY_TYPE_COMPACT:
+		/* Only the schema knows the values; Tlm_CompactDecode() checks */
+		expect = (len >= (TELEMETRY_COMPACT_HEADER + 2U)) ? len : 0U;
+		break;
+	default:
+		return TLM_ERR_TYPE;
+	}
+	if (len != expect) {
+		return TLM_ERR_LENGTH;
+	}
+	if (Tlm_Crc16(data, len - 2U) != Tlm_Get16(&data[len - 2U])) {
+		return TLM_ERR_CRC;
+	}
+
+	pkt->type = data[0];
+	pkt->len = len;
+	pkt->data = data;
+	switch (data[0]) {
+	case TELEMETRY_TYPE_READING:
+		pkt->v.reading = (const telemetry_reading_pkt_t*) data;
+		break;
+	case TELEMETRY_TYPE_HISTORY:
+		pkt->v.history = (const telemetry_history_hdr_t*) data;
+		break;
+	case TELEMETRY_TYPE_FLASHLOG:
+		pkt->v.flashlog = (const telemetry_flashlog_hdr_t*) data;
+		break;
+	case TELEMETRY_TYPE_DELTA_KEY:
+		pkt->v.delta_key = (const telemetry_delta_key_pkt_t*) data;
+		break;
+	case TELEMETRY_TYPE_DELTA:
+		pkt->v.delta = (const telemetry_delta_pkt_t*) data;
+		break;
+	case TELEMETRY_TYPE_PERF:
+		pkt->v.perf = (const telemetry_perf_hdr_t*) data;
+		break;
+	case TELEMETRY_TYPE_TIME:
+		pkt->v.time = (const telemetry_time_pkt_t*) data;
+		break;
+	case TELEMETRY_TYPE_BATCH:
+		pkt->v.batch = (const telemetry_batch_hdr_t*) data;
+		break;
+	case TELEMETRY_TYPE_TRACE:
+		pkt->v.trace = (const telemetry_trace_hdr_t*) data;
+		break;
+	case TELEMETRY_TYPE_SCHEMA:
+		pkt->v.schema = (const telemetry_schema_hdr_t*) data;
+		break;
+	case TELEMETRY_TYPE_COMPACT:
+		pkt->v.compact = (const telemetry_compact_hdr_t*) data;
+		break;
+	case TELEMETRY_TYPE_GATEWAY:
+		pkt->v.gateway = (const telemetry_gateway_hdr_t*) data;
+		break;
+	default:
+		pkt->v.summary = (const telemetry_summary_pkt_t*) data;
+		break;
+	}
+	return TLM_OK;
+}
+
+/**
+ * @brief CRC-16/CCITT-FALSE.
+ */
+uint16_t Tlm_Crc16(const uint8_t *data, uint32_t len) {
+	uint16_t crc = 0xFFFFU;
+	uint32_t i;
+
+	for (i = 0U; i < len; i++) {
+		crc = (uint16_t) ((crc << 4) ^ tlm_crc_nibble[(crc >> 12) ^ (data[i] >> 4)]);
+		crc = (uint16_t) ((crc << 4)
+				^ tlm_crc_nibble[(crc >> 12) ^ (data[i] & 0x0FU)]);
+	}
+	return crc;
+}
+
+/**
+ * @brief Starts iterating the readings of a packet.
+ */
+void Tlm_SamplesBegin(tlm_iter_t *it, const tlm_packet_t *pkt) {
+	it->pkt = pkt;
+	it->index = 0U;
+}
+
+/**
+ * @brief Next reading.
+ */
+int Tlm_SamplesNext(tlm_iter_t *it, tlm_sample_t *sample) {
+	const tlm_packet_t *pkt = it->pkt;
+	const telemetry_history_rec_t *rec;
+	const telemetry_batch_sample_t *bs;
+	uint32_t i = it->index;
+
+	switch (pkt->type) {
+	case TELEMETRY_TYPE_READING:
+		if (i != 0U) {
+			return 0;
+		}
+		sample->sensor_id = pkt->v.reading->sensor_id;
+		sample->status = pkt->v.reading->status;
+		sample->retries = pkt->v.reading->retries;
+		sample->raw_len = 5U;
+		sample->raw = pkt->v.reading->raw;
+		sample->timestamp_ms = pkt->v.reading->timestamp_ms;
+		sample->seq = pkt->v.reading->seq;
+		sample->boot = 0U;
+		break;
+	case TELEMETRY_TYPE_HISTORY:
+		if (i >= pkt->v.history->n) {
+			return 0;
+		}
+		rec = (const telemetry_history_rec_t*) (pkt->data
+				+ TELEMETRY_HISTORY_HEADER) + i;
+		sample->sensor_id = rec->sensor_id;
+		sample->status = rec->status;
+		sample->retries = 0U;
+		sample->raw_len = 4U;
+		sample->raw = rec->raw;
+		sample->timestamp_ms = rec->timestamp_ms;
+		sample->seq = pkt->v.history->first_seq + i;
+		sample->boot = rec->boot;
+		break;
+	case TELEMETRY_TYPE_BATCH:
+		if (i >= pkt->v.batch->n) {
+			return 0;
+		}
+		bs = (const telemetry_batch_sample_t*) (pkt->data
+				+ TELEMETRY_BATCH_HEADER) + i;
+		sample->sensor_id = bs->sensor_id;
+		sample->status = bs->status;
+		sample->retries = bs->retries;
+		sample->raw_len = 5U;
+		sample->raw = bs->raw;
+		sample->timestamp_ms = pkt->v.batch->timestamp_ms + bs->dt_ms;
+		sample->seq = pkt->v.batch->seq;
+		sample->boot = 0U;
+		break;
+	default:
+		return 0;
+	}
+	it->index++;
+	return 1;
+}
+
+/**
+ * @brief Word i of a flash log chunk (0x03).
+ */
+uint32_t Tlm_FlashlogWord(const tlm_packet_t *pkt, uint32_t i) {
+	uint32_t word;
+
+	memcpy(&word, pkt->data + TELEMETRY_FLASHLOG_HEADER + (i * 4U), 4U);
+	return word;
+}
+
+/**
+ * @brief Handler share i of a CPU load packet (0x06), permille.
+ */
+uint16_t Tlm_PerfShare(const tlm_packet_t *pkt, uint32_t i) {
+	return Tlm_Get16(pkt->data + TELEMETRY_PERF_HEADER + (i * 2U));
+}
+
+/**
+ * @brief Edge time i of a trace packet (0x0A), microseconds.
+ */
+uint16_t Tlm_TraceEdge(const tlm_packet_t *pkt, uint32_t i) {
+	return Tlm_Get16(pkt->data + TELEMETRY_TRACE_HEADER + (i * 2U));
+}
+
+/**
+ * @brief Takes a schema packet as the stream's schema.
+ */
+int Tlm_SchemaLoad(tlm_schema_t *schema, const tlm_packet_t *pkt) {
+	const telemetry_schema_hdr_t *h = pkt->v.schema;
+	uint32_t i;
+
+	if ((pkt->type != TELEMETRY_TYPE_SCHEMA) || (h->nfields > TLM_SCHEMA_FIELDS_MAX)
+			|| (h->nsensors > TLM_SCHEMA_SENSORS_MAX)) {
+		return 0;
+	}
+	memcpy(schema->fields, pkt->data + TELEMETRY_SCHEMA_HEADER,
+			h->nfields * TELEMETRY_SCHEMA_FIELD);
+	memcpy(schema->sensors, pkt->data + TELEMETRY_SCHEMA_HEADER
+			+ (h->nfields * TELEMETRY_SCHEMA_FIELD),
+			h->nsensors * TELEMETRY_SCHEMA_SENSOR);
+	schema->values_len = 0U;
+	for (i = 0U; i < h->nfields; i++) {
+		schema->values_len += TELEMETRY_ENC_SIZE(schema->fields[i].enc);
+	}
+	schema->schema_id = h->schema_id;
+	schema->nfields = h->nfields;
+	schema->nsensors = h->nsensors;
+	schema->next_seq = (uint8_t) (h->seq + 1U);
+	schema->time_ms = h->timestamp_ms;
+	schema->synced = 1U;
+	schema->valid = 1U;
+	return 1;
+}
+
+/**
+ * @brief Values of a compact packet, in schema field order.
+ */
+uint32_t Tlm_CompactDecode(tlm_schema_t *schema, const tlm_packet_t *pkt,
+		int32_t *values, uint32_t *timestamp_ms) {
+	const uint8_t *p = pkt->data + TELEMETRY_COMPACT_HEADER;
+	uint32_t size;
+	uint32_t raw;
+	uint32_t i;
+	uint32_t b;
+	int32_t scale;
+	uint8_t enc;
+
+	if ((pkt->type != TELEMETRY_TYPE_COMPACT) || (schema->valid == 0U)
+			|| (pkt->v.compact->schema_id != schema->schema_id)
+			|| (pkt->len != (TELEMETRY_COMPACT_HEADER + schema->values_len + 2U))) {
+		return 0U;
+	}
+	if (pkt->v.compact->seq != schema->next_seq) {
+		schema->synced = 0U;
+	}
+	schema->next_seq = (uint8_t) (pkt->v.compact->seq + 1U);
+	if (schema->synced == 0U) {
+		return 0U;
+	}
+	for (i = 0U; i < schema->nfields; i++) {
+		enc = schema->fields[i].enc;
+		size = TELEMETRY_ENC_SIZE(enc);
+		raw = 0U;
+		for (b = 0U; b < size; b++) {
+			raw |= (uint32_t) p[b] << (8U * b);
+		}
+		p += size;
+		if (((enc & TELEMETRY_ENC_SIGNED) != 0U) && (size < 4U)
+				&& ((raw & (1UL << ((8U * size) - 1U))) != 0U)) {
+			raw |= (uint32_t) (0xFFFFFFFFUL << (8U * size)); /* Sign-extend */
+		}
+		values[i] = (int32_t) raw;
+		if (schema->fields[i].id == TELEMETRY_FIELD_DT) {
+			/* Seconds * 10^scale to milliseconds */
+			for (scale = schema->fields[i].scale; scale < -3; scale++) {
+				raw /= 10U;
+			}
+			for (; scale > -3; scale--) {
+				raw *= 10U;
+			}
+			schema->time_ms += raw;
+		}
+	}
+	*timestamp_ms = schema->time_ms;
+	return schema->nfields;
+}
+
+/**
+ * @brief Kind of a sensor in the loaded schema.
+ */
+uint8_t Tlm_SchemaSensorKind(const tlm_schema_t *schema, uint8_t sensor_id) {
+	uint32_t i;
+
+	for (i = 0U; i < schema->nsensors; i++) {
+		if (schema->sensors[i].sensor_id == sensor_id) {
+			return schema->sensors[i].kind;
+		}
+	}
+	return 0U;
+}
+
+/**
+ * @brief Short printable name of a status.
+ */
+const char* Tlm_StatusName(tlm_status_t status) {
+	switch (status) {
+	case TLM_OK:
+		return "ok";
+	case TLM_NEED_MORE:
+		return "need_more";
+	case TLM_ERR_COBS:
+		return "cobs";
+	case TLM_ERR_OVERFLOW:
+		return "overflow";
+	case TLM_ERR_LENGTH:
+		return "length";
+	case TLM_ERR_CRC:
+		return "crc";
+	default:
+		return "type";
+	}
+}
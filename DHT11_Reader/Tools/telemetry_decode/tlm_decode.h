@@ -0,0 +1,257 @@
+/**
+ ******************************************************************************
+ * @file           : tlm_decode.h
+ * @brief          : Host decoder of the binary telemetry stream: COBS
+ *                   frames split from a byte stream, checked and viewed in
+ *                   place through the firmware's packet structs.
+ *
+ *                   No allocation and no copy beyond COBS unstuffing:
+ *                     - Tlm_StreamFeed() takes bytes as they come off a
+ *                       socket or serial port, unstuffs them into a
+ *                       caller buffer of at least TELEMETRY_PKT_MAX bytes
+ *                       and returns at every 0x00 delimiter;
+ *                     - Tlm_DecodeFrame() unstuffs a frame already split
+ *                       at its delimiter in place, for captures held in
+ *                       memory;
+ *                     - both end in Tlm_Parse(), which checks the type,
+ *                       the length and the CRC-16/CCITT-FALSE and sets
+ *                       tlm_packet_t's view: pointers into the packet,
+ *                       typed by telemetry_frames.h, valid as long as its
+ *                       bytes are.
+ *                   Tlm_SamplesNext() iterates the readings of a 0x01,
+ *                   0x02 or 0x08 packet as one sample type, raw bytes
+ *                   pointed to in the packet.
+ *                   Compact packets (0x0C) only make sense against their
+ *                   schema (0x0B): Tlm_SchemaLoad() copies one into a
+ *                   tlm_schema_t, Tlm_CompactDecode() reads a compact
+ *                   packet's values and time through it.
+ *
+ *                   One tlm_stream_t per byte stream; streams share
+ *                   nothing, so boards can be decoded on any threads.
+ *                   The library is C99 and its header is usable from C++;
+ *                   GCC or Clang on a little-endian host (packed structs,
+ *                   telemetry_frames.h refuses big-endian).
+ *
+ * @author         : Nitin R
+ * @version        : 1.0
+ * @date           : Oct 14, 2026
+ ******************************************************************************
+ */
+
+#ifndef TLM_DECODE_H_
+#define TLM_DECODE_H_
+
+#include "telemetry_frames.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Result of feeding or parsing.
+ */
+typedef enum {
+	TLM_OK = 0,          /*!< A valid packet is in the view          */
+	TLM_NEED_MORE,       /*!< Input used up inside a frame           */
+	TLM_ERR_COBS,        /*!< Stuffing broken: noise or a cut frame  */
+	TLM_ERR_OVERFLOW,    /*!< Longer than the buffer: text or noise  */
+	TLM_ERR_LENGTH,      /*!< Length does not match the type         */
+	TLM_ERR_CRC,
+	TLM_ERR_TYPE         /*!< Unknown packet type                    */
+} tlm_status_t;
+
+/**
+ * @brief Checked packet, viewed in place.
+ */
+typedef struct {
+	uint8_t type;
+	uint32_t len;                /*!< Body length, CRC included  */
+	const uint8_t *data;         /*!< Body, type byte first      */
+	union {
+		const telemetry_reading_pkt_t *reading;
+		const telemetry_history_hdr_t *history;
+		const telemetry_flashlog_hdr_t *flashlog;
+		const telemetry_delta_key_pkt_t *delta_key;
+		const telemetry_delta_pkt_t *delta;
+		const telemetry_perf_hdr_t *perf;
+		const telemetry_time_pkt_t *time;
+		const telemetry_batch_hdr_t *batch;
+		const telemetry_summary_pkt_t *summary;
+		const telemetry_trace_hdr_t *trace;
+		const telemetry_schema_hdr_t *schema;
+		const telemetry_compact_hdr_t *compact;
+		const telemetry_gateway_hdr_t *gateway;
+	} v;
+} tlm_packet_t;
+
+/**
+ * @brief Frame counters of one stream.
+ */
+typedef struct {
+	uint32_t packets;            /*!< Valid packets                      */
+	uint32_t empty;              /*!< Back-to-back delimiters, skipped   */
+	uint32_t errors[TLM_ERR_TYPE + 1]; /*!< Dropped frames, by status    */
+} tlm_stats_t;
+
+/**
+ * @brief Reassembly state of one byte stream.
+ */
+typedef struct {
+	uint8_t *buf;
+	uint32_t size;
+	uint32_t len;                /*!< Bytes unstuffed so far            */
+	uint32_t block;              /*!< Bytes left in the current block   */
+	uint8_t zero;                /*!< The block ends with an implied 0  */
+	uint8_t started;             /*!< At least one byte of this frame   */
+	tlm_status_t fault;          /*!< Fault seen, wait for the delimiter */
+	tlm_stats_t stats;
+} tlm_stream_t;
+
+/**
+ * @brief One reading of a packet.
+ */
+typedef struct {
+	uint8_t sensor_id;
+	uint8_t status;              /*!< dht11_status_t                      */
+	uint8_t retries;             /*!< 0 in history records                */
+	uint8_t raw_len;             /*!< 5, or 4 in history (no checksum)    */
+	const uint8_t *raw;          /*!< In the packet                       */
+	uint32_t timestamp_ms;       /*!< Device HAL tick                     */
+	uint32_t seq;                /*!< Packet, batch or record sequence    */
+	uint16_t boot;               /*!< Boot number, history records only   */
+} tlm_sample_t;
+
+/** Largest schema a tlm_schema_t holds */
+#define TLM_SCHEMA_FIELDS_MAX  (16U)
+#define TLM_SCHEMA_SENSORS_MAX (32U)
+
+/**
+ * @brief Last schema (0x0B) of one stream and the time of its last
+ *        packet.
+ */
+typedef struct {
+	uint8_t valid;               /*!< A schema is loaded                  */
+	uint8_t synced;              /*!< No packet lost since it             */
+	uint8_t schema_id;
+	uint8_t next_seq;
+	uint8_t nfields;
+	uint8_t nsensors;
+	uint32_t values_len;         /*!< Bytes of values per 0x0C packet     */
+	uint32_t time_ms;            /*!< Device tick of the last packet      */
+	telemetry_schema_field_t fields[TLM_SCHEMA_FIELDS_MAX];
+	telemetry_schema_sensor_t sensors[TLM_SCHEMA_SENSORS_MAX];
+} tlm_schema_t;
+
+/**
+ * @brief Position in a packet's readings.
+ */
+typedef struct {
+	const tlm_packet_t *pkt;
+	uint32_t index;
+} tlm_iter_t;
+
+/**
+ * @brief Starts a stream over a caller buffer.
+ * @param size: At least TELEMETRY_PKT_MAX; shorter frames are dropped.
+ */
+void Tlm_StreamInit(tlm_stream_t *s, uint8_t *buf, uint32_t size);
+
+/**
+ * @brief Unstuffs bytes into the stream buffer up to the next delimiter.
+ * @param consumed: Bytes taken from data, delimiter included.
+ * @param pkt: Set when TLM_OK; its view lives in the stream buffer until
+ *             the next call.
+ * @retval TLM_NEED_MORE when data ran out inside a frame, otherwise the
+ *         status of the frame the delimiter ended.
+ */
+tlm_status_t Tlm_StreamFeed(tlm_stream_t *s, const uint8_t *data,
+		uint32_t len, uint32_t *consumed, tlm_packet_t *pkt);
+
+/**
+ * @brief COBS-decodes a frame; out may be in for in-place decoding.
+ * @param in: Frame bytes before the 0x00 delimiter.
+ * @retval Decoded length, 0 if the stuffing is broken or out is too small.
+ */
+uint32_t Tlm_CobsDecode(const uint8_t *in, uint32_t len, uint8_t *out,
+		uint32_t size);
+
+/**
+ * @brief Decodes a frame in place and parses it.
+ * @param frame: Frame bytes before the 0x00 delimiter; overwritten.
+ */
+tlm_status_t Tlm_DecodeFrame(uint8_t *frame, uint32_t len, tlm_packet_t *pkt);
+
+/**
+ * @brief Checks an unstuffed packet and sets its view.
+ */
+tlm_status_t Tlm_Parse(const uint8_t *data, uint32_t len, tlm_packet_t *pkt);
+
+/**
+ * @brief CRC-16/CCITT-FALSE, as Crc_Ccitt16() on the device.
+ */
+uint16_t Tlm_Crc16(const uint8_t *data, uint32_t len);
+
+/**
+ * @brief Starts iterating the readings of a packet; packets of other types
+ *        have none.
+ */
+void Tlm_SamplesBegin(tlm_iter_t *it, const tlm_packet_t *pkt);
+
+/**
+ * @brief Next reading.
+ * @retval 1 with *sample set, 0 at the end.
+ */
+int Tlm_SamplesNext(tlm_iter_t *it, tlm_sample_t *sample);
+
+/**
+ * @brief Word i of a flash log chunk (0x03).
+ */
+uint32_t Tlm_FlashlogWord(const tlm_packet_t *pkt, uint32_t i);
+
+/**
+ * @brief Handler share i of a CPU load packet (0x06), permille.
+ */
+uint16_t Tlm_PerfShare(const tlm_packet_t *pkt, uint32_t i);
+
+/**
+ * @brief Edge time i of a trace packet (0x0A), microseconds.
+ */
+uint16_t Tlm_TraceEdge(const tlm_packet_t *pkt, uint32_t i);
+
+/**
+ * @brief Takes a schema packet (0x0B) as the stream's schema; later
+ *        compact packets are decoded against it.
+ * @retval 1 if loaded, 0 for another packet type or a schema larger than
+ *         tlm_schema_t holds.
+ */
+int Tlm_SchemaLoad(tlm_schema_t *schema, const tlm_packet_t *pkt);
+
+/**
+ * @brief Values of a compact packet (0x0C), in schema field order, as the
+ *        wire integers (scale and unit in schema->fields). A
+ *        TELEMETRY_FIELD_DT field moves the time on.
+ * @param values: At least schema->nfields entries.
+ * @param timestamp_ms: Set to the device tick of the reading.
+ * @retval Number of values, 0 if the packet's schema is not the loaded one,
+ *         its length does not match, or a packet was lost since the
+ *         schema: its time is unknown until the next schema packet.
+ */
+uint32_t Tlm_CompactDecode(tlm_schema_t *schema, const tlm_packet_t *pkt,
+		int32_t *values, uint32_t *timestamp_ms);
+
+/**
+ * @brief Kind (TELEMETRY_SENSOR_*) of a sensor in the loaded schema, 0 if
+ *        it is not listed.
+ */
+uint8_t Tlm_SchemaSensorKind(const tlm_schema_t *schema, uint8_t sensor_id);
+
+/**
+ * @brief Short printable name of a status.
+ */
+const char* Tlm_StatusName(tlm_status_t status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TLM_DECODE_H_ */